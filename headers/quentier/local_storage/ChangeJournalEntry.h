@@ -0,0 +1,104 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_LOCAL_STORAGE_CHANGE_JOURNAL_ENTRY_H
+#define LIB_QUENTIER_LOCAL_STORAGE_CHANGE_JOURNAL_ENTRY_H
+
+#include <quentier/utility/Printable.h>
+#include <QStringList>
+#include <QMetaType>
+
+namespace quentier {
+
+/**
+ * @brief The ChangeJournalEntry class represents a single record of the local storage's change journal:
+ * the append-only log of additions, updates and expunges of data elements written by LocalStorageManager
+ * within the same transaction as the change itself
+ *
+ * The consumers interested in incremental updates (caches, models, indexes) can remember the sequence number
+ * of the last entry they have processed and later ask LocalStorageManager for the changes made since then
+ * instead of re-listing the data elements from the local storage
+ */
+class QUENTIER_EXPORT ChangeJournalEntry: public Printable
+{
+public:
+    struct EntityType
+    {
+        enum type
+        {
+            Notebook = 0,
+            LinkedNotebook,
+            Note,
+            Tag,
+            Resource,
+            SavedSearch
+        };
+    };
+
+    struct ChangeType
+    {
+        enum type
+        {
+            Add = 0,
+            Update,
+            Expunge
+        };
+    };
+
+public:
+    ChangeJournalEntry();
+    virtual ~ChangeJournalEntry();
+
+    bool operator==(const ChangeJournalEntry & other) const;
+    bool operator!=(const ChangeJournalEntry & other) const;
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+    /**
+     * Monotonically increasing number of the entry within the journal; sequence numbers
+     * are never reused, even after the journal is trimmed
+     */
+    qint64                  sequenceNumber;
+
+    EntityType::type        entityType;
+    ChangeType::type        changeType;
+
+    /**
+     * Local uid of the changed data element; for linked notebooks which have no local uids
+     * it is the guid of the linked notebook
+     */
+    QString                 localUid;
+
+    /**
+     * The names of changed groups of fields, if the change touched only some of them;
+     * empty list means the whole data element was written (or expunged). For notes the possible
+     * groups are "note" (the note's own fields including content and attributes), "tags" and "resources"
+     */
+    QStringList             changedFields;
+
+    /**
+     * The time of the change, in milliseconds since epoch
+     */
+    qint64                  timestamp;
+};
+
+} // namespace quentier
+
+Q_DECLARE_METATYPE(quentier::ChangeJournalEntry)
+
+#endif // LIB_QUENTIER_LOCAL_STORAGE_CHANGE_JOURNAL_ENTRY_H
@@ -22,6 +22,10 @@
 #include <quentier/types/Account.h>
 #include <quentier/local_storage/Lists.h>
 #include <quentier/local_storage/NoteSearchQuery.h>
+#include <quentier/local_storage/ChangeJournalEntry.h>
+#include <quentier/local_storage/LocalStorageStatistics.h>
+#include <quentier/local_storage/StaleDataItemsExpungeResult.h>
+#include <quentier/local_storage/LocalStorageSnapshotInfo.h>
 #include <quentier/utility/Linkage.h>
 #include <quentier/utility/Macros.h>
 #include <quentier/types/ErrorString.h>
@@ -29,6 +33,7 @@
 #include <QScopedPointer>
 #include <QSharedPointer>
 #include <QHash>
+#include <QSet>
 #include <cstdint>
 
 namespace qevercloud {
@@ -542,6 +547,19 @@ public:
     bool updateNote(Note & note, const bool updateResources,
                     const bool updateTags, ErrorString & errorDescription);
 
+    /**
+     * @brief updateNotes - updates passed in notes in the local storage database within a single transaction;
+     * each note is identified and updated the same way as by updateNote method
+     * @param notes - notes to be updated in the local storage database; may be changed as a result of the call
+     * the same way as the note passed to updateNote method
+     * @param updateResources - flag indicating whether the notes' resources should be updated along with the notes
+     * @param updateTags - flag indicating whether the notes' tags should be updated along with the notes
+     * @param errorDescription - error description if notes could not be updated; in this case none of them is updated
+     * @return true if all notes were updated successfully, false otherwise
+     */
+    bool updateNotes(QList<Note> & notes, const bool updateResources,
+                     const bool updateTags, ErrorString & errorDescription);
+
     /**
      * @brief findNote - attempts to find note in the local storage database
      * @param note - note to be found in the local storage database. Must have either
@@ -1024,6 +1042,153 @@ public:
      */
     qint32 accountHighUsn(const QString & linkedNotebookGuid, ErrorString & errorDescription);
 
+    /**
+     * @brief listChangesSince - lists the entries of the local storage change journal which were written
+     * after the entry with the specified sequence number, in the order of increasing sequence numbers
+     *
+     * Each addition, update or expunge of a notebook, linked notebook, note, tag, resource or saved search
+     * is recorded in the change journal within the same transaction as the change itself, including the data elements
+     * expunged implicitly along with their parents (i.e. notes along with their notebook)
+     *
+     * @param sequenceNumber - the sequence number of the last journal entry already known to the caller;
+     * pass zero to list the entire journal
+     * @param errorDescription - error description if the change journal entries could not be listed;
+     * if no error happens, this parameter is untouched
+     * @param limit - limit for the max number of entries in the result, zero by default which means no limit is set
+     * @return either the list of change journal entries or empty list in case of error or no changes since
+     * the specified sequence number
+     */
+    QList<ChangeJournalEntry> listChangesSince(const qint64 sequenceNumber, ErrorString & errorDescription,
+                                               const size_t limit = 0) const;
+
+    /**
+     * @brief lastChangeSequenceNumber - returns the sequence number of the latest entry of the local storage change journal
+     * @param errorDescription - error description if the sequence number could not be returned
+     * @return either non-negative sequence number (zero if no changes were journaled yet) or -1 in case of error
+     */
+    qint64 lastChangeSequenceNumber(ErrorString & errorDescription) const;
+
+    /**
+     * @brief trimChangeJournal - permanently removes the change journal entries with sequence numbers not greater
+     * than the specified one; the sequence numbers of the removed entries are never reused
+     * @param upToSequenceNumber - the sequence number of the last entry to be removed from the journal
+     * @param errorDescription - error description if the change journal could not be trimmed
+     * @return true if the change journal was trimmed successfully, false otherwise
+     */
+    bool trimChangeJournal(const qint64 upToSequenceNumber, ErrorString & errorDescription);
+
+    /**
+     * @brief listResourceSyncedDataHashes - lists the hashes of resources' data as it was when the resources were
+     * last synchronized with the service, for the resources of the specified notes
+     *
+     * The synchronized data hash of the resource is recorded each time the resource is put into the local storage
+     * while not being dirty and each time the note is updated without updating its resources while not being dirty,
+     * i.e. after the note has been sent to the service
+     *
+     * @param noteLocalUids - local uids of notes which resources' synchronized data hashes should be listed
+     * @param errorDescription - error description if the hashes could not be listed; if no error happens,
+     * this parameter is untouched
+     * @return the hash of synchronized resource data hashes by resource local uids; the resources
+     * which have never been synchronized are not included into it
+     */
+    QHash<QString,QByteArray> listResourceSyncedDataHashes(const QStringList & noteLocalUids,
+                                                           ErrorString & errorDescription) const;
+
+    /**
+     * @brief statistics - returns the snapshot of the performance statistics collected by the local storage manager
+     * since its creation or since the last call to resetStatistics: latency histograms of local storage manager's
+     * operations, counters of executed SQL queries grouped by their shape and the log of slow SQL queries along
+     * with their query plans
+     */
+    LocalStorageStatistics statistics() const;
+
+    /**
+     * @brief resetStatistics - clears the collected performance statistics; the slow query threshold is preserved
+     */
+    void resetStatistics();
+
+    /**
+     * @brief statisticsCollectionEnabled - returns true if the performance statistics are being collected, false otherwise;
+     * the statistics collection is enabled by default
+     */
+    bool statisticsCollectionEnabled() const;
+
+    /**
+     * @brief setStatisticsCollectionEnabled - enables or disables the collection of performance statistics
+     */
+    void setStatisticsCollectionEnabled(const bool enabled);
+
+    /**
+     * @brief setSlowQueryThreshold - sets the duration of SQL query above which the query gets logged
+     * as a slow one, along with its query plan
+     * @param thresholdUsec - the threshold duration in microseconds
+     */
+    void setSlowQueryThreshold(const qint64 thresholdUsec);
+
+    /**
+     * @brief exportSnapshot - writes the consistent snapshot of the entire local storage database into the specified file
+     *
+     * The snapshot is a page-level copy of the database file: the write-ahead log is first checkpointed into
+     * the database file with wal_checkpoint(TRUNCATE) and then the file is copied on the thread owning
+     * the local storage. No write can happen in between since all the writes go through the same thread
+     * and other processes are kept away from the database by the file lock; no transaction blocks the writes.
+     * The snapshot records the highest update sequence numbers of user's own account and of each linked notebook
+     * at the moment of its creation so that the account restored from the snapshot can continue
+     * with the incremental sync from that point, see SynchronizationManager::setLastSyncParametersFromSnapshot
+     *
+     * @param snapshotFilePath - the path to the snapshot file; the existing file gets overwritten
+     * @param snapshotInfo - the synchronization state recorded within the snapshot
+     * @param errorDescription - error description if the snapshot could not be exported
+     * @return true if the snapshot was exported successfully, false otherwise
+     */
+    bool exportSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                        ErrorString & errorDescription);
+
+    /**
+     * @brief importSnapshot - replaces the entire contents of the local storage database for the current account
+     * with the contents of the snapshot previously created by exportSnapshot; the snapshot is validated
+     * before anything is replaced
+     *
+     * The change journal of the local storage is replaced along with the rest of the data so the previously listed
+     * change journal sequence numbers are no longer meaningful after the import
+     *
+     * @param snapshotFilePath - the path to the snapshot file
+     * @param snapshotInfo - the synchronization state recorded within the snapshot; it should be passed
+     * to SynchronizationManager::setLastSyncParametersFromSnapshot so that the incremental sync continues after it
+     * @param errorDescription - error description if the snapshot could not be imported
+     * @return true if the snapshot was imported successfully, false otherwise
+     */
+    bool importSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                        ErrorString & errorDescription);
+
+    /**
+     * @brief expungeStaleDataItems - expunges the data items which have guids but were not referenced
+     * during the full sync, either of user's own account or of some linked notebook; the dirty ones of such data items
+     * are not expunged but stripped off their guids and update sequence numbers so that they would be sent
+     * to the service as new data items
+     *
+     * The stale data items are computed and processed in a single transaction: the synced guids are loaded
+     * into temporary tables and the stale data items are found via a single anti-join per data item type
+     *
+     * Notes are considered within the scope of their notebooks. The dirty notes from the expunged notebooks are expunged
+     * along with their notebooks. The dirty tags which parent tags are expunged are detached from their parents.
+     * Saved searches are only processed for user's own account, i.e. if linkedNotebookGuid is empty
+     *
+     * @param syncedNotebookGuids - the guids of notebooks referenced during the full sync
+     * @param syncedTagGuids - the guids of tags referenced during the full sync
+     * @param syncedNoteGuids - the guids of notes referenced during the full sync
+     * @param syncedSavedSearchGuids - the guids of saved searches referenced during the full sync
+     * @param linkedNotebookGuid - the guid of linked notebook which data items should be processed;
+     * if empty, the data items from user's own account are processed
+     * @param result - the local uids of expunged and detached data items
+     * @param errorDescription - error description if the stale data items could not be expunged
+     * @return true if the stale data items were expunged successfully, false otherwise
+     */
+    bool expungeStaleDataItems(const QSet<QString> & syncedNotebookGuids, const QSet<QString> & syncedTagGuids,
+                               const QSet<QString> & syncedNoteGuids, const QSet<QString> & syncedSavedSearchGuids,
+                               const QString & linkedNotebookGuid, StaleDataItemsExpungeResult & result,
+                               ErrorString & errorDescription);
+
 private:
     LocalStorageManager() Q_DECL_EQ_DELETE;
     Q_DISABLE_COPY(LocalStorageManager)
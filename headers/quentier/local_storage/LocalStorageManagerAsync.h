@@ -22,6 +22,9 @@
 #include <quentier/utility/Macros.h>
 #include <quentier/types/ErrorString.h>
 #include <quentier/local_storage/LocalStorageManager.h>
+#include <quentier/local_storage/ChangeJournalEntry.h>
+#include <quentier/local_storage/LocalStorageStatistics.h>
+#include <quentier/local_storage/StaleDataItemsExpungeResult.h>
 #include <quentier/local_storage/LocalStorageCacheManager.h>
 #include <quentier/local_storage/ILocalStorageCacheExpiryChecker.h>
 #include <quentier/types/User.h>
@@ -33,6 +36,7 @@
 #include <quentier/types/Resource.h>
 #include <quentier/types/SavedSearch.h>
 #include <QObject>
+#include <QHash>
 
 namespace quentier {
 
@@ -52,6 +56,22 @@ public:
     const LocalStorageManager * localStorageManager() const;
     LocalStorageManager * localStorageManager();
 
+    /**
+     * @brief setNoteUpdateCoalescingWindow - sets the duration of the window within which the successive requests
+     * to update the same note (identified by its local uid) are merged into a single write to the local storage:
+     * only the latest state of the note gets written at the end of the window and each of the merged requests
+     * receives its own completion signal
+     *
+     * The pending note updates are written out before processing any other request involving notes
+     * and on the explicit flush request; the requests bypassing the async interface, through direct access
+     * to the local storage manager, don't see them until they are written
+     *
+     * @param windowMsec - the duration of the coalescing window in milliseconds; zero (default) disables
+     * the coalescing of note updates so that each one is written immediately
+     */
+    void setNoteUpdateCoalescingWindow(const int windowMsec);
+    int noteUpdateCoalescingWindow() const;
+
 Q_SIGNALS:
     // Sent when the initialization is complete
     void initialized();
@@ -155,6 +175,9 @@ Q_SIGNALS:
     void updateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId = QUuid());
     void updateNoteFailed(Note note, bool updateResources, bool updateTags,
                           ErrorString errorDescription, QUuid requestId = QUuid());
+    void updateNotesComplete(QList<Note> notes, bool updateResources, bool updateTags, QUuid requestId = QUuid());
+    void updateNotesFailed(QList<Note> notes, bool updateResources, bool updateTags,
+                           ErrorString errorDescription, QUuid requestId = QUuid());
     void findNoteComplete(Note foundNote, bool withResourceBinaryData, QUuid requestId = QUuid());
     void findNoteFailed(Note note, bool withResourceBinaryData, ErrorString errorDescription, QUuid requestId = QUuid());
     void listNotesPerNotebookComplete(Notebook notebook, bool withResourceBinaryData,
@@ -280,6 +303,36 @@ Q_SIGNALS:
     void accountHighUsnComplete(qint32 usn, QString linkedNotebookGuid, QUuid requestId = QUuid());
     void accountHighUsnFailed(QString linkedNotebookGuid, ErrorString errorDescription, QUuid requestId = QUuid());
 
+    void listChangesSinceComplete(qint64 sequenceNumber, size_t limit, QList<ChangeJournalEntry> entries,
+                                  QUuid requestId = QUuid());
+    void listChangesSinceFailed(qint64 sequenceNumber, size_t limit, ErrorString errorDescription,
+                                QUuid requestId = QUuid());
+
+    void listResourceSyncedDataHashesComplete(QStringList noteLocalUids, QHash<QString,QByteArray> dataHashesByResourceLocalUid,
+                                              QUuid requestId = QUuid());
+    void listResourceSyncedDataHashesFailed(QStringList noteLocalUids, ErrorString errorDescription,
+                                            QUuid requestId = QUuid());
+
+    void localStorageStatisticsComplete(LocalStorageStatistics statistics, bool reset, QUuid requestId = QUuid());
+    void localStorageStatisticsFailed(bool reset, ErrorString errorDescription, QUuid requestId = QUuid());
+
+    void exportSnapshotComplete(QString snapshotFilePath, LocalStorageSnapshotInfo snapshotInfo, QUuid requestId = QUuid());
+    void exportSnapshotFailed(QString snapshotFilePath, ErrorString errorDescription, QUuid requestId = QUuid());
+
+    void importSnapshotComplete(QString snapshotFilePath, LocalStorageSnapshotInfo snapshotInfo, QUuid requestId = QUuid());
+    void importSnapshotFailed(QString snapshotFilePath, ErrorString errorDescription, QUuid requestId = QUuid());
+
+    void expungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                       QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                       QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                       QUuid requestId = QUuid());
+    void expungeStaleDataItemsFailed(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                     QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                     QString linkedNotebookGuid, ErrorString errorDescription,
+                                     QUuid requestId = QUuid());
+
+    void flushPendingNoteUpdatesComplete(QUuid requestId = QUuid());
+
 public Q_SLOTS:
     void init();
 
@@ -336,6 +389,7 @@ public Q_SLOTS:
     void onGetNoteCountsPerAllTagsRequest(QUuid requestId);
     void onAddNoteRequest(Note note, QUuid requestId);
     void onUpdateNoteRequest(Note note, bool updateResources, bool updateTags, QUuid requestId);
+    void onUpdateNotesRequest(QList<Note> notes, bool updateResources, bool updateTags, QUuid requestId);
     void onFindNoteRequest(Note note, bool withResourceBinaryData, QUuid requestId);
     void onListNotesPerNotebookRequest(Notebook notebook, bool withResourceBinaryData,
                                        LocalStorageManager::ListObjectsOptions flag,
@@ -357,6 +411,12 @@ public Q_SLOTS:
     void onFindNoteLocalUidsWithSearchQuery(NoteSearchQuery noteSearchQuery, QUuid requestId);
     void onExpungeNoteRequest(Note note, QUuid requestId);
 
+    /**
+     * Writes all the note updates pending within the coalescing window to the local storage; intended
+     * to be used before the shutdown or synchronization
+     */
+    void onFlushPendingNoteUpdatesRequest(QUuid requestId);
+
     // Tag-related slots:
     void onGetTagCountRequest(QUuid requestId);
     void onAddTagRequest(Tag tag, QUuid requestId);
@@ -404,16 +464,66 @@ public Q_SLOTS:
 
     void onAccountHighUsnRequest(QString linkedNotebookGuid, QUuid requestId);
 
+    void onListChangesSinceRequest(qint64 sequenceNumber, size_t limit, QUuid requestId);
+
+    void onListResourceSyncedDataHashesRequest(QStringList noteLocalUids, QUuid requestId);
+
+    /**
+     * Retrieves the performance statistics collected by the local storage manager; if reset is true,
+     * the statistics are reset after being retrieved so that each next request returns the statistics
+     * collected since the previous one
+     */
+    void onLocalStorageStatisticsRequest(bool reset, QUuid requestId);
+
+    void onExportSnapshotRequest(QString snapshotFilePath, QUuid requestId);
+
+    /**
+     * Replaces the contents of the local storage with those of the snapshot; the local storage cache,
+     * if it is used, is cleared after the import
+     */
+    void onImportSnapshotRequest(QString snapshotFilePath, QUuid requestId);
+
+    /**
+     * Expunges the data items not referenced during the full sync in a single batch, see
+     * LocalStorageManager::expungeStaleDataItems; the local storage cache, if it is used, is cleared afterwards
+     */
+    void onExpungeStaleDataItemsRequest(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                        QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                        QString linkedNotebookGuid, QUuid requestId);
+
+protected:
+    virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
+
 private:
     LocalStorageManagerAsync() Q_DECL_EQ_DELETE;
     Q_DISABLE_COPY(LocalStorageManagerAsync)
 
+    void updateNoteImpl(Note & note, const bool updateResources, const bool updateTags,
+                        const QList<QUuid> & requestIds);
+    void flushPendingNoteUpdate(const QString & noteLocalUid);
+    void flushPendingNoteUpdates();
+
+    struct PendingNoteUpdate
+    {
+        PendingNoteUpdate();
+
+        Note            m_note;
+        bool            m_updateResources;
+        bool            m_updateTags;
+        QList<QUuid>    m_requestIds;
+        int             m_timerId;
+    };
+
     Account                     m_account;
     bool                        m_startFromScratch;
     bool                        m_overrideLock;
     LocalStorageManager *       m_pLocalStorageManager;
     bool                        m_useCache;
     LocalStorageCacheManager *  m_pLocalStorageCacheManager;
+
+    int                                 m_noteUpdateCoalescingWindowMsec;
+    QHash<QString, PendingNoteUpdate>   m_pendingNoteUpdatesByLocalUid;
+    QHash<int, QString>                 m_pendingNoteUpdateLocalUidsByTimerId;
 };
 
 } // namespace quentier
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_SNAPSHOT_INFO_H
+#define LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_SNAPSHOT_INFO_H
+
+#include <quentier/utility/Printable.h>
+#include <QHash>
+#include <QMetaType>
+
+namespace quentier {
+
+/**
+ * @brief The LocalStorageSnapshotInfo class describes the synchronization state of the account captured
+ * within the local storage snapshot created by LocalStorageManager::exportSnapshot; after the snapshot is imported,
+ * it can be passed to SynchronizationManager::setLastSyncParametersFromSnapshot so that the synchronization
+ * continues incrementally from the state captured within the snapshot instead of starting from scratch
+ */
+class QUENTIER_EXPORT LocalStorageSnapshotInfo: public Printable
+{
+public:
+    LocalStorageSnapshotInfo();
+    virtual ~LocalStorageSnapshotInfo();
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+    /**
+     * The highest update sequence number of user's own account's data items within the snapshot
+     */
+    qint32                  highUsn;
+
+    /**
+     * The highest update sequence numbers of linked notebooks' data items within the snapshot,
+     * one per each linked notebook present within the snapshot
+     */
+    QHash<QString,qint32>   highUsnByLinkedNotebookGuid;
+
+    /**
+     * The timestamp of the snapshot creation in milliseconds since epoch
+     */
+    qint64                  creationTimestamp;
+};
+
+} // namespace quentier
+
+Q_DECLARE_METATYPE(quentier::LocalStorageSnapshotInfo)
+
+#endif // LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_SNAPSHOT_INFO_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_H
+#define LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_H
+
+#include <quentier/utility/Printable.h>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+
+namespace quentier {
+
+/**
+ * @brief The LocalStorageStatistics class is the snapshot of the performance statistics collected by LocalStorageManager:
+ * latency histograms of its public operations, per SQL query shape counters and the log of the slowest SQL queries
+ * along with their query plans
+ *
+ * All durations are in microseconds
+ */
+class QUENTIER_EXPORT LocalStorageStatistics: public Printable
+{
+public:
+    /**
+     * @brief The OperationStatistics struct accumulates the latencies of a single LocalStorageManager's operation
+     * such as addNote or listNotes
+     */
+    struct QUENTIER_EXPORT OperationStatistics
+    {
+        OperationStatistics();
+
+        quint64             count;
+        qint64              totalDurationUsec;
+        qint64              maxDurationUsec;
+
+        /**
+         * The number of operations which fell into each latency bucket, see latencyHistogramBucketUpperBoundsUsec
+         * for the bucket bounds; the last bucket collects everything beyond the last bound
+         */
+        QVector<quint64>    latencyHistogram;
+    };
+
+    /**
+     * @brief The QueryStatistics struct accumulates the counters for SQL queries of the same shape, i.e. the same SQL text
+     * with literal values replaced by placeholders
+     */
+    struct QUENTIER_EXPORT QueryStatistics
+    {
+        QueryStatistics();
+
+        quint64             count;
+        quint64             failedCount;
+        qint64              totalDurationUsec;
+        qint64              maxDurationUsec;
+
+        /**
+         * The total number of rows inserted, updated or deleted by the queries of this shape; selection queries
+         * don't contribute to this counter
+         */
+        quint64             rowsAffected;
+    };
+
+    /**
+     * @brief The SlowQuery struct represents the entry of the slow query log
+     */
+    struct QUENTIER_EXPORT SlowQuery
+    {
+        SlowQuery();
+
+        QString             query;
+        QString             queryPlan;
+        qint64              durationUsec;
+        qint64              timestamp;
+    };
+
+public:
+    LocalStorageStatistics();
+    virtual ~LocalStorageStatistics();
+
+    /**
+     * @return the upper bounds of latency histogram buckets, in microseconds
+     */
+    static QVector<qint64> latencyHistogramBucketUpperBoundsUsec();
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+    /**
+     * Statistics per LocalStorageManager's operation name
+     */
+    QHash<QString, OperationStatistics>     operations;
+
+    /**
+     * Statistics per SQL query shape
+     */
+    QHash<QString, QueryStatistics>         queries;
+
+    /**
+     * The most recent SQL queries which took longer than the slow query threshold, in chronological order
+     */
+    QList<SlowQuery>                        slowQueries;
+
+    qint64                                  slowQueryThresholdUsec;
+
+    /**
+     * The time when the statistics collection was started or last reset, in milliseconds since epoch
+     */
+    qint64                                  collectionStartTimestamp;
+};
+
+} // namespace quentier
+
+Q_DECLARE_METATYPE(quentier::LocalStorageStatistics)
+
+#endif // LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_H
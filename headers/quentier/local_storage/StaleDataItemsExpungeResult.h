@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIB_QUENTIER_LOCAL_STORAGE_STALE_DATA_ITEMS_EXPUNGE_RESULT_H
+#define LIB_QUENTIER_LOCAL_STORAGE_STALE_DATA_ITEMS_EXPUNGE_RESULT_H
+
+#include <quentier/utility/Printable.h>
+#include <QStringList>
+#include <QMetaType>
+
+namespace quentier {
+
+/**
+ * @brief The StaleDataItemsExpungeResult class describes what LocalStorageManager::expungeStaleDataItems
+ * has done with the data items not referenced by the full sync: the local uids of the data items which were expunged
+ * and of the dirty data items which were preserved but stripped off their guids and update sequence numbers
+ */
+class QUENTIER_EXPORT StaleDataItemsExpungeResult: public Printable
+{
+public:
+    StaleDataItemsExpungeResult();
+    virtual ~StaleDataItemsExpungeResult();
+
+    /**
+     * @return true if nothing was expunged or stripped off the guid, false otherwise
+     */
+    bool isEmpty() const;
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+    QStringList     expungedNotebookLocalUids;
+
+    /**
+     * Local uids of expunged tags including the child tags expunged along with their parents
+     */
+    QStringList     expungedTagLocalUids;
+
+    /**
+     * Local uids of expunged notes including the notes expunged along with their notebooks
+     */
+    QStringList     expungedNoteLocalUids;
+
+    QStringList     expungedSavedSearchLocalUids;
+
+    QStringList     detachedNotebookLocalUids;
+    QStringList     detachedTagLocalUids;
+    QStringList     detachedNoteLocalUids;
+    QStringList     detachedSavedSearchLocalUids;
+};
+
+} // namespace quentier
+
+Q_DECLARE_METATYPE(quentier::StaleDataItemsExpungeResult)
+
+#endif // LIB_QUENTIER_LOCAL_STORAGE_STALE_DATA_ITEMS_EXPUNGE_RESULT_H
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_I_NOTE_STORE_H
+#define LIB_QUENTIER_SYNCHRONIZATION_I_NOTE_STORE_H
+
+#include <quentier/utility/Linkage.h>
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <quentier/types/Notebook.h>
+#include <quentier/types/Tag.h>
+#include <quentier/types/SavedSearch.h>
+#include <QObject>
+#include <QUuid>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(Resource)
+
+/**
+ * @brief The INoteStore class is the interface for the subset of Evernote's NoteStore API used by libquentier's
+ * synchronization. The default implementation talks to Evernote service via QEverCloud; alternative implementations
+ * can be passed to SynchronizationManager, for example, to synchronize against an in-process fake service.
+ *
+ * The methods returning qint32 return zero on success and the EDAM error code on failure; in case of
+ * RATE_LIMIT_REACHED error code the number of seconds to wait is returned via rateLimitSeconds parameter.
+ * The asynchronous methods return false if the request could not be started; otherwise the outcome
+ * of the request is reported via the corresponding signal.
+ */
+class QUENTIER_EXPORT INoteStore: public QObject
+{
+    Q_OBJECT
+protected:
+    explicit INoteStore(QObject * parent = Q_NULLPTR);
+
+public:
+    virtual ~INoteStore();
+
+    /**
+     * @brief create - creates the new note store of the same kind as this one; it is used to create the note stores
+     * for linked notebooks. The caller takes the ownership of the returned object
+     */
+    virtual INoteStore * create() const = 0;
+
+    /**
+     * @brief stop - cancels all the asynchronous requests in progress, their results won't be reported
+     */
+    virtual void stop() = 0;
+
+    virtual QString noteStoreUrl() const = 0;
+    virtual void setNoteStoreUrl(const QString & noteStoreUrl) = 0;
+
+    virtual QString authenticationToken() const = 0;
+    virtual void setAuthenticationToken(const QString & authToken) = 0;
+
+    virtual qint32 createNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                  const QString & linkedNotebookAuthToken = QString()) = 0;
+    virtual qint32 updateNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                  const QString & linkedNotebookAuthToken = QString()) = 0;
+
+    virtual bool createNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) = 0;
+    virtual bool updateNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) = 0;
+
+    virtual qint32 createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                              const QString & linkedNotebookAuthToken = QString()) = 0;
+    virtual qint32 updateNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                              const QString & linkedNotebookAuthToken = QString()) = 0;
+
+    virtual bool createNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                 ErrorString & errorDescription) = 0;
+    virtual bool updateNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                 ErrorString & errorDescription) = 0;
+
+    virtual qint32 createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                             const QString & linkedNotebookAuthToken = QString()) = 0;
+    virtual qint32 updateTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                             const QString & linkedNotebookAuthToken = QString()) = 0;
+
+    virtual bool createTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) = 0;
+    virtual bool updateTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) = 0;
+
+    virtual qint32 createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+    virtual qint32 updateSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+    virtual bool createSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId, ErrorString & errorDescription) = 0;
+    virtual bool updateSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId, ErrorString & errorDescription) = 0;
+
+    virtual qint32 getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+    virtual qint32 getSyncChunk(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                qint32 & rateLimitSeconds) = 0;
+
+    virtual bool getSyncChunkAsync(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                   ErrorString & errorDescription) = 0;
+
+    virtual qint32 getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
+                                              const QString & authToken, qevercloud::SyncState & syncState,
+                                              ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+    virtual qint32 getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook & linkedNotebook,
+                                              const qint32 afterUSN, const qint32 maxEntries,
+                                              const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                              qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                              qint32 & rateLimitSeconds) = 0;
+
+    virtual bool getLinkedNotebookSyncStateAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const QString & authToken, ErrorString & errorDescription) = 0;
+
+    virtual bool getLinkedNotebookSyncChunkAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const qint32 afterUSN, const qint32 maxEntries,
+                                                 const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                                 ErrorString & errorDescription) = 0;
+
+    virtual qint32 getNote(const bool withContent, const bool withResourcesData,
+                           const bool withResourcesRecognition, const bool withResourceAlternateData,
+                           Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+    virtual bool getNoteAsync(const bool withContent, const bool withResourceData, const bool withResourcesRecognition,
+                              const bool withResourceAlternateData, const bool withSharedNotes,
+                              const bool withNoteAppDataValues, const bool withResourceAppDataValues,
+                              const bool withNoteLimits, const QString & noteGuid,
+                              const QString & authToken, ErrorString & errorDescription) = 0;
+
+    virtual qint32 getResource(const bool withDataBody, const bool withRecognitionDataBody,
+                               const bool withAlternateDataBody, const bool withAttributes,
+                               const QString & authToken, Resource & resource, ErrorString & errorDescription,
+                               qint32 & rateLimitSeconds) = 0;
+
+    virtual bool getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
+                                  const bool withAlternateDataBody, const bool withAttributes, const QString & resourceGuid,
+                                  const QString & authToken, ErrorString & errorDescription) = 0;
+
+    virtual qint32 authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
+                                                ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+Q_SIGNALS:
+    void getNoteAsyncFinished(qint32 errorCode, qevercloud::Note note, qint32 rateLimitSeconds, ErrorString errorDescription);
+    void getResourceAsyncFinished(qint32 errorCode, qevercloud::Resource resource, qint32 rateLimitSeconds, ErrorString errorDescription);
+    void getSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk, qint32 afterUsn,
+                                   qint32 rateLimitSeconds, ErrorString errorDescription);
+    void getLinkedNotebookSyncStateAsyncFinished(qint32 errorCode, qevercloud::SyncState syncState, qint32 rateLimitSeconds,
+                                                 ErrorString errorDescription, QString linkedNotebookGuid);
+    void getLinkedNotebookSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk, qint32 afterUsn,
+                                                 qint32 rateLimitSeconds, ErrorString errorDescription,
+                                                 QString linkedNotebookGuid);
+
+    // The note passed with these signals has guid and update sequence number set from the service's response
+    void createNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                 QUuid requestId);
+    void updateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                 QUuid requestId);
+
+    // The same goes for the notebooks, tags and saved searches passed with these signals
+    void createNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                     QUuid requestId);
+    void updateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                     QUuid requestId);
+    void createTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                QUuid requestId);
+    void updateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds, ErrorString errorDescription,
+                                QUuid requestId);
+    void createSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                        ErrorString errorDescription, QUuid requestId);
+    void updateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                        ErrorString errorDescription, QUuid requestId);
+
+private:
+    Q_DISABLE_COPY(INoteStore)
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_I_NOTE_STORE_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_I_USER_STORE_H
+#define LIB_QUENTIER_SYNCHRONIZATION_I_USER_STORE_H
+
+#include <quentier/utility/Linkage.h>
+#include <quentier/utility/Macros.h>
+#include <quentier/types/ErrorString.h>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(User)
+
+/**
+ * @brief The IUserStore class is the interface for the subset of Evernote's UserStore API used by libquentier's
+ * synchronization. The default implementation talks to Evernote service via QEverCloud; alternative implementations
+ * can be passed to SynchronizationManager, for example, to synchronize against an in-process fake service.
+ *
+ * The methods returning qint32 return zero on success and the EDAM error code on failure; in case of
+ * RATE_LIMIT_REACHED error code the number of seconds to wait is returned via rateLimitSeconds parameter.
+ */
+class QUENTIER_EXPORT IUserStore
+{
+protected:
+    IUserStore();
+
+public:
+    virtual ~IUserStore();
+
+    virtual QString authenticationToken() const = 0;
+    virtual void setAuthenticationToken(const QString & authToken) = 0;
+
+    virtual bool checkVersion(const QString & clientName, qint16 edamVersionMajor, qint16 edamVersionMinor,
+                              ErrorString & errorDescription) = 0;
+
+    virtual qint32 getUser(User & user, ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+    virtual qint32 getAccountLimits(const qevercloud::ServiceLevel::type serviceLevel, qevercloud::AccountLimits & limits,
+                                    ErrorString & errorDescription, qint32 & rateLimitSeconds) = 0;
+
+private:
+    Q_DISABLE_COPY(IUserStore)
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_I_USER_STORE_H
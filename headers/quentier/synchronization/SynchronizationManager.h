@@ -20,17 +20,23 @@
 #define LIB_QUENTIER_SYNCHRONIZATION_SYNCHRONIZATION_MANAGER_H
 
 #include <quentier/synchronization/IAuthenticationManager.h>
+#include <quentier/local_storage/LocalStorageSnapshotInfo.h>
 #include <quentier/types/Account.h>
 #include <quentier/types/ErrorString.h>
 #include <quentier/types/LinkedNotebook.h>
+#include <quentier/types/Resource.h>
 #include <quentier/utility/Linkage.h>
 #include <quentier/utility/Macros.h>
 #include <QObject>
+#include <QUuid>
+#include <QStringList>
 
 namespace quentier {
 
 QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
 QT_FORWARD_DECLARE_CLASS(SynchronizationManagerPrivate)
+QT_FORWARD_DECLARE_CLASS(INoteStore)
+QT_FORWARD_DECLARE_CLASS(IUserStore)
 
 /**
  * @brief The SynchronizationManager class encapsulates methods and signals & slots required to perform the full or partial
@@ -48,10 +54,16 @@ public:
      *               but could be sandbox.evernote.com or some other one
      * @param localStorageManagerAsync - local storage manager
      * @param authenticationManager - authentication manager (particular implementation of IAuthenticationManager abstract class)
+     * @param pNoteStore - optional note store to use instead of the default one talking to the Evernote service;
+     *                     SynchronizationManager takes the ownership of it; the note stores for linked notebooks
+     *                     are created via its create method
+     * @param pUserStore - optional user store to use instead of the default one talking to the Evernote service;
+     *                     SynchronizationManager takes the ownership of it
      */
     SynchronizationManager(const QString & consumerKey, const QString & consumerSecret,
                            const QString & host, LocalStorageManagerAsync & localStorageManagerAsync,
-                           IAuthenticationManager & authenticationManager);
+                           IAuthenticationManager & authenticationManager,
+                           INoteStore * pNoteStore = Q_NULLPTR, IUserStore * pUserStore = Q_NULLPTR);
 
     virtual ~SynchronizationManager();
 
@@ -140,6 +152,141 @@ public Q_SLOTS:
      */
     void setInkNoteImagesStoragePath(QString path);
 
+    /**
+     * Use this slot to limit the estimated amount of memory occupied by the sync chunks downloaded during the synchronization.
+     * Once the limit is reached, notes and resources from the subsequently downloaded sync chunks are temporarily stored
+     * in a file within the folder returned by applicationTemporaryStoragePath function found in quentier/StandardPaths.h header
+     * and are read back from it when they are processed. Zero or negative value means no limit. The default limit is 256 Mb.
+     *
+     * The new limit takes effect starting from the next synchronization.
+     *
+     * After the method finishes its job, setSyncChunksMemoryLimitDone signal is emitted
+     */
+    void setSyncChunksMemoryLimit(qint64 memoryLimitBytes);
+
+    /**
+     * Use this slot to set the max number of full note and resource data downloads which can be in flight
+     * at the same time during the synchronization. The actual number of downloads in flight adapts to the rate limits
+     * of Evernote service within this bound. The value less than 1 is treated as 1. The default value is 10.
+     *
+     * The new value takes effect immediately, including the synchronization in progress.
+     *
+     * After the method finishes its job, setMaxInFlightDownloadsDone signal is emitted
+     */
+    void setMaxInFlightDownloads(int maxInFlightDownloads);
+
+    /**
+     * Use this slot to set the max number of linked notebooks which sync chunks can be downloaded at the same time
+     * during the synchronization. The value less than 1 is treated as 1. The default value is 4.
+     *
+     * The increased value takes effect immediately, including the synchronization in progress.
+     *
+     * After the method finishes its job, setMaxParallelLinkedNotebookSyncsDone signal is emitted
+     */
+    void setMaxParallelLinkedNotebookSyncs(int maxParallelLinkedNotebookSyncs);
+
+    /**
+     * Use this slot to switch the option whether the binary data of resources is downloaded during the synchronization
+     * or only on demand. When the option is enabled, the resources are put into the local storage with their data hash
+     * and size but without the data body unless the resource prefetch policy says otherwise; such resources' data
+     * can be downloaded later via downloadResourceData slot. By default the option is disabled.
+     *
+     * The new value takes effect immediately, including the synchronization in progress.
+     *
+     * After the method finishes its job, setDownloadResourceDataOnDemandDone signal is emitted
+     */
+    void setDownloadResourceDataOnDemand(bool flag);
+
+    /**
+     * Use this slot to specify which resources' binary data is still downloaded during the synchronization when
+     * the resources' data is downloaded on demand: the data is downloaded for notes modified within the specified number
+     * of days before the synchronization if the total size of the note's resources' data doesn't exceed the specified limit.
+     * Zero or negative number of days means no data is downloaded during the synchronization, zero or negative size
+     * means no limit on the data size. By default no data is downloaded during the synchronization.
+     *
+     * After the method finishes its job, setResourceDataPrefetchPolicyDone signal is emitted
+     */
+    void setResourceDataPrefetchPolicy(qint32 maxNoteAgeDays, qint64 maxNoteResourcesSizeBytes);
+
+    /**
+     * Use this slot to tell which notes are currently visible to the user: the contents, thumbnails and ink note images
+     * of these notes are downloaded before the ones of other notes during the synchronization. The setting
+     * is not persistent, the empty list means no note is visible.
+     *
+     * After the method finishes its job, setVisibleNoteGuidsDone signal is emitted
+     */
+    void setVisibleNoteGuids(QStringList noteGuids);
+
+    /**
+     * Use this slot to restrict the synchronization of notes and resources to the chosen notebooks and tags:
+     * only the notes from the chosen notebooks or labeled with any of the chosen tags are downloaded.
+     * Notebooks, tags, saved searches and linked notebooks are always synchronized in full. The empty lists
+     * of notebook and tag guids remove the restriction. The setting is persistent and takes effect since
+     * the next synchronization; if it selects notes which were skipped by the previous synchronizations,
+     * these notes are downloaded as well. Narrowing the selection doesn't remove the already synchronized
+     * notes from the local storage.
+     *
+     * After the method finishes its job, setSelectiveSyncFilterDone signal is emitted
+     */
+    void setSelectiveSyncFilter(QStringList notebookGuids, QStringList tagGuids);
+
+    /**
+     * Use this slot to request the contents of particular notes to be downloaded as soon as possible, for example,
+     * when the user opens the note which content is not synchronized yet. The full note and resource data downloads
+     * are ordered by urgency: the requested notes go first, then the visible ones (see setVisibleNoteGuids),
+     * then the notes from the last used notebook, then the recently modified notes and then the rest of notes.
+     * The new order applies to the downloads not started yet right away, the downloads already in progress
+     * are not interrupted. Each call replaces the previously requested notes, the empty list cancels the request.
+     *
+     * After the method finishes its job, prioritizeNoteDownloadsDone signal is emitted
+     */
+    void prioritizeNoteDownloads(QStringList noteGuids);
+
+    /**
+     * Use this slot to switch the tracing of the synchronization on or off. When the tracing is on, the timeline
+     * of the synchronization phases (sync chunks download, merge of tags, notebooks, notes and resources, conflicts
+     * resolution, notes and resources download, writes to the local storage, expunging, sending the local changes
+     * and the waits for the API rate limit to expire) is recorded along with the item counts and byte sizes;
+     * the summary of per-phase metrics is logged after each synchronization. The trace is kept until the next
+     * synchronization starts and can be exported via exportSyncTrace slot. By default the tracing is off.
+     *
+     * After the method finishes its job, setSyncTracingEnabledDone signal is emitted
+     */
+    void setSyncTracingEnabled(bool flag);
+
+    /**
+     * Use this slot to write the trace of the last or current synchronization into the file in Chrome trace event
+     * format which can be loaded into chrome://tracing or any compatible viewer.
+     *
+     * After the method finishes its job, exportSyncTraceDone signal is emitted
+     */
+    void exportSyncTrace(QString filePath);
+
+    /**
+     * Use this slot after the local storage of the current account was replaced with the snapshot imported via
+     * LocalStorageManager::importSnapshot: the high USNs recorded in the snapshot for the user's own account
+     * and for linked notebooks become the persistent last update counts and the time of the snapshot's creation
+     * becomes the last sync time, so the next synchronization is the incremental one continuing from the state
+     * of the snapshot instead of the full one. The slot has no effect if the account is local or the synchronization
+     * is in progress.
+     *
+     * After the method finishes its job, setLastSyncParametersFromSnapshotDone signal is emitted
+     */
+    void setLastSyncParametersFromSnapshot(LocalStorageSnapshotInfo snapshotInfo);
+
+    /**
+     * Use this slot to download the binary data of the resource which was synchronized without it: the downloaded data
+     * is put into the local storage and then either downloadResourceDataComplete or downloadResourceDataFailed signal is emitted.
+     * The download requires valid authentication and, for resources from linked notebooks, the linked notebook needs to be
+     * synchronized during the current session; the download is not retried if the Evernote API rate limit is reached.
+     *
+     * @param resource - the resource from the local storage, must have guid set
+     * @param linkedNotebookGuid - the guid of the linked notebook the resource's note belongs to, empty for the resources
+     * from the user's own account
+     * @param requestId - the id of the request, passed back with the signal reporting the result
+     */
+    void downloadResourceData(Resource resource, QString linkedNotebookGuid, QUuid requestId);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the synchronization is started (authentication is not considered a part of
@@ -251,8 +398,8 @@ Q_SIGNALS:
      * This signal is emitted during linked notebooks sync chunks downloading and denotes the progress of that step,
      * individually for each linked notebook. The percentage of completeness can be computed roughly as
      * (highestDownloadedUsn - lastPreviousUsn) / (highestServerUsn - lastPreviousUsn) * 100%.
-     * The sync chunks for each linked notebook are downloaded sequentially so the signals for one linked notebook
-     * should not intermix with signals for other linked notebooks, however, it is within hands of Qt's slot schedulers
+     * The sync chunks for several linked notebooks can be downloaded at the same time so the signals for one linked notebook
+     * can intermix with signals for other linked notebooks; the signals for each linked notebook come in order
      *
      * @param highestDownloadedUsn denotes the highest update sequence number within data items from linked notebook
      * sync chunks downloaded so far
@@ -270,6 +417,22 @@ Q_SIGNALS:
      */
     void linkedNotebooksSyncChunksDownloaded();
 
+    /**
+     * This signal is emitted when all the sync chunks for the particular linked notebook are downloaded
+     * during "remote to local" synchronization step
+     * @param linkedNotebook denotes the linked notebook which sync chunks were downloaded
+     */
+    void linkedNotebookSyncChunksDownloadFinished(LinkedNotebook linkedNotebook);
+
+    /**
+     * This signal is emitted when the sync chunks for the particular linked notebook could not be downloaded,
+     * for example, because the linked notebook is no longer accessible. Such linked notebook is skipped
+     * within the current synchronization while the rest of linked notebooks are synchronized as usual
+     * @param linkedNotebook denotes the linked notebook which failed to synchronize
+     * @param errorDescription contains the description of the error
+     */
+    void linkedNotebookSyncFailed(LinkedNotebook linkedNotebook, ErrorString errorDescription);
+
     /**
      * This signal is emitted on each successful download of full note data from user's own account
      * @param notesDownloaded is the number of notes downloaded by the moment
@@ -337,6 +500,81 @@ Q_SIGNALS:
      */
     void setInkNoteImagesStoragePathDone(QString path);
 
+    /**
+     * This signal is emitted in response to invoking the setSyncChunksMemoryLimit slot after the setting is accepted
+     */
+    void setSyncChunksMemoryLimitDone(qint64 memoryLimitBytes);
+
+    /**
+     * This signal is emitted in response to invoking the setMaxInFlightDownloads slot after the setting is accepted
+     */
+    void setMaxInFlightDownloadsDone(int maxInFlightDownloads);
+
+    /**
+     * This signal is emitted in response to invoking the setMaxParallelLinkedNotebookSyncs slot after the setting is accepted
+     */
+    void setMaxParallelLinkedNotebookSyncsDone(int maxParallelLinkedNotebookSyncs);
+
+    /**
+     * This signal is emitted in response to invoking the setDownloadResourceDataOnDemand slot after the setting is accepted
+     */
+    void setDownloadResourceDataOnDemandDone(bool flag);
+
+    /**
+     * This signal is emitted in response to invoking the setResourceDataPrefetchPolicy slot after the setting is accepted
+     */
+    void setResourceDataPrefetchPolicyDone(qint32 maxNoteAgeDays, qint64 maxNoteResourcesSizeBytes);
+
+    /**
+     * This signal is emitted in response to invoking the setVisibleNoteGuids slot after the setting is accepted
+     */
+    void setVisibleNoteGuidsDone(QStringList noteGuids);
+
+    /**
+     * This signal is emitted in response to invoking the setSelectiveSyncFilter slot after the setting is accepted
+     */
+    void setSelectiveSyncFilterDone(QStringList notebookGuids, QStringList tagGuids);
+
+    /**
+     * This signal is emitted in response to invoking the prioritizeNoteDownloads slot after the request is accepted
+     */
+    void prioritizeNoteDownloadsDone(QStringList noteGuids);
+
+    /**
+     * This signal is emitted in response to invoking the setSyncTracingEnabled slot after the setting is accepted
+     */
+    void setSyncTracingEnabledDone(bool flag);
+
+    /**
+     * This signal is emitted in response to invoking the exportSyncTrace slot
+     * @param success - true if the trace was written to the file, false otherwise
+     * @param filePath - the path to the file passed to exportSyncTrace slot
+     * @param errorDescription - the textual explanation of the failure to write the trace to the file
+     */
+    void exportSyncTraceDone(bool success, QString filePath, ErrorString errorDescription);
+
+    /**
+     * This signal is emitted in response to invoking the setLastSyncParametersFromSnapshot slot
+     * @param success - true if the last sync parameters were set from the snapshot info, false otherwise
+     * @param snapshotInfo - the snapshot info passed to setLastSyncParametersFromSnapshot slot
+     * @param errorDescription - the textual explanation of the failure to set the last sync parameters
+     */
+    void setLastSyncParametersFromSnapshotDone(bool success, LocalStorageSnapshotInfo snapshotInfo,
+                                               ErrorString errorDescription);
+
+    /**
+     * This signal is emitted when the binary data of the resource requested via downloadResourceData slot
+     * has been downloaded and put into the local storage
+     * @param resource - the resource with the downloaded binary data
+     */
+    void downloadResourceDataComplete(Resource resource, QUuid requestId);
+
+    /**
+     * This signal is emitted when the binary data of the resource requested via downloadResourceData slot
+     * could not be downloaded or put into the local storage
+     */
+    void downloadResourceDataFailed(Resource resource, ErrorString errorDescription, QUuid requestId);
+
 private:
     SynchronizationManager() Q_DECL_EQ_DELETE;
     Q_DISABLE_COPY(SynchronizationManager)
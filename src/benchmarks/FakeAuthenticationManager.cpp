@@ -0,0 +1,42 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FakeAuthenticationManager.h"
+#include <QDateTime>
+
+// The fake authentication token never expires during the benchmark: it is valid for a year
+#define FAKE_AUTH_TOKEN_LIFETIME_MSEC (Q_INT64_C(365) * 24 * 60 * 60 * 1000)
+
+namespace quentier {
+namespace benchmark {
+
+FakeAuthenticationManager::FakeAuthenticationManager(const qevercloud::UserID userId, QObject * parent) :
+    IAuthenticationManager(parent),
+    m_userId(userId)
+{}
+
+void FakeAuthenticationManager::onAuthenticationRequest()
+{
+    qevercloud::Timestamp expirationTime = QDateTime::currentMSecsSinceEpoch() + FAKE_AUTH_TOKEN_LIFETIME_MSEC;
+    Q_EMIT sendAuthenticationResult(/* success = */ true, m_userId, QStringLiteral("fake_auth_token"), expirationTime,
+                                    QStringLiteral("s1"), QStringLiteral("https://fake.evernote.local/shard/s1/notestore"),
+                                    QStringLiteral("https://fake.evernote.local/shard/s1/"), ErrorString());
+}
+
+} // namespace benchmark
+} // namespace quentier
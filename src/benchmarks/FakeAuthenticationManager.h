@@ -0,0 +1,47 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_FAKE_AUTHENTICATION_MANAGER_H
+#define LIB_QUENTIER_BENCHMARKS_FAKE_AUTHENTICATION_MANAGER_H
+
+#include <quentier/synchronization/IAuthenticationManager.h>
+
+namespace quentier {
+namespace benchmark {
+
+/**
+ * @brief The FakeAuthenticationManager class immediately "authenticates" the fake sync service's user
+ * with the long living fake authentication token
+ */
+class FakeAuthenticationManager: public IAuthenticationManager
+{
+    Q_OBJECT
+public:
+    explicit FakeAuthenticationManager(const qevercloud::UserID userId, QObject * parent = Q_NULLPTR);
+
+public Q_SLOTS:
+    virtual void onAuthenticationRequest() Q_DECL_OVERRIDE;
+
+private:
+    qevercloud::UserID  m_userId;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_FAKE_AUTHENTICATION_MANAGER_H
@@ -0,0 +1,628 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FakeNoteStore.h"
+#include "FakeSyncService.h"
+#include <quentier/types/Notebook.h>
+#include <quentier/types/Resource.h>
+#include <quentier/types/Tag.h>
+#include <quentier/types/SavedSearch.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTimerEvent>
+#include <algorithm>
+
+namespace quentier {
+namespace benchmark {
+
+FakeNoteStore::AsyncReply::AsyncReply() :
+    m_type(Type::GetNote),
+    m_errorCode(0),
+    m_rateLimitSeconds(0),
+    m_errorDescription(),
+    m_qecNote(),
+    m_resource(),
+    m_syncChunk(),
+    m_syncState(),
+    m_afterUsn(0),
+    m_linkedNotebookGuid(),
+    m_note(),
+    m_notebook(),
+    m_tag(),
+    m_savedSearch(),
+    m_requestId()
+{}
+
+FakeNoteStore::FakeNoteStore(FakeSyncService & service, QObject * parent) :
+    INoteStore(parent),
+    m_service(service),
+    m_noteStoreUrl(),
+    m_authToken(),
+    m_asyncRepliesByTimerId(),
+    m_numScheduledAsyncReplies(0)
+{}
+
+FakeNoteStore::~FakeNoteStore()
+{
+    stop();
+}
+
+INoteStore * FakeNoteStore::create() const
+{
+    return new FakeNoteStore(m_service);
+}
+
+void FakeNoteStore::stop()
+{
+    for(auto it = m_asyncRepliesByTimerId.constBegin(), end = m_asyncRepliesByTimerId.constEnd(); it != end; ++it) {
+        killTimer(it.key());
+    }
+
+    m_asyncRepliesByTimerId.clear();
+}
+
+QString FakeNoteStore::noteStoreUrl() const
+{
+    return m_noteStoreUrl;
+}
+
+void FakeNoteStore::setNoteStoreUrl(const QString & noteStoreUrl)
+{
+    m_noteStoreUrl = noteStoreUrl;
+}
+
+QString FakeNoteStore::authenticationToken() const
+{
+    return m_authToken;
+}
+
+void FakeNoteStore::setAuthenticationToken(const QString & authToken)
+{
+    m_authToken = authToken;
+}
+
+qint32 FakeNoteStore::createNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                     const QString & linkedNotebookAuthToken)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+    simulateLatency();
+    return sendNotebook(notebook, errorDescription, rateLimitSeconds);
+}
+
+qint32 FakeNoteStore::updateNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                     const QString & linkedNotebookAuthToken)
+{
+    return createNotebook(notebook, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
+}
+
+bool FakeNoteStore::createNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                        const QUuid & requestId, ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::CreateNotebook;
+    reply.m_notebook = notebook;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendNotebook(reply.m_notebook, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+bool FakeNoteStore::updateNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                        const QUuid & requestId, ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::UpdateNotebook;
+    reply.m_notebook = notebook;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendNotebook(reply.m_notebook, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                 const QString & linkedNotebookAuthToken)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+    simulateLatency();
+    return sendNote(note, errorDescription, rateLimitSeconds);
+}
+
+qint32 FakeNoteStore::updateNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                 const QString & linkedNotebookAuthToken)
+{
+    return createNote(note, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
+}
+
+bool FakeNoteStore::createNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                    ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::CreateNote;
+    reply.m_note = note;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendNote(reply.m_note, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+bool FakeNoteStore::updateNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                    ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::UpdateNote;
+    reply.m_note = note;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendNote(reply.m_note, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                const QString & linkedNotebookAuthToken)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+    simulateLatency();
+    return sendTag(tag, errorDescription, rateLimitSeconds);
+}
+
+qint32 FakeNoteStore::updateTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                const QString & linkedNotebookAuthToken)
+{
+    return createTag(tag, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
+}
+
+bool FakeNoteStore::createTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                   ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::CreateTag;
+    reply.m_tag = tag;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendTag(reply.m_tag, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+bool FakeNoteStore::updateTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                   ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::UpdateTag;
+    reply.m_tag = tag;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendTag(reply.m_tag, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    simulateLatency();
+    return sendSavedSearch(savedSearch, errorDescription, rateLimitSeconds);
+}
+
+qint32 FakeNoteStore::updateSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    return createSavedSearch(savedSearch, errorDescription, rateLimitSeconds);
+}
+
+bool FakeNoteStore::createSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                           ErrorString & errorDescription)
+{
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::CreateSavedSearch;
+    reply.m_savedSearch = savedSearch;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendSavedSearch(reply.m_savedSearch, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+bool FakeNoteStore::updateSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                           ErrorString & errorDescription)
+{
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::UpdateSavedSearch;
+    reply.m_savedSearch = savedSearch;
+    reply.m_requestId = requestId;
+    reply.m_errorCode = sendSavedSearch(reply.m_savedSearch, reply.m_errorDescription, reply.m_rateLimitSeconds);
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        syncState = m_service.syncState();
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::getSyncChunk(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                   qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                   qint32 & rateLimitSeconds)
+{
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        syncChunk = m_service.syncChunk(afterUSN, maxEntries, filter);
+    }
+
+    return errorCode;
+}
+
+bool FakeNoteStore::getSyncChunkAsync(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                      ErrorString & errorDescription)
+{
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::GetSyncChunk;
+    reply.m_afterUsn = afterUSN;
+    reply.m_errorCode = m_service.processRequest(reply.m_errorDescription, reply.m_rateLimitSeconds);
+    if (reply.m_errorCode == 0) {
+        reply.m_syncChunk = m_service.syncChunk(afterUSN, maxEntries, filter);
+    }
+
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const QString & authToken, qevercloud::SyncState & syncState,
+                                                 ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(authToken)
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        errorCode = m_service.linkedNotebookSyncState(linkedNotebook.guid.isSet() ? linkedNotebook.guid.ref() : QString(),
+                                                      syncState, errorDescription);
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const qint32 afterUSN, const qint32 maxEntries,
+                                                 const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                                 qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                                 qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+    Q_UNUSED(fullSyncOnly)
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        errorCode = m_service.linkedNotebookSyncChunk(linkedNotebook.guid.isSet() ? linkedNotebook.guid.ref() : QString(),
+                                                      afterUSN, maxEntries, syncChunk, errorDescription);
+    }
+
+    return errorCode;
+}
+
+bool FakeNoteStore::getLinkedNotebookSyncStateAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                    const QString & authToken, ErrorString & errorDescription)
+{
+    Q_UNUSED(authToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::GetLinkedNotebookSyncState;
+    reply.m_linkedNotebookGuid = (linkedNotebook.guid.isSet() ? linkedNotebook.guid.ref() : QString());
+    reply.m_errorCode = m_service.processRequest(reply.m_errorDescription, reply.m_rateLimitSeconds);
+    if (reply.m_errorCode == 0) {
+        reply.m_errorCode = m_service.linkedNotebookSyncState(reply.m_linkedNotebookGuid, reply.m_syncState,
+                                                              reply.m_errorDescription);
+    }
+
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+bool FakeNoteStore::getLinkedNotebookSyncChunkAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                    const qint32 afterUSN, const qint32 maxEntries,
+                                                    const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                                    ErrorString & errorDescription)
+{
+    Q_UNUSED(linkedNotebookAuthToken)
+    Q_UNUSED(fullSyncOnly)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::GetLinkedNotebookSyncChunk;
+    reply.m_afterUsn = afterUSN;
+    reply.m_linkedNotebookGuid = (linkedNotebook.guid.isSet() ? linkedNotebook.guid.ref() : QString());
+    reply.m_errorCode = m_service.processRequest(reply.m_errorDescription, reply.m_rateLimitSeconds);
+    if (reply.m_errorCode == 0) {
+        reply.m_errorCode = m_service.linkedNotebookSyncChunk(reply.m_linkedNotebookGuid, afterUSN, maxEntries,
+                                                              reply.m_syncChunk, reply.m_errorDescription);
+    }
+
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::getNote(const bool withContent, const bool withResourcesData,
+                              const bool withResourcesRecognition, const bool withResourceAlternateData,
+                              Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode != 0) {
+        return errorCode;
+    }
+
+    qevercloud::Note qecNote;
+    if (!m_service.findNote(note.guid(), withContent, withResourcesData, withResourcesRecognition,
+                            withResourceAlternateData, qecNote))
+    {
+        errorDescription.setBase(QT_TR_NOOP("Note not found"));
+        errorDescription.details() = note.guid();
+        return qevercloud::EDAMErrorCode::UNKNOWN;
+    }
+
+    note.qevercloudNote() = qecNote;
+    return 0;
+}
+
+bool FakeNoteStore::getNoteAsync(const bool withContent, const bool withResourceData, const bool withResourcesRecognition,
+                                 const bool withResourceAlternateData, const bool withSharedNotes,
+                                 const bool withNoteAppDataValues, const bool withResourceAppDataValues,
+                                 const bool withNoteLimits, const QString & noteGuid,
+                                 const QString & authToken, ErrorString & errorDescription)
+{
+    Q_UNUSED(withSharedNotes)
+    Q_UNUSED(withNoteAppDataValues)
+    Q_UNUSED(withResourceAppDataValues)
+    Q_UNUSED(withNoteLimits)
+    Q_UNUSED(authToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::GetNote;
+    reply.m_qecNote.guid = noteGuid;
+    reply.m_errorCode = m_service.processRequest(reply.m_errorDescription, reply.m_rateLimitSeconds);
+    if ((reply.m_errorCode == 0) &&
+        !m_service.findNote(noteGuid, withContent, withResourceData, withResourcesRecognition,
+                            withResourceAlternateData, reply.m_qecNote))
+    {
+        reply.m_errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        reply.m_errorDescription.setBase(QT_TR_NOOP("Note not found"));
+        reply.m_errorDescription.details() = noteGuid;
+    }
+
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::getResource(const bool withDataBody, const bool withRecognitionDataBody,
+                                  const bool withAlternateDataBody, const bool withAttributes,
+                                  const QString & authToken, Resource & resource, ErrorString & errorDescription,
+                                  qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(withAttributes)
+    Q_UNUSED(authToken)
+    simulateLatency();
+
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode != 0) {
+        return errorCode;
+    }
+
+    qevercloud::Resource qecResource;
+    if (!m_service.findResource(resource.guid(), withDataBody, withRecognitionDataBody, withAlternateDataBody, qecResource)) {
+        errorDescription.setBase(QT_TR_NOOP("Resource not found"));
+        errorDescription.details() = resource.guid();
+        return qevercloud::EDAMErrorCode::UNKNOWN;
+    }
+
+    resource.qevercloudResource() = qecResource;
+    return 0;
+}
+
+bool FakeNoteStore::getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
+                                     const bool withAlternateDataBody, const bool withAttributes, const QString & resourceGuid,
+                                     const QString & authToken, ErrorString & errorDescription)
+{
+    Q_UNUSED(withAttributes)
+    Q_UNUSED(authToken)
+
+    AsyncReply reply;
+    reply.m_type = AsyncReply::Type::GetResource;
+    reply.m_resource.guid = resourceGuid;
+    reply.m_errorCode = m_service.processRequest(reply.m_errorDescription, reply.m_rateLimitSeconds);
+    if ((reply.m_errorCode == 0) &&
+        !m_service.findResource(resourceGuid, withDataBody, withRecognitionDataBody, withAlternateDataBody, reply.m_resource))
+    {
+        reply.m_errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        reply.m_errorDescription.setBase(QT_TR_NOOP("Resource not found"));
+        reply.m_errorDescription.details() = resourceGuid;
+    }
+
+    return scheduleAsyncReply(reply, errorDescription);
+}
+
+qint32 FakeNoteStore::authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
+                                                   ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(shareKey)
+    Q_UNUSED(authResult)
+    Q_UNUSED(rateLimitSeconds)
+    return unsupportedRequest("authenticateToSharedNotebook", errorDescription);
+}
+
+void FakeNoteStore::timerEvent(QTimerEvent * pEvent)
+{
+    if (Q_UNLIKELY(!pEvent)) {
+        return;
+    }
+
+    int timerId = pEvent->timerId();
+    killTimer(timerId);
+
+    auto it = m_asyncRepliesByTimerId.find(timerId);
+    if (it == m_asyncRepliesByTimerId.end()) {
+        return;
+    }
+
+    AsyncReply reply = it.value();
+    Q_UNUSED(m_asyncRepliesByTimerId.erase(it))
+
+    switch(reply.m_type)
+    {
+    case AsyncReply::Type::GetNote:
+        Q_EMIT getNoteAsyncFinished(reply.m_errorCode, reply.m_qecNote, reply.m_rateLimitSeconds, reply.m_errorDescription);
+        break;
+    case AsyncReply::Type::GetResource:
+        Q_EMIT getResourceAsyncFinished(reply.m_errorCode, reply.m_resource, reply.m_rateLimitSeconds, reply.m_errorDescription);
+        break;
+    case AsyncReply::Type::GetSyncChunk:
+        Q_EMIT getSyncChunkAsyncFinished(reply.m_errorCode, reply.m_syncChunk, reply.m_afterUsn,
+                                         reply.m_rateLimitSeconds, reply.m_errorDescription);
+        break;
+    case AsyncReply::Type::GetLinkedNotebookSyncState:
+        Q_EMIT getLinkedNotebookSyncStateAsyncFinished(reply.m_errorCode, reply.m_syncState, reply.m_rateLimitSeconds,
+                                                       reply.m_errorDescription, reply.m_linkedNotebookGuid);
+        break;
+    case AsyncReply::Type::GetLinkedNotebookSyncChunk:
+        Q_EMIT getLinkedNotebookSyncChunkAsyncFinished(reply.m_errorCode, reply.m_syncChunk, reply.m_afterUsn,
+                                                       reply.m_rateLimitSeconds, reply.m_errorDescription,
+                                                       reply.m_linkedNotebookGuid);
+        break;
+    case AsyncReply::Type::CreateNote:
+        Q_EMIT createNoteAsyncFinished(reply.m_errorCode, reply.m_note, reply.m_rateLimitSeconds,
+                                       reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::UpdateNote:
+        Q_EMIT updateNoteAsyncFinished(reply.m_errorCode, reply.m_note, reply.m_rateLimitSeconds,
+                                       reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::CreateNotebook:
+        Q_EMIT createNotebookAsyncFinished(reply.m_errorCode, reply.m_notebook, reply.m_rateLimitSeconds,
+                                           reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::UpdateNotebook:
+        Q_EMIT updateNotebookAsyncFinished(reply.m_errorCode, reply.m_notebook, reply.m_rateLimitSeconds,
+                                           reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::CreateTag:
+        Q_EMIT createTagAsyncFinished(reply.m_errorCode, reply.m_tag, reply.m_rateLimitSeconds,
+                                      reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::UpdateTag:
+        Q_EMIT updateTagAsyncFinished(reply.m_errorCode, reply.m_tag, reply.m_rateLimitSeconds,
+                                      reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::CreateSavedSearch:
+        Q_EMIT createSavedSearchAsyncFinished(reply.m_errorCode, reply.m_savedSearch, reply.m_rateLimitSeconds,
+                                              reply.m_errorDescription, reply.m_requestId);
+        break;
+    case AsyncReply::Type::UpdateSavedSearch:
+        Q_EMIT updateSavedSearchAsyncFinished(reply.m_errorCode, reply.m_savedSearch, reply.m_rateLimitSeconds,
+                                              reply.m_errorDescription, reply.m_requestId);
+        break;
+    }
+}
+
+void FakeNoteStore::simulateLatency()
+{
+    // NOTE: much like QEverCloud's synchronous calls, the simulated one spins the local event loop while waiting
+    const int latencyMsec = m_service.settings().m_latencyMsec;
+    if (latencyMsec <= 0) {
+        return;
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(latencyMsec, &loop, SLOT(quit()));
+    Q_UNUSED(loop.exec())
+}
+
+bool FakeNoteStore::scheduleAsyncReply(const AsyncReply & reply, ErrorString & errorDescription)
+{
+    int latencyMsec = std::max(m_service.settings().m_latencyMsec, 0);
+    if (m_service.settings().m_reorderAsyncReplies && ((m_numScheduledAsyncReplies % 2) == 0)) {
+        latencyMsec = 2 * latencyMsec + 1;
+    }
+
+    ++m_numScheduledAsyncReplies;
+
+    int timerId = startTimer(latencyMsec);
+    if (Q_UNLIKELY(timerId == 0)) {
+        errorDescription.setBase(QT_TR_NOOP("Failed to start the timer to deliver the fake service's reply"));
+        return false;
+    }
+
+    m_asyncRepliesByTimerId[timerId] = reply;
+    return true;
+}
+
+qint32 FakeNoteStore::sendNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        m_service.putNote(note.qevercloudNote());
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::sendNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        m_service.putNotebook(notebook.qevercloudNotebook());
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::sendTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        m_service.putTag(tag.qevercloudTag());
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::sendSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    qint32 errorCode = m_service.processRequest(errorDescription, rateLimitSeconds);
+    if (errorCode == 0) {
+        m_service.putSavedSearch(savedSearch.qevercloudSavedSearch());
+    }
+
+    return errorCode;
+}
+
+qint32 FakeNoteStore::unsupportedRequest(const char * method, ErrorString & errorDescription) const
+{
+    errorDescription.setBase(QT_TR_NOOP("The request is not supported by the fake sync service"));
+    errorDescription.details() = QString::fromLatin1(method);
+    QNWARNING(errorDescription);
+    return qevercloud::EDAMErrorCode::UNSUPPORTED_OPERATION;
+}
+
+} // namespace benchmark
+} // namespace quentier
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_FAKE_NOTE_STORE_H
+#define LIB_QUENTIER_BENCHMARKS_FAKE_NOTE_STORE_H
+
+#include <quentier/synchronization/INoteStore.h>
+#include <QHash>
+
+namespace quentier {
+namespace benchmark {
+
+QT_FORWARD_DECLARE_CLASS(FakeSyncService)
+
+/**
+ * @brief The FakeNoteStore class implements INoteStore on top of FakeSyncService; the results of asynchronous
+ * requests are delivered via the event loop after the simulated latency, much like with the real note store
+ */
+class FakeNoteStore: public INoteStore
+{
+    Q_OBJECT
+public:
+    explicit FakeNoteStore(FakeSyncService & service, QObject * parent = Q_NULLPTR);
+    virtual ~FakeNoteStore();
+
+    virtual INoteStore * create() const Q_DECL_OVERRIDE;
+
+    virtual void stop() Q_DECL_OVERRIDE;
+
+    virtual QString noteStoreUrl() const Q_DECL_OVERRIDE;
+    virtual void setNoteStoreUrl(const QString & noteStoreUrl) Q_DECL_OVERRIDE;
+
+    virtual QString authenticationToken() const Q_DECL_OVERRIDE;
+    virtual void setAuthenticationToken(const QString & authToken) Q_DECL_OVERRIDE;
+
+    virtual qint32 createNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                  const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                                  const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    virtual bool createNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+    virtual bool updateNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                              const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                              const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    virtual bool createNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                 ErrorString & errorDescription) Q_DECL_OVERRIDE;
+    virtual bool updateNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                 ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                             const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds,
+                             const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    virtual bool createTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) Q_DECL_OVERRIDE;
+    virtual bool updateTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription,
+                                     qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+    virtual qint32 updateSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription,
+                                     qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool createSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                        ErrorString & errorDescription) Q_DECL_OVERRIDE;
+    virtual bool updateSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                        ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription,
+                                qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual qint32 getSyncChunk(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool getSyncChunkAsync(const qint32 afterUSN, const qint32 maxEntries, const qevercloud::SyncChunkFilter & filter,
+                                   ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
+                                              const QString & authToken, qevercloud::SyncState & syncState,
+                                              ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual qint32 getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook & linkedNotebook,
+                                              const qint32 afterUSN, const qint32 maxEntries,
+                                              const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                              qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
+                                              qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool getLinkedNotebookSyncStateAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual bool getLinkedNotebookSyncChunkAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                 const qint32 afterUSN, const qint32 maxEntries,
+                                                 const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                                 ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getNote(const bool withContent, const bool withResourcesData,
+                           const bool withResourcesRecognition, const bool withResourceAlternateData,
+                           Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool getNoteAsync(const bool withContent, const bool withResourceData, const bool withResourcesRecognition,
+                              const bool withResourceAlternateData, const bool withSharedNotes,
+                              const bool withNoteAppDataValues, const bool withResourceAppDataValues,
+                              const bool withNoteLimits, const QString & noteGuid,
+                              const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getResource(const bool withDataBody, const bool withRecognitionDataBody,
+                               const bool withAlternateDataBody, const bool withAttributes,
+                               const QString & authToken, Resource & resource, ErrorString & errorDescription,
+                               qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
+                                  const bool withAlternateDataBody, const bool withAttributes, const QString & resourceGuid,
+                                  const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
+                                                ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+private:
+    virtual void timerEvent(QTimerEvent * pEvent) Q_DECL_OVERRIDE;
+
+private:
+    struct AsyncReply
+    {
+        struct Type
+        {
+            enum type {
+                GetNote = 0,
+                GetResource,
+                GetSyncChunk,
+                GetLinkedNotebookSyncState,
+                GetLinkedNotebookSyncChunk,
+                CreateNote,
+                UpdateNote,
+                CreateNotebook,
+                UpdateNotebook,
+                CreateTag,
+                UpdateTag,
+                CreateSavedSearch,
+                UpdateSavedSearch
+            };
+        };
+
+        AsyncReply();
+
+        Type::type              m_type;
+        qint32                  m_errorCode;
+        qint32                  m_rateLimitSeconds;
+        ErrorString             m_errorDescription;
+        qevercloud::Note        m_qecNote;
+        qevercloud::Resource    m_resource;
+        qevercloud::SyncChunk   m_syncChunk;
+        qevercloud::SyncState   m_syncState;
+        qint32                  m_afterUsn;
+        QString                 m_linkedNotebookGuid;
+        Note                    m_note;
+        Notebook                m_notebook;
+        Tag                     m_tag;
+        SavedSearch             m_savedSearch;
+        QUuid                   m_requestId;
+    };
+
+    void simulateLatency();
+    bool scheduleAsyncReply(const AsyncReply & reply, ErrorString & errorDescription);
+    qint32 sendNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+    qint32 sendNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+    qint32 sendTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+    qint32 sendSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+    qint32 unsupportedRequest(const char * method, ErrorString & errorDescription) const;
+
+private:
+    Q_DISABLE_COPY(FakeNoteStore)
+
+private:
+    FakeSyncService &           m_service;
+    QString                     m_noteStoreUrl;
+    QString                     m_authToken;
+    QHash<int, AsyncReply>      m_asyncRepliesByTimerId;
+    qint64                      m_numScheduledAsyncReplies;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_FAKE_NOTE_STORE_H
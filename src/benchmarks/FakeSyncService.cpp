@@ -0,0 +1,876 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FakeSyncService.h"
+#include "SyntheticDatasetGenerator.h"
+#include <quentier/types/Note.h>
+#include <quentier/types/Resource.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <algorithm>
+
+#define FAKE_USER_ID (1)
+#define MAX_TAGS_PER_NOTE (4)
+#define MAX_RESOURCES_PER_NOTE (2)
+
+namespace quentier {
+namespace benchmark {
+
+FakeSyncService::Settings::Settings() :
+    m_latencyMsec(0),
+    m_rateLimitEveryNthRequest(0),
+    m_rateLimitSeconds(1),
+    m_reorderAsyncReplies(false),
+    m_recordNoteRequests(false)
+{}
+
+FakeSyncService::NoteRequest::NoteRequest() :
+    m_withContent(false),
+    m_withResourcesData(false),
+    m_withResourcesRecognition(false),
+    m_withResourcesAlternateData(false)
+{}
+
+FakeSyncService::Statistics::Statistics() :
+    m_numRequests(0),
+    m_numSyncStateRequests(0),
+    m_numSyncChunkRequests(0),
+    m_numNoteRequests(0),
+    m_numResourceRequests(0),
+    m_numUploadRequests(0),
+    m_numRateLimitedRequests(0),
+    m_payloadBytes(0)
+{}
+
+FakeSyncService::LinkedNotebookData::LinkedNotebookData() :
+    m_linkedNotebook(),
+    m_notebook(),
+    m_noteGuids(),
+    m_accessible(true)
+{}
+
+FakeSyncService::FakeSyncService(const quint32 seed, const Settings & settings) :
+    m_settings(settings),
+    m_statistics(),
+    m_noteRequestsByGuid(),
+    m_pGenerator(new SyntheticDatasetGenerator(seed)),
+    m_notebooks(),
+    m_tags(),
+    m_notebooksByGuid(),
+    m_tagsByGuid(),
+    m_savedSearchesByGuid(),
+    m_notesByGuid(),
+    m_noteGuidsByResourceGuid(),
+    m_linkedNotebookDataByGuid(),
+    m_linkedNotebookNotesByGuid(),
+    m_entriesByUsn(),
+    m_updateCount(0),
+    m_nextNoteIndex(0),
+    m_nextGuidIndex(0)
+{}
+
+FakeSyncService::~FakeSyncService()
+{
+    delete m_pGenerator;
+}
+
+void FakeSyncService::populate(const int numNotes)
+{
+    QNINFO(QStringLiteral("Populating the fake sync service with ") << numNotes << QStringLiteral(" notes"));
+
+    const int numNotebooks = std::max(numNotes / 200, 1);
+    for(int i = 0; i < numNotebooks; ++i)
+    {
+        Notebook notebook = m_pGenerator->generateNotebook(i);
+        m_notebooks << notebook;
+
+        qevercloud::Notebook qecNotebook = notebook.qevercloudNotebook();
+        qecNotebook.updateSequenceNumber.clear();
+        putNotebook(qecNotebook);
+    }
+
+    // Parent tags always precede their children in terms of update sequence numbers, much like with the real service
+    const int numTags = std::max(numNotes / 50, 1);
+    for(int i = 0; i < numTags; ++i)
+    {
+        const Tag * pParentTag = Q_NULLPTR;
+        if ((i > 0) && (m_pGenerator->randomInt(0, 1) == 0)) {
+            pParentTag = &m_tags[m_pGenerator->randomInt(0, i - 1)];
+        }
+
+        Tag tag = m_pGenerator->generateTag(i, pParentTag);
+        m_tags << tag;
+
+        qevercloud::Tag qecTag = tag.qevercloudTag();
+        qecTag.updateSequenceNumber.clear();
+        putTag(qecTag);
+    }
+
+    const int numSavedSearches = std::max(numNotes / 500, 1);
+    for(int i = 0; i < numSavedSearches; ++i)
+    {
+        qevercloud::SavedSearch savedSearch;
+        savedSearch.name = QStringLiteral("Search #") + QString::number(i);
+        savedSearch.query = m_pGenerator->randomWord();
+        savedSearch.format = qevercloud::QueryFormat::USER;
+        putSavedSearch(savedSearch);
+    }
+
+    for(int i = 0; i < numNotes; ++i)
+    {
+        const Notebook & notebook = m_notebooks[m_pGenerator->randomInt(0, numNotebooks - 1)];
+        Note note = m_pGenerator->generateNote(m_nextNoteIndex++, notebook, m_tags,
+                                               MAX_TAGS_PER_NOTE, MAX_RESOURCES_PER_NOTE);
+        addNote(note.qevercloudNote());
+    }
+}
+
+void FakeSyncService::modify(const int numModifiedNotes, const int numNewNotes, const int numExpungedNotes)
+{
+    QNINFO(QStringLiteral("Modifying the fake sync service's account: ") << numModifiedNotes
+           << QStringLiteral(" modified notes, ") << numNewNotes << QStringLiteral(" new notes, ")
+           << numExpungedNotes << QStringLiteral(" expunged notes"));
+
+    QStringList noteGuids = m_notesByGuid.keys();
+    noteGuids.sort();
+
+    // Spread the changes evenly over the whole account
+    const int numChangedNotes = std::min(numModifiedNotes + numExpungedNotes, noteGuids.size());
+    const int step = ((numChangedNotes > 0) ? (noteGuids.size() / numChangedNotes) : 0);
+    for(int i = 0; i < numChangedNotes; ++i)
+    {
+        const QString & guid = noteGuids[i * step];
+        auto it = m_notesByGuid.find(guid);
+        qevercloud::Note & note = it.value();
+
+        if (i < numExpungedNotes)
+        {
+            if (note.resources.isSet())
+            {
+                const QList<qevercloud::Resource> & resources = note.resources.ref();
+                for(auto rit = resources.constBegin(), rend = resources.constEnd(); rit != rend; ++rit) {
+                    Q_UNUSED(m_noteGuidsByResourceGuid.remove(rit->guid.ref()))
+                }
+            }
+
+            Q_UNUSED(assignNextUsn(ItemType::ExpungedNote, guid, note.updateSequenceNumber.ref()))
+            Q_UNUSED(m_notesByGuid.erase(it))
+            continue;
+        }
+
+        QList<Resource> resources;
+        if (note.resources.isSet())
+        {
+            const QList<qevercloud::Resource> & qecResources = note.resources.ref();
+            for(auto rit = qecResources.constBegin(), rend = qecResources.constEnd(); rit != rend; ++rit) {
+                resources << Resource(*rit);
+            }
+        }
+
+        note.content = m_pGenerator->generateNoteContent(resources);
+        note.updated = QDateTime::currentMSecsSinceEpoch();
+        putNote(note);
+    }
+
+    for(int i = 0; i < numNewNotes; ++i)
+    {
+        const Notebook & notebook = m_notebooks[m_pGenerator->randomInt(0, m_notebooks.size() - 1)];
+        Note note = m_pGenerator->generateNote(m_nextNoteIndex++, notebook, m_tags,
+                                               MAX_TAGS_PER_NOTE, MAX_RESOURCES_PER_NOTE);
+        addNote(note.qevercloudNote());
+    }
+}
+
+bool FakeSyncService::modifyNoteTitle(const QString & noteGuid)
+{
+    auto it = m_notesByGuid.find(noteGuid);
+    if (it == m_notesByGuid.end()) {
+        return false;
+    }
+
+    qevercloud::Note & note = it.value();
+    note.title = m_pGenerator->randomWord() + QStringLiteral(" ") + m_pGenerator->randomWord();
+    note.updated = QDateTime::currentMSecsSinceEpoch();
+    putNote(note);
+    return true;
+}
+
+bool FakeSyncService::modifyNoteContent(const QString & noteGuid)
+{
+    auto it = m_notesByGuid.find(noteGuid);
+    if (it == m_notesByGuid.end()) {
+        return false;
+    }
+
+    qevercloud::Note & note = it.value();
+
+    QList<Resource> resources;
+    if (note.resources.isSet())
+    {
+        const QList<qevercloud::Resource> & qecResources = note.resources.ref();
+        for(auto rit = qecResources.constBegin(), rend = qecResources.constEnd(); rit != rend; ++rit) {
+            resources << Resource(*rit);
+        }
+    }
+
+    note.content = m_pGenerator->generateNoteContent(resources);
+    note.updated = QDateTime::currentMSecsSinceEpoch();
+    putNote(note);
+    return true;
+}
+
+bool FakeSyncService::modifyNoteResourceData(const QString & noteGuid)
+{
+    auto it = m_notesByGuid.find(noteGuid);
+    if ((it == m_notesByGuid.end()) || !it->resources.isSet() || it->resources->isEmpty()) {
+        return false;
+    }
+
+    qevercloud::Note & note = it.value();
+
+    qevercloud::Resource & resource = note.resources.ref()[0];
+    if (!resource.data.isSet() || !resource.data->body.isSet()) {
+        return false;
+    }
+
+    // As the resource's data changes, so does its update sequence number: it gets the one the note is about to get
+    QByteArray dataBody = resource.data->body.ref();
+    dataBody.append(m_pGenerator->randomWord().toUtf8());
+    resource.data->body = dataBody;
+    resource.data->size = dataBody.size();
+    resource.data->bodyHash = QCryptographicHash::hash(dataBody, QCryptographicHash::Md5);
+    resource.updateSequenceNumber = m_updateCount + 1;
+
+    note.updated = QDateTime::currentMSecsSinceEpoch();
+    putNote(note);
+    return true;
+}
+
+bool FakeSyncService::addNoteResource(const QString & noteGuid)
+{
+    auto it = m_notesByGuid.find(noteGuid);
+    if (it == m_notesByGuid.end()) {
+        return false;
+    }
+
+    qevercloud::Note & note = it.value();
+
+    Note localNote(note);
+    const int indexInNote = (note.resources.isSet() ? note.resources->size() : 0);
+    Resource resource = m_pGenerator->generateResource(localNote, indexInNote);
+
+    // The guid and the update sequence number are assigned by the service
+    qevercloud::Resource qecResource = resource.qevercloudResource();
+    qecResource.guid.clear();
+    qecResource.updateSequenceNumber.clear();
+
+    if (!note.resources.isSet()) {
+        note.resources = QList<qevercloud::Resource>();
+    }
+
+    note.resources.ref() << qecResource;
+    note.updated = QDateTime::currentMSecsSinceEpoch();
+    putNote(note);
+    return true;
+}
+
+bool FakeSyncService::moveNote(const QString & noteGuid, const QString & notebookGuid)
+{
+    auto it = m_notesByGuid.find(noteGuid);
+    if ((it == m_notesByGuid.end()) || !m_notebooksByGuid.contains(notebookGuid)) {
+        return false;
+    }
+
+    qevercloud::Note & note = it.value();
+    note.notebookGuid = notebookGuid;
+    note.updated = QDateTime::currentMSecsSinceEpoch();
+    putNote(note);
+    return true;
+}
+
+bool FakeSyncService::renameTag(const QString & tagGuid, const QString & name)
+{
+    auto it = m_tagsByGuid.find(tagGuid);
+    if (it == m_tagsByGuid.end()) {
+        return false;
+    }
+
+    qevercloud::Tag & tag = it.value();
+    tag.name = name;
+    putTag(tag);
+    return true;
+}
+
+QString FakeSyncService::addLinkedNotebook(const int numNotes)
+{
+    const int index = m_linkedNotebookDataByGuid.size();
+
+    LinkedNotebookData data;
+
+    // The shared notebook comes from another account, the synthetic notebook's guid is used as is
+    // while the update sequence numbers are those of the other account
+    Notebook notebook = m_pGenerator->generateNotebook(index);
+    notebook.setName(QStringLiteral("Shared notebook #") + QString::number(index) + QStringLiteral(" ") +
+                     m_pGenerator->randomWord());
+    notebook.setDefaultNotebook(false);
+    notebook.setUpdateSequenceNumber(1);
+    data.m_notebook = notebook.qevercloudNotebook();
+
+    // The notes of shared notebooks don't have resources so that their data is downloaded along with the notes
+    for(int i = 0; i < numNotes; ++i)
+    {
+        Note note = m_pGenerator->generateNote(m_nextNoteIndex++, notebook, QList<Tag>(), 0, 0);
+        qevercloud::Note & qecNote = note.qevercloudNote();
+        qecNote.updateSequenceNumber = i + 2;
+        updateNoteContentHash(qecNote);
+        m_linkedNotebookNotesByGuid[qecNote.guid.ref()] = qecNote;
+        data.m_noteGuids << qecNote.guid.ref();
+    }
+
+    // No shared notebook global id but the uri: this is how the public linked notebooks look like, they don't need
+    // the authentication to the shared notebook
+    qevercloud::LinkedNotebook & linkedNotebook = data.m_linkedNotebook;
+    linkedNotebook.guid = nextGuid();
+    linkedNotebook.shareName = notebook.name();
+    linkedNotebook.username = QStringLiteral("fake_sync_benchmark_sharer_") + QString::number(index);
+    linkedNotebook.shardId = QStringLiteral("s") + QString::number(index + 2);
+    linkedNotebook.uri = QStringLiteral("shared_notebook_") + QString::number(index);
+    linkedNotebook.noteStoreUrl = QStringLiteral("https://www.evernote.local/shard/") + linkedNotebook.shardId.ref() +
+                                  QStringLiteral("/notestore");
+    linkedNotebook.updateSequenceNumber = assignNextUsn(ItemType::LinkedNotebook, linkedNotebook.guid.ref(), 0);
+
+    QString guid = linkedNotebook.guid.ref();
+    m_linkedNotebookDataByGuid[guid] = data;
+    return guid;
+}
+
+bool FakeSyncService::setLinkedNotebookAccessible(const QString & linkedNotebookGuid, const bool accessible)
+{
+    auto it = m_linkedNotebookDataByGuid.find(linkedNotebookGuid);
+    if (it == m_linkedNotebookDataByGuid.end()) {
+        return false;
+    }
+
+    it->m_accessible = accessible;
+    return true;
+}
+
+int FakeSyncService::numNoteResources(const QString & noteGuid) const
+{
+    auto it = m_notesByGuid.constFind(noteGuid);
+    if ((it == m_notesByGuid.constEnd()) || !it->resources.isSet()) {
+        return 0;
+    }
+
+    return it->resources->size();
+}
+
+QString FakeSyncService::noteNotebookGuid(const QString & noteGuid) const
+{
+    auto it = m_notesByGuid.constFind(noteGuid);
+    if ((it == m_notesByGuid.constEnd()) || !it->notebookGuid.isSet()) {
+        return QString();
+    }
+
+    return it->notebookGuid.ref();
+}
+
+QStringList FakeSyncService::linkedNotebookNoteGuids(const QString & linkedNotebookGuid) const
+{
+    return m_linkedNotebookDataByGuid.value(linkedNotebookGuid).m_noteGuids;
+}
+
+void FakeSyncService::resetStatistics()
+{
+    m_statistics = Statistics();
+    m_noteRequestsByGuid.clear();
+}
+
+qint32 FakeSyncService::processRequest(ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    ++m_statistics.m_numRequests;
+
+    if ((m_settings.m_rateLimitEveryNthRequest > 0) &&
+        ((m_statistics.m_numRequests % m_settings.m_rateLimitEveryNthRequest) == 0))
+    {
+        ++m_statistics.m_numRateLimitedRequests;
+        errorDescription.setBase(QT_TR_NOOP("Rate limit reached"));
+        rateLimitSeconds = m_settings.m_rateLimitSeconds;
+        return qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED;
+    }
+
+    return 0;
+}
+
+qevercloud::UserID FakeSyncService::userId() const
+{
+    return FAKE_USER_ID;
+}
+
+qevercloud::User FakeSyncService::user() const
+{
+    qevercloud::User user;
+    user.id = FAKE_USER_ID;
+    user.username = QStringLiteral("fake_sync_benchmark_user");
+    user.name = QStringLiteral("Fake sync benchmark user");
+    user.email = QStringLiteral("fake_sync_benchmark_user@example.com");
+    user.privilege = qevercloud::PrivilegeLevel::NORMAL;
+    user.serviceLevel = qevercloud::ServiceLevel::BASIC;
+    user.active = true;
+    user.created = QDateTime::currentMSecsSinceEpoch();
+    user.updated = user.created;
+
+    qevercloud::AccountLimits accountLimits;
+    accountLimits.noteSizeMax = 25 * 1024 * 1024;
+    accountLimits.resourceSizeMax = 25 * 1024 * 1024;
+    accountLimits.userNoteCountMax = 100000;
+    accountLimits.userNotebookCountMax = 250;
+    accountLimits.userTagCountMax = 100000;
+    accountLimits.userSavedSearchesMax = 100;
+    accountLimits.noteResourceCountMax = 1000;
+    accountLimits.noteTagCountMax = 100;
+    user.accountLimits = accountLimits;
+
+    return user;
+}
+
+qevercloud::SyncState FakeSyncService::syncState()
+{
+    ++m_statistics.m_numSyncStateRequests;
+
+    qevercloud::SyncState state;
+    state.currentTime = QDateTime::currentMSecsSinceEpoch();
+    state.fullSyncBefore = 0;
+    state.updateCount = m_updateCount;
+    return state;
+}
+
+qevercloud::SyncChunk FakeSyncService::syncChunk(const qint32 afterUSN, const qint32 maxEntries,
+                                                 const qevercloud::SyncChunkFilter & filter)
+{
+    ++m_statistics.m_numSyncChunkRequests;
+
+    qevercloud::SyncChunk chunk;
+    chunk.currentTime = QDateTime::currentMSecsSinceEpoch();
+    chunk.updateCount = m_updateCount;
+    chunk.chunkHighUSN = m_updateCount;
+
+    const bool includeExpunged = filter.includeExpunged.isSet() && filter.includeExpunged.ref();
+    const bool includeNoteResources = filter.includeNoteResources.isSet() && filter.includeNoteResources.ref();
+
+    qint32 numEntries = 0;
+    for(auto it = m_entriesByUsn.upperBound(afterUSN), end = m_entriesByUsn.end(); it != end; ++it)
+    {
+        if (numEntries >= maxEntries) {
+            chunk.chunkHighUSN = it.key() - 1;
+            break;
+        }
+
+        const UsnEntry & entry = it.value();
+        switch(entry.m_type)
+        {
+        case ItemType::Notebook:
+            if (filter.includeNotebooks.isSet() && filter.includeNotebooks.ref())
+            {
+                if (!chunk.notebooks.isSet()) {
+                    chunk.notebooks = QList<qevercloud::Notebook>();
+                }
+
+                chunk.notebooks.ref() << m_notebooksByGuid.value(entry.m_guid);
+                ++numEntries;
+            }
+            break;
+        case ItemType::Tag:
+            if (filter.includeTags.isSet() && filter.includeTags.ref())
+            {
+                if (!chunk.tags.isSet()) {
+                    chunk.tags = QList<qevercloud::Tag>();
+                }
+
+                chunk.tags.ref() << m_tagsByGuid.value(entry.m_guid);
+                ++numEntries;
+            }
+            break;
+        case ItemType::SavedSearch:
+            if (filter.includeSearches.isSet() && filter.includeSearches.ref())
+            {
+                if (!chunk.searches.isSet()) {
+                    chunk.searches = QList<qevercloud::SavedSearch>();
+                }
+
+                chunk.searches.ref() << m_savedSearchesByGuid.value(entry.m_guid);
+                ++numEntries;
+            }
+            break;
+        case ItemType::Note:
+            if (filter.includeNotes.isSet() && filter.includeNotes.ref())
+            {
+                // The notes within the sync chunks carry neither the content nor the resources' data bodies
+                qevercloud::Note note = m_notesByGuid.value(entry.m_guid);
+                note.content.clear();
+
+                if (!includeNoteResources) {
+                    note.resources.clear();
+                }
+                else if (note.resources.isSet())
+                {
+                    QList<qevercloud::Resource> & resources = note.resources.ref();
+                    for(auto rit = resources.begin(), rend = resources.end(); rit != rend; ++rit) {
+                        stripResourceBodies(*rit, false, false, false);
+                    }
+                }
+
+                if (!chunk.notes.isSet()) {
+                    chunk.notes = QList<qevercloud::Note>();
+                }
+
+                chunk.notes.ref() << note;
+                ++numEntries;
+            }
+            break;
+        case ItemType::LinkedNotebook:
+            if (filter.includeLinkedNotebooks.isSet() && filter.includeLinkedNotebooks.ref())
+            {
+                if (!chunk.linkedNotebooks.isSet()) {
+                    chunk.linkedNotebooks = QList<qevercloud::LinkedNotebook>();
+                }
+
+                chunk.linkedNotebooks.ref() << m_linkedNotebookDataByGuid.value(entry.m_guid).m_linkedNotebook;
+                ++numEntries;
+            }
+            break;
+        case ItemType::ExpungedNote:
+            if (includeExpunged)
+            {
+                if (!chunk.expungedNotes.isSet()) {
+                    chunk.expungedNotes = QList<qevercloud::Guid>();
+                }
+
+                chunk.expungedNotes.ref() << entry.m_guid;
+                ++numEntries;
+            }
+            break;
+        }
+    }
+
+    return chunk;
+}
+
+qint32 FakeSyncService::linkedNotebookSyncState(const QString & linkedNotebookGuid, qevercloud::SyncState & syncState,
+                                                ErrorString & errorDescription)
+{
+    ++m_statistics.m_numSyncStateRequests;
+
+    qint32 errorCode = checkLinkedNotebookAccess(linkedNotebookGuid, errorDescription);
+    if (errorCode != 0) {
+        return errorCode;
+    }
+
+    const LinkedNotebookData & data = m_linkedNotebookDataByGuid[linkedNotebookGuid];
+    syncState.currentTime = QDateTime::currentMSecsSinceEpoch();
+    syncState.fullSyncBefore = 0;
+    syncState.updateCount = data.m_noteGuids.size() + 1;
+    return 0;
+}
+
+qint32 FakeSyncService::linkedNotebookSyncChunk(const QString & linkedNotebookGuid, const qint32 afterUSN,
+                                                const qint32 maxEntries, qevercloud::SyncChunk & syncChunk,
+                                                ErrorString & errorDescription)
+{
+    ++m_statistics.m_numSyncChunkRequests;
+
+    qint32 errorCode = checkLinkedNotebookAccess(linkedNotebookGuid, errorDescription);
+    if (errorCode != 0) {
+        return errorCode;
+    }
+
+    const LinkedNotebookData & data = m_linkedNotebookDataByGuid[linkedNotebookGuid];
+    const qint32 updateCount = data.m_noteGuids.size() + 1;
+
+    syncChunk = qevercloud::SyncChunk();
+    syncChunk.currentTime = QDateTime::currentMSecsSinceEpoch();
+    syncChunk.updateCount = updateCount;
+    syncChunk.chunkHighUSN = updateCount;
+
+    qint32 numEntries = 0;
+    for(qint32 usn = std::max(afterUSN, 0) + 1; usn <= updateCount; ++usn)
+    {
+        if (numEntries >= maxEntries) {
+            syncChunk.chunkHighUSN = usn - 1;
+            break;
+        }
+
+        ++numEntries;
+
+        if (usn == 1) {
+            syncChunk.notebooks = QList<qevercloud::Notebook>() << data.m_notebook;
+            continue;
+        }
+
+        qevercloud::Note note = m_linkedNotebookNotesByGuid.value(data.m_noteGuids[usn - 2]);
+        note.content.clear();
+
+        if (!syncChunk.notes.isSet()) {
+            syncChunk.notes = QList<qevercloud::Note>();
+        }
+
+        syncChunk.notes.ref() << note;
+    }
+
+    return 0;
+}
+
+bool FakeSyncService::findNote(const QString & guid, const bool withContent, const bool withResourcesData,
+                               const bool withResourcesRecognition, const bool withResourcesAlternateData,
+                               qevercloud::Note & note)
+{
+    ++m_statistics.m_numNoteRequests;
+
+    if (m_settings.m_recordNoteRequests)
+    {
+        NoteRequest & request = m_noteRequestsByGuid[guid];
+        request.m_withContent = withContent;
+        request.m_withResourcesData = withResourcesData;
+        request.m_withResourcesRecognition = withResourcesRecognition;
+        request.m_withResourcesAlternateData = withResourcesAlternateData;
+    }
+
+    auto it = m_notesByGuid.constFind(guid);
+    if (it != m_notesByGuid.constEnd()) {
+        note = it.value();
+    }
+    else {
+        auto linkedIt = m_linkedNotebookNotesByGuid.constFind(guid);
+        if (linkedIt == m_linkedNotebookNotesByGuid.constEnd()) {
+            return false;
+        }
+
+        note = linkedIt.value();
+    }
+
+    if (!withContent) {
+        note.content.clear();
+    }
+    else if (note.content.isSet()) {
+        m_statistics.m_payloadBytes += note.content->toUtf8().size();
+    }
+
+    if (note.resources.isSet())
+    {
+        QList<qevercloud::Resource> & resources = note.resources.ref();
+        for(auto rit = resources.begin(), rend = resources.end(); rit != rend; ++rit) {
+            stripResourceBodies(*rit, withResourcesData, withResourcesRecognition, withResourcesAlternateData);
+        }
+    }
+
+    return true;
+}
+
+bool FakeSyncService::findResource(const QString & guid, const bool withDataBody, const bool withRecognitionDataBody,
+                                   const bool withAlternateDataBody, qevercloud::Resource & resource)
+{
+    ++m_statistics.m_numResourceRequests;
+
+    auto noteIt = m_notesByGuid.constFind(m_noteGuidsByResourceGuid.value(guid));
+    if ((noteIt == m_notesByGuid.constEnd()) || !noteIt->resources.isSet()) {
+        return false;
+    }
+
+    const QList<qevercloud::Resource> & resources = noteIt->resources.ref();
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        if (it->guid.isSet() && (it->guid.ref() == guid)) {
+            resource = *it;
+            stripResourceBodies(resource, withDataBody, withRecognitionDataBody, withAlternateDataBody);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FakeSyncService::putNotebook(qevercloud::Notebook & notebook)
+{
+    ++m_statistics.m_numUploadRequests;
+
+    if (!notebook.guid.isSet()) {
+        notebook.guid = nextGuid();
+    }
+
+    qint32 previousUsn = (notebook.updateSequenceNumber.isSet() ? notebook.updateSequenceNumber.ref() : 0);
+    notebook.updateSequenceNumber = assignNextUsn(ItemType::Notebook, notebook.guid.ref(), previousUsn);
+    m_notebooksByGuid[notebook.guid.ref()] = notebook;
+}
+
+void FakeSyncService::putTag(qevercloud::Tag & tag)
+{
+    ++m_statistics.m_numUploadRequests;
+
+    if (!tag.guid.isSet()) {
+        tag.guid = nextGuid();
+    }
+
+    qint32 previousUsn = (tag.updateSequenceNumber.isSet() ? tag.updateSequenceNumber.ref() : 0);
+    tag.updateSequenceNumber = assignNextUsn(ItemType::Tag, tag.guid.ref(), previousUsn);
+    m_tagsByGuid[tag.guid.ref()] = tag;
+}
+
+void FakeSyncService::putSavedSearch(qevercloud::SavedSearch & savedSearch)
+{
+    ++m_statistics.m_numUploadRequests;
+
+    if (!savedSearch.guid.isSet()) {
+        savedSearch.guid = nextGuid();
+    }
+
+    qint32 previousUsn = (savedSearch.updateSequenceNumber.isSet() ? savedSearch.updateSequenceNumber.ref() : 0);
+    savedSearch.updateSequenceNumber = assignNextUsn(ItemType::SavedSearch, savedSearch.guid.ref(), previousUsn);
+    m_savedSearchesByGuid[savedSearch.guid.ref()] = savedSearch;
+}
+
+void FakeSyncService::putNote(qevercloud::Note & note)
+{
+    ++m_statistics.m_numUploadRequests;
+
+    if (!note.guid.isSet()) {
+        note.guid = nextGuid();
+    }
+
+    updateNoteContentHash(note);
+
+    qint32 previousUsn = (note.updateSequenceNumber.isSet() ? note.updateSequenceNumber.ref() : 0);
+    note.updateSequenceNumber = assignNextUsn(ItemType::Note, note.guid.ref(), previousUsn);
+
+    if (note.resources.isSet())
+    {
+        QList<qevercloud::Resource> & resources = note.resources.ref();
+        for(auto it = resources.begin(), end = resources.end(); it != end; ++it)
+        {
+            if (!it->guid.isSet()) {
+                it->guid = nextGuid();
+                it->updateSequenceNumber = note.updateSequenceNumber.ref();
+            }
+
+            it->noteGuid = note.guid.ref();
+            m_noteGuidsByResourceGuid[it->guid.ref()] = note.guid.ref();
+        }
+    }
+
+    m_notesByGuid[note.guid.ref()] = note;
+}
+
+qint32 FakeSyncService::checkLinkedNotebookAccess(const QString & linkedNotebookGuid, ErrorString & errorDescription) const
+{
+    auto it = m_linkedNotebookDataByGuid.constFind(linkedNotebookGuid);
+    if (it == m_linkedNotebookDataByGuid.constEnd()) {
+        errorDescription.setBase(QT_TR_NOOP("Linked notebook not found"));
+        errorDescription.details() = linkedNotebookGuid;
+        return qevercloud::EDAMErrorCode::UNKNOWN;
+    }
+
+    if (!it->m_accessible) {
+        errorDescription.setBase(QT_TR_NOOP("The shared notebook is no longer accessible"));
+        errorDescription.details() = linkedNotebookGuid;
+        return qevercloud::EDAMErrorCode::PERMISSION_DENIED;
+    }
+
+    return 0;
+}
+
+qint32 FakeSyncService::assignNextUsn(const ItemType::type type, const QString & guid, const qint32 previousUsn)
+{
+    auto it = m_entriesByUsn.find(previousUsn);
+    if ((it != m_entriesByUsn.end()) && (it.value().m_guid == guid)) {
+        Q_UNUSED(m_entriesByUsn.erase(it))
+    }
+
+    ++m_updateCount;
+    m_entriesByUsn[m_updateCount] = UsnEntry(type, guid);
+    return m_updateCount;
+}
+
+void FakeSyncService::addNote(qevercloud::Note & note)
+{
+    // The synthetic note comes with the update sequence number assigned by the generator, it is replaced here
+    note.updateSequenceNumber.clear();
+
+    if (note.resources.isSet())
+    {
+        QList<qevercloud::Resource> & resources = note.resources.ref();
+        for(auto it = resources.begin(), end = resources.end(); it != end; ++it) {
+            it->updateSequenceNumber = m_updateCount + 1;
+        }
+    }
+
+    putNote(note);
+}
+
+void FakeSyncService::updateNoteContentHash(qevercloud::Note & note)
+{
+    if (note.content.isSet()) {
+        QByteArray content = note.content->toUtf8();
+        note.contentHash = QCryptographicHash::hash(content, QCryptographicHash::Md5);
+        note.contentLength = content.size();
+    }
+}
+
+void FakeSyncService::stripResourceBodies(qevercloud::Resource & resource, const bool withDataBody,
+                                          const bool withRecognitionDataBody, const bool withAlternateDataBody)
+{
+    if (resource.data.isSet() && resource.data->body.isSet())
+    {
+        if (withDataBody) {
+            m_statistics.m_payloadBytes += resource.data->body->size();
+        }
+        else {
+            resource.data->body.clear();
+        }
+    }
+
+    if (resource.recognition.isSet() && resource.recognition->body.isSet())
+    {
+        if (withRecognitionDataBody) {
+            m_statistics.m_payloadBytes += resource.recognition->body->size();
+        }
+        else {
+            resource.recognition->body.clear();
+        }
+    }
+
+    if (resource.alternateData.isSet() && resource.alternateData->body.isSet())
+    {
+        if (withAlternateDataBody) {
+            m_statistics.m_payloadBytes += resource.alternateData->body->size();
+        }
+        else {
+            resource.alternateData->body.clear();
+        }
+    }
+}
+
+QString FakeSyncService::nextGuid()
+{
+    ++m_nextGuidIndex;
+    QString hex = QString::number(m_nextGuidIndex, 16).rightJustified(32, QChar::fromLatin1('0'));
+    return hex.mid(0, 8) + QStringLiteral("-") + hex.mid(8, 4) + QStringLiteral("-") + hex.mid(12, 4) +
+           QStringLiteral("-") + hex.mid(16, 4) + QStringLiteral("-") + hex.mid(20, 12);
+}
+
+} // namespace benchmark
+} // namespace quentier
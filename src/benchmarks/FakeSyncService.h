@@ -0,0 +1,283 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_FAKE_SYNC_SERVICE_H
+#define LIB_QUENTIER_BENCHMARKS_FAKE_SYNC_SERVICE_H
+
+#include <quentier/types/ErrorString.h>
+#include <quentier/types/Notebook.h>
+#include <quentier/types/Tag.h>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+namespace quentier {
+namespace benchmark {
+
+QT_FORWARD_DECLARE_CLASS(SyntheticDatasetGenerator)
+
+/**
+ * @brief The FakeSyncService class is the in-process replacement for Evernote service used by the sync benchmark:
+ * it holds the synthetic account's data elements ordered by their update sequence numbers and serves sync chunks,
+ * full notes and resources out of it, simulating the network latency and the rate limits of the real service
+ *
+ * The service is shared by FakeNoteStore and FakeUserStore instances; all of them are expected to live
+ * in the same thread
+ */
+class FakeSyncService
+{
+public:
+    struct Settings
+    {
+        Settings();
+
+        // Simulated latency of each API call
+        int         m_latencyMsec;
+
+        // Each N-th note store API call fails with RATE_LIMIT_REACHED error; zero disables the rate limiting
+        int         m_rateLimitEveryNthRequest;
+        qint32      m_rateLimitSeconds;
+
+        // If set, each other asynchronous reply is delivered after the one following it, much like the replies
+        // to the requests processed by the real service in parallel
+        bool        m_reorderAsyncReplies;
+
+        // If set, the options of the last note request are recorded for each note
+        bool        m_recordNoteRequests;
+    };
+
+    struct NoteRequest
+    {
+        NoteRequest();
+
+        bool        m_withContent;
+        bool        m_withResourcesData;
+        bool        m_withResourcesRecognition;
+        bool        m_withResourcesAlternateData;
+    };
+
+    struct Statistics
+    {
+        Statistics();
+
+        qint64      m_numRequests;
+        qint64      m_numSyncStateRequests;
+        qint64      m_numSyncChunkRequests;
+        qint64      m_numNoteRequests;
+        qint64      m_numResourceRequests;
+        qint64      m_numUploadRequests;
+        qint64      m_numRateLimitedRequests;
+
+        // The size of note contents and resource data bodies served to the client
+        qint64      m_payloadBytes;
+    };
+
+public:
+    FakeSyncService(const quint32 seed, const Settings & settings);
+    ~FakeSyncService();
+
+    const Settings & settings() const { return m_settings; }
+
+    /**
+     * @brief populate - fills the service with the synthetic account containing the specified number of notes;
+     * the numbers of notebooks, tags and saved searches are derived from it
+     */
+    void populate(const int numNotes);
+
+    /**
+     * @brief modify - simulates the changes done to the account by another client: modifies the contents
+     * of the given number of existing notes, adds new notes and expunges some of the existing ones
+     */
+    void modify(const int numModifiedNotes, const int numNewNotes, const int numExpungedNotes);
+
+    /**
+     * The methods below simulate the particular kinds of changes done to the particular note by another client;
+     * each of them returns false if there's no note with such guid or it has no resource to change
+     */
+    bool modifyNoteTitle(const QString & noteGuid);
+    bool modifyNoteContent(const QString & noteGuid);
+    bool modifyNoteResourceData(const QString & noteGuid);
+    bool addNoteResource(const QString & noteGuid);
+
+    /**
+     * @brief moveNote - simulates the move of the note to another notebook by another client
+     * @return false if there's no note or notebook with such guid
+     */
+    bool moveNote(const QString & noteGuid, const QString & notebookGuid);
+
+    /**
+     * @brief renameTag - simulates the renaming of the tag by another client
+     * @return false if there's no tag with such guid
+     */
+    bool renameTag(const QString & tagGuid, const QString & name);
+
+    /**
+     * @brief addLinkedNotebook - adds the public linked notebook to the account; the shared notebook it refers to
+     * belongs to another account so the notebook and its notes have their own update sequence numbers
+     * @return the guid of the added linked notebook
+     */
+    QString addLinkedNotebook(const int numNotes);
+
+    /**
+     * @brief setLinkedNotebookAccessible - simulates the revoked or restored access to the shared notebook:
+     * while the linked notebook is inaccessible, the requests for its sync state and sync chunks fail
+     * with PERMISSION_DENIED error
+     * @return false if there's no linked notebook with such guid
+     */
+    bool setLinkedNotebookAccessible(const QString & linkedNotebookGuid, const bool accessible);
+
+    qevercloud::UserID userId() const;
+    qint32 updateCount() const { return m_updateCount; }
+    int numNotes() const { return m_notesByGuid.size(); }
+    QStringList noteGuids() const { return m_notesByGuid.keys(); }
+    int numNoteResources(const QString & noteGuid) const;
+    QString noteNotebookGuid(const QString & noteGuid) const;
+    QStringList linkedNotebookNoteGuids(const QString & linkedNotebookGuid) const;
+
+    const Statistics & statistics() const { return m_statistics; }
+    void resetStatistics();
+
+    /**
+     * @brief noteRequestsByGuid - the options of the last note request for each note since the last reset
+     * of the statistics; empty unless Settings::m_recordNoteRequests is set
+     */
+    const QHash<QString, NoteRequest> & noteRequestsByGuid() const { return m_noteRequestsByGuid; }
+
+    /**
+     * @brief processRequest - accounts for the next note store API call; if the call should fail due to
+     * the simulated rate limit, returns RATE_LIMIT_REACHED error code and sets rateLimitSeconds
+     * @return zero if the request should proceed, EDAM error code otherwise
+     */
+    qint32 processRequest(ErrorString & errorDescription, qint32 & rateLimitSeconds);
+
+    qevercloud::User user() const;
+
+    qevercloud::SyncState syncState();
+
+    qevercloud::SyncChunk syncChunk(const qint32 afterUSN, const qint32 maxEntries,
+                                    const qevercloud::SyncChunkFilter & filter);
+
+    /**
+     * The methods below serve the content of the shared notebook the linked notebook refers to
+     * @return zero on success, EDAM error code otherwise
+     */
+    qint32 linkedNotebookSyncState(const QString & linkedNotebookGuid, qevercloud::SyncState & syncState,
+                                   ErrorString & errorDescription);
+    qint32 linkedNotebookSyncChunk(const QString & linkedNotebookGuid, const qint32 afterUSN, const qint32 maxEntries,
+                                   qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription);
+
+    bool findNote(const QString & guid, const bool withContent, const bool withResourcesData,
+                  const bool withResourcesRecognition, const bool withResourcesAlternateData,
+                  qevercloud::Note & note);
+
+    bool findResource(const QString & guid, const bool withDataBody, const bool withRecognitionDataBody,
+                      const bool withAlternateDataBody, qevercloud::Resource & resource);
+
+    /**
+     * The methods below put the data elements sent by the client into the service, assigning
+     * them the guids (if not set yet) and the new update sequence numbers; they are also used
+     * to populate and modify the account so the statistics should be reset before the measured sync
+     */
+    void putNotebook(qevercloud::Notebook & notebook);
+    void putTag(qevercloud::Tag & tag);
+    void putSavedSearch(qevercloud::SavedSearch & savedSearch);
+    void putNote(qevercloud::Note & note);
+
+private:
+    struct ItemType
+    {
+        enum type {
+            Notebook = 0,
+            Tag,
+            SavedSearch,
+            Note,
+            ExpungedNote,
+            LinkedNotebook
+        };
+    };
+
+    struct UsnEntry
+    {
+        UsnEntry() : m_type(ItemType::Note), m_guid() {}
+        UsnEntry(const ItemType::type type, const QString & guid) : m_type(type), m_guid(guid) {}
+
+        ItemType::type  m_type;
+        QString         m_guid;
+    };
+
+    struct LinkedNotebookData
+    {
+        LinkedNotebookData();
+
+        qevercloud::LinkedNotebook  m_linkedNotebook;
+        qevercloud::Notebook        m_notebook;
+
+        // The guids of the shared notebook's notes ordered by their update sequence numbers;
+        // the notebook itself takes the first one
+        QStringList                 m_noteGuids;
+        bool                        m_accessible;
+    };
+
+    qint32 checkLinkedNotebookAccess(const QString & linkedNotebookGuid, ErrorString & errorDescription) const;
+
+    qint32 assignNextUsn(const ItemType::type type, const QString & guid, const qint32 previousUsn);
+    void addNote(qevercloud::Note & note);
+    void updateNoteContentHash(qevercloud::Note & note);
+    void stripResourceBodies(qevercloud::Resource & resource, const bool withDataBody,
+                             const bool withRecognitionDataBody, const bool withAlternateDataBody);
+    QString nextGuid();
+
+private:
+    Q_DISABLE_COPY(FakeSyncService)
+
+private:
+    Settings                                    m_settings;
+    Statistics                                  m_statistics;
+    QHash<QString, NoteRequest>                 m_noteRequestsByGuid;
+    SyntheticDatasetGenerator *                 m_pGenerator;
+
+    // The notebooks and tags the synthetic notes are generated for
+    QList<Notebook>                             m_notebooks;
+    QList<Tag>                                  m_tags;
+
+    QHash<QString, qevercloud::Notebook>        m_notebooksByGuid;
+    QHash<QString, qevercloud::Tag>             m_tagsByGuid;
+    QHash<QString, qevercloud::SavedSearch>     m_savedSearchesByGuid;
+    QHash<QString, qevercloud::Note>            m_notesByGuid;
+    QHash<QString, QString>                     m_noteGuidsByResourceGuid;
+    QHash<QString, LinkedNotebookData>          m_linkedNotebookDataByGuid;
+    QHash<QString, qevercloud::Note>            m_linkedNotebookNotesByGuid;
+
+    QMap<qint32, UsnEntry>                      m_entriesByUsn;
+    qint32                                      m_updateCount;
+    int                                         m_nextNoteIndex;
+    quint64                                     m_nextGuidIndex;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_FAKE_SYNC_SERVICE_H
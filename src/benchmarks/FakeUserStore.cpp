@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FakeUserStore.h"
+#include "FakeSyncService.h"
+#include <quentier/types/User.h>
+
+namespace quentier {
+namespace benchmark {
+
+FakeUserStore::FakeUserStore(FakeSyncService & service) :
+    IUserStore(),
+    m_service(service),
+    m_authToken()
+{}
+
+QString FakeUserStore::authenticationToken() const
+{
+    return m_authToken;
+}
+
+void FakeUserStore::setAuthenticationToken(const QString & authToken)
+{
+    m_authToken = authToken;
+}
+
+bool FakeUserStore::checkVersion(const QString & clientName, qint16 edamVersionMajor, qint16 edamVersionMinor,
+                                 ErrorString & errorDescription)
+{
+    Q_UNUSED(clientName)
+    Q_UNUSED(edamVersionMajor)
+    Q_UNUSED(edamVersionMinor)
+    Q_UNUSED(errorDescription)
+    return true;
+}
+
+qint32 FakeUserStore::getUser(User & user, ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(rateLimitSeconds)
+    user.qevercloudUser() = m_service.user();
+    return 0;
+}
+
+qint32 FakeUserStore::getAccountLimits(const qevercloud::ServiceLevel::type serviceLevel, qevercloud::AccountLimits & limits,
+                                       ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    Q_UNUSED(serviceLevel)
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(rateLimitSeconds)
+    limits = m_service.user().accountLimits.ref();
+    return 0;
+}
+
+} // namespace benchmark
+} // namespace quentier
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_FAKE_USER_STORE_H
+#define LIB_QUENTIER_BENCHMARKS_FAKE_USER_STORE_H
+
+#include <quentier/synchronization/IUserStore.h>
+
+namespace quentier {
+namespace benchmark {
+
+QT_FORWARD_DECLARE_CLASS(FakeSyncService)
+
+/**
+ * @brief The FakeUserStore class implements IUserStore on top of FakeSyncService; its requests are never
+ * rate limited since the user data is synchronized during the authentication which doesn't wait for the rate limits
+ */
+class FakeUserStore: public IUserStore
+{
+public:
+    explicit FakeUserStore(FakeSyncService & service);
+
+    virtual QString authenticationToken() const Q_DECL_OVERRIDE;
+    virtual void setAuthenticationToken(const QString & authToken) Q_DECL_OVERRIDE;
+
+    virtual bool checkVersion(const QString & clientName, qint16 edamVersionMajor, qint16 edamVersionMinor,
+                              ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getUser(User & user, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual qint32 getAccountLimits(const qevercloud::ServiceLevel::type serviceLevel, qevercloud::AccountLimits & limits,
+                                    ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(FakeUserStore)
+
+private:
+    FakeSyncService &   m_service;
+    QString             m_authToken;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_FAKE_USER_STORE_H
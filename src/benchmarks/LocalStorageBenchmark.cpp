@@ -0,0 +1,322 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocalStorageBenchmark.h"
+#include "SyntheticDatasetGenerator.h"
+#include <quentier/local_storage/LocalStorageManager.h>
+#include <quentier/local_storage/NoteSearchQuery.h>
+#include <quentier/types/Account.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <algorithm>
+
+#define MAX_ITERATIONS_PER_OPERATION (1000)
+#define NUM_LIST_ITERATIONS (20)
+#define LIST_PAGE_SIZE (100)
+
+// Measures the duration of the expression into the vector of durations; the expression is expected to evaluate to bool
+#define MEASURE(durations, expression) \
+    { \
+        QElapsedTimer timer; \
+        timer.start(); \
+        bool measuredRes = (expression); \
+        durations << (timer.nsecsElapsed() / 1000); \
+        if (!measuredRes) { \
+            QNWARNING(QStringLiteral("Benchmarked operation failed: ") << errorDescription); \
+            return false; \
+        } \
+    }
+
+namespace quentier {
+namespace benchmark {
+
+LocalStorageBenchmark::Result::Result() :
+    m_operation(),
+    m_numNotes(0),
+    m_iterations(0),
+    m_totalUsec(0),
+    m_minUsec(0),
+    m_maxUsec(0),
+    m_meanUsec(0),
+    m_medianUsec(0),
+    m_p95Usec(0)
+{}
+
+LocalStorageBenchmark::LocalStorageBenchmark(const quint32 seed) :
+    m_seed(seed)
+{}
+
+bool LocalStorageBenchmark::run(const int numNotes, QList<Result> & results, ErrorString & errorDescription)
+{
+    QNINFO(QStringLiteral("Running the local storage benchmark with ") << numNotes << QStringLiteral(" notes"));
+
+    SyntheticDatasetGenerator generator(m_seed);
+
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageBenchmarkFakeUser") + QString::number(numNotes),
+                    Account::Type::Evernote, numNotes);
+    LocalStorageManager localStorageManager(account, startFromScratch, overrideLock);
+
+    const int numNotebooks = std::max(numNotes / 200, 1);
+    const int numTags = std::max(numNotes / 50, 1);
+    const int maxTagsPerNote = 4;
+    const int maxResourcesPerNote = 2;
+    const int numIterations = std::min(numNotes, MAX_ITERATIONS_PER_OPERATION);
+
+    QVector<qint64> durations;
+
+    // ========== Populate notebooks ==========
+
+    QList<Notebook> notebooks;
+    notebooks.reserve(numNotebooks);
+    durations.reserve(numNotebooks);
+    for(int i = 0; i < numNotebooks; ++i)
+    {
+        notebooks << generator.generateNotebook(i);
+        MEASURE(durations, localStorageManager.addNotebook(notebooks.back(), errorDescription))
+    }
+    results << makeResult(QStringLiteral("addNotebook"), numNotes, durations);
+
+    // ========== Populate tags with hierarchy ==========
+
+    QList<Tag> tags;
+    tags.reserve(numTags);
+    durations.clear();
+    durations.reserve(numTags);
+    for(int i = 0; i < numTags; ++i)
+    {
+        const Tag * pParentTag = Q_NULLPTR;
+        if ((i > 0) && (generator.randomInt(0, 1) == 0)) {
+            pParentTag = &tags[generator.randomInt(0, i - 1)];
+        }
+
+        Tag tag = generator.generateTag(i, pParentTag);
+        tags << tag;
+        MEASURE(durations, localStorageManager.addTag(tags.back(), errorDescription))
+    }
+    results << makeResult(QStringLiteral("addTag"), numNotes, durations);
+
+    // ========== Populate notes with resources ==========
+
+    QList<Note> notes;
+    notes.reserve(numNotes);
+    durations.clear();
+    durations.reserve(numNotes);
+    for(int i = 0; i < numNotes; ++i)
+    {
+        const Notebook & notebook = notebooks[generator.randomInt(0, numNotebooks - 1)];
+        notes << generator.generateNote(i, notebook, tags, maxTagsPerNote, maxResourcesPerNote);
+        MEASURE(durations, localStorageManager.addNote(notes.back(), errorDescription))
+
+        // Don't keep resource bodies in memory for the rest of the benchmark
+        notes.back().setResources(QList<Resource>());
+    }
+    results << makeResult(QStringLiteral("addNote"), numNotes, durations);
+
+    // ========== Count ==========
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i) {
+        MEASURE(durations, (localStorageManager.noteCount(errorDescription) >= 0))
+    }
+    results << makeResult(QStringLiteral("noteCount"), numNotes, durations);
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i)
+    {
+        const Notebook & notebook = notebooks[generator.randomInt(0, numNotebooks - 1)];
+        MEASURE(durations, (localStorageManager.noteCountPerNotebook(notebook, errorDescription) >= 0))
+    }
+    results << makeResult(QStringLiteral("noteCountPerNotebook"), numNotes, durations);
+
+    // ========== Find ==========
+
+    durations.clear();
+    durations.reserve(numIterations);
+    for(int i = 0; i < numIterations; ++i)
+    {
+        Note note;
+        note.setLocalUid(notes[generator.randomInt(0, numNotes - 1)].localUid());
+        MEASURE(durations, localStorageManager.findNote(note, errorDescription, /* with resource binary data = */ false))
+    }
+    results << makeResult(QStringLiteral("findNote"), numNotes, durations);
+
+    // ========== Update ==========
+
+    durations.clear();
+    durations.reserve(numIterations);
+    for(int i = 0; i < numIterations; ++i)
+    {
+        Note & note = notes[generator.randomInt(0, numNotes - 1)];
+        note.setTitle(generator.randomWord() + QStringLiteral(" ") + generator.randomWord());
+        note.setContent(generator.generateNoteContent(QList<Resource>()));
+        note.setDirty(true);
+        MEASURE(durations, localStorageManager.updateNote(note, /* update resources = */ false,
+                                                          /* update tags = */ true, errorDescription))
+    }
+    results << makeResult(QStringLiteral("updateNote"), numNotes, durations);
+
+    // ========== List ==========
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i)
+    {
+        size_t offset = static_cast<size_t>(generator.randomInt(0, std::max(numNotes - LIST_PAGE_SIZE, 0)));
+        errorDescription.clear();
+        MEASURE(durations, (!localStorageManager.listNotes(LocalStorageManager::ListAll, errorDescription,
+                                                           /* with resource binary data = */ false,
+                                                           LIST_PAGE_SIZE, offset,
+                                                           LocalStorageManager::ListNotesOrder::ByModificationTimestamp,
+                                                           LocalStorageManager::OrderDirection::Descending).isEmpty() ||
+                            errorDescription.isEmpty()))
+    }
+    results << makeResult(QStringLiteral("listNotes"), numNotes, durations);
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i)
+    {
+        const Notebook & notebook = notebooks[generator.randomInt(0, numNotebooks - 1)];
+        errorDescription.clear();
+        MEASURE(durations, (!localStorageManager.listNotesPerNotebook(notebook, errorDescription,
+                                                                      /* with resource binary data = */ false,
+                                                                      LocalStorageManager::ListAll,
+                                                                      LIST_PAGE_SIZE).isEmpty() ||
+                            errorDescription.isEmpty()))
+    }
+    results << makeResult(QStringLiteral("listNotesPerNotebook"), numNotes, durations);
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i)
+    {
+        errorDescription.clear();
+        MEASURE(durations, (!localStorageManager.listAllTags(errorDescription).isEmpty() || errorDescription.isEmpty()))
+    }
+    results << makeResult(QStringLiteral("listAllTags"), numNotes, durations);
+
+    // ========== Search ==========
+
+    durations.clear();
+    for(int i = 0; i < NUM_LIST_ITERATIONS; ++i)
+    {
+        QString queryString;
+        switch(i % 3)
+        {
+        case 0:
+            queryString = generator.randomWord();
+            break;
+        case 1:
+            queryString = generator.randomWord() + QStringLiteral(" ") + generator.randomWord();
+            break;
+        default:
+            queryString = QStringLiteral("tag:") + tags[generator.randomInt(0, numTags - 1)].name();
+            break;
+        }
+
+        NoteSearchQuery noteSearchQuery;
+        bool res = noteSearchQuery.setQueryString(queryString, errorDescription);
+        if (!res) {
+            return false;
+        }
+
+        errorDescription.clear();
+        MEASURE(durations, (!localStorageManager.findNotesWithSearchQuery(noteSearchQuery, errorDescription,
+                                                                          /* with resource binary data = */ false).isEmpty() ||
+                            errorDescription.isEmpty()))
+    }
+    results << makeResult(QStringLiteral("findNotesWithSearchQuery"), numNotes, durations);
+
+    // ========== Expunge ==========
+
+    durations.clear();
+    durations.reserve(numIterations);
+    for(int i = 0; i < numIterations; ++i)
+    {
+        // Pick the random note out of not yet expunged ones
+        int index = generator.randomInt(i, numNotes - 1);
+        notes.swap(i, index);
+        MEASURE(durations, localStorageManager.expungeNote(notes[i], errorDescription))
+    }
+    results << makeResult(QStringLiteral("expungeNote"), numNotes, durations);
+
+    return true;
+}
+
+void LocalStorageBenchmark::writeResultsJson(const QList<Result> & results, const quint32 seed, QTextStream & strm)
+{
+    strm << QStringLiteral("{\n");
+    strm << QStringLiteral("  \"benchmark\": \"local_storage\",\n");
+    strm << QStringLiteral("  \"timestamp\": ") << QDateTime::currentMSecsSinceEpoch() << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"seed\": ") << seed << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"results\": [\n");
+
+    for(int i = 0, size = results.size(); i < size; ++i)
+    {
+        const Result & result = results[i];
+        strm << QStringLiteral("    {\"operation\": \"") << result.m_operation
+             << QStringLiteral("\", \"notes\": ") << result.m_numNotes
+             << QStringLiteral(", \"iterations\": ") << result.m_iterations
+             << QStringLiteral(", \"total_usec\": ") << result.m_totalUsec
+             << QStringLiteral(", \"min_usec\": ") << result.m_minUsec
+             << QStringLiteral(", \"max_usec\": ") << result.m_maxUsec
+             << QStringLiteral(", \"mean_usec\": ") << result.m_meanUsec
+             << QStringLiteral(", \"median_usec\": ") << result.m_medianUsec
+             << QStringLiteral(", \"p95_usec\": ") << result.m_p95Usec
+             << QStringLiteral("}") << ((i != (size - 1)) ? QStringLiteral(",\n") : QStringLiteral("\n"));
+    }
+
+    strm << QStringLiteral("  ]\n");
+    strm << QStringLiteral("}\n");
+    strm.flush();
+}
+
+LocalStorageBenchmark::Result LocalStorageBenchmark::makeResult(const QString & operation, const int numNotes,
+                                                                QVector<qint64> & durationsUsec)
+{
+    Result result;
+    result.m_operation = operation;
+    result.m_numNotes = numNotes;
+    result.m_iterations = durationsUsec.size();
+
+    if (durationsUsec.isEmpty()) {
+        return result;
+    }
+
+    std::sort(durationsUsec.begin(), durationsUsec.end());
+
+    for(auto it = durationsUsec.constBegin(), end = durationsUsec.constEnd(); it != end; ++it) {
+        result.m_totalUsec += *it;
+    }
+
+    int size = durationsUsec.size();
+    result.m_minUsec = durationsUsec.front();
+    result.m_maxUsec = durationsUsec.back();
+    result.m_meanUsec = result.m_totalUsec / size;
+    result.m_medianUsec = durationsUsec[size / 2];
+    result.m_p95Usec = durationsUsec[std::min(size - 1, (size * 95) / 100)];
+
+    QNINFO(operation << QStringLiteral(" @ ") << numNotes << QStringLiteral(" notes: ") << result.m_iterations
+           << QStringLiteral(" iterations, median = ") << result.m_medianUsec << QStringLiteral(" usec, p95 = ")
+           << result.m_p95Usec << QStringLiteral(" usec"));
+
+    return result;
+}
+
+} // namespace benchmark
+} // namespace quentier
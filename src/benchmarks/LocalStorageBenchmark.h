@@ -0,0 +1,89 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_LOCAL_STORAGE_BENCHMARK_H
+#define LIB_QUENTIER_BENCHMARKS_LOCAL_STORAGE_BENCHMARK_H
+
+#include <quentier/types/ErrorString.h>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QTextStream>
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManager)
+
+namespace benchmark {
+
+QT_FORWARD_DECLARE_CLASS(SyntheticDatasetGenerator)
+
+/**
+ * @brief The LocalStorageBenchmark class populates the local storage with the synthetic dataset of the given size
+ * and measures the durations of typical local storage operations against it
+ */
+class LocalStorageBenchmark
+{
+public:
+    struct Result
+    {
+        Result();
+
+        QString     m_operation;
+        int         m_numNotes;
+        int         m_iterations;
+        qint64      m_totalUsec;
+        qint64      m_minUsec;
+        qint64      m_maxUsec;
+        qint64      m_meanUsec;
+        qint64      m_medianUsec;
+        qint64      m_p95Usec;
+    };
+
+public:
+    explicit LocalStorageBenchmark(const quint32 seed);
+
+    /**
+     * @brief run - runs the benchmark against the fresh local storage populated with the dataset
+     * containing the specified number of notes
+     * @param numNotes - the number of notes in the dataset; the numbers of notebooks, tags and resources are derived from it
+     * @param results - the results of the benchmark get appended to this list
+     * @param errorDescription - the description of error if the benchmark could not be run
+     * @return true if the benchmark was run successfully, false otherwise
+     */
+    bool run(const int numNotes, QList<Result> & results, ErrorString & errorDescription);
+
+    /**
+     * @brief writeResultsJson - writes the results of the benchmarks in JSON format
+     */
+    static void writeResultsJson(const QList<Result> & results, const quint32 seed, QTextStream & strm);
+
+private:
+    static Result makeResult(const QString & operation, const int numNotes, QVector<qint64> & durationsUsec);
+
+private:
+    Q_DISABLE_COPY(LocalStorageBenchmark)
+
+private:
+    quint32     m_seed;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_LOCAL_STORAGE_BENCHMARK_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocalStorageBenchmark.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/QuentierApplication.h>
+#include <quentier/utility/Utility.h>
+#include <QFile>
+#include <QStringList>
+#include <iostream>
+
+using namespace quentier;
+using namespace quentier::benchmark;
+
+/**
+ * Usage: bench_libquentier [--sizes=1000,10000,100000] [--seed=<number>] [--output=<path to JSON file>]
+ *
+ * Without --output the JSON results are written to the standard output
+ */
+int main(int argc, char *argv[])
+{
+    QuentierApplication app(argc, argv);
+    app.setOrganizationName(QStringLiteral("d1vanov"));
+    app.setApplicationName(QStringLiteral("QuentierLocalStorageBenchmark"));
+
+    // NOTE: not adding stdout log destination since the results might be written to stdout
+    QUENTIER_INITIALIZE_LOGGING();
+    QUENTIER_SET_MIN_LOG_LEVEL(Info);
+
+    initializeLibquentier();
+
+    QList<int> sizes;
+    sizes << 1000 << 10000 << 100000;
+    quint32 seed = 42;
+    QString outputFilePath;
+
+    QStringList arguments = app.arguments();
+    for(int i = 1, numArguments = arguments.size(); i < numArguments; ++i)
+    {
+        const QString & argument = arguments[i];
+        if (argument.startsWith(QStringLiteral("--sizes=")))
+        {
+            sizes.clear();
+            QStringList sizeStrings = argument.mid(8).split(QChar::fromLatin1(','), QString::SkipEmptyParts);
+            for(auto it = sizeStrings.constBegin(), end = sizeStrings.constEnd(); it != end; ++it)
+            {
+                bool conversionResult = false;
+                int size = it->toInt(&conversionResult);
+                if (!conversionResult || (size <= 0)) {
+                    std::cerr << "Invalid dataset size: " << qPrintable(*it) << std::endl;
+                    return 1;
+                }
+
+                sizes << size;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--seed=")))
+        {
+            bool conversionResult = false;
+            seed = argument.mid(7).toUInt(&conversionResult);
+            if (!conversionResult) {
+                std::cerr << "Invalid seed: " << qPrintable(argument.mid(7)) << std::endl;
+                return 1;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--output=")))
+        {
+            outputFilePath = argument.mid(9);
+        }
+        else
+        {
+            std::cerr << "Usage: " << qPrintable(arguments[0])
+                      << " [--sizes=1000,10000,100000] [--seed=<number>] [--output=<path to JSON file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    LocalStorageBenchmark benchmark(seed);
+    QList<LocalStorageBenchmark::Result> results;
+
+    for(auto it = sizes.constBegin(), end = sizes.constEnd(); it != end; ++it)
+    {
+        std::cerr << "Running the local storage benchmark for dataset with " << *it << " notes" << std::endl;
+
+        ErrorString errorDescription;
+        bool res = benchmark.run(*it, results, errorDescription);
+        if (!res) {
+            std::cerr << "Local storage benchmark failed for dataset with " << *it << " notes: "
+                      << qPrintable(errorDescription.nonLocalizedString()) << std::endl;
+            return 1;
+        }
+    }
+
+    if (outputFilePath.isEmpty()) {
+        QTextStream strm(stdout);
+        LocalStorageBenchmark::writeResultsJson(results, seed, strm);
+        return 0;
+    }
+
+    QFile outputFile(outputFilePath);
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        std::cerr << "Can't open the output file " << qPrintable(outputFilePath) << " for writing: "
+                  << qPrintable(outputFile.errorString()) << std::endl;
+        return 1;
+    }
+
+    QTextStream strm(&outputFile);
+    LocalStorageBenchmark::writeResultsJson(results, seed, strm);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PendingItemsRegistryBenchmark.h"
+#include "SyntheticDatasetGenerator.h"
+#include "../synchronization/PendingItemsRegistry.h"
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QStringList>
+
+namespace quentier {
+namespace benchmark {
+
+PendingItemsRegistryBenchmark::Result::Result() :
+    m_container(),
+    m_operation(),
+    m_numNotes(0),
+    m_totalUsec(0),
+    m_perItemNsec(0)
+{}
+
+PendingItemsRegistryBenchmark::PendingItemsRegistryBenchmark(const quint32 seed) :
+    m_seed(seed)
+{}
+
+void PendingItemsRegistryBenchmark::run(const int numNotes, const bool includeList, QList<Result> & results)
+{
+    SyntheticDatasetGenerator generator(m_seed);
+    Notebook notebook = generator.generateNotebook(0);
+    QList<Tag> tags;
+
+    QList<qevercloud::Note> notes;
+    notes.reserve(numNotes);
+    for(int i = 0; i < numNotes; ++i)
+    {
+        qevercloud::Note note = generator.generateNote(i, notebook, tags, 0, 0).qevercloudNote();
+        // Only the metadata is relevant for the bookkeeping of pending notes
+        note.content.clear();
+        notes << note;
+    }
+
+    // The local storage replies come in the order which generally differs from the order of the requests
+    QStringList guids;
+    guids.reserve(numNotes);
+    for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it) {
+        guids << it->guid.ref();
+    }
+
+    for(int i = numNotes - 1; i > 0; --i) {
+        guids.swap(i, generator.randomInt(0, i));
+    }
+
+    QElapsedTimer timer;
+
+    if (includeList)
+    {
+        QList<qevercloud::Note> list;
+
+        timer.start();
+        for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it) {
+            list << *it;
+        }
+        results << makeResult(QStringLiteral("list"), QStringLiteral("append"), numNotes, timer.nsecsElapsed());
+
+        timer.restart();
+        for(auto git = guids.constBegin(), gend = guids.constEnd(); git != gend; ++git)
+        {
+            const QString & guid = *git;
+            auto it = list.begin();
+            for(auto end = list.end(); it != end; ++it)
+            {
+                if (it->guid.isSet() && (it->guid.ref() == guid)) {
+                    break;
+                }
+            }
+
+            if (it != list.end()) {
+                Q_UNUSED(list.erase(it))
+            }
+        }
+        results << makeResult(QStringLiteral("list"), QStringLiteral("find_and_remove_by_guid"), numNotes,
+                              timer.nsecsElapsed());
+    }
+
+    PendingItemsRegistry<qevercloud::Note> registry;
+
+    timer.start();
+    for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it) {
+        registry << *it;
+    }
+    results << makeResult(QStringLiteral("registry"), QStringLiteral("append"), numNotes, timer.nsecsElapsed());
+
+    timer.restart();
+    for(auto git = guids.constBegin(), gend = guids.constEnd(); git != gend; ++git)
+    {
+        auto it = registry.findByGuid(*git);
+        if (it != registry.end()) {
+            Q_UNUSED(registry.erase(it))
+        }
+    }
+    results << makeResult(QStringLiteral("registry"), QStringLiteral("find_and_remove_by_guid"), numNotes,
+                          timer.nsecsElapsed());
+}
+
+void PendingItemsRegistryBenchmark::writeResultsJson(const QList<Result> & results, const quint32 seed, QTextStream & strm)
+{
+    strm << QStringLiteral("{\n");
+    strm << QStringLiteral("  \"benchmark\": \"pending_items_registry\",\n");
+    strm << QStringLiteral("  \"timestamp\": ") << QDateTime::currentMSecsSinceEpoch() << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"seed\": ") << seed << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"results\": [\n");
+
+    for(int i = 0, size = results.size(); i < size; ++i)
+    {
+        const Result & result = results[i];
+        strm << QStringLiteral("    {\"container\": \"") << result.m_container
+             << QStringLiteral("\", \"operation\": \"") << result.m_operation
+             << QStringLiteral("\", \"notes\": ") << result.m_numNotes
+             << QStringLiteral(", \"total_usec\": ") << result.m_totalUsec
+             << QStringLiteral(", \"per_item_nsec\": ") << result.m_perItemNsec
+             << QStringLiteral("}") << ((i != (size - 1)) ? QStringLiteral(",\n") : QStringLiteral("\n"));
+    }
+
+    strm << QStringLiteral("  ]\n");
+    strm << QStringLiteral("}\n");
+    strm.flush();
+}
+
+PendingItemsRegistryBenchmark::Result PendingItemsRegistryBenchmark::makeResult(const QString & container,
+                                                                              const QString & operation,
+                                                                              const int numNotes,
+                                                                              const qint64 totalNsec)
+{
+    Result result;
+    result.m_container = container;
+    result.m_operation = operation;
+    result.m_numNotes = numNotes;
+    result.m_totalUsec = totalNsec / 1000;
+    result.m_perItemNsec = (numNotes > 0 ? (totalNsec / numNotes) : 0);
+    return result;
+}
+
+} // namespace benchmark
+} // namespace quentier
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_PENDING_ITEMS_REGISTRY_BENCHMARK_H
+#define LIB_QUENTIER_BENCHMARKS_PENDING_ITEMS_REGISTRY_BENCHMARK_H
+
+#include <QString>
+#include <QList>
+#include <QTextStream>
+
+namespace quentier {
+namespace benchmark {
+
+/**
+ * @brief The PendingItemsRegistryBenchmark class measures how the bookkeeping of the notes pending processing
+ * during the sync scales with the number of notes: the notes are appended to the container and then
+ * looked up by guid and removed from it one by one in random order, the way the local storage replies
+ * come in during the sync. Both the registry used by the sync and the plain list it replaced are measured.
+ */
+class PendingItemsRegistryBenchmark
+{
+public:
+    struct Result
+    {
+        Result();
+
+        QString     m_container;
+        QString     m_operation;
+        int         m_numNotes;
+        qint64      m_totalUsec;
+        qint64      m_perItemNsec;
+    };
+
+public:
+    explicit PendingItemsRegistryBenchmark(const quint32 seed);
+
+    /**
+     * @brief run - runs the benchmark for the specified number of notes
+     * @param numNotes - the number of notes pending processing
+     * @param includeList - whether the plain list should be measured as well; it scales quadratically
+     * so might take too long for large numbers of notes
+     * @param results - the results of the benchmark get appended to this list
+     */
+    void run(const int numNotes, const bool includeList, QList<Result> & results);
+
+    /**
+     * @brief writeResultsJson - writes the results of the benchmarks in JSON format
+     */
+    static void writeResultsJson(const QList<Result> & results, const quint32 seed, QTextStream & strm);
+
+private:
+    static Result makeResult(const QString & container, const QString & operation,
+                             const int numNotes, const qint64 totalNsec);
+
+private:
+    Q_DISABLE_COPY(PendingItemsRegistryBenchmark)
+
+private:
+    quint32     m_seed;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_PENDING_ITEMS_REGISTRY_BENCHMARK_H
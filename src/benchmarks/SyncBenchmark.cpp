@@ -0,0 +1,312 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncBenchmark.h"
+#include "FakeNoteStore.h"
+#include "FakeUserStore.h"
+#include "FakeAuthenticationManager.h"
+#include <quentier/synchronization/SynchronizationManager.h>
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_LINUX)
+#include <sys/resource.h>
+#endif
+
+#define FAKE_SERVICE_HOST QStringLiteral("fake.evernote.local")
+
+namespace quentier {
+namespace benchmark {
+
+#ifdef Q_OS_LINUX
+static qint64 readProcStatusValueKb(const char * key)
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    const QByteArray prefix(key);
+    while(!file.atEnd())
+    {
+        QByteArray line = file.readLine();
+        if (!line.startsWith(prefix)) {
+            continue;
+        }
+
+        // The line looks like "VmHWM:     123456 kB"
+        QByteArray value = line.mid(prefix.size()).trimmed();
+        int spaceIndex = value.indexOf(' ');
+        if (spaceIndex > 0) {
+            value.truncate(spaceIndex);
+        }
+
+        bool conversionResult = false;
+        qint64 valueKb = value.toLongLong(&conversionResult);
+        return (conversionResult ? valueKb : -1);
+    }
+
+    return -1;
+}
+#endif
+
+static qint64 currentRssKb()
+{
+#ifdef Q_OS_LINUX
+    return readProcStatusValueKb("VmRSS:");
+#else
+    return -1;
+#endif
+}
+
+static qint64 peakRssKb()
+{
+#if defined(Q_OS_LINUX)
+    return readProcStatusValueKb("VmHWM:");
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+
+#ifdef Q_OS_MAC
+    // On macOS ru_maxrss is in bytes
+    return static_cast<qint64>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<qint64>(usage.ru_maxrss);
+#endif
+#else
+    return -1;
+#endif
+}
+
+static void resetPeakRss()
+{
+#ifdef Q_OS_LINUX
+    // Writing "5" to clear_refs resets the peak RSS (VmHWM) to the current RSS; not supported by older kernels
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    if (file.open(QIODevice::WriteOnly)) {
+        Q_UNUSED(file.write("5"))
+    }
+#endif
+}
+
+SyncBenchmark::Result::Result() :
+    m_phase(),
+    m_numNotes(0),
+    m_wallMsec(0),
+    m_numRequests(0),
+    m_numSyncChunkRequests(0),
+    m_numNoteRequests(0),
+    m_numResourceRequests(0),
+    m_numRateLimitedRequests(0),
+    m_payloadBytes(0),
+    m_rssBeforeKb(-1),
+    m_peakRssKb(-1)
+{}
+
+SyncBenchmark::SyncBenchmark(const quint32 seed, const FakeSyncService::Settings & settings, QObject * parent) :
+    QObject(parent),
+    m_seed(seed),
+    m_settings(settings),
+    m_pEventLoop(Q_NULLPTR),
+    m_syncSucceeded(false),
+    m_syncErrorDescription()
+{}
+
+bool SyncBenchmark::run(const int numNotes, QList<Result> & results, ErrorString & errorDescription)
+{
+    QNINFO(QStringLiteral("Running the sync benchmark with ") << numNotes << QStringLiteral(" notes"));
+
+    FakeSyncService service(m_seed, m_settings);
+    service.populate(numNotes);
+
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(service.user().username.ref(), Account::Type::Evernote, service.userId(),
+                    Account::EvernoteAccountType::Free, FAKE_SERVICE_HOST);
+
+    QThread * pLocalStorageManagerThread = new QThread;
+    LocalStorageManagerAsync * pLocalStorageManagerAsync = new LocalStorageManagerAsync(account, startFromScratch, overrideLock);
+    pLocalStorageManagerAsync->moveToThread(pLocalStorageManagerThread);
+
+    QObject::connect(pLocalStorageManagerThread, QNSIGNAL(QThread,started),
+                     pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,init));
+
+    {
+        QEventLoop loop;
+        QObject::connect(pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,initialized),
+                         &loop, QNSLOT(QEventLoop,quit));
+        pLocalStorageManagerThread->start();
+        Q_UNUSED(loop.exec())
+    }
+
+    bool res = true;
+
+    {
+        FakeAuthenticationManager authenticationManager(service.userId());
+        SynchronizationManager syncManager(QStringLiteral("fake_consumer_key"), QStringLiteral("fake_consumer_secret"),
+                                           FAKE_SERVICE_HOST, *pLocalStorageManagerAsync, authenticationManager,
+                                           new FakeNoteStore(service), new FakeUserStore(service));
+
+        // Thumbnails and ink note images are downloaded via HTTP requests bypassing the note store
+        syncManager.setDownloadNoteThumbnails(false);
+        syncManager.setDownloadInkNoteImages(false);
+
+        QObject::connect(&syncManager, QNSIGNAL(SynchronizationManager,finished,Account),
+                         this, QNSLOT(SyncBenchmark,onSyncFinished,Account));
+        QObject::connect(&syncManager, QNSIGNAL(SynchronizationManager,failed,ErrorString),
+                         this, QNSLOT(SyncBenchmark,onSyncFailed,ErrorString));
+
+        Result result;
+        res = runPhase(QStringLiteral("full_sync"), numNotes, syncManager, service, result, errorDescription);
+        if (res)
+        {
+            results << result;
+
+            service.modify(/* modified notes = */ std::max(numNotes / 10, 1),
+                           /* new notes = */ std::max(numNotes / 20, 1),
+                           /* expunged notes = */ std::max(numNotes / 50, 1));
+
+            res = runPhase(QStringLiteral("incremental_sync"), numNotes, syncManager, service, result, errorDescription);
+            if (res) {
+                results << result;
+            }
+        }
+    }
+
+    pLocalStorageManagerThread->quit();
+    Q_UNUSED(pLocalStorageManagerThread->wait())
+    delete pLocalStorageManagerAsync;
+    delete pLocalStorageManagerThread;
+
+    return res;
+}
+
+void SyncBenchmark::writeResultsJson(const QList<Result> & results, QTextStream & strm) const
+{
+    strm << QStringLiteral("{\n");
+    strm << QStringLiteral("  \"benchmark\": \"sync\",\n");
+    strm << QStringLiteral("  \"timestamp\": ") << QDateTime::currentMSecsSinceEpoch() << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"seed\": ") << m_seed << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"latency_msec\": ") << m_settings.m_latencyMsec << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"rate_limit_every_nth_request\": ") << m_settings.m_rateLimitEveryNthRequest << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"rate_limit_seconds\": ") << m_settings.m_rateLimitSeconds << QStringLiteral(",\n");
+    strm << QStringLiteral("  \"results\": [\n");
+
+    for(int i = 0, size = results.size(); i < size; ++i)
+    {
+        const Result & result = results[i];
+        strm << QStringLiteral("    {\"phase\": \"") << result.m_phase
+             << QStringLiteral("\", \"notes\": ") << result.m_numNotes
+             << QStringLiteral(", \"wall_msec\": ") << result.m_wallMsec
+             << QStringLiteral(", \"requests\": ") << result.m_numRequests
+             << QStringLiteral(", \"sync_chunk_requests\": ") << result.m_numSyncChunkRequests
+             << QStringLiteral(", \"note_requests\": ") << result.m_numNoteRequests
+             << QStringLiteral(", \"resource_requests\": ") << result.m_numResourceRequests
+             << QStringLiteral(", \"rate_limited_requests\": ") << result.m_numRateLimitedRequests
+             << QStringLiteral(", \"payload_bytes\": ") << result.m_payloadBytes
+             << QStringLiteral(", \"rss_before_kb\": ") << result.m_rssBeforeKb
+             << QStringLiteral(", \"peak_rss_kb\": ") << result.m_peakRssKb
+             << QStringLiteral("}") << ((i != (size - 1)) ? QStringLiteral(",\n") : QStringLiteral("\n"));
+    }
+
+    strm << QStringLiteral("  ]\n");
+    strm << QStringLiteral("}\n");
+    strm.flush();
+}
+
+void SyncBenchmark::onSyncFinished(Account account)
+{
+    QNDEBUG(QStringLiteral("SyncBenchmark::onSyncFinished: ") << account);
+
+    m_syncSucceeded = true;
+    if (m_pEventLoop) {
+        m_pEventLoop->quit();
+    }
+}
+
+void SyncBenchmark::onSyncFailed(ErrorString errorDescription)
+{
+    QNWARNING(QStringLiteral("SyncBenchmark::onSyncFailed: ") << errorDescription);
+
+    m_syncSucceeded = false;
+    m_syncErrorDescription = errorDescription;
+    if (m_pEventLoop) {
+        m_pEventLoop->quit();
+    }
+}
+
+bool SyncBenchmark::runPhase(const QString & phase, const int numNotes, SynchronizationManager & syncManager,
+                             FakeSyncService & service, Result & result, ErrorString & errorDescription)
+{
+    QNINFO(QStringLiteral("Running ") << phase << QStringLiteral(" @ ") << numNotes << QStringLiteral(" notes"));
+
+    service.resetStatistics();
+    resetPeakRss();
+
+    result = Result();
+    result.m_phase = phase;
+    result.m_numNotes = numNotes;
+    result.m_rssBeforeKb = currentRssKb();
+
+    m_syncSucceeded = false;
+    m_syncErrorDescription.clear();
+
+    QEventLoop loop;
+    m_pEventLoop = &loop;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    syncManager.synchronize();
+    Q_UNUSED(loop.exec())
+
+    result.m_wallMsec = timer.elapsed();
+    m_pEventLoop = Q_NULLPTR;
+
+    if (!m_syncSucceeded) {
+        errorDescription = m_syncErrorDescription;
+        return false;
+    }
+
+    const FakeSyncService::Statistics & statistics = service.statistics();
+    result.m_numRequests = statistics.m_numRequests;
+    result.m_numSyncChunkRequests = statistics.m_numSyncChunkRequests;
+    result.m_numNoteRequests = statistics.m_numNoteRequests;
+    result.m_numResourceRequests = statistics.m_numResourceRequests;
+    result.m_numRateLimitedRequests = statistics.m_numRateLimitedRequests;
+    result.m_payloadBytes = statistics.m_payloadBytes;
+    result.m_peakRssKb = peakRssKb();
+
+    QNINFO(phase << QStringLiteral(" @ ") << numNotes << QStringLiteral(" notes: ") << result.m_wallMsec
+           << QStringLiteral(" msec, ") << result.m_numRequests << QStringLiteral(" requests, ")
+           << result.m_payloadBytes << QStringLiteral(" payload bytes, peak RSS = ") << result.m_peakRssKb
+           << QStringLiteral(" kB"));
+
+    return true;
+}
+
+} // namespace benchmark
+} // namespace quentier
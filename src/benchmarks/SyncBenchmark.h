@@ -0,0 +1,106 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_SYNC_BENCHMARK_H
+#define LIB_QUENTIER_BENCHMARKS_SYNC_BENCHMARK_H
+
+#include "FakeSyncService.h"
+#include <quentier/types/Account.h>
+#include <quentier/types/ErrorString.h>
+#include <QObject>
+#include <QList>
+#include <QTextStream>
+
+QT_FORWARD_DECLARE_CLASS(QEventLoop)
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(SynchronizationManager)
+
+namespace benchmark {
+
+/**
+ * @brief The SyncBenchmark class runs SynchronizationManager end to end against the in-process fake sync service
+ * populated with the synthetic account of the given size: first the full sync into the empty local storage,
+ * then the incremental sync after some of the notes were changed "remotely"
+ */
+class SyncBenchmark: public QObject
+{
+    Q_OBJECT
+public:
+    struct Result
+    {
+        Result();
+
+        QString     m_phase;
+        int         m_numNotes;
+        qint64      m_wallMsec;
+        qint64      m_numRequests;
+        qint64      m_numSyncChunkRequests;
+        qint64      m_numNoteRequests;
+        qint64      m_numResourceRequests;
+        qint64      m_numRateLimitedRequests;
+        qint64      m_payloadBytes;
+
+        // Resident set size before the sync (including the fake service's data) and its peak during the sync;
+        // -1 if not available on the current platform
+        qint64      m_rssBeforeKb;
+        qint64      m_peakRssKb;
+    };
+
+public:
+    SyncBenchmark(const quint32 seed, const FakeSyncService::Settings & settings, QObject * parent = Q_NULLPTR);
+
+    /**
+     * @brief run - runs the full and the incremental syncs of the account containing the specified number of notes
+     * @param numNotes - the number of notes in the account; the numbers of notebooks, tags and saved searches are derived from it
+     * @param results - the results of the benchmark get appended to this list
+     * @param errorDescription - the description of error if the benchmark could not be run
+     * @return true if the benchmark was run successfully, false otherwise
+     */
+    bool run(const int numNotes, QList<Result> & results, ErrorString & errorDescription);
+
+    /**
+     * @brief writeResultsJson - writes the results of the benchmarks in JSON format
+     */
+    void writeResultsJson(const QList<Result> & results, QTextStream & strm) const;
+
+private Q_SLOTS:
+    void onSyncFinished(Account account);
+    void onSyncFailed(ErrorString errorDescription);
+
+private:
+    bool runPhase(const QString & phase, const int numNotes, SynchronizationManager & syncManager,
+                  FakeSyncService & service, Result & result, ErrorString & errorDescription);
+
+private:
+    Q_DISABLE_COPY(SyncBenchmark)
+
+private:
+    quint32                     m_seed;
+    FakeSyncService::Settings   m_settings;
+
+    QEventLoop *                m_pEventLoop;
+    bool                        m_syncSucceeded;
+    ErrorString                 m_syncErrorDescription;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_SYNC_BENCHMARK_H
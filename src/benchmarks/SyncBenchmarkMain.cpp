@@ -0,0 +1,178 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncBenchmark.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/QuentierApplication.h>
+#include <quentier/utility/StandardPaths.h>
+#include <quentier/utility/Utility.h>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <iostream>
+
+using namespace quentier;
+using namespace quentier::benchmark;
+
+#define USAGE " [--sizes=1000,10000] [--latency=<msec>] [--rate-limit-every=<N>] [--rate-limit-seconds=<seconds>]" \
+              " [--seed=<number>] [--output=<path to JSON file>]"
+
+static bool parseNonNegativeInt(const QString & argument, const int prefixSize, int & value)
+{
+    bool conversionResult = false;
+    value = argument.mid(prefixSize).toInt(&conversionResult);
+    if (!conversionResult || (value < 0)) {
+        std::cerr << "Invalid value: " << qPrintable(argument) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Usage: sync_bench_libquentier [--sizes=1000,10000] [--latency=<msec>] [--rate-limit-every=<N>]
+ *                               [--rate-limit-seconds=<seconds>] [--seed=<number>] [--output=<path to JSON file>]
+ *
+ * Without --output the JSON results are written to the standard output. Unless LIBQUENTIER_PERSISTENCE_STORAGE_PATH
+ * environment variable is set, the local storage and the settings are kept within the fresh temporary directory
+ * so that each run starts with the full sync
+ */
+int main(int argc, char *argv[])
+{
+    QuentierApplication app(argc, argv);
+    app.setOrganizationName(QStringLiteral("d1vanov"));
+    app.setApplicationName(QStringLiteral("QuentierSyncBenchmark"));
+
+    if (qgetenv(LIBQUENTIER_PERSISTENCE_STORAGE_PATH).isEmpty())
+    {
+        QString storagePath = QDir::tempPath() + QStringLiteral("/QuentierSyncBenchmark_") +
+                              QString::number(QCoreApplication::applicationPid()) + QStringLiteral("_") +
+                              QString::number(QDateTime::currentMSecsSinceEpoch());
+        Q_UNUSED(QDir().mkpath(storagePath))
+        qputenv(LIBQUENTIER_PERSISTENCE_STORAGE_PATH, storagePath.toLocal8Bit());
+        std::cerr << "Using the persistent storage path " << qPrintable(storagePath) << std::endl;
+    }
+
+    // NOTE: not adding stdout log destination since the results might be written to stdout
+    QUENTIER_INITIALIZE_LOGGING();
+    QUENTIER_SET_MIN_LOG_LEVEL(Info);
+
+    initializeLibquentier();
+
+    QList<int> sizes;
+    sizes << 1000 << 10000;
+    quint32 seed = 42;
+    FakeSyncService::Settings settings;
+    QString outputFilePath;
+
+    QStringList arguments = app.arguments();
+    for(int i = 1, numArguments = arguments.size(); i < numArguments; ++i)
+    {
+        const QString & argument = arguments[i];
+        if (argument.startsWith(QStringLiteral("--sizes=")))
+        {
+            sizes.clear();
+            QStringList sizeStrings = argument.mid(8).split(QChar::fromLatin1(','), QString::SkipEmptyParts);
+            for(auto it = sizeStrings.constBegin(), end = sizeStrings.constEnd(); it != end; ++it)
+            {
+                bool conversionResult = false;
+                int size = it->toInt(&conversionResult);
+                if (!conversionResult || (size <= 0)) {
+                    std::cerr << "Invalid account size: " << qPrintable(*it) << std::endl;
+                    return 1;
+                }
+
+                sizes << size;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--latency=")))
+        {
+            if (!parseNonNegativeInt(argument, 10, settings.m_latencyMsec)) {
+                return 1;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--rate-limit-every=")))
+        {
+            if (!parseNonNegativeInt(argument, 19, settings.m_rateLimitEveryNthRequest)) {
+                return 1;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--rate-limit-seconds=")))
+        {
+            int rateLimitSeconds = 0;
+            if (!parseNonNegativeInt(argument, 21, rateLimitSeconds) || (rateLimitSeconds == 0)) {
+                std::cerr << "The number of seconds to wait on rate limit must be positive" << std::endl;
+                return 1;
+            }
+
+            settings.m_rateLimitSeconds = rateLimitSeconds;
+        }
+        else if (argument.startsWith(QStringLiteral("--seed=")))
+        {
+            bool conversionResult = false;
+            seed = argument.mid(7).toUInt(&conversionResult);
+            if (!conversionResult) {
+                std::cerr << "Invalid seed: " << qPrintable(argument.mid(7)) << std::endl;
+                return 1;
+            }
+        }
+        else if (argument.startsWith(QStringLiteral("--output=")))
+        {
+            outputFilePath = argument.mid(9);
+        }
+        else
+        {
+            std::cerr << "Usage: " << qPrintable(arguments[0]) << USAGE << std::endl;
+            return 1;
+        }
+    }
+
+    SyncBenchmark benchmark(seed, settings);
+    QList<SyncBenchmark::Result> results;
+
+    for(auto it = sizes.constBegin(), end = sizes.constEnd(); it != end; ++it)
+    {
+        std::cerr << "Running the sync benchmark for the account with " << *it << " notes" << std::endl;
+
+        ErrorString errorDescription;
+        bool res = benchmark.run(*it, results, errorDescription);
+        if (!res) {
+            std::cerr << "Sync benchmark failed for the account with " << *it << " notes: "
+                      << qPrintable(errorDescription.nonLocalizedString()) << std::endl;
+            return 1;
+        }
+    }
+
+    if (outputFilePath.isEmpty()) {
+        QTextStream strm(stdout);
+        benchmark.writeResultsJson(results, strm);
+        return 0;
+    }
+
+    QFile outputFile(outputFilePath);
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        std::cerr << "Can't open the output file " << qPrintable(outputFilePath) << " for writing: "
+                  << qPrintable(outputFile.errorString()) << std::endl;
+        return 1;
+    }
+
+    QTextStream strm(&outputFile);
+    benchmark.writeResultsJson(results, strm);
+    return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticDatasetGenerator.h"
+#include <QCryptographicHash>
+#include <algorithm>
+
+// Base timestamp for the generated data elements: 2017-01-01T00:00:00Z, in milliseconds since epoch
+#define BASE_TIMESTAMP (Q_INT64_C(1483228800000))
+
+namespace quentier {
+namespace benchmark {
+
+SyntheticDatasetGenerator::SyntheticDatasetGenerator(const quint32 seed) :
+    m_state(seed ? seed : 1),
+    m_words()
+{
+    m_words << QStringLiteral("account") << QStringLiteral("budget") << QStringLiteral("calendar")
+            << QStringLiteral("design") << QStringLiteral("evening") << QStringLiteral("family")
+            << QStringLiteral("garden") << QStringLiteral("holiday") << QStringLiteral("invoice")
+            << QStringLiteral("journey") << QStringLiteral("kitchen") << QStringLiteral("library")
+            << QStringLiteral("meeting") << QStringLiteral("network") << QStringLiteral("office")
+            << QStringLiteral("project") << QStringLiteral("question") << QStringLiteral("recipe")
+            << QStringLiteral("schedule") << QStringLiteral("travel") << QStringLiteral("update")
+            << QStringLiteral("vacation") << QStringLiteral("weekend") << QStringLiteral("yearly")
+            << QStringLiteral("zone") << QStringLiteral("archive") << QStringLiteral("backup")
+            << QStringLiteral("contract") << QStringLiteral("deadline") << QStringLiteral("estimate")
+            << QStringLiteral("feedback") << QStringLiteral("grocery") << QStringLiteral("hardware")
+            << QStringLiteral("interview") << QStringLiteral("lecture") << QStringLiteral("manual")
+            << QStringLiteral("notebook") << QStringLiteral("outline") << QStringLiteral("payment")
+            << QStringLiteral("receipt") << QStringLiteral("summary") << QStringLiteral("ticket")
+            << QStringLiteral("university") << QStringLiteral("version") << QStringLiteral("workshop");
+}
+
+Notebook SyntheticDatasetGenerator::generateNotebook(const int index)
+{
+    Notebook notebook;
+    notebook.setLocalUid(generateGuid());
+    notebook.setGuid(generateGuid());
+    notebook.setUpdateSequenceNumber(index + 1);
+    notebook.setName(QStringLiteral("Notebook #") + QString::number(index) + QStringLiteral(" ") + randomWord());
+    notebook.setCreationTimestamp(BASE_TIMESTAMP + index);
+    notebook.setModificationTimestamp(BASE_TIMESTAMP + index);
+    notebook.setDefaultNotebook(index == 0);
+    notebook.setLastUsed(false);
+    return notebook;
+}
+
+Tag SyntheticDatasetGenerator::generateTag(const int index, const Tag * pParentTag)
+{
+    Tag tag;
+    tag.setLocalUid(generateGuid());
+    tag.setGuid(generateGuid());
+    tag.setUpdateSequenceNumber(index + 1);
+    tag.setName(QStringLiteral("tag") + QString::number(index) + QStringLiteral("_") + randomWord());
+
+    if (pParentTag) {
+        tag.setParentGuid(pParentTag->guid());
+        tag.setParentLocalUid(pParentTag->localUid());
+    }
+
+    return tag;
+}
+
+Note SyntheticDatasetGenerator::generateNote(const int index, const Notebook & notebook, const QList<Tag> & tags,
+                                             const int maxTagsPerNote, const int maxResourcesPerNote)
+{
+    Note note;
+    note.setLocalUid(generateGuid());
+    note.setGuid(generateGuid());
+    note.setUpdateSequenceNumber(index + 1);
+    note.setNotebookGuid(notebook.guid());
+    note.setNotebookLocalUid(notebook.localUid());
+    note.setTitle(randomWord() + QStringLiteral(" ") + randomWord() + QStringLiteral(" #") + QString::number(index));
+    note.setCreationTimestamp(BASE_TIMESTAMP + index * 1000);
+    note.setModificationTimestamp(BASE_TIMESTAMP + index * 1000 + randomInt(0, 999));
+    note.setActive(true);
+
+    if (!tags.isEmpty())
+    {
+        int numTags = randomInt(0, std::min(maxTagsPerNote, tags.size()));
+        for(int i = 0; i < numTags; ++i)
+        {
+            const Tag & tag = tags[randomInt(0, tags.size() - 1)];
+            if (note.tagLocalUids().contains(tag.localUid())) {
+                continue;
+            }
+
+            note.addTagLocalUid(tag.localUid());
+            note.addTagGuid(tag.guid());
+        }
+    }
+
+    QList<Resource> resources;
+    int numResources = randomInt(0, maxResourcesPerNote);
+    for(int i = 0; i < numResources; ++i) {
+        resources << generateResource(note, i);
+    }
+
+    if (!resources.isEmpty()) {
+        note.setResources(resources);
+    }
+
+    note.setContent(generateNoteContent(resources));
+    return note;
+}
+
+QString SyntheticDatasetGenerator::generateNoteContent(const QList<Resource> & resources)
+{
+    QString content = QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                                     "<!DOCTYPE en-note SYSTEM \"http://xml.evernote.com/pub/enml2.dtd\">"
+                                     "<en-note>");
+
+    int numParagraphs = randomInt(1, 8);
+    for(int i = 0; i < numParagraphs; ++i)
+    {
+        content += QStringLiteral("<div>");
+
+        if (randomInt(0, 4) == 0) {
+            content += QStringLiteral("<en-todo checked=\"") + (randomInt(0, 1) ? QStringLiteral("true") : QStringLiteral("false"))
+                       + QStringLiteral("\"/>");
+        }
+
+        int numWords = randomInt(5, 40);
+        for(int j = 0; j < numWords; ++j)
+        {
+            if (j != 0) {
+                content += QStringLiteral(" ");
+            }
+
+            if (randomInt(0, 9) == 0) {
+                content += QStringLiteral("<b>") + randomWord() + QStringLiteral("</b>");
+            }
+            else {
+                content += randomWord();
+            }
+        }
+
+        content += QStringLiteral("</div>");
+    }
+
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        content += QStringLiteral("<div><en-media type=\"") + it->mime() + QStringLiteral("\" hash=\"")
+                   + QString::fromLocal8Bit(it->dataHash().toHex()) + QStringLiteral("\"/></div>");
+    }
+
+    content += QStringLiteral("</en-note>");
+    return content;
+}
+
+QString SyntheticDatasetGenerator::randomWord()
+{
+    return m_words[randomInt(0, m_words.size() - 1)];
+}
+
+int SyntheticDatasetGenerator::randomInt(const int min, const int max)
+{
+    if (max <= min) {
+        return min;
+    }
+
+    return min + static_cast<int>(nextRandom() % static_cast<quint32>(max - min + 1));
+}
+
+quint32 SyntheticDatasetGenerator::nextRandom()
+{
+    // xorshift32: fast, deterministic across platforms and independent of the global qrand state
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state;
+}
+
+QString SyntheticDatasetGenerator::generateGuid()
+{
+    QByteArray bytes = generateBytes(16).toHex();
+    QString hex = QString::fromLocal8Bit(bytes);
+    return hex.mid(0, 8) + QStringLiteral("-") + hex.mid(8, 4) + QStringLiteral("-") + hex.mid(12, 4) +
+           QStringLiteral("-") + hex.mid(16, 4) + QStringLiteral("-") + hex.mid(20, 12);
+}
+
+QByteArray SyntheticDatasetGenerator::generateBytes(const int size)
+{
+    QByteArray bytes;
+    bytes.resize(size);
+
+    for(int i = 0; i < size; ++i) {
+        bytes[i] = static_cast<char>(nextRandom() & 0xFF);
+    }
+
+    return bytes;
+}
+
+Resource SyntheticDatasetGenerator::generateResource(const Note & note, const int indexInNote)
+{
+    Resource resource;
+    resource.setLocalUid(generateGuid());
+    resource.setGuid(generateGuid());
+    resource.setUpdateSequenceNumber(note.updateSequenceNumber());
+    resource.setNoteLocalUid(note.localUid());
+    resource.setNoteGuid(note.guid());
+    resource.setIndexInNote(indexInNote);
+
+    QByteArray dataBody = generateBytes(randomInt(1024, 16384));
+    resource.setDataBody(dataBody);
+    resource.setDataSize(dataBody.size());
+    resource.setDataHash(QCryptographicHash::hash(dataBody, QCryptographicHash::Md5));
+    resource.setMime(QStringLiteral("image/png"));
+    resource.setWidth(static_cast<qint16>(randomInt(64, 1024)));
+    resource.setHeight(static_cast<qint16>(randomInt(64, 1024)));
+
+    QString recognitionData = QStringLiteral("<recoIndex docType=\"unknown\" objType=\"image\" objID=\"") +
+                              QString::fromLocal8Bit(resource.dataHash().toHex()) +
+                              QStringLiteral("\" engineVersion=\"5.5.22.7\" recoType=\"service\" lang=\"en\" "
+                                             "objWidth=\"") + QString::number(resource.width()) +
+                              QStringLiteral("\" objHeight=\"") + QString::number(resource.height()) +
+                              QStringLiteral("\">");
+
+    int numItems = randomInt(1, 4);
+    for(int i = 0; i < numItems; ++i)
+    {
+        recognitionData += QStringLiteral("<item x=\"") + QString::number(randomInt(0, 500)) +
+                           QStringLiteral("\" y=\"") + QString::number(randomInt(0, 500)) +
+                           QStringLiteral("\" w=\"") + QString::number(randomInt(10, 200)) +
+                           QStringLiteral("\" h=\"") + QString::number(randomInt(10, 50)) + QStringLiteral("\">");
+
+        int numAlternatives = randomInt(1, 3);
+        for(int j = 0; j < numAlternatives; ++j) {
+            recognitionData += QStringLiteral("<t w=\"") + QString::number(randomInt(10, 90)) + QStringLiteral("\">") +
+                               randomWord() + QStringLiteral("</t>");
+        }
+
+        recognitionData += QStringLiteral("</item>");
+    }
+
+    recognitionData += QStringLiteral("</recoIndex>");
+
+    QByteArray recognitionDataBody = recognitionData.toUtf8();
+    resource.setRecognitionDataBody(recognitionDataBody);
+    resource.setRecognitionDataSize(recognitionDataBody.size());
+    resource.setRecognitionDataHash(QCryptographicHash::hash(recognitionDataBody, QCryptographicHash::Md5));
+
+    return resource;
+}
+
+} // namespace benchmark
+} // namespace quentier
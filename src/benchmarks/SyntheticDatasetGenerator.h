@@ -0,0 +1,96 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_BENCHMARKS_SYNTHETIC_DATASET_GENERATOR_H
+#define LIB_QUENTIER_BENCHMARKS_SYNTHETIC_DATASET_GENERATOR_H
+
+#include <quentier/types/Notebook.h>
+#include <quentier/types/Tag.h>
+#include <quentier/types/Note.h>
+#include <quentier/types/Resource.h>
+#include <QStringList>
+
+namespace quentier {
+namespace benchmark {
+
+/**
+ * @brief The SyntheticDatasetGenerator class generates the data elements resembling those of a real account:
+ * notebooks, hierarchical tags, notes with ENML content and resources with recognition data
+ *
+ * The generator is fully deterministic: given the same seed it produces exactly the same data elements,
+ * including their guids and local uids, so the benchmark results obtained with different versions
+ * of the library are comparable
+ */
+class SyntheticDatasetGenerator
+{
+public:
+    explicit SyntheticDatasetGenerator(const quint32 seed);
+
+    Notebook generateNotebook(const int index);
+
+    /**
+     * @brief generateTag - generates the tag with the optional parent tag
+     * @param index - the index of the tag within the dataset, used for the tag name
+     * @param pParentTag - pointer to the parent tag, null for the top-level tag
+     */
+    Tag generateTag(const int index, const Tag * pParentTag);
+
+    /**
+     * @brief generateNote - generates the note within the given notebook, labeled with some
+     * of the passed in tags and with some resources
+     * @param index - the index of the note within the dataset
+     * @param notebook - the notebook the note would belong to
+     * @param tags - the tags the note's tags would be chosen from
+     * @param maxTagsPerNote - the max number of tags labeling the note
+     * @param maxResourcesPerNote - the max number of resources of the note
+     */
+    Note generateNote(const int index, const Notebook & notebook, const QList<Tag> & tags,
+                      const int maxTagsPerNote, const int maxResourcesPerNote);
+
+    /**
+     * @brief generateNoteContent - generates the ENML content of the note with the specified resources
+     */
+    QString generateNoteContent(const QList<Resource> & resources);
+
+    /**
+     * @brief generateResource - generates the resource with the data and recognition data for the given note
+     * @param note - the note the resource would belong to
+     * @param indexInNote - the index of the resource within the note
+     */
+    Resource generateResource(const Note & note, const int indexInNote);
+
+    QString randomWord();
+    int randomInt(const int min, const int max);
+
+private:
+    quint32 nextRandom();
+    QString generateGuid();
+    QByteArray generateBytes(const int size);
+
+private:
+    Q_DISABLE_COPY(SyntheticDatasetGenerator)
+
+private:
+    quint32         m_state;
+    QStringList     m_words;
+};
+
+} // namespace benchmark
+} // namespace quentier
+
+#endif // LIB_QUENTIER_BENCHMARKS_SYNTHETIC_DATASET_GENERATOR_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <quentier/local_storage/ChangeJournalEntry.h>
+#include <quentier/utility/Utility.h>
+
+namespace quentier {
+
+ChangeJournalEntry::ChangeJournalEntry() :
+    Printable(),
+    sequenceNumber(-1),
+    entityType(EntityType::Note),
+    changeType(ChangeType::Update),
+    localUid(),
+    changedFields(),
+    timestamp(0)
+{}
+
+ChangeJournalEntry::~ChangeJournalEntry()
+{}
+
+bool ChangeJournalEntry::operator==(const ChangeJournalEntry & other) const
+{
+    return (sequenceNumber == other.sequenceNumber) &&
+           (entityType == other.entityType) &&
+           (changeType == other.changeType) &&
+           (localUid == other.localUid) &&
+           (changedFields == other.changedFields) &&
+           (timestamp == other.timestamp);
+}
+
+bool ChangeJournalEntry::operator!=(const ChangeJournalEntry & other) const
+{
+    return !(*this == other);
+}
+
+QTextStream & ChangeJournalEntry::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("ChangeJournalEntry: {\n");
+    strm << QStringLiteral("    sequence number = ") << sequenceNumber << QStringLiteral(";\n");
+
+    strm << QStringLiteral("    entity type = ");
+    switch(entityType)
+    {
+    case EntityType::Notebook:
+        strm << QStringLiteral("Notebook");
+        break;
+    case EntityType::LinkedNotebook:
+        strm << QStringLiteral("LinkedNotebook");
+        break;
+    case EntityType::Note:
+        strm << QStringLiteral("Note");
+        break;
+    case EntityType::Tag:
+        strm << QStringLiteral("Tag");
+        break;
+    case EntityType::Resource:
+        strm << QStringLiteral("Resource");
+        break;
+    case EntityType::SavedSearch:
+        strm << QStringLiteral("SavedSearch");
+        break;
+    default:
+        strm << QStringLiteral("Unknown (") << static_cast<qint64>(entityType) << QStringLiteral(")");
+        break;
+    }
+    strm << QStringLiteral(";\n");
+
+    strm << QStringLiteral("    change type = ");
+    switch(changeType)
+    {
+    case ChangeType::Add:
+        strm << QStringLiteral("Add");
+        break;
+    case ChangeType::Update:
+        strm << QStringLiteral("Update");
+        break;
+    case ChangeType::Expunge:
+        strm << QStringLiteral("Expunge");
+        break;
+    default:
+        strm << QStringLiteral("Unknown (") << static_cast<qint64>(changeType) << QStringLiteral(")");
+        break;
+    }
+    strm << QStringLiteral(";\n");
+
+    strm << QStringLiteral("    local uid = ") << localUid << QStringLiteral(";\n");
+    strm << QStringLiteral("    changed fields = ")
+         << (changedFields.isEmpty() ? QStringLiteral("<all>") : changedFields.join(QStringLiteral(", ")))
+         << QStringLiteral(";\n");
+    strm << QStringLiteral("    timestamp = ") << printableDateTimeFromTimestamp(timestamp) << QStringLiteral(";\n");
+    strm << QStringLiteral("};\n");
+
+    return strm;
+}
+
+} // namespace quentier
@@ -19,6 +19,9 @@
 #include <quentier/local_storage/LocalStorageManager.h>
 #include "LocalStorageManager_p.h"
 
+#define MEASURE_LOCAL_STORAGE_OPERATION(operation) \
+    LocalStorageOperationTimer operationTimer(d->statisticsCollector(), QStringLiteral(#operation))
+
 namespace quentier {
 
 LocalStorageManager::LocalStorageManager(const Account & account,
@@ -35,36 +38,42 @@ LocalStorageManager::~LocalStorageManager()
 bool LocalStorageManager::addUser(const User & user, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addUser);
     return d->addUser(user, errorDescription);
 }
 
 bool LocalStorageManager::updateUser(const User & user, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateUser);
     return d->updateUser(user, errorDescription);
 }
 
 bool LocalStorageManager::findUser(User & user, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findUser);
     return d->findUser(user, errorDescription);
 }
 
 bool LocalStorageManager::deleteUser(const User & user, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(deleteUser);
     return d->deleteUser(user, errorDescription);
 }
 
 bool LocalStorageManager::expungeUser(const User & user, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeUser);
     return d->expungeUser(user, errorDescription);
 }
 
 int LocalStorageManager::notebookCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(notebookCount);
     return d->notebookCount(errorDescription);
 }
 
@@ -72,48 +81,56 @@ void LocalStorageManager::switchUser(const Account & account,
                                      const bool startFromScratch, const bool overrideLock)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(switchUser);
     d->switchUser(account, startFromScratch, overrideLock);
 }
 
 int LocalStorageManager::userCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(userCount);
     return d->userCount(errorDescription);
 }
 
 bool LocalStorageManager::addNotebook(Notebook & notebook, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addNotebook);
     return d->addNotebook(notebook, errorDescription);
 }
 
 bool LocalStorageManager::updateNotebook(Notebook & notebook, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateNotebook);
     return d->updateNotebook(notebook, errorDescription);
 }
 
 bool LocalStorageManager::findNotebook(Notebook & notebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findNotebook);
     return d->findNotebook(notebook, errorDescription);
 }
 
 bool LocalStorageManager::findDefaultNotebook(Notebook & notebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findDefaultNotebook);
     return d->findDefaultNotebook(notebook, errorDescription);
 }
 
 bool LocalStorageManager::findLastUsedNotebook(Notebook & notebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findLastUsedNotebook);
     return d->findLastUsedNotebook(notebook, errorDescription);
 }
 
 bool LocalStorageManager::findDefaultOrLastUsedNotebook(Notebook & notebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findDefaultOrLastUsedNotebook);
     return d->findDefaultOrLastUsedNotebook(notebook, errorDescription);
 }
 
@@ -124,6 +141,7 @@ QList<Notebook> LocalStorageManager::listAllNotebooks(ErrorString & errorDescrip
                                                       const QString & linkedNotebookGuid) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllNotebooks);
     return d->listAllNotebooks(errorDescription, limit, offset, order, orderDirection, linkedNotebookGuid);
 }
 
@@ -134,12 +152,14 @@ QList<Notebook> LocalStorageManager::listNotebooks(const ListObjectsOptions flag
                                                    const QString & linkedNotebookGuid) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listNotebooks);
     return d->listNotebooks(flag, errorDescription, limit, offset, order, orderDirection, linkedNotebookGuid);
 }
 
 QList<SharedNotebook> LocalStorageManager::listAllSharedNotebooks(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllSharedNotebooks);
     return d->listAllSharedNotebooks(errorDescription);
 }
 
@@ -147,18 +167,21 @@ QList<SharedNotebook> LocalStorageManager::listSharedNotebooksPerNotebookGuid(co
                                                                                      ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listSharedNotebooksPerNotebookGuid);
     return d->listSharedNotebooksPerNotebookGuid(notebookGuid, errorDescription);
 }
 
 bool LocalStorageManager::expungeNotebook(Notebook & notebook, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeNotebook);
     return d->expungeNotebook(notebook, errorDescription);
 }
 
 int LocalStorageManager::linkedNotebookCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(linkedNotebookCount);
     return d->linkedNotebookCount(errorDescription);
 }
 
@@ -166,6 +189,7 @@ bool LocalStorageManager::addLinkedNotebook(const LinkedNotebook & linkedNoteboo
                                             ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addLinkedNotebook);
     return d->addLinkedNotebook(linkedNotebook, errorDescription);
 }
 
@@ -173,12 +197,14 @@ bool LocalStorageManager::updateLinkedNotebook(const LinkedNotebook & linkedNote
                                                ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateLinkedNotebook);
     return d->updateLinkedNotebook(linkedNotebook, errorDescription);
 }
 
 bool LocalStorageManager::findLinkedNotebook(LinkedNotebook & linkedNotebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findLinkedNotebook);
     return d->findLinkedNotebook(linkedNotebook, errorDescription);
 }
 
@@ -187,6 +213,7 @@ QList<LinkedNotebook> LocalStorageManager::listAllLinkedNotebooks(ErrorString &
                                                                   const OrderDirection::type orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllLinkedNotebooks);
     return d->listAllLinkedNotebooks(errorDescription, limit, offset, order, orderDirection);
 }
 
@@ -195,6 +222,7 @@ QList<LinkedNotebook> LocalStorageManager::listLinkedNotebooks(const ListObjects
                                                                const OrderDirection::type orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listLinkedNotebooks);
     return d->listLinkedNotebooks(flag, errorDescription, limit, offset, order, orderDirection);
 }
 
@@ -202,36 +230,42 @@ bool LocalStorageManager::expungeLinkedNotebook(const LinkedNotebook & linkedNot
                                                 ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeLinkedNotebook);
     return d->expungeLinkedNotebook(linkedNotebook, errorDescription);
 }
 
 int LocalStorageManager::noteCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(noteCount);
     return d->noteCount(errorDescription);
 }
 
 int LocalStorageManager::noteCountPerNotebook(const Notebook & notebook, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(noteCountPerNotebook);
     return d->noteCountPerNotebook(notebook, errorDescription);
 }
 
 int LocalStorageManager::noteCountPerTag(const Tag & tag, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(noteCountPerTag);
     return d->noteCountPerTag(tag, errorDescription);
 }
 
 bool LocalStorageManager::noteCountsPerAllTags(QHash<QString, int> & noteCountsPerTagLocalUid, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(noteCountsPerAllTags);
     return d->noteCountsPerAllTags(noteCountsPerTagLocalUid, errorDescription);
 }
 
 bool LocalStorageManager::addNote(Note & note, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addNote);
     return d->addNote(note, errorDescription);
 }
 
@@ -239,13 +273,23 @@ bool LocalStorageManager::updateNote(Note & note, const bool updateResources,
                                      const bool updateTags, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateNote);
     return d->updateNote(note, updateResources, updateTags, errorDescription);
 }
 
+bool LocalStorageManager::updateNotes(QList<Note> & notes, const bool updateResources,
+                                      const bool updateTags, ErrorString & errorDescription)
+{
+    Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateNotes);
+    return d->updateNotes(notes, updateResources, updateTags, errorDescription);
+}
+
 bool LocalStorageManager::findNote(Note & note, ErrorString & errorDescription,
                                    const bool withResourceBinaryData) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findNote);
     return d->findNote(note, errorDescription, withResourceBinaryData);
 }
 
@@ -258,6 +302,7 @@ QList<Note> LocalStorageManager::listNotesPerNotebook(const Notebook & notebook,
                                                       const LocalStorageManager::OrderDirection::type & orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listNotesPerNotebook);
     return d->listNotesPerNotebook(notebook, errorDescription, withResourceBinaryData,
                                    flag, limit, offset, order, orderDirection);
 }
@@ -270,6 +315,7 @@ QList<Note> LocalStorageManager::listNotesPerTag(const Tag & tag, ErrorString &
                                                  const LocalStorageManager::OrderDirection::type & orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listNotesPerTag);
     return d->listNotesPerTag(tag, errorDescription, withResourceBinaryData, flag, limit, offset, order, orderDirection);
 }
 
@@ -280,6 +326,7 @@ QList<Note> LocalStorageManager::listNotes(const ListObjectsOptions flag, ErrorS
                                            const QString & linkedNotebookGuid) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listNotes);
     return d->listNotes(flag, errorDescription, withResourceBinaryData, limit, offset, order, orderDirection, linkedNotebookGuid);
 }
 
@@ -287,6 +334,7 @@ QStringList LocalStorageManager::findNoteLocalUidsWithSearchQuery(const NoteSear
                                                                   ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findNoteLocalUidsWithSearchQuery);
     return d->findNoteLocalUidsWithSearchQuery(noteSearchQuery, errorDescription);
 }
 
@@ -295,36 +343,42 @@ NoteList LocalStorageManager::findNotesWithSearchQuery(const NoteSearchQuery & n
                                                        const bool withResourceBinaryData) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findNotesWithSearchQuery);
     return d->findNotesWithSearchQuery(noteSearchQuery, errorDescription, withResourceBinaryData);
 }
 
 bool LocalStorageManager::expungeNote(Note & note, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeNote);
     return d->expungeNote(note, errorDescription);
 }
 
 int LocalStorageManager::tagCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(tagCount);
     return d->tagCount(errorDescription);
 }
 
 bool LocalStorageManager::addTag(Tag & tag, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addTag);
     return d->addTag(tag, errorDescription);
 }
 
 bool LocalStorageManager::updateTag(Tag & tag, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateTag);
     return d->updateTag(tag, errorDescription);
 }
 
 bool LocalStorageManager::findTag(Tag & tag, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findTag);
     return d->findTag(tag, errorDescription);
 }
 
@@ -334,6 +388,7 @@ QList<Tag> LocalStorageManager::listAllTagsPerNote(const Note & note, ErrorStrin
                                                    const OrderDirection::type & orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllTagsPerNote);
     return d->listAllTagsPerNote(note, errorDescription, flag, limit, offset, order, orderDirection);
 }
 
@@ -343,6 +398,7 @@ QList<Tag> LocalStorageManager::listAllTags(ErrorString & errorDescription, cons
                                             const QString & linkedNotebookGuid) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllTags);
     return d->listAllTags(errorDescription, limit, offset, order, orderDirection, linkedNotebookGuid);
 }
 
@@ -353,36 +409,42 @@ QList<Tag> LocalStorageManager::listTags(const ListObjectsOptions flag, ErrorStr
                                          const QString & linkedNotebookGuid) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listTags);
     return d->listTags(flag, errorDescription, limit, offset, order, orderDirection, linkedNotebookGuid);
 }
 
 bool LocalStorageManager::expungeTag(Tag & tag, QStringList & expungedChildTagLocalUids, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeTag);
     return d->expungeTag(tag, expungedChildTagLocalUids, errorDescription);
 }
 
 bool LocalStorageManager::expungeNotelessTagsFromLinkedNotebooks(ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeNotelessTagsFromLinkedNotebooks);
     return d->expungeNotelessTagsFromLinkedNotebooks(errorDescription);
 }
 
 int LocalStorageManager::enResourceCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(enResourceCount);
     return d->enResourceCount(errorDescription);
 }
 
 bool LocalStorageManager::addEnResource(Resource & resource, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addEnResource);
     return d->addEnResource(resource, errorDescription);
 }
 
 bool LocalStorageManager::updateEnResource(Resource & resource, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateEnResource);
     return d->updateEnResource(resource, errorDescription);
 }
 
@@ -390,36 +452,42 @@ bool LocalStorageManager::findEnResource(Resource & resource, ErrorString & erro
                                          const bool withBinaryData) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findEnResource);
     return d->findEnResource(resource, errorDescription, withBinaryData);
 }
 
 bool LocalStorageManager::expungeEnResource(Resource & resource, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeEnResource);
     return d->expungeEnResource(resource, errorDescription);
 }
 
 int LocalStorageManager::savedSearchCount(ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(savedSearchCount);
     return d->savedSearchCount(errorDescription);
 }
 
 bool LocalStorageManager::addSavedSearch(SavedSearch & search, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(addSavedSearch);
     return d->addSavedSearch(search, errorDescription);
 }
 
 bool LocalStorageManager::updateSavedSearch(SavedSearch & search, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(updateSavedSearch);
     return d->updateSavedSearch(search, errorDescription);
 }
 
 bool LocalStorageManager::findSavedSearch(SavedSearch & search, ErrorString & errorDescription) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(findSavedSearch);
     return d->findSavedSearch(search, errorDescription);
 }
 
@@ -428,6 +496,7 @@ QList<SavedSearch> LocalStorageManager::listAllSavedSearches(ErrorString & error
                                                              const OrderDirection::type orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listAllSavedSearches);
     return d->listAllSavedSearches(errorDescription, limit, offset, order, orderDirection);
 }
 
@@ -437,19 +506,109 @@ QList<SavedSearch> LocalStorageManager::listSavedSearches(const ListObjectsOptio
                                                           const OrderDirection::type orderDirection) const
 {
     Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listSavedSearches);
     return d->listSavedSearches(flag, errorDescription, limit, offset, order, orderDirection);
 }
 
 bool LocalStorageManager::expungeSavedSearch(SavedSearch & search, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeSavedSearch);
     return d->expungeSavedSearch(search, errorDescription);
 }
 
 qint32 LocalStorageManager::accountHighUsn(const QString & linkedNotebookGuid, ErrorString & errorDescription)
 {
     Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(accountHighUsn);
     return d->accountHighUsn(linkedNotebookGuid, errorDescription);
 }
 
+QList<ChangeJournalEntry> LocalStorageManager::listChangesSince(const qint64 sequenceNumber, ErrorString & errorDescription,
+                                                                const size_t limit) const
+{
+    Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listChangesSince);
+    return d->listChangesSince(sequenceNumber, errorDescription, limit);
+}
+
+qint64 LocalStorageManager::lastChangeSequenceNumber(ErrorString & errorDescription) const
+{
+    Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(lastChangeSequenceNumber);
+    return d->lastChangeSequenceNumber(errorDescription);
+}
+
+bool LocalStorageManager::trimChangeJournal(const qint64 upToSequenceNumber, ErrorString & errorDescription)
+{
+    Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(trimChangeJournal);
+    return d->trimChangeJournal(upToSequenceNumber, errorDescription);
+}
+
+QHash<QString,QByteArray> LocalStorageManager::listResourceSyncedDataHashes(const QStringList & noteLocalUids,
+                                                                           ErrorString & errorDescription) const
+{
+    Q_D(const LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(listResourceSyncedDataHashes);
+    return d->listResourceSyncedDataHashes(noteLocalUids, errorDescription);
+}
+
+LocalStorageStatistics LocalStorageManager::statistics() const
+{
+    Q_D(const LocalStorageManager);
+    return d->statistics();
+}
+
+void LocalStorageManager::resetStatistics()
+{
+    Q_D(LocalStorageManager);
+    d->resetStatistics();
+}
+
+bool LocalStorageManager::statisticsCollectionEnabled() const
+{
+    Q_D(const LocalStorageManager);
+    return d->statisticsCollectionEnabled();
+}
+
+void LocalStorageManager::setStatisticsCollectionEnabled(const bool enabled)
+{
+    Q_D(LocalStorageManager);
+    d->setStatisticsCollectionEnabled(enabled);
+}
+
+void LocalStorageManager::setSlowQueryThreshold(const qint64 thresholdUsec)
+{
+    Q_D(LocalStorageManager);
+    d->setSlowQueryThreshold(thresholdUsec);
+}
+
+bool LocalStorageManager::exportSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                                         ErrorString & errorDescription)
+{
+    Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(exportSnapshot);
+    return d->exportSnapshot(snapshotFilePath, snapshotInfo, errorDescription);
+}
+
+bool LocalStorageManager::importSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                                         ErrorString & errorDescription)
+{
+    Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(importSnapshot);
+    return d->importSnapshot(snapshotFilePath, snapshotInfo, errorDescription);
+}
+
+bool LocalStorageManager::expungeStaleDataItems(const QSet<QString> & syncedNotebookGuids, const QSet<QString> & syncedTagGuids,
+                                                const QSet<QString> & syncedNoteGuids, const QSet<QString> & syncedSavedSearchGuids,
+                                                const QString & linkedNotebookGuid, StaleDataItemsExpungeResult & result,
+                                                ErrorString & errorDescription)
+{
+    Q_D(LocalStorageManager);
+    MEASURE_LOCAL_STORAGE_OPERATION(expungeStaleDataItems);
+    return d->expungeStaleDataItems(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids, syncedSavedSearchGuids,
+                                    linkedNotebookGuid, result, errorDescription);
+}
+
 } // namespace quentier
@@ -20,6 +20,7 @@
 #include <quentier/local_storage/NoteSearchQuery.h>
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/utility/SysInfo.h>
+#include <QTimerEvent>
 
 namespace quentier {
 
@@ -31,11 +32,17 @@ LocalStorageManagerAsync::LocalStorageManagerAsync(const Account & account, cons
     m_overrideLock(overrideLock),
     m_pLocalStorageManager(Q_NULLPTR),
     m_useCache(true),
-    m_pLocalStorageCacheManager(Q_NULLPTR)
+    m_pLocalStorageCacheManager(Q_NULLPTR),
+    m_noteUpdateCoalescingWindowMsec(0),
+    m_pendingNoteUpdatesByLocalUid(),
+    m_pendingNoteUpdateLocalUidsByTimerId()
 {}
 
 LocalStorageManagerAsync::~LocalStorageManagerAsync()
 {
+    // Not losing the note updates which were not written yet
+    flushPendingNoteUpdates();
+
     if (m_pLocalStorageManager) {
         delete m_pLocalStorageManager;
     }
@@ -85,6 +92,23 @@ LocalStorageManager * LocalStorageManagerAsync::localStorageManager()
     return m_pLocalStorageManager;
 }
 
+void LocalStorageManagerAsync::setNoteUpdateCoalescingWindow(const int windowMsec)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerAsync::setNoteUpdateCoalescingWindow: ") << windowMsec
+            << QStringLiteral(" msec"));
+
+    m_noteUpdateCoalescingWindowMsec = windowMsec;
+
+    if (windowMsec <= 0) {
+        flushPendingNoteUpdates();
+    }
+}
+
+int LocalStorageManagerAsync::noteUpdateCoalescingWindow() const
+{
+    return m_noteUpdateCoalescingWindowMsec;
+}
+
 void LocalStorageManagerAsync::init()
 {
     if (m_pLocalStorageManager) {
@@ -127,6 +151,8 @@ void LocalStorageManagerAsync::onGetUserCountRequest(QUuid requestId)
 
 void LocalStorageManagerAsync::onSwitchUserRequest(Account account, bool startFromScratch, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         m_pLocalStorageManager->switchUser(account, startFromScratch);
@@ -600,6 +626,8 @@ void LocalStorageManagerAsync::onListSharedNotebooksPerNotebookGuidRequest(QStri
 
 void LocalStorageManagerAsync::onExpungeNotebookRequest(Notebook notebook, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -846,6 +874,8 @@ void LocalStorageManagerAsync::onExpungeLinkedNotebookRequest(LinkedNotebook lin
 
 void LocalStorageManagerAsync::onGetNoteCountRequest(QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -869,6 +899,8 @@ void LocalStorageManagerAsync::onGetNoteCountRequest(QUuid requestId)
 
 void LocalStorageManagerAsync::onGetNoteCountPerNotebookRequest(Notebook notebook, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -892,6 +924,8 @@ void LocalStorageManagerAsync::onGetNoteCountPerNotebookRequest(Notebook noteboo
 
 void LocalStorageManagerAsync::onGetNoteCountPerTagRequest(Tag tag, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -915,6 +949,8 @@ void LocalStorageManagerAsync::onGetNoteCountPerTagRequest(Tag tag, QUuid reques
 
 void LocalStorageManagerAsync::onGetNoteCountsPerAllTagsRequest(QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -968,13 +1004,100 @@ void LocalStorageManagerAsync::onAddNoteRequest(Note note, QUuid requestId)
 void LocalStorageManagerAsync::onUpdateNoteRequest(Note note, bool updateResources,
                                                    bool updateTags, QUuid requestId)
 {
+    const QString noteLocalUid = note.localUid();
+    if ((m_noteUpdateCoalescingWindowMsec <= 0) || noteLocalUid.isEmpty()) {
+        QList<QUuid> requestIds;
+        requestIds << requestId;
+        updateNoteImpl(note, updateResources, updateTags, requestIds);
+        return;
+    }
+
+    auto it = m_pendingNoteUpdatesByLocalUid.find(noteLocalUid);
+    if ((it != m_pendingNoteUpdatesByLocalUid.end()) &&
+        ((it.value().m_updateResources != updateResources) || (it.value().m_updateTags != updateTags)))
+    {
+        // The updates affecting different parts of the note can't be merged, writing the pending one first
+        flushPendingNoteUpdate(noteLocalUid);
+        it = m_pendingNoteUpdatesByLocalUid.end();
+    }
+
+    if (it == m_pendingNoteUpdatesByLocalUid.end())
+    {
+        PendingNoteUpdate pendingNoteUpdate;
+        pendingNoteUpdate.m_updateResources = updateResources;
+        pendingNoteUpdate.m_updateTags = updateTags;
+
+        // NOTE: the timer is not restarted on subsequent updates so that the note gets written no later than
+        // the end of the window even if the updates keep coming
+        pendingNoteUpdate.m_timerId = startTimer(m_noteUpdateCoalescingWindowMsec);
+        m_pendingNoteUpdateLocalUidsByTimerId[pendingNoteUpdate.m_timerId] = noteLocalUid;
+
+        it = m_pendingNoteUpdatesByLocalUid.insert(noteLocalUid, pendingNoteUpdate);
+    }
+
+    PendingNoteUpdate & pendingNoteUpdate = it.value();
+    pendingNoteUpdate.m_note = note;
+    pendingNoteUpdate.m_requestIds << requestId;
+
+    QNTRACE(QStringLiteral("Coalesced the update of note with local uid ") << noteLocalUid
+            << QStringLiteral(", the number of pending update requests for it = ") << pendingNoteUpdate.m_requestIds.size());
+}
+
+void LocalStorageManagerAsync::onUpdateNotesRequest(QList<Note> notes, bool updateResources,
+                                                    bool updateTags, QUuid requestId)
+{
+    // The coalesced updates of the same notes must not overwrite the batch later
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
 
-        bool res = m_pLocalStorageManager->updateNote(note, updateResources, updateTags, errorDescription);
+        bool res = m_pLocalStorageManager->updateNotes(notes, updateResources, updateTags, errorDescription);
         if (!res) {
-            Q_EMIT updateNoteFailed(note, updateResources, updateTags, errorDescription, requestId);
+            Q_EMIT updateNotesFailed(notes, updateResources, updateTags, errorDescription, requestId);
+            return;
+        }
+
+        if (m_useCache)
+        {
+            for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it)
+            {
+                if (updateResources && updateTags) {
+                    m_pLocalStorageCacheManager->cacheNote(*it);
+                }
+                else {
+                    m_pLocalStorageCacheManager->expungeNote(*it);
+                }
+            }
+        }
+
+        Q_EMIT updateNotesComplete(notes, updateResources, updateTags, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't update notes in the local storage: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT updateNotesFailed(notes, updateResources, updateTags, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::updateNoteImpl(Note & note, const bool updateResources, const bool updateTags,
+                                              const QList<QUuid> & requestIds)
+{
+    try
+    {
+        ErrorString errorDescription;
+
+        bool res = m_pLocalStorageManager->updateNote(note, updateResources, updateTags, errorDescription);
+        if (!res)
+        {
+            for(auto it = requestIds.constBegin(), end = requestIds.constEnd(); it != end; ++it) {
+                Q_EMIT updateNoteFailed(note, updateResources, updateTags, errorDescription, *it);
+            }
+
             return;
         }
 
@@ -990,7 +1113,9 @@ void LocalStorageManagerAsync::onUpdateNoteRequest(Note note, bool updateResourc
             }
         }
 
-        Q_EMIT updateNoteComplete(note, updateResources, updateTags, requestId);
+        for(auto it = requestIds.constBegin(), end = requestIds.constEnd(); it != end; ++it) {
+            Q_EMIT updateNoteComplete(note, updateResources, updateTags, *it);
+        }
     }
     catch(const std::exception & e)
     {
@@ -998,12 +1123,77 @@ void LocalStorageManagerAsync::onUpdateNoteRequest(Note note, bool updateResourc
         error.details() = QString::fromUtf8(e.what());
         SysInfo sysInfo;
         QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
-        Q_EMIT updateNoteFailed(note, updateResources, updateTags, error, requestId);
+
+        for(auto it = requestIds.constBegin(), end = requestIds.constEnd(); it != end; ++it) {
+            Q_EMIT updateNoteFailed(note, updateResources, updateTags, error, *it);
+        }
+    }
+}
+
+void LocalStorageManagerAsync::flushPendingNoteUpdate(const QString & noteLocalUid)
+{
+    auto it = m_pendingNoteUpdatesByLocalUid.find(noteLocalUid);
+    if (it == m_pendingNoteUpdatesByLocalUid.end()) {
+        return;
+    }
+
+    PendingNoteUpdate pendingNoteUpdate = it.value();
+    Q_UNUSED(m_pendingNoteUpdatesByLocalUid.erase(it))
+
+    killTimer(pendingNoteUpdate.m_timerId);
+    Q_UNUSED(m_pendingNoteUpdateLocalUidsByTimerId.remove(pendingNoteUpdate.m_timerId))
+
+    QNDEBUG(QStringLiteral("Writing the coalesced update of note with local uid ") << noteLocalUid
+            << QStringLiteral(", the number of merged update requests = ") << pendingNoteUpdate.m_requestIds.size());
+
+    updateNoteImpl(pendingNoteUpdate.m_note, pendingNoteUpdate.m_updateResources,
+                   pendingNoteUpdate.m_updateTags, pendingNoteUpdate.m_requestIds);
+}
+
+void LocalStorageManagerAsync::flushPendingNoteUpdates()
+{
+    if (m_pendingNoteUpdatesByLocalUid.isEmpty()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("LocalStorageManagerAsync::flushPendingNoteUpdates: ")
+            << m_pendingNoteUpdatesByLocalUid.size() << QStringLiteral(" pending note updates"));
+
+    const QList<QString> noteLocalUids = m_pendingNoteUpdatesByLocalUid.keys();
+    for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it) {
+        flushPendingNoteUpdate(*it);
+    }
+}
+
+void LocalStorageManagerAsync::onFlushPendingNoteUpdatesRequest(QUuid requestId)
+{
+    flushPendingNoteUpdates();
+    Q_EMIT flushPendingNoteUpdatesComplete(requestId);
+}
+
+void LocalStorageManagerAsync::timerEvent(QTimerEvent * pEvent)
+{
+    if (Q_UNLIKELY(!pEvent)) {
+        QNWARNING(QStringLiteral("Detected null pointer to QTimerEvent in LocalStorageManagerAsync"));
+        return;
+    }
+
+    int timerId = pEvent->timerId();
+
+    auto it = m_pendingNoteUpdateLocalUidsByTimerId.find(timerId);
+    if (it == m_pendingNoteUpdateLocalUidsByTimerId.end()) {
+        QObject::timerEvent(pEvent);
+        return;
     }
+
+    QString noteLocalUid = it.value();
+    flushPendingNoteUpdate(noteLocalUid);
 }
 
 void LocalStorageManagerAsync::onFindNoteRequest(Note note, bool withResourceBinaryData, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1054,6 +1244,8 @@ void LocalStorageManagerAsync::onListNotesPerNotebookRequest(Notebook notebook,
                                                              LocalStorageManager::OrderDirection::type orderDirection,
                                                              QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1097,6 +1289,8 @@ void LocalStorageManagerAsync::onListNotesPerTagRequest(Tag tag, bool withResour
                                                         LocalStorageManager::OrderDirection::type orderDirection,
                                                         QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1138,6 +1332,8 @@ void LocalStorageManagerAsync::onListNotesRequest(LocalStorageManager::ListObjec
                                                   LocalStorageManager::OrderDirection::type orderDirection,
                                                   QString linkedNotebookGuid, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1174,6 +1370,8 @@ void LocalStorageManagerAsync::onListNotesRequest(LocalStorageManager::ListObjec
 
 void LocalStorageManagerAsync::onFindNoteLocalUidsWithSearchQuery(NoteSearchQuery noteSearchQuery, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1198,6 +1396,8 @@ void LocalStorageManagerAsync::onFindNoteLocalUidsWithSearchQuery(NoteSearchQuer
 
 void LocalStorageManagerAsync::onExpungeNoteRequest(Note note, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1362,6 +1562,8 @@ void LocalStorageManagerAsync::onListAllTagsPerNoteRequest(Note note, LocalStora
                                                            LocalStorageManager::OrderDirection::type orderDirection,
                                                            QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1469,6 +1671,8 @@ void LocalStorageManagerAsync::onListTagsRequest(LocalStorageManager::ListObject
 
 void LocalStorageManagerAsync::onExpungeTagRequest(Tag tag, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1505,6 +1709,8 @@ void LocalStorageManagerAsync::onExpungeTagRequest(Tag tag, QUuid requestId)
 
 void LocalStorageManagerAsync::onExpungeNotelessTagsFromLinkedNotebooksRequest(QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1528,6 +1734,8 @@ void LocalStorageManagerAsync::onExpungeNotelessTagsFromLinkedNotebooksRequest(Q
 
 void LocalStorageManagerAsync::onGetResourceCountRequest(QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1551,6 +1759,8 @@ void LocalStorageManagerAsync::onGetResourceCountRequest(QUuid requestId)
 
 void LocalStorageManagerAsync::onAddResourceRequest(Resource resource, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1575,6 +1785,8 @@ void LocalStorageManagerAsync::onAddResourceRequest(Resource resource, QUuid req
 
 void LocalStorageManagerAsync::onUpdateResourceRequest(Resource resource, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1599,6 +1811,8 @@ void LocalStorageManagerAsync::onUpdateResourceRequest(Resource resource, QUuid
 
 void LocalStorageManagerAsync::onFindResourceRequest(Resource resource, bool withBinaryData, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1623,6 +1837,8 @@ void LocalStorageManagerAsync::onFindResourceRequest(Resource resource, bool wit
 
 void LocalStorageManagerAsync::onExpungeResourceRequest(Resource resource, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1883,6 +2099,8 @@ void LocalStorageManagerAsync::onExpungeSavedSearchRequest(SavedSearch search, Q
 
 void LocalStorageManagerAsync::onAccountHighUsnRequest(QString linkedNotebookGuid, QUuid requestId)
 {
+    flushPendingNoteUpdates();
+
     try
     {
         ErrorString errorDescription;
@@ -1905,4 +2123,181 @@ void LocalStorageManagerAsync::onAccountHighUsnRequest(QString linkedNotebookGui
     }
 }
 
+void LocalStorageManagerAsync::onListChangesSinceRequest(qint64 sequenceNumber, size_t limit, QUuid requestId)
+{
+    flushPendingNoteUpdates();
+
+    try
+    {
+        ErrorString errorDescription;
+
+        QList<ChangeJournalEntry> entries = m_pLocalStorageManager->listChangesSince(sequenceNumber, errorDescription, limit);
+        if (entries.isEmpty() && !errorDescription.isEmpty()) {
+            Q_EMIT listChangesSinceFailed(sequenceNumber, limit, errorDescription, requestId);
+            return;
+        }
+
+        Q_EMIT listChangesSinceComplete(sequenceNumber, limit, entries, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't list changes from the local storage's change journal: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT listChangesSinceFailed(sequenceNumber, limit, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::onListResourceSyncedDataHashesRequest(QStringList noteLocalUids, QUuid requestId)
+{
+    try
+    {
+        ErrorString errorDescription;
+
+        QHash<QString,QByteArray> dataHashesByResourceLocalUid =
+            m_pLocalStorageManager->listResourceSyncedDataHashes(noteLocalUids, errorDescription);
+        if (dataHashesByResourceLocalUid.isEmpty() && !errorDescription.isEmpty()) {
+            Q_EMIT listResourceSyncedDataHashesFailed(noteLocalUids, errorDescription, requestId);
+            return;
+        }
+
+        Q_EMIT listResourceSyncedDataHashesComplete(noteLocalUids, dataHashesByResourceLocalUid, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't list the synchronized data hashes of resources from the local storage: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT listResourceSyncedDataHashesFailed(noteLocalUids, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::onLocalStorageStatisticsRequest(bool reset, QUuid requestId)
+{
+    try
+    {
+        LocalStorageStatistics statistics = m_pLocalStorageManager->statistics();
+        if (reset) {
+            m_pLocalStorageManager->resetStatistics();
+        }
+
+        Q_EMIT localStorageStatisticsComplete(statistics, reset, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't get the local storage statistics: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT localStorageStatisticsFailed(reset, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::onExportSnapshotRequest(QString snapshotFilePath, QUuid requestId)
+{
+    flushPendingNoteUpdates();
+
+    try
+    {
+        ErrorString errorDescription;
+        LocalStorageSnapshotInfo snapshotInfo;
+
+        bool res = m_pLocalStorageManager->exportSnapshot(snapshotFilePath, snapshotInfo, errorDescription);
+        if (!res) {
+            Q_EMIT exportSnapshotFailed(snapshotFilePath, errorDescription, requestId);
+            return;
+        }
+
+        Q_EMIT exportSnapshotComplete(snapshotFilePath, snapshotInfo, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't export the snapshot of the local storage: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT exportSnapshotFailed(snapshotFilePath, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::onImportSnapshotRequest(QString snapshotFilePath, QUuid requestId)
+{
+    flushPendingNoteUpdates();
+
+    try
+    {
+        ErrorString errorDescription;
+        LocalStorageSnapshotInfo snapshotInfo;
+
+        bool res = m_pLocalStorageManager->importSnapshot(snapshotFilePath, snapshotInfo, errorDescription);
+
+        if (m_useCache) {
+            m_pLocalStorageCacheManager->clear();
+        }
+
+        if (!res) {
+            Q_EMIT importSnapshotFailed(snapshotFilePath, errorDescription, requestId);
+            return;
+        }
+
+        Q_EMIT importSnapshotComplete(snapshotFilePath, snapshotInfo, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't import the snapshot of the local storage: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT importSnapshotFailed(snapshotFilePath, error, requestId);
+    }
+}
+
+void LocalStorageManagerAsync::onExpungeStaleDataItemsRequest(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                                              QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                                              QString linkedNotebookGuid, QUuid requestId)
+{
+    flushPendingNoteUpdates();
+
+    try
+    {
+        ErrorString errorDescription;
+        StaleDataItemsExpungeResult result;
+
+        bool res = m_pLocalStorageManager->expungeStaleDataItems(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids,
+                                                                 syncedSavedSearchGuids, linkedNotebookGuid, result,
+                                                                 errorDescription);
+        if (!res) {
+            Q_EMIT expungeStaleDataItemsFailed(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids, syncedSavedSearchGuids,
+                                               linkedNotebookGuid, errorDescription, requestId);
+            return;
+        }
+
+        if (m_useCache && !result.isEmpty()) {
+            m_pLocalStorageCacheManager->clear();
+        }
+
+        Q_EMIT expungeStaleDataItemsComplete(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids, syncedSavedSearchGuids,
+                                             linkedNotebookGuid, result, requestId);
+    }
+    catch(const std::exception & e)
+    {
+        ErrorString error(QT_TR_NOOP("Can't expunge stale data items from the local storage: caught exception"));
+        error.details() = QString::fromUtf8(e.what());
+        SysInfo sysInfo;
+        QNERROR(error << QStringLiteral("; backtrace: ") << sysInfo.stackTrace());
+        Q_EMIT expungeStaleDataItemsFailed(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids, syncedSavedSearchGuids,
+                                           linkedNotebookGuid, error, requestId);
+    }
+}
+
+LocalStorageManagerAsync::PendingNoteUpdate::PendingNoteUpdate() :
+    m_note(),
+    m_updateResources(false),
+    m_updateTags(false),
+    m_requestIds(),
+    m_timerId(0)
+{}
+
 } // namespace quentier
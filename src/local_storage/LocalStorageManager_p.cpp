@@ -31,11 +31,20 @@
 #include <quentier/utility/UidGenerator.h>
 #include <quentier/types/ResourceRecognitionIndices.h>
 #include <QBuffer>
+#include <QElapsedTimer>
 #include <algorithm>
 
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace quentier {
 
 #define QUENTIER_DATABASE_NAME "qn.storage.sqlite"
+#define SNAPSHOT_IMPORT_FILE_SUFFIX ".import"
+#define SNAPSHOT_IMPORT_BACKUP_FILE_SUFFIX ".backup"
 
 LocalStorageManagerPrivate::LocalStorageManagerPrivate(const Account & account, const bool startFromScratch, const bool overrideLock) :
     QObject(),
@@ -122,8 +131,13 @@ LocalStorageManagerPrivate::LocalStorageManagerPrivate(const Account & account,
     m_insertOrReplaceUserAttributesRecentMailedAddressesQueryPrepared(false),
     m_deleteUserQuery(),
     m_deleteUserQueryPrepared(false),
+    m_insertChangeJournalEntryQuery(),
+    m_insertChangeJournalEntryQueryPrepared(false),
+    m_insertOrReplaceResourceSyncedDataHashQuery(),
+    m_insertOrReplaceResourceSyncedDataHashQueryPrepared(false),
     m_stringUtils(),
-    m_preservedAsterisk()
+    m_preservedAsterisk(),
+    m_statisticsCollector()
 {
     m_preservedAsterisk.reserve(1);
     m_preservedAsterisk.push_back(QChar::fromLatin1('*'));
@@ -259,7 +273,7 @@ bool LocalStorageManagerPrivate::findUser(User & user, ErrorString & errorDescri
 
     query.bindValue(QStringLiteral(":id"), userId);
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     size_t counter = 0;
@@ -306,7 +320,7 @@ bool LocalStorageManagerPrivate::deleteUser(const User & user, ErrorString & err
     query.bindValue(QStringLiteral(":userIsLocal"), (user.isLocal() ? 1 : 0));
     query.bindValue(QStringLiteral(":id"), user.id());
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -332,7 +346,7 @@ bool LocalStorageManagerPrivate::expungeUser(const User & user, ErrorString & er
     QString userId = QString::number(id);
     query.bindValue(QStringLiteral(":id"), userId);
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -364,7 +378,7 @@ int LocalStorageManagerPrivate::notebookCount(ErrorString & errorDescription) co
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -459,6 +473,22 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
         }
     }
 
+    // If the snapshot import was interrupted after the database file was moved aside as a backup
+    // but before the imported snapshot took its place, restore the backup
+    QString backupDatabaseFilePath = m_databaseFilePath + QStringLiteral(SNAPSHOT_IMPORT_BACKUP_FILE_SUFFIX);
+    if (!databaseFileInfo.exists() && QFile::exists(backupDatabaseFilePath))
+    {
+        QNINFO(QStringLiteral("Found the backup of the local storage database file left from the interrupted snapshot import, "
+                              "restoring it: ") << backupDatabaseFilePath);
+        if (!moveDatabaseFileWithAuxiliaryFiles(backupDatabaseFilePath, m_databaseFilePath)) {
+            ErrorString error(QT_TR_NOOP("Can't restore the local storage database file from the backup"));
+            error.details() = backupDatabaseFilePath;
+            throw DatabaseOpeningException(error);
+        }
+
+        databaseFileInfo.refresh();
+    }
+
     if (databaseFileInfo.exists())
     {
         if (Q_UNLIKELY(!databaseFileInfo.isReadable())) {
@@ -527,6 +557,17 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
         clearDatabaseFile();
     }
 
+    openDatabase();
+
+    // TODO: in future should check whether the upgrade from previous database version is necessary
+}
+
+void LocalStorageManagerPrivate::openDatabase()
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::openDatabase: ") << m_databaseFilePath);
+
+    QString accountName = m_currentAccount.name();
+
     m_sqlDatabase.setHostName(QStringLiteral("localhost"));
     m_sqlDatabase.setUserName(accountName);
     m_sqlDatabase.setPassword(accountName);
@@ -540,7 +581,7 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
     }
 
     QSqlQuery query(m_sqlDatabase);
-    if (!query.exec(QStringLiteral("PRAGMA foreign_keys = ON"))) {
+    if (!execQuery(query, QStringLiteral("PRAGMA foreign_keys = ON"))) {
         QString lastErrorText = m_sqlDatabase.lastError().text();
         ErrorString error(QT_TR_NOOP("Can't set foreign_keys = ON pragma for the local storage database"));
         error.details() = lastErrorText;
@@ -550,7 +591,7 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
     SysInfo sysInfo;
     qint64 pageSize = sysInfo.pageSize();
     QString pageSizeQuery = QString::fromUtf8("PRAGMA page_size = %1").arg(QString::number(pageSize));
-    if (!query.exec(pageSizeQuery)) {
+    if (!execQuery(query, pageSizeQuery)) {
         QString lastErrorText = m_sqlDatabase.lastError().text();
         ErrorString error(QT_TR_NOOP("Can't set page_size pragma for the local storage database"));
         error.details() = lastErrorText;
@@ -558,7 +599,7 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
     }
 
     QString writeAheadLoggingQuery = QStringLiteral("PRAGMA journal_mode=WAL");
-    if (!query.exec(writeAheadLoggingQuery)) {
+    if (!execQuery(query, writeAheadLoggingQuery)) {
         QString lastErrorText = m_sqlDatabase.lastError().text();
         ErrorString error(QT_TR_NOOP("Can't set journal_mode pragma to WAL for the local storage database"));
         error.details() = lastErrorText;
@@ -575,8 +616,6 @@ void LocalStorageManagerPrivate::switchUser(const Account & account,
     }
 
     clearCachedQueries();
-
-    // TODO: in future should check whether the upgrade from previous database version is necessary
 }
 
 int LocalStorageManagerPrivate::userCount(ErrorString & errorDescription) const
@@ -590,7 +629,7 @@ int LocalStorageManagerPrivate::userCount(ErrorString & errorDescription) const
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -680,7 +719,7 @@ bool LocalStorageManagerPrivate::addNotebook(Notebook & notebook, ErrorString &
     }
 
     error.clear();
-    res = insertOrReplaceNotebook(notebook, error);
+    res = insertOrReplaceNotebook(notebook, ChangeJournalEntry::ChangeType::Add, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -773,7 +812,7 @@ bool LocalStorageManagerPrivate::updateNotebook(Notebook & notebook, ErrorString
     }
 
     error.clear();
-    res = insertOrReplaceNotebook(notebook, error);
+    res = insertOrReplaceNotebook(notebook, ChangeJournalEntry::ChangeType::Update, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -865,7 +904,7 @@ bool LocalStorageManagerPrivate::findNotebook(Notebook & notebook, ErrorString &
     Notebook result;
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     size_t counter = 0;
@@ -901,17 +940,17 @@ bool LocalStorageManagerPrivate::findDefaultNotebook(Notebook & notebook, ErrorS
     ErrorString errorPrefix(QT_TR_NOOP("Can't find the default notebook in the local storage database"));
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(QStringLiteral("SELECT * FROM Notebooks LEFT OUTER JOIN NotebookRestrictions "
-                                         "ON Notebooks.localUid = NotebookRestrictions.localUid "
-                                         "LEFT OUTER JOIN SharedNotebooks ON Notebooks.guid = SharedNotebooks.sharedNotebookNotebookGuid "
-                                         "LEFT OUTER JOIN Users ON Notebooks.contactId = Users.id "
-                                         "LEFT OUTER JOIN UserAttributes ON Notebooks.contactId = UserAttributes.id "
-                                         "LEFT OUTER JOIN UserAttributesViewedPromotions ON Notebooks.contactId = UserAttributesViewedPromotions.id "
-                                         "LEFT OUTER JOIN UserAttributesRecentMailedAddresses ON Notebooks.contactId = UserAttributesRecentMailedAddresses.id "
-                                         "LEFT OUTER JOIN Accounting ON Notebooks.contactId = Accounting.id "
-                                         "LEFT OUTER JOIN AccountLimits ON Notebooks.contactId = AccountLimits.id "
-                                         "LEFT OUTER JOIN BusinessUserInfo ON Notebooks.contactId = BusinessUserInfo.id "
-                                         "WHERE isDefault = 1 LIMIT 1"));
+    bool res = execQuery(query, QStringLiteral("SELECT * FROM Notebooks LEFT OUTER JOIN NotebookRestrictions "
+                                               "ON Notebooks.localUid = NotebookRestrictions.localUid "
+                                               "LEFT OUTER JOIN SharedNotebooks ON Notebooks.guid = SharedNotebooks.sharedNotebookNotebookGuid "
+                                               "LEFT OUTER JOIN Users ON Notebooks.contactId = Users.id "
+                                               "LEFT OUTER JOIN UserAttributes ON Notebooks.contactId = UserAttributes.id "
+                                               "LEFT OUTER JOIN UserAttributesViewedPromotions ON Notebooks.contactId = UserAttributesViewedPromotions.id "
+                                               "LEFT OUTER JOIN UserAttributesRecentMailedAddresses ON Notebooks.contactId = UserAttributesRecentMailedAddresses.id "
+                                               "LEFT OUTER JOIN Accounting ON Notebooks.contactId = Accounting.id "
+                                               "LEFT OUTER JOIN AccountLimits ON Notebooks.contactId = AccountLimits.id "
+                                               "LEFT OUTER JOIN BusinessUserInfo ON Notebooks.contactId = BusinessUserInfo.id "
+                                               "WHERE isDefault = 1 LIMIT 1"));
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -944,17 +983,17 @@ bool LocalStorageManagerPrivate::findLastUsedNotebook(Notebook & notebook, Error
     ErrorString errorPrefix(QT_TR_NOOP("Can't find the last used notebook in the local storage database"));
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(QStringLiteral("SELECT * FROM Notebooks LEFT OUTER JOIN NotebookRestrictions "
-                                         "ON Notebooks.localUid = NotebookRestrictions.localUid "
-                                         "LEFT OUTER JOIN SharedNotebooks ON Notebooks.guid = SharedNotebooks.sharedNotebookNotebookGuid "
-                                         "LEFT OUTER JOIN Users ON Notebooks.contactId = Users.id "
-                                         "LEFT OUTER JOIN UserAttributes ON Notebooks.contactId = UserAttributes.id "
-                                         "LEFT OUTER JOIN UserAttributesViewedPromotions ON Notebooks.contactId = UserAttributesViewedPromotions.id "
-                                         "LEFT OUTER JOIN UserAttributesRecentMailedAddresses ON Notebooks.contactId = UserAttributesRecentMailedAddresses.id "
-                                         "LEFT OUTER JOIN Accounting ON Notebooks.contactId = Accounting.id "
-                                         "LEFT OUTER JOIN AccountLimits ON Notebooks.contactId = AccountLimits.id "
-                                         "LEFT OUTER JOIN BusinessUserInfo ON Notebooks.contactId = BusinessUserInfo.id "
-                                         "WHERE isLastUsed = 1 LIMIT 1"));
+    bool res = execQuery(query, QStringLiteral("SELECT * FROM Notebooks LEFT OUTER JOIN NotebookRestrictions "
+                                               "ON Notebooks.localUid = NotebookRestrictions.localUid "
+                                               "LEFT OUTER JOIN SharedNotebooks ON Notebooks.guid = SharedNotebooks.sharedNotebookNotebookGuid "
+                                               "LEFT OUTER JOIN Users ON Notebooks.contactId = Users.id "
+                                               "LEFT OUTER JOIN UserAttributes ON Notebooks.contactId = UserAttributes.id "
+                                               "LEFT OUTER JOIN UserAttributesViewedPromotions ON Notebooks.contactId = UserAttributesViewedPromotions.id "
+                                               "LEFT OUTER JOIN UserAttributesRecentMailedAddresses ON Notebooks.contactId = UserAttributesRecentMailedAddresses.id "
+                                               "LEFT OUTER JOIN Accounting ON Notebooks.contactId = Accounting.id "
+                                               "LEFT OUTER JOIN AccountLimits ON Notebooks.contactId = AccountLimits.id "
+                                               "LEFT OUTER JOIN BusinessUserInfo ON Notebooks.contactId = BusinessUserInfo.id "
+                                               "WHERE isLastUsed = 1 LIMIT 1"));
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -1035,7 +1074,7 @@ QList<SharedNotebook> LocalStorageManagerPrivate::listAllSharedNotebooks(ErrorSt
     ErrorString errorPrefix(QT_TR_NOOP("Can't list all shared notebooks"));
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(QStringLiteral("SELECT * FROM SharedNotebooks"));
+    bool res = execQuery(query, QStringLiteral("SELECT * FROM SharedNotebooks"));
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         QNERROR(errorDescription << QStringLiteral("last error = ") << query.lastError()
@@ -1118,7 +1157,7 @@ QList<qevercloud::SharedNotebook> LocalStorageManagerPrivate::listEnSharedNotebo
     query.prepare(QStringLiteral("SELECT * FROM SharedNotebooks WHERE sharedNotebookNotebookGuid=?"));
     query.addBindValue(notebookGuid);
 
-    bool res = query.exec();
+    bool res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return qecSharedNotebooks;
@@ -1226,7 +1265,7 @@ bool LocalStorageManagerPrivate::expungeNotebook(Notebook & notebook, ErrorStrin
 
     QString queryString = QString::fromUtf8("DELETE FROM Notebooks WHERE %1 = '%2'").arg(column,uid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -1243,7 +1282,7 @@ int LocalStorageManagerPrivate::linkedNotebookCount(ErrorString & errorDescripti
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -1292,7 +1331,7 @@ bool LocalStorageManagerPrivate::addLinkedNotebook(const LinkedNotebook & linked
     }
 
     error.clear();
-    res = insertOrReplaceLinkedNotebook(linkedNotebook, error);
+    res = insertOrReplaceLinkedNotebook(linkedNotebook, ChangeJournalEntry::ChangeType::Add, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -1334,7 +1373,7 @@ bool LocalStorageManagerPrivate::updateLinkedNotebook(const LinkedNotebook & lin
     }
 
     error.clear();
-    res = insertOrReplaceLinkedNotebook(linkedNotebook, error);
+    res = insertOrReplaceLinkedNotebook(linkedNotebook, ChangeJournalEntry::ChangeType::Update, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -1376,7 +1415,7 @@ bool LocalStorageManagerPrivate::findLinkedNotebook(LinkedNotebook & linkedNoteb
                                  "FROM LinkedNotebooks WHERE guid = ?"));
     query.addBindValue(notebookGuid);
 
-    bool res = query.exec();
+    bool res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -1454,7 +1493,7 @@ bool LocalStorageManagerPrivate::expungeLinkedNotebook(const LinkedNotebook & li
 
     QString queryString = QString::fromUtf8("DELETE FROM LinkedNotebooks WHERE guid='%1'").arg(linkedNotebookGuid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -1471,7 +1510,7 @@ int LocalStorageManagerPrivate::noteCount(ErrorString & errorDescription) const
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -1522,7 +1561,7 @@ int LocalStorageManagerPrivate::noteCountPerNotebook(const Notebook & notebook,
 
     QString queryString = QString::fromUtf8("SELECT COUNT(*) FROM Notes WHERE deletionTimestamp IS NULL AND %1 = '%2'").arg(column, value);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
 
     if (!res) {
         SET_ERROR();
@@ -1574,7 +1613,7 @@ int LocalStorageManagerPrivate::noteCountPerTag(const Tag & tag, ErrorString & e
     QString queryString = QString::fromUtf8("SELECT COUNT(*) FROM Notes WHERE deletionTimestamp IS NULL AND (localUid IN"
                                             "(SELECT DISTINCT localNote FROM NoteTags WHERE %1 = '%2'))").arg(column,value);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -1604,7 +1643,7 @@ bool LocalStorageManagerPrivate::noteCountsPerAllTags(QHash<QString, int> & note
                                          "ON NoteTags.localNote = Notes.localUid WHERE Notes.deletionTimestamp IS NULL "
                                          "GROUP BY localTag");
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     if (!res) {
         SET_ERROR();
         return false;
@@ -1770,7 +1809,8 @@ bool LocalStorageManagerPrivate::addNote(Note & note, ErrorString & errorDescrip
         return false;
     }
 
-    res = insertOrReplaceNote(note, /* update resources = */ true, /* update tags = */ true, errorDescription);
+    res = insertOrReplaceNote(note, /* update resources = */ true, /* update tags = */ true,
+                              ChangeJournalEntry::ChangeType::Add, errorDescription);
     if (!res) {
         QNWARNING(QStringLiteral("Note which produced the error: ") << note);
     }
@@ -1779,7 +1819,7 @@ bool LocalStorageManagerPrivate::addNote(Note & note, ErrorString & errorDescrip
 }
 
 bool LocalStorageManagerPrivate::updateNote(Note & note, const bool updateResources, const bool updateTags,
-                                            ErrorString & errorDescription)
+                                            ErrorString & errorDescription, const bool useSeparateTransaction)
 {
     ErrorString errorPrefix(QT_TR_NOOP("Can't update note in the local storage database"));
 
@@ -1901,7 +1941,8 @@ bool LocalStorageManagerPrivate::updateNote(Note & note, const bool updateResour
         }
     }
 
-    res = insertOrReplaceNote(note, updateResources, updateTags, errorDescription);
+    res = insertOrReplaceNote(note, updateResources, updateTags, ChangeJournalEntry::ChangeType::Update, errorDescription,
+                              useSeparateTransaction);
     if (!res) {
         QNWARNING(QStringLiteral("Note which produced the error: ") << note);
     }
@@ -1909,6 +1950,25 @@ bool LocalStorageManagerPrivate::updateNote(Note & note, const bool updateResour
     return res;
 }
 
+bool LocalStorageManagerPrivate::updateNotes(QList<Note> & notes, const bool updateResources, const bool updateTags,
+                                             ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::updateNotes: ") << notes.size() << QStringLiteral(" notes"));
+
+    // NOTE: writing all the notes within the same transaction means a single commit for all of them instead of one per note
+    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+
+    for(auto it = notes.begin(), end = notes.end(); it != end; ++it)
+    {
+        bool res = updateNote(*it, updateResources, updateTags, errorDescription, /* use separate transaction = */ false);
+        if (!res) {
+            return false;
+        }
+    }
+
+    return transaction.commit(errorDescription);
+}
+
 bool LocalStorageManagerPrivate::findNote(Note & note, ErrorString & errorDescription,
                                           const bool withResourceBinaryData) const
 {
@@ -1962,7 +2022,7 @@ bool LocalStorageManagerPrivate::findNote(Note & note, ErrorString & errorDescri
                                             "LEFT OUTER JOIN NoteTags ON Notes.localUid = NoteTags.localNote "
                                             "WHERE %3 = '%4'").arg(resourcesTable,resourceIndexColumn,column,uid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     Note result;
@@ -2492,7 +2552,7 @@ bool LocalStorageManagerPrivate::expungeNote(Note & note, ErrorString & errorDes
 
     QString queryString = QString::fromUtf8("DELETE FROM Notes WHERE %1 = '%2'").arg(column, uid);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -2528,7 +2588,7 @@ QStringList LocalStorageManagerPrivate::findNoteLocalUidsWithSearchQuery(const N
     }
 
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     if (!res) {
         SET_ERROR();
         QNWARNING(QStringLiteral("Full executed SQL query: ") << queryString);
@@ -2590,7 +2650,7 @@ NoteList LocalStorageManagerPrivate::findNotesWithSearchQuery(const NoteSearchQu
 
     QString queryString = QString::fromUtf8("SELECT * FROM Notes WHERE localUid IN (%1)").arg(joinedLocalUids);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     if (Q_UNLIKELY(!res)) {
         SET_ERROR();
         return NoteList();
@@ -2672,7 +2732,7 @@ int LocalStorageManagerPrivate::tagCount(ErrorString & errorDescription) const
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -2767,7 +2827,7 @@ bool LocalStorageManagerPrivate::addTag(Tag & tag, ErrorString & errorDescriptio
     }
 
     error.clear();
-    res = insertOrReplaceTag(tag, error);
+    res = insertOrReplaceTag(tag, ChangeJournalEntry::ChangeType::Add, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -2864,7 +2924,7 @@ bool LocalStorageManagerPrivate::updateTag(Tag & tag, ErrorString & errorDescrip
     }
 
     error.clear();
-    res = insertOrReplaceTag(tag, error);
+    res = insertOrReplaceTag(tag, ChangeJournalEntry::ChangeType::Update, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -2941,7 +3001,7 @@ bool LocalStorageManagerPrivate::findTag(Tag & tag, ErrorString & errorDescripti
     }
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -3008,7 +3068,7 @@ QList<Tag> LocalStorageManagerPrivate::listAllTagsPerNote(const Note & note, Err
 
     QString queryString = QString::fromUtf8("SELECT localTag FROM NoteTags WHERE %1 = '%2'").arg(column,uid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     if (!res) {
         SET_ERROR();
         return tags;
@@ -3156,7 +3216,7 @@ bool LocalStorageManagerPrivate::expungeTag(Tag & tag, QStringList & expungedChi
     QSqlQuery query(m_sqlDatabase);
 
     QString findChildTagsQueryString = QString::fromUtf8("SELECT localUid FROM Tags WHERE %1='%2'").arg(parentColumn, uid);
-    bool res = query.exec(findChildTagsQueryString);
+    bool res = execQuery(query, findChildTagsQueryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     while(query.next())
@@ -3186,11 +3246,11 @@ bool LocalStorageManagerPrivate::expungeTag(Tag & tag, QStringList & expungedChi
 
     // Removing child tags
     QString queryString = QString::fromUtf8("DELETE FROM Tags WHERE %1='%2'").arg(parentColumn,uid);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     queryString = QString::fromUtf8("DELETE FROM Tags WHERE %1='%2'").arg(column,uid);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -3203,7 +3263,7 @@ bool LocalStorageManagerPrivate::expungeNotelessTagsFromLinkedNotebooks(ErrorStr
     QString queryString = QStringLiteral("DELETE FROM Tags WHERE ((linkedNotebookGuid IS NOT NULL) AND "
                                          "(localUid NOT IN (SELECT localTag FROM NoteTags)))");
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -3220,7 +3280,7 @@ int LocalStorageManagerPrivate::enResourceCount(ErrorString & errorDescription)
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -3287,7 +3347,7 @@ bool LocalStorageManagerPrivate::findEnResource(Resource & resource, ErrorString
                                             "WHERE %1.%2 = '%3'").arg(resourcesTable,column,uid);
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     Resource foundResource(resource);
@@ -3396,7 +3456,7 @@ bool LocalStorageManagerPrivate::expungeEnResource(Resource & resource, ErrorStr
 
     QString queryString = QString::fromUtf8("DELETE FROM Resources WHERE %1 = '%2'").arg(column,uid);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -3413,7 +3473,7 @@ int LocalStorageManagerPrivate::savedSearchCount(ErrorString & errorDescription)
         return -1;
     }
 
-    res = query.exec();
+    res = execQuery(query);
     if (!res) {
         SET_ERROR();
         return -1;
@@ -3497,7 +3557,7 @@ bool LocalStorageManagerPrivate::addSavedSearch(SavedSearch & search, ErrorStrin
     }
 
     error.clear();
-    res = insertOrReplaceSavedSearch(search, error);
+    res = insertOrReplaceSavedSearch(search, ChangeJournalEntry::ChangeType::Add, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -3586,7 +3646,7 @@ bool LocalStorageManagerPrivate::updateSavedSearch(SavedSearch & search, ErrorSt
     }
 
     error.clear();
-    res = insertOrReplaceSavedSearch(search, error);
+    res = insertOrReplaceSavedSearch(search, ChangeJournalEntry::ChangeType::Update, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -3643,7 +3703,7 @@ bool LocalStorageManagerPrivate::findSavedSearch(SavedSearch & search, ErrorStri
                                             "includeAccount, includePersonalLinkedNotebooks, includeBusinessLinkedNotebooks, "
                                             "isFavorited FROM SavedSearches WHERE %1 = '%2'").arg(column,value);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -3753,7 +3813,7 @@ bool LocalStorageManagerPrivate::expungeSavedSearch(SavedSearch & search, ErrorS
 
     QString queryString = QString::fromUtf8("DELETE FROM SavedSearches WHERE %1='%2'").arg(column,uid);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -3763,79 +3823,1127 @@ qint32 LocalStorageManagerPrivate::accountHighUsn(const QString & linkedNotebook
 {
     QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::accountHighUsn: linked notebook guid = ") << linkedNotebookGuid);
 
-    qint32 updateSequenceNumber = 0;
+    qint32 updateSequenceNumber = 0;
+
+    QVector<HighUsnRequestData> tablesAndUsnColumns;
+    if (linkedNotebookGuid.isEmpty()) {
+        tablesAndUsnColumns.reserve(6);
+    }
+    else {
+        tablesAndUsnColumns.reserve(4);
+    }
+
+    QString queryCondition = QStringLiteral("WHERE linkedNotebookGuid");
+    if (linkedNotebookGuid.isEmpty()) {
+        queryCondition += QStringLiteral(" IS NULL");
+    }
+    else {
+        queryCondition += QString::fromUtf8("='%1'").arg(sqlEscapeString(linkedNotebookGuid));
+    }
+
+#define ADD_TABLE_AND_USN_COLUMN(tableName, usnColumnName) \
+    tablesAndUsnColumns << HighUsnRequestData(tableName, usnColumnName, queryCondition)
+
+    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Notebooks"), QStringLiteral("updateSequenceNumber"));
+    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Tags"), QStringLiteral("updateSequenceNumber"));
+
+    // Separate query condition is required for notes table
+    queryCondition = QStringLiteral("WHERE notebookLocalUid IN (SELECT DISTINCT localUid FROM Notebooks WHERE linkedNotebookGuid");
+    if (linkedNotebookGuid.isEmpty()) {
+        queryCondition += QStringLiteral(" IS NULL)");
+    }
+    else {
+        queryCondition += QString::fromUtf8("='%1')").arg(sqlEscapeString(linkedNotebookGuid));
+    }
+    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Notes"), QStringLiteral("updateSequenceNumber"));
+
+    // Separate query condition is required for resources table
+    queryCondition = QStringLiteral("WHERE noteLocalUid IN (SELECT DISTINCT localUid FROM Notes WHERE notebookLocalUid IN ");
+    queryCondition += QStringLiteral("(SELECT DISTINCT localUid FROM Notebooks WHERE linkedNotebookGuid");
+    if (linkedNotebookGuid.isEmpty()) {
+        queryCondition += QStringLiteral(" IS NULL))");
+    }
+    else {
+        queryCondition += QString::fromUtf8("='%1'))").arg(sqlEscapeString(linkedNotebookGuid));
+    }
+    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Resources"), QStringLiteral("resourceUpdateSequenceNumber"));
+
+    // No query condition is required for linked notebooks and saved searches tables + only need to consider them
+    // for highest USN from user's own account, not from some linked notebook
+    if (linkedNotebookGuid.isEmpty()) {
+        queryCondition.clear();
+        ADD_TABLE_AND_USN_COLUMN(QStringLiteral("LinkedNotebooks"), QStringLiteral("updateSequenceNumber"));
+        ADD_TABLE_AND_USN_COLUMN(QStringLiteral("SavedSearches"), QStringLiteral("updateSequenceNumber"));
+    }
+
+#undef ADD_TABLE_AND_USN_COLUMN
+
+    for(auto it = tablesAndUsnColumns.constBegin(), end = tablesAndUsnColumns.constEnd(); it != end; ++it)
+    {
+        qint32 usn = 0;
+        bool res = updateSequenceNumberFromTable(it->m_tableName, it->m_usnColumnName,
+                                                 it->m_queryCondition, usn, errorDescription);
+        if (!res) {
+            return -1;
+        }
+
+        updateSequenceNumber = std::max(updateSequenceNumber, usn);
+
+        QNTRACE(QStringLiteral("Max update sequence number from table ") << it->m_tableName
+                << QStringLiteral(": ") << usn << QStringLiteral(", overall max USN so far: ")
+                << updateSequenceNumber);
+    }
+
+    QNDEBUG(QStringLiteral("Max USN = ") << updateSequenceNumber);
+    return updateSequenceNumber;
+}
+
+QList<ChangeJournalEntry> LocalStorageManagerPrivate::listChangesSince(const qint64 sequenceNumber,
+                                                                      ErrorString & errorDescription,
+                                                                      const size_t limit) const
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::listChangesSince: sequence number = ") << sequenceNumber
+            << QStringLiteral(", limit = ") << limit);
+
+    QList<ChangeJournalEntry> entries;
+    ErrorString errorPrefix(QT_TR_NOOP("can't list the changes from the local storage's change journal"));
+
+    QString queryString = QString::fromUtf8("SELECT sequenceNumber, entityType, changeType, localUid, changedFields, timestamp "
+                                            "FROM ChangeJournal WHERE sequenceNumber > %1 ORDER BY sequenceNumber ASC")
+                                            .arg(sequenceNumber);
+    if (limit > 0) {
+        queryString += QString::fromUtf8(" LIMIT %1").arg(QString::number(limit));
+    }
+
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, queryString);
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.details() = query.lastError().text();
+        QNERROR(errorDescription << QStringLiteral(", last executed query: ") << lastExecutedQuery(query));
+        return entries;
+    }
+
+    while(query.next())
+    {
+        entries << ChangeJournalEntry();
+        ChangeJournalEntry & entry = entries.back();
+
+        entry.sequenceNumber = query.value(0).toLongLong();
+        entry.entityType = static_cast<ChangeJournalEntry::EntityType::type>(query.value(1).toInt());
+        entry.changeType = static_cast<ChangeJournalEntry::ChangeType::type>(query.value(2).toInt());
+        entry.localUid = query.value(3).toString();
+
+        QString changedFields = query.value(4).toString();
+        if (!changedFields.isEmpty()) {
+            entry.changedFields = changedFields.split(QChar::fromLatin1(','), QString::SkipEmptyParts);
+        }
+
+        entry.timestamp = query.value(5).toLongLong();
+    }
+
+    QNDEBUG(QStringLiteral("Found ") << entries.size() << QStringLiteral(" change journal entries"));
+    return entries;
+}
+
+qint64 LocalStorageManagerPrivate::lastChangeSequenceNumber(ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::lastChangeSequenceNumber"));
+
+    ErrorString errorPrefix(QT_TR_NOOP("can't get the last sequence number from the local storage's change journal"));
+
+    // NOTE: sqlite_sequence keeps the largest sequence number ever used even if the corresponding entries
+    // have already been trimmed from the journal
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, QStringLiteral("SELECT seq FROM sqlite_sequence WHERE name='ChangeJournal'"));
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.details() = query.lastError().text();
+        QNERROR(errorDescription << QStringLiteral(", last executed query: ") << lastExecutedQuery(query));
+        return -1;
+    }
+
+    if (!query.next()) {
+        QNDEBUG(QStringLiteral("No changes were recorded in the change journal yet"));
+        return 0;
+    }
+
+    bool conversionResult = false;
+    qint64 sequenceNumber = query.value(0).toLongLong(&conversionResult);
+    if (!conversionResult) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("can't convert the sequence number to integer"));
+        QNERROR(errorDescription << QStringLiteral(": ") << query.value(0));
+        return -1;
+    }
+
+    QNDEBUG(QStringLiteral("Last change sequence number = ") << sequenceNumber);
+    return sequenceNumber;
+}
+
+bool LocalStorageManagerPrivate::trimChangeJournal(const qint64 upToSequenceNumber, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::trimChangeJournal: up to sequence number = ") << upToSequenceNumber);
+
+    ErrorString errorPrefix(QT_TR_NOOP("can't trim the local storage's change journal"));
+
+    QString queryString = QString::fromUtf8("DELETE FROM ChangeJournal WHERE sequenceNumber <= %1").arg(upToSequenceNumber);
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, queryString);
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    return true;
+}
+
+QHash<QString,QByteArray> LocalStorageManagerPrivate::listResourceSyncedDataHashes(const QStringList & noteLocalUids,
+                                                                                  ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::listResourceSyncedDataHashes: ") << noteLocalUids.size()
+            << QStringLiteral(" note local uids"));
+
+    QHash<QString,QByteArray> dataHashesByResourceLocalUid;
+    if (noteLocalUids.isEmpty()) {
+        return dataHashesByResourceLocalUid;
+    }
+
+    ErrorString errorPrefix(QT_TR_NOOP("can't list the synchronized data hashes of resources from the local storage"));
+
+    QString noteLocalUidsList;
+    for(auto it = noteLocalUids.constBegin(), end = noteLocalUids.constEnd(); it != end; ++it)
+    {
+        if (!noteLocalUidsList.isEmpty()) {
+            noteLocalUidsList += QStringLiteral(", ");
+        }
+
+        noteLocalUidsList += QStringLiteral("'") + sqlEscapeString(*it) + QStringLiteral("'");
+    }
+
+    QString queryString = QString::fromUtf8("SELECT ResourceSyncedDataHashes.resourceLocalUid, ResourceSyncedDataHashes.dataHash "
+                                            "FROM ResourceSyncedDataHashes INNER JOIN Resources "
+                                            "ON ResourceSyncedDataHashes.resourceLocalUid = Resources.resourceLocalUid "
+                                            "WHERE Resources.noteLocalUid IN (%1)").arg(noteLocalUidsList);
+
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, queryString);
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.details() = query.lastError().text();
+        QNERROR(errorDescription << QStringLiteral(", last executed query: ") << lastExecutedQuery(query));
+        return dataHashesByResourceLocalUid;
+    }
+
+    while(query.next()) {
+        dataHashesByResourceLocalUid[query.value(0).toString()] = query.value(1).toByteArray();
+    }
+
+    QNDEBUG(QStringLiteral("Found ") << dataHashesByResourceLocalUid.size() << QStringLiteral(" synchronized resource data hashes"));
+    return dataHashesByResourceLocalUid;
+}
+
+LocalStorageStatistics LocalStorageManagerPrivate::statistics() const
+{
+    return m_statisticsCollector.statistics();
+}
+
+void LocalStorageManagerPrivate::resetStatistics()
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::resetStatistics"));
+    m_statisticsCollector.reset();
+}
+
+bool LocalStorageManagerPrivate::statisticsCollectionEnabled() const
+{
+    return m_statisticsCollector.isEnabled();
+}
+
+void LocalStorageManagerPrivate::setStatisticsCollectionEnabled(const bool enabled)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::setStatisticsCollectionEnabled: ")
+            << (enabled ? QStringLiteral("true") : QStringLiteral("false")));
+    m_statisticsCollector.setEnabled(enabled);
+}
+
+void LocalStorageManagerPrivate::setSlowQueryThreshold(const qint64 thresholdUsec)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::setSlowQueryThreshold: ") << thresholdUsec << QStringLiteral(" usec"));
+    m_statisticsCollector.setSlowQueryThresholdUsec(thresholdUsec);
+}
+
+#define SNAPSHOT_CONNECTION_NAME "quentier_sqlite_snapshot_connection"
+#define SNAPSHOT_FILE_COPY_CHUNK_SIZE (1024 * 1024)
+
+bool LocalStorageManagerPrivate::exportSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                                                ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::exportSnapshot: ") << snapshotFilePath);
+
+    ErrorString errorPrefix(QT_TR_NOOP("Can't export the snapshot of the local storage"));
+
+    if (Q_UNLIKELY(snapshotFilePath.isEmpty())) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("snapshot file path is empty"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QFileInfo snapshotFileInfo(snapshotFilePath);
+    if (Q_UNLIKELY(snapshotFileInfo.absoluteFilePath() == QFileInfo(m_databaseFilePath).absoluteFilePath())) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("snapshot file path coincides with the path of the local storage database file"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QDir snapshotFileDir = snapshotFileInfo.absoluteDir();
+    if (!snapshotFileDir.exists() && !snapshotFileDir.mkpath(snapshotFileDir.absolutePath())) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("can't create the folder for the snapshot file"));
+        errorDescription.details() = snapshotFileDir.absolutePath();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    ErrorString error;
+    LocalStorageSnapshotInfo info;
+    if (Q_UNLIKELY(!collectSnapshotInfo(info, error))) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    // Move all the pages from the write-ahead log into the database file itself so that the page-level copy
+    // of the database file contains the entire state of the local storage
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    if (query.next() && (query.value(0).toInt() != 0)) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("can't checkpoint the write-ahead log of the local storage database"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    query.finish();
+
+    QString temporarySnapshotFilePath = snapshotFileInfo.absoluteFilePath() + QStringLiteral(".tmp");
+    Q_UNUSED(QFile::remove(temporarySnapshotFilePath))
+
+    // NOTE: no transaction is opened around the copying: SQLite refuses to checkpoint the write-ahead log
+    // from within a transaction so the checkpoint above has to run outside of it anyway. Nothing can write
+    // to the database file in between: all writes from this process go through this very thread
+    // and other processes are kept away from the database file by the file lock
+    res = copyFileContents(m_databaseFilePath, temporarySnapshotFilePath, error);
+
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(temporarySnapshotFilePath))
+        return false;
+    }
+
+    {
+        QSqlDatabase snapshotDatabase = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"),
+                                                                  QStringLiteral(SNAPSHOT_CONNECTION_NAME));
+        snapshotDatabase.setDatabaseName(temporarySnapshotFilePath);
+        if (!snapshotDatabase.open()) {
+            error.setBase(QT_TR_NOOP("can't open the snapshot file"));
+            error.details() = snapshotDatabase.lastError().text();
+            res = false;
+        }
+        else {
+            res = writeSnapshotInfo(snapshotDatabase, info, error);
+            snapshotDatabase.close();
+        }
+    }
+
+    QSqlDatabase::removeDatabase(QStringLiteral(SNAPSHOT_CONNECTION_NAME));
+
+    if (res) {
+        Q_UNUSED(QFile::remove(snapshotFileInfo.absoluteFilePath()))
+        res = QFile::rename(temporarySnapshotFilePath, snapshotFileInfo.absoluteFilePath());
+        if (!res) {
+            error.setBase(QT_TR_NOOP("can't rename the temporary snapshot file"));
+            error.details() = temporarySnapshotFilePath;
+        }
+    }
+
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(temporarySnapshotFilePath))
+        return false;
+    }
+
+    snapshotInfo = info;
+    QNDEBUG(QStringLiteral("Exported the local storage snapshot: ") << snapshotInfo);
+    return true;
+}
+
+bool LocalStorageManagerPrivate::importSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                                                ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::importSnapshot: ") << snapshotFilePath);
+
+    ErrorString errorPrefix(QT_TR_NOOP("Can't import the snapshot of the local storage"));
+
+    if (Q_UNLIKELY(m_databaseFilePath.isEmpty())) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("the local storage is not initialized"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QFileInfo snapshotFileInfo(snapshotFilePath);
+    if (Q_UNLIKELY(!snapshotFileInfo.exists() || !snapshotFileInfo.isReadable())) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(QT_TR_NOOP("snapshot file doesn't exist or is not readable"));
+        errorDescription.details() = snapshotFilePath;
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    // Collect the names of tables the snapshot is expected to contain
+    QStringList tableNames;
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, QStringLiteral("SELECT name FROM sqlite_master WHERE type='table' "
+                                               "AND name NOT LIKE 'sqlite_%'"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    while(query.next()) {
+        tableNames << query.value(0).toString();
+    }
+
+    query.finish();
+
+    ErrorString error;
+    LocalStorageSnapshotInfo info;
+
+    {
+        QSqlDatabase snapshotDatabase = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"),
+                                                                  QStringLiteral(SNAPSHOT_CONNECTION_NAME));
+        snapshotDatabase.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        snapshotDatabase.setDatabaseName(snapshotFileInfo.absoluteFilePath());
+        if (!snapshotDatabase.open()) {
+            error.setBase(QT_TR_NOOP("can't open the snapshot file"));
+            error.details() = snapshotDatabase.lastError().text();
+            res = false;
+        }
+        else {
+            res = readSnapshotInfo(snapshotDatabase, tableNames, info, error);
+            snapshotDatabase.close();
+        }
+    }
+
+    QSqlDatabase::removeDatabase(QStringLiteral(SNAPSHOT_CONNECTION_NAME));
+
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    // The snapshot is first copied next to the database file and synced to the disk; only then
+    // the current database file is moved aside as a backup and the copy takes its place. The backup
+    // is removed only after the database is successfully reopened from the imported snapshot,
+    // otherwise the backup is moved back in place
+    QString importedDatabaseFilePath = m_databaseFilePath + QStringLiteral(SNAPSHOT_IMPORT_FILE_SUFFIX);
+    Q_UNUSED(QFile::remove(importedDatabaseFilePath))
+
+    res = copyFileContents(snapshotFileInfo.absoluteFilePath(), importedDatabaseFilePath, error);
+    if (!res) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+        Q_UNUSED(QFile::remove(importedDatabaseFilePath))
+        return false;
+    }
+
+    // Move the pages from the write-ahead log into the database file so that the backup is self-contained;
+    // if that doesn't work out, the write-ahead log is moved aside along with the database file
+    QSqlQuery checkpointQuery(m_sqlDatabase);
+    if (!execQuery(checkpointQuery, QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)"))) {
+        QNINFO(QStringLiteral("Can't checkpoint the write-ahead log before the snapshot import: ")
+               << checkpointQuery.lastError());
+    }
+
+    checkpointQuery.finish();
+    m_sqlDatabase.close();
+
+    QString backupDatabaseFilePath = m_databaseFilePath + QStringLiteral(SNAPSHOT_IMPORT_BACKUP_FILE_SUFFIX);
+    removeDatabaseFileWithAuxiliaryFiles(backupDatabaseFilePath);
+
+    res = moveDatabaseFileWithAuxiliaryFiles(m_databaseFilePath, backupDatabaseFilePath);
+    if (res)
+    {
+        res = QFile::rename(importedDatabaseFilePath, m_databaseFilePath);
+        if (!res) {
+            error.setBase(QT_TR_NOOP("can't move the imported snapshot in place of the local storage database file"));
+            error.details() = importedDatabaseFilePath;
+            Q_UNUSED(moveDatabaseFileWithAuxiliaryFiles(backupDatabaseFilePath, m_databaseFilePath))
+        }
+    }
+    else
+    {
+        error.setBase(QT_TR_NOOP("can't back up the local storage database file"));
+        error.details() = m_databaseFilePath;
+    }
+
+    ErrorString openingError;
+    if (res) {
+        res = relockAndOpenDatabase(openingError);
+        if (!res) {
+            error = openingError;
+            removeDatabaseFileWithAuxiliaryFiles(m_databaseFilePath);
+            Q_UNUSED(moveDatabaseFileWithAuxiliaryFiles(backupDatabaseFilePath, m_databaseFilePath))
+        }
+    }
+
+    if (!res)
+    {
+        Q_UNUSED(QFile::remove(importedDatabaseFilePath))
+
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(error.base());
+        errorDescription.appendBase(error.additionalBases());
+        errorDescription.details() = error.details();
+        QNWARNING(errorDescription);
+
+        // Whatever happened, the original database file is back in place by now, need to reopen it
+        if (!relockAndOpenDatabase(openingError)) {
+            errorDescription.appendBase(QT_TR_NOOP("can't reopen the local storage database"));
+            errorDescription.appendBase(openingError.base());
+            errorDescription.details() += QStringLiteral("; ") + openingError.details();
+            QNWARNING(errorDescription);
+        }
+
+        return false;
+    }
+
+    removeDatabaseFileWithAuxiliaryFiles(backupDatabaseFilePath);
+
+    QSqlQuery dropSnapshotInfoQuery(m_sqlDatabase);
+    res = execQuery(dropSnapshotInfoQuery, QStringLiteral("DROP TABLE IF EXISTS SnapshotInfo"));
+    if (res) {
+        res = execQuery(dropSnapshotInfoQuery, QStringLiteral("DROP TABLE IF EXISTS SnapshotLinkedNotebooksInfo"));
+    }
+
+    if (!res) {
+        // Not critical: the tables are simply ignored by the local storage
+        QNWARNING(QStringLiteral("Can't drop the snapshot info tables from the imported local storage database: ")
+                  << dropSnapshotInfoQuery.lastError());
+    }
+
+    snapshotInfo = info;
+    QNDEBUG(QStringLiteral("Imported the local storage snapshot: ") << snapshotInfo);
+    return true;
+}
+
+bool LocalStorageManagerPrivate::expungeStaleDataItems(const QSet<QString> & syncedNotebookGuids,
+                                                       const QSet<QString> & syncedTagGuids,
+                                                       const QSet<QString> & syncedNoteGuids,
+                                                       const QSet<QString> & syncedSavedSearchGuids,
+                                                       const QString & linkedNotebookGuid,
+                                                       StaleDataItemsExpungeResult & result,
+                                                       ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::expungeStaleDataItems: linked notebook guid = ") << linkedNotebookGuid
+            << QStringLiteral(", synced notebook guids: ") << syncedNotebookGuids.size()
+            << QStringLiteral(", synced tag guids: ") << syncedTagGuids.size()
+            << QStringLiteral(", synced note guids: ") << syncedNoteGuids.size()
+            << QStringLiteral(", synced saved search guids: ") << syncedSavedSearchGuids.size());
+
+    result = StaleDataItemsExpungeResult();
+
+    ErrorString errorPrefix(QT_TR_NOOP("Can't expunge stale data items from the local storage database"));
+
+    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+
+    QSqlQuery query(m_sqlDatabase);
+    bool res = true;
+
+    QStringList temporaryTablesQueries;
+    temporaryTablesQueries << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS SyncedNotebookGuids(guid TEXT PRIMARY KEY NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS SyncedTagGuids(guid TEXT PRIMARY KEY NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS SyncedNoteGuids(guid TEXT PRIMARY KEY NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS SyncedSavedSearchGuids(guid TEXT PRIMARY KEY NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS StaleNotebooks("
+                                             "localUid TEXT PRIMARY KEY NOT NULL, isDirty INTEGER NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS StaleTags("
+                                             "localUid TEXT PRIMARY KEY NOT NULL, guid TEXT NOT NULL, isDirty INTEGER NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS StaleNotes("
+                                             "localUid TEXT PRIMARY KEY NOT NULL, notebookLocalUid TEXT NOT NULL, "
+                                             "isDirty INTEGER NOT NULL)")
+                           << QStringLiteral("CREATE TEMP TABLE IF NOT EXISTS StaleSavedSearches("
+                                             "localUid TEXT PRIMARY KEY NOT NULL, isDirty INTEGER NOT NULL)");
+
+    QStringList temporaryTableNames;
+    temporaryTableNames << QStringLiteral("SyncedNotebookGuids") << QStringLiteral("SyncedTagGuids")
+                        << QStringLiteral("SyncedNoteGuids") << QStringLiteral("SyncedSavedSearchGuids")
+                        << QStringLiteral("StaleNotebooks") << QStringLiteral("StaleTags")
+                        << QStringLiteral("StaleNotes") << QStringLiteral("StaleSavedSearches");
+
+    for(auto it = temporaryTablesQueries.constBegin(), end = temporaryTablesQueries.constEnd(); it != end; ++it) {
+        res = execQuery(query, *it);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    // The temporary tables might contain leftovers from the previous call if it failed before cleaning them up
+    for(auto it = temporaryTableNames.constBegin(), end = temporaryTableNames.constEnd(); it != end; ++it) {
+        res = execQuery(query, QStringLiteral("DELETE FROM temp.") + *it);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    ErrorString error;
+
+#define FILL_SYNCED_GUIDS_TABLE(tableName, guids) \
+    error.clear(); \
+    if (!fillSyncedGuidsTable(QStringLiteral(tableName), guids, error)) { \
+        errorDescription.base() = errorPrefix.base(); \
+        errorDescription.appendBase(error.base()); \
+        errorDescription.appendBase(error.additionalBases()); \
+        errorDescription.details() = error.details(); \
+        return false; \
+    }
+
+    FILL_SYNCED_GUIDS_TABLE("SyncedNotebookGuids", syncedNotebookGuids)
+    FILL_SYNCED_GUIDS_TABLE("SyncedTagGuids", syncedTagGuids)
+    FILL_SYNCED_GUIDS_TABLE("SyncedNoteGuids", syncedNoteGuids)
+
+    if (linkedNotebookGuid.isEmpty()) {
+        FILL_SYNCED_GUIDS_TABLE("SyncedSavedSearchGuids", syncedSavedSearchGuids)
+    }
+
+#undef FILL_SYNCED_GUIDS_TABLE
+
+    QString linkedNotebookGuidCondition = (linkedNotebookGuid.isEmpty()
+                                           ? QStringLiteral("linkedNotebookGuid IS NULL")
+                                           : QString::fromUtf8("linkedNotebookGuid = '%1'").arg(sqlEscapeString(linkedNotebookGuid)));
+
+    // Find the stale data items: those which have guids but are not referenced among the synced ones
+    QStringList staleItemsQueries;
+    staleItemsQueries << QString::fromUtf8("INSERT INTO temp.StaleNotebooks(localUid, isDirty) "
+                                           "SELECT localUid, isDirty FROM Notebooks WHERE guid IS NOT NULL AND %1 "
+                                           "AND NOT EXISTS (SELECT 1 FROM temp.SyncedNotebookGuids AS synced "
+                                           "WHERE synced.guid = Notebooks.guid)").arg(linkedNotebookGuidCondition)
+                      << QString::fromUtf8("INSERT INTO temp.StaleTags(localUid, guid, isDirty) "
+                                           "SELECT localUid, guid, isDirty FROM Tags WHERE guid IS NOT NULL AND %1 "
+                                           "AND NOT EXISTS (SELECT 1 FROM temp.SyncedTagGuids AS synced "
+                                           "WHERE synced.guid = Tags.guid)").arg(linkedNotebookGuidCondition)
+                      << QString::fromUtf8("INSERT INTO temp.StaleNotes(localUid, notebookLocalUid, isDirty) "
+                                           "SELECT Notes.localUid, Notes.notebookLocalUid, Notes.isDirty FROM Notes "
+                                           "INNER JOIN Notebooks ON Notes.notebookLocalUid = Notebooks.localUid "
+                                           "WHERE Notes.guid IS NOT NULL AND Notebooks.%1 "
+                                           "AND NOT EXISTS (SELECT 1 FROM temp.SyncedNoteGuids AS synced "
+                                           "WHERE synced.guid = Notes.guid)").arg(linkedNotebookGuidCondition);
+
+    // Saved searches only belong to user's own account
+    if (linkedNotebookGuid.isEmpty()) {
+        staleItemsQueries << QStringLiteral("INSERT INTO temp.StaleSavedSearches(localUid, isDirty) "
+                                            "SELECT localUid, isDirty FROM SavedSearches WHERE guid IS NOT NULL "
+                                            "AND NOT EXISTS (SELECT 1 FROM temp.SyncedSavedSearchGuids AS synced "
+                                            "WHERE synced.guid = SavedSearches.guid)");
+    }
+
+    for(auto it = staleItemsQueries.constBegin(), end = staleItemsQueries.constEnd(); it != end; ++it) {
+        res = execQuery(query, *it);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    // Dirty stale tags need to be preserved so they need to be detached from their parents going to be expunged,
+    // otherwise they would be expunged along with them
+    res = execQuery(query, QStringLiteral("UPDATE Tags SET parentGuid = NULL, parentLocalUid = NULL "
+                                          "WHERE localUid IN (SELECT localUid FROM temp.StaleTags WHERE isDirty != 0) "
+                                          "AND parentGuid IN (SELECT guid FROM temp.StaleTags WHERE isDirty = 0)"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    const QString expungedTagsCondition = QStringLiteral("localUid IN (SELECT localUid FROM temp.StaleTags WHERE isDirty = 0) "
+                                                         "OR parentGuid IN (SELECT guid FROM temp.StaleTags WHERE isDirty = 0)");
+
+    // Dirty notes from the notebooks being expunged are expunged along with their notebooks
+    const QString detachedNotesCondition = QStringLiteral("localUid IN (SELECT localUid FROM temp.StaleNotes WHERE isDirty != 0 "
+                                                          "AND notebookLocalUid NOT IN (SELECT localUid FROM temp.StaleNotebooks "
+                                                          "WHERE isDirty = 0))");
+
+    QList<QPair<QString, QStringList*> > localUidsQueries;
+    localUidsQueries << qMakePair(QStringLiteral("SELECT localUid FROM temp.StaleNotebooks WHERE isDirty = 0"),
+                                  &result.expungedNotebookLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM temp.StaleNotebooks WHERE isDirty != 0"),
+                                  &result.detachedNotebookLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM Tags WHERE ") + expungedTagsCondition,
+                                  &result.expungedTagLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM temp.StaleTags WHERE isDirty != 0"),
+                                  &result.detachedTagLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM Notes WHERE notebookLocalUid IN "
+                                                 "(SELECT localUid FROM temp.StaleNotebooks WHERE isDirty = 0) "
+                                                 "UNION SELECT localUid FROM temp.StaleNotes WHERE isDirty = 0"),
+                                  &result.expungedNoteLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM Notes WHERE ") + detachedNotesCondition,
+                                  &result.detachedNoteLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM temp.StaleSavedSearches WHERE isDirty = 0"),
+                                  &result.expungedSavedSearchLocalUids)
+                     << qMakePair(QStringLiteral("SELECT localUid FROM temp.StaleSavedSearches WHERE isDirty != 0"),
+                                  &result.detachedSavedSearchLocalUids);
+
+    for(auto it = localUidsQueries.constBegin(), end = localUidsQueries.constEnd(); it != end; ++it)
+    {
+        error.clear();
+        if (!listLocalUidsFromQuery(it->first, *(it->second), error)) {
+            errorDescription.base() = errorPrefix.base();
+            errorDescription.appendBase(error.base());
+            errorDescription.appendBase(error.additionalBases());
+            errorDescription.details() = error.details();
+            return false;
+        }
+    }
+
+    QNDEBUG(QStringLiteral("Stale data items: ") << result);
+
+    // NOTE: expunging first and detaching then because the latter changes the guid columns
+    // referenced by the full text search triggers firing on deletion
+    QStringList modificationQueries;
+    modificationQueries << QStringLiteral("DELETE FROM Notes WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleNotes WHERE isDirty = 0)")
+                        << QStringLiteral("DELETE FROM Notebooks WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleNotebooks WHERE isDirty = 0)")
+                        << (QStringLiteral("DELETE FROM Tags WHERE ") + expungedTagsCondition)
+                        << QStringLiteral("DELETE FROM SavedSearches WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleSavedSearches WHERE isDirty = 0)")
+                        << QStringLiteral("UPDATE Notebooks SET guid = NULL, updateSequenceNumber = NULL WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleNotebooks WHERE isDirty != 0)")
+                        << QStringLiteral("UPDATE Tags SET guid = NULL, updateSequenceNumber = NULL WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleTags WHERE isDirty != 0)")
+                        << (QStringLiteral("UPDATE Notes SET guid = NULL, updateSequenceNumber = NULL, "
+                                           "notebookGuid = (SELECT guid FROM Notebooks WHERE Notebooks.localUid = Notes.notebookLocalUid) "
+                                           "WHERE ") + detachedNotesCondition)
+                        << QStringLiteral("UPDATE SavedSearches SET guid = NULL, updateSequenceNumber = NULL WHERE localUid IN "
+                                          "(SELECT localUid FROM temp.StaleSavedSearches WHERE isDirty != 0)");
+
+    for(auto it = modificationQueries.constBegin(), end = modificationQueries.constEnd(); it != end; ++it) {
+        res = execQuery(query, *it);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    // The full text search tables contain guid columns which are not updated by any trigger; rebuilding each
+    // affected table once is what the insertion triggers do for every single data item anyway
+    QStringList ftsTablesToRebuild;
+    if (!result.detachedNotebookLocalUids.isEmpty()) {
+        ftsTablesToRebuild << QStringLiteral("NotebookFTS");
+    }
+
+    if (!result.detachedTagLocalUids.isEmpty()) {
+        ftsTablesToRebuild << QStringLiteral("TagFTS");
+    }
+
+    if (!result.detachedNoteLocalUids.isEmpty() || !result.detachedNotebookLocalUids.isEmpty()) {
+        ftsTablesToRebuild << QStringLiteral("NoteFTS");
+    }
+
+    for(auto it = ftsTablesToRebuild.constBegin(), end = ftsTablesToRebuild.constEnd(); it != end; ++it) {
+        res = execQuery(query, QString::fromUtf8("INSERT INTO %1(%1) VALUES('rebuild')").arg(*it));
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    for(auto it = temporaryTableNames.constBegin(), end = temporaryTableNames.constEnd(); it != end; ++it) {
+        res = execQuery(query, QStringLiteral("DELETE FROM temp.") + *it);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    // NOTE: the expunged data items are journaled by the deletion triggers of the change journal,
+    // only the detached ones need to be journaled explicitly here
+    QStringList noteChangedFields;
+    noteChangedFields << QStringLiteral("note");
+
+#define APPEND_CHANGE_JOURNAL_ENTRIES(entityType, changeType, localUids, changedFields) \
+    error.clear(); \
+    if (!appendChangeJournalEntries(ChangeJournalEntry::EntityType::entityType, ChangeJournalEntry::ChangeType::changeType, \
+                                    localUids, changedFields, error)) \
+    { \
+        errorDescription.base() = errorPrefix.base(); \
+        errorDescription.appendBase(error.base()); \
+        errorDescription.appendBase(error.additionalBases()); \
+        errorDescription.details() = error.details(); \
+        return false; \
+    }
+
+    APPEND_CHANGE_JOURNAL_ENTRIES(Notebook, Update, result.detachedNotebookLocalUids, QStringList())
+    APPEND_CHANGE_JOURNAL_ENTRIES(Tag, Update, result.detachedTagLocalUids, QStringList())
+    APPEND_CHANGE_JOURNAL_ENTRIES(Note, Update, result.detachedNoteLocalUids, noteChangedFields)
+    APPEND_CHANGE_JOURNAL_ENTRIES(SavedSearch, Update, result.detachedSavedSearchLocalUids, QStringList())
+
+#undef APPEND_CHANGE_JOURNAL_ENTRIES
+
+    return transaction.commit(errorDescription);
+}
+
+bool LocalStorageManagerPrivate::collectSnapshotInfo(LocalStorageSnapshotInfo & snapshotInfo,
+                                                     ErrorString & errorDescription)
+{
+    ErrorString errorPrefix(QT_TR_NOOP("can't collect the snapshot info"));
+
+    qint32 highUsn = accountHighUsn(QString(), errorDescription);
+    if (Q_UNLIKELY(highUsn < 0)) {
+        return false;
+    }
+
+    QStringList linkedNotebookGuids;
+    {
+        QSqlQuery query(m_sqlDatabase);
+        bool res = execQuery(query, QStringLiteral("SELECT guid FROM LinkedNotebooks"));
+        DATABASE_CHECK_AND_SET_ERROR();
+
+        while(query.next()) {
+            linkedNotebookGuids << query.value(0).toString();
+        }
+    }
+
+    QHash<QString,qint32> highUsnByLinkedNotebookGuid;
+    highUsnByLinkedNotebookGuid.reserve(linkedNotebookGuids.size());
+
+    for(auto it = linkedNotebookGuids.constBegin(), end = linkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        qint32 linkedNotebookHighUsn = accountHighUsn(*it, errorDescription);
+        if (Q_UNLIKELY(linkedNotebookHighUsn < 0)) {
+            return false;
+        }
+
+        highUsnByLinkedNotebookGuid[*it] = linkedNotebookHighUsn;
+    }
+
+    snapshotInfo.highUsn = highUsn;
+    snapshotInfo.highUsnByLinkedNotebookGuid = highUsnByLinkedNotebookGuid;
+    snapshotInfo.creationTimestamp = QDateTime::currentMSecsSinceEpoch();
+    return true;
+}
+
+bool LocalStorageManagerPrivate::writeSnapshotInfo(QSqlDatabase & snapshotDatabase,
+                                                   const LocalStorageSnapshotInfo & snapshotInfo,
+                                                   ErrorString & errorDescription) const
+{
+    ErrorString errorPrefix(QT_TR_NOOP("can't write the snapshot info"));
+
+    QSqlQuery query(snapshotDatabase);
+
+    // The snapshot must be self-contained, without the write-ahead log file alongside it
+    bool res = execQuery(query, QStringLiteral("PRAGMA journal_mode=DELETE"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS SnapshotInfo("
+                                          "  lock                        CHAR(1) PRIMARY KEY     NOT NULL DEFAULT 'X'    CHECK (lock='X'), "
+                                          "  highUsn                     INTEGER                 NOT NULL, "
+                                          "  creationTimestamp           INTEGER                 NOT NULL"
+                                          ")"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS SnapshotLinkedNotebooksInfo("
+                                          "  linkedNotebookGuid          TEXT PRIMARY KEY        NOT NULL UNIQUE, "
+                                          "  highUsn                     INTEGER                 NOT NULL"
+                                          ")"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = query.prepare(QStringLiteral("INSERT OR REPLACE INTO SnapshotInfo(highUsn, creationTimestamp) "
+                                       "VALUES(:highUsn, :creationTimestamp)"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    query.bindValue(QStringLiteral(":highUsn"), snapshotInfo.highUsn);
+    query.bindValue(QStringLiteral(":creationTimestamp"), snapshotInfo.creationTimestamp);
+
+    res = execQuery(query);
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    if (snapshotInfo.highUsnByLinkedNotebookGuid.isEmpty()) {
+        return true;
+    }
+
+    res = query.prepare(QStringLiteral("INSERT OR REPLACE INTO SnapshotLinkedNotebooksInfo(linkedNotebookGuid, highUsn) "
+                                       "VALUES(:linkedNotebookGuid, :highUsn)"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    for(auto it = snapshotInfo.highUsnByLinkedNotebookGuid.constBegin(),
+        end = snapshotInfo.highUsnByLinkedNotebookGuid.constEnd(); it != end; ++it)
+    {
+        query.bindValue(QStringLiteral(":linkedNotebookGuid"), it.key());
+        query.bindValue(QStringLiteral(":highUsn"), it.value());
+
+        res = execQuery(query);
+        DATABASE_CHECK_AND_SET_ERROR();
+    }
+
+    return true;
+}
+
+bool LocalStorageManagerPrivate::readSnapshotInfo(QSqlDatabase & snapshotDatabase, const QStringList & expectedTableNames,
+                                                  LocalStorageSnapshotInfo & snapshotInfo,
+                                                  ErrorString & errorDescription) const
+{
+    ErrorString errorPrefix(QT_TR_NOOP("can't read the snapshot info"));
+
+    QSqlQuery query(snapshotDatabase);
+    bool res = execQuery(query, QStringLiteral("PRAGMA quick_check"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    if (!query.next() || (query.value(0).toString() != QStringLiteral("ok"))) {
+        errorDescription.setBase(QT_TR_NOOP("the snapshot file is corrupted"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QSet<QString> tableNames;
+    res = execQuery(query, QStringLiteral("SELECT name FROM sqlite_master WHERE type='table'"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    while(query.next()) {
+        Q_UNUSED(tableNames.insert(query.value(0).toString()))
+    }
+
+    if (!tableNames.contains(QStringLiteral("SnapshotInfo"))) {
+        errorDescription.setBase(QT_TR_NOOP("the file is not a local storage snapshot"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    for(auto it = expectedTableNames.constBegin(), end = expectedTableNames.constEnd(); it != end; ++it)
+    {
+        if (!tableNames.contains(*it)) {
+            errorDescription.setBase(QT_TR_NOOP("the snapshot is incompatible with the current local storage database: "
+                                                "some table is missing"));
+            errorDescription.details() = *it;
+            QNWARNING(errorDescription);
+            return false;
+        }
+    }
+
+    res = execQuery(query, QStringLiteral("SELECT highUsn, creationTimestamp FROM SnapshotInfo LIMIT 1"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    if (!query.next()) {
+        errorDescription.setBase(QT_TR_NOOP("the snapshot info is empty"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    bool conversionResult = false;
+    qint32 usn = query.value(0).toInt(&conversionResult);
+    if (!conversionResult || (usn < 0)) {
+        errorDescription.setBase(QT_TR_NOOP("the snapshot info contains invalid high USN"));
+        errorDescription.details() = query.value(0).toString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    conversionResult = false;
+    qint64 creationTimestamp = query.value(1).toLongLong(&conversionResult);
+    if (!conversionResult || (creationTimestamp < 0)) {
+        errorDescription.setBase(QT_TR_NOOP("the snapshot info contains invalid creation timestamp"));
+        errorDescription.details() = query.value(1).toString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QHash<QString,qint32> highUsnByLinkedNotebookGuid;
+
+    // NOTE: the snapshots created before the linked notebooks' high USNs were recorded don't have this table;
+    // the linked notebooks from such snapshots are synchronized from scratch
+    if (tableNames.contains(QStringLiteral("SnapshotLinkedNotebooksInfo")))
+    {
+        res = execQuery(query, QStringLiteral("SELECT linkedNotebookGuid, highUsn FROM SnapshotLinkedNotebooksInfo"));
+        DATABASE_CHECK_AND_SET_ERROR();
+
+        while(query.next())
+        {
+            QString linkedNotebookGuid = query.value(0).toString();
+
+            conversionResult = false;
+            qint32 linkedNotebookUsn = query.value(1).toInt(&conversionResult);
+            if (linkedNotebookGuid.isEmpty() || !conversionResult || (linkedNotebookUsn < 0)) {
+                errorDescription.setBase(QT_TR_NOOP("the snapshot info contains invalid high USN of a linked notebook"));
+                errorDescription.details() = linkedNotebookGuid + QStringLiteral(": ") + query.value(1).toString();
+                QNWARNING(errorDescription);
+                return false;
+            }
+
+            highUsnByLinkedNotebookGuid[linkedNotebookGuid] = linkedNotebookUsn;
+        }
+    }
+
+    snapshotInfo.highUsn = usn;
+    snapshotInfo.highUsnByLinkedNotebookGuid = highUsnByLinkedNotebookGuid;
+    snapshotInfo.creationTimestamp = creationTimestamp;
+    return true;
+}
+
+bool LocalStorageManagerPrivate::copyFileContents(const QString & sourceFilePath, const QString & targetFilePath,
+                                                  ErrorString & errorDescription) const
+{
+    QFile sourceFile(sourceFilePath);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("can't open the file for reading"));
+        errorDescription.details() = sourceFilePath + QStringLiteral(": ") + sourceFile.errorString();
+        return false;
+    }
+
+    QFile targetFile(targetFilePath);
+    if (!targetFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorDescription.setBase(QT_TR_NOOP("can't open the file for writing"));
+        errorDescription.details() = targetFilePath + QStringLiteral(": ") + targetFile.errorString();
+        return false;
+    }
+
+    while(!sourceFile.atEnd())
+    {
+        QByteArray chunk = sourceFile.read(SNAPSHOT_FILE_COPY_CHUNK_SIZE);
+        if (chunk.isEmpty() && (sourceFile.error() != QFile::NoError)) {
+            errorDescription.setBase(QT_TR_NOOP("can't read the file"));
+            errorDescription.details() = sourceFilePath + QStringLiteral(": ") + sourceFile.errorString();
+            return false;
+        }
+
+        if (targetFile.write(chunk) != chunk.size()) {
+            errorDescription.setBase(QT_TR_NOOP("can't write the file"));
+            errorDescription.details() = targetFilePath + QStringLiteral(": ") + targetFile.errorString();
+            return false;
+        }
+    }
+
+    if (!targetFile.flush()) {
+        errorDescription.setBase(QT_TR_NOOP("can't write the file"));
+        errorDescription.details() = targetFilePath + QStringLiteral(": ") + targetFile.errorString();
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    int syncResult = _commit(targetFile.handle());
+#else
+    int syncResult = fsync(targetFile.handle());
+#endif
+
+    if (syncResult != 0) {
+        errorDescription.setBase(QT_TR_NOOP("can't sync the file to the disk"));
+        errorDescription.details() = targetFilePath;
+        return false;
+    }
+
+    return true;
+}
+
+bool LocalStorageManagerPrivate::moveDatabaseFileWithAuxiliaryFiles(const QString & sourceFilePath,
+                                                                    const QString & targetFilePath) const
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::moveDatabaseFileWithAuxiliaryFiles: from ") << sourceFilePath
+            << QStringLiteral(" to ") << targetFilePath);
+
+    if (!QFile::rename(sourceFilePath, targetFilePath)) {
+        QNWARNING(QStringLiteral("Can't move the database file ") << sourceFilePath << QStringLiteral(" to ") << targetFilePath);
+        return false;
+    }
+
+    // The write-ahead log might contain pages which haven't been checkpointed into the database file yet
+    // so it has to travel along with it; the shared memory index is rebuilt by SQLite from the write-ahead log
+    QString sourceWalFilePath = sourceFilePath + QStringLiteral("-wal");
+    QString targetWalFilePath = targetFilePath + QStringLiteral("-wal");
+    Q_UNUSED(QFile::remove(targetWalFilePath))
+    if (QFile::exists(sourceWalFilePath) && !QFile::rename(sourceWalFilePath, targetWalFilePath)) {
+        QNWARNING(QStringLiteral("Can't move the write-ahead log file ") << sourceWalFilePath
+                  << QStringLiteral(" to ") << targetWalFilePath);
+        Q_UNUSED(QFile::rename(targetFilePath, sourceFilePath))
+        return false;
+    }
+
+    Q_UNUSED(QFile::remove(sourceFilePath + QStringLiteral("-shm")))
+    Q_UNUSED(QFile::remove(targetFilePath + QStringLiteral("-shm")))
+    return true;
+}
+
+void LocalStorageManagerPrivate::removeDatabaseFileWithAuxiliaryFiles(const QString & filePath) const
+{
+    Q_UNUSED(QFile::remove(filePath))
+    Q_UNUSED(QFile::remove(filePath + QStringLiteral("-wal")))
+    Q_UNUSED(QFile::remove(filePath + QStringLiteral("-shm")))
+}
+
+bool LocalStorageManagerPrivate::relockAndOpenDatabase(ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::relockAndOpenDatabase"));
 
-    QVector<HighUsnRequestData> tablesAndUsnColumns;
-    if (linkedNotebookGuid.isEmpty()) {
-        tablesAndUsnColumns.reserve(6);
+    // The file lock is tied to the file rather than to its path so the file put in place of the former one
+    // needs to be locked anew
+#ifndef Q_OS_WIN
+    try {
+        boost::interprocess::file_lock databaseLock(QFileInfo(m_databaseFilePath).canonicalFilePath().toUtf8().constData());
+        m_databaseFileLock.swap(databaseLock);
+        if (!m_databaseFileLock.try_lock()) {
+            QNINFO(QStringLiteral("Can't lock the local storage database file ") << m_databaseFilePath);
+        }
     }
-    else {
-        tablesAndUsnColumns.reserve(4);
+    catch(boost::interprocess::interprocess_exception & exc) {
+        QNWARNING(QStringLiteral("Caught exception trying to lock the database file: error code = ")
+                  << exc.get_error_code() << QStringLiteral(", error message = ") << exc.what());
     }
+#endif
 
-    QString queryCondition = QStringLiteral("WHERE linkedNotebookGuid");
-    if (linkedNotebookGuid.isEmpty()) {
-        queryCondition += QStringLiteral(" IS NULL");
+    try {
+        openDatabase();
     }
-    else {
-        queryCondition += QString::fromUtf8("='%1'").arg(sqlEscapeString(linkedNotebookGuid));
+    catch(const std::exception & e) {
+        errorDescription.setBase(QT_TR_NOOP("can't open the local storage database"));
+        errorDescription.details() = QString::fromUtf8(e.what());
+        m_sqlDatabase.close();
+        return false;
     }
 
-#define ADD_TABLE_AND_USN_COLUMN(tableName, usnColumnName) \
-    tablesAndUsnColumns << HighUsnRequestData(tableName, usnColumnName, queryCondition)
+    return true;
+}
 
-    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Notebooks"), QStringLiteral("updateSequenceNumber"));
-    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Tags"), QStringLiteral("updateSequenceNumber"));
+bool LocalStorageManagerPrivate::fillSyncedGuidsTable(const QString & tableName, const QSet<QString> & guids,
+                                                      ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("LocalStorageManagerPrivate::fillSyncedGuidsTable: ") << tableName
+            << QStringLiteral(", ") << guids.size() << QStringLiteral(" guids"));
 
-    // Separate query condition is required for notes table
-    queryCondition = QStringLiteral("WHERE notebookLocalUid IN (SELECT DISTINCT localUid FROM Notebooks WHERE linkedNotebookGuid");
-    if (linkedNotebookGuid.isEmpty()) {
-        queryCondition += QStringLiteral(" IS NULL)");
-    }
-    else {
-        queryCondition += QString::fromUtf8("='%1')").arg(sqlEscapeString(linkedNotebookGuid));
-    }
-    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Notes"), QStringLiteral("updateSequenceNumber"));
+    ErrorString errorPrefix(QT_TR_NOOP("can't fill the temporary table of synchronized guids"));
 
-    // Separate query condition is required for resources table
-    queryCondition = QStringLiteral("WHERE noteLocalUid IN (SELECT DISTINCT localUid FROM Notes WHERE notebookLocalUid IN ");
-    queryCondition += QStringLiteral("(SELECT DISTINCT localUid FROM Notebooks WHERE linkedNotebookGuid");
-    if (linkedNotebookGuid.isEmpty()) {
-        queryCondition += QStringLiteral(" IS NULL))");
-    }
-    else {
-        queryCondition += QString::fromUtf8("='%1'))").arg(sqlEscapeString(linkedNotebookGuid));
-    }
-    ADD_TABLE_AND_USN_COLUMN(QStringLiteral("Resources"), QStringLiteral("resourceUpdateSequenceNumber"));
+    QSqlQuery query(m_sqlDatabase);
+    bool res = query.prepare(QString::fromUtf8("INSERT OR IGNORE INTO temp.%1(guid) VALUES(:guid)").arg(tableName));
+    DATABASE_CHECK_AND_SET_ERROR();
 
-    // No query condition is required for linked notebooks and saved searches tables + only need to consider them
-    // for highest USN from user's own account, not from some linked notebook
-    if (linkedNotebookGuid.isEmpty()) {
-        queryCondition.clear();
-        ADD_TABLE_AND_USN_COLUMN(QStringLiteral("LinkedNotebooks"), QStringLiteral("updateSequenceNumber"));
-        ADD_TABLE_AND_USN_COLUMN(QStringLiteral("SavedSearches"), QStringLiteral("updateSequenceNumber"));
+    for(auto it = guids.constBegin(), end = guids.constEnd(); it != end; ++it)
+    {
+        query.bindValue(QStringLiteral(":guid"), *it);
+        res = execQuery(query);
+        DATABASE_CHECK_AND_SET_ERROR();
     }
 
-#undef ADD_TABLE_AND_USN_COLUMN
+    return true;
+}
 
-    for(auto it = tablesAndUsnColumns.constBegin(), end = tablesAndUsnColumns.constEnd(); it != end; ++it)
-    {
-        qint32 usn = 0;
-        bool res = updateSequenceNumberFromTable(it->m_tableName, it->m_usnColumnName,
-                                                 it->m_queryCondition, usn, errorDescription);
-        if (!res) {
-            return -1;
-        }
+bool LocalStorageManagerPrivate::listLocalUidsFromQuery(const QString & queryString, QStringList & localUids,
+                                                        ErrorString & errorDescription)
+{
+    ErrorString errorPrefix(QT_TR_NOOP("can't list the local uids of data items"));
 
-        updateSequenceNumber = std::max(updateSequenceNumber, usn);
+    QSqlQuery query(m_sqlDatabase);
+    bool res = execQuery(query, queryString);
+    DATABASE_CHECK_AND_SET_ERROR();
 
-        QNTRACE(QStringLiteral("Max update sequence number from table ") << it->m_tableName
-                << QStringLiteral(": ") << usn << QStringLiteral(", overall max USN so far: ")
-                << updateSequenceNumber);
+    while(query.next()) {
+        localUids << query.value(0).toString();
     }
 
-    QNDEBUG(QStringLiteral("Max USN = ") << updateSequenceNumber);
-    return updateSequenceNumber;
+    return true;
 }
 
 bool LocalStorageManagerPrivate::updateSequenceNumberFromTable(const QString & tableName, const QString & usnColumnName,
@@ -3854,7 +4962,7 @@ bool LocalStorageManagerPrivate::updateSequenceNumberFromTable(const QString & t
     }
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (!query.next()) {
@@ -3925,7 +5033,7 @@ bool LocalStorageManagerPrivate::addEnResource(Resource & resource, ErrorString
 
     QString queryString = QString::fromUtf8("SELECT COUNT(*) FROM NoteResources WHERE localNote = '%1'").arg(noteLocalUid);
     QSqlQuery query(m_sqlDatabase);
-    res = query.exec(queryString);
+    res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next())
@@ -3991,7 +5099,7 @@ bool LocalStorageManagerPrivate::addEnResource(Resource & resource, ErrorString
     }
 
     error.clear();
-    res = insertOrReplaceResource(resource, error);
+    res = insertOrReplaceResource(resource, ChangeJournalEntry::ChangeType::Add, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -4103,7 +5211,7 @@ bool LocalStorageManagerPrivate::updateEnResource(Resource & resource, ErrorStri
     }
 
     error.clear();
-    res = insertOrReplaceResource(resource, error);
+    res = insertOrReplaceResource(resource, ChangeJournalEntry::ChangeType::Update, error);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         errorDescription.appendBase(error.base());
@@ -4156,673 +5264,828 @@ QString LocalStorageManagerPrivate::lastExecutedQuery(const QSqlQuery & query) c
     return str;
 }
 
+bool LocalStorageManagerPrivate::execQuery(QSqlQuery & query, const QString & queryString) const
+{
+    const bool prepared = queryString.isEmpty();
+
+    if (!m_statisticsCollector.isEnabled()) {
+        return (prepared ? query.exec() : query.exec(queryString));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool res = (prepared ? query.exec() : query.exec(queryString));
+
+    // NOTE: for selection queries this is the time taken to execute the query and step to the first row
+    // of the result; the time spent on fetching the rest of rows is accounted for in the operation's latency
+    qint64 durationUsec = timer.nsecsElapsed() / 1000;
+
+    m_statisticsCollector.recordQuery(query.lastQuery(), prepared, durationUsec, res,
+                                      (query.isSelect() ? -1 : query.numRowsAffected()));
+
+    if (res && (durationUsec >= m_statisticsCollector.slowQueryThresholdUsec()))
+    {
+        QString executedQuery = lastExecutedQuery(query);
+        QString queryPlan = explainQueryPlan(query);
+        QNINFO(QStringLiteral("Slow SQL query: ") << durationUsec << QStringLiteral(" usec: ") << executedQuery
+               << QStringLiteral("; query plan: ") << queryPlan);
+        m_statisticsCollector.recordSlowQuery(executedQuery, queryPlan, durationUsec);
+    }
+
+    return res;
+}
+
+QString LocalStorageManagerPrivate::explainQueryPlan(const QSqlQuery & query) const
+{
+    QSqlQuery explainQuery(m_sqlDatabase);
+    bool res = explainQuery.prepare(QStringLiteral("EXPLAIN QUERY PLAN ") + query.lastQuery());
+    if (!res) {
+        QNDEBUG(QStringLiteral("Can't prepare the query to explain the query plan: ") << explainQuery.lastError());
+        return QString();
+    }
+
+    QMap<QString,QVariant> boundValues = query.boundValues();
+    for(auto it = boundValues.constBegin(), end = boundValues.constEnd(); it != end; ++it) {
+        explainQuery.bindValue(it.key(), it.value());
+    }
+
+    res = explainQuery.exec();
+    if (!res) {
+        QNDEBUG(QStringLiteral("Can't explain the query plan: ") << explainQuery.lastError());
+        return QString();
+    }
+
+    QStringList queryPlanLines;
+    while(explainQuery.next())
+    {
+        QSqlRecord record = explainQuery.record();
+        int detailIndex = record.indexOf(QStringLiteral("detail"));
+        if (detailIndex >= 0) {
+            queryPlanLines << record.value(detailIndex).toString();
+        }
+    }
+
+    return queryPlanLines.join(QStringLiteral("; "));
+}
+
 bool LocalStorageManagerPrivate::createTables(ErrorString & errorDescription)
 {
     QSqlQuery query(m_sqlDatabase);
     bool res;
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Auxiliary("
-                                    "  lock                        CHAR(1) PRIMARY KEY     NOT NULL DEFAULT 'X'    CHECK (lock='X'), "
-                                    "  version                     INTEGER                 NOT NULL DEFAULT 1"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Auxiliary("
+                                          "  lock                        CHAR(1) PRIMARY KEY     NOT NULL DEFAULT 'X'    CHECK (lock='X'), "
+                                          "  version                     INTEGER                 NOT NULL DEFAULT 1"
+                                          ")"));
     ErrorString errorPrefix(QT_TR_NOOP("Can't create Auxiliary table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Users("
-                                    "  id                              INTEGER PRIMARY KEY     NOT NULL UNIQUE, "
-                                    "  username                        TEXT                    DEFAULT NULL, "
-                                    "  email                           TEXT                    DEFAULT NULL, "
-                                    "  name                            TEXT                    DEFAULT NULL, "
-                                    "  timezone                        TEXT                    DEFAULT NULL, "
-                                    "  privilege                       INTEGER                 DEFAULT NULL, "
-                                    "  serviceLevel                    INTEGER                 DEFAULT NULL, "
-                                    "  userCreationTimestamp           INTEGER                 DEFAULT NULL, "
-                                    "  userModificationTimestamp       INTEGER                 DEFAULT NULL, "
-                                    "  userIsDirty                     INTEGER                 NOT NULL, "
-                                    "  userIsLocal                     INTEGER                 NOT NULL, "
-                                    "  userDeletionTimestamp           INTEGER                 DEFAULT NULL, "
-                                    "  userIsActive                    INTEGER                 DEFAULT NULL, "
-                                    "  userShardId                     TEXT                    DEFAULT NULL, "
-                                    "  userPhotoUrl                    TEXT                    DEFAULT NULL, "
-                                    "  userPhotoLastUpdateTimestamp    INTEGER                 DEFAULT NULL"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Users("
+                                          "  id                              INTEGER PRIMARY KEY     NOT NULL UNIQUE, "
+                                          "  username                        TEXT                    DEFAULT NULL, "
+                                          "  email                           TEXT                    DEFAULT NULL, "
+                                          "  name                            TEXT                    DEFAULT NULL, "
+                                          "  timezone                        TEXT                    DEFAULT NULL, "
+                                          "  privilege                       INTEGER                 DEFAULT NULL, "
+                                          "  serviceLevel                    INTEGER                 DEFAULT NULL, "
+                                          "  userCreationTimestamp           INTEGER                 DEFAULT NULL, "
+                                          "  userModificationTimestamp       INTEGER                 DEFAULT NULL, "
+                                          "  userIsDirty                     INTEGER                 NOT NULL, "
+                                          "  userIsLocal                     INTEGER                 NOT NULL, "
+                                          "  userDeletionTimestamp           INTEGER                 DEFAULT NULL, "
+                                          "  userIsActive                    INTEGER                 DEFAULT NULL, "
+                                          "  userShardId                     TEXT                    DEFAULT NULL, "
+                                          "  userPhotoUrl                    TEXT                    DEFAULT NULL, "
+                                          "  userPhotoLastUpdateTimestamp    INTEGER                 DEFAULT NULL"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Users table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributes("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  defaultLocationName         TEXT                    DEFAULT NULL, "
-                                    "  defaultLatitude             REAL                    DEFAULT NULL, "
-                                    "  defaultLongitude            REAL                    DEFAULT NULL, "
-                                    "  preactivation               INTEGER                 DEFAULT NULL, "
-                                    "  incomingEmailAddress        TEXT                    DEFAULT NULL, "
-                                    "  comments                    TEXT                    DEFAULT NULL, "
-                                    "  dateAgreedToTermsOfService  INTEGER                 DEFAULT NULL, "
-                                    "  maxReferrals                INTEGER                 DEFAULT NULL, "
-                                    "  referralCount               INTEGER                 DEFAULT NULL, "
-                                    "  refererCode                 TEXT                    DEFAULT NULL, "
-                                    "  sentEmailDate               INTEGER                 DEFAULT NULL, "
-                                    "  sentEmailCount              INTEGER                 DEFAULT NULL, "
-                                    "  dailyEmailLimit             INTEGER                 DEFAULT NULL, "
-                                    "  emailOptOutDate             INTEGER                 DEFAULT NULL, "
-                                    "  partnerEmailOptInDate       INTEGER                 DEFAULT NULL, "
-                                    "  preferredLanguage           TEXT                    DEFAULT NULL, "
-                                    "  preferredCountry            TEXT                    DEFAULT NULL, "
-                                    "  clipFullPage                INTEGER                 DEFAULT NULL, "
-                                    "  twitterUserName             TEXT                    DEFAULT NULL, "
-                                    "  twitterId                   TEXT                    DEFAULT NULL, "
-                                    "  groupName                   TEXT                    DEFAULT NULL, "
-                                    "  recognitionLanguage         TEXT                    DEFAULT NULL, "
-                                    "  referralProof               TEXT                    DEFAULT NULL, "
-                                    "  educationalDiscount         INTEGER                 DEFAULT NULL, "
-                                    "  businessAddress             TEXT                    DEFAULT NULL, "
-                                    "  hideSponsorBilling          INTEGER                 DEFAULT NULL, "
-                                    "  useEmailAutoFiling          INTEGER                 DEFAULT NULL, "
-                                    "  reminderEmailConfig         INTEGER                 DEFAULT NULL, "
-                                    "  emailAddressLastConfirmed   INTEGER                 DEFAULT NULL, "
-                                    "  passwordUpdated             INTEGER                 DEFAULT NULL, "
-                                    "  salesforcePushEnabled       INTEGER                 DEFAULT NULL, "
-                                    "  shouldLogClientEvent        INTEGER                 DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributes("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  defaultLocationName         TEXT                    DEFAULT NULL, "
+                                          "  defaultLatitude             REAL                    DEFAULT NULL, "
+                                          "  defaultLongitude            REAL                    DEFAULT NULL, "
+                                          "  preactivation               INTEGER                 DEFAULT NULL, "
+                                          "  incomingEmailAddress        TEXT                    DEFAULT NULL, "
+                                          "  comments                    TEXT                    DEFAULT NULL, "
+                                          "  dateAgreedToTermsOfService  INTEGER                 DEFAULT NULL, "
+                                          "  maxReferrals                INTEGER                 DEFAULT NULL, "
+                                          "  referralCount               INTEGER                 DEFAULT NULL, "
+                                          "  refererCode                 TEXT                    DEFAULT NULL, "
+                                          "  sentEmailDate               INTEGER                 DEFAULT NULL, "
+                                          "  sentEmailCount              INTEGER                 DEFAULT NULL, "
+                                          "  dailyEmailLimit             INTEGER                 DEFAULT NULL, "
+                                          "  emailOptOutDate             INTEGER                 DEFAULT NULL, "
+                                          "  partnerEmailOptInDate       INTEGER                 DEFAULT NULL, "
+                                          "  preferredLanguage           TEXT                    DEFAULT NULL, "
+                                          "  preferredCountry            TEXT                    DEFAULT NULL, "
+                                          "  clipFullPage                INTEGER                 DEFAULT NULL, "
+                                          "  twitterUserName             TEXT                    DEFAULT NULL, "
+                                          "  twitterId                   TEXT                    DEFAULT NULL, "
+                                          "  groupName                   TEXT                    DEFAULT NULL, "
+                                          "  recognitionLanguage         TEXT                    DEFAULT NULL, "
+                                          "  referralProof               TEXT                    DEFAULT NULL, "
+                                          "  educationalDiscount         INTEGER                 DEFAULT NULL, "
+                                          "  businessAddress             TEXT                    DEFAULT NULL, "
+                                          "  hideSponsorBilling          INTEGER                 DEFAULT NULL, "
+                                          "  useEmailAutoFiling          INTEGER                 DEFAULT NULL, "
+                                          "  reminderEmailConfig         INTEGER                 DEFAULT NULL, "
+                                          "  emailAddressLastConfirmed   INTEGER                 DEFAULT NULL, "
+                                          "  passwordUpdated             INTEGER                 DEFAULT NULL, "
+                                          "  salesforcePushEnabled       INTEGER                 DEFAULT NULL, "
+                                          "  shouldLogClientEvent        INTEGER                 DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create UserAttributes table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributesViewedPromotions("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  promotion               TEXT                    DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributesViewedPromotions("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  promotion               TEXT                    DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create UserAttributesViewedPromotions table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributesRecentMailedAddresses("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  address                 TEXT                    DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS UserAttributesRecentMailedAddresses("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  address                 TEXT                    DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create UserAttributesRecentMailedAddresses table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Accounting("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  uploadLimitEnd              INTEGER             DEFAULT NULL, "
-                                    "  uploadLimitNextMonth        INTEGER             DEFAULT NULL, "
-                                    "  premiumServiceStatus        INTEGER             DEFAULT NULL, "
-                                    "  premiumOrderNumber          TEXT                DEFAULT NULL, "
-                                    "  premiumCommerceService      TEXT                DEFAULT NULL, "
-                                    "  premiumServiceStart         INTEGER             DEFAULT NULL, "
-                                    "  premiumServiceSKU           TEXT                DEFAULT NULL, "
-                                    "  lastSuccessfulCharge        INTEGER             DEFAULT NULL, "
-                                    "  lastFailedCharge            INTEGER             DEFAULT NULL, "
-                                    "  lastFailedChargeReason      TEXT                DEFAULT NULL, "
-                                    "  nextPaymentDue              INTEGER             DEFAULT NULL, "
-                                    "  premiumLockUntil            INTEGER             DEFAULT NULL, "
-                                    "  updated                     INTEGER             DEFAULT NULL, "
-                                    "  premiumSubscriptionNumber   TEXT                DEFAULT NULL, "
-                                    "  lastRequestedCharge         INTEGER             DEFAULT NULL, "
-                                    "  currency                    TEXT                DEFAULT NULL, "
-                                    "  unitPrice                   INTEGER             DEFAULT NULL, "
-                                    "  unitDiscount                INTEGER             DEFAULT NULL, "
-                                    "  nextChargeDate              INTEGER             DEFAULT NULL, "
-                                    "  availablePoints             INTEGER             DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Accounting("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  uploadLimitEnd              INTEGER             DEFAULT NULL, "
+                                          "  uploadLimitNextMonth        INTEGER             DEFAULT NULL, "
+                                          "  premiumServiceStatus        INTEGER             DEFAULT NULL, "
+                                          "  premiumOrderNumber          TEXT                DEFAULT NULL, "
+                                          "  premiumCommerceService      TEXT                DEFAULT NULL, "
+                                          "  premiumServiceStart         INTEGER             DEFAULT NULL, "
+                                          "  premiumServiceSKU           TEXT                DEFAULT NULL, "
+                                          "  lastSuccessfulCharge        INTEGER             DEFAULT NULL, "
+                                          "  lastFailedCharge            INTEGER             DEFAULT NULL, "
+                                          "  lastFailedChargeReason      TEXT                DEFAULT NULL, "
+                                          "  nextPaymentDue              INTEGER             DEFAULT NULL, "
+                                          "  premiumLockUntil            INTEGER             DEFAULT NULL, "
+                                          "  updated                     INTEGER             DEFAULT NULL, "
+                                          "  premiumSubscriptionNumber   TEXT                DEFAULT NULL, "
+                                          "  lastRequestedCharge         INTEGER             DEFAULT NULL, "
+                                          "  currency                    TEXT                DEFAULT NULL, "
+                                          "  unitPrice                   INTEGER             DEFAULT NULL, "
+                                          "  unitDiscount                INTEGER             DEFAULT NULL, "
+                                          "  nextChargeDate              INTEGER             DEFAULT NULL, "
+                                          "  availablePoints             INTEGER             DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Accounting table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS AccountLimits("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  userMailLimitDaily          INTEGER             DEFAULT NULL, "
-                                    "  noteSizeMax                 INTEGER             DEFAULT NULL, "
-                                    "  resourceSizeMax             INTEGER             DEFAULT NULL, "
-                                    "  userLinkedNotebookMax       INTEGER             DEFAULT NULL, "
-                                    "  uploadLimit                 INTEGER             DEFAULT NULL, "
-                                    "  userNoteCountMax            INTEGER             DEFAULT NULL, "
-                                    "  userNotebookCountMax        INTEGER             DEFAULT NULL, "
-                                    "  userTagCountMax             INTEGER             DEFAULT NULL, "
-                                    "  noteTagCountMax             INTEGER             DEFAULT NULL, "
-                                    "  userSavedSearchesMax        INTEGER             DEFAULT NULL, "
-                                    "  noteResourceCountMax        INTEGER             DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS AccountLimits("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  userMailLimitDaily          INTEGER             DEFAULT NULL, "
+                                          "  noteSizeMax                 INTEGER             DEFAULT NULL, "
+                                          "  resourceSizeMax             INTEGER             DEFAULT NULL, "
+                                          "  userLinkedNotebookMax       INTEGER             DEFAULT NULL, "
+                                          "  uploadLimit                 INTEGER             DEFAULT NULL, "
+                                          "  userNoteCountMax            INTEGER             DEFAULT NULL, "
+                                          "  userNotebookCountMax        INTEGER             DEFAULT NULL, "
+                                          "  userTagCountMax             INTEGER             DEFAULT NULL, "
+                                          "  noteTagCountMax             INTEGER             DEFAULT NULL, "
+                                          "  userSavedSearchesMax        INTEGER             DEFAULT NULL, "
+                                          "  noteResourceCountMax        INTEGER             DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create AccountLimits table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS BusinessUserInfo("
-                                    "  id REFERENCES Users(id) ON UPDATE CASCADE, "
-                                    "  businessId              INTEGER                 DEFAULT NULL, "
-                                    "  businessName            TEXT                    DEFAULT NULL, "
-                                    "  role                    INTEGER                 DEFAULT NULL, "
-                                    "  businessInfoEmail       TEXT                    DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS BusinessUserInfo("
+                                          "  id REFERENCES Users(id) ON UPDATE CASCADE, "
+                                          "  businessId              INTEGER                 DEFAULT NULL, "
+                                          "  businessName            TEXT                    DEFAULT NULL, "
+                                          "  role                    INTEGER                 DEFAULT NULL, "
+                                          "  businessInfoEmail       TEXT                    DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create BusinessUserInfo table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_user_delete_trigger "
-                                    "BEFORE DELETE ON Users "
-                                    "BEGIN "
-                                    "DELETE FROM UserAttributes WHERE id=OLD.id; "
-                                    "DELETE FROM UserAttributesViewedPromotions WHERE id=OLD.id; "
-                                    "DELETE FROM UserAttributesRecentMailedAddresses WHERE id=OLD.id; "
-                                    "DELETE FROM Accounting WHERE id=OLD.id; "
-                                    "DELETE FROM AccountLimits WHERE id=OLD.id; "
-                                    "DELETE FROM BusinessUserInfo WHERE id=OLD.id; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_user_delete_trigger "
+                                          "BEFORE DELETE ON Users "
+                                          "BEGIN "
+                                          "DELETE FROM UserAttributes WHERE id=OLD.id; "
+                                          "DELETE FROM UserAttributesViewedPromotions WHERE id=OLD.id; "
+                                          "DELETE FROM UserAttributesRecentMailedAddresses WHERE id=OLD.id; "
+                                          "DELETE FROM Accounting WHERE id=OLD.id; "
+                                          "DELETE FROM AccountLimits WHERE id=OLD.id; "
+                                          "DELETE FROM BusinessUserInfo WHERE id=OLD.id; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on deletion from users table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS LinkedNotebooks("
-                                    "  guid                            TEXT PRIMARY KEY  NOT NULL UNIQUE, "
-                                    "  updateSequenceNumber            INTEGER           DEFAULT NULL, "
-                                    "  isDirty                         INTEGER           DEFAULT NULL, "
-                                    "  shareName                       TEXT              DEFAULT NULL, "
-                                    "  username                        TEXT              DEFAULT NULL, "
-                                    "  shardId                         TEXT              DEFAULT NULL, "
-                                    "  sharedNotebookGlobalId          TEXT              DEFAULT NULL, "
-                                    "  uri                             TEXT              DEFAULT NULL, "
-                                    "  noteStoreUrl                    TEXT              DEFAULT NULL, "
-                                    "  webApiUrlPrefix                 TEXT              DEFAULT NULL, "
-                                    "  stack                           TEXT              DEFAULT NULL, "
-                                    "  businessId                      INTEGER           DEFAULT NULL"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS LinkedNotebooks("
+                                          "  guid                            TEXT PRIMARY KEY  NOT NULL UNIQUE, "
+                                          "  updateSequenceNumber            INTEGER           DEFAULT NULL, "
+                                          "  isDirty                         INTEGER           DEFAULT NULL, "
+                                          "  shareName                       TEXT              DEFAULT NULL, "
+                                          "  username                        TEXT              DEFAULT NULL, "
+                                          "  shardId                         TEXT              DEFAULT NULL, "
+                                          "  sharedNotebookGlobalId          TEXT              DEFAULT NULL, "
+                                          "  uri                             TEXT              DEFAULT NULL, "
+                                          "  noteStoreUrl                    TEXT              DEFAULT NULL, "
+                                          "  webApiUrlPrefix                 TEXT              DEFAULT NULL, "
+                                          "  stack                           TEXT              DEFAULT NULL, "
+                                          "  businessId                      INTEGER           DEFAULT NULL"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create LinkedNotebooks table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Notebooks("
-                                    "  localUid                        TEXT PRIMARY KEY  NOT NULL UNIQUE, "
-                                    "  guid                            TEXT              DEFAULT NULL UNIQUE, "
-                                    "  linkedNotebookGuid REFERENCES LinkedNotebooks(guid) ON UPDATE CASCADE, "
-                                    "  updateSequenceNumber            INTEGER           DEFAULT NULL, "
-                                    "  notebookName                    TEXT              DEFAULT NULL, "
-                                    "  notebookNameUpper               TEXT              DEFAULT NULL, "
-                                    "  creationTimestamp               INTEGER           DEFAULT NULL, "
-                                    "  modificationTimestamp           INTEGER           DEFAULT NULL, "
-                                    "  isDirty                         INTEGER           NOT NULL, "
-                                    "  isLocal                         INTEGER           NOT NULL, "
-                                    "  isDefault                       INTEGER           DEFAULT NULL UNIQUE, "
-                                    "  isLastUsed                      INTEGER           DEFAULT NULL UNIQUE, "
-                                    "  isFavorited                     INTEGER           DEFAULT NULL, "
-                                    "  publishingUri                   TEXT              DEFAULT NULL, "
-                                    "  publishingNoteSortOrder         INTEGER           DEFAULT NULL, "
-                                    "  publishingAscendingSort         INTEGER           DEFAULT NULL, "
-                                    "  publicDescription               TEXT              DEFAULT NULL, "
-                                    "  isPublished                     INTEGER           DEFAULT NULL, "
-                                    "  stack                           TEXT              DEFAULT NULL, "
-                                    "  businessNotebookDescription     TEXT              DEFAULT NULL, "
-                                    "  businessNotebookPrivilegeLevel  INTEGER           DEFAULT NULL, "
-                                    "  businessNotebookIsRecommended   INTEGER           DEFAULT NULL, "
-                                    "  contactId                       INTEGER           DEFAULT NULL, "
-                                    "  recipientReminderNotifyEmail    INTEGER           DEFAULT NULL, "
-                                    "  recipientReminderNotifyInApp    INTEGER           DEFAULT NULL, "
-                                    "  recipientInMyList               INTEGER           DEFAULT NULL, "
-                                    "  recipientStack                  TEXT              DEFAULT NULL, "
-                                    "  UNIQUE(localUid, guid), "
-                                    "  UNIQUE(notebookNameUpper, linkedNotebookGuid) "
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Notebooks("
+                                          "  localUid                        TEXT PRIMARY KEY  NOT NULL UNIQUE, "
+                                          "  guid                            TEXT              DEFAULT NULL UNIQUE, "
+                                          "  linkedNotebookGuid REFERENCES LinkedNotebooks(guid) ON UPDATE CASCADE, "
+                                          "  updateSequenceNumber            INTEGER           DEFAULT NULL, "
+                                          "  notebookName                    TEXT              DEFAULT NULL, "
+                                          "  notebookNameUpper               TEXT              DEFAULT NULL, "
+                                          "  creationTimestamp               INTEGER           DEFAULT NULL, "
+                                          "  modificationTimestamp           INTEGER           DEFAULT NULL, "
+                                          "  isDirty                         INTEGER           NOT NULL, "
+                                          "  isLocal                         INTEGER           NOT NULL, "
+                                          "  isDefault                       INTEGER           DEFAULT NULL UNIQUE, "
+                                          "  isLastUsed                      INTEGER           DEFAULT NULL UNIQUE, "
+                                          "  isFavorited                     INTEGER           DEFAULT NULL, "
+                                          "  publishingUri                   TEXT              DEFAULT NULL, "
+                                          "  publishingNoteSortOrder         INTEGER           DEFAULT NULL, "
+                                          "  publishingAscendingSort         INTEGER           DEFAULT NULL, "
+                                          "  publicDescription               TEXT              DEFAULT NULL, "
+                                          "  isPublished                     INTEGER           DEFAULT NULL, "
+                                          "  stack                           TEXT              DEFAULT NULL, "
+                                          "  businessNotebookDescription     TEXT              DEFAULT NULL, "
+                                          "  businessNotebookPrivilegeLevel  INTEGER           DEFAULT NULL, "
+                                          "  businessNotebookIsRecommended   INTEGER           DEFAULT NULL, "
+                                          "  contactId                       INTEGER           DEFAULT NULL, "
+                                          "  recipientReminderNotifyEmail    INTEGER           DEFAULT NULL, "
+                                          "  recipientReminderNotifyInApp    INTEGER           DEFAULT NULL, "
+                                          "  recipientInMyList               INTEGER           DEFAULT NULL, "
+                                          "  recipientStack                  TEXT              DEFAULT NULL, "
+                                          "  UNIQUE(localUid, guid), "
+                                          "  UNIQUE(notebookNameUpper, linkedNotebookGuid) "
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Notebooks table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS NotebookFTS USING FTS4(content=\"Notebooks\", "
-                                    "localUid, guid, notebookName)"));
+    res = execQuery(query, QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS NotebookFTS USING FTS4(content=\"Notebooks\", "
+                                          "localUid, guid, notebookName)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create virtual FTS4 NotebookFTS table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS NotebookFTS_BeforeDeleteTrigger BEFORE DELETE ON Notebooks "
-                                    "BEGIN "
-                                    "DELETE FROM NotebookFTS WHERE localUid=old.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS NotebookFTS_BeforeDeleteTrigger BEFORE DELETE ON Notebooks "
+                                          "BEGIN "
+                                          "DELETE FROM NotebookFTS WHERE localUid=old.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NotebookFTS_BeforeDeleteTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS NotebookFTS_AfterInsertTrigger AFTER INSERT ON Notebooks "
-                                    "BEGIN "
-                                    "INSERT INTO NotebookFTS(NotebookFTS) VALUES('rebuild'); "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS NotebookFTS_AfterInsertTrigger AFTER INSERT ON Notebooks "
+                                          "BEGIN "
+                                          "INSERT INTO NotebookFTS(NotebookFTS) VALUES('rebuild'); "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NotebookFTS_AfterInsertTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS NotebookRestrictions("
-                                    "  localUid REFERENCES Notebooks(localUid) ON UPDATE CASCADE, "
-                                    "  noReadNotes                 INTEGER      DEFAULT NULL, "
-                                    "  noCreateNotes               INTEGER      DEFAULT NULL, "
-                                    "  noUpdateNotes               INTEGER      DEFAULT NULL, "
-                                    "  noExpungeNotes              INTEGER      DEFAULT NULL, "
-                                    "  noShareNotes                INTEGER      DEFAULT NULL, "
-                                    "  noEmailNotes                INTEGER      DEFAULT NULL, "
-                                    "  noSendMessageToRecipients   INTEGER      DEFAULT NULL, "
-                                    "  noUpdateNotebook            INTEGER      DEFAULT NULL, "
-                                    "  noExpungeNotebook           INTEGER      DEFAULT NULL, "
-                                    "  noSetDefaultNotebook        INTEGER      DEFAULT NULL, "
-                                    "  noSetNotebookStack          INTEGER      DEFAULT NULL, "
-                                    "  noPublishToPublic           INTEGER      DEFAULT NULL, "
-                                    "  noPublishToBusinessLibrary  INTEGER      DEFAULT NULL, "
-                                    "  noCreateTags                INTEGER      DEFAULT NULL, "
-                                    "  noUpdateTags                INTEGER      DEFAULT NULL, "
-                                    "  noExpungeTags               INTEGER      DEFAULT NULL, "
-                                    "  noSetParentTag              INTEGER      DEFAULT NULL, "
-                                    "  noCreateSharedNotebooks     INTEGER      DEFAULT NULL, "
-                                    "  noShareNotesWithBusiness    INTEGER      DEFAULT NULL, "
-                                    "  noRenameNotebook            INTEGER      DEFAULT NULL, "
-                                    "  updateWhichSharedNotebookRestrictions    INTEGER     DEFAULT NULL, "
-                                    "  expungeWhichSharedNotebookRestrictions   INTEGER     DEFAULT NULL "
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS NotebookRestrictions("
+                                          "  localUid REFERENCES Notebooks(localUid) ON UPDATE CASCADE, "
+                                          "  noReadNotes                 INTEGER      DEFAULT NULL, "
+                                          "  noCreateNotes               INTEGER      DEFAULT NULL, "
+                                          "  noUpdateNotes               INTEGER      DEFAULT NULL, "
+                                          "  noExpungeNotes              INTEGER      DEFAULT NULL, "
+                                          "  noShareNotes                INTEGER      DEFAULT NULL, "
+                                          "  noEmailNotes                INTEGER      DEFAULT NULL, "
+                                          "  noSendMessageToRecipients   INTEGER      DEFAULT NULL, "
+                                          "  noUpdateNotebook            INTEGER      DEFAULT NULL, "
+                                          "  noExpungeNotebook           INTEGER      DEFAULT NULL, "
+                                          "  noSetDefaultNotebook        INTEGER      DEFAULT NULL, "
+                                          "  noSetNotebookStack          INTEGER      DEFAULT NULL, "
+                                          "  noPublishToPublic           INTEGER      DEFAULT NULL, "
+                                          "  noPublishToBusinessLibrary  INTEGER      DEFAULT NULL, "
+                                          "  noCreateTags                INTEGER      DEFAULT NULL, "
+                                          "  noUpdateTags                INTEGER      DEFAULT NULL, "
+                                          "  noExpungeTags               INTEGER      DEFAULT NULL, "
+                                          "  noSetParentTag              INTEGER      DEFAULT NULL, "
+                                          "  noCreateSharedNotebooks     INTEGER      DEFAULT NULL, "
+                                          "  noShareNotesWithBusiness    INTEGER      DEFAULT NULL, "
+                                          "  noRenameNotebook            INTEGER      DEFAULT NULL, "
+                                          "  updateWhichSharedNotebookRestrictions    INTEGER     DEFAULT NULL, "
+                                          "  expungeWhichSharedNotebookRestrictions   INTEGER     DEFAULT NULL "
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NotebookRestrictions table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS SharedNotebooks("
-                                    "  sharedNotebookShareId                             INTEGER PRIMARY KEY   NOT NULL UNIQUE, "
-                                    "  sharedNotebookUserId                              INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookNotebookGuid REFERENCES Notebooks(guid) ON UPDATE CASCADE, "
-                                    "  sharedNotebookEmail                               TEXT       DEFAULT NULL, "
-                                    "  sharedNotebookIdentityId                          INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookCreationTimestamp                   INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookModificationTimestamp               INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookGlobalId                            TEXT       DEFAULT NULL, "
-                                    "  sharedNotebookUsername                            TEXT       DEFAULT NULL, "
-                                    "  sharedNotebookPrivilegeLevel                      INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookRecipientReminderNotifyEmail        INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookRecipientReminderNotifyInApp        INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookSharerUserId                        INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookRecipientUsername                   TEXT       DEFAULT NULL, "
-                                    "  sharedNotebookRecipientUserId                     INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookRecipientIdentityId                 INTEGER    DEFAULT NULL, "
-                                    "  sharedNotebookAssignmentTimestamp                 INTEGER    DEFAULT NULL, "
-                                    "  indexInNotebook                                   INTEGER    DEFAULT NULL, "
-                                    "  UNIQUE(sharedNotebookShareId, sharedNotebookNotebookGuid) ON CONFLICT REPLACE"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS SharedNotebooks("
+                                          "  sharedNotebookShareId                             INTEGER PRIMARY KEY   NOT NULL UNIQUE, "
+                                          "  sharedNotebookUserId                              INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookNotebookGuid REFERENCES Notebooks(guid) ON UPDATE CASCADE, "
+                                          "  sharedNotebookEmail                               TEXT       DEFAULT NULL, "
+                                          "  sharedNotebookIdentityId                          INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookCreationTimestamp                   INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookModificationTimestamp               INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookGlobalId                            TEXT       DEFAULT NULL, "
+                                          "  sharedNotebookUsername                            TEXT       DEFAULT NULL, "
+                                          "  sharedNotebookPrivilegeLevel                      INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookRecipientReminderNotifyEmail        INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookRecipientReminderNotifyInApp        INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookSharerUserId                        INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookRecipientUsername                   TEXT       DEFAULT NULL, "
+                                          "  sharedNotebookRecipientUserId                     INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookRecipientIdentityId                 INTEGER    DEFAULT NULL, "
+                                          "  sharedNotebookAssignmentTimestamp                 INTEGER    DEFAULT NULL, "
+                                          "  indexInNotebook                                   INTEGER    DEFAULT NULL, "
+                                          "  UNIQUE(sharedNotebookShareId, sharedNotebookNotebookGuid) ON CONFLICT REPLACE"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create SharedNotebooks table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Notes("
-                                    "  localUid                        TEXT PRIMARY KEY     NOT NULL UNIQUE, "
-                                    "  guid                            TEXT                 DEFAULT NULL UNIQUE, "
-                                    "  updateSequenceNumber            INTEGER              DEFAULT NULL, "
-                                    "  isDirty                         INTEGER              NOT NULL, "
-                                    "  isLocal                         INTEGER              NOT NULL, "
-                                    "  isFavorited                     INTEGER              NOT NULL, "
-                                    "  title                           TEXT                 DEFAULT NULL, "
-                                    "  titleNormalized                 TEXT                 DEFAULT NULL, "
-                                    "  content                         TEXT                 DEFAULT NULL, "
-                                    "  contentLength                   INTEGER              DEFAULT NULL, "
-                                    "  contentHash                     TEXT                 DEFAULT NULL, "
-                                    "  contentPlainText                TEXT                 DEFAULT NULL, "
-                                    "  contentListOfWords              TEXT                 DEFAULT NULL, "
-                                    "  contentContainsFinishedToDo     INTEGER              DEFAULT NULL, "
-                                    "  contentContainsUnfinishedToDo   INTEGER              DEFAULT NULL, "
-                                    "  contentContainsEncryption       INTEGER              DEFAULT NULL, "
-                                    "  creationTimestamp               INTEGER              DEFAULT NULL, "
-                                    "  modificationTimestamp           INTEGER              DEFAULT NULL, "
-                                    "  deletionTimestamp               INTEGER              DEFAULT NULL, "
-                                    "  isActive                        INTEGER              DEFAULT NULL, "
-                                    "  hasAttributes                   INTEGER              NOT NULL, "
-                                    "  thumbnail                       BLOB                 DEFAULT NULL, "
-                                    "  notebookLocalUid REFERENCES Notebooks(localUid) ON UPDATE CASCADE, "
-                                    "  notebookGuid REFERENCES Notebooks(guid) ON UPDATE CASCADE, "
-                                    "  subjectDate                     INTEGER              DEFAULT NULL, "
-                                    "  latitude                        REAL                 DEFAULT NULL, "
-                                    "  longitude                       REAL                 DEFAULT NULL, "
-                                    "  altitude                        REAL                 DEFAULT NULL, "
-                                    "  author                          TEXT                 DEFAULT NULL, "
-                                    "  source                          TEXT                 DEFAULT NULL, "
-                                    "  sourceURL                       TEXT                 DEFAULT NULL, "
-                                    "  sourceApplication               TEXT                 DEFAULT NULL, "
-                                    "  shareDate                       INTEGER              DEFAULT NULL, "
-                                    "  reminderOrder                   INTEGER              DEFAULT NULL, "
-                                    "  reminderDoneTime                INTEGER              DEFAULT NULL, "
-                                    "  reminderTime                    INTEGER              DEFAULT NULL, "
-                                    "  placeName                       TEXT                 DEFAULT NULL, "
-                                    "  contentClass                    TEXT                 DEFAULT NULL, "
-                                    "  lastEditedBy                    TEXT                 DEFAULT NULL, "
-                                    "  creatorId                       INTEGER              DEFAULT NULL, "
-                                    "  lastEditorId                    INTEGER              DEFAULT NULL, "
-                                    "  sharedWithBusiness              INTEGER              DEFAULT NULL, "
-                                    "  conflictSourceNoteGuid          TEXT                 DEFAULT NULL, "
-                                    "  noteTitleQuality                INTEGER              DEFAULT NULL, "
-                                    "  applicationDataKeysOnly         TEXT                 DEFAULT NULL, "
-                                    "  applicationDataKeysMap          TEXT                 DEFAULT NULL, "
-                                    "  applicationDataValues           TEXT                 DEFAULT NULL, "
-                                    "  classificationKeys              TEXT                 DEFAULT NULL, "
-                                    "  classificationValues            TEXT                 DEFAULT NULL, "
-                                    "  UNIQUE(localUid, guid)"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Notes("
+                                          "  localUid                        TEXT PRIMARY KEY     NOT NULL UNIQUE, "
+                                          "  guid                            TEXT                 DEFAULT NULL UNIQUE, "
+                                          "  updateSequenceNumber            INTEGER              DEFAULT NULL, "
+                                          "  isDirty                         INTEGER              NOT NULL, "
+                                          "  isLocal                         INTEGER              NOT NULL, "
+                                          "  isFavorited                     INTEGER              NOT NULL, "
+                                          "  title                           TEXT                 DEFAULT NULL, "
+                                          "  titleNormalized                 TEXT                 DEFAULT NULL, "
+                                          "  content                         TEXT                 DEFAULT NULL, "
+                                          "  contentLength                   INTEGER              DEFAULT NULL, "
+                                          "  contentHash                     TEXT                 DEFAULT NULL, "
+                                          "  contentPlainText                TEXT                 DEFAULT NULL, "
+                                          "  contentListOfWords              TEXT                 DEFAULT NULL, "
+                                          "  contentContainsFinishedToDo     INTEGER              DEFAULT NULL, "
+                                          "  contentContainsUnfinishedToDo   INTEGER              DEFAULT NULL, "
+                                          "  contentContainsEncryption       INTEGER              DEFAULT NULL, "
+                                          "  creationTimestamp               INTEGER              DEFAULT NULL, "
+                                          "  modificationTimestamp           INTEGER              DEFAULT NULL, "
+                                          "  deletionTimestamp               INTEGER              DEFAULT NULL, "
+                                          "  isActive                        INTEGER              DEFAULT NULL, "
+                                          "  hasAttributes                   INTEGER              NOT NULL, "
+                                          "  thumbnail                       BLOB                 DEFAULT NULL, "
+                                          "  notebookLocalUid REFERENCES Notebooks(localUid) ON UPDATE CASCADE, "
+                                          "  notebookGuid REFERENCES Notebooks(guid) ON UPDATE CASCADE, "
+                                          "  subjectDate                     INTEGER              DEFAULT NULL, "
+                                          "  latitude                        REAL                 DEFAULT NULL, "
+                                          "  longitude                       REAL                 DEFAULT NULL, "
+                                          "  altitude                        REAL                 DEFAULT NULL, "
+                                          "  author                          TEXT                 DEFAULT NULL, "
+                                          "  source                          TEXT                 DEFAULT NULL, "
+                                          "  sourceURL                       TEXT                 DEFAULT NULL, "
+                                          "  sourceApplication               TEXT                 DEFAULT NULL, "
+                                          "  shareDate                       INTEGER              DEFAULT NULL, "
+                                          "  reminderOrder                   INTEGER              DEFAULT NULL, "
+                                          "  reminderDoneTime                INTEGER              DEFAULT NULL, "
+                                          "  reminderTime                    INTEGER              DEFAULT NULL, "
+                                          "  placeName                       TEXT                 DEFAULT NULL, "
+                                          "  contentClass                    TEXT                 DEFAULT NULL, "
+                                          "  lastEditedBy                    TEXT                 DEFAULT NULL, "
+                                          "  creatorId                       INTEGER              DEFAULT NULL, "
+                                          "  lastEditorId                    INTEGER              DEFAULT NULL, "
+                                          "  sharedWithBusiness              INTEGER              DEFAULT NULL, "
+                                          "  conflictSourceNoteGuid          TEXT                 DEFAULT NULL, "
+                                          "  noteTitleQuality                INTEGER              DEFAULT NULL, "
+                                          "  applicationDataKeysOnly         TEXT                 DEFAULT NULL, "
+                                          "  applicationDataKeysMap          TEXT                 DEFAULT NULL, "
+                                          "  applicationDataValues           TEXT                 DEFAULT NULL, "
+                                          "  classificationKeys              TEXT                 DEFAULT NULL, "
+                                          "  classificationValues            TEXT                 DEFAULT NULL, "
+                                          "  UNIQUE(localUid, guid)"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Notes table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS SharedNotes("
-                                    "  sharedNoteNoteGuid REFERENCES Notes(guid) ON UPDATE CASCADE, "
-                                    "  sharedNoteSharerUserId                               INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientIdentityId                        INTEGER     DEFAULT NULL UNIQUE, "
-                                    "  sharedNoteRecipientContactName                       TEXT        DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactId                         TEXT        DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactType                       INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactPhotoUrl                   TEXT        DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactPhotoLastUpdated           INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactMessagingPermit            BLOB        DEFAULT NULL, "
-                                    "  sharedNoteRecipientContactMessagingPermitExpires     INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientUserId                            INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientDeactivated                       INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientSameBusiness                      INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientBlocked                           INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientUserConnected                     INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteRecipientEventId                           INTEGER     DEFAULT NULL, "
-                                    "  sharedNotePrivilegeLevel                             INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteCreationTimestamp                          INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteModificationTimestamp                      INTEGER     DEFAULT NULL, "
-                                    "  sharedNoteAssignmentTimestamp                        INTEGER     DEFAULT NULL, "
-                                    "  indexInNote                                          INTEGER     DEFAULT NULL, "
-                                    "  UNIQUE(sharedNoteNoteGuid, sharedNoteRecipientIdentityId) ON CONFLICT REPLACE)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS SharedNotes("
+                                          "  sharedNoteNoteGuid REFERENCES Notes(guid) ON UPDATE CASCADE, "
+                                          "  sharedNoteSharerUserId                               INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientIdentityId                        INTEGER     DEFAULT NULL UNIQUE, "
+                                          "  sharedNoteRecipientContactName                       TEXT        DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactId                         TEXT        DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactType                       INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactPhotoUrl                   TEXT        DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactPhotoLastUpdated           INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactMessagingPermit            BLOB        DEFAULT NULL, "
+                                          "  sharedNoteRecipientContactMessagingPermitExpires     INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientUserId                            INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientDeactivated                       INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientSameBusiness                      INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientBlocked                           INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientUserConnected                     INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteRecipientEventId                           INTEGER     DEFAULT NULL, "
+                                          "  sharedNotePrivilegeLevel                             INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteCreationTimestamp                          INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteModificationTimestamp                      INTEGER     DEFAULT NULL, "
+                                          "  sharedNoteAssignmentTimestamp                        INTEGER     DEFAULT NULL, "
+                                          "  indexInNote                                          INTEGER     DEFAULT NULL, "
+                                          "  UNIQUE(sharedNoteNoteGuid, sharedNoteRecipientIdentityId) ON CONFLICT REPLACE)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create SharedNotes table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS NoteRestrictions("
-                                    "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
-                                    "  noUpdateNoteTitle                INTEGER             DEFAULT NULL, "
-                                    "  noUpdateNoteContent              INTEGER             DEFAULT NULL, "
-                                    "  noEmailNote                      INTEGER             DEFAULT NULL, "
-                                    "  noShareNote                      INTEGER             DEFAULT NULL, "
-                                    "  noShareNotePublicly              INTEGER             DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS NoteRestrictions("
+                                          "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
+                                          "  noUpdateNoteTitle                INTEGER             DEFAULT NULL, "
+                                          "  noUpdateNoteContent              INTEGER             DEFAULT NULL, "
+                                          "  noEmailNote                      INTEGER             DEFAULT NULL, "
+                                          "  noShareNote                      INTEGER             DEFAULT NULL, "
+                                          "  noShareNotePublicly              INTEGER             DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteRestrictions table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS NoteLimits("
-                                    "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
-                                    "  noteResourceCountMax             INTEGER             DEFAULT NULL, "
-                                    "  uploadLimit                      INTEGER             DEFAULT NULL, "
-                                    "  resourceSizeMax                  INTEGER             DEFAULT NULL, "
-                                    "  noteSizeMax                      INTEGER             DEFAULT NULL, "
-                                    "  uploaded                         INTEGER             DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS NoteLimits("
+                                          "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
+                                          "  noteResourceCountMax             INTEGER             DEFAULT NULL, "
+                                          "  uploadLimit                      INTEGER             DEFAULT NULL, "
+                                          "  resourceSizeMax                  INTEGER             DEFAULT NULL, "
+                                          "  noteSizeMax                      INTEGER             DEFAULT NULL, "
+                                          "  uploaded                         INTEGER             DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteLimits table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS NotesNotebooks ON Notes(notebookLocalUid)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS NotesNotebooks ON Notes(notebookLocalUid)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create index NotesNotebooks"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS NoteFTS USING FTS4(content=\"Notes\", localUid, titleNormalized, "
-                                    "contentListOfWords, contentContainsFinishedToDo, contentContainsUnfinishedToDo, "
-                                    "contentContainsEncryption, creationTimestamp, modificationTimestamp, "
-                                    "isActive, notebookLocalUid, notebookGuid, subjectDate, latitude, longitude, "
-                                    "altitude, author, source, sourceApplication, reminderOrder, reminderDoneTime, "
-                                    "reminderTime, placeName, contentClass, applicationDataKeysOnly, "
-                                    "applicationDataKeysMap, applicationDataValues)"));
+    res = execQuery(query, QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS NoteFTS USING FTS4(content=\"Notes\", localUid, titleNormalized, "
+                                          "contentListOfWords, contentContainsFinishedToDo, contentContainsUnfinishedToDo, "
+                                          "contentContainsEncryption, creationTimestamp, modificationTimestamp, "
+                                          "isActive, notebookLocalUid, notebookGuid, subjectDate, latitude, longitude, "
+                                          "altitude, author, source, sourceApplication, reminderOrder, reminderDoneTime, "
+                                          "reminderTime, placeName, contentClass, applicationDataKeysOnly, "
+                                          "applicationDataKeysMap, applicationDataValues)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create virtual FTS4 table NoteFTS"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS NoteFTS_BeforeDeleteTrigger BEFORE DELETE ON Notes "
-                                    "BEGIN "
-                                    "DELETE FROM NoteFTS WHERE localUid=old.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS NoteFTS_BeforeDeleteTrigger BEFORE DELETE ON Notes "
+                                          "BEGIN "
+                                          "DELETE FROM NoteFTS WHERE localUid=old.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger NoteFTS_BeforeDeleteTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS NoteFTS_AfterInsertTrigger AFTER INSERT ON Notes "
-                                    "BEGIN "
-                                    "INSERT INTO NoteFTS(NoteFTS) VALUES('rebuild'); "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS NoteFTS_AfterInsertTrigger AFTER INSERT ON Notes "
+                                          "BEGIN "
+                                          "INSERT INTO NoteFTS(NoteFTS) VALUES('rebuild'); "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger NoteFTS_AfterInsertTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_notebook_delete_trigger BEFORE DELETE ON Notebooks "
-                                    "BEGIN "
-                                    "DELETE FROM NotebookRestrictions WHERE NotebookRestrictions.localUid=OLD.localUid; "
-                                    "DELETE FROM SharedNotebooks WHERE SharedNotebooks.sharedNotebookNotebookGuid=OLD.guid; "
-                                    "DELETE FROM Notes WHERE Notes.notebookLocalUid=OLD.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_notebook_delete_trigger BEFORE DELETE ON Notebooks "
+                                          "BEGIN "
+                                          "DELETE FROM NotebookRestrictions WHERE NotebookRestrictions.localUid=OLD.localUid; "
+                                          "DELETE FROM SharedNotebooks WHERE SharedNotebooks.sharedNotebookNotebookGuid=OLD.guid; "
+                                          "DELETE FROM Notes WHERE Notes.notebookLocalUid=OLD.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on notebook deletion"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Resources("
-                                    "  resourceLocalUid                TEXT PRIMARY KEY     NOT NULL UNIQUE, "
-                                    "  resourceGuid                    TEXT                 DEFAULT NULL UNIQUE, "
-                                    "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
-                                    "  noteGuid REFERENCES Notes(guid) ON UPDATE CASCADE, "
-                                    "  resourceUpdateSequenceNumber    INTEGER              DEFAULT NULL, "
-                                    "  resourceIsDirty                 INTEGER              NOT NULL, "
-                                    "  dataBody                        TEXT                 DEFAULT NULL, "
-                                    "  dataSize                        INTEGER              DEFAULT NULL, "
-                                    "  dataHash                        TEXT                 DEFAULT NULL, "
-                                    "  mime                            TEXT                 DEFAULT NULL, "
-                                    "  width                           INTEGER              DEFAULT NULL, "
-                                    "  height                          INTEGER              DEFAULT NULL, "
-                                    "  recognitionDataBody             TEXT                 DEFAULT NULL, "
-                                    "  recognitionDataSize             INTEGER              DEFAULT NULL, "
-                                    "  recognitionDataHash             TEXT                 DEFAULT NULL, "
-                                    "  alternateDataBody               TEXT                 DEFAULT NULL, "
-                                    "  alternateDataSize               INTEGER              DEFAULT NULL, "
-                                    "  alternateDataHash               TEXT                 DEFAULT NULL, "
-                                    "  resourceIndexInNote             INTEGER              DEFAULT NULL, "
-                                    "  UNIQUE(resourceLocalUid, resourceGuid)"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Resources("
+                                          "  resourceLocalUid                TEXT PRIMARY KEY     NOT NULL UNIQUE, "
+                                          "  resourceGuid                    TEXT                 DEFAULT NULL UNIQUE, "
+                                          "  noteLocalUid REFERENCES Notes(localUid) ON UPDATE CASCADE, "
+                                          "  noteGuid REFERENCES Notes(guid) ON UPDATE CASCADE, "
+                                          "  resourceUpdateSequenceNumber    INTEGER              DEFAULT NULL, "
+                                          "  resourceIsDirty                 INTEGER              NOT NULL, "
+                                          "  dataBody                        TEXT                 DEFAULT NULL, "
+                                          "  dataSize                        INTEGER              DEFAULT NULL, "
+                                          "  dataHash                        TEXT                 DEFAULT NULL, "
+                                          "  mime                            TEXT                 DEFAULT NULL, "
+                                          "  width                           INTEGER              DEFAULT NULL, "
+                                          "  height                          INTEGER              DEFAULT NULL, "
+                                          "  recognitionDataBody             TEXT                 DEFAULT NULL, "
+                                          "  recognitionDataSize             INTEGER              DEFAULT NULL, "
+                                          "  recognitionDataHash             TEXT                 DEFAULT NULL, "
+                                          "  alternateDataBody               TEXT                 DEFAULT NULL, "
+                                          "  alternateDataSize               INTEGER              DEFAULT NULL, "
+                                          "  alternateDataHash               TEXT                 DEFAULT NULL, "
+                                          "  resourceIndexInNote             INTEGER              DEFAULT NULL, "
+                                          "  UNIQUE(resourceLocalUid, resourceGuid)"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Resources table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceMimeIndex ON Resources(mime)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceMimeIndex ON Resources(mime)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceMimeIndex index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceRecognitionData("
-                                    "  resourceLocalUid REFERENCES Resources(resourceLocalUid)     ON UPDATE CASCADE, "
-                                    "  noteLocalUid REFERENCES Notes(localUid)                     ON UPDATE CASCADE, "
-                                    "  recognitionData                 TEXT                        DEFAULT NULL)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceRecognitionData("
+                                          "  resourceLocalUid REFERENCES Resources(resourceLocalUid)     ON UPDATE CASCADE, "
+                                          "  noteLocalUid REFERENCES Notes(localUid)                     ON UPDATE CASCADE, "
+                                          "  recognitionData                 TEXT                        DEFAULT NULL)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceRecognitionData table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceRecognitionDataIndex "
-                                    "ON ResourceRecognitionData(recognitionData)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceRecognitionDataIndex "
+                                          "ON ResourceRecognitionData(recognitionData)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceRecognitionDataIndex index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS ResourceRecognitionDataFTS USING FTS4"
-                                    "(content=\"ResourceRecognitionData\", resourceLocalUid, noteLocalUid, recognitionData)"));
+    res = execQuery(query, QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS ResourceRecognitionDataFTS USING FTS4"
+                                          "(content=\"ResourceRecognitionData\", resourceLocalUid, noteLocalUid, recognitionData)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create virtual FTS4 ResourceRecognitionDataFTS table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceRecognitionDataFTS_BeforeDeleteTrigger BEFORE DELETE "
-                                    "ON ResourceRecognitionData "
-                                    "BEGIN "
-                                    "DELETE FROM ResourceRecognitionDataFTS WHERE recognitionData=old.recognitionData; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceRecognitionDataFTS_BeforeDeleteTrigger BEFORE DELETE "
+                                          "ON ResourceRecognitionData "
+                                          "BEGIN "
+                                          "DELETE FROM ResourceRecognitionDataFTS WHERE recognitionData=old.recognitionData; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger ResourceRecognitionDataFTS_BeforeDeleteTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceRecognitionDataFTS_AfterInsertTrigger AFTER INSERT "
-                                    "ON ResourceRecognitionData "
-                                    "BEGIN "
-                                    "INSERT INTO ResourceRecognitionDataFTS(ResourceRecognitionDataFTS) VALUES('rebuild'); "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceRecognitionDataFTS_AfterInsertTrigger AFTER INSERT "
+                                          "ON ResourceRecognitionData "
+                                          "BEGIN "
+                                          "INSERT INTO ResourceRecognitionDataFTS(ResourceRecognitionDataFTS) VALUES('rebuild'); "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger ResourceRecognitionDataFTS_AfterInsertTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS ResourceMimeFTS USING FTS4(content=\"Resources\", resourceLocalUid, mime)"));
+    res = execQuery(query, QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS ResourceMimeFTS USING FTS4(content=\"Resources\", resourceLocalUid, mime)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create virtual FTS4 ResourceMimeFTS table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceMimeFTS_BeforeDeleteTrigger BEFORE DELETE ON Resources "
-                                    "BEGIN "
-                                    "DELETE FROM ResourceMimeFTS WHERE mime=old.mime; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceMimeFTS_BeforeDeleteTrigger BEFORE DELETE ON Resources "
+                                          "BEGIN "
+                                          "DELETE FROM ResourceMimeFTS WHERE mime=old.mime; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger ResourceMimeFTS_BeforeDeleteTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceMimeFTS_AfterInsertTrigger AFTER INSERT ON Resources "
-                                    "BEGIN "
-                                    "INSERT INTO ResourceMimeFTS(ResourceMimeFTS) VALUES('rebuild'); "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceMimeFTS_AfterInsertTrigger AFTER INSERT ON Resources "
+                                          "BEGIN "
+                                          "INSERT INTO ResourceMimeFTS(ResourceMimeFTS) VALUES('rebuild'); "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger ResourceMimeFTS_AfterInsertTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIEW IF NOT EXISTS ResourcesWithoutBinaryData "
-                                    "AS SELECT resourceLocalUid, resourceGuid, noteLocalUid, noteGuid, "
-                                    "resourceUpdateSequenceNumber, resourceIsDirty, dataSize, dataHash, "
-                                    "mime, width, height, recognitionDataSize, recognitionDataHash, "
-                                    "alternateDataSize, alternateDataHash, resourceIndexInNote FROM Resources"));
+    res = execQuery(query, QStringLiteral("CREATE VIEW IF NOT EXISTS ResourcesWithoutBinaryData "
+                                          "AS SELECT resourceLocalUid, resourceGuid, noteLocalUid, noteGuid, "
+                                          "resourceUpdateSequenceNumber, resourceIsDirty, dataSize, dataHash, "
+                                          "mime, width, height, recognitionDataSize, recognitionDataHash, "
+                                          "alternateDataSize, alternateDataHash, resourceIndexInNote FROM Resources"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourcesWithoutBinaryData view"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceNote ON Resources(noteLocalUid)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS ResourceNote ON Resources(noteLocalUid)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceNote index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributes("
-                                    "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
-                                    "  resourceSourceURL       TEXT                DEFAULT NULL, "
-                                    "  timestamp               INTEGER             DEFAULT NULL, "
-                                    "  resourceLatitude        REAL                DEFAULT NULL, "
-                                    "  resourceLongitude       REAL                DEFAULT NULL, "
-                                    "  resourceAltitude        REAL                DEFAULT NULL, "
-                                    "  cameraMake              TEXT                DEFAULT NULL, "
-                                    "  cameraModel             TEXT                DEFAULT NULL, "
-                                    "  clientWillIndex         INTEGER             DEFAULT NULL, "
-                                    "  fileName                TEXT                DEFAULT NULL, "
-                                    "  attachment              INTEGER             DEFAULT NULL, "
-                                    "  UNIQUE(resourceLocalUid) "
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributes("
+                                          "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
+                                          "  resourceSourceURL       TEXT                DEFAULT NULL, "
+                                          "  timestamp               INTEGER             DEFAULT NULL, "
+                                          "  resourceLatitude        REAL                DEFAULT NULL, "
+                                          "  resourceLongitude       REAL                DEFAULT NULL, "
+                                          "  resourceAltitude        REAL                DEFAULT NULL, "
+                                          "  cameraMake              TEXT                DEFAULT NULL, "
+                                          "  cameraModel             TEXT                DEFAULT NULL, "
+                                          "  clientWillIndex         INTEGER             DEFAULT NULL, "
+                                          "  fileName                TEXT                DEFAULT NULL, "
+                                          "  attachment              INTEGER             DEFAULT NULL, "
+                                          "  UNIQUE(resourceLocalUid) "
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceAttributes table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributesApplicationDataKeysOnly("
-                                    "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
-                                    "  resourceKey             TEXT                DEFAULT NULL, "
-                                    "  UNIQUE(resourceLocalUid, resourceKey)"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributesApplicationDataKeysOnly("
+                                          "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
+                                          "  resourceKey             TEXT                DEFAULT NULL, "
+                                          "  UNIQUE(resourceLocalUid, resourceKey)"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceAttributesApplicationDataKeysOnly table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributesApplicationDataFullMap("
-                                    "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
-                                    "  resourceMapKey          TEXT                DEFAULT NULL, "
-                                    "  resourceValue           TEXT                DEFAULT NULL, "
-                                    "  UNIQUE(resourceLocalUid, resourceMapKey) ON CONFLICT REPLACE"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceAttributesApplicationDataFullMap("
+                                          "  resourceLocalUid REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
+                                          "  resourceMapKey          TEXT                DEFAULT NULL, "
+                                          "  resourceValue           TEXT                DEFAULT NULL, "
+                                          "  UNIQUE(resourceLocalUid, resourceMapKey) ON CONFLICT REPLACE"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceAttributesApplicationDataFullMap table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS Tags("
-                                    "  localUid              TEXT PRIMARY KEY     NOT NULL UNIQUE, "
-                                    "  guid                  TEXT                 DEFAULT NULL UNIQUE, "
-                                    "  linkedNotebookGuid REFERENCES LinkedNotebooks(guid) ON UPDATE CASCADE, "
-                                    "  updateSequenceNumber  INTEGER              DEFAULT NULL, "
-                                    "  name                  TEXT                 DEFAULT NULL, "
-                                    "  nameLower             TEXT                 DEFAULT NULL, "
-                                    "  parentGuid REFERENCES Tags(guid)           ON UPDATE CASCADE DEFAULT NULL, "
-                                    "  parentLocalUid REFERENCES Tags(localUid)   ON UPDATE CASCADE DEFAULT NULL, "
-                                    "  isDirty               INTEGER              NOT NULL, "
-                                    "  isLocal               INTEGER              NOT NULL, "
-                                    "  isFavorited           INTEGER              NOT NULL, "
-                                    "  UNIQUE(localUid, guid), "
-                                    "  UNIQUE(nameLower, linkedNotebookGuid) "
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS Tags("
+                                          "  localUid              TEXT PRIMARY KEY     NOT NULL UNIQUE, "
+                                          "  guid                  TEXT                 DEFAULT NULL UNIQUE, "
+                                          "  linkedNotebookGuid REFERENCES LinkedNotebooks(guid) ON UPDATE CASCADE, "
+                                          "  updateSequenceNumber  INTEGER              DEFAULT NULL, "
+                                          "  name                  TEXT                 DEFAULT NULL, "
+                                          "  nameLower             TEXT                 DEFAULT NULL, "
+                                          "  parentGuid REFERENCES Tags(guid)           ON UPDATE CASCADE DEFAULT NULL, "
+                                          "  parentLocalUid REFERENCES Tags(localUid)   ON UPDATE CASCADE DEFAULT NULL, "
+                                          "  isDirty               INTEGER              NOT NULL, "
+                                          "  isLocal               INTEGER              NOT NULL, "
+                                          "  isFavorited           INTEGER              NOT NULL, "
+                                          "  UNIQUE(localUid, guid), "
+                                          "  UNIQUE(nameLower, linkedNotebookGuid) "
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create Tags table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS TagNameUpperIndex ON Tags(nameLower)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS TagNameUpperIndex ON Tags(nameLower)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create TagNameUpperIndex index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS TagFTS USING FTS4(content=\"Tags\", localUid, guid, nameLower)"));
+    res = execQuery(query, QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS TagFTS USING FTS4(content=\"Tags\", localUid, guid, nameLower)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create virtual FTS4 table TagFTS"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS TagFTS_BeforeDeleteTrigger BEFORE DELETE ON Tags "
-                                    "BEGIN "
-                                    "DELETE FROM TagFTS WHERE localUid=old.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS TagFTS_BeforeDeleteTrigger BEFORE DELETE ON Tags "
+                                          "BEGIN "
+                                          "DELETE FROM TagFTS WHERE localUid=old.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger TagFTS_BeforeDeleteTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS TagFTS_AfterInsertTrigger AFTER INSERT ON Tags "
-                                    "BEGIN "
-                                    "INSERT INTO TagFTS(TagFTS) VALUES('rebuild'); "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS TagFTS_AfterInsertTrigger AFTER INSERT ON Tags "
+                                          "BEGIN "
+                                          "INSERT INTO TagFTS(TagFTS) VALUES('rebuild'); "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger TagFTS_AfterInsertTrigger"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS TagsSearchName ON Tags(nameLower)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS TagsSearchName ON Tags(nameLower)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create TagsSearchName index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS NoteTags("
-                                    "  localNote REFERENCES Notes(localUid) ON UPDATE CASCADE, "
-                                    "  note REFERENCES Notes(guid)          ON UPDATE CASCADE, "
-                                    "  localTag REFERENCES Tags(localUid)   ON UPDATE CASCADE, "
-                                    "  tag  REFERENCES Tags(guid)           ON UPDATE CASCADE, "
-                                    "  tagIndexInNote        INTEGER        DEFAULT NULL, "
-                                    "  UNIQUE(localNote, localTag) ON CONFLICT REPLACE"
-                                    ")"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS NoteTags("
+                                          "  localNote REFERENCES Notes(localUid) ON UPDATE CASCADE, "
+                                          "  note REFERENCES Notes(guid)          ON UPDATE CASCADE, "
+                                          "  localTag REFERENCES Tags(localUid)   ON UPDATE CASCADE, "
+                                          "  tag  REFERENCES Tags(guid)           ON UPDATE CASCADE, "
+                                          "  tagIndexInNote        INTEGER        DEFAULT NULL, "
+                                          "  UNIQUE(localNote, localTag) ON CONFLICT REPLACE"
+                                          ")"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteTags table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS NoteTagsNote ON NoteTags(localNote)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS NoteTagsNote ON NoteTags(localNote)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteTagsNote index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS NoteResources("
-                                    "  localNote     REFERENCES Notes(localUid)             ON UPDATE CASCADE, "
-                                    "  note          REFERENCES Notes(guid)                 ON UPDATE CASCADE, "
-                                    "  localResource REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
-                                    "  resource      REFERENCES Resources(resourceGuid)     ON UPDATE CASCADE, "
-                                    "  UNIQUE(localNote, localResource) ON CONFLICT REPLACE)"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS NoteResources("
+                                          "  localNote     REFERENCES Notes(localUid)             ON UPDATE CASCADE, "
+                                          "  note          REFERENCES Notes(guid)                 ON UPDATE CASCADE, "
+                                          "  localResource REFERENCES Resources(resourceLocalUid) ON UPDATE CASCADE, "
+                                          "  resource      REFERENCES Resources(resourceGuid)     ON UPDATE CASCADE, "
+                                          "  UNIQUE(localNote, localResource) ON CONFLICT REPLACE)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteResources table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE INDEX IF NOT EXISTS NoteResourcesNote ON NoteResources(localNote)"));
+    res = execQuery(query, QStringLiteral("CREATE INDEX IF NOT EXISTS NoteResourcesNote ON NoteResources(localNote)"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create NoteResourcesNote index"));
     DATABASE_CHECK_AND_SET_ERROR();
 
     // NOTE: reasoning for existence and unique constraint for nameLower, citing Evernote API reference:
     // "The account may only contain one search with a given name (case-insensitive compare)"
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_linked_notebook_delete_trigger "
-                                    "BEFORE DELETE ON LinkedNotebooks "
-                                    "BEGIN "
-                                    "DELETE FROM Notebooks WHERE Notebooks.linkedNotebookGuid=OLD.guid; "
-                                    "DELETE FROM Tags WHERE Tags.linkedNotebookGuid=OLD.guid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_linked_notebook_delete_trigger "
+                                          "BEFORE DELETE ON LinkedNotebooks "
+                                          "BEGIN "
+                                          "DELETE FROM Notebooks WHERE Notebooks.linkedNotebookGuid=OLD.guid; "
+                                          "DELETE FROM Tags WHERE Tags.linkedNotebookGuid=OLD.guid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on linked notebook deletion"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_note_delete_trigger "
-                                    "BEFORE DELETE ON Notes "
-                                    "BEGIN "
-                                    "DELETE FROM Resources WHERE Resources.noteLocalUid=OLD.localUid; "
-                                    "DELETE FROM ResourceRecognitionData WHERE ResourceRecognitionData.noteLocalUid=OLD.localUid; "
-                                    "DELETE FROM NoteTags WHERE NoteTags.localNote=OLD.localUid; "
-                                    "DELETE FROM NoteResources WHERE NoteResources.localNote=OLD.localUid; "
-                                    "DELETE FROM SharedNotes WHERE SharedNotes.sharedNoteNoteGuid=OLD.guid; "
-                                    "DELETE FROM NoteRestrictions WHERE NoteRestrictions.noteLocalUid=OLD.localUid; "
-                                    "DELETE FROM NoteLimits WHERE NoteLimits.noteLocalUid=OLD.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_note_delete_trigger "
+                                          "BEFORE DELETE ON Notes "
+                                          "BEGIN "
+                                          "DELETE FROM Resources WHERE Resources.noteLocalUid=OLD.localUid; "
+                                          "DELETE FROM ResourceRecognitionData WHERE ResourceRecognitionData.noteLocalUid=OLD.localUid; "
+                                          "DELETE FROM NoteTags WHERE NoteTags.localNote=OLD.localUid; "
+                                          "DELETE FROM NoteResources WHERE NoteResources.localNote=OLD.localUid; "
+                                          "DELETE FROM SharedNotes WHERE SharedNotes.sharedNoteNoteGuid=OLD.guid; "
+                                          "DELETE FROM NoteRestrictions WHERE NoteRestrictions.noteLocalUid=OLD.localUid; "
+                                          "DELETE FROM NoteLimits WHERE NoteLimits.noteLocalUid=OLD.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on note deletion"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_resource_delete_trigger "
-                                    "BEFORE DELETE ON Resources "
-                                    "BEGIN "
-                                    "DELETE FROM ResourceRecognitionData WHERE ResourceRecognitionData.resourceLocalUid=OLD.resourceLocalUid; "
-                                    "DELETE FROM ResourceAttributes WHERE ResourceAttributes.resourceLocalUid=OLD.resourceLocalUid; "
-                                    "DELETE FROM ResourceAttributesApplicationDataKeysOnly WHERE ResourceAttributesApplicationDataKeysOnly.resourceLocalUid=OLD.resourceLocalUid; "
-                                    "DELETE FROM ResourceAttributesApplicationDataFullMap WHERE ResourceAttributesApplicationDataFullMap.resourceLocalUid=OLD.resourceLocalUid; "
-                                    "DELETE FROM NoteResources WHERE NoteResources.localResource=OLD.resourceLocalUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_resource_delete_trigger "
+                                          "BEFORE DELETE ON Resources "
+                                          "BEGIN "
+                                          "DELETE FROM ResourceRecognitionData WHERE ResourceRecognitionData.resourceLocalUid=OLD.resourceLocalUid; "
+                                          "DELETE FROM ResourceAttributes WHERE ResourceAttributes.resourceLocalUid=OLD.resourceLocalUid; "
+                                          "DELETE FROM ResourceAttributesApplicationDataKeysOnly WHERE ResourceAttributesApplicationDataKeysOnly.resourceLocalUid=OLD.resourceLocalUid; "
+                                          "DELETE FROM ResourceAttributesApplicationDataFullMap WHERE ResourceAttributesApplicationDataFullMap.resourceLocalUid=OLD.resourceLocalUid; "
+                                          "DELETE FROM NoteResources WHERE NoteResources.localResource=OLD.resourceLocalUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on resource deletion"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_tag_delete_trigger "
-                                    "BEFORE DELETE ON Tags "
-                                    "BEGIN "
-                                    "DELETE FROM NoteTags WHERE NoteTags.localTag=OLD.localUid; "
-                                    "END"));
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS on_tag_delete_trigger "
+                                          "BEFORE DELETE ON Tags "
+                                          "BEGIN "
+                                          "DELETE FROM NoteTags WHERE NoteTags.localTag=OLD.localUid; "
+                                          "END"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to fire on tag deletion"));
     DATABASE_CHECK_AND_SET_ERROR();
 
-    res = query.exec(QStringLiteral("CREATE TABLE IF NOT EXISTS SavedSearches("
-                                    "  localUid                        TEXT PRIMARY KEY    NOT NULL UNIQUE, "
-                                    "  guid                            TEXT                DEFAULT NULL UNIQUE, "
-                                    "  name                            TEXT                DEFAULT NULL, "
-                                    "  nameLower                       TEXT                DEFAULT NULL UNIQUE, "
-                                    "  query                           TEXT                DEFAULT NULL, "
-                                    "  format                          INTEGER             DEFAULT NULL, "
-                                    "  updateSequenceNumber            INTEGER             DEFAULT NULL, "
-                                    "  isDirty                         INTEGER             NOT NULL, "
-                                    "  isLocal                         INTEGER             NOT NULL, "
-                                    "  includeAccount                  INTEGER             DEFAULT NULL, "
-                                    "  includePersonalLinkedNotebooks  INTEGER             DEFAULT NULL, "
-                                    "  includeBusinessLinkedNotebooks  INTEGER             DEFAULT NULL, "
-                                    "  isFavorited                     INTEGER             NOT NULL, "
-                                    "  UNIQUE(localUid, guid))"));
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS SavedSearches("
+                                          "  localUid                        TEXT PRIMARY KEY    NOT NULL UNIQUE, "
+                                          "  guid                            TEXT                DEFAULT NULL UNIQUE, "
+                                          "  name                            TEXT                DEFAULT NULL, "
+                                          "  nameLower                       TEXT                DEFAULT NULL UNIQUE, "
+                                          "  query                           TEXT                DEFAULT NULL, "
+                                          "  format                          INTEGER             DEFAULT NULL, "
+                                          "  updateSequenceNumber            INTEGER             DEFAULT NULL, "
+                                          "  isDirty                         INTEGER             NOT NULL, "
+                                          "  isLocal                         INTEGER             NOT NULL, "
+                                          "  includeAccount                  INTEGER             DEFAULT NULL, "
+                                          "  includePersonalLinkedNotebooks  INTEGER             DEFAULT NULL, "
+                                          "  includeBusinessLinkedNotebooks  INTEGER             DEFAULT NULL, "
+                                          "  isFavorited                     INTEGER             NOT NULL, "
+                                          "  UNIQUE(localUid, guid))"));
     errorPrefix.setBase(QT_TR_NOOP("Can't create SavedSearches table"));
     DATABASE_CHECK_AND_SET_ERROR();
 
+    // NOTE: the change journal is append-only; AUTOINCREMENT guarantees the sequence numbers are never reused
+    // even after the oldest entries are trimmed. Additions and updates are journaled by insertOrReplace* methods
+    // within the same transaction as the change itself while expunges are journaled by triggers below so that
+    // the data elements expunged implicitly (i.e. notes of the expunged notebook) are recorded as well.
+    // The numeric values of entity and change types correspond to ChangeJournalEntry::EntityType
+    // and ChangeJournalEntry::ChangeType enumerations
+
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ChangeJournal("
+                                          "  sequenceNumber                  INTEGER PRIMARY KEY AUTOINCREMENT, "
+                                          "  entityType                      INTEGER             NOT NULL, "
+                                          "  changeType                      INTEGER             NOT NULL, "
+                                          "  localUid                        TEXT                NOT NULL, "
+                                          "  changedFields                   TEXT                DEFAULT NULL, "
+                                          "  timestamp                       INTEGER             NOT NULL DEFAULT "
+                                          "(CAST((julianday('now') - 2440587.5) * 86400000 AS INTEGER)))"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create ChangeJournal table"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_NotebookAfterDeleteTrigger "
+                                          "AFTER DELETE ON Notebooks "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(0, 2, OLD.localUid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record notebook deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_LinkedNotebookAfterDeleteTrigger "
+                                          "AFTER DELETE ON LinkedNotebooks "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(1, 2, OLD.guid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record linked notebook deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_NoteAfterDeleteTrigger "
+                                          "AFTER DELETE ON Notes "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(2, 2, OLD.localUid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record note deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_TagAfterDeleteTrigger "
+                                          "AFTER DELETE ON Tags "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(3, 2, OLD.localUid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record tag deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_ResourceAfterDeleteTrigger "
+                                          "AFTER DELETE ON Resources "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(4, 2, OLD.resourceLocalUid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record resource deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ChangeJournal_SavedSearchAfterDeleteTrigger "
+                                          "AFTER DELETE ON SavedSearches "
+                                          "BEGIN "
+                                          "INSERT INTO ChangeJournal(entityType, changeType, localUid) "
+                                          "VALUES(5, 2, OLD.localUid); "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to record saved search deletion in the change journal"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    // NOTE: the hash of each resource's data as it was when the resource was last synchronized with the service;
+    // it is kept in a separate table rather than in Resources one so that the existing databases get it as well
+
+    res = execQuery(query, QStringLiteral("CREATE TABLE IF NOT EXISTS ResourceSyncedDataHashes("
+                                          "  resourceLocalUid                TEXT PRIMARY KEY     NOT NULL UNIQUE, "
+                                          "  dataHash                        TEXT                 NOT NULL"
+                                          ")"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create ResourceSyncedDataHashes table"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    res = execQuery(query, QStringLiteral("CREATE TRIGGER IF NOT EXISTS ResourceSyncedDataHashes_ResourceAfterDeleteTrigger "
+                                          "AFTER DELETE ON Resources "
+                                          "BEGIN "
+                                          "DELETE FROM ResourceSyncedDataHashes WHERE resourceLocalUid=OLD.resourceLocalUid; "
+                                          "END"));
+    errorPrefix.setBase(QT_TR_NOOP("Can't create trigger to remove the synchronized data hash on resource deletion"));
+    DATABASE_CHECK_AND_SET_ERROR();
+
     return true;
 }
 
@@ -4872,7 +6135,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNotebookRestrictions(const QStri
                     notebookRestrictions.expungeWhichSharedNotebookRestrictions.isSet()
                     ? notebookRestrictions.expungeWhichSharedNotebookRestrictions.ref() : nullValue);
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -4909,7 +6172,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceSharedNotebook(const SharedNoteb
     query.bindValue(QStringLiteral(":sharedNotebookAssignmentTimestamp"), (sharedNotebook.hasAssignmentTimestamp() ? sharedNotebook.assignmentTimestamp() : nullValue));
     query.bindValue(QStringLiteral(":indexInNotebook"), (sharedNotebook.indexInNotebook() >= 0 ? sharedNotebook.indexInNotebook() : nullValue));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -4923,7 +6186,7 @@ bool LocalStorageManagerPrivate::rowExists(const QString & tableName, const QStr
     QString queryString = QString::fromUtf8("SELECT count(*) FROM %1 WHERE %2='%3'").arg(tableName,uniqueKeyName,key);
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     if (!res) {
         QNWARNING(QStringLiteral("Unable to check the existence of row with key name ") << uniqueKeyName
                   << QStringLiteral(", value = ") << key << QStringLiteral(" in table ") << tableName
@@ -4974,7 +6237,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
         query.bindValue(QStringLiteral(":userPhotoUrl"), (user.hasPhotoUrl() ? user.photoUrl() : nullValue));
         query.bindValue(QStringLiteral(":userPhotoLastUpdateTimestamp"), (user.hasPhotoLastUpdateTimestamp() ? user.photoLastUpdateTimestamp() : nullValue));
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -4996,7 +6259,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
         {
             QString queryString = QString::fromUtf8("DELETE FROM UserAttributesViewedPromotions WHERE id=%1").arg(userId);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
 
@@ -5004,7 +6267,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
         {
             QString queryString = QString::fromUtf8("DELETE FROM UserAttributesRecentMailedAddresses WHERE id=%1").arg(userId);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
 
@@ -5012,7 +6275,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
         {
             QString queryString = QString::fromUtf8("DELETE FROM UserAttributes WHERE id=%1").arg(userId);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
     }
@@ -5033,7 +6296,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
     {
         QString queryString = QString::fromUtf8("DELETE FROM Accounting WHERE id=%1").arg(userId);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5053,7 +6316,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
     {
         QString queryString = QString::fromUtf8("DELETE FROM AccountLimits WHERE id=%1").arg(userId);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5073,7 +6336,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUser(const User & user, ErrorStr
     {
         QString queryString = QString::fromUtf8("DELETE FROM BusinessUserInfo WHERE id=%1").arg(userId);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5097,7 +6360,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceBusinessUserInfo(const qeverclou
     query.bindValue(QStringLiteral(":role"), (info.role.isSet() ? info.role.ref() : nullValue));
     query.bindValue(QStringLiteral(":businessInfoEmail"), (info.email.isSet() ? info.email.ref() : nullValue));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -5142,7 +6405,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceAccounting(const qevercloud::Use
 
 #undef CHECK_AND_BIND_VALUE
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -5178,7 +6441,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceAccountLimits(const qevercloud::
 
 #undef CHECK_AND_BIND_VALUE
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -5243,7 +6506,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUserAttributes(const qevercloud:
 
 #undef CHECK_AND_BIND_BOOLEAN_VALUE
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5251,7 +6514,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUserAttributes(const qevercloud:
     {
         QString queryString = QString::fromUtf8("DELETE FROM UserAttributesViewedPromotions WHERE id=%1").arg(id);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5266,7 +6529,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUserAttributes(const qevercloud:
         const auto & viewedPromotions = attributes.viewedPromotions.ref();
         for(auto it = viewedPromotions.begin(), end = viewedPromotions.end(); it != end; ++it) {
             query.bindValue(QStringLiteral(":promotion"), *it);
-            res = query.exec();
+            res = execQuery(query);
             DATABASE_CHECK_AND_SET_ERROR();
         }
     }
@@ -5275,7 +6538,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUserAttributes(const qevercloud:
     {
         QString queryString = QString::fromUtf8("DELETE FROM UserAttributesRecentMailedAddresses WHERE id=%1").arg(id);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5290,7 +6553,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceUserAttributes(const qevercloud:
         const auto & recentMailedAddresses = attributes.recentMailedAddresses.ref();
         for(auto it = recentMailedAddresses.begin(), end = recentMailedAddresses.end(); it != end; ++it) {
             query.bindValue(QStringLiteral(":address"), *it);
-            res = query.exec();
+            res = execQuery(query);
             DATABASE_CHECK_AND_SET_ERROR();
         }
     }
@@ -5515,6 +6778,7 @@ bool LocalStorageManagerPrivate::checkAndPrepareDeleteUserQuery()
 }
 
 bool LocalStorageManagerPrivate::insertOrReplaceNotebook(const Notebook & notebook,
+                                                         const ChangeJournalEntry::ChangeType::type changeType,
                                                          ErrorString & errorDescription)
 {
     // NOTE: this method expects to be called after notebook is already checked
@@ -5567,7 +6831,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNotebook(const Notebook & notebo
                                                                : nullValue));
         query.bindValue(QStringLiteral(":recipientStack"), (notebook.hasRecipientStack() ? notebook.recipientStack() : nullValue));
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5587,7 +6851,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNotebook(const Notebook & notebo
     {
         QString queryString = QString::fromUtf8("DELETE FROM NotebookRestrictions WHERE localUid='%1'").arg(localUid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -5596,7 +6860,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNotebook(const Notebook & notebo
         QString guid = sqlEscapeString(notebook.guid());
         QString queryString = QString::fromUtf8("DELETE FROM SharedNotebooks WHERE sharedNotebookNotebookGuid='%1'").arg(guid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         QList<SharedNotebook> sharedNotebooks = notebook.sharedNotebooks();
@@ -5621,6 +6885,17 @@ bool LocalStorageManagerPrivate::insertOrReplaceNotebook(const Notebook & notebo
         }
     }
 
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::Notebook, changeType,
+                                               notebook.localUid(), QStringList(), journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
     return transaction.commit(errorDescription);
 }
 
@@ -5736,6 +7011,7 @@ bool LocalStorageManagerPrivate::checkAndPrepareInsertOrReplaceSharedNotebookQue
 }
 
 bool LocalStorageManagerPrivate::insertOrReplaceLinkedNotebook(const LinkedNotebook & linkedNotebook,
+                                                               const ChangeJournalEntry::ChangeType::type changeType,
                                                                ErrorString & errorDescription)
 {
     // NOTE: this method expects to be called after the linked notebook
@@ -5743,6 +7019,8 @@ bool LocalStorageManagerPrivate::insertOrReplaceLinkedNotebook(const LinkedNoteb
 
     ErrorString errorPrefix(QT_TR_NOOP("can't insert or replace linked notebook"));
 
+    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+
     bool res = checkAndPrepareInsertOrReplaceLinkedNotebookQuery();
     QSqlQuery & query = m_insertOrReplaceLinkedNotebookQuery;
     DATABASE_CHECK_AND_SET_ERROR();
@@ -5762,10 +7040,21 @@ bool LocalStorageManagerPrivate::insertOrReplaceLinkedNotebook(const LinkedNoteb
     query.bindValue(QStringLiteral(":businessId"), (linkedNotebook.hasBusinessId() ? linkedNotebook.businessId() : nullValue));
     query.bindValue(QStringLiteral(":isDirty"), (linkedNotebook.isDirty() ? 1 : 0));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
-    return true;
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::LinkedNotebook, changeType,
+                                               linkedNotebook.guid(), QStringList(), journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
+    return transaction.commit(errorDescription);
 }
 
 bool LocalStorageManagerPrivate::checkAndPrepareGetLinkedNotebookCountQuery() const
@@ -5858,7 +7147,7 @@ bool LocalStorageManagerPrivate::getNoteLocalUidFromResource(const Resource & re
 
     QString queryString = QString::fromUtf8("SELECT localNote FROM NoteResources WHERE %1='%2'").arg(column,uid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     res = query.next();
@@ -5894,7 +7183,7 @@ bool LocalStorageManagerPrivate::getNotebookLocalUidFromNote(const Note & note,
         QString notebookGuid = sqlEscapeString(note.notebookGuid());
         QString queryString = QString::fromUtf8("SELECT localUid FROM Notebooks WHERE guid = '%1'").arg(notebookGuid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         res = query.next();
@@ -5923,7 +7212,7 @@ bool LocalStorageManagerPrivate::getNotebookLocalUidFromNote(const Note & note,
 
         QString queryString = QString::fromUtf8("SELECT notebookLocalUid FROM Notes WHERE %1='%2'").arg(column,uid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         res = query.next();
@@ -5976,7 +7265,7 @@ bool LocalStorageManagerPrivate::getNotebookGuidForNote(const Note & note, QStri
 
     QString queryString = QString::fromUtf8("SELECT guid FROM Notebooks where localUid = '%1'").arg(notebookLocalUid);
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     res = query.next();
@@ -6000,7 +7289,7 @@ bool LocalStorageManagerPrivate::getNotebookLocalUidForGuid(const QString & note
 
     QString queryString = QString::fromUtf8("SELECT localUid FROM Notebooks WHERE guid = '%1'").arg(sqlEscapeString(notebookGuid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next()) {
@@ -6027,7 +7316,7 @@ bool LocalStorageManagerPrivate::getNoteLocalUidForGuid(const QString & noteGuid
 
     QString queryString = QString::fromUtf8("SELECT localUid FROM Notes WHERE guid = '%1'").arg(sqlEscapeString(noteGuid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next()) {
@@ -6055,7 +7344,7 @@ bool LocalStorageManagerPrivate::getTagLocalUidForGuid(const QString & tagGuid,
 
     QString queryString = QString::fromUtf8("SELECT localUid FROM Tags WHERE guid = '%1'").arg(sqlEscapeString(tagGuid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next()) {
@@ -6082,7 +7371,7 @@ bool LocalStorageManagerPrivate::getResourceLocalUidForGuid(const QString & reso
 
     QString queryString = QString::fromUtf8("SELECT resourceLocalUid FROM Resources WHERE resourceGuid = '%1'").arg(sqlEscapeString(resourceGuid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next()) {
@@ -6110,7 +7399,7 @@ bool LocalStorageManagerPrivate::getSavedSearchLocalUidForGuid(const QString & s
 
     QString queryString = QString::fromUtf8("SELECT localUid FROM SavedSearches WHERE guid = '%1'").arg(sqlEscapeString(savedSearchGuid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     if (query.next()) {
@@ -6130,14 +7419,19 @@ bool LocalStorageManagerPrivate::getSavedSearchLocalUidForGuid(const QString & s
 }
 
 bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool updateResources,
-                                                     const bool updateTags, ErrorString & errorDescription)
+                                                     const bool updateTags,
+                                                     const ChangeJournalEntry::ChangeType::type changeType,
+                                                     ErrorString & errorDescription, const bool useSeparateTransaction)
 {
     // NOTE: this method expects to be called after the note is already checked
     // for sanity of its parameters!
 
     ErrorString errorPrefix(QT_TR_NOOP("can't insert or replace note"));
 
-    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+    QScopedPointer<Transaction> pTransaction;
+    if (useSeparateTransaction) {
+        pTransaction.reset(new Transaction(m_sqlDatabase, *this, Transaction::Exclusive));
+    }
 
     QVariant nullValue;
     QString localUid = sqlEscapeString(note.localUid());
@@ -6362,7 +7656,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
 #undef BIND_NULL_ATTRIBUTE
         }
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -6379,7 +7673,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
     {
         QString queryString = QString::fromUtf8("DELETE FROM NoteRestrictions WHERE noteLocalUid='%1'").arg(localUid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -6396,7 +7690,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
     {
         QString queryString = QString::fromUtf8("DELETE FROM NoteLimits WHERE noteLocalUid='%1'").arg(localUid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -6407,7 +7701,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
             QString noteGuid = sqlEscapeString(note.guid());
             QString queryString = QString::fromUtf8("DELETE FROM SharedNotes WHERE sharedNoteNoteGuid='%1'").arg(noteGuid);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
 
@@ -6431,7 +7725,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
         {
             QString queryString = QString::fromUtf8("DELETE From NoteTags WHERE localNote='%1'").arg(localUid);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
 
@@ -6503,7 +7797,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
                 query.bindValue(QStringLiteral(":tag"), (tag.hasGuid() ? tag.guid() : nullValue));
                 query.bindValue(QStringLiteral(":tagIndexInNote"), i);
 
-                res = query.exec();
+                res = execQuery(query);
                 DATABASE_CHECK_AND_SET_ERROR();
             }
 
@@ -6526,7 +7820,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
             // Just clear any resources the note might have had then
             QString queryString = QString::fromUtf8("DELETE FROM Resources WHERE noteLocalUid='%1'").arg(localUid);
             QSqlQuery query(m_sqlDatabase);
-            bool res = query.exec(queryString);
+            bool res = execQuery(query, queryString);
             DATABASE_CHECK_AND_SET_ERROR();
         }
         else
@@ -6537,8 +7831,50 @@ bool LocalStorageManagerPrivate::insertOrReplaceNote(Note & note, const bool upd
             }
         }
     }
+    else if (!note.isDirty() && note.hasResources())
+    {
+        // The note is not dirty after it has been sent to the service: the resources of the note as it was sent
+        // have just been synchronized even though the resources themselves are not updated
+        QList<Resource> resources = note.resources();
+        for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+        {
+            const Resource & resource = *it;
+            if (!resource.hasDataHash()) {
+                continue;
+            }
+
+            bool res = insertOrReplaceResourceSyncedDataHash(resource.localUid(), resource.dataHash(), errorDescription);
+            if (!res) {
+                return false;
+            }
+        }
+    }
 
-    return transaction.commit(errorDescription);
+    QStringList changedFields;
+    changedFields << QStringLiteral("note");
+    if (updateTags) {
+        changedFields << QStringLiteral("tags");
+    }
+    if (updateResources) {
+        changedFields << QStringLiteral("resources");
+    }
+
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::Note, changeType,
+                                               note.localUid(), changedFields, journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
+    if (!pTransaction.isNull()) {
+        return pTransaction->commit(errorDescription);
+    }
+
+    return true;
 }
 
 bool LocalStorageManagerPrivate::insertOrReplaceSharedNote(const SharedNote & sharedNote, ErrorString & errorDescription)
@@ -6605,7 +7941,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceSharedNote(const SharedNote & sh
     query.bindValue(QStringLiteral(":sharedNoteAssignmentTimestamp"), (sharedNote.hasAssignmentTimestamp() ? sharedNote.assignmentTimestamp() : nullValue));
     query.bindValue(QStringLiteral(":indexInNote"), (sharedNote.indexInNote() >= 0 ? sharedNote.indexInNote() : nullValue));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -6636,7 +7972,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNoteRestrictions(const QString &
 
 #undef BIND_RESTRICTION
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -6666,7 +8002,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceNoteLimits(const QString & noteL
 
 #undef BIND_LIMIT
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -6911,13 +8247,16 @@ bool LocalStorageManagerPrivate::checkAndPrepareInsertOrReplaceNoteIntoNoteTagsQ
     return res;
 }
 
-bool LocalStorageManagerPrivate::insertOrReplaceTag(const Tag & tag, ErrorString & errorDescription)
+bool LocalStorageManagerPrivate::insertOrReplaceTag(const Tag & tag, const ChangeJournalEntry::ChangeType::type changeType,
+                                                    ErrorString & errorDescription)
 {
     // NOTE: this method expects to be called after tag is already checked
     // for sanity of its parameters!
 
     ErrorString errorPrefix(QT_TR_NOOP("can't insert or replace tag into the local storage database"));
 
+    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+
     QString localUid = tag.localUid();
 
     bool res = checkAndPrepareInsertOrReplaceTagQuery();
@@ -6944,10 +8283,21 @@ bool LocalStorageManagerPrivate::insertOrReplaceTag(const Tag & tag, ErrorString
     query.bindValue(QStringLiteral(":isLocal"), (tag.isLocal() ? 1 : 0));
     query.bindValue(QStringLiteral(":isFavorited"), (tag.isFavorited() ? 1 : 0));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
-    return true;
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::Tag, changeType,
+                                               localUid, QStringList(), journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
+    return transaction.commit(errorDescription);
 }
 
 bool LocalStorageManagerPrivate::checkAndPrepareTagCountQuery() const
@@ -7011,7 +8361,7 @@ bool LocalStorageManagerPrivate::complementTagParentInfo(Tag & tag, ErrorString
     QNDEBUG(QStringLiteral("Query string = ") << queryString);
 
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     res = query.next();
@@ -7033,7 +8383,9 @@ bool LocalStorageManagerPrivate::complementTagParentInfo(Tag & tag, ErrorString
     return true;
 }
 
-bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resource, ErrorString & errorDescription,
+bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resource,
+                                                         const ChangeJournalEntry::ChangeType::type changeType,
+                                                         ErrorString & errorDescription,
                                                          const bool useSeparateTransaction)
 {
     // NOTE: this method expects to be called after resource is already checked
@@ -7070,7 +8422,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
 
         query.bindValue(QStringLiteral(":resourceLocalUid"), resourceLocalUid);
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -7111,7 +8463,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
                 query.bindValue(QStringLiteral(":noteLocalUid"), noteLocalUid);
                 query.bindValue(QStringLiteral(":recognitionData"), recognitionData);
 
-                res = query.exec();
+                res = execQuery(query);
                 DATABASE_CHECK_AND_SET_ERROR();
             }
         }
@@ -7125,7 +8477,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
 
         query.bindValue(QStringLiteral(":resourceLocalUid"), resourceLocalUid);
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -7137,7 +8489,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
 
         query.bindValue(QStringLiteral(":resourceLocalUid"), resourceLocalUid);
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -7149,7 +8501,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
 
         query.bindValue(QStringLiteral(":resourceLocalUid"), resourceLocalUid);
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -7162,6 +8514,26 @@ bool LocalStorageManagerPrivate::insertOrReplaceResource(const Resource & resour
         }
     }
 
+    // The resource which is not dirty has the same data as the service has
+    if (!resource.isDirty() && resource.hasDataHash())
+    {
+        bool res = insertOrReplaceResourceSyncedDataHash(resourceLocalUid, resource.dataHash(), errorDescription);
+        if (!res) {
+            return false;
+        }
+    }
+
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::Resource, changeType,
+                                               resourceLocalUid, QStringList(), journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
     if (!pTransaction.isNull()) {
         return pTransaction->commit(errorDescription);
     }
@@ -7199,7 +8571,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResourceAttributes(const QString
         query.bindValue(QStringLiteral(":fileName"), (attributes.fileName.isSet() ? attributes.fileName.ref() : nullValue));
         query.bindValue(QStringLiteral(":attachment"), (attributes.attachment.isSet() ? (attributes.attachment.ref() ? 1 : 0) : nullValue));
 
-        res = query.exec();
+        res = execQuery(query);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -7219,7 +8591,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResourceAttributes(const QString
             for(auto it = keysOnly.begin(), end = keysOnly.end(); it != end; ++it) {
                 const QString & key = *it;
                 query.bindValue(QStringLiteral(":resourceKey"), key);
-                res = query.exec();
+                res = execQuery(query);
                 DATABASE_CHECK_AND_SET_ERROR();
             }
         }
@@ -7238,7 +8610,7 @@ bool LocalStorageManagerPrivate::insertOrReplaceResourceAttributes(const QString
                 const QString & value = it.value();
                 query.bindValue(QStringLiteral(":resourceMapKey"), key);
                 query.bindValue(QStringLiteral(":resourceValue"), value);
-                res = query.exec();
+                res = execQuery(query);
                 DATABASE_CHECK_AND_SET_ERROR();
             }
         }
@@ -7278,7 +8650,7 @@ bool LocalStorageManagerPrivate::updateCommonResourceData(const Resource & resou
     query.bindValue(QStringLiteral(":resourceIndexInNote"), resource.indexInNote());
     query.bindValue(QStringLiteral(":resourceLocalUid"), resource.localUid());
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -7300,7 +8672,7 @@ bool LocalStorageManagerPrivate::updateNoteResources(const Resource & resource,
     query.bindValue(QStringLiteral(":localResource"), resource.localUid());
     query.bindValue(QStringLiteral(":resource"), (resource.hasGuid() ? resource.guid() : nullValue));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     return true;
@@ -7524,13 +8896,17 @@ bool LocalStorageManagerPrivate::checkAndPrepareResourceCountQuery() const
     return res;
 }
 
-bool LocalStorageManagerPrivate::insertOrReplaceSavedSearch(const SavedSearch & search, ErrorString & errorDescription)
+bool LocalStorageManagerPrivate::insertOrReplaceSavedSearch(const SavedSearch & search,
+                                                            const ChangeJournalEntry::ChangeType::type changeType,
+                                                            ErrorString & errorDescription)
 {
     // NOTE: this method expects to be called after the search is already checked
     // for sanity of its parameters!
 
     ErrorString errorPrefix(QT_TR_NOOP("can't insert or replace saved search into the local storage database"));
 
+    Transaction transaction(m_sqlDatabase, *this, Transaction::Exclusive);
+
     bool res = checkAndPrepareInsertOrReplaceSavedSearchQuery();
     if (!res) {
         errorDescription.base() = errorPrefix.base();
@@ -7566,11 +8942,130 @@ bool LocalStorageManagerPrivate::insertOrReplaceSavedSearch(const SavedSearch &
                                                                         : nullValue));
     query.bindValue(QStringLiteral(":isFavorited"), (search.isFavorited() ? 1 : 0));
 
-    res = query.exec();
+    res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
+
+    ErrorString journalError;
+    bool journalRes = appendChangeJournalEntry(ChangeJournalEntry::EntityType::SavedSearch, changeType,
+                                               search.localUid(), QStringList(), journalError);
+    if (!journalRes) {
+        errorDescription.base() = errorPrefix.base();
+        errorDescription.appendBase(journalError.base());
+        errorDescription.appendBase(journalError.additionalBases());
+        errorDescription.details() = journalError.details();
+        return false;
+    }
+
+    return transaction.commit(errorDescription);
+}
+
+bool LocalStorageManagerPrivate::appendChangeJournalEntry(const ChangeJournalEntry::EntityType::type entityType,
+                                                          const ChangeJournalEntry::ChangeType::type changeType,
+                                                          const QString & localUid, const QStringList & changedFields,
+                                                          ErrorString & errorDescription)
+{
+    QNTRACE(QStringLiteral("LocalStorageManagerPrivate::appendChangeJournalEntry: entity type = ") << entityType
+            << QStringLiteral(", change type = ") << changeType << QStringLiteral(", local uid = ") << localUid
+            << QStringLiteral(", changed fields: ") << changedFields.join(QStringLiteral(", ")));
+
+    ErrorString errorPrefix(QT_TR_NOOP("can't append the entry to the local storage's change journal"));
+
+    bool res = checkAndPrepareInsertChangeJournalEntryQuery();
+    QSqlQuery & query = m_insertChangeJournalEntryQuery;
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    QVariant nullValue;
+
+    query.bindValue(QStringLiteral(":entityType"), static_cast<int>(entityType));
+    query.bindValue(QStringLiteral(":changeType"), static_cast<int>(changeType));
+    query.bindValue(QStringLiteral(":localUid"), localUid);
+    query.bindValue(QStringLiteral(":changedFields"), (changedFields.isEmpty()
+                                                       ? nullValue
+                                                       : QVariant(changedFields.join(QStringLiteral(",")))));
+    query.bindValue(QStringLiteral(":timestamp"), QDateTime::currentMSecsSinceEpoch());
+
+    res = execQuery(query);
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    return true;
+}
+
+bool LocalStorageManagerPrivate::appendChangeJournalEntries(const ChangeJournalEntry::EntityType::type entityType,
+                                                            const ChangeJournalEntry::ChangeType::type changeType,
+                                                            const QStringList & localUids, const QStringList & changedFields,
+                                                            ErrorString & errorDescription)
+{
+    for(auto it = localUids.constBegin(), end = localUids.constEnd(); it != end; ++it)
+    {
+        bool res = appendChangeJournalEntry(entityType, changeType, *it, changedFields, errorDescription);
+        if (!res) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LocalStorageManagerPrivate::checkAndPrepareInsertChangeJournalEntryQuery()
+{
+    if (Q_LIKELY(m_insertChangeJournalEntryQueryPrepared)) {
+        return true;
+    }
+
+    QNDEBUG(QStringLiteral("Preparing SQL query to insert the change journal entry"));
+
+    m_insertChangeJournalEntryQuery = QSqlQuery(m_sqlDatabase);
+    bool res = m_insertChangeJournalEntryQuery.prepare(QStringLiteral("INSERT INTO ChangeJournal"
+                                                                      "(entityType, changeType, localUid, changedFields, timestamp) "
+                                                                      "VALUES(:entityType, :changeType, :localUid, :changedFields, :timestamp)"));
+    if (res) {
+        m_insertChangeJournalEntryQueryPrepared = true;
+    }
+
+    return res;
+}
+
+bool LocalStorageManagerPrivate::insertOrReplaceResourceSyncedDataHash(const QString & resourceLocalUid,
+                                                                       const QByteArray & dataHash,
+                                                                       ErrorString & errorDescription)
+{
+    QNTRACE(QStringLiteral("LocalStorageManagerPrivate::insertOrReplaceResourceSyncedDataHash: resource local uid = ")
+            << resourceLocalUid);
+
+    ErrorString errorPrefix(QT_TR_NOOP("can't insert or replace the synchronized data hash of the resource"));
+
+    bool res = checkAndPrepareInsertOrReplaceResourceSyncedDataHashQuery();
+    QSqlQuery & query = m_insertOrReplaceResourceSyncedDataHashQuery;
+    DATABASE_CHECK_AND_SET_ERROR();
+
+    query.bindValue(QStringLiteral(":resourceLocalUid"), resourceLocalUid);
+    query.bindValue(QStringLiteral(":dataHash"), dataHash);
+
+    res = execQuery(query);
+    DATABASE_CHECK_AND_SET_ERROR();
+
     return true;
 }
 
+bool LocalStorageManagerPrivate::checkAndPrepareInsertOrReplaceResourceSyncedDataHashQuery()
+{
+    if (Q_LIKELY(m_insertOrReplaceResourceSyncedDataHashQueryPrepared)) {
+        return true;
+    }
+
+    QNDEBUG(QStringLiteral("Preparing SQL query to insert or replace the synchronized data hash of the resource"));
+
+    m_insertOrReplaceResourceSyncedDataHashQuery = QSqlQuery(m_sqlDatabase);
+    bool res = m_insertOrReplaceResourceSyncedDataHashQuery.prepare(QStringLiteral("INSERT OR REPLACE INTO ResourceSyncedDataHashes"
+                                                                                   "(resourceLocalUid, dataHash) "
+                                                                                   "VALUES(:resourceLocalUid, :dataHash)"));
+    if (res) {
+        m_insertOrReplaceResourceSyncedDataHashQueryPrepared = true;
+    }
+
+    return res;
+}
+
 bool LocalStorageManagerPrivate::checkAndPrepareInsertOrReplaceSavedSearchQuery()
 {
     if (Q_LIKELY(m_insertOrReplaceSavedSearchQueryPrepared)) {
@@ -8905,7 +10400,7 @@ bool LocalStorageManagerPrivate::findAndSetTagIdsPerNote(Note & note, ErrorStrin
     query.prepare(QStringLiteral("SELECT tag, localTag, tagIndexInNote FROM NoteTags WHERE localNote = ?"));
     query.addBindValue(noteLocalUid);
 
-    bool res = query.exec();
+    bool res = execQuery(query);
     DATABASE_CHECK_AND_SET_ERROR();
 
     QMultiHash<int, QString> tagGuidsAndIndices;
@@ -9041,7 +10536,7 @@ bool LocalStorageManagerPrivate::findAndSetResourcesPerNote(Note & note, ErrorSt
     // but the best I was able to do is this. Please be very careful if you think you can do better here...
     QString queryString = QString(QStringLiteral("SELECT * FROM NoteResources"));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     QStringList resourceLocalUids;
@@ -9154,7 +10649,7 @@ bool LocalStorageManagerPrivate::noteSearchQueryToSQL(const NoteSearchQuery & no
     {
         QSqlQuery query(m_sqlDatabase);
         QString notebookQueryString = QString::fromUtf8("SELECT localUid FROM NotebookFTS WHERE notebookName MATCH '%1' LIMIT 1").arg(sqlEscapeString(notebookName));
-        bool res = query.exec(notebookQueryString);
+        bool res = execQuery(query, notebookQueryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         if (Q_UNLIKELY(!query.next())) {
@@ -9939,10 +11434,10 @@ bool LocalStorageManagerPrivate::tagNamesToTagLocalUids(const QStringList & tagN
 
     bool res = false;
     if (queryString.isEmpty()) {
-        res = query.exec();
+        res = execQuery(query);
     }
     else {
-        res = query.exec(queryString);
+        res = execQuery(query, queryString);
     }
     DATABASE_CHECK_AND_SET_ERROR();
 
@@ -10032,10 +11527,10 @@ bool LocalStorageManagerPrivate::resourceMimeTypesToResourceLocalUids(const QStr
 
     bool res = false;
     if (queryString.isEmpty()) {
-        res = query.exec();
+        res = execQuery(query);
     }
     else {
-        res = query.exec(queryString);
+        res = execQuery(query, queryString);
     }
     DATABASE_CHECK_AND_SET_ERROR();
 
@@ -10066,7 +11561,7 @@ bool LocalStorageManagerPrivate::complementResourceNoteIds(Resource & resource,
         QString noteLocalUid = sqlEscapeString(resource.noteLocalUid());
         QString queryString = QString::fromUtf8("SELECT guid FROM Notes WHERE localUid = '%1'").arg(noteLocalUid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         if (query.next()) {
@@ -10078,7 +11573,7 @@ bool LocalStorageManagerPrivate::complementResourceNoteIds(Resource & resource,
         QString noteGuid = sqlEscapeString(resource.noteGuid());
         QString queryString = QString::fromUtf8("SELECT localUid FROM Notes WHERE guid = '%1'").arg(noteGuid);
         QSqlQuery query(m_sqlDatabase);
-        bool res = query.exec(queryString);
+        bool res = execQuery(query, queryString);
         DATABASE_CHECK_AND_SET_ERROR();
 
         if (query.next()) {
@@ -10112,10 +11607,11 @@ bool LocalStorageManagerPrivate::partialUpdateNoteResources(const QString & note
                                                              "ON Resources.resourceLocalUid = ResourceAttributesApplicationDataFullMap.resourceLocalUid "
                                                              "WHERE noteLocalUid='%1'").arg(sqlEscapeString(noteLocalUid));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(listNoteResourcesQueryString);
+    bool res = execQuery(query, listNoteResourcesQueryString);
     DATABASE_CHECK_AND_SET_ERROR();
 
     QList<Resource> previousNoteResources;
+    QSet<QString> previousNoteResourceLocalUids;
 
     QNDEBUG(QStringLiteral("Starting to process the query results"));
 
@@ -10140,6 +11636,7 @@ bool LocalStorageManagerPrivate::partialUpdateNoteResources(const QString & note
 
         fillResourceFromSqlRecord(record, /* with binary data = */ false, resource);
         previousNoteResources << resource;
+        Q_UNUSED(previousNoteResourceLocalUids.insert(resource.localUid()))
     }
 
     // Now figure out which resources were removed from the note and which were added or updated
@@ -10227,7 +11724,7 @@ bool LocalStorageManagerPrivate::partialUpdateNoteResources(const QString & note
     if (!localUidsForResourcesRemovedFromNote.isEmpty()) {
         QString removeResourcesQueryString = QString::fromUtf8("DELETE FROM Resources WHERE resourceLocalUid IN ('%1')")
                                              .arg(localUidsForResourcesRemovedFromNote.join(QStringLiteral(",")));
-        res = query.exec(removeResourcesQueryString);
+        res = execQuery(query, removeResourcesQueryString);
         DATABASE_CHECK_AND_SET_ERROR();
     }
 
@@ -10250,8 +11747,12 @@ bool LocalStorageManagerPrivate::partialUpdateNoteResources(const QString & note
             return false;
         }
 
+        ChangeJournalEntry::ChangeType::type changeType = (previousNoteResourceLocalUids.contains(resource.localUid())
+                                                           ? ChangeJournalEntry::ChangeType::Update
+                                                           : ChangeJournalEntry::ChangeType::Add);
+
         error.clear();
-        res = insertOrReplaceResource(resource, error, /* useSeparateTransaction = */ false);
+        res = insertOrReplaceResource(resource, changeType, error, /* useSeparateTransaction = */ false);
         if (!res) {
             errorDescription.base() = errorPrefix.base();
             errorDescription.appendBase(QT_TR_NOOP("can't add or update one of note's resources"));
@@ -10323,6 +11824,7 @@ void LocalStorageManagerPrivate::clearCachedQueries()
     m_insertOrReplaceUserAttributesViewedPromotionsQueryPrepared = false;
     m_insertOrReplaceUserAttributesRecentMailedAddressesQueryPrepared = false;
     m_deleteUserQueryPrepared = false;
+    m_insertChangeJournalEntryQueryPrepared = false;
 }
 
 template <class T>
@@ -10845,7 +12347,7 @@ QList<T> LocalStorageManagerPrivate::listObjects(const LocalStorageManager::List
 
     ErrorString errorPrefix(QT_TR_NOOP("can't list objects from the local storage database by filter"));
     QSqlQuery query(m_sqlDatabase);
-    bool res = query.exec(queryString);
+    bool res = execQuery(query, queryString);
     if (!res) {
         errorDescription.base() = errorPrefix.base();
         QNERROR(errorDescription << QStringLiteral(", last query = ") << query.lastQuery()
@@ -12,6 +12,7 @@
 #include <quentier/types/LinkedNotebook.h>
 #include <quentier/types/SavedSearch.h>
 #include <quentier/utility/StringUtils.h>
+#include "LocalStorageStatisticsCollector.h"
 #include <QtSql>
 
 // Prevent boost::interprocess from automatic linkage to boost::datetime
@@ -85,7 +86,9 @@ public:
     int noteCountPerTag(const Tag & tag, ErrorString & errorDescription) const;
     bool noteCountsPerAllTags(QHash<QString, int> & noteCountsPerTagLocalUid, ErrorString & errorDescription) const;
     bool addNote(Note & note, ErrorString & errorDescription);
-    bool updateNote(Note & note, const bool updateResources, const bool updateTags, ErrorString & errorDescription);
+    bool updateNote(Note & note, const bool updateResources, const bool updateTags, ErrorString & errorDescription,
+                    const bool useSeparateTransaction = true);
+    bool updateNotes(QList<Note> & notes, const bool updateResources, const bool updateTags, ErrorString & errorDescription);
     bool findNote(Note & note, ErrorString & errorDescription,
                   const bool withResourceBinaryData = true) const;
     QList<Note> listNotesPerNotebook(const Notebook & notebook, ErrorString & errorDescription,
@@ -154,6 +157,32 @@ public:
 
     qint32 accountHighUsn(const QString & linkedNotebookGuid, ErrorString & errorDescription);
 
+    QList<ChangeJournalEntry> listChangesSince(const qint64 sequenceNumber, ErrorString & errorDescription,
+                                               const size_t limit) const;
+    qint64 lastChangeSequenceNumber(ErrorString & errorDescription) const;
+    bool trimChangeJournal(const qint64 upToSequenceNumber, ErrorString & errorDescription);
+
+    QHash<QString,QByteArray> listResourceSyncedDataHashes(const QStringList & noteLocalUids,
+                                                           ErrorString & errorDescription) const;
+
+    LocalStorageStatistics statistics() const;
+    void resetStatistics();
+    bool statisticsCollectionEnabled() const;
+    void setStatisticsCollectionEnabled(const bool enabled);
+    void setSlowQueryThreshold(const qint64 thresholdUsec);
+
+    bool exportSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                        ErrorString & errorDescription);
+    bool importSnapshot(const QString & snapshotFilePath, LocalStorageSnapshotInfo & snapshotInfo,
+                        ErrorString & errorDescription);
+
+    bool expungeStaleDataItems(const QSet<QString> & syncedNotebookGuids, const QSet<QString> & syncedTagGuids,
+                               const QSet<QString> & syncedNoteGuids, const QSet<QString> & syncedSavedSearchGuids,
+                               const QString & linkedNotebookGuid, StaleDataItemsExpungeResult & result,
+                               ErrorString & errorDescription);
+
+    LocalStorageStatisticsCollector & statisticsCollector() const { return m_statisticsCollector; }
+
     bool updateSequenceNumberFromTable(const QString & tableName, const QString & usnColumnName,
                                        const QString & queryCondition,
                                        qint32 & usn, ErrorString & errorDescription);
@@ -166,10 +195,30 @@ private:
     Q_DISABLE_COPY(LocalStorageManagerPrivate)
 
     void unlockDatabaseFile();
+    void openDatabase();
+
+    bool collectSnapshotInfo(LocalStorageSnapshotInfo & snapshotInfo, ErrorString & errorDescription);
+    bool writeSnapshotInfo(QSqlDatabase & snapshotDatabase, const LocalStorageSnapshotInfo & snapshotInfo,
+                           ErrorString & errorDescription) const;
+    bool readSnapshotInfo(QSqlDatabase & snapshotDatabase, const QStringList & expectedTableNames,
+                          LocalStorageSnapshotInfo & snapshotInfo, ErrorString & errorDescription) const;
+    bool copyFileContents(const QString & sourceFilePath, const QString & targetFilePath,
+                          ErrorString & errorDescription) const;
+    bool moveDatabaseFileWithAuxiliaryFiles(const QString & sourceFilePath, const QString & targetFilePath) const;
+    void removeDatabaseFileWithAuxiliaryFiles(const QString & filePath) const;
+    bool relockAndOpenDatabase(ErrorString & errorDescription);
+
+    bool fillSyncedGuidsTable(const QString & tableName, const QSet<QString> & guids, ErrorString & errorDescription);
+    bool listLocalUidsFromQuery(const QString & queryString, QStringList & localUids, ErrorString & errorDescription);
 
     QString sqlEscapeString(const QString & str) const;
     QString lastExecutedQuery(const QSqlQuery & query) const;
 
+    // NOTE: all SQL queries except for the transaction control ones are executed via this method
+    // in order to collect the statistics of their durations and to log the slow ones
+    bool execQuery(QSqlQuery & query, const QString & queryString = QString()) const;
+    QString explainQueryPlan(const QSqlQuery & query) const;
+
     bool createTables(ErrorString & errorDescription);
     bool insertOrReplaceNotebookRestrictions(const QString & localUid, const qevercloud::NotebookRestrictions & notebookRestrictions,
                                              ErrorString & errorDescription);
@@ -198,13 +247,15 @@ private:
     bool checkAndPrepareInsertOrReplaceUserAttributesRecentMailedAddressesQuery();
     bool checkAndPrepareDeleteUserQuery();
 
-    bool insertOrReplaceNotebook(const Notebook & notebook, ErrorString & errorDescription);
+    bool insertOrReplaceNotebook(const Notebook & notebook, const ChangeJournalEntry::ChangeType::type changeType,
+                                 ErrorString & errorDescription);
     bool checkAndPrepareNotebookCountQuery() const;
     bool checkAndPrepareInsertOrReplaceNotebookQuery();
     bool checkAndPrepareInsertOrReplaceNotebookRestrictionsQuery();
     bool checkAndPrepareInsertOrReplaceSharedNotebookQuery();
 
-    bool insertOrReplaceLinkedNotebook(const LinkedNotebook & linkedNotebook, ErrorString & errorDescription);
+    bool insertOrReplaceLinkedNotebook(const LinkedNotebook & linkedNotebook, const ChangeJournalEntry::ChangeType::type changeType,
+                                       ErrorString & errorDescription);
     bool checkAndPrepareGetLinkedNotebookCountQuery() const;
     bool checkAndPrepareInsertOrReplaceLinkedNotebookQuery();
 
@@ -217,7 +268,9 @@ private:
     bool getResourceLocalUidForGuid(const QString & resourceGuid, QString & resourceLocalUid, ErrorString & errorDescription);
     bool getSavedSearchLocalUidForGuid(const QString & savedSearchGuid, QString & savedSearchLocalUid, ErrorString & errorDescription);
 
-    bool insertOrReplaceNote(Note & note, const bool updateResources, const bool updateTags, ErrorString & errorDescription);
+    bool insertOrReplaceNote(Note & note, const bool updateResources, const bool updateTags,
+                             const ChangeJournalEntry::ChangeType::type changeType, ErrorString & errorDescription,
+                             const bool useSeparateTransaction = true);
     bool insertOrReplaceSharedNote(const SharedNote & sharedNote, ErrorString & errorDescription);
     bool insertOrReplaceNoteRestrictions(const QString & noteLocalUid, const qevercloud::NoteRestrictions & noteRestrictions,
                                          ErrorString & errorDescription);
@@ -234,14 +287,15 @@ private:
     bool checkAndPrepareCanExpungeNoteInNotebookQuery() const;
     bool checkAndPrepareInsertOrReplaceNoteIntoNoteTagsQuery();
 
-    bool insertOrReplaceTag(const Tag & tag, ErrorString & errorDescription);
+    bool insertOrReplaceTag(const Tag & tag, const ChangeJournalEntry::ChangeType::type changeType,
+                            ErrorString & errorDescription);
     bool checkAndPrepareTagCountQuery() const;
     bool checkAndPrepareInsertOrReplaceTagQuery();
     bool checkAndPrepareDeleteTagQuery();
     bool complementTagParentInfo(Tag & tag, ErrorString & errorDescription);
 
-    bool insertOrReplaceResource(const Resource & resource, ErrorString & errorDescription,
-                                 const bool useSeparateTransaction = true);
+    bool insertOrReplaceResource(const Resource & resource, const ChangeJournalEntry::ChangeType::type changeType,
+                                 ErrorString & errorDescription, const bool useSeparateTransaction = true);
     bool insertOrReplaceResourceAttributes(const QString & localUid,
                                            const qevercloud::ResourceAttributes & attributes,
                                            ErrorString & errorDescription);
@@ -260,11 +314,26 @@ private:
     bool checkAndPrepareInsertOrReplaceResourceAttributesApplicationDataFullMapQuery();
     bool checkAndPrepareResourceCountQuery() const;
 
-    bool insertOrReplaceSavedSearch(const SavedSearch & search, ErrorString & errorDescription);
+    bool insertOrReplaceSavedSearch(const SavedSearch & search, const ChangeJournalEntry::ChangeType::type changeType,
+                                    ErrorString & errorDescription);
     bool checkAndPrepareInsertOrReplaceSavedSearchQuery();
     bool checkAndPrepareGetSavedSearchCountQuery() const;
     bool checkAndPrepareExpungeSavedSearchQuery();
 
+    bool appendChangeJournalEntry(const ChangeJournalEntry::EntityType::type entityType,
+                                  const ChangeJournalEntry::ChangeType::type changeType,
+                                  const QString & localUid, const QStringList & changedFields,
+                                  ErrorString & errorDescription);
+    bool appendChangeJournalEntries(const ChangeJournalEntry::EntityType::type entityType,
+                                    const ChangeJournalEntry::ChangeType::type changeType,
+                                    const QStringList & localUids, const QStringList & changedFields,
+                                    ErrorString & errorDescription);
+    bool checkAndPrepareInsertChangeJournalEntryQuery();
+
+    bool insertOrReplaceResourceSyncedDataHash(const QString & resourceLocalUid, const QByteArray & dataHash,
+                                               ErrorString & errorDescription);
+    bool checkAndPrepareInsertOrReplaceResourceSyncedDataHashQuery();
+
     void fillResourceFromSqlRecord(const QSqlRecord & rec, const bool withBinaryData, Resource & resource) const;
     bool fillResourceAttributesFromSqlRecord(const QSqlRecord & rec, qevercloud::ResourceAttributes & attributes) const;
     bool fillResourceAttributesApplicationDataKeysOnlyFromSqlRecord(const QSqlRecord & rec, qevercloud::ResourceAttributes & attributes) const;
@@ -509,8 +578,16 @@ private:
     QSqlQuery           m_deleteUserQuery;
     bool                m_deleteUserQueryPrepared;
 
+    QSqlQuery           m_insertChangeJournalEntryQuery;
+    bool                m_insertChangeJournalEntryQueryPrepared;
+
+    QSqlQuery           m_insertOrReplaceResourceSyncedDataHashQuery;
+    bool                m_insertOrReplaceResourceSyncedDataHashQueryPrepared;
+
     StringUtils         m_stringUtils;
     QVector<QChar>      m_preservedAsterisk;
+
+    mutable LocalStorageStatisticsCollector     m_statisticsCollector;
 };
 
 } // namespace quentier
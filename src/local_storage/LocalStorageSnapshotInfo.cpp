@@ -0,0 +1,50 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <quentier/local_storage/LocalStorageSnapshotInfo.h>
+#include <quentier/utility/Utility.h>
+
+namespace quentier {
+
+LocalStorageSnapshotInfo::LocalStorageSnapshotInfo() :
+    Printable(),
+    highUsn(-1),
+    highUsnByLinkedNotebookGuid(),
+    creationTimestamp(0)
+{}
+
+LocalStorageSnapshotInfo::~LocalStorageSnapshotInfo()
+{}
+
+QTextStream & LocalStorageSnapshotInfo::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("LocalStorageSnapshotInfo: {\n");
+    strm << QStringLiteral("  high USN = ") << highUsn << QStringLiteral(";\n");
+    strm << QStringLiteral("  creation timestamp = ") << printableDateTimeFromTimestamp(creationTimestamp)
+         << QStringLiteral(";\n");
+
+    for(auto it = highUsnByLinkedNotebookGuid.constBegin(), end = highUsnByLinkedNotebookGuid.constEnd(); it != end; ++it) {
+        strm << QStringLiteral("  linked notebook guid = ") << it.key() << QStringLiteral(", high USN = ")
+             << it.value() << QStringLiteral(";\n");
+    }
+
+    strm << QStringLiteral("}\n");
+    return strm;
+}
+
+} // namespace quentier
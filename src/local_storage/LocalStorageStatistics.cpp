@@ -0,0 +1,127 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <quentier/local_storage/LocalStorageStatistics.h>
+#include <quentier/utility/Utility.h>
+
+namespace quentier {
+
+LocalStorageStatistics::OperationStatistics::OperationStatistics() :
+    count(0),
+    totalDurationUsec(0),
+    maxDurationUsec(0),
+    latencyHistogram(LocalStorageStatistics::latencyHistogramBucketUpperBoundsUsec().size() + 1, 0)
+{}
+
+LocalStorageStatistics::QueryStatistics::QueryStatistics() :
+    count(0),
+    failedCount(0),
+    totalDurationUsec(0),
+    maxDurationUsec(0),
+    rowsAffected(0)
+{}
+
+LocalStorageStatistics::SlowQuery::SlowQuery() :
+    query(),
+    queryPlan(),
+    durationUsec(0),
+    timestamp(0)
+{}
+
+LocalStorageStatistics::LocalStorageStatistics() :
+    Printable(),
+    operations(),
+    queries(),
+    slowQueries(),
+    slowQueryThresholdUsec(0),
+    collectionStartTimestamp(0)
+{}
+
+LocalStorageStatistics::~LocalStorageStatistics()
+{}
+
+QVector<qint64> LocalStorageStatistics::latencyHistogramBucketUpperBoundsUsec()
+{
+    QVector<qint64> bounds;
+    bounds.reserve(9);
+    bounds << 100 << 500 << 1000 << 5000 << 10000 << 50000 << 100000 << 500000 << 1000000;
+    return bounds;
+}
+
+QTextStream & LocalStorageStatistics::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("LocalStorageStatistics: {\n");
+    strm << QStringLiteral("  collected since: ") << printableDateTimeFromTimestamp(collectionStartTimestamp)
+         << QStringLiteral(";\n");
+
+    QVector<qint64> bounds = latencyHistogramBucketUpperBoundsUsec();
+
+    strm << QStringLiteral("  operations: {\n");
+    for(auto it = operations.constBegin(), end = operations.constEnd(); it != end; ++it)
+    {
+        const OperationStatistics & stats = it.value();
+        strm << QStringLiteral("    ") << it.key() << QStringLiteral(": count = ") << stats.count
+             << QStringLiteral(", total = ") << stats.totalDurationUsec << QStringLiteral(" usec, max = ")
+             << stats.maxDurationUsec << QStringLiteral(" usec, histogram: ");
+
+        for(int i = 0, size = stats.latencyHistogram.size(); i < size; ++i)
+        {
+            if (i < bounds.size()) {
+                strm << QStringLiteral("<=") << bounds[i];
+            }
+            else {
+                strm << QStringLiteral(">") << bounds.back();
+            }
+
+            strm << QStringLiteral(": ") << stats.latencyHistogram[i];
+            if (i != (size - 1)) {
+                strm << QStringLiteral(", ");
+            }
+        }
+
+        strm << QStringLiteral(";\n");
+    }
+    strm << QStringLiteral("  };\n");
+
+    strm << QStringLiteral("  queries: {\n");
+    for(auto it = queries.constBegin(), end = queries.constEnd(); it != end; ++it)
+    {
+        const QueryStatistics & stats = it.value();
+        strm << QStringLiteral("    ") << it.key() << QStringLiteral(": count = ") << stats.count
+             << QStringLiteral(", failed = ") << stats.failedCount << QStringLiteral(", total = ")
+             << stats.totalDurationUsec << QStringLiteral(" usec, max = ") << stats.maxDurationUsec
+             << QStringLiteral(" usec, rows affected = ") << stats.rowsAffected << QStringLiteral(";\n");
+    }
+    strm << QStringLiteral("  };\n");
+
+    strm << QStringLiteral("  slow query threshold = ") << slowQueryThresholdUsec << QStringLiteral(" usec;\n");
+    strm << QStringLiteral("  slow queries: {\n");
+    for(auto it = slowQueries.constBegin(), end = slowQueries.constEnd(); it != end; ++it)
+    {
+        const SlowQuery & slowQuery = *it;
+        strm << QStringLiteral("    [") << printableDateTimeFromTimestamp(slowQuery.timestamp)
+             << QStringLiteral("] ") << slowQuery.durationUsec << QStringLiteral(" usec: ") << slowQuery.query
+             << QStringLiteral("; query plan: ") << slowQuery.queryPlan << QStringLiteral(";\n");
+    }
+    strm << QStringLiteral("  };\n");
+
+    strm << QStringLiteral("};\n");
+    return strm;
+}
+
+} // namespace quentier
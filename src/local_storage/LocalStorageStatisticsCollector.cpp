@@ -0,0 +1,169 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocalStorageStatisticsCollector.h"
+#include <QDateTime>
+#include <algorithm>
+
+#define DEFAULT_SLOW_QUERY_THRESHOLD_USEC (50000)
+#define MAX_SLOW_QUERY_LOG_SIZE (50)
+#define MAX_CACHED_QUERY_SHAPES (500)
+
+// Longer queries are mostly the ones with long lists of literal values which hardly ever repeat exactly
+// so there's no point in caching their shapes
+#define MAX_CACHED_QUERY_LENGTH (1024)
+
+namespace quentier {
+
+LocalStorageStatisticsCollector::LocalStorageStatisticsCollector() :
+    m_enabled(true),
+    m_statistics(),
+    m_latencyHistogramBucketUpperBoundsUsec(LocalStorageStatistics::latencyHistogramBucketUpperBoundsUsec()),
+    // String literals, with escaped single quotes inside them
+    m_stringLiteralRegExp(QStringLiteral("'([^']|'')*'")),
+    // Numeric literals
+    m_numericLiteralRegExp(QStringLiteral("\\b\\d+(\\.\\d+)?\\b")),
+    // Lists of values of variable length, i.e. within "IN (...)" clauses
+    m_valuesListRegExp(QStringLiteral("\\?(\\s*,\\s*\\?)+")),
+    m_queryShapesByQuery()
+{
+    m_statistics.slowQueryThresholdUsec = DEFAULT_SLOW_QUERY_THRESHOLD_USEC;
+    m_statistics.collectionStartTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+void LocalStorageStatisticsCollector::recordOperation(const QString & operationName, const qint64 durationUsec)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    LocalStorageStatistics::OperationStatistics & stats = m_statistics.operations[operationName];
+    ++stats.count;
+    stats.totalDurationUsec += durationUsec;
+    stats.maxDurationUsec = std::max(stats.maxDurationUsec, durationUsec);
+
+    int bucketIndex = 0;
+    for(int size = m_latencyHistogramBucketUpperBoundsUsec.size(); bucketIndex < size; ++bucketIndex)
+    {
+        if (durationUsec <= m_latencyHistogramBucketUpperBoundsUsec[bucketIndex]) {
+            break;
+        }
+    }
+
+    ++stats.latencyHistogram[bucketIndex];
+}
+
+void LocalStorageStatisticsCollector::recordQuery(const QString & query, const bool prepared, const qint64 durationUsec,
+                                                  const bool succeeded, const int rowsAffected)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    // NOTE: the text of the prepared query contains only placeholders so it is the shape already,
+    // no need to spend time on normalizing it
+    LocalStorageStatistics::QueryStatistics & stats = m_statistics.queries[prepared ? query : queryShape(query)];
+    ++stats.count;
+    if (!succeeded) {
+        ++stats.failedCount;
+    }
+
+    stats.totalDurationUsec += durationUsec;
+    stats.maxDurationUsec = std::max(stats.maxDurationUsec, durationUsec);
+
+    if (rowsAffected > 0) {
+        stats.rowsAffected += static_cast<quint64>(rowsAffected);
+    }
+}
+
+void LocalStorageStatisticsCollector::recordSlowQuery(const QString & query, const QString & queryPlan,
+                                                      const qint64 durationUsec)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    LocalStorageStatistics::SlowQuery slowQuery;
+    slowQuery.query = query;
+    slowQuery.queryPlan = queryPlan;
+    slowQuery.durationUsec = durationUsec;
+    slowQuery.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    m_statistics.slowQueries << slowQuery;
+    while(m_statistics.slowQueries.size() > MAX_SLOW_QUERY_LOG_SIZE) {
+        m_statistics.slowQueries.removeFirst();
+    }
+}
+
+void LocalStorageStatisticsCollector::reset()
+{
+    qint64 slowQueryThresholdUsec = m_statistics.slowQueryThresholdUsec;
+
+    m_statistics = LocalStorageStatistics();
+    m_statistics.slowQueryThresholdUsec = slowQueryThresholdUsec;
+    m_statistics.collectionStartTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+QString LocalStorageStatisticsCollector::queryShape(const QString & query)
+{
+    const bool cacheable = (query.size() <= MAX_CACHED_QUERY_LENGTH);
+    if (cacheable)
+    {
+        auto it = m_queryShapesByQuery.constFind(query);
+        if (it != m_queryShapesByQuery.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QString shape = query.simplified();
+    shape.replace(m_stringLiteralRegExp, QStringLiteral("?"));
+    shape.replace(m_numericLiteralRegExp, QStringLiteral("?"));
+    shape.replace(m_valuesListRegExp, QStringLiteral("?"));
+
+    if (cacheable)
+    {
+        if (m_queryShapesByQuery.size() >= MAX_CACHED_QUERY_SHAPES) {
+            m_queryShapesByQuery.clear();
+        }
+
+        m_queryShapesByQuery[query] = shape;
+    }
+
+    return shape;
+}
+
+LocalStorageOperationTimer::LocalStorageOperationTimer(LocalStorageStatisticsCollector & collector,
+                                                       const QString & operationName) :
+    m_collector(collector),
+    m_operationName(operationName),
+    m_timer(),
+    m_started(collector.isEnabled())
+{
+    if (m_started) {
+        m_timer.start();
+    }
+}
+
+LocalStorageOperationTimer::~LocalStorageOperationTimer()
+{
+    if (m_started) {
+        m_collector.recordOperation(m_operationName, m_timer.nsecsElapsed() / 1000);
+    }
+}
+
+} // namespace quentier
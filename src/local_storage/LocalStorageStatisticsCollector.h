@@ -0,0 +1,97 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_COLLECTOR_H
+#define LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_COLLECTOR_H
+
+#include <quentier/local_storage/LocalStorageStatistics.h>
+#include <QElapsedTimer>
+#include <QRegExp>
+#include <QHash>
+
+namespace quentier {
+
+/**
+ * @brief The LocalStorageStatisticsCollector class accumulates the performance statistics of LocalStorageManager;
+ * it is owned by LocalStorageManagerPrivate and is not thread-safe, just like LocalStorageManager itself
+ */
+class Q_DECL_HIDDEN LocalStorageStatisticsCollector
+{
+public:
+    LocalStorageStatisticsCollector();
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(const bool enabled) { m_enabled = enabled; }
+
+    qint64 slowQueryThresholdUsec() const { return m_statistics.slowQueryThresholdUsec; }
+    void setSlowQueryThresholdUsec(const qint64 thresholdUsec) { m_statistics.slowQueryThresholdUsec = thresholdUsec; }
+
+    void recordOperation(const QString & operationName, const qint64 durationUsec);
+    void recordQuery(const QString & query, const bool prepared, const qint64 durationUsec,
+                     const bool succeeded, const int rowsAffected);
+    void recordSlowQuery(const QString & query, const QString & queryPlan, const qint64 durationUsec);
+
+    const LocalStorageStatistics & statistics() const { return m_statistics; }
+    void reset();
+
+    /**
+     * @brief queryShape - replaces the literal values within the SQL query with placeholders
+     * so that the queries differing only in literal values produce the same shape; the shapes of recently seen
+     * queries are cached so that the same ad-hoc query isn't normalized over and over again
+     */
+    QString queryShape(const QString & query);
+
+private:
+    Q_DISABLE_COPY(LocalStorageStatisticsCollector)
+
+private:
+    bool                        m_enabled;
+    LocalStorageStatistics      m_statistics;
+    QVector<qint64>             m_latencyHistogramBucketUpperBoundsUsec;
+
+    // The regular expressions used for the computation of query shapes are compiled only once
+    QRegExp                     m_stringLiteralRegExp;
+    QRegExp                     m_numericLiteralRegExp;
+    QRegExp                     m_valuesListRegExp;
+
+    QHash<QString,QString>      m_queryShapesByQuery;
+};
+
+/**
+ * @brief The LocalStorageOperationTimer class measures the duration of LocalStorageManager's operation
+ * from its construction until its destruction and records it into the statistics collector
+ */
+class Q_DECL_HIDDEN LocalStorageOperationTimer
+{
+public:
+    LocalStorageOperationTimer(LocalStorageStatisticsCollector & collector, const QString & operationName);
+    ~LocalStorageOperationTimer();
+
+private:
+    Q_DISABLE_COPY(LocalStorageOperationTimer)
+
+private:
+    LocalStorageStatisticsCollector &   m_collector;
+    QString                             m_operationName;
+    QElapsedTimer                       m_timer;
+    bool                                m_started;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_LOCAL_STORAGE_LOCAL_STORAGE_STATISTICS_COLLECTOR_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <quentier/local_storage/StaleDataItemsExpungeResult.h>
+
+namespace quentier {
+
+StaleDataItemsExpungeResult::StaleDataItemsExpungeResult() :
+    Printable(),
+    expungedNotebookLocalUids(),
+    expungedTagLocalUids(),
+    expungedNoteLocalUids(),
+    expungedSavedSearchLocalUids(),
+    detachedNotebookLocalUids(),
+    detachedTagLocalUids(),
+    detachedNoteLocalUids(),
+    detachedSavedSearchLocalUids()
+{}
+
+StaleDataItemsExpungeResult::~StaleDataItemsExpungeResult()
+{}
+
+bool StaleDataItemsExpungeResult::isEmpty() const
+{
+    return expungedNotebookLocalUids.isEmpty() &&
+           expungedTagLocalUids.isEmpty() &&
+           expungedNoteLocalUids.isEmpty() &&
+           expungedSavedSearchLocalUids.isEmpty() &&
+           detachedNotebookLocalUids.isEmpty() &&
+           detachedTagLocalUids.isEmpty() &&
+           detachedNoteLocalUids.isEmpty() &&
+           detachedSavedSearchLocalUids.isEmpty();
+}
+
+QTextStream & StaleDataItemsExpungeResult::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("StaleDataItemsExpungeResult: {\n");
+
+#define PRINT_LOCAL_UIDS(name) \
+    strm << QStringLiteral("  " #name ": ") << name.join(QStringLiteral(", ")) << QStringLiteral(";\n")
+
+    PRINT_LOCAL_UIDS(expungedNotebookLocalUids);
+    PRINT_LOCAL_UIDS(expungedTagLocalUids);
+    PRINT_LOCAL_UIDS(expungedNoteLocalUids);
+    PRINT_LOCAL_UIDS(expungedSavedSearchLocalUids);
+    PRINT_LOCAL_UIDS(detachedNotebookLocalUids);
+    PRINT_LOCAL_UIDS(detachedTagLocalUids);
+    PRINT_LOCAL_UIDS(detachedNoteLocalUids);
+    PRINT_LOCAL_UIDS(detachedSavedSearchLocalUids);
+
+#undef PRINT_LOCAL_UIDS
+
+    strm << QStringLiteral("}\n");
+    return strm;
+}
+
+} // namespace quentier
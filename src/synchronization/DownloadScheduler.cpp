@@ -0,0 +1,373 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DownloadScheduler.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QPair>
+#include <algorithm>
+
+// The window of downloads in flight the scheduler starts with; it grows from here up to the max window
+// as long as the downloads don't hit the rate limit
+#define DOWNLOAD_SCHEDULER_INITIAL_WINDOW (4)
+
+#define DOWNLOAD_SCHEDULER_DEFAULT_MAX_WINDOW (10)
+
+namespace quentier {
+
+DownloadScheduler::DownloadScheduler() :
+    m_maxWindow(DOWNLOAD_SCHEDULER_DEFAULT_MAX_WINDOW),
+    m_window(std::min(DOWNLOAD_SCHEDULER_INITIAL_WINDOW, DOWNLOAD_SCHEDULER_DEFAULT_MAX_WINDOW)),
+    m_backoffEndTimestamp(0),
+    m_nextSequenceNumber(0),
+    m_queue(),
+    m_inFlightNotesByGuid(),
+    m_inFlightResourcesByGuid(),
+    m_metrics()
+{
+    updateMetrics();
+}
+
+void DownloadScheduler::setMaxWindow(const int maxWindow)
+{
+    QNDEBUG(QStringLiteral("DownloadScheduler::setMaxWindow: ") << maxWindow);
+
+    m_maxWindow = std::max(maxWindow, 1);
+    m_window = std::min(m_window, static_cast<double>(m_maxWindow));
+    updateMetrics();
+}
+
+int DownloadScheduler::window() const
+{
+    return std::max(1, std::min(m_maxWindow, static_cast<int>(m_window)));
+}
+
+void DownloadScheduler::enqueue(const Download & download, const qint64 timestamp)
+{
+    QNTRACE(QStringLiteral("DownloadScheduler::enqueue: guid = ") << download.guid()
+            << QStringLiteral(", type = ") << ((download.m_type == DownloadType::Note) ? QStringLiteral("note") : QStringLiteral("resource"))
+            << QStringLiteral(", estimated size = ") << download.m_estimatedSize);
+
+    QueueKey key = queueKey(download, m_nextSequenceNumber++);
+
+    Download & queuedDownload = m_queue[key];
+    queuedDownload = download;
+    queuedDownload.m_enqueueTimestamp = timestamp;
+
+    ++m_metrics.m_numEnqueued;
+    updateMetrics();
+}
+
+bool DownloadScheduler::takeNext(Download & download, const qint64 timestamp)
+{
+    if (m_queue.isEmpty()) {
+        return false;
+    }
+
+    if (backoffRemainingMsec(timestamp) > 0) {
+        QNTRACE(QStringLiteral("Waiting for the rate limit to expire"));
+        return false;
+    }
+
+    if (numInFlight() >= window()) {
+        QNTRACE(QStringLiteral("The window of downloads in flight is full: ") << window());
+        return false;
+    }
+
+    auto it = m_queue.begin();
+    download = it.value();
+    Q_UNUSED(m_queue.erase(it))
+
+    if (download.m_type == DownloadType::Note) {
+        m_inFlightNotesByGuid[download.guid()] = download;
+    }
+    else {
+        m_inFlightResourcesByGuid[download.guid()] = download;
+    }
+
+    if (m_metrics.m_numStarted == 0) {
+        m_metrics.m_firstStartTimestamp = timestamp;
+    }
+
+    ++m_metrics.m_numStarted;
+    m_metrics.m_totalQueueWaitMsec += std::max(Q_INT64_C(0), timestamp - download.m_enqueueTimestamp);
+    updateMetrics();
+
+    QNTRACE(QStringLiteral("Starting the download: guid = ") << download.guid() << QStringLiteral(", in flight: ")
+            << numInFlight() << QStringLiteral(", window = ") << window() << QStringLiteral(", queue depth = ")
+            << m_queue.size());
+    return true;
+}
+
+bool DownloadScheduler::onDownloadFinished(const DownloadType::type type, const QString & guid, const qint64 timestamp,
+                                           Download & download)
+{
+    if (!takeInFlightDownload(type, guid, download)) {
+        return false;
+    }
+
+    // Additive increase: the window grows by one download per window's worth of finished downloads
+    m_window = std::min(m_window + 1.0 / m_window, static_cast<double>(m_maxWindow));
+
+    ++m_metrics.m_numFinished;
+    m_metrics.m_lastFinishTimestamp = timestamp;
+    updateMetrics();
+    return true;
+}
+
+bool DownloadScheduler::onRateLimitReached(const DownloadType::type type, const QString & guid, const qint32 rateLimitSeconds,
+                                           const qint64 timestamp, Download & download)
+{
+    QNDEBUG(QStringLiteral("DownloadScheduler::onRateLimitReached: guid = ") << guid
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds);
+
+    bool res = takeInFlightDownload(type, guid, download);
+
+    ++m_metrics.m_numRateLimitHits;
+
+    qint64 backoffEndTimestamp = timestamp + static_cast<qint64>(std::max(rateLimitSeconds, 0)) * 1000;
+    if (backoffEndTimestamp <= m_backoffEndTimestamp) {
+        // The downloads which were in flight simultaneously hit the same rate limit, it has already been accounted for
+        updateMetrics();
+        return res;
+    }
+
+    // Multiplicative decrease, but only once per rate limit: the downloads in flight at the moment are likely to hit it too
+    if (m_backoffEndTimestamp <= timestamp) {
+        m_window = std::max(1.0, m_window / 2.0);
+        m_metrics.m_totalBackoffMsec += (backoffEndTimestamp - timestamp);
+    }
+    else {
+        m_metrics.m_totalBackoffMsec += (backoffEndTimestamp - m_backoffEndTimestamp);
+    }
+
+    m_backoffEndTimestamp = backoffEndTimestamp;
+    updateMetrics();
+
+    QNDEBUG(QStringLiteral("Holding back all downloads for ") << (m_backoffEndTimestamp - timestamp)
+            << QStringLiteral(" msec, the window of downloads in flight is now ") << window());
+    return res;
+}
+
+qint64 DownloadScheduler::backoffRemainingMsec(const qint64 timestamp) const
+{
+    return std::max(Q_INT64_C(0), m_backoffEndTimestamp - timestamp);
+}
+
+QList<DownloadScheduler::Download> DownloadScheduler::downloads() const
+{
+    QList<Download> result = m_queue.values();
+    result << m_inFlightNotesByGuid.values();
+    result << m_inFlightResourcesByGuid.values();
+    return result;
+}
+
+int DownloadScheduler::setUrgency(const QHash<QString,Urgency::type> & urgenciesByNoteGuid)
+{
+    QNDEBUG(QStringLiteral("DownloadScheduler::setUrgency: ") << urgenciesByNoteGuid.size() << QStringLiteral(" notes"));
+
+    if (urgenciesByNoteGuid.isEmpty()) {
+        return 0;
+    }
+
+    QList<QPair<QueueKey,Download> > changedDownloads;
+    for(auto it = m_queue.begin(); it != m_queue.end(); )
+    {
+        const Download & download = it.value();
+        auto urgencyIt = urgenciesByNoteGuid.find(download.m_note.hasGuid() ? download.m_note.guid() : QString());
+        if ((urgencyIt == urgenciesByNoteGuid.end()) || (urgencyIt.value() == download.m_urgency)) {
+            ++it;
+            continue;
+        }
+
+        Download changedDownload = download;
+        changedDownload.m_urgency = urgencyIt.value();
+
+        // NOTE: the sequence number is preserved to keep the order of downloads which keys are otherwise equal
+        changedDownloads << QPair<QueueKey,Download>(queueKey(changedDownload, it.key().m_sequenceNumber), changedDownload);
+        it = m_queue.erase(it);
+    }
+
+    for(auto it = changedDownloads.constBegin(), end = changedDownloads.constEnd(); it != end; ++it) {
+        m_queue[it->first] = it->second;
+    }
+
+    QNDEBUG(QStringLiteral("Changed the urgency of ") << changedDownloads.size() << QStringLiteral(" queued downloads"));
+    return changedDownloads.size();
+}
+
+void DownloadScheduler::clear()
+{
+    QNDEBUG(QStringLiteral("DownloadScheduler::clear"));
+
+    m_window = std::min(DOWNLOAD_SCHEDULER_INITIAL_WINDOW, m_maxWindow);
+    m_backoffEndTimestamp = 0;
+    m_nextSequenceNumber = 0;
+
+    m_queue.clear();
+    m_inFlightNotesByGuid.clear();
+    m_inFlightResourcesByGuid.clear();
+
+    m_metrics = Metrics();
+    updateMetrics();
+}
+
+bool DownloadScheduler::takeInFlightDownload(const DownloadType::type type, const QString & guid, Download & download)
+{
+    QHash<QString,Download> & inFlightDownloads = ((type == DownloadType::Note)
+                                                   ? m_inFlightNotesByGuid
+                                                   : m_inFlightResourcesByGuid);
+
+    auto it = inFlightDownloads.find(guid);
+    if (it == inFlightDownloads.end()) {
+        QNDEBUG(QStringLiteral("The download with guid ") << guid << QStringLiteral(" is not in flight"));
+        return false;
+    }
+
+    download = it.value();
+    Q_UNUSED(inFlightDownloads.erase(it))
+    return true;
+}
+
+DownloadScheduler::QueueKey DownloadScheduler::queueKey(const Download & download, const qint64 sequenceNumber) const
+{
+    QueueKey key;
+    key.m_urgency = download.m_urgency;
+    key.m_priorityClass = download.m_priorityClass;
+    key.m_estimatedSize = download.m_estimatedSize;
+    key.m_sequenceNumber = sequenceNumber;
+
+    // The urgent downloads are ordered by recency rather than by size
+    if (download.m_urgency != Urgency::Regular) {
+        key.m_noteModificationTimestamp = download.m_noteModificationTimestamp;
+    }
+
+    return key;
+}
+
+void DownloadScheduler::updateMetrics()
+{
+    m_metrics.m_queueDepth = m_queue.size();
+    m_metrics.m_peakQueueDepth = std::max(m_metrics.m_peakQueueDepth, m_metrics.m_queueDepth);
+    m_metrics.m_numInFlight = numInFlight();
+    m_metrics.m_peakNumInFlight = std::max(m_metrics.m_peakNumInFlight, m_metrics.m_numInFlight);
+    m_metrics.m_window = window();
+}
+
+DownloadScheduler::Download::Download() :
+    m_type(DownloadType::Note),
+    m_priorityClass(PriorityClass::UserAccount),
+    m_urgency(Urgency::Regular),
+    m_estimatedSize(0),
+    m_noteModificationTimestamp(0),
+    m_note(),
+    m_resource(),
+    m_enqueueTimestamp(0)
+{}
+
+QString DownloadScheduler::Download::guid() const
+{
+    if (m_type == DownloadType::Note) {
+        return (m_note.hasGuid() ? m_note.guid() : QString());
+    }
+
+    return (m_resource.hasGuid() ? m_resource.guid() : QString());
+}
+
+DownloadScheduler::Metrics::Metrics() :
+    m_queueDepth(0),
+    m_peakQueueDepth(0),
+    m_numInFlight(0),
+    m_peakNumInFlight(0),
+    m_window(0),
+    m_numEnqueued(0),
+    m_numStarted(0),
+    m_numFinished(0),
+    m_numRateLimitHits(0),
+    m_totalBackoffMsec(0),
+    m_totalQueueWaitMsec(0),
+    m_firstStartTimestamp(0),
+    m_lastFinishTimestamp(0)
+{}
+
+double DownloadScheduler::Metrics::throughput() const
+{
+    qint64 elapsedMsec = m_lastFinishTimestamp - m_firstStartTimestamp;
+    if ((m_numFinished == 0) || (elapsedMsec <= 0)) {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_numFinished) * 1000.0 / static_cast<double>(elapsedMsec);
+}
+
+qint64 DownloadScheduler::Metrics::averageQueueWaitMsec() const
+{
+    if (m_numStarted == 0) {
+        return 0;
+    }
+
+    return m_totalQueueWaitMsec / m_numStarted;
+}
+
+QTextStream & DownloadScheduler::Metrics::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("DownloadScheduler::Metrics: queue depth = ") << m_queueDepth
+         << QStringLiteral(", peak queue depth = ") << m_peakQueueDepth
+         << QStringLiteral(", in flight = ") << m_numInFlight
+         << QStringLiteral(", peak in flight = ") << m_peakNumInFlight
+         << QStringLiteral(", window = ") << m_window
+         << QStringLiteral(", enqueued = ") << m_numEnqueued
+         << QStringLiteral(", started = ") << m_numStarted
+         << QStringLiteral(", finished = ") << m_numFinished
+         << QStringLiteral(", rate limit hits = ") << m_numRateLimitHits
+         << QStringLiteral(", total backoff = ") << m_totalBackoffMsec
+         << QStringLiteral(" msec, average queue wait = ") << averageQueueWaitMsec()
+         << QStringLiteral(" msec, throughput = ") << throughput() << QStringLiteral(" downloads/sec");
+    return strm;
+}
+
+bool DownloadScheduler::QueueKey::operator<(const QueueKey & other) const
+{
+    if (m_urgency != other.m_urgency) {
+        return (m_urgency < other.m_urgency);
+    }
+
+    if (m_priorityClass != other.m_priorityClass) {
+        return (m_priorityClass < other.m_priorityClass);
+    }
+
+    // More recently modified notes go first
+    if (m_noteModificationTimestamp != other.m_noteModificationTimestamp) {
+        return (m_noteModificationTimestamp > other.m_noteModificationTimestamp);
+    }
+
+    if (m_estimatedSize != other.m_estimatedSize) {
+        return (m_estimatedSize < other.m_estimatedSize);
+    }
+
+    return (m_sequenceNumber < other.m_sequenceNumber);
+}
+
+DownloadScheduler::QueueKey::QueueKey() :
+    m_urgency(Urgency::Regular),
+    m_priorityClass(PriorityClass::UserAccount),
+    m_noteModificationTimestamp(0),
+    m_estimatedSize(0),
+    m_sequenceNumber(0)
+{}
+
+} // namespace quentier
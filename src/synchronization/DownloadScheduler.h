@@ -0,0 +1,242 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_DOWNLOAD_SCHEDULER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_DOWNLOAD_SCHEDULER_H
+
+#include <quentier/types/Note.h>
+#include <quentier/types/Resource.h>
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+#include <QMap>
+#include <QHash>
+
+namespace quentier {
+
+/**
+ * @brief The DownloadScheduler class limits the number of full note and resource data downloads
+ * which are in flight at the same time
+ *
+ * The scheduled downloads are queued by priority: the downloads of notes the user is likely to open first go before
+ * the rest of downloads, see Urgency. Within the same urgency downloads of data from the user's own account go before
+ * the ones from linked notebooks; then the urgent downloads of more recently modified notes go first while the regular
+ * downloads of smaller notes and resources go before larger ones. The urgency of queued downloads can be changed
+ * at any time, the downloads already in flight are not interrupted. The window of downloads in flight
+ * adapts to the service's rate limits: it grows by one download per window's worth of successful downloads
+ * and is halved each time the rate limit is reached. When the rate limit is reached, no downloads are started
+ * until the rate limit expires, regardless of which note store has reported it.
+ *
+ * The scheduler doesn't start any downloads itself and doesn't measure time: the timestamps are passed in by the caller
+ */
+class Q_DECL_HIDDEN DownloadScheduler
+{
+public:
+    struct DownloadType
+    {
+        enum type
+        {
+            Note = 0,
+            Resource
+        };
+    };
+
+    struct PriorityClass
+    {
+        enum type
+        {
+            UserAccount = 0,
+            LinkedNotebook
+        };
+    };
+
+    /**
+     * The urgency of the download reflects how soon the user is likely to need the downloaded note; for resource
+     * downloads it's the urgency of the note owning the resource
+     */
+    struct Urgency
+    {
+        enum type
+        {
+            // The note explicitly requested to be downloaded as soon as possible
+            Requested = 0,
+            // The note currently shown to the user
+            Visible,
+            // The note from the last used notebook
+            LastUsedNotebook,
+            // The note modified recently
+            RecentlyModified,
+            Regular
+        };
+    };
+
+    struct Download
+    {
+        Download();
+
+        QString guid() const;
+
+        DownloadType::type      m_type;
+        PriorityClass::type     m_priorityClass;
+        Urgency::type           m_urgency;
+        qint64                  m_estimatedSize;
+
+        // The modification timestamp of the note or of the note owning the resource
+        qint64                  m_noteModificationTimestamp;
+
+        // For resource downloads m_note is the note owning the resource
+        Note                    m_note;
+        Resource                m_resource;
+
+        qint64                  m_enqueueTimestamp;
+    };
+
+    struct Metrics: public Printable
+    {
+        Metrics();
+
+        virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+        /**
+         * @return the number of downloads finished per second since the first download was started
+         */
+        double throughput() const;
+
+        /**
+         * @return the average time the downloads spent in the queue before being started, in milliseconds
+         */
+        qint64 averageQueueWaitMsec() const;
+
+        int         m_queueDepth;
+        int         m_peakQueueDepth;
+        int         m_numInFlight;
+        int         m_peakNumInFlight;
+        int         m_window;
+        qint64      m_numEnqueued;
+        qint64      m_numStarted;
+        qint64      m_numFinished;
+        qint64      m_numRateLimitHits;
+        qint64      m_totalBackoffMsec;
+        qint64      m_totalQueueWaitMsec;
+        qint64      m_firstStartTimestamp;
+        qint64      m_lastFinishTimestamp;
+    };
+
+public:
+    DownloadScheduler();
+
+    /**
+     * @brief setMaxWindow - sets the max number of downloads which can be in flight at the same time;
+     * the value less than 1 is treated as 1
+     */
+    void setMaxWindow(const int maxWindow);
+    int maxWindow() const { return m_maxWindow; }
+
+    /**
+     * @return the current number of downloads which can be in flight at the same time
+     */
+    int window() const;
+
+    int queueDepth() const { return m_queue.size(); }
+    int numInFlight() const { return m_inFlightNotesByGuid.size() + m_inFlightResourcesByGuid.size(); }
+
+    void enqueue(const Download & download, const qint64 timestamp);
+
+    /**
+     * @brief takeNext - takes the highest priority download from the queue and considers it being in flight
+     * @return false if there's nothing to download, if the window of downloads in flight is full or if the scheduler
+     * waits for the rate limit to expire; true otherwise
+     */
+    bool takeNext(Download & download, const qint64 timestamp);
+
+    /**
+     * @brief onDownloadFinished - marks the download in flight as finished, either successfully or with an error
+     * other than reaching the rate limit
+     * @param download - the finished download as it was passed to enqueue method
+     * @return true if the download with the given type and guid was in flight, false otherwise
+     */
+    bool onDownloadFinished(const DownloadType::type type, const QString & guid, const qint64 timestamp, Download & download);
+
+    /**
+     * @brief onRateLimitReached - marks the download in flight as finished due to reaching the rate limit: all downloads
+     * are held back until the rate limit expires and the window of downloads in flight gets halved
+     * @param download - the download as it was passed to enqueue method, it needs to be enqueued again
+     * @return true if the download with the given type and guid was in flight, false otherwise
+     */
+    bool onRateLimitReached(const DownloadType::type type, const QString & guid, const qint32 rateLimitSeconds,
+                            const qint64 timestamp, Download & download);
+
+    /**
+     * @return the number of milliseconds left until the rate limit expires, zero if the rate limit is not in effect
+     */
+    qint64 backoffRemainingMsec(const qint64 timestamp) const;
+
+    /**
+     * @return the downloads which are either queued or in flight
+     */
+    QList<Download> downloads() const;
+
+    /**
+     * @brief setUrgency - changes the urgency of queued downloads of the notes with the given guids and of resources
+     * owned by these notes; the downloads in flight are not affected
+     * @return the number of queued downloads which urgency has changed
+     */
+    int setUrgency(const QHash<QString,Urgency::type> & urgenciesByNoteGuid);
+
+    const Metrics & metrics() const { return m_metrics; }
+
+    /**
+     * @brief clear - drops all queued downloads and downloads in flight and resets the adaptive window and the metrics;
+     * the max window is preserved
+     */
+    void clear();
+
+private:
+    struct QueueKey
+    {
+        QueueKey();
+
+        bool operator<(const QueueKey & other) const;
+
+        Urgency::type           m_urgency;
+        PriorityClass::type     m_priorityClass;
+        qint64                  m_noteModificationTimestamp;
+        qint64                  m_estimatedSize;
+        qint64                  m_sequenceNumber;
+    };
+
+    QueueKey queueKey(const Download & download, const qint64 sequenceNumber) const;
+
+    bool takeInFlightDownload(const DownloadType::type type, const QString & guid, Download & download);
+    void updateMetrics();
+
+private:
+    int                         m_maxWindow;
+    double                      m_window;
+    qint64                      m_backoffEndTimestamp;
+    qint64                      m_nextSequenceNumber;
+
+    QMap<QueueKey,Download>     m_queue;
+    QHash<QString,Download>     m_inFlightNotesByGuid;
+    QHash<QString,Download>     m_inFlightResourcesByGuid;
+
+    Metrics                     m_metrics;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_DOWNLOAD_SCHEDULER_H
@@ -19,17 +19,12 @@
 #ifndef LIB_QUENTIER_SYNCHRONIZATION_FULL_SYNC_STALE_DATA_ITEMS_EXPUNGER_H
 #define LIB_QUENTIER_SYNCHRONIZATION_FULL_SYNC_STALE_DATA_ITEMS_EXPUNGER_H
 
-#include "NoteSyncCache.h"
-#include <QPointer>
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <QSet>
 #include <QUuid>
 
 namespace quentier {
 
-QT_FORWARD_DECLARE_CLASS(NotebookSyncCache)
-QT_FORWARD_DECLARE_CLASS(TagSyncCache)
-QT_FORWARD_DECLARE_CLASS(SavedSearchSyncCache)
-
 /**
  * @brief The FullSyncStaleDataItemsExpunger class ensures there would be no stale data items
  * left within the local storage after the full sync performed not for the first time.
@@ -49,6 +44,10 @@ QT_FORWARD_DECLARE_CLASS(SavedSearchSyncCache)
  * data, the matching data items which are marked as dirty are not expunged from the local storage: instead
  * their guid and update sequence number are wiped out so that they are presented as new data items to the service.
  * That happens during sending the local changes to Evernote service.
+ *
+ * The stale data items are found and processed by the local storage itself within a single request,
+ * see LocalStorageManager::expungeStaleDataItems; the sync caches update themselves from the result
+ * of that request so there is no need to refill them afterwards.
  */
 class Q_DECL_HIDDEN FullSyncStaleDataItemsExpunger: public QObject
 {
@@ -64,9 +63,6 @@ public:
 
 public:
     explicit FullSyncStaleDataItemsExpunger(LocalStorageManagerAsync & localStorageManagerAsync,
-                                            NotebookSyncCache & notebookSyncCache,
-                                            TagSyncCache & tagSyncCache,
-                                            SavedSearchSyncCache & savedSearchSyncCache,
                                             const SyncedGuids & syncedGuids,
                                             const QString & linkedNotebookGuid,
                                             QObject * parent = Q_NULLPTR);
@@ -78,86 +74,38 @@ Q_SIGNALS:
     void failure(ErrorString errorDescription);
 
 // private signals:
-    void expungeNotebook(Notebook notebook, QUuid requestId);
-    void expungeTag(Tag tag, QUuid requestId);
-    void expungeSavedSearch(SavedSearch search, QUuid requestId);
-    void expungeNote(Note note, QUuid requestId);
-
-    void updateNotebook(Notebook notebook, QUuid requestId);
-    void updateTag(Tag tag, QUuid requestId);
-    void updateSavedSearch(SavedSearch search, QUuid requestId);
-    void updateNote(Note note, bool updateResources, bool updateTags, QUuid requestId);
+    void expungeStaleDataItems(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                               QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                               QString linkedNotebookGuid, QUuid requestId);
 
 public Q_SLOTS:
     void start();
 
 private Q_SLOTS:
-    void onNotebookCacheFilled();
-    void onTagCacheFilled();
-    void onSavedSearchCacheFilled();
-    void onNoteCacheFilled();
-
-    void onExpungeNotebookComplete(Notebook notebook, QUuid requestId);
-    void onExpungeNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
-    void onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId);
-    void onExpungeTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
-    void onExpungeSavedSearchComplete(SavedSearch search, QUuid requestId);
-    void onExpungeSavedSearchFailed(SavedSearch search, ErrorString errorDescription, QUuid requestId);
-    void onExpungeNoteComplete(Note note, QUuid requestId);
-    void onExpungeNoteFailed(Note note, ErrorString errorDescription, QUuid requestId);
-
-    void onUpdateNotebookComplete(Notebook notebook, QUuid requestId);
-    void onUpdateNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
-    void onUpdateTagComplete(Tag tag, QUuid requestId);
-    void onUpdateTagFailed(Tag tag, ErrorString errorDescription, QUuid requestId);
-    void onUpdateSavedSearchComplete(SavedSearch search, QUuid requestId);
-    void onUpdateSavedSearchFailed(SavedSearch search, ErrorString errorDescription, QUuid requestId);
-    void onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId);
-    void onUpdateNoteFailed(Note note, bool updateResources, bool updateTags, ErrorString errorDescription, QUuid requestId);
+    void onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                         QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                         QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                         QUuid requestId);
+    void onExpungeStaleDataItemsFailed(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                       QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                       QString linkedNotebookGuid, ErrorString errorDescription,
+                                       QUuid requestId);
 
 private:
     void connectToLocalStorage();
     void disconnectFromLocalStorage();
 
-    void checkAndRequestCachesFilling();
-    bool pendingCachesFilling() const;
-
-    void analyzeDataAndSendRequestsOrResult();
-
-    void checkRequestsCompletionAndSendResult();
-    void checkTagUpdatesCompletionAndSendExpungeTagRequests();
-
 private:
     LocalStorageManagerAsync &      m_localStorageManagerAsync;
     bool                            m_connectedToLocalStorage;
 
     bool                            m_inProgress;
 
-    QPointer<NotebookSyncCache>     m_pNotebookSyncCache;
-    QPointer<TagSyncCache>          m_pTagSyncCache;
-    QPointer<SavedSearchSyncCache>  m_pSavedSearchSyncCache;
-    NoteSyncCache                   m_noteSyncCache;
-
     SyncedGuids                     m_syncedGuids;
 
     QString                         m_linkedNotebookGuid;
 
-    bool                            m_pendingNotebookSyncCache;
-    bool                            m_pendingTagSyncCache;
-    bool                            m_pendingSavedSearchSyncCache;
-    bool                            m_pendingNoteSyncCache;
-
-    QSet<QString>                   m_tagGuidsToExpunge;
-
-    QSet<QUuid>                     m_expungeNotebookRequestIds;
-    QSet<QUuid>                     m_expungeTagRequestIds;
-    QSet<QUuid>                     m_expungeNoteRequestIds;
-    QSet<QUuid>                     m_expungeSavedSearchRequestIds;
-
-    QSet<QUuid>                     m_updateNotebookRequestId;
-    QSet<QUuid>                     m_updateTagRequestIds;
-    QSet<QUuid>                     m_updateNoteRequestIds;
-    QSet<QUuid>                     m_updateSavedSearchRequestIds;
+    QUuid                           m_expungeStaleDataItemsRequestId;
 };
 
 } // namespace quentier
@@ -0,0 +1,546 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NoteImagesDownloadManager.h"
+#include "InkNoteImageDownloader.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <algorithm>
+
+#define DEFAULT_MAX_NOTE_IMAGE_DOWNLOADS_IN_FLIGHT (4)
+
+#define THUMBNAILS_CACHE_SUBFOLDER QStringLiteral("thumbnails")
+#define INK_NOTE_IMAGES_CACHE_SUBFOLDER QStringLiteral("inkNoteImages")
+
+namespace quentier {
+
+NoteImagesDownloadManager::NoteImagesDownloadManager(QObject * parent) :
+    QObject(parent),
+    m_cacheFolderPath(),
+    m_maxDownloadsInFlight(DEFAULT_MAX_NOTE_IMAGE_DOWNLOADS_IN_FLIGHT),
+    m_numDownloadsInFlight(0),
+    m_pendingProcessingScheduled(false),
+    m_nextSequenceNumber(0),
+    m_visibleNoteGuids(),
+    m_pendingDownloads(),
+    m_thumbnailsByKey(),
+    m_thumbnailDownloadsByAsyncResultPtr(),
+    m_inkNoteImageDownloadsByResourceGuid()
+{}
+
+NoteImagesDownloadManager::~NoteImagesDownloadManager()
+{}
+
+void NoteImagesDownloadManager::setCacheFolderPath(const QString & cacheFolderPath)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::setCacheFolderPath: ") << cacheFolderPath);
+    m_cacheFolderPath = cacheFolderPath;
+}
+
+void NoteImagesDownloadManager::setMaxDownloadsInFlight(const int maxDownloadsInFlight)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::setMaxDownloadsInFlight: ") << maxDownloadsInFlight);
+
+    m_maxDownloadsInFlight = std::max(maxDownloadsInFlight, 1);
+    if (!m_pendingDownloads.isEmpty()) {
+        scheduleProcessingPendingDownloads();
+    }
+}
+
+void NoteImagesDownloadManager::setVisibleNoteGuids(const QStringList & noteGuids)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::setVisibleNoteGuids: ") << noteGuids.join(QStringLiteral(", ")));
+
+    m_visibleNoteGuids.clear();
+    for(auto it = noteGuids.constBegin(), end = noteGuids.constEnd(); it != end; ++it) {
+        Q_UNUSED(m_visibleNoteGuids.insert(*it))
+    }
+
+    if (m_pendingDownloads.isEmpty()) {
+        return;
+    }
+
+    // Re-keying the pending downloads; the sequence numbers are preserved so that the downloads within the same
+    // priority class keep their order
+    QMap<QueueKey,Download> pendingDownloads;
+    for(auto it = m_pendingDownloads.constBegin(), end = m_pendingDownloads.constEnd(); it != end; ++it)
+    {
+        const Download & download = it.value();
+        int priority = (m_visibleNoteGuids.contains(download.m_noteGuid)
+                        ? static_cast<int>(PriorityClass::VisibleNote)
+                        : static_cast<int>(download.m_priorityClass));
+        pendingDownloads.insert(QueueKey(priority, it.key().second), download);
+    }
+
+    m_pendingDownloads = pendingDownloads;
+}
+
+void NoteImagesDownloadManager::downloadNoteThumbnail(const QString & host, const QString & noteGuid,
+                                                      const QByteArray & noteContentHash, const QString & authToken,
+                                                      const QString & shardId, const bool noteFromPublicLinkedNotebook,
+                                                      const PriorityClass::type priorityClass)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::downloadNoteThumbnail: host = ") << host
+            << QStringLiteral(", note guid = ") << noteGuid << QStringLiteral(", note content hash = ")
+            << noteContentHash.toHex() << QStringLiteral(", is public = ")
+            << (noteFromPublicLinkedNotebook ? QStringLiteral("true") : QStringLiteral("false")));
+
+    Download download;
+    download.m_type = DownloadType::Thumbnail;
+    download.m_priorityClass = priorityClass;
+    download.m_host = host;
+    download.m_noteGuid = noteGuid;
+    download.m_hash = noteContentHash;
+    download.m_authToken = authToken;
+    download.m_shardId = shardId;
+    download.m_noteFromPublicLinkedNotebook = noteFromPublicLinkedNotebook;
+
+    enqueue(download);
+}
+
+void NoteImagesDownloadManager::downloadInkNoteImage(const QString & host, const QString & resourceGuid,
+                                                     const QString & noteGuid, const QByteArray & resourceDataHash,
+                                                     const QString & authToken, const QString & shardId,
+                                                     const int height, const int width,
+                                                     const bool noteFromPublicLinkedNotebook,
+                                                     const QString & storageFolderPath,
+                                                     const PriorityClass::type priorityClass)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::downloadInkNoteImage: host = ") << host
+            << QStringLiteral(", resource guid = ") << resourceGuid << QStringLiteral(", note guid = ") << noteGuid
+            << QStringLiteral(", resource data hash = ") << resourceDataHash.toHex() << QStringLiteral(", height = ")
+            << height << QStringLiteral(", width = ") << width << QStringLiteral(", storage folder path = ")
+            << storageFolderPath);
+
+    Download download;
+    download.m_type = DownloadType::InkNoteImage;
+    download.m_priorityClass = priorityClass;
+    download.m_host = host;
+    download.m_noteGuid = noteGuid;
+    download.m_resourceGuid = resourceGuid;
+    download.m_hash = resourceDataHash;
+    download.m_authToken = authToken;
+    download.m_shardId = shardId;
+    download.m_height = height;
+    download.m_width = width;
+    download.m_noteFromPublicLinkedNotebook = noteFromPublicLinkedNotebook;
+    download.m_storageFolderPath = storageFolderPath;
+
+    enqueue(download);
+}
+
+void NoteImagesDownloadManager::clear()
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::clear"));
+
+    m_pendingDownloads.clear();
+
+    for(auto it = m_thumbnailDownloadsByAsyncResultPtr.constBegin(),
+        end = m_thumbnailDownloadsByAsyncResultPtr.constEnd(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteImagesDownloadManager,onThumbnailDownloadFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_thumbnailDownloadsByAsyncResultPtr.clear();
+
+    QList<InkNoteImageDownloader*> inkNoteImageDownloaders = findChildren<InkNoteImageDownloader*>();
+    for(auto it = inkNoteImageDownloaders.begin(), end = inkNoteImageDownloaders.end(); it != end; ++it)
+    {
+        InkNoteImageDownloader * pDownloader = *it;
+        if (Q_UNLIKELY(!pDownloader)) {
+            continue;
+        }
+
+        QObject::disconnect(pDownloader, QNSIGNAL(InkNoteImageDownloader,finished,bool,QString,QString,ErrorString),
+                            this, QNSLOT(NoteImagesDownloadManager,onInkNoteImageDownloadFinished,bool,QString,QString,ErrorString));
+        pDownloader->setParent(Q_NULLPTR);
+        pDownloader->deleteLater();
+    }
+
+    m_inkNoteImageDownloadsByResourceGuid.clear();
+
+    // NOTE: the authentication tokens might change before the next sync so not reusing the thumbnail objects
+    m_thumbnailsByKey.clear();
+
+    m_numDownloadsInFlight = 0;
+}
+
+void NoteImagesDownloadManager::processPendingDownloads()
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::processPendingDownloads: ") << m_pendingDownloads.size()
+            << QStringLiteral(" pending downloads, ") << m_numDownloadsInFlight << QStringLiteral(" downloads in flight"));
+
+    m_pendingProcessingScheduled = false;
+
+    while(!m_pendingDownloads.isEmpty())
+    {
+        // NOTE: the signals emitted below might lead to the modification of the queue so need to take the download
+        // out of it before doing anything else
+        auto it = m_pendingDownloads.begin();
+        QueueKey key = it.key();
+        Download download = it.value();
+        Q_UNUSED(m_pendingDownloads.erase(it))
+
+        // The images found within the cache don't occupy the slots of downloads in flight
+        if (completeFromCache(download)) {
+            continue;
+        }
+
+        if (m_numDownloadsInFlight >= m_maxDownloadsInFlight) {
+            m_pendingDownloads.insert(key, download);
+            break;
+        }
+
+        startDownload(download);
+    }
+}
+
+void NoteImagesDownloadManager::onThumbnailDownloadFinished(QVariant result,
+                                                            QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::onThumbnailDownloadFinished"));
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't find the thumbnail download "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    auto it = m_thumbnailDownloadsByAsyncResultPtr.find(pAsyncResult);
+    if (it == m_thumbnailDownloadsByAsyncResultPtr.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the thumbnail download by async result ptr"));
+        return;
+    }
+
+    Download download = it.value();
+    Q_UNUSED(m_thumbnailDownloadsByAsyncResultPtr.erase(it))
+    onDownloadFinished();
+
+    if (!exceptionData.isNull()) {
+        ErrorString errorDescription(QT_TR_NOOP("failed to download the note thumbnail"));
+        errorDescription.details() = exceptionData->errorMessage;
+        QNDEBUG(errorDescription << QStringLiteral(", note guid = ") << download.m_noteGuid);
+        Q_EMIT noteThumbnailDownloaded(false, download.m_noteGuid, QByteArray(), errorDescription);
+        return;
+    }
+
+    QByteArray thumbnailImageData = result.toByteArray();
+    if (Q_UNLIKELY(thumbnailImageData.isEmpty())) {
+        ErrorString errorDescription(QT_TR_NOOP("received empty note thumbnail data"));
+        QNDEBUG(errorDescription << QStringLiteral(", note guid = ") << download.m_noteGuid);
+        Q_EMIT noteThumbnailDownloaded(false, download.m_noteGuid, QByteArray(), errorDescription);
+        return;
+    }
+
+    if (!download.m_hash.isEmpty()) {
+        putIntoCache(thumbnailCacheFilePath(download), QStringLiteral("*.png"), thumbnailImageData);
+    }
+
+    Q_EMIT noteThumbnailDownloaded(true, download.m_noteGuid, thumbnailImageData, ErrorString());
+}
+
+void NoteImagesDownloadManager::onInkNoteImageDownloadFinished(bool status, QString resourceGuid, QString noteGuid,
+                                                               ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::onInkNoteImageDownloadFinished: status = ")
+            << (status ? QStringLiteral("true") : QStringLiteral("false")) << QStringLiteral(", resource guid = ")
+            << resourceGuid << QStringLiteral(", note guid = ") << noteGuid << QStringLiteral(", error description = ")
+            << errorDescription);
+
+    InkNoteImageDownloader * pDownloader = qobject_cast<InkNoteImageDownloader*>(sender());
+    if (pDownloader) {
+        pDownloader->setParent(Q_NULLPTR);
+        pDownloader->deleteLater();
+    }
+
+    auto it = m_inkNoteImageDownloadsByResourceGuid.find(resourceGuid);
+    if (it == m_inkNoteImageDownloadsByResourceGuid.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the ink note image download by resource guid"));
+        return;
+    }
+
+    Download download = it.value();
+    Q_UNUSED(m_inkNoteImageDownloadsByResourceGuid.erase(it))
+    onDownloadFinished();
+
+    if (status && !download.m_hash.isEmpty())
+    {
+        QFile file(download.m_storageFolderPath + QStringLiteral("/") + resourceGuid + QStringLiteral(".png"));
+        if (file.open(QIODevice::ReadOnly)) {
+            putIntoCache(inkNoteImageCacheFilePath(download), resourceGuid + QStringLiteral("_*.png"), file.readAll());
+            file.close();
+        }
+        else {
+            QNDEBUG(QStringLiteral("Can't open the downloaded ink note image file to put it into the cache: ")
+                    << file.fileName());
+        }
+    }
+
+    Q_EMIT inkNoteImageDownloaded(status, resourceGuid, noteGuid, errorDescription);
+}
+
+NoteImagesDownloadManager::Download::Download() :
+    m_type(DownloadType::Thumbnail),
+    m_priorityClass(PriorityClass::UserAccount),
+    m_host(),
+    m_noteGuid(),
+    m_resourceGuid(),
+    m_hash(),
+    m_authToken(),
+    m_shardId(),
+    m_height(0),
+    m_width(0),
+    m_noteFromPublicLinkedNotebook(false),
+    m_storageFolderPath()
+{}
+
+void NoteImagesDownloadManager::enqueue(const Download & download)
+{
+    int priority = (m_visibleNoteGuids.contains(download.m_noteGuid)
+                    ? static_cast<int>(PriorityClass::VisibleNote)
+                    : static_cast<int>(download.m_priorityClass));
+    m_pendingDownloads.insert(QueueKey(priority, m_nextSequenceNumber++), download);
+
+    scheduleProcessingPendingDownloads();
+}
+
+void NoteImagesDownloadManager::scheduleProcessingPendingDownloads()
+{
+    if (m_pendingProcessingScheduled) {
+        return;
+    }
+
+    // NOTE: processing the pending downloads asynchronously so that the results, even the cached ones,
+    // are never reported from within the call scheduling the download
+    m_pendingProcessingScheduled = true;
+    QTimer::singleShot(0, this, SLOT(processPendingDownloads()));
+}
+
+bool NoteImagesDownloadManager::completeFromCache(const Download & download)
+{
+    if (m_cacheFolderPath.isEmpty() || download.m_hash.isEmpty()) {
+        return false;
+    }
+
+    if (download.m_type == DownloadType::Thumbnail)
+    {
+        QFile file(thumbnailCacheFilePath(download));
+        if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        QByteArray thumbnailImageData = file.readAll();
+        file.close();
+
+        if (Q_UNLIKELY(thumbnailImageData.isEmpty())) {
+            return false;
+        }
+
+        QNDEBUG(QStringLiteral("Found the thumbnail within the cache, note guid = ") << download.m_noteGuid);
+        Q_EMIT noteThumbnailDownloaded(true, download.m_noteGuid, thumbnailImageData, ErrorString());
+        return true;
+    }
+
+    QFileInfo cacheFileInfo(inkNoteImageCacheFilePath(download));
+    if (!cacheFileInfo.exists()) {
+        return false;
+    }
+
+    QString filePath = download.m_storageFolderPath + QStringLiteral("/") + download.m_resourceGuid + QStringLiteral(".png");
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || (fileInfo.size() != cacheFileInfo.size()))
+    {
+        QDir dir(download.m_storageFolderPath);
+        if (Q_UNLIKELY(!dir.exists() && !dir.mkpath(download.m_storageFolderPath))) {
+            return false;
+        }
+
+        if (fileInfo.exists() && !QFile::remove(filePath)) {
+            return false;
+        }
+
+        if (Q_UNLIKELY(!QFile::copy(cacheFileInfo.absoluteFilePath(), filePath))) {
+            QNDEBUG(QStringLiteral("Failed to copy the cached ink note image to ") << filePath);
+            return false;
+        }
+    }
+
+    QNDEBUG(QStringLiteral("Found the ink note image within the cache, resource guid = ") << download.m_resourceGuid);
+    Q_EMIT inkNoteImageDownloaded(true, download.m_resourceGuid, download.m_noteGuid, ErrorString());
+    return true;
+}
+
+void NoteImagesDownloadManager::startDownload(const Download & download)
+{
+    if (download.m_type == DownloadType::Thumbnail) {
+        startThumbnailDownload(download);
+    }
+    else {
+        startInkNoteImageDownload(download);
+    }
+}
+
+void NoteImagesDownloadManager::startThumbnailDownload(const Download & download)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::startThumbnailDownload: note guid = ") << download.m_noteGuid);
+
+#define SET_ERROR(error) \
+    ErrorString errorDescription(error); \
+    QNDEBUG(errorDescription); \
+    Q_EMIT noteThumbnailDownloaded(false, download.m_noteGuid, QByteArray(), errorDescription); \
+    return
+
+    if (Q_UNLIKELY(download.m_host.isEmpty())) {
+        SET_ERROR(QT_TR_NOOP("host is empty"));
+    }
+
+    if (Q_UNLIKELY(download.m_noteGuid.isEmpty())) {
+        SET_ERROR(QT_TR_NOOP("note guid is empty"));
+    }
+
+    if (Q_UNLIKELY(download.m_shardId.isEmpty())) {
+        SET_ERROR(QT_TR_NOOP("shard id is empty"));
+    }
+
+    if (Q_UNLIKELY(!download.m_noteFromPublicLinkedNotebook && download.m_authToken.isEmpty())) {
+        SET_ERROR(QT_TR_NOOP("authentication data is incomplete"));
+    }
+
+    QString key = download.m_host + QStringLiteral("|") + download.m_shardId + QStringLiteral("|") + download.m_authToken;
+    auto thumbnailIt = m_thumbnailsByKey.find(key);
+    if (thumbnailIt == m_thumbnailsByKey.end()) {
+        thumbnailIt = m_thumbnailsByKey.insert(key, QSharedPointer<qevercloud::Thumbnail>(
+                                                        new qevercloud::Thumbnail(download.m_host, download.m_shardId,
+                                                                                  download.m_authToken)));
+    }
+
+    qevercloud::AsyncResult * pAsyncResult = thumbnailIt.value()->downloadAsync(download.m_noteGuid,
+                                                                                download.m_noteFromPublicLinkedNotebook,
+                                                                                /* is resource guid = */ false);
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        SET_ERROR(QT_TR_NOOP("failed to download the note thumbnail, QEverCloud returned null pointer to AsyncResult"));
+    }
+
+#undef SET_ERROR
+
+    m_thumbnailDownloadsByAsyncResultPtr[pAsyncResult] = download;
+    ++m_numDownloadsInFlight;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteImagesDownloadManager,onThumbnailDownloadFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+}
+
+void NoteImagesDownloadManager::startInkNoteImageDownload(const Download & download)
+{
+    QNDEBUG(QStringLiteral("NoteImagesDownloadManager::startInkNoteImageDownload: resource guid = ")
+            << download.m_resourceGuid << QStringLiteral(", note guid = ") << download.m_noteGuid);
+
+    m_inkNoteImageDownloadsByResourceGuid[download.m_resourceGuid] = download;
+    ++m_numDownloadsInFlight;
+
+    InkNoteImageDownloader * pDownloader = new InkNoteImageDownloader(download.m_host, download.m_resourceGuid,
+                                                                      download.m_noteGuid, download.m_authToken,
+                                                                      download.m_shardId, download.m_height,
+                                                                      download.m_width,
+                                                                      download.m_noteFromPublicLinkedNotebook,
+                                                                      download.m_storageFolderPath, this);
+    QObject::connect(pDownloader, QNSIGNAL(InkNoteImageDownloader,finished,bool,QString,QString,ErrorString),
+                     this, QNSLOT(NoteImagesDownloadManager,onInkNoteImageDownloadFinished,bool,QString,QString,ErrorString));
+
+    // WARNING: it seems it's not possible to run ink note image downloading
+    // in a different thread, the error like this might appear: QObject: Cannot
+    // create children for a parent that is in a different thread.
+    // (Parent is QNetworkAccessManager(0x499b900), parent's thread is QThread(0x1b535b0), current thread is QThread(0x42ed270)
+
+    // QThreadPool::globalInstance()->start(pDownloader);
+
+    pDownloader->run();
+}
+
+void NoteImagesDownloadManager::onDownloadFinished()
+{
+    if (m_numDownloadsInFlight > 0) {
+        --m_numDownloadsInFlight;
+    }
+
+    if (!m_pendingDownloads.isEmpty()) {
+        scheduleProcessingPendingDownloads();
+    }
+}
+
+QString NoteImagesDownloadManager::thumbnailCacheFilePath(const Download & download) const
+{
+    return m_cacheFolderPath + QStringLiteral("/") + THUMBNAILS_CACHE_SUBFOLDER + QStringLiteral("/") +
+           download.m_noteGuid + QStringLiteral("/") + QString::fromUtf8(download.m_hash.toHex()) + QStringLiteral(".png");
+}
+
+QString NoteImagesDownloadManager::inkNoteImageCacheFilePath(const Download & download) const
+{
+    return m_cacheFolderPath + QStringLiteral("/") + INK_NOTE_IMAGES_CACHE_SUBFOLDER + QStringLiteral("/") +
+           download.m_noteGuid + QStringLiteral("/") + download.m_resourceGuid + QStringLiteral("_") +
+           QString::fromUtf8(download.m_hash.toHex()) + QStringLiteral(".png");
+}
+
+void NoteImagesDownloadManager::putIntoCache(const QString & cacheFilePath, const QString & staleFilesNameFilter,
+                                             const QByteArray & data)
+{
+    if (m_cacheFolderPath.isEmpty()) {
+        return;
+    }
+
+    QFileInfo cacheFileInfo(cacheFilePath);
+    QString folderPath = cacheFileInfo.absolutePath();
+
+    QDir dir(folderPath);
+    if (!dir.exists())
+    {
+        if (Q_UNLIKELY(!dir.mkpath(folderPath))) {
+            QNWARNING(QStringLiteral("Can't create the folder for the cached note image: ") << folderPath);
+            return;
+        }
+    }
+    else
+    {
+        // The images made from the previous versions of the same data are no longer needed
+        QStringList staleFileNames = dir.entryList(QStringList(staleFilesNameFilter), QDir::Files);
+        for(auto it = staleFileNames.constBegin(), end = staleFileNames.constEnd(); it != end; ++it) {
+            Q_UNUSED(dir.remove(*it))
+        }
+    }
+
+    QFile file(cacheFilePath);
+    if (Q_UNLIKELY(!file.open(QIODevice::WriteOnly))) {
+        QNWARNING(QStringLiteral("Can't open the cached note image file for writing: ") << cacheFilePath);
+        return;
+    }
+
+    file.write(data);
+    file.close();
+}
+
+} // namespace quentier
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_NOTE_IMAGES_DOWNLOAD_MANAGER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_NOTE_IMAGES_DOWNLOAD_MANAGER_H
+
+#include <quentier/types/ErrorString.h>
+#include <quentier/utility/Macros.h>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QSharedPointer>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#include <qt5qevercloud/thumbnail.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#include <qt4qevercloud/thumbnail.h>
+#endif
+
+namespace quentier {
+
+/**
+ * @brief The NoteImagesDownloadManager class downloads note thumbnails and ink note images during the synchronization
+ *
+ * All the downloads share a single queue with the bounded number of downloads in flight. The downloads for notes
+ * which are currently visible to the user go first, then the ones for notes from the user's own account
+ * and then the ones for notes from linked notebooks. The thumbnail downloads with the same host, shard id
+ * and authentication token share the same qevercloud::Thumbnail object.
+ *
+ * The downloaded images are also put into the on-disk cache keyed by note guid and by the hash of the data
+ * the image was made from: the note's content hash for thumbnails and the resource's data hash for ink note images.
+ * If the cache already has the image for the same hash, the image is taken from the cache instead of being downloaded.
+ */
+class Q_DECL_HIDDEN NoteImagesDownloadManager: public QObject
+{
+    Q_OBJECT
+public:
+    struct PriorityClass
+    {
+        enum type
+        {
+            VisibleNote = 0,
+            UserAccount,
+            LinkedNotebook
+        };
+    };
+
+public:
+    explicit NoteImagesDownloadManager(QObject * parent = Q_NULLPTR);
+    virtual ~NoteImagesDownloadManager();
+
+    /**
+     * @brief setCacheFolderPath - sets the path to the folder with the cached images; the empty path disables the cache
+     */
+    void setCacheFolderPath(const QString & cacheFolderPath);
+    const QString & cacheFolderPath() const { return m_cacheFolderPath; }
+
+    /**
+     * @brief setMaxDownloadsInFlight - sets the max number of downloads which can be in flight at the same time;
+     * the value less than 1 is treated as 1
+     */
+    void setMaxDownloadsInFlight(const int maxDownloadsInFlight);
+    int maxDownloadsInFlight() const { return m_maxDownloadsInFlight; }
+
+    /**
+     * @brief setVisibleNoteGuids - sets the guids of notes which are visible to the user; the pending downloads
+     * for these notes are moved to the front of the queue
+     */
+    void setVisibleNoteGuids(const QStringList & noteGuids);
+
+    /**
+     * @brief downloadNoteThumbnail - schedules the download of the note thumbnail; when done, noteThumbnailDownloaded
+     * signal is emitted
+     * @param noteContentHash - the content hash of the note, used as the cache key; if empty, the thumbnail is always
+     * downloaded and is not cached
+     */
+    void downloadNoteThumbnail(const QString & host, const QString & noteGuid, const QByteArray & noteContentHash,
+                               const QString & authToken, const QString & shardId,
+                               const bool noteFromPublicLinkedNotebook, const PriorityClass::type priorityClass);
+
+    /**
+     * @brief downloadInkNoteImage - schedules the download of the ink note image into the file named after the resource guid
+     * within the storage folder; when done, inkNoteImageDownloaded signal is emitted
+     * @param resourceDataHash - the data hash of the ink note resource, used as the cache key; if empty, the image
+     * is always downloaded and is not cached
+     */
+    void downloadInkNoteImage(const QString & host, const QString & resourceGuid, const QString & noteGuid,
+                              const QByteArray & resourceDataHash, const QString & authToken, const QString & shardId,
+                              const int height, const int width, const bool noteFromPublicLinkedNotebook,
+                              const QString & storageFolderPath, const PriorityClass::type priorityClass);
+
+    int numPendingDownloads() const { return m_pendingDownloads.size(); }
+    int numDownloadsInFlight() const { return m_numDownloadsInFlight; }
+
+    /**
+     * @brief clear - drops the pending downloads and abandons the downloads in flight: no signals are emitted for them;
+     * the visible note guids, the cache folder path and the max number of downloads in flight are preserved
+     */
+    void clear();
+
+Q_SIGNALS:
+    void noteThumbnailDownloaded(bool success, QString noteGuid, QByteArray downloadedThumbnailData,
+                                 ErrorString errorDescription);
+    void inkNoteImageDownloaded(bool success, QString resourceGuid, QString noteGuid, ErrorString errorDescription);
+
+private:
+    typedef qevercloud::EverCloudExceptionData EverCloudExceptionData;
+
+private Q_SLOTS:
+    void processPendingDownloads();
+
+    void onThumbnailDownloadFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onInkNoteImageDownloadFinished(bool status, QString resourceGuid, QString noteGuid, ErrorString errorDescription);
+
+private:
+    struct DownloadType
+    {
+        enum type
+        {
+            Thumbnail = 0,
+            InkNoteImage
+        };
+    };
+
+    struct Download
+    {
+        Download();
+
+        DownloadType::type      m_type;
+        PriorityClass::type     m_priorityClass;
+        QString                 m_host;
+        QString                 m_noteGuid;
+        QString                 m_resourceGuid;
+        QByteArray              m_hash;
+        QString                 m_authToken;
+        QString                 m_shardId;
+        int                     m_height;
+        int                     m_width;
+        bool                    m_noteFromPublicLinkedNotebook;
+        QString                 m_storageFolderPath;
+    };
+
+    typedef QPair<int,qint64> QueueKey;
+
+    void enqueue(const Download & download);
+    void scheduleProcessingPendingDownloads();
+
+    bool completeFromCache(const Download & download);
+    void startDownload(const Download & download);
+    void startThumbnailDownload(const Download & download);
+    void startInkNoteImageDownload(const Download & download);
+    void onDownloadFinished();
+
+    QString thumbnailCacheFilePath(const Download & download) const;
+    QString inkNoteImageCacheFilePath(const Download & download) const;
+    void putIntoCache(const QString & cacheFilePath, const QString & staleFilesNameFilter, const QByteArray & data);
+
+private:
+    Q_DISABLE_COPY(NoteImagesDownloadManager)
+
+private:
+    QString                                     m_cacheFolderPath;
+    int                                         m_maxDownloadsInFlight;
+    int                                         m_numDownloadsInFlight;
+    bool                                        m_pendingProcessingScheduled;
+    qint64                                      m_nextSequenceNumber;
+
+    QSet<QString>                               m_visibleNoteGuids;
+    QMap<QueueKey,Download>                     m_pendingDownloads;
+
+    // Thumbnail downloads with the same host, shard id and auth token reuse the same qevercloud::Thumbnail object
+    QHash<QString,QSharedPointer<qevercloud::Thumbnail> >   m_thumbnailsByKey;
+    QHash<qevercloud::AsyncResult*,Download>                m_thumbnailDownloadsByAsyncResultPtr;
+    QHash<QString,Download>                                 m_inkNoteImageDownloadsByResourceGuid;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_NOTE_IMAGES_DOWNLOAD_MANAGER_H
@@ -38,9 +38,17 @@ namespace quentier {
     }
 
 NoteStore::NoteStore(QSharedPointer<qevercloud::NoteStore> pQecNoteStore, QObject * parent) :
-    QObject(parent),
+    INoteStore(parent),
     m_pQecNoteStore(pQecNoteStore),
-    m_noteGuidByAsyncResultPtr()
+    m_noteGuidByAsyncResultPtr(),
+    m_resourceGuidByAsyncResultPtr(),
+    m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr(),
+    m_sendNoteAsyncDataByAsyncResultPtr(),
+    m_sendNotebookAsyncDataByAsyncResultPtr(),
+    m_sendTagAsyncDataByAsyncResultPtr(),
+    m_sendSavedSearchAsyncDataByAsyncResultPtr(),
+    m_linkedNotebookGuidBySyncStateAsyncResultPtr(),
+    m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr()
 {
     QUENTIER_CHECK_PTR(m_pQecNoteStore)
 }
@@ -66,6 +74,109 @@ void NoteStore::stop()
     }
 
     m_noteGuidByAsyncResultPtr.clear();
+
+    for(auto it = m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.begin(),
+        end = m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onGetSyncChunkAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.clear();
+
+    for(auto it = m_sendNoteAsyncDataByAsyncResultPtr.begin(),
+        end = m_sendNoteAsyncDataByAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onSendNoteAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_sendNoteAsyncDataByAsyncResultPtr.clear();
+
+    for(auto it = m_sendNotebookAsyncDataByAsyncResultPtr.begin(),
+        end = m_sendNotebookAsyncDataByAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onSendNotebookAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_sendNotebookAsyncDataByAsyncResultPtr.clear();
+
+    for(auto it = m_sendTagAsyncDataByAsyncResultPtr.begin(),
+        end = m_sendTagAsyncDataByAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onSendTagAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_sendTagAsyncDataByAsyncResultPtr.clear();
+
+    for(auto it = m_sendSavedSearchAsyncDataByAsyncResultPtr.begin(),
+        end = m_sendSavedSearchAsyncDataByAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onSendSavedSearchAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_sendSavedSearchAsyncDataByAsyncResultPtr.clear();
+
+    for(auto it = m_linkedNotebookGuidBySyncStateAsyncResultPtr.begin(),
+        end = m_linkedNotebookGuidBySyncStateAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onGetLinkedNotebookSyncStateAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_linkedNotebookGuidBySyncStateAsyncResultPtr.clear();
+
+    for(auto it = m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.begin(),
+        end = m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.end(); it != end; ++it)
+    {
+        qevercloud::AsyncResult * pAsyncResult = it.key();
+        if (Q_UNLIKELY(!pAsyncResult)) {
+            continue;
+        }
+
+        QObject::disconnect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                            this, QNSLOT(NoteStore,onGetLinkedNotebookSyncChunkAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    }
+
+    m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.clear();
+}
+
+INoteStore * NoteStore::create() const
+{
+    return new NoteStore(QSharedPointer<qevercloud::NoteStore>(new qevercloud::NoteStore));
 }
 
 QSharedPointer<qevercloud::NoteStore> NoteStore::getQecNoteStore()
@@ -146,6 +257,20 @@ qint32 NoteStore::updateNotebook(Notebook & notebook, ErrorString & errorDescrip
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::createNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                    const QUuid & requestId, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::createNotebookAsync: request id = ") << requestId);
+    return sendNotebookAsync(notebook, UserExceptionSource::Creation, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
+bool NoteStore::updateNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                    const QUuid & requestId, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::updateNotebookAsync: request id = ") << requestId);
+    return sendNotebookAsync(notebook, UserExceptionSource::Update, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
 qint32 NoteStore::createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken)
 {
     try
@@ -214,6 +339,20 @@ qint32 NoteStore::updateNote(Note & note, ErrorString & errorDescription, qint32
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::createNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::createNoteAsync: request id = ") << requestId);
+    return sendNoteAsync(note, UserExceptionSource::Creation, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
+bool NoteStore::updateNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::updateNoteAsync: request id = ") << requestId);
+    return sendNoteAsync(note, UserExceptionSource::Update, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
 qint32 NoteStore::createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken)
 {
     try
@@ -265,6 +404,20 @@ qint32 NoteStore::updateTag(Tag & tag, ErrorString & errorDescription, qint32 &
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::createTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                               ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::createTagAsync: request id = ") << requestId);
+    return sendTagAsync(tag, UserExceptionSource::Creation, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
+bool NoteStore::updateTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                               ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::updateTagAsync: request id = ") << requestId);
+    return sendTagAsync(tag, UserExceptionSource::Update, linkedNotebookAuthToken, requestId, errorDescription);
+}
+
 qint32 NoteStore::createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds)
 {
     try
@@ -316,6 +469,20 @@ qint32 NoteStore::updateSavedSearch(SavedSearch & savedSearch, ErrorString & err
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::createSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                       ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::createSavedSearchAsync: request id = ") << requestId);
+    return sendSavedSearchAsync(savedSearch, UserExceptionSource::Creation, requestId, errorDescription);
+}
+
+bool NoteStore::updateSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                       ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::updateSavedSearchAsync: request id = ") << requestId);
+    return sendSavedSearchAsync(savedSearch, UserExceptionSource::Update, requestId, errorDescription);
+}
+
 qint32 NoteStore::getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription,
                                qint32 & rateLimitSeconds)
 {
@@ -367,6 +534,29 @@ qint32 NoteStore::getSyncChunk(const qint32 afterUSN, const qint32 maxEntries,
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::getSyncChunkAsync(const qint32 afterUSN, const qint32 maxEntries,
+                                  const qevercloud::SyncChunkFilter & filter,
+                                  ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::getSyncChunkAsync: after USN = ") << afterUSN
+            << QStringLiteral(", max entries = ") << maxEntries
+            << QStringLiteral(", sync chunk filter = ") << filter);
+
+    qevercloud::AsyncResult * pAsyncResult = m_pQecNoteStore->getFilteredSyncChunkAsync(afterUSN, maxEntries, filter);
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't download the sync chunk: "
+                                            "internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr[pAsyncResult] = QPair<qint32,qint32>(afterUSN, maxEntries);
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onGetSyncChunkAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
 qint32 NoteStore::getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
                                              const QString & authToken, qevercloud::SyncState & syncState,
                                              ErrorString & errorDescription, qint32 & rateLimitSeconds)
@@ -424,29 +614,7 @@ qint32 NoteStore::getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook &
     }
     catch(const qevercloud::EDAMNotFoundException & notFoundException)
     {
-        errorDescription.setBase(QT_TR_NOOP("caught EDAM not found exception while attempting to "
-                                            "download the sync chunk for linked notebook"));
-        if (!notFoundException.exceptionData().isNull())
-        {
-            const QString & errorMessage = notFoundException.exceptionData()->errorMessage;
-            if (errorMessage == QStringLiteral("LinkedNotebook")) {
-                errorDescription.appendBase(QT_TR_NOOP("the provided information "
-                                                       "doesn't match any valid notebook"));
-            }
-            else if (errorMessage == QStringLiteral("LinkedNotebook.uri")) {
-                errorDescription.appendBase(QT_TR_NOOP("the provided public URI doesn't "
-                                                       "match any valid notebook"));
-            }
-            else if (errorMessage == QStringLiteral("SharedNotebook.id")) {
-                errorDescription.appendBase(QT_TR_NOOP("the provided information indicates "
-                                                       "the shared notebook no longer exists"));
-            }
-            else {
-                errorDescription.appendBase(QT_TR_NOOP("unknown error"));
-                errorDescription.details() = errorMessage;
-            }
-        }
-
+        processEdamNotFoundExceptionForGetLinkedNotebookSyncChunk(notFoundException, errorDescription);
         return qevercloud::EDAMErrorCode::UNKNOWN;
     }
     catch(const qevercloud::EDAMSystemException & systemException)
@@ -458,6 +626,66 @@ qint32 NoteStore::getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook &
     return qevercloud::EDAMErrorCode::UNKNOWN;
 }
 
+bool NoteStore::getLinkedNotebookSyncStateAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                const QString & authToken, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::getLinkedNotebookSyncStateAsync: linked notebook: ") << linkedNotebook);
+
+    if (Q_UNLIKELY(!linkedNotebook.guid.isSet())) {
+        errorDescription.setBase(QT_TR_NOOP("can't get the linked notebook sync state: linked notebook has no guid"));
+        return false;
+    }
+
+    qevercloud::AsyncResult * pAsyncResult = m_pQecNoteStore->getLinkedNotebookSyncStateAsync(linkedNotebook, authToken);
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't get the linked notebook sync state: "
+                                            "internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    m_linkedNotebookGuidBySyncStateAsyncResultPtr[pAsyncResult] = linkedNotebook.guid.ref();
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onGetLinkedNotebookSyncStateAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+bool NoteStore::getLinkedNotebookSyncChunkAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                                const qint32 afterUSN, const qint32 maxEntries,
+                                                const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                                ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::getLinkedNotebookSyncChunkAsync: linked notebook: ") << linkedNotebook
+            << QStringLiteral("\nAfter USN = ") << afterUSN << QStringLiteral(", max entries = ") << maxEntries
+            << QStringLiteral(", full sync only = ") << (fullSyncOnly ? QStringLiteral("true") : QStringLiteral("false")));
+
+    if (Q_UNLIKELY(!linkedNotebook.guid.isSet())) {
+        errorDescription.setBase(QT_TR_NOOP("can't download the linked notebook sync chunk: linked notebook has no guid"));
+        return false;
+    }
+
+    qevercloud::AsyncResult * pAsyncResult = m_pQecNoteStore->getLinkedNotebookSyncChunkAsync(linkedNotebook, afterUSN,
+                                                                                              maxEntries, fullSyncOnly,
+                                                                                              linkedNotebookAuthToken);
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't download the linked notebook sync chunk: "
+                                            "internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    LinkedNotebookSyncChunkAsyncData data;
+    data.m_linkedNotebookGuid = linkedNotebook.guid.ref();
+    data.m_afterUsn = afterUSN;
+    data.m_maxEntries = maxEntries;
+    m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr[pAsyncResult] = data;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onGetLinkedNotebookSyncChunkAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
 qint32 NoteStore::getNote(const bool withContent, const bool withResourcesData,
                           const bool withResourcesRecognition, const bool withResourceAlternateData,
                           Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds)
@@ -537,180 +765,636 @@ bool NoteStore::getNoteAsync(const bool withContent, const bool withResourceData
         return false;
     }
 
-    m_noteGuidByAsyncResultPtr[pAsyncResult] = noteGuid;
-
-    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
-                     this, QNSLOT(NoteStore,onGetNoteAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
-    return true;
+    m_noteGuidByAsyncResultPtr[pAsyncResult] = noteGuid;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onGetNoteAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+qint32 NoteStore::getResource(const bool withDataBody, const bool withRecognitionDataBody,
+                              const bool withAlternateDataBody, const bool withAttributes,
+                              const QString & authToken, Resource & resource, ErrorString & errorDescription,
+                              qint32 & rateLimitSeconds)
+{
+    QNDEBUG(QStringLiteral("NoteStore::getResource: with data body = ") << (withDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with recognition data body = ") << (withRecognitionDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with alternate data body = ") << (withAlternateDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with attributes = ") << (withAttributes ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", resource guid = ") << (resource.hasGuid() ? resource.guid() : QStringLiteral("<not set>")));
+
+    if (!resource.hasGuid()) {
+        errorDescription.setBase(QT_TR_NOOP("can't get resource: resource's guid is empty"));
+        return qevercloud::EDAMErrorCode::UNKNOWN;
+    }
+
+    try
+    {
+        resource.qevercloudResource() = m_pQecNoteStore->getResource(resource.guid(), withDataBody, withRecognitionDataBody,
+                                                                     withAttributes, withAlternateDataBody, authToken);
+        resource.setLocal(false);
+        resource.setDirty(false);
+        return 0;
+    }
+    catch(const qevercloud::EDAMUserException & userException)
+    {
+        return processEdamUserExceptionForGetResource(resource.qevercloudResource(), userException, errorDescription);
+    }
+    catch(const qevercloud::EDAMNotFoundException & notFoundException)
+    {
+        processEdamNotFoundException(notFoundException, errorDescription);
+    }
+    catch(const qevercloud::EDAMSystemException & systemException)
+    {
+        return processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+    }
+    CATCH_GENERIC_EXCEPTIONS_NO_RET()
+
+    return qevercloud::EDAMErrorCode::UNKNOWN;
+}
+
+bool NoteStore::getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
+                                 const bool withAlternateDataBody, const bool withAttributes,
+                                 const QString & resourceGuid, const QString & authToken, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("NoteStore::getResourceAsync: with data body = ") << (withDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with recognition data body = ") << (withRecognitionDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with alternate data body = ") << (withAlternateDataBody ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", with attributes = ") << (withAttributes ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", resource guid = ") << resourceGuid);
+
+    if (Q_UNLIKELY(resourceGuid.isEmpty())) {
+        errorDescription.setBase(QT_TR_NOOP("Detected the attempt to get full resource's data for empty resource guid"));
+        return false;
+    }
+
+    qevercloud::AsyncResult * pAsyncResult = m_pQecNoteStore->getResourceAsync(resourceGuid, withDataBody, withRecognitionDataBody,
+                                                                               withAttributes, withAlternateDataBody, authToken);
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't get full resource data: internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    m_resourceGuidByAsyncResultPtr[pAsyncResult] = resourceGuid;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onGetResourceAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+qint32 NoteStore::authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
+                                               ErrorString & errorDescription, qint32 & rateLimitSeconds)
+{
+    try
+    {
+        authResult = m_pQecNoteStore->authenticateToSharedNotebook(shareKey);
+        return 0;
+    }
+    catch(const qevercloud::EDAMUserException & userException)
+    {
+        if (userException.errorCode == qevercloud::EDAMErrorCode::DATA_REQUIRED) {
+            errorDescription.setBase(QT_TR_NOOP("no valid authentication token for current user"));
+        }
+        else if (userException.errorCode == qevercloud::EDAMErrorCode::PERMISSION_DENIED) {
+            errorDescription.setBase(QT_TR_NOOP("share requires login, and another username has already been bound to this notebook"));
+        }
+        else {
+            errorDescription.setBase(QT_TR_NOOP("unexpected EDAM user exception"));
+            errorDescription.details() = QStringLiteral("error code = ");
+            errorDescription.details() += ToString(userException.errorCode);
+        }
+
+        return userException.errorCode;
+    }
+    catch(const qevercloud::EDAMNotFoundException & notFoundException)
+    {
+        // NOTE: this means that shared notebook no longer exists. It can happen with
+        // shared/linked notebooks from time to time so it shouldn't be really considered
+        // an error. Instead, the method would return empty auth result which should indicate
+        // the fact of missing shared notebook to the caller
+        Q_UNUSED(notFoundException)
+        authResult = qevercloud::AuthenticationResult();
+        return 0;
+    }
+    catch(const qevercloud::EDAMSystemException & systemException)
+    {
+        if (systemException.errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+        {
+            if (!systemException.rateLimitDuration.isSet()) {
+                errorDescription.setBase(QT_TR_NOOP("QEverCloud error: RATE_LIMIT_REACHED exception "
+                                                    "was caught but rateLimitDuration is not set"));
+                return qevercloud::EDAMErrorCode::UNKNOWN;
+            }
+
+            rateLimitSeconds = systemException.rateLimitDuration;
+        }
+        else if (systemException.errorCode == qevercloud::EDAMErrorCode::BAD_DATA_FORMAT)
+        {
+            errorDescription.setBase(QT_TR_NOOP("invalid share key"));
+        }
+        else if (systemException.errorCode == qevercloud::EDAMErrorCode::INVALID_AUTH)
+        {
+            errorDescription.setBase(QT_TR_NOOP("bad signature of share key"));
+        }
+        else
+        {
+            errorDescription.setBase(QT_TR_NOOP("unexpected EDAM system exception"));
+            errorDescription.details() = QStringLiteral("error code = ");
+            errorDescription.details() += ToString(systemException.errorCode);
+        }
+
+        return systemException.errorCode;
+    }
+    CATCH_GENERIC_EXCEPTIONS_NO_RET()
+
+    return qevercloud::EDAMErrorCode::UNKNOWN;
+}
+
+void NoteStore::onGetNoteAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteStore::onGetNoteAsyncFinished"));
+
+    QString noteGuid;
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (pAsyncResult)
+    {
+        auto it = m_noteGuidByAsyncResultPtr.find(pAsyncResult);
+        if (it != m_noteGuidByAsyncResultPtr.end()) {
+            noteGuid = it.value();
+            Q_UNUSED(m_noteGuidByAsyncResultPtr.erase(it))
+        }
+        else {
+            QNDEBUG(QStringLiteral("Couldn't find the note guid by async result ptr"));
+            return;
+        }
+    }
+    else
+    {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the note guid "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    qevercloud::Note note;
+    note.guid = noteGuid;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
+    {
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForGetNote(note, userException, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
+
+        Q_EMIT getNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription);
+        return;
+    }
+
+    note = result.value<qevercloud::Note>();
+    Q_EMIT getNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription);
+}
+
+void NoteStore::onGetResourceAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteStore::onGetResourceAsyncFinished"));
+
+    QString resourceGuid;
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (pAsyncResult)
+    {
+        auto it = m_resourceGuidByAsyncResultPtr.find(pAsyncResult);
+        if (it != m_resourceGuidByAsyncResultPtr.end()) {
+            resourceGuid = it.value();
+            Q_UNUSED(m_resourceGuidByAsyncResultPtr.erase(it))
+        }
+        else {
+            QNDEBUG(QStringLiteral("Couldn't find the resource guid by async result ptr"));
+            return;
+        }
+    }
+    else
+    {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the resource guid "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    qevercloud::Resource resource;
+    resource.guid = resourceGuid;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
+    {
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForGetResource(resource, userException, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
+
+        Q_EMIT getResourceAsyncFinished(errorCode, resource, rateLimitSeconds, errorDescription);
+        return;
+    }
+
+    resource = result.value<qevercloud::Resource>();
+    Q_EMIT getResourceAsyncFinished(errorCode, resource, rateLimitSeconds, errorDescription);
+}
+
+void NoteStore::onSendNoteAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteStore::onSendNoteAsyncFinished"));
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the note "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    auto it = m_sendNoteAsyncDataByAsyncResultPtr.find(pAsyncResult);
+    if (it == m_sendNoteAsyncDataByAsyncResultPtr.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the sent note by async result ptr"));
+        return;
+    }
+
+    SendNoteAsyncData data = it.value();
+    Q_UNUSED(m_sendNoteAsyncDataByAsyncResultPtr.erase(it))
+
+    Note & note = data.m_note;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
+    {
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForNote(note, userException, data.m_source, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
+    }
+    else
+    {
+        qevercloud::Note noteMetadata = result.value<qevercloud::Note>();
+        QNDEBUG(QStringLiteral("Note metadata returned from the asynchronous note sending: ") << noteMetadata);
+
+        if (noteMetadata.guid.isSet()) {
+            note.setGuid(noteMetadata.guid.ref());
+        }
+
+        if (noteMetadata.updateSequenceNum.isSet()) {
+            note.setUpdateSequenceNumber(noteMetadata.updateSequenceNum);
+        }
+    }
+
+    if (data.m_source == UserExceptionSource::Creation) {
+        Q_EMIT createNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
+    else {
+        Q_EMIT updateNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
+}
+
+void NoteStore::onSendNotebookAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteStore::onSendNotebookAsyncFinished"));
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the notebook "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    auto it = m_sendNotebookAsyncDataByAsyncResultPtr.find(pAsyncResult);
+    if (it == m_sendNotebookAsyncDataByAsyncResultPtr.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the sent notebook by async result ptr"));
+        return;
+    }
+
+    SendNotebookAsyncData data = it.value();
+    Q_UNUSED(m_sendNotebookAsyncDataByAsyncResultPtr.erase(it))
+
+    Notebook & notebook = data.m_notebook;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
+    {
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForNotebook(notebook, userException, data.m_source, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
+    }
+    else if (data.m_source == UserExceptionSource::Creation)
+    {
+        notebook.qevercloudNotebook() = result.value<qevercloud::Notebook>();
+    }
+    else
+    {
+        notebook.setUpdateSequenceNumber(result.value<qint32>());
+    }
+
+    if (data.m_source == UserExceptionSource::Creation) {
+        Q_EMIT createNotebookAsyncFinished(errorCode, notebook, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
+    else {
+        Q_EMIT updateNotebookAsyncFinished(errorCode, notebook, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
+}
+
+void NoteStore::onSendTagAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+{
+    QNDEBUG(QStringLiteral("NoteStore::onSendTagAsyncFinished"));
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the tag "
+                               "to which the result corresponds"));
+        return;
+    }
+
+    auto it = m_sendTagAsyncDataByAsyncResultPtr.find(pAsyncResult);
+    if (it == m_sendTagAsyncDataByAsyncResultPtr.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the sent tag by async result ptr"));
+        return;
+    }
+
+    SendTagAsyncData data = it.value();
+    Q_UNUSED(m_sendTagAsyncDataByAsyncResultPtr.erase(it))
+
+    Tag & tag = data.m_tag;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
+    {
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForTag(tag, userException, data.m_source, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
+    }
+    else if (data.m_source == UserExceptionSource::Creation)
+    {
+        tag.qevercloudTag() = result.value<qevercloud::Tag>();
+    }
+    else
+    {
+        tag.setUpdateSequenceNumber(result.value<qint32>());
+    }
+
+    if (data.m_source == UserExceptionSource::Creation) {
+        Q_EMIT createTagAsyncFinished(errorCode, tag, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
+    else {
+        Q_EMIT updateTagAsyncFinished(errorCode, tag, rateLimitSeconds, errorDescription, data.m_requestId);
+    }
 }
 
-qint32 NoteStore::getResource(const bool withDataBody, const bool withRecognitionDataBody,
-                              const bool withAlternateDataBody, const bool withAttributes,
-                              const QString & authToken, Resource & resource, ErrorString & errorDescription,
-                              qint32 & rateLimitSeconds)
+void NoteStore::onSendSavedSearchAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
 {
-    QNDEBUG(QStringLiteral("NoteStore::getResource: with data body = ") << (withDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with recognition data body = ") << (withRecognitionDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with alternate data body = ") << (withAlternateDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with attributes = ") << (withAttributes ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", resource guid = ") << (resource.hasGuid() ? resource.guid() : QStringLiteral("<not set>")));
+    QNDEBUG(QStringLiteral("NoteStore::onSendSavedSearchAsyncFinished"));
 
-    if (!resource.hasGuid()) {
-        errorDescription.setBase(QT_TR_NOOP("can't get resource: resource's guid is empty"));
-        return qevercloud::EDAMErrorCode::UNKNOWN;
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the saved search "
+                               "to which the result corresponds"));
+        return;
     }
 
-    try
-    {
-        resource.qevercloudResource() = m_pQecNoteStore->getResource(resource.guid(), withDataBody, withRecognitionDataBody,
-                                                                     withAttributes, withAlternateDataBody, authToken);
-        resource.setLocal(false);
-        resource.setDirty(false);
-        return 0;
+    auto it = m_sendSavedSearchAsyncDataByAsyncResultPtr.find(pAsyncResult);
+    if (it == m_sendSavedSearchAsyncDataByAsyncResultPtr.end()) {
+        QNDEBUG(QStringLiteral("Couldn't find the sent saved search by async result ptr"));
+        return;
     }
-    catch(const qevercloud::EDAMUserException & userException)
+
+    SendSavedSearchAsyncData data = it.value();
+    Q_UNUSED(m_sendSavedSearchAsyncDataByAsyncResultPtr.erase(it))
+
+    SavedSearch & savedSearch = data.m_savedSearch;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
     {
-        return processEdamUserExceptionForGetResource(resource.qevercloudResource(), userException, errorDescription);
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
+
+        try
+        {
+            exceptionData->throwException();
+        }
+        catch(const qevercloud::EDAMUserException & userException)
+        {
+            errorCode = processEdamUserExceptionForSavedSearch(savedSearch, userException, data.m_source, errorDescription);
+        }
+        catch(const qevercloud::EDAMNotFoundException & notFoundException)
+        {
+            processEdamNotFoundException(notFoundException, errorDescription);
+            errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        }
+        catch(const qevercloud::EDAMSystemException & systemException)
+        {
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
     }
-    catch(const qevercloud::EDAMNotFoundException & notFoundException)
+    else if (data.m_source == UserExceptionSource::Creation)
     {
-        processEdamNotFoundException(notFoundException, errorDescription);
+        savedSearch.qevercloudSavedSearch() = result.value<qevercloud::SavedSearch>();
     }
-    catch(const qevercloud::EDAMSystemException & systemException)
+    else
     {
-        return processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
+        savedSearch.setUpdateSequenceNumber(result.value<qint32>());
     }
-    CATCH_GENERIC_EXCEPTIONS_NO_RET()
-
-    return qevercloud::EDAMErrorCode::UNKNOWN;
-}
-
-bool NoteStore::getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
-                                 const bool withAlternateDataBody, const bool withAttributes,
-                                 const QString & resourceGuid, const QString & authToken, ErrorString & errorDescription)
-{
-    QNDEBUG(QStringLiteral("NoteStore::getResourceAsync: with data body = ") << (withDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with recognition data body = ") << (withRecognitionDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with alternate data body = ") << (withAlternateDataBody ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", with attributes = ") << (withAttributes ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", resource guid = ") << resourceGuid);
 
-    if (Q_UNLIKELY(resourceGuid.isEmpty())) {
-        errorDescription.setBase(QT_TR_NOOP("Detected the attempt to get full resource's data for empty resource guid"));
-        return false;
+    if (data.m_source == UserExceptionSource::Creation) {
+        Q_EMIT createSavedSearchAsyncFinished(errorCode, savedSearch, rateLimitSeconds, errorDescription, data.m_requestId);
     }
-
-    qevercloud::AsyncResult * pAsyncResult = m_pQecNoteStore->getResourceAsync(resourceGuid, withDataBody, withRecognitionDataBody,
-                                                                               withAttributes, withAlternateDataBody, authToken);
-    if (Q_UNLIKELY(!pAsyncResult)) {
-        errorDescription.setBase(QT_TR_NOOP("Can't get full resource data: internal error, QEverCloud library returned "
-                                            "null pointer to asynchronous result object"));
-        return false;
+    else {
+        Q_EMIT updateSavedSearchAsyncFinished(errorCode, savedSearch, rateLimitSeconds, errorDescription, data.m_requestId);
     }
-
-    m_resourceGuidByAsyncResultPtr[pAsyncResult] = resourceGuid;
-
-    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
-                     this, QNSLOT(NoteStore,onGetResourceAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
-    return true;
 }
 
-qint32 NoteStore::authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
-                                               ErrorString & errorDescription, qint32 & rateLimitSeconds)
+void NoteStore::onGetSyncChunkAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
 {
-    try
-    {
-        authResult = m_pQecNoteStore->authenticateToSharedNotebook(shareKey);
-        return 0;
-    }
-    catch(const qevercloud::EDAMUserException & userException)
+    QNDEBUG(QStringLiteral("NoteStore::onGetSyncChunkAsyncFinished"));
+
+    qint32 afterUSN = 0;
+    qint32 maxEntries = 0;
+
+    qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
+    if (pAsyncResult)
     {
-        if (userException.errorCode == qevercloud::EDAMErrorCode::DATA_REQUIRED) {
-            errorDescription.setBase(QT_TR_NOOP("no valid authentication token for current user"));
-        }
-        else if (userException.errorCode == qevercloud::EDAMErrorCode::PERMISSION_DENIED) {
-            errorDescription.setBase(QT_TR_NOOP("share requires login, and another username has already been bound to this notebook"));
+        auto it = m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.find(pAsyncResult);
+        if (it != m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.end()) {
+            afterUSN = it.value().first;
+            maxEntries = it.value().second;
+            Q_UNUSED(m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr.erase(it))
         }
         else {
-            errorDescription.setBase(QT_TR_NOOP("unexpected EDAM user exception"));
-            errorDescription.details() = QStringLiteral("error code = ");
-            errorDescription.details() += ToString(userException.errorCode);
+            QNDEBUG(QStringLiteral("Couldn't find the after USN by async result ptr"));
+            return;
         }
-
-        return userException.errorCode;
     }
-    catch(const qevercloud::EDAMNotFoundException & notFoundException)
+    else
     {
-        // NOTE: this means that shared notebook no longer exists. It can happen with
-        // shared/linked notebooks from time to time so it shouldn't be really considered
-        // an error. Instead, the method would return empty auth result which should indicate
-        // the fact of missing shared notebook to the caller
-        Q_UNUSED(notFoundException)
-        authResult = qevercloud::AuthenticationResult();
-        return 0;
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the after USN "
+                               "to which the result corresponds"));
+        return;
     }
-    catch(const qevercloud::EDAMSystemException & systemException)
+
+    qevercloud::SyncChunk syncChunk;
+
+    ErrorString errorDescription;
+    qint32 errorCode = 0;
+    qint32 rateLimitSeconds = -1;
+
+    if (!exceptionData.isNull())
     {
-        if (systemException.errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
-        {
-            if (!systemException.rateLimitDuration.isSet()) {
-                errorDescription.setBase(QT_TR_NOOP("QEverCloud error: RATE_LIMIT_REACHED exception "
-                                                    "was caught but rateLimitDuration is not set"));
-                return qevercloud::EDAMErrorCode::UNKNOWN;
-            }
+        QNDEBUG(QStringLiteral("Error: ") << exceptionData->errorMessage);
 
-            rateLimitSeconds = systemException.rateLimitDuration;
-        }
-        else if (systemException.errorCode == qevercloud::EDAMErrorCode::BAD_DATA_FORMAT)
+        try
         {
-            errorDescription.setBase(QT_TR_NOOP("invalid share key"));
+            exceptionData->throwException();
         }
-        else if (systemException.errorCode == qevercloud::EDAMErrorCode::INVALID_AUTH)
+        catch(const qevercloud::EDAMUserException & userException)
         {
-            errorDescription.setBase(QT_TR_NOOP("bad signature of share key"));
+            errorCode = processEdamUserExceptionForGetSyncChunk(userException, afterUSN, maxEntries, errorDescription);
         }
-        else
+        catch(const qevercloud::EDAMSystemException & systemException)
         {
-            errorDescription.setBase(QT_TR_NOOP("unexpected EDAM system exception"));
-            errorDescription.details() = QStringLiteral("error code = ");
-            errorDescription.details() += ToString(systemException.errorCode);
+            errorCode = processEdamSystemException(systemException, errorDescription, rateLimitSeconds);
         }
+        CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
 
-        return systemException.errorCode;
+        Q_EMIT getSyncChunkAsyncFinished(errorCode, syncChunk, afterUSN, rateLimitSeconds, errorDescription);
+        return;
     }
-    CATCH_GENERIC_EXCEPTIONS_NO_RET()
 
-    return qevercloud::EDAMErrorCode::UNKNOWN;
+    syncChunk = result.value<qevercloud::SyncChunk>();
+    Q_EMIT getSyncChunkAsyncFinished(errorCode, syncChunk, afterUSN, rateLimitSeconds, errorDescription);
 }
 
-void NoteStore::onGetNoteAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+void NoteStore::onGetLinkedNotebookSyncStateAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
 {
-    QNDEBUG(QStringLiteral("NoteStore::onGetNoteAsyncFinished"));
+    QNDEBUG(QStringLiteral("NoteStore::onGetLinkedNotebookSyncStateAsyncFinished"));
 
-    QString noteGuid;
+    QString linkedNotebookGuid;
 
     qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
     if (pAsyncResult)
     {
-        auto it = m_noteGuidByAsyncResultPtr.find(pAsyncResult);
-        if (it != m_noteGuidByAsyncResultPtr.end()) {
-            noteGuid = it.value();
-            Q_UNUSED(m_noteGuidByAsyncResultPtr.erase(it))
+        auto it = m_linkedNotebookGuidBySyncStateAsyncResultPtr.find(pAsyncResult);
+        if (it != m_linkedNotebookGuidBySyncStateAsyncResultPtr.end()) {
+            linkedNotebookGuid = it.value();
+            Q_UNUSED(m_linkedNotebookGuidBySyncStateAsyncResultPtr.erase(it))
         }
         else {
-            QNDEBUG(QStringLiteral("Couldn't find the note guid by async result ptr"));
+            QNDEBUG(QStringLiteral("Couldn't find the linked notebook guid by async result ptr"));
             return;
         }
     }
     else
     {
-        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the note guid "
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the linked notebook guid "
                                "to which the result corresponds"));
         return;
     }
 
-    qevercloud::Note note;
-    note.guid = noteGuid;
+    qevercloud::SyncState syncState;
 
     ErrorString errorDescription;
     qint32 errorCode = 0;
@@ -726,11 +1410,17 @@ void NoteStore::onGetNoteAsyncFinished(QVariant result, QSharedPointer<EverCloud
         }
         catch(const qevercloud::EDAMUserException & userException)
         {
-            errorCode = processEdamUserExceptionForGetNote(note, userException, errorDescription);
+            SET_EDAM_USER_EXCEPTION_ERROR(userException)
+            errorCode = userException.errorCode;
         }
         catch(const qevercloud::EDAMNotFoundException & notFoundException)
         {
-            processEdamNotFoundException(notFoundException, errorDescription);
+            errorDescription.setBase(QT_TR_NOOP("caught EDAM not found exception, could not find "
+                                                "linked notebook to get the sync state for"));
+            if (!notFoundException.exceptionData().isNull()) {
+                errorDescription.details() += ToString(notFoundException.exceptionData()->errorMessage);
+            }
+
             errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
         }
         catch(const qevercloud::EDAMSystemException & systemException)
@@ -739,42 +1429,41 @@ void NoteStore::onGetNoteAsyncFinished(QVariant result, QSharedPointer<EverCloud
         }
         CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
 
-        Q_EMIT getNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription);
+        Q_EMIT getLinkedNotebookSyncStateAsyncFinished(errorCode, syncState, rateLimitSeconds, errorDescription, linkedNotebookGuid);
         return;
     }
 
-    note = result.value<qevercloud::Note>();
-    Q_EMIT getNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription);
+    syncState = result.value<qevercloud::SyncState>();
+    Q_EMIT getLinkedNotebookSyncStateAsyncFinished(errorCode, syncState, rateLimitSeconds, errorDescription, linkedNotebookGuid);
 }
 
-void NoteStore::onGetResourceAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
+void NoteStore::onGetLinkedNotebookSyncChunkAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData)
 {
-    QNDEBUG(QStringLiteral("NoteStore::onGetResourceAsyncFinished"));
+    QNDEBUG(QStringLiteral("NoteStore::onGetLinkedNotebookSyncChunkAsyncFinished"));
 
-    QString resourceGuid;
+    LinkedNotebookSyncChunkAsyncData data;
 
     qevercloud::AsyncResult * pAsyncResult = qobject_cast<qevercloud::AsyncResult*>(sender());
     if (pAsyncResult)
     {
-        auto it = m_resourceGuidByAsyncResultPtr.find(pAsyncResult);
-        if (it != m_resourceGuidByAsyncResultPtr.end()) {
-            resourceGuid = it.value();
-            Q_UNUSED(m_resourceGuidByAsyncResultPtr.erase(it))
+        auto it = m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.find(pAsyncResult);
+        if (it != m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.end()) {
+            data = it.value();
+            Q_UNUSED(m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr.erase(it))
         }
         else {
-            QNDEBUG(QStringLiteral("Couldn't find the resource guid by async result ptr"));
+            QNDEBUG(QStringLiteral("Couldn't find the linked notebook sync chunk request data by async result ptr"));
             return;
         }
     }
     else
     {
-        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the resource guid "
+        QNDEBUG(QStringLiteral("Couldn't get non-NULL pointer to AsyncResult, hence can't get the linked notebook "
                                "to which the result corresponds"));
         return;
     }
 
-    qevercloud::Resource resource;
-    resource.guid = resourceGuid;
+    qevercloud::SyncChunk syncChunk;
 
     ErrorString errorDescription;
     qint32 errorCode = 0;
@@ -790,11 +1479,11 @@ void NoteStore::onGetResourceAsyncFinished(QVariant result, QSharedPointer<EverC
         }
         catch(const qevercloud::EDAMUserException & userException)
         {
-            errorCode = processEdamUserExceptionForGetResource(resource, userException, errorDescription);
+            errorCode = processEdamUserExceptionForGetSyncChunk(userException, data.m_afterUsn, data.m_maxEntries, errorDescription);
         }
         catch(const qevercloud::EDAMNotFoundException & notFoundException)
         {
-            processEdamNotFoundException(notFoundException, errorDescription);
+            processEdamNotFoundExceptionForGetLinkedNotebookSyncChunk(notFoundException, errorDescription);
             errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
         }
         catch(const qevercloud::EDAMSystemException & systemException)
@@ -803,12 +1492,14 @@ void NoteStore::onGetResourceAsyncFinished(QVariant result, QSharedPointer<EverC
         }
         CATCH_GENERIC_EXCEPTIONS_IMPL(errorCode = qevercloud::EDAMErrorCode::UNKNOWN)
 
-        Q_EMIT getResourceAsyncFinished(errorCode, resource, rateLimitSeconds, errorDescription);
+        Q_EMIT getLinkedNotebookSyncChunkAsyncFinished(errorCode, syncChunk, data.m_afterUsn, rateLimitSeconds,
+                                                       errorDescription, data.m_linkedNotebookGuid);
         return;
     }
 
-    resource = result.value<qevercloud::Resource>();
-    Q_EMIT getResourceAsyncFinished(errorCode, resource, rateLimitSeconds, errorDescription);
+    syncChunk = result.value<qevercloud::SyncChunk>();
+    Q_EMIT getLinkedNotebookSyncChunkAsyncFinished(errorCode, syncChunk, data.m_afterUsn, rateLimitSeconds,
+                                                   errorDescription, data.m_linkedNotebookGuid);
 }
 
 qint32 NoteStore::processEdamUserExceptionForTag(const Tag & tag, const qevercloud::EDAMUserException & userException,
@@ -1228,6 +1919,95 @@ qint32 NoteStore::processEdamUserExceptionForGetResource(const qevercloud::Resou
     return userException.errorCode;
 }
 
+bool NoteStore::sendNoteAsync(const Note & note, const UserExceptionSource::type source, const QString & linkedNotebookAuthToken,
+                              const QUuid & requestId, ErrorString & errorDescription)
+{
+    qevercloud::AsyncResult * pAsyncResult = ((source == UserExceptionSource::Creation)
+                                              ? m_pQecNoteStore->createNoteAsync(note.qevercloudNote(), linkedNotebookAuthToken)
+                                              : m_pQecNoteStore->updateNoteAsync(note.qevercloudNote(), linkedNotebookAuthToken));
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't send the note: internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    SendNoteAsyncData & data = m_sendNoteAsyncDataByAsyncResultPtr[pAsyncResult];
+    data.m_note = note;
+    data.m_source = source;
+    data.m_requestId = requestId;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onSendNoteAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+bool NoteStore::sendNotebookAsync(const Notebook & notebook, const UserExceptionSource::type source,
+                                  const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                  ErrorString & errorDescription)
+{
+    qevercloud::AsyncResult * pAsyncResult = ((source == UserExceptionSource::Creation)
+                                              ? m_pQecNoteStore->createNotebookAsync(notebook.qevercloudNotebook(), linkedNotebookAuthToken)
+                                              : m_pQecNoteStore->updateNotebookAsync(notebook.qevercloudNotebook(), linkedNotebookAuthToken));
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't send the notebook: internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    SendNotebookAsyncData & data = m_sendNotebookAsyncDataByAsyncResultPtr[pAsyncResult];
+    data.m_notebook = notebook;
+    data.m_source = source;
+    data.m_requestId = requestId;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onSendNotebookAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+bool NoteStore::sendTagAsync(const Tag & tag, const UserExceptionSource::type source, const QString & linkedNotebookAuthToken,
+                             const QUuid & requestId, ErrorString & errorDescription)
+{
+    qevercloud::AsyncResult * pAsyncResult = ((source == UserExceptionSource::Creation)
+                                              ? m_pQecNoteStore->createTagAsync(tag.qevercloudTag(), linkedNotebookAuthToken)
+                                              : m_pQecNoteStore->updateTagAsync(tag.qevercloudTag(), linkedNotebookAuthToken));
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't send the tag: internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    SendTagAsyncData & data = m_sendTagAsyncDataByAsyncResultPtr[pAsyncResult];
+    data.m_tag = tag;
+    data.m_source = source;
+    data.m_requestId = requestId;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onSendTagAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
+bool NoteStore::sendSavedSearchAsync(const SavedSearch & savedSearch, const UserExceptionSource::type source,
+                                     const QUuid & requestId, ErrorString & errorDescription)
+{
+    qevercloud::AsyncResult * pAsyncResult = ((source == UserExceptionSource::Creation)
+                                              ? m_pQecNoteStore->createSearchAsync(savedSearch.qevercloudSavedSearch())
+                                              : m_pQecNoteStore->updateSearchAsync(savedSearch.qevercloudSavedSearch()));
+    if (Q_UNLIKELY(!pAsyncResult)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't send the saved search: internal error, QEverCloud library returned "
+                                            "null pointer to asynchronous result object"));
+        return false;
+    }
+
+    SendSavedSearchAsyncData & data = m_sendSavedSearchAsyncDataByAsyncResultPtr[pAsyncResult];
+    data.m_savedSearch = savedSearch;
+    data.m_source = source;
+    data.m_requestId = requestId;
+
+    QObject::connect(pAsyncResult, QNSIGNAL(qevercloud::AsyncResult,finished,QVariant,QSharedPointer<EverCloudExceptionData>),
+                     this, QNSLOT(NoteStore,onSendSavedSearchAsyncFinished,QVariant,QSharedPointer<EverCloudExceptionData>));
+    return true;
+}
+
 qint32 NoteStore::processEdamUserExceptionForNotebook(const Notebook & notebook,
                                                       const qevercloud::EDAMUserException & userException,
                                                       const NoteStore::UserExceptionSource::type & source,
@@ -1698,4 +2478,32 @@ void NoteStore::processEdamNotFoundException(const qevercloud::EDAMNotFoundExcep
     }
 }
 
+void NoteStore::processEdamNotFoundExceptionForGetLinkedNotebookSyncChunk(const qevercloud::EDAMNotFoundException & notFoundException,
+                                                                          ErrorString & errorDescription) const
+{
+    errorDescription.setBase(QT_TR_NOOP("caught EDAM not found exception while attempting to "
+                                        "download the sync chunk for linked notebook"));
+    if (notFoundException.exceptionData().isNull()) {
+        return;
+    }
+
+    const QString & errorMessage = notFoundException.exceptionData()->errorMessage;
+    if (errorMessage == QStringLiteral("LinkedNotebook")) {
+        errorDescription.appendBase(QT_TR_NOOP("the provided information "
+                                               "doesn't match any valid notebook"));
+    }
+    else if (errorMessage == QStringLiteral("LinkedNotebook.uri")) {
+        errorDescription.appendBase(QT_TR_NOOP("the provided public URI doesn't "
+                                               "match any valid notebook"));
+    }
+    else if (errorMessage == QStringLiteral("SharedNotebook.id")) {
+        errorDescription.appendBase(QT_TR_NOOP("the provided information indicates "
+                                               "the shared notebook no longer exists"));
+    }
+    else {
+        errorDescription.appendBase(QT_TR_NOOP("unknown error"));
+        errorDescription.details() = errorMessage;
+    }
+}
+
 } // namespace quentier
@@ -19,11 +19,18 @@
 #ifndef LIB_QUENTIER_SYNCHRONIZATION_NOTE_STORE_H
 #define LIB_QUENTIER_SYNCHRONIZATION_NOTE_STORE_H
 
+#include <quentier/synchronization/INoteStore.h>
 #include <quentier/utility/Macros.h>
 #include <quentier/types/ErrorString.h>
+#include <quentier/types/Note.h>
+#include <quentier/types/Notebook.h>
+#include <quentier/types/Tag.h>
+#include <quentier/types/SavedSearch.h>
 #include <QSharedPointer>
 #include <QObject>
 #include <QHash>
+#include <QPair>
+#include <QUuid>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <qt5qevercloud/QEverCloud.h>
@@ -33,11 +40,7 @@
 
 namespace quentier {
 
-QT_FORWARD_DECLARE_CLASS(Notebook)
-QT_FORWARD_DECLARE_CLASS(Note)
 QT_FORWARD_DECLARE_CLASS(Resource)
-QT_FORWARD_DECLARE_CLASS(Tag)
-QT_FORWARD_DECLARE_CLASS(SavedSearch)
 
 /**
  * @brief The NoteStore class in quentier namespace is a wrapper under NoteStore from QEverCloud.
@@ -50,77 +53,159 @@ QT_FORWARD_DECLARE_CLASS(SavedSearch)
  * libquentier at the moment uses only several methods from those available in QEverCloud's NoteStore
  * so only the small subset of original NoteStore's API is wrapped here at the moment.
  */
-class Q_DECL_HIDDEN NoteStore: public QObject
+class Q_DECL_HIDDEN NoteStore: public INoteStore
 {
     Q_OBJECT
 public:
     explicit NoteStore(QSharedPointer<qevercloud::NoteStore> pQecNoteStore, QObject * parent = Q_NULLPTR);
     virtual ~NoteStore();
 
-    void stop();
+    virtual void stop() Q_DECL_OVERRIDE;
 
-    QSharedPointer<qevercloud::NoteStore> getQecNoteStore();
-
-    QString noteStoreUrl() const;
-    void setNoteStoreUrl(const QString & noteStoreUrl);
-
-    QString authenticationToken() const;
-    void setAuthenticationToken(const QString & authToken);
-
-    qint32 createNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
-    qint32 updateNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
-
-    qint32 createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
-    qint32 updateNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
+    virtual INoteStore * create() const Q_DECL_OVERRIDE;
 
-    qint32 createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
-    qint32 updateTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString());
-
-    qint32 createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds);
-    qint32 updateSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds);
-
-    qint32 getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+    QSharedPointer<qevercloud::NoteStore> getQecNoteStore();
 
-    qint32 getSyncChunk(const qint32 afterUSN, const qint32 maxEntries,
+    virtual QString noteStoreUrl() const Q_DECL_OVERRIDE;
+    virtual void setNoteStoreUrl(const QString & noteStoreUrl) Q_DECL_OVERRIDE;
+
+    virtual QString authenticationToken() const Q_DECL_OVERRIDE;
+    virtual void setAuthenticationToken(const QString & authToken) Q_DECL_OVERRIDE;
+
+    virtual qint32 createNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateNotebook(Notebook & notebook, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief createNotebookAsync - starts creating the notebook asynchronously; the outcome is reported via
+     * createNotebookAsyncFinished signal with the same request id
+     * @return true if the notebook creation has been started, false otherwise
+     */
+    virtual bool createNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief updateNotebookAsync - starts updating the notebook asynchronously; the outcome is reported via
+     * updateNotebookAsyncFinished signal with the same request id
+     * @return true if the notebook update has been started, false otherwise
+     */
+    virtual bool updateNotebookAsync(const Notebook & notebook, const QString & linkedNotebookAuthToken,
+                                     const QUuid & requestId, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateNote(Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief createNoteAsync - starts creating the note asynchronously; the outcome is reported via
+     * createNoteAsyncFinished signal with the same request id
+     * @return true if the note creation has been started, false otherwise
+     */
+    virtual bool createNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                         ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief updateNoteAsync - starts updating the note asynchronously; the outcome is reported via
+     * updateNoteAsyncFinished signal with the same request id
+     * @return true if the note update has been started, false otherwise
+     */
+    virtual bool updateNoteAsync(const Note & note, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                         ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+    virtual qint32 updateTag(Tag & tag, ErrorString & errorDescription, qint32 & rateLimitSeconds, const QString & linkedNotebookAuthToken = QString()) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief createTagAsync - starts creating the tag asynchronously; the outcome is reported via
+     * createTagAsyncFinished signal with the same request id
+     * @return true if the tag creation has been started, false otherwise
+     */
+    virtual bool createTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief updateTagAsync - starts updating the tag asynchronously; the outcome is reported via
+     * updateTagAsyncFinished signal with the same request id
+     * @return true if the tag update has been started, false otherwise
+     */
+    virtual bool updateTagAsync(const Tag & tag, const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                                ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 createSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+    virtual qint32 updateSavedSearch(SavedSearch & savedSearch, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief createSavedSearchAsync - starts creating the saved search asynchronously; the outcome is reported via
+     * createSavedSearchAsyncFinished signal with the same request id
+     * @return true if the saved search creation has been started, false otherwise
+     */
+    virtual bool createSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                        ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief updateSavedSearchAsync - starts updating the saved search asynchronously; the outcome is reported via
+     * updateSavedSearchAsyncFinished signal with the same request id
+     * @return true if the saved search update has been started, false otherwise
+     */
+    virtual bool updateSavedSearchAsync(const SavedSearch & savedSearch, const QUuid & requestId,
+                                        ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getSyncState(qevercloud::SyncState & syncState, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual qint32 getSyncChunk(const qint32 afterUSN, const qint32 maxEntries,
                         const qevercloud::SyncChunkFilter & filter,
                         qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
-                        qint32 & rateLimitSeconds);
+                        qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    virtual bool getSyncChunkAsync(const qint32 afterUSN, const qint32 maxEntries,
+                           const qevercloud::SyncChunkFilter & filter,
+                           ErrorString & errorDescription) Q_DECL_OVERRIDE;
 
-    qint32 getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
+    virtual qint32 getLinkedNotebookSyncState(const qevercloud::LinkedNotebook & linkedNotebook,
                                       const QString & authToken, qevercloud::SyncState & syncState,
-                                      ErrorString & errorDescription, qint32 & rateLimitSeconds);
+                                      ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
 
-    qint32 getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook & linkedNotebook,
+    virtual qint32 getLinkedNotebookSyncChunk(const qevercloud::LinkedNotebook & linkedNotebook,
                                       const qint32 afterUSN, const qint32 maxEntries,
                                       const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
                                       qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription,
-                                      qint32 & rateLimitSeconds);
-
-    qint32 getNote(const bool withContent, const bool withResourcesData,
+                                      qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief getLinkedNotebookSyncStateAsync - starts getting the sync state of the linked notebook asynchronously;
+     * the outcome is reported via getLinkedNotebookSyncStateAsyncFinished signal with the linked notebook's guid
+     */
+    virtual bool getLinkedNotebookSyncStateAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                         const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    /**
+     * @brief getLinkedNotebookSyncChunkAsync - starts downloading the linked notebook's sync chunk asynchronously;
+     * the outcome is reported via getLinkedNotebookSyncChunkAsyncFinished signal with the linked notebook's guid
+     */
+    virtual bool getLinkedNotebookSyncChunkAsync(const qevercloud::LinkedNotebook & linkedNotebook,
+                                         const qint32 afterUSN, const qint32 maxEntries,
+                                         const QString & linkedNotebookAuthToken, const bool fullSyncOnly,
+                                         ErrorString & errorDescription) Q_DECL_OVERRIDE;
+
+    virtual qint32 getNote(const bool withContent, const bool withResourcesData,
                    const bool withResourcesRecognition, const bool withResourceAlternateData,
-                   Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds);
+                   Note & note, ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
 
-    bool getNoteAsync(const bool withContent, const bool withResourceData, const bool withResourcesRecognition,
+    virtual bool getNoteAsync(const bool withContent, const bool withResourceData, const bool withResourcesRecognition,
                       const bool withResourceAlternateData, const bool withSharedNotes,
                       const bool withNoteAppDataValues, const bool withResourceAppDataValues,
                       const bool withNoteLimits, const QString & noteGuid,
-                      const QString & authToken, ErrorString & errorDescription);
+                      const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
 
-    qint32 getResource(const bool withDataBody, const bool withRecognitionDataBody,
+    virtual qint32 getResource(const bool withDataBody, const bool withRecognitionDataBody,
                        const bool withAlternateDataBody, const bool withAttributes,
                        const QString & authToken, Resource & resource, ErrorString & errorDescription,
-                       qint32 & rateLimitSeconds);
+                       qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
 
-    bool getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
+    virtual bool getResourceAsync(const bool withDataBody, const bool withRecognitionDataBody,
                           const bool withAlternateDataBody, const bool withAttributes, const QString & resourceGuid,
-                          const QString & authToken, ErrorString & errorDescription);
-
-    qint32 authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
-                                        ErrorString & errorDescription, qint32 & rateLimitSeconds);
+                          const QString & authToken, ErrorString & errorDescription) Q_DECL_OVERRIDE;
 
-Q_SIGNALS:
-    void getNoteAsyncFinished(qint32 errorCode, qevercloud::Note note, qint32 rateLimitSeconds, ErrorString errorDescription);
-    void getResourceAsyncFinished(qint32 errorCode, qevercloud::Resource resource, qint32 rateLimitSeconds, ErrorString errorDescription);
+    virtual qint32 authenticateToSharedNotebook(const QString & shareKey, qevercloud::AuthenticationResult & authResult,
+                                        ErrorString & errorDescription, qint32 & rateLimitSeconds) Q_DECL_OVERRIDE;
 
 private:
     typedef qevercloud::EverCloudExceptionData EverCloudExceptionData;
@@ -128,6 +213,13 @@ private:
 private Q_SLOTS:
     void onGetNoteAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
     void onGetResourceAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onGetSyncChunkAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onSendNoteAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onSendNotebookAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onSendTagAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onSendSavedSearchAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onGetLinkedNotebookSyncStateAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
+    void onGetLinkedNotebookSyncChunkAsyncFinished(QVariant result, QSharedPointer<EverCloudExceptionData> exceptionData);
 
 private:
     struct UserExceptionSource
@@ -169,6 +261,67 @@ private:
     void processEdamNotFoundException(const qevercloud::EDAMNotFoundException & notFoundException,
                                       ErrorString & errorDescription) const;
 
+    void processEdamNotFoundExceptionForGetLinkedNotebookSyncChunk(const qevercloud::EDAMNotFoundException & notFoundException,
+                                                                   ErrorString & errorDescription) const;
+
+    bool sendNoteAsync(const Note & note, const UserExceptionSource::type source, const QString & linkedNotebookAuthToken,
+                       const QUuid & requestId, ErrorString & errorDescription);
+
+    struct SendNoteAsyncData
+    {
+        SendNoteAsyncData() : m_note(), m_source(UserExceptionSource::Creation), m_requestId() {}
+
+        Note                        m_note;
+        UserExceptionSource::type   m_source;
+        QUuid                       m_requestId;
+    };
+
+    bool sendNotebookAsync(const Notebook & notebook, const UserExceptionSource::type source,
+                           const QString & linkedNotebookAuthToken, const QUuid & requestId,
+                           ErrorString & errorDescription);
+
+    struct SendNotebookAsyncData
+    {
+        SendNotebookAsyncData() : m_notebook(), m_source(UserExceptionSource::Creation), m_requestId() {}
+
+        Notebook                    m_notebook;
+        UserExceptionSource::type   m_source;
+        QUuid                       m_requestId;
+    };
+
+    bool sendTagAsync(const Tag & tag, const UserExceptionSource::type source, const QString & linkedNotebookAuthToken,
+                      const QUuid & requestId, ErrorString & errorDescription);
+
+    struct SendTagAsyncData
+    {
+        SendTagAsyncData() : m_tag(), m_source(UserExceptionSource::Creation), m_requestId() {}
+
+        Tag                         m_tag;
+        UserExceptionSource::type   m_source;
+        QUuid                       m_requestId;
+    };
+
+    bool sendSavedSearchAsync(const SavedSearch & savedSearch, const UserExceptionSource::type source,
+                              const QUuid & requestId, ErrorString & errorDescription);
+
+    struct SendSavedSearchAsyncData
+    {
+        SendSavedSearchAsyncData() : m_savedSearch(), m_source(UserExceptionSource::Creation), m_requestId() {}
+
+        SavedSearch                 m_savedSearch;
+        UserExceptionSource::type   m_source;
+        QUuid                       m_requestId;
+    };
+
+    struct LinkedNotebookSyncChunkAsyncData
+    {
+        LinkedNotebookSyncChunkAsyncData() : m_linkedNotebookGuid(), m_afterUsn(0), m_maxEntries(0) {}
+
+        QString     m_linkedNotebookGuid;
+        qint32      m_afterUsn;
+        qint32      m_maxEntries;
+    };
+
 private:
     Q_DISABLE_COPY(NoteStore)
 
@@ -176,6 +329,13 @@ private:
     QSharedPointer<qevercloud::NoteStore>       m_pQecNoteStore;
     QHash<qevercloud::AsyncResult*, QString>    m_noteGuidByAsyncResultPtr;
     QHash<qevercloud::AsyncResult*, QString>    m_resourceGuidByAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, QPair<qint32,qint32> >  m_afterUsnAndMaxEntriesBySyncChunkAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, SendNoteAsyncData>      m_sendNoteAsyncDataByAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, SendNotebookAsyncData>  m_sendNotebookAsyncDataByAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, SendTagAsyncData>       m_sendTagAsyncDataByAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, SendSavedSearchAsyncData>   m_sendSavedSearchAsyncDataByAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, QString>                m_linkedNotebookGuidBySyncStateAsyncResultPtr;
+    QHash<qevercloud::AsyncResult*, LinkedNotebookSyncChunkAsyncData>  m_linkedNotebookSyncChunkAsyncDataByAsyncResultPtr;
 };
 
 } // namespace quentier
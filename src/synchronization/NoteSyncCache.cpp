@@ -36,8 +36,19 @@
 #define NSWARNING(message) \
     __NSLOG_BASE(message, Warn)
 
+// NOTE: the local storage lists the notes with all their fields while the cache only needs a few of them
+// so the notes are listed page by page to avoid keeping all of them in memory at once
+#define LIST_NOTES_PAGE_SIZE (100)
+
 namespace quentier {
 
+NoteSyncCache::NoteSyncInfo::NoteSyncInfo() :
+    m_localUid(),
+    m_updateSequenceNumber(-1),
+    m_isDirty(false),
+    m_contentHash()
+{}
+
 NoteSyncCache::NoteSyncCache(LocalStorageManagerAsync & localStorageManagerAsync,
                              const QString & linkedNotebookGuid, QObject * parent) :
     QObject(parent),
@@ -45,10 +56,10 @@ NoteSyncCache::NoteSyncCache(LocalStorageManagerAsync & localStorageManagerAsync
     m_connectedToLocalStorage(false),
     m_linkedNotebookGuid(linkedNotebookGuid),
     m_noteGuidToLocalUidBimap(),
-    m_dirtyNotesByGuid(),
+    m_noteSyncInfoByGuid(),
     m_notebookGuidByNoteGuid(),
     m_listNotesRequestId(),
-    m_limit(40),
+    m_limit(LIST_NOTES_PAGE_SIZE),
     m_offset(0)
 {}
 
@@ -59,7 +70,7 @@ void NoteSyncCache::clear()
     disconnectFromLocalStorage();
 
     m_noteGuidToLocalUidBimap.clear();
-    m_dirtyNotesByGuid.clear();
+    m_noteSyncInfoByGuid.clear();
     m_notebookGuidByNoteGuid.clear();
     m_listNotesRequestId = QUuid();
     m_offset = 0;
@@ -78,6 +89,44 @@ bool NoteSyncCache::isFilled() const
     return false;
 }
 
+NoteSyncCache::NoteSyncStatus::type NoteSyncCache::noteSyncStatus(const qevercloud::Note & remoteNote) const
+{
+    if (!remoteNote.guid.isSet()) {
+        return NoteSyncStatus::New;
+    }
+
+    auto it = m_noteSyncInfoByGuid.find(remoteNote.guid.ref());
+    if (it == m_noteSyncInfoByGuid.end()) {
+        return NoteSyncStatus::New;
+    }
+
+    return noteSyncStatus(&(it.value()), remoteNote);
+}
+
+NoteSyncCache::NoteSyncStatus::type NoteSyncCache::noteSyncStatus(const NoteSyncInfo * pLocalNoteSyncInfo,
+                                                                  const qevercloud::Note & remoteNote)
+{
+    if (!pLocalNoteSyncInfo) {
+        return NoteSyncStatus::New;
+    }
+
+    if (pLocalNoteSyncInfo->m_isDirty) {
+        return NoteSyncStatus::Conflicting;
+    }
+
+    // NOTE: the content hash is compared along with the update sequence number to be on the safe side:
+    // the local note with the matching update sequence number but without the content or with some other content
+    // still needs to be updated
+    if (remoteNote.updateSequenceNum.isSet() && (pLocalNoteSyncInfo->m_updateSequenceNumber == remoteNote.updateSequenceNum.ref()) &&
+        !pLocalNoteSyncInfo->m_contentHash.isEmpty() && remoteNote.contentHash.isSet() &&
+        (pLocalNoteSyncInfo->m_contentHash == remoteNote.contentHash.ref()))
+    {
+        return NoteSyncStatus::UpToDate;
+    }
+
+    return NoteSyncStatus::Modified;
+}
+
 void NoteSyncCache::fill()
 {
     NSDEBUG(QStringLiteral("NoteSyncCache::fill"));
@@ -111,9 +160,12 @@ void NoteSyncCache::onListNotesComplete(LocalStorageManager::ListObjectsOptions
         processNote(*it);
     }
 
+    int numFoundNotes = foundNotes.size();
+    foundNotes.clear();
+
     m_listNotesRequestId = QUuid();
 
-    if (foundNotes.size() == static_cast<int>(limit)) {
+    if ((limit != 0) && (numFoundNotes == static_cast<int>(limit))) {
         NSTRACE(QStringLiteral("The number of found notes matches the limit, requesting more notes from the local storage"));
         m_offset += limit;
         requestNotesList();
@@ -142,7 +194,7 @@ void NoteSyncCache::onListNotesFailed(LocalStorageManager::ListObjectsOptions fl
     NSWARNING(QStringLiteral("Failed to cache the note information required for the sync: ") << errorDescription);
 
     m_noteGuidToLocalUidBimap.clear();
-    m_dirtyNotesByGuid.clear();
+    m_noteSyncInfoByGuid.clear();
     m_notebookGuidByNoteGuid.clear();
     disconnectFromLocalStorage();
 
@@ -175,6 +227,34 @@ void NoteSyncCache::onExpungeNoteComplete(Note note, QUuid requestId)
     removeNote(note.localUid());
 }
 
+void NoteSyncCache::onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                                    QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                                    QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                                    QUuid requestId)
+{
+    if (linkedNotebookGuid != m_linkedNotebookGuid) {
+        return;
+    }
+
+    Q_UNUSED(syncedNotebookGuids)
+    Q_UNUSED(syncedTagGuids)
+    Q_UNUSED(syncedNoteGuids)
+    Q_UNUSED(syncedSavedSearchGuids)
+
+    NSDEBUG(QStringLiteral("NoteSyncCache::onExpungeStaleDataItemsComplete: request id = ")
+            << requestId << QStringLiteral(", result: ") << result);
+
+    // NOTE: the detached notes are no longer referenced by their guids within the local storage
+    // so they have nothing to keep within the cache
+    for(auto it = result.expungedNoteLocalUids.constBegin(), end = result.expungedNoteLocalUids.constEnd(); it != end; ++it) {
+        removeNote(*it);
+    }
+
+    for(auto it = result.detachedNoteLocalUids.constBegin(), end = result.detachedNoteLocalUids.constEnd(); it != end; ++it) {
+        removeNote(*it);
+    }
+}
+
 void NoteSyncCache::connectToLocalStorage()
 {
     NSDEBUG(QStringLiteral("NoteSyncCache::connectToLocalStorage"));
@@ -216,6 +296,11 @@ void NoteSyncCache::connectToLocalStorage()
                      this, QNSLOT(NoteSyncCache,onUpdateNoteComplete,Note,bool,bool,QUuid));
     QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeNoteComplete,Note,QUuid),
                      this, QNSLOT(NoteSyncCache,onExpungeNoteComplete,Note,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                           QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                           QString,StaleDataItemsExpungeResult,QUuid),
+                     this, QNSLOT(NoteSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                  QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = true;
 }
@@ -261,6 +346,11 @@ void NoteSyncCache::disconnectFromLocalStorage()
                         this, QNSLOT(NoteSyncCache,onUpdateNoteComplete,Note,bool,bool,QUuid));
     QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeNoteComplete,Note,QUuid),
                         this, QNSLOT(NoteSyncCache,onExpungeNoteComplete,Note,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                              QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                              QString,StaleDataItemsExpungeResult,QUuid),
+                        this, QNSLOT(NoteSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                     QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = false;
 }
@@ -293,9 +383,9 @@ void NoteSyncCache::removeNote(const QString & noteLocalUid)
     QString guid = localUidIt->second;
     Q_UNUSED(m_noteGuidToLocalUidBimap.right.erase(localUidIt))
 
-    auto dirtyNoteIt = m_dirtyNotesByGuid.find(guid);
-    if (dirtyNoteIt != m_dirtyNotesByGuid.end()) {
-        Q_UNUSED(m_dirtyNotesByGuid.erase(dirtyNoteIt))
+    auto noteSyncInfoIt = m_noteSyncInfoByGuid.find(guid);
+    if (noteSyncInfoIt != m_noteSyncInfoByGuid.end()) {
+        Q_UNUSED(m_noteSyncInfoByGuid.erase(noteSyncInfoIt))
     }
 
     auto notebookGuitIt = m_notebookGuidByNoteGuid.find(guid);
@@ -322,17 +412,11 @@ void NoteSyncCache::processNote(const Note & note)
 
     if (note.hasGuid())
     {
-        if (note.isDirty())
-        {
-            m_dirtyNotesByGuid[note.guid()] = note;
-        }
-        else
-        {
-            auto it = m_dirtyNotesByGuid.find(note.guid());
-            if (it != m_dirtyNotesByGuid.end()) {
-                Q_UNUSED(m_dirtyNotesByGuid.erase(it))
-            }
-        }
+        NoteSyncInfo & info = m_noteSyncInfoByGuid[note.guid()];
+        info.m_localUid = note.localUid();
+        info.m_updateSequenceNumber = (note.hasUpdateSequenceNumber() ? note.updateSequenceNumber() : -1);
+        info.m_isDirty = note.isDirty();
+        info.m_contentHash = (note.hasContentHash() ? note.contentHash() : QByteArray());
 
         if (note.hasNotebookGuid())
         {
@@ -24,6 +24,7 @@
 #include <QHash>
 #include <QSet>
 #include <QUuid>
+#include <QByteArray>
 
 // NOTE: Workaround a bug in Qt4 which may prevent building with some boost versions
 #ifndef Q_MOC_RUN
@@ -32,10 +33,52 @@
 
 namespace quentier {
 
+/**
+ * @brief The NoteSyncCache class keeps the compact index of the local notes (either from the user's own account
+ * or from some particular linked notebook) which is sufficient to classify the notes downloaded during the sync
+ * as new, already up to date, modified or conflicting ones without querying the local storage for each of them
+ */
 class Q_DECL_HIDDEN NoteSyncCache: public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @brief The NoteSyncInfo structure holds the bits of information about the local note
+     * required to detect the conflict with the remote note having the same guid
+     */
+    struct NoteSyncInfo
+    {
+        NoteSyncInfo();
+
+        QString     m_localUid;
+        qint32      m_updateSequenceNumber;
+        bool        m_isDirty;
+        QByteArray  m_contentHash;
+    };
+
+    struct NoteSyncStatus
+    {
+        enum type
+        {
+            /**
+             * There's no local note with the same guid
+             */
+            New = 0,
+            /**
+             * The local note is not dirty and has the same update sequence number and content hash as the remote one
+             */
+            UpToDate,
+            /**
+             * The local note is not dirty, it can be overridden by the remote one
+             */
+            Modified,
+            /**
+             * The local note is dirty, the conflict needs to be resolved using the full local note
+             */
+            Conflicting
+        };
+    };
+
     NoteSyncCache(LocalStorageManagerAsync & localStorageManagerAsync,
                   const QString & linkedNotebookGuid, QObject * parent = Q_NULLPTR);
 
@@ -51,9 +94,23 @@ public:
     typedef boost::bimap<QString, QString> NoteGuidToLocalUidBimap;
 
     const NoteGuidToLocalUidBimap & noteGuidToLocalUidBimap() const { return m_noteGuidToLocalUidBimap; }
-    const QHash<QString,Note> & dirtyNotesByGuid() const { return m_dirtyNotesByGuid; }
+    const QHash<QString,NoteSyncInfo> & noteSyncInfoByGuid() const { return m_noteSyncInfoByGuid; }
     const QHash<QString,QString> & notebookGuidByNoteGuid() const { return m_notebookGuidByNoteGuid; }
 
+    /**
+     * @return The sync status of the remote note with respect to the cached information about the local notes
+     */
+    NoteSyncStatus::type noteSyncStatus(const qevercloud::Note & remoteNote) const;
+
+    /**
+     * @param pLocalNoteSyncInfo - the information about the local note with the same guid as the remote note;
+     * null if there's no such local note
+     * @param remoteNote - the note from the remote storage
+     * @return The sync status of the remote note with respect to the local one
+     */
+    static NoteSyncStatus::type noteSyncStatus(const NoteSyncInfo * pLocalNoteSyncInfo,
+                                               const qevercloud::Note & remoteNote);
+
 Q_SIGNALS:
     void filled();
     void failure(ErrorString errorDescription);
@@ -85,6 +142,10 @@ private Q_SLOTS:
     void onAddNoteComplete(Note note, QUuid requestId);
     void onUpdateNoteComplete(Note note, bool updateResources, bool updateTags, QUuid requestId);
     void onExpungeNoteComplete(Note note, QUuid requestId);
+    void onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                         QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                         QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                         QUuid requestId);
 
 private:
     void connectToLocalStorage();
@@ -102,7 +163,7 @@ private:
     QString                             m_linkedNotebookGuid;
 
     NoteGuidToLocalUidBimap             m_noteGuidToLocalUidBimap;
-    QHash<QString,Note>                 m_dirtyNotesByGuid;
+    QHash<QString,NoteSyncInfo>         m_noteSyncInfoByGuid;
     QHash<QString,QString>              m_notebookGuidByNoteGuid;
 
     QUuid                               m_listNotesRequestId;
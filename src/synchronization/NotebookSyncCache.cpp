@@ -49,7 +49,7 @@ NotebookSyncCache::NotebookSyncCache(LocalStorageManagerAsync & localStorageMana
     m_notebookGuidByName(),
     m_dirtyNotebooksByGuid(),
     m_listNotebooksRequestId(),
-    m_limit(20),
+    m_limit(0),
     m_offset(0)
 {}
 
@@ -117,7 +117,7 @@ void NotebookSyncCache::onListNotebooksComplete(LocalStorageManager::ListObjects
 
     m_listNotebooksRequestId = QUuid();
 
-    if (foundNotebooks.size() == static_cast<int>(limit)) {
+    if ((limit != 0) && (foundNotebooks.size() == static_cast<int>(limit))) {
         NCTRACE(QStringLiteral("The number of found notebooks matches the limit, requesting more notebooks from the local storage"));
         m_offset += limit;
         requestNotebooksList();
@@ -181,6 +181,32 @@ void NotebookSyncCache::onExpungeNotebookComplete(Notebook notebook, QUuid reque
     removeNotebook(notebook.localUid());
 }
 
+void NotebookSyncCache::onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                                        QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                                        QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                                        QUuid requestId)
+{
+    if (linkedNotebookGuid != m_linkedNotebookGuid) {
+        return;
+    }
+
+    Q_UNUSED(syncedNotebookGuids)
+    Q_UNUSED(syncedTagGuids)
+    Q_UNUSED(syncedNoteGuids)
+    Q_UNUSED(syncedSavedSearchGuids)
+
+    NCDEBUG(QStringLiteral("NotebookSyncCache::onExpungeStaleDataItemsComplete: request id = ")
+            << requestId << QStringLiteral(", result: ") << result);
+
+    for(auto it = result.expungedNotebookLocalUids.constBegin(), end = result.expungedNotebookLocalUids.constEnd(); it != end; ++it) {
+        removeNotebook(*it);
+    }
+
+    for(auto it = result.detachedNotebookLocalUids.constBegin(), end = result.detachedNotebookLocalUids.constEnd(); it != end; ++it) {
+        detachNotebook(*it);
+    }
+}
+
 void NotebookSyncCache::connectToLocalStorage()
 {
     NCDEBUG(QStringLiteral("NotebookSyncCache::connectToLocalStorage"));
@@ -231,6 +257,11 @@ void NotebookSyncCache::connectToLocalStorage()
                      this, QNSLOT(NotebookSyncCache,onUpdateNotebookComplete,Notebook,QUuid));
     QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeNotebookComplete,Notebook,QUuid),
                      this, QNSLOT(NotebookSyncCache,onExpungeNotebookComplete,Notebook,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                           QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                           QString,StaleDataItemsExpungeResult,QUuid),
+                     this, QNSLOT(NotebookSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                  QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = true;
 }
@@ -285,6 +316,11 @@ void NotebookSyncCache::disconnectFromLocalStorage()
                         this, QNSLOT(NotebookSyncCache,onUpdateNotebookComplete,Notebook,QUuid));
     QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeNotebookComplete,Notebook,QUuid),
                         this, QNSLOT(NotebookSyncCache,onExpungeNotebookComplete,Notebook,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                              QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                              QString,StaleDataItemsExpungeResult,QUuid),
+                        this, QNSLOT(NotebookSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                     QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = false;
 }
@@ -340,6 +376,22 @@ void NotebookSyncCache::removeNotebook(const QString & notebookLocalUid)
     Q_UNUSED(m_notebookNameByGuid.erase(nameIt))
 }
 
+void NotebookSyncCache::detachNotebook(const QString & notebookLocalUid)
+{
+    NCDEBUG(QStringLiteral("NotebookSyncCache::detachNotebook: local uid = ") << notebookLocalUid);
+
+    // The detached notebook stays within the local storage under the same name but loses its guid
+    auto localUidIt = m_notebookNameByLocalUid.find(notebookLocalUid);
+    if (localUidIt == m_notebookNameByLocalUid.end()) {
+        NCDEBUG(QStringLiteral("The notebook name was not found in the cache by local uid"));
+        return;
+    }
+
+    QString name = localUidIt.value();
+    removeNotebook(notebookLocalUid);
+    m_notebookNameByLocalUid[notebookLocalUid] = name;
+}
+
 void NotebookSyncCache::processNotebook(const Notebook & notebook)
 {
     NCDEBUG(QStringLiteral("NotebookSyncCache::processNotebook: ") << notebook);
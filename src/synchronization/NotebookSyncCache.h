@@ -22,6 +22,7 @@
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <QObject>
 #include <QHash>
+#include <QSet>
 #include <QUuid>
 
 namespace quentier {
@@ -90,6 +91,10 @@ private Q_SLOTS:
     void onAddNotebookComplete(Notebook notebook, QUuid requestId);
     void onUpdateNotebookComplete(Notebook notebook, QUuid requestId);
     void onExpungeNotebookComplete(Notebook notebook, QUuid requestId);
+    void onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                         QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                         QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                         QUuid requestId);
 
 private:
     void connectToLocalStorage();
@@ -98,6 +103,7 @@ private:
     void requestNotebooksList();
 
     void removeNotebook(const QString & notebookLocalUid);
+    void detachNotebook(const QString & notebookLocalUid);
     void processNotebook(const Notebook & notebook);
 
 private:
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_PENDING_ITEMS_REGISTRY_H
+#define LIB_QUENTIER_SYNCHRONIZATION_PENDING_ITEMS_REGISTRY_H
+
+#include <quentier/utility/Macros.h>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+#include <QHash>
+#include <QMultiHash>
+#include <QList>
+#include <QString>
+#include <list>
+
+namespace quentier {
+
+/**
+ * @brief The PendingItemKeys template struct extracts the keys by which the data items pending processing
+ * during the sync are looked up: the guid and the name; the latter is compared case-insensitively
+ * and is empty for the kinds of items which are never looked up by name
+ */
+template <class T>
+struct Q_DECL_HIDDEN PendingItemKeys
+{
+    static QString guid(const T & item) { return (item.guid.isSet() ? item.guid.ref() : QString()); }
+    static QString name(const T & item) { return (item.name.isSet() ? item.name.ref().toUpper() : QString()); }
+};
+
+template <>
+struct Q_DECL_HIDDEN PendingItemKeys<qevercloud::Note>
+{
+    static QString guid(const qevercloud::Note & note) { return (note.guid.isSet() ? note.guid.ref() : QString()); }
+    static QString name(const qevercloud::Note & note) { return (note.title.isSet() ? note.title.ref().toUpper() : QString()); }
+};
+
+template <>
+struct Q_DECL_HIDDEN PendingItemKeys<qevercloud::Resource>
+{
+    static QString guid(const qevercloud::Resource & resource) { return (resource.guid.isSet() ? resource.guid.ref() : QString()); }
+    static QString name(const qevercloud::Resource & /* resource */) { return QString(); }
+};
+
+template <>
+struct Q_DECL_HIDDEN PendingItemKeys<qevercloud::LinkedNotebook>
+{
+    static QString guid(const qevercloud::LinkedNotebook & linkedNotebook)
+    { return (linkedNotebook.guid.isSet() ? linkedNotebook.guid.ref() : QString()); }
+    static QString name(const qevercloud::LinkedNotebook & /* linkedNotebook */) { return QString(); }
+};
+
+/**
+ * @brief The PendingItemsRegistry template class holds the data items downloaded from the remote service
+ * which are pending processing during the sync. Items are kept in the order of their addition; lookup by guid
+ * and by name as well as the removal of an arbitrary item take constant time.
+ *
+ * The registry keeps at most one item per guid: appending the item with the guid which is already
+ * within the registry replaces the previously appended item in place. The items without guid are kept
+ * but can't be looked up by guid.
+ *
+ * NOTE: the guids and names of items must not be changed through the iterators, use replace method for that.
+ */
+template <class T>
+class Q_DECL_HIDDEN PendingItemsRegistry
+{
+public:
+    typedef T value_type;
+    typedef std::list<T> container_type;
+    typedef typename container_type::iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+
+public:
+    PendingItemsRegistry() :
+        m_items(),
+        m_size(0),
+        m_itemsByGuid(),
+        m_itemsByName()
+    {}
+
+    PendingItemsRegistry(const PendingItemsRegistry & other) :
+        m_items(),
+        m_size(0),
+        m_itemsByGuid(),
+        m_itemsByName()
+    {
+        append(other);
+    }
+
+    PendingItemsRegistry & operator=(const PendingItemsRegistry & other)
+    {
+        if (this != &other) {
+            clear();
+            append(other);
+        }
+
+        return *this;
+    }
+
+    iterator begin() { return m_items.begin(); }
+    const_iterator begin() const { return m_items.begin(); }
+    const_iterator constBegin() const { return m_items.begin(); }
+
+    iterator end() { return m_items.end(); }
+    const_iterator end() const { return m_items.end(); }
+    const_iterator constEnd() const { return m_items.end(); }
+
+    bool isEmpty() const { return (m_size == 0); }
+    bool empty() const { return (m_size == 0); }
+    int size() const { return m_size; }
+
+    void reserve(const int size)
+    {
+        m_itemsByGuid.reserve(size);
+        m_itemsByName.reserve(size);
+    }
+
+    void clear()
+    {
+        m_items.clear();
+        m_size = 0;
+        m_itemsByGuid.clear();
+        m_itemsByName.clear();
+    }
+
+    /**
+     * @brief append - appends the item to the end of the registry or replaces the item with the same guid
+     * if it is already within the registry
+     * @return the iterator pointing to the appended or replaced item
+     */
+    iterator append(const T & item)
+    {
+        QString guid = PendingItemKeys<T>::guid(item);
+        if (!guid.isEmpty())
+        {
+            auto git = m_itemsByGuid.find(guid);
+            if (git != m_itemsByGuid.end()) {
+                iterator it = git.value();
+                replace(it, item);
+                return it;
+            }
+        }
+
+        iterator it = m_items.insert(m_items.end(), item);
+        ++m_size;
+        index(it);
+        return it;
+    }
+
+    void append(const QList<T> & items)
+    {
+        for(auto it = items.constBegin(), end = items.constEnd(); it != end; ++it) {
+            Q_UNUSED(append(*it))
+        }
+    }
+
+    void append(const PendingItemsRegistry & other)
+    {
+        for(auto it = other.constBegin(), end = other.constEnd(); it != end; ++it) {
+            Q_UNUSED(append(*it))
+        }
+    }
+
+    PendingItemsRegistry & operator<<(const T & item) { Q_UNUSED(append(item)) return *this; }
+    PendingItemsRegistry & operator<<(const QList<T> & items) { append(items); return *this; }
+    PendingItemsRegistry & operator<<(const PendingItemsRegistry & other) { append(other); return *this; }
+
+    /**
+     * @brief replace - replaces the item pointed to by the iterator keeping its position within the registry
+     */
+    void replace(iterator it, const T & item)
+    {
+        unindex(it);
+        *it = item;
+        index(it);
+    }
+
+    /**
+     * @brief erase - removes the item pointed to by the iterator from the registry
+     * @return the iterator pointing to the item following the removed one
+     */
+    iterator erase(iterator it)
+    {
+        unindex(it);
+        --m_size;
+        return m_items.erase(it);
+    }
+
+    /**
+     * @brief removeByGuid - removes the item with the specified guid from the registry
+     * @return true if the item was found and removed, false otherwise
+     */
+    bool removeByGuid(const QString & guid)
+    {
+        iterator it = findByGuid(guid);
+        if (it == m_items.end()) {
+            return false;
+        }
+
+        Q_UNUSED(erase(it))
+        return true;
+    }
+
+    iterator findByGuid(const QString & guid)
+    {
+        auto it = m_itemsByGuid.find(guid);
+        if (it == m_itemsByGuid.end()) {
+            return m_items.end();
+        }
+
+        return it.value();
+    }
+
+    const_iterator findByGuid(const QString & guid) const
+    {
+        auto it = m_itemsByGuid.find(guid);
+        if (it == m_itemsByGuid.end()) {
+            return m_items.end();
+        }
+
+        return it.value();
+    }
+
+    bool containsGuid(const QString & guid) const
+    {
+        return m_itemsByGuid.contains(guid);
+    }
+
+    /**
+     * @brief findByName - looks up the items with the specified name, case-insensitively
+     * @return the iterators pointing to all the items with the specified name, in no particular order;
+     * there can be several of them i.e. for items from different linked notebooks
+     */
+    QList<iterator> findByName(const QString & name)
+    {
+        return m_itemsByName.values(name.toUpper());
+    }
+
+private:
+    void index(iterator it)
+    {
+        QString guid = PendingItemKeys<T>::guid(*it);
+        if (!guid.isEmpty()) {
+            m_itemsByGuid[guid] = it;
+        }
+
+        QString name = PendingItemKeys<T>::name(*it);
+        if (!name.isEmpty()) {
+            Q_UNUSED(m_itemsByName.insert(name, it))
+        }
+    }
+
+    void unindex(iterator it)
+    {
+        QString guid = PendingItemKeys<T>::guid(*it);
+        if (!guid.isEmpty())
+        {
+            auto git = m_itemsByGuid.find(guid);
+            if ((git != m_itemsByGuid.end()) && (git.value() == it)) {
+                Q_UNUSED(m_itemsByGuid.erase(git))
+            }
+        }
+
+        QString name = PendingItemKeys<T>::name(*it);
+        if (!name.isEmpty()) {
+            Q_UNUSED(m_itemsByName.remove(name, it))
+        }
+    }
+
+private:
+    container_type                  m_items;
+    int                             m_size;
+    QHash<QString, iterator>        m_itemsByGuid;
+    QMultiHash<QString, iterator>   m_itemsByName;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_PENDING_ITEMS_REGISTRY_H
@@ -17,8 +17,6 @@
  */
 
 #include "RemoteToLocalSynchronizationManager.h"
-#include "InkNoteImageDownloader.h"
-#include "NoteThumbnailDownloader.h"
 #include <quentier/utility/Utility.h>
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <quentier/types/Resource.h>
@@ -55,9 +53,45 @@
 #define SHOULD_DOWNLOAD_NOTE_THUMBNAILS QStringLiteral("DownloadNoteThumbnails")
 #define SHOULD_DOWNLOAD_INK_NOTE_IMAGES QStringLiteral("DownloadInkNoteImages")
 #define INK_NOTE_IMAGES_STORAGE_PATH_KEY QStringLiteral("InkNoteImagesStoragePath")
+#define SYNC_CHUNKS_MEMORY_LIMIT_KEY QStringLiteral("SyncChunksMemoryLimit")
+#define MAX_IN_FLIGHT_DOWNLOADS_KEY QStringLiteral("MaxInFlightDownloads")
+#define MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS_KEY QStringLiteral("MaxParallelLinkedNotebookSyncs")
+#define DOWNLOAD_RESOURCE_DATA_ON_DEMAND_KEY QStringLiteral("DownloadResourceDataOnDemand")
+#define RESOURCE_DATA_PREFETCH_MAX_NOTE_AGE_KEY QStringLiteral("ResourceDataPrefetchMaxNoteAgeDays")
+#define RESOURCE_DATA_PREFETCH_MAX_SIZE_KEY QStringLiteral("ResourceDataPrefetchMaxSize")
+#define SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY QStringLiteral("SelectiveSyncNotebookGuids")
+#define SELECTIVE_SYNC_TAG_GUIDS_KEY QStringLiteral("SelectiveSyncTagGuids")
+#define APPLIED_SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY QStringLiteral("AppliedSelectiveSyncNotebookGuids")
+#define APPLIED_SELECTIVE_SYNC_TAG_GUIDS_KEY QStringLiteral("AppliedSelectiveSyncTagGuids")
+
+// The default estimated amount of memory the downloaded sync chunks can occupy before their notes
+// and resources start to be spooled to disk
+#define DEFAULT_SYNC_CHUNKS_MEMORY_LIMIT_BYTES (Q_INT64_C(268435456))
+
+// The default max number of full note and resource data downloads in flight at the same time
+#define DEFAULT_MAX_IN_FLIGHT_DOWNLOADS (10)
+
+// The default max number of linked notebooks which sync chunks are downloaded at the same time
+#define DEFAULT_MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS (4)
+
+// How often the notes and resources put into the local storage during the sync are persisted to the sync checkpoint
+#define SYNC_CHECKPOINT_INTERVAL_MSEC (30000)
 
 #define THIRTY_DAYS_IN_MSEC (2592000000)
 
+#define ONE_DAY_IN_MSEC (Q_INT64_C(86400000))
+
+// The notes modified within this period are downloaded before the rest of notes
+#define RECENTLY_MODIFIED_NOTE_MAX_AGE_MSEC (7 * ONE_DAY_IN_MSEC)
+
+// The max number of pending local storage requests for saved searches and notebooks from already downloaded
+// sync chunks at which the download of the next sync chunk is still started right away
+#define SYNC_CHUNKS_DOWNLOAD_MAX_PENDING_LOCAL_STORAGE_REQUESTS (100)
+#define SYNC_CHUNKS_DOWNLOAD_RESUME_PENDING_LOCAL_STORAGE_REQUESTS (50)
+
+// The max number of sync chunks which notes or resources are being processed at the same time
+#define MAX_SYNC_CHUNKS_WITH_DATA_ELEMENTS_PENDING_PROCESSING (2)
+
 #define APPEND_NOTE_DETAILS(errorDescription, note) \
    if (note.hasTitle()) \
    { \
@@ -104,11 +138,13 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_manager(manager),
     m_connectedToLocalStorage(false),
     m_host(host),
-    m_maxSyncChunksPerOneDownload(50),
+    m_syncChunkWindow(),
+    m_linkedNotebookSyncChunkWindow(),
     m_lastSyncMode(SyncMode::FullSync),
     m_lastUpdateCount(0),
     m_lastSyncTime(0),
     m_onceSyncDone(false),
+    m_fullSyncResumedFromSyncCheckpoint(false),
     m_lastUsnOnStart(-1),
     m_lastSyncChunksDownloadedUsn(-1),
     m_syncChunksDownloaded(false),
@@ -119,10 +155,24 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_edamProtocolVersionChecked(false),
     m_syncChunks(),
     m_linkedNotebookSyncChunks(),
+    m_linkedNotebookGuidsOfLinkedNotebookSyncChunks(),
     m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded(),
+    m_notesSyncContentSource(ContentSource::UserAccount),
+    m_nextSyncChunkIndexToTakeNotesFrom(-1),
+    m_nextSyncChunkIndexToTakeResourcesFrom(-1),
+    m_syncChunkIndicesByPendingNoteGuids(),
+    m_numPendingNotesBySyncChunkIndices(),
+    m_syncChunkIndicesByPendingResourceGuids(),
+    m_numPendingResourcesBySyncChunkIndices(),
+    m_lastSyncChunkIndicesByNoteGuids(),
+    m_lastSyncChunkIndicesByResourceGuids(),
+    m_lastSyncChunkIndicesByExpungedNoteGuids(),
+    m_lastSyncChunkIndicesByExpungedNotebookGuids(),
     m_accountLimits(),
     m_tags(),
     m_tagsPendingProcessing(),
+    m_tagsPendingProcessingLevelSizes(),
+    m_guidsOfTagsFromCurrentLevelPendingProcessing(),
     m_tagsPendingAddOrUpdate(),
     m_expungedTags(),
     m_findTagByNameRequestIds(),
@@ -132,8 +182,6 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_updateTagRequestIds(),
     m_expungeTagRequestIds(),
     m_pendingTagsSyncStart(false),
-    m_tagSyncCache(m_manager.localStorageManagerAsync(), QStringLiteral("")),
-    m_tagSyncCachesByLinkedNotebookGuids(),
     m_linkedNotebookGuidsPendingTagSyncCachesFill(),
     m_linkedNotebookGuidsByTagGuids(),
     m_expungeNotelessTagsRequestId(),
@@ -145,7 +193,6 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_addSavedSearchRequestIds(),
     m_updateSavedSearchRequestIds(),
     m_expungeSavedSearchRequestIds(),
-    m_savedSearchSyncCache(m_manager.localStorageManagerAsync()),
     m_linkedNotebooks(),
     m_linkedNotebooksPendingAddOrUpdate(),
     m_expungedLinkedNotebooks(),
@@ -169,6 +216,12 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_authenticationTokenExpirationTimesByLinkedNotebookGuid(),
     m_pendingAuthenticationTokensForLinkedNotebooks(false),
     m_syncStatesByLinkedNotebookGuid(),
+    m_linkedNotebooksSyncChunksDownloadStarted(false),
+    m_linkedNotebookGuidsPendingSyncChunksDownload(),
+    m_linkedNotebookSyncChunksDownloadsByGuid(),
+    m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight(),
+    m_linkedNotebookGuidsFailedToSync(),
+    m_maxParallelLinkedNotebookSyncs(DEFAULT_MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS),
     m_lastUpdateCountByLinkedNotebookGuid(),
     m_lastSyncTimeByLinkedNotebookGuid(),
     m_linkedNotebookGuidsForWhichFullSyncWasPerformed(),
@@ -183,8 +236,7 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_updateNotebookRequestIds(),
     m_expungeNotebookRequestIds(),
     m_pendingNotebooksSyncStart(false),
-    m_notebookSyncCache(m_manager.localStorageManagerAsync(), QStringLiteral("")),
-    m_notebookSyncCachesByLinkedNotebookGuids(),
+    m_syncCachesManager(m_manager.localStorageManagerAsync()),
     m_linkedNotebookGuidsByNotebookGuids(),
     m_notes(),
     m_notesPendingAddOrUpdate(),
@@ -217,17 +269,41 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_localUidsOfElementsAlreadyAttemptedToFindByName(),
     m_guidsOfNotesPendingDownloadForAddingToLocalStorage(),
     m_notesPendingDownloadForUpdatingInLocalStorageByGuid(),
+    m_partialNoteDataDownloadsByGuid(),
+    m_notesPendingLocalResourceDataByFindNoteRequestId(),
     m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid(),
     m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid(),
     m_fullSyncStaleDataItemsSyncedGuids(),
+    m_fullSyncStaleDataItemsSyncedGuidsByLinkedNotebookGuid(),
     m_pFullSyncStaleDataItemsExpunger(Q_NULLPTR),
     m_fullSyncStaleDataItemsExpungersByLinkedNotebookGuid(),
-    m_notesToAddPerAPICallPostponeTimerId(),
-    m_notesToUpdatePerAPICallPostponeTimerId(),
-    m_resourcesToAddWithNotesPerAPICallPostponeTimerId(),
-    m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId(),
+    m_downloadScheduler(),
+    m_downloadSchedulerBackoffTimerId(0),
+    m_requestedNoteGuids(),
+    m_visibleNoteGuids(),
+    m_lastUsedNotebookGuid(),
+    m_findLastUsedNotebookRequestId(),
+    m_noteImagesDownloadManager(),
+    m_downloadResourceDataOnDemand(false),
+    m_resourceDataPrefetchMaxNoteAgeDays(0),
+    m_resourceDataPrefetchMaxSize(0),
+    m_selectiveSyncFilter(),
+    m_appliedSelectiveSyncFilter(),
+    m_selectiveSyncBackfillPending(false),
+    m_selectiveSyncBackfillUpToUsn(-1),
+    m_selectiveSyncBackfillInProgress(false),
+    m_notebookGuidsBySelectiveSyncSkippedNoteGuids(),
+    m_syncCheckpoint(),
+    m_syncCheckpointTimerId(0),
     m_postponedConflictingResourceDataPerAPICallPostponeTimerId(),
     m_afterUsnForSyncChunkPerAPICallPostponeTimerId(),
+    m_lastPreviousUsnOnSyncChunksDownload(0),
+    m_pendingSyncChunkAfterUsn(-1),
+    m_pendingSyncChunkMaxEntries(0),
+    m_pendingSyncChunkRequestTimestamp(0),
+    m_afterUsnForSyncChunkPendingAuthentication(-1),
+    m_numSyncChunksWithMergedSavedSearchesAndNotebooks(0),
+    m_syncChunksDownloadPostponedByLocalStorage(false),
     m_getLinkedNotebookSyncStateBeforeStartAPICallPostponeTimerId(),
     m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId(),
     m_getSyncStateBeforeStartAPICallPostponeTimerId(0),
@@ -235,10 +311,16 @@ RemoteToLocalSynchronizationManager::RemoteToLocalSynchronizationManager(IManage
     m_syncAccountLimitsPostponeTimerId(0),
     m_gotLastSyncParameters(false)
 {
-    QObject::connect(&(m_manager.noteStore()), QNSIGNAL(NoteStore,getNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
+    QObject::connect(&(m_manager.noteStore()), QNSIGNAL(INoteStore,getNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onGetNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString));
-    QObject::connect(&(m_manager.noteStore()), QNSIGNAL(NoteStore,getResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString),
+    QObject::connect(&(m_manager.noteStore()), QNSIGNAL(INoteStore,getResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onGetResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString));
+    QObject::connect(&(m_manager.noteStore()), QNSIGNAL(INoteStore,getSyncChunkAsyncFinished,qint32,qevercloud::SyncChunk,qint32,qint32,ErrorString),
+                     this, QNSLOT(RemoteToLocalSynchronizationManager,onGetSyncChunkAsyncFinished,qint32,qevercloud::SyncChunk,qint32,qint32,ErrorString));
+    QObject::connect(&m_noteImagesDownloadManager, QNSIGNAL(NoteImagesDownloadManager,noteThumbnailDownloaded,bool,QString,QByteArray,ErrorString),
+                     this, QNSLOT(RemoteToLocalSynchronizationManager,onNoteThumbnailDownloadingFinished,bool,QString,QByteArray,ErrorString));
+    QObject::connect(&m_noteImagesDownloadManager, QNSIGNAL(NoteImagesDownloadManager,inkNoteImageDownloaded,bool,QString,QString,ErrorString),
+                     this, QNSLOT(RemoteToLocalSynchronizationManager,onInkNoteImageDownloadFinished,bool,QString,QString,ErrorString));
 }
 
 bool RemoteToLocalSynchronizationManager::active() const
@@ -404,6 +486,140 @@ QString RemoteToLocalSynchronizationManager::inkNoteImagesStoragePath() const
     return path;
 }
 
+qint64 RemoteToLocalSynchronizationManager::syncChunksMemoryLimit() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+
+    qint64 memoryLimitBytes = DEFAULT_SYNC_CHUNKS_MEMORY_LIMIT_BYTES;
+    if (appSettings.contains(SYNC_CHUNKS_MEMORY_LIMIT_KEY))
+    {
+        bool conversionResult = false;
+        qint64 value = appSettings.value(SYNC_CHUNKS_MEMORY_LIMIT_KEY).toLongLong(&conversionResult);
+        if (conversionResult) {
+            memoryLimitBytes = value;
+        }
+        else {
+            QNWARNING(QStringLiteral("Can't convert the sync chunks memory limit from settings to qint64: ")
+                      << appSettings.value(SYNC_CHUNKS_MEMORY_LIMIT_KEY));
+        }
+    }
+
+    appSettings.endGroup();
+    return memoryLimitBytes;
+}
+
+int RemoteToLocalSynchronizationManager::maxInFlightDownloads() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+
+    int maxInFlightDownloads = DEFAULT_MAX_IN_FLIGHT_DOWNLOADS;
+    if (appSettings.contains(MAX_IN_FLIGHT_DOWNLOADS_KEY))
+    {
+        bool conversionResult = false;
+        int value = appSettings.value(MAX_IN_FLIGHT_DOWNLOADS_KEY).toInt(&conversionResult);
+        if (conversionResult && (value > 0)) {
+            maxInFlightDownloads = value;
+        }
+        else {
+            QNWARNING(QStringLiteral("Can't convert the max number of downloads in flight from settings to positive int: ")
+                      << appSettings.value(MAX_IN_FLIGHT_DOWNLOADS_KEY));
+        }
+    }
+
+    appSettings.endGroup();
+    return maxInFlightDownloads;
+}
+
+int RemoteToLocalSynchronizationManager::maxParallelLinkedNotebookSyncs() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+
+    int maxParallelLinkedNotebookSyncs = DEFAULT_MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS;
+    if (appSettings.contains(MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS_KEY))
+    {
+        bool conversionResult = false;
+        int value = appSettings.value(MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS_KEY).toInt(&conversionResult);
+        if (conversionResult && (value > 0)) {
+            maxParallelLinkedNotebookSyncs = value;
+        }
+        else {
+            QNWARNING(QStringLiteral("Can't convert the max number of linked notebooks synchronized in parallel from settings "
+                                     "to positive int: ") << appSettings.value(MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS_KEY));
+        }
+    }
+
+    appSettings.endGroup();
+    return maxParallelLinkedNotebookSyncs;
+}
+
+bool RemoteToLocalSynchronizationManager::downloadResourceDataOnDemand() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    bool flag = appSettings.value(DOWNLOAD_RESOURCE_DATA_ON_DEMAND_KEY, false).toBool();
+    appSettings.endGroup();
+    return flag;
+}
+
+qint32 RemoteToLocalSynchronizationManager::resourceDataPrefetchMaxNoteAgeDays() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+
+    qint32 maxNoteAgeDays = 0;
+    if (appSettings.contains(RESOURCE_DATA_PREFETCH_MAX_NOTE_AGE_KEY))
+    {
+        bool conversionResult = false;
+        qint32 value = appSettings.value(RESOURCE_DATA_PREFETCH_MAX_NOTE_AGE_KEY).toInt(&conversionResult);
+        if (conversionResult) {
+            maxNoteAgeDays = value;
+        }
+        else {
+            QNWARNING(QStringLiteral("Can't convert the max age of notes for resource data prefetch from settings to int: ")
+                      << appSettings.value(RESOURCE_DATA_PREFETCH_MAX_NOTE_AGE_KEY));
+        }
+    }
+
+    appSettings.endGroup();
+    return maxNoteAgeDays;
+}
+
+qint64 RemoteToLocalSynchronizationManager::resourceDataPrefetchMaxSize() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+
+    qint64 maxSizeBytes = 0;
+    if (appSettings.contains(RESOURCE_DATA_PREFETCH_MAX_SIZE_KEY))
+    {
+        bool conversionResult = false;
+        qint64 value = appSettings.value(RESOURCE_DATA_PREFETCH_MAX_SIZE_KEY).toLongLong(&conversionResult);
+        if (conversionResult) {
+            maxSizeBytes = value;
+        }
+        else {
+            QNWARNING(QStringLiteral("Can't convert the max size of resource data prefetched per note from settings to qint64: ")
+                      << appSettings.value(RESOURCE_DATA_PREFETCH_MAX_SIZE_KEY));
+        }
+    }
+
+    appSettings.endGroup();
+    return maxSizeBytes;
+}
+
+SelectiveSyncFilter RemoteToLocalSynchronizationManager::selectiveSyncFilter() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    QStringList notebookGuids = appSettings.value(SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY).toStringList();
+    QStringList tagGuids = appSettings.value(SELECTIVE_SYNC_TAG_GUIDS_KEY).toStringList();
+    appSettings.endGroup();
+    return SelectiveSyncFilter(notebookGuids, tagGuids);
+}
+
 void RemoteToLocalSynchronizationManager::start(qint32 afterUsn)
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::start: afterUsn = ") << afterUsn);
@@ -417,10 +633,44 @@ void RemoteToLocalSynchronizationManager::start(qint32 afterUsn)
 
     clear();
 
+    qint64 memoryLimitBytes = syncChunksMemoryLimit();
+    m_syncChunks.setMemoryLimit(memoryLimitBytes);
+    m_linkedNotebookSyncChunks.setMemoryLimit(memoryLimitBytes);
+
+    m_downloadScheduler.setMaxWindow(maxInFlightDownloads());
+    m_noteImagesDownloadManager.setCacheFolderPath(noteImagesCachePath());
+    m_maxParallelLinkedNotebookSyncs = maxParallelLinkedNotebookSyncs();
+
+    m_downloadResourceDataOnDemand = downloadResourceDataOnDemand();
+    m_resourceDataPrefetchMaxNoteAgeDays = resourceDataPrefetchMaxNoteAgeDays();
+    m_resourceDataPrefetchMaxSize = resourceDataPrefetchMaxSize();
+
+    m_selectiveSyncFilter = selectiveSyncFilter();
+    m_appliedSelectiveSyncFilter = appliedSelectiveSyncFilter();
+    m_selectiveSyncBackfillPending = m_selectiveSyncFilter.selectsMoreThan(m_appliedSelectiveSyncFilter);
+    if (m_selectiveSyncBackfillPending) {
+        QNINFO(QStringLiteral("The selective sync filter was widened since the last sync, the notes skipped before "
+                              "would be downloaded: ") << m_selectiveSyncFilter << QStringLiteral(", previously applied: ")
+               << m_appliedSelectiveSyncFilter);
+    }
+
+    readSyncCheckpoint();
+    startSyncCheckpointTimer();
+
     connectToLocalStorage();
     m_lastUsnOnStart = afterUsn;
     m_active = true;
 
+    // The notes from the last used notebook are downloaded before the rest of notes
+    m_lastUsedNotebookGuid.clear();
+    m_findLastUsedNotebookRequestId = QUuid::createUuid();
+    QNTRACE(QStringLiteral("Emitting the request to find the last used notebook: request id = ") << m_findLastUsedNotebookRequestId);
+    Q_EMIT findLastUsedNotebook(Notebook(), m_findLastUsedNotebookRequestId);
+
+    // The notes downloaded from user's own account are classified as new, up to date, modified or conflicting ones
+    // using the note sync cache which is filled while the sync chunks are being downloaded
+    m_syncCachesManager.noteSyncCache().fill();
+
     ErrorString errorDescription;
 
     // Checking the protocol version first
@@ -456,6 +706,18 @@ void RemoteToLocalSynchronizationManager::start(qint32 afterUsn)
                       ? SyncMode::FullSync
                       : SyncMode::IncrementalSync);
 
+    if (m_syncCheckpoint.fullSyncInProgress())
+    {
+        // The full sync of user's own account was interrupted, it needs to be finished before any incremental sync
+        // or the stale data items left within the local storage would never be expunged
+        QNINFO(QStringLiteral("Resuming the interrupted full sync after USN ") << m_syncCheckpoint.fullSyncAfterUsn());
+        m_lastSyncMode = SyncMode::FullSync;
+        m_fullSyncResumedFromSyncCheckpoint = true;
+        m_fullSyncStaleDataItemsSyncedGuids = m_syncCheckpoint.fullSyncSyncedGuids();
+        downloadSyncChunksAndLaunchSync(m_syncCheckpoint.fullSyncAfterUsn());
+        return;
+    }
+
     if (m_onceSyncDone || (afterUsn != 0))
     {
         bool asyncWait = false;
@@ -467,6 +729,19 @@ void RemoteToLocalSynchronizationManager::start(qint32 afterUsn)
             return;
         }
 
+        if (m_selectiveSyncBackfillPending && (m_lastSyncMode == SyncMode::IncrementalSync)) {
+            m_selectiveSyncBackfillUpToUsn = afterUsn;
+        }
+
+        if (!res && (m_selectiveSyncBackfillUpToUsn > 0))
+        {
+            QNDEBUG(QStringLiteral("The service has no updates for user's own account but the notes skipped by the previous syncs "
+                                   "due to the selective sync filter need to be downloaded"));
+            m_selectiveSyncBackfillInProgress = true;
+            downloadSyncChunksAndLaunchSync(0);
+            return;
+        }
+
         if (!res)
         {
             QNTRACE(QStringLiteral("The service has no updates for user's own account, need to check for updates from linked notebooks"));
@@ -493,6 +768,12 @@ void RemoteToLocalSynchronizationManager::start(qint32 afterUsn)
         // (Because the sync of user's account can bring in the new linked notebooks or remove any of them)
     }
 
+    if (m_lastSyncMode == SyncMode::FullSync) {
+        // Persisting the marker of the full sync in progress right away so that the full sync interrupted
+        // at any moment is resumed rather than replaced with the incremental sync
+        writeSyncCheckpoint();
+    }
+
     downloadSyncChunksAndLaunchSync(afterUsn);
 }
 
@@ -505,6 +786,8 @@ void RemoteToLocalSynchronizationManager::stop()
         return;
     }
 
+    writeSyncCheckpoint();
+
     clear();
     resetCurrentSyncState();
 
@@ -520,6 +803,7 @@ void RemoteToLocalSynchronizationManager::emitAddRequest<Tag>(const Tag & tag)
 
     QUuid addTagRequestId = QUuid::createUuid();
     Q_UNUSED(m_addTagRequestIds.insert(addTagRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addTagRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to add tag to local storage: request id = ")
             << addTagRequestId << QStringLiteral(", tag: ") << tag);
     Q_EMIT addTag(tag, addTagRequestId);
@@ -534,6 +818,7 @@ void RemoteToLocalSynchronizationManager::emitAddRequest<SavedSearch>(const Save
 
     QUuid addSavedSearchRequestId = QUuid::createUuid();
     Q_UNUSED(m_addSavedSearchRequestIds.insert(addSavedSearchRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addSavedSearchRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to add saved search to local storage: request id = ")
             << addSavedSearchRequestId << QStringLiteral(", saved search: ") << search);
     Q_EMIT addSavedSearch(search, addSavedSearchRequestId);
@@ -548,6 +833,7 @@ void RemoteToLocalSynchronizationManager::emitAddRequest<LinkedNotebook>(const L
 
     QUuid addLinkedNotebookRequestId = QUuid::createUuid();
     Q_UNUSED(m_addLinkedNotebookRequestIds.insert(addLinkedNotebookRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addLinkedNotebookRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to add linked notebook to local storage: request id = ")
             << addLinkedNotebookRequestId << QStringLiteral(", linked notebook: ") << linkedNotebook);
     Q_EMIT addLinkedNotebook(linkedNotebook, addLinkedNotebookRequestId);
@@ -562,6 +848,7 @@ void RemoteToLocalSynchronizationManager::emitAddRequest<Notebook>(const Noteboo
 
     QUuid addNotebookRequestId = QUuid::createUuid();
     Q_UNUSED(m_addNotebookRequestIds.insert(addNotebookRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addNotebookRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to add notebook to local storage: request id = ")
             << addNotebookRequestId << QStringLiteral(", notebook: ") << notebook);
     Q_EMIT addNotebook(notebook, addNotebookRequestId);
@@ -576,6 +863,7 @@ void RemoteToLocalSynchronizationManager::emitAddRequest<Note>(const Note & note
 
     QUuid addNoteRequestId = QUuid::createUuid();
     Q_UNUSED(m_addNoteRequestIds.insert(addNoteRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addNoteRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to add note to local storage: request id = ")
             << addNoteRequestId << QStringLiteral(", note: ") << note);
     Q_EMIT addNote(note, addNoteRequestId);
@@ -677,8 +965,9 @@ void RemoteToLocalSynchronizationManager::onFindNotebookCompleted(Notebook noteb
             Q_UNUSED(m_resourceGuidsPendingFindNotebookForInkNoteImageDownloadPerNoteGuid.erase(git))
         }
 
-        setupInkNoteImageDownloading(resourceData.m_resourceGuid, resourceData.m_resourceHeight,
-                                     resourceData.m_resourceWidth, resourceData.m_noteGuid, notebook);
+        setupInkNoteImageDownloading(resourceData.m_resourceGuid, resourceData.m_resourceDataHash,
+                                     resourceData.m_resourceHeight, resourceData.m_resourceWidth,
+                                     resourceData.m_noteGuid, notebook);
         return;
     }
 
@@ -835,6 +1124,41 @@ void RemoteToLocalSynchronizationManager::onFindNotebookFailed(Notebook notebook
     }
 }
 
+void RemoteToLocalSynchronizationManager::onFindLastUsedNotebookCompleted(Notebook notebook, QUuid requestId)
+{
+    if (requestId != m_findLastUsedNotebookRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onFindLastUsedNotebookCompleted: request id = ")
+            << requestId << QStringLiteral(", notebook: ") << notebook);
+
+    m_findLastUsedNotebookRequestId = QUuid();
+
+    if (!notebook.hasGuid()) {
+        QNDEBUG(QStringLiteral("The last used notebook was never synchronized, nothing to download from it first"));
+        return;
+    }
+
+    m_lastUsedNotebookGuid = notebook.guid();
+    updateScheduledDownloadsUrgency();
+}
+
+void RemoteToLocalSynchronizationManager::onFindLastUsedNotebookFailed(Notebook notebook, ErrorString errorDescription,
+                                                                       QUuid requestId)
+{
+    if (requestId != m_findLastUsedNotebookRequestId) {
+        return;
+    }
+
+    // NOTE: not an error, there might be no last used notebook, for example, on the first sync
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onFindLastUsedNotebookFailed: request id = ")
+            << requestId << QStringLiteral(", error description: ") << errorDescription
+            << QStringLiteral(", notebook: ") << notebook);
+
+    m_findLastUsedNotebookRequestId = QUuid();
+}
+
 void RemoteToLocalSynchronizationManager::onFindNoteCompleted(Note note, bool withResourceBinaryData, QUuid requestId)
 {
     Q_UNUSED(withResourceBinaryData);
@@ -874,6 +1198,26 @@ void RemoteToLocalSynchronizationManager::onFindNoteCompleted(Note note, bool wi
         return;
     }
 
+    auto nit = m_notesPendingLocalResourceDataByFindNoteRequestId.find(requestId);
+    if (nit != m_notesPendingLocalResourceDataByFindNoteRequestId.end())
+    {
+        QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onFindNoteCompleted: found the local note with resources' "
+                               "binary data for the partially downloaded note: request id = ") << requestId);
+
+        Note updatedNote = nit.value();
+        Q_UNUSED(m_notesPendingLocalResourceDataByFindNoteRequestId.erase(nit))
+
+        copyLocalResourcesBinaryData(updatedNote, note);
+
+        QUuid updateNoteRequestId = QUuid::createUuid();
+        Q_UNUSED(m_updateNoteRequestIds.insert(updateNoteRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateNoteRequestId.toString());
+        QNTRACE(QStringLiteral("Emitting the request to update note in local storage: request id = ")
+                << updateNoteRequestId << QStringLiteral(", note; ") << updatedNote);
+        Q_EMIT updateNote(updatedNote, /* update resources = */ true, /* update tags = */ true, updateNoteRequestId);
+        return;
+    }
+
     auto rit = m_resourcesByFindNoteRequestIds.find(requestId);
     if (rit != m_resourcesByFindNoteRequestIds.end())
     {
@@ -918,12 +1262,14 @@ void RemoteToLocalSynchronizationManager::onFindNoteCompleted(Note note, bool wi
 
             if (pNotebook)
             {
-                setupInkNoteImageDownloading(resource.guid(), resource.height(), resource.width(), note.guid(), *pNotebook);
+                setupInkNoteImageDownloading(resource.guid(), (resource.hasDataHash() ? resource.dataHash() : QByteArray()),
+                                             resource.height(), resource.width(), note.guid(), *pNotebook);
             }
             else if (note.hasNotebookLocalUid() || note.hasNotebookGuid())
             {
                 InkNoteResourceData resourceData;
                 resourceData.m_resourceGuid = resource.guid();
+                resourceData.m_resourceDataHash = (resource.hasDataHash() ? resource.dataHash() : QByteArray());
                 resourceData.m_noteGuid = note.guid();
                 resourceData.m_resourceHeight = resource.height();
                 resourceData.m_resourceWidth = resource.width();
@@ -1004,6 +1350,17 @@ void RemoteToLocalSynchronizationManager::onFindNoteFailed(Note note, bool withR
             return;
         }
 
+        if (shouldSkipNewNoteDueToSelectiveSyncFilter(*it))
+        {
+            qevercloud::Note skippedNote = *it;
+            Q_UNUSED(m_notes.erase(it));
+
+            skipNewNoteDueToSelectiveSyncFilter(skippedNote);
+            checkNotesSyncCompletionAndLaunchResourcesSync();
+            checkServerDataMergeCompletion();
+            return;
+        }
+
         // Removing the note from the list of notes waiting for processing
         // but also remembering it for further reference
         Q_UNUSED(m_notes.erase(it));
@@ -1016,14 +1373,39 @@ void RemoteToLocalSynchronizationManager::onFindNoteFailed(Note note, bool withR
         return;
     }
 
+    auto nit = m_notesPendingLocalResourceDataByFindNoteRequestId.find(requestId);
+    if (nit != m_notesPendingLocalResourceDataByFindNoteRequestId.end())
+    {
+        QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onFindNoteFailed: note = ") << note
+                << QStringLiteral(", requestId = ") << requestId);
+
+        Q_UNUSED(m_notesPendingLocalResourceDataByFindNoteRequestId.erase(nit))
+
+        ErrorString errorDescription(QT_TR_NOOP("Can't find the note in the local storage in order to preserve "
+                                                "the binary data of its unchanged resources"));
+        APPEND_NOTE_DETAILS(errorDescription, note)
+        QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
+        Q_EMIT failure(errorDescription);
+        return;
+    }
+
     auto rit = m_resourcesByFindNoteRequestIds.find(requestId);
     if (rit != m_resourcesByFindNoteRequestIds.end())
     {
         QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onFindNoteFailed: note = ") << note
                 << QStringLiteral(", requestId = ") << requestId);
 
+        Resource resource = rit.value();
         Q_UNUSED(m_resourcesByFindNoteRequestIds.erase(rit));
 
+        if (!m_selectiveSyncFilter.isEmpty()) {
+            QNDEBUG(QStringLiteral("The note owning the resource is not synchronized due to the selective sync filter, "
+                                   "skipping the resource: ") << resource);
+            checkAndIncrementResourceDownloadProgress(resource.guid());
+            checkServerDataMergeCompletion();
+            return;
+        }
+
         ErrorString errorDescription(QT_TR_NOOP("Can't find note containing the synchronized resource in the local storage"));
         APPEND_NOTE_DETAILS(errorDescription, note)
 
@@ -1230,6 +1612,7 @@ void RemoteToLocalSynchronizationManager::onAddDataElementCompleted(const Elemen
                 << requestId);
 
         Q_UNUSED(addElementRequestIds.erase(it));
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
         performPostAddOrUpdateChecks<ElementType>(element);
         checkServerDataMergeCompletion();
     }
@@ -1289,6 +1672,7 @@ void RemoteToLocalSynchronizationManager::onAddDataElementFailed(const ElementTy
                   << errorDescription << QStringLiteral(", requestId = ") << requestId);
 
         Q_UNUSED(addElementRequestIds.erase(it));
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
 
         ErrorString error(QT_TR_NOOP("Failed to add the data item fetched from the remote database to the local storage"));
         error.additionalBases().append(errorDescription.base());
@@ -1362,6 +1746,7 @@ void RemoteToLocalSynchronizationManager::onUpdateDataElementCompleted(const Ele
             << QStringLiteral(">: ") << typeName << QStringLiteral(" = ") << element << QStringLiteral(", requestId = ") << requestId);
 
     Q_UNUSED(updateElementRequestIds.erase(rit));
+    endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
     performPostAddOrUpdateChecks<ElementType>(element);
     checkServerDataMergeCompletion();
 }
@@ -1391,6 +1776,7 @@ void RemoteToLocalSynchronizationManager::onUpdateDataElementFailed(const Elemen
               << errorDescription << QStringLiteral(", requestId = ") << requestId);
 
     Q_UNUSED(updateElementRequestIds.erase(it));
+    endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
 
     ErrorString error(QT_TR_NOOP("Can't update the item in the local storage"));
     error.additionalBases().append(errorDescription.base());
@@ -1464,7 +1850,7 @@ void RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Tag>(cons
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Tag>: ") << tag);
 
     unregisterTagPendingAddOrUpdate(tag);
-    syncNextTagPendingProcessing();
+    onTagFromCurrentLevelProcessed(tag.hasGuid() ? tag.guid() : QString());
     checkNotebooksAndTagsSyncCompletionAndLaunchNotesSync();
     checkServerDataMergeCompletion();
 }
@@ -1480,6 +1866,23 @@ void RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Notebook>
 template <>
 void RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Note>(const Note & note)
 {
+    if (note.hasGuid() && note.hasUpdateSequenceNumber())
+    {
+        m_syncCheckpoint.setNoteProcessed(note.guid(), note.updateSequenceNumber());
+
+        // The resources were put into the local storage along with the note
+        if (note.hasResources())
+        {
+            QList<Resource> resources = note.resources();
+            for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+            {
+                if (it->hasGuid() && it->hasUpdateSequenceNumber()) {
+                    m_syncCheckpoint.setResourceProcessed(it->guid(), it->updateSequenceNumber());
+                }
+            }
+        }
+    }
+
     unregisterNotePendingAddOrUpdate(note);
     checkNotesSyncCompletionAndLaunchResourcesSync();
     checkServerDataMergeCompletion();
@@ -1488,6 +1891,10 @@ void RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Note>(con
 template <>
 void RemoteToLocalSynchronizationManager::performPostAddOrUpdateChecks<Resource>(const Resource & resource)
 {
+    if (resource.hasGuid() && resource.hasUpdateSequenceNumber()) {
+        m_syncCheckpoint.setResourceProcessed(resource.guid(), resource.updateSequenceNumber());
+    }
+
     unregisterResourcePendingAddOrUpdate(resource);
     checkServerDataMergeCompletion();
 }
@@ -1535,6 +1942,7 @@ void RemoteToLocalSynchronizationManager::onExpungeDataElementCompleted(const El
 
     QNTRACE(QStringLiteral("Expunged ") << typeName << QStringLiteral(" from local storage: ") << element);
     Q_UNUSED(expungeElementRequestIds.erase(it))
+    endSyncTraceSpan(SyncTracer::Phase::Expunge, requestId.toString(), 1);
 
     performPostExpungeChecks<ElementType>();
     checkExpungesCompletion();
@@ -1558,6 +1966,7 @@ void RemoteToLocalSynchronizationManager::onExpungeDataElementFailed(const Eleme
                               "has never existed in the local storage in the first place. Error description: ")
             << errorDescription);
     Q_UNUSED(expungeElementRequestIds.erase(it))
+    endSyncTraceSpan(SyncTracer::Phase::Expunge, requestId.toString());
 
     performPostExpungeChecks<ElementType>();
     checkExpungesCompletion();
@@ -1583,6 +1992,7 @@ void RemoteToLocalSynchronizationManager::expungeTags()
 
         QUuid expungeTagRequestId = QUuid::createUuid();
         Q_UNUSED(m_expungeTagRequestIds.insert(expungeTagRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, expungeTagRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to expunge tag: guid = ")
                 << expungedTagGuid << QStringLiteral(", request id = ") << expungeTagRequestId);
         Q_EMIT expungeTag(tagToExpunge, expungeTagRequestId);
@@ -1611,6 +2021,7 @@ void RemoteToLocalSynchronizationManager::expungeSavedSearches()
 
         QUuid expungeSavedSearchRequestId = QUuid::createUuid();
         Q_UNUSED(m_expungeSavedSearchRequestIds.insert(expungeSavedSearchRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, expungeSavedSearchRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to expunge saved search: guid = ")
                 << expungedSavedSerchGuid << QStringLiteral(", request id = ")
                 << expungeSavedSearchRequestId);
@@ -1639,6 +2050,7 @@ void RemoteToLocalSynchronizationManager::expungeLinkedNotebooks()
 
         QUuid expungeLinkedNotebookRequestId = QUuid::createUuid();
         Q_UNUSED(m_expungeLinkedNotebookRequestIds.insert(expungeLinkedNotebookRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, expungeLinkedNotebookRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to expunge linked notebook: guid = ")
                 << expungedLinkedNotebookGuid << QStringLiteral(", request id = ")
                 << expungeLinkedNotebookRequestId);
@@ -1668,6 +2080,7 @@ void RemoteToLocalSynchronizationManager::expungeNotebooks()
 
         QUuid expungeNotebookRequestId = QUuid::createUuid();
         Q_UNUSED(m_expungeNotebookRequestIds.insert(expungeNotebookRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, expungeNotebookRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to expunge notebook: notebook guid = ")
                 << expungedNotebookGuid << QStringLiteral(", request id = ") << expungeNotebookRequestId);
         Q_EMIT expungeNotebook(notebookToExpunge, expungeNotebookRequestId);
@@ -1696,6 +2109,7 @@ void RemoteToLocalSynchronizationManager::expungeNotes()
 
         QUuid expungeNoteRequestId = QUuid::createUuid();
         Q_UNUSED(m_expungeNoteRequestIds.insert(expungeNoteRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, expungeNoteRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to expunge note: guid = ") << expungedNoteGuid
                 << QStringLiteral(", request id = ") << expungeNoteRequestId);
         Q_EMIT expungeNote(noteToExpunge, expungeNoteRequestId);
@@ -2035,6 +2449,7 @@ void RemoteToLocalSynchronizationManager::onAddLinkedNotebookCompleted(LinkedNot
                 << linkedNotebook << QStringLiteral(", request id = ") << requestId);
 
         Q_UNUSED(m_addLinkedNotebookRequestIds.erase(it))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
         checkServerDataMergeCompletion();
     }
 }
@@ -2058,6 +2473,7 @@ void RemoteToLocalSynchronizationManager::onUpdateLinkedNotebookCompleted(Linked
                 << linkedNotebook << QStringLiteral(", requestId = ") << requestId);
 
         Q_UNUSED(m_updateLinkedNotebookRequestIds.erase(it));
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
         checkServerDataMergeCompletion();
     }
 }
@@ -2090,32 +2506,7 @@ void RemoteToLocalSynchronizationManager::onExpungeLinkedNotebookCompleted(Linke
     }
 
     const QString & linkedNotebookGuid = linkedNotebook.guid();
-
-    auto notebookSyncCacheIt = m_notebookSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-    if (notebookSyncCacheIt != m_notebookSyncCachesByLinkedNotebookGuids.end())
-    {
-        NotebookSyncCache * pNotebookSyncCache = notebookSyncCacheIt.value();
-        if (pNotebookSyncCache) {
-            pNotebookSyncCache->disconnect();
-            pNotebookSyncCache->setParent(Q_NULLPTR);
-            pNotebookSyncCache->deleteLater();
-        }
-
-        Q_UNUSED(m_notebookSyncCachesByLinkedNotebookGuids.erase(notebookSyncCacheIt))
-    }
-
-    auto tagSyncCacheIt = m_tagSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-    if (tagSyncCacheIt != m_tagSyncCachesByLinkedNotebookGuids.end())
-    {
-        TagSyncCache * pTagSyncCache = tagSyncCacheIt.value();
-        if (pTagSyncCache) {
-            pTagSyncCache->disconnect();
-            pTagSyncCache->setParent(Q_NULLPTR);
-            pTagSyncCache->deleteLater();
-        }
-
-        Q_UNUSED(m_tagSyncCachesByLinkedNotebookGuids.erase(tagSyncCacheIt))
-    }
+    m_syncCachesManager.removeLinkedNotebookCaches(linkedNotebookGuid);
 
     auto linkedNotebookGuidPendingTagSyncCacheIt = m_linkedNotebookGuidsPendingTagSyncCachesFill.find(linkedNotebookGuid);
     if (linkedNotebookGuidPendingTagSyncCacheIt != m_linkedNotebookGuidsPendingTagSyncCachesFill.end()) {
@@ -2228,6 +2619,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteCompleted(Note note, bool
                 << QStringLiteral("\nRequestId = ") << requestId);
 
         Q_UNUSED(m_updateNoteRequestIds.erase(it));
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
 
         performPostAddOrUpdateChecks(note);
         checkServerDataMergeCompletion();
@@ -2241,6 +2633,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteCompleted(Note note, bool
                 << note << QStringLiteral("\nRequestId = ") << requestId);
 
         Q_UNUSED(m_updateNoteWithThumbnailRequestIds.erase(tit))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
 
         checkAndIncrementNoteDownloadProgress(note.hasGuid() ? note.guid() : QString());
         performPostAddOrUpdateChecks(note);
@@ -2256,6 +2649,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteCompleted(Note note, bool
 
         Resource resource = mdit.value();
         Q_UNUSED(m_resourcesByMarkNoteOwningResourceDirtyRequestIds.erase(mdit))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString(), 1);
         performPostAddOrUpdateChecks(resource);
         checkServerDataMergeCompletion();
         return;
@@ -2276,6 +2670,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteFailed(Note note, bool upd
                 << requestId);
 
         Q_UNUSED(m_updateNoteRequestIds.erase(it))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
 
         ErrorString error(QT_TR_NOOP("Failed to update the note in the local storage"));
         error.additionalBases().append(errorDescription.base());
@@ -2297,6 +2692,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteFailed(Note note, bool upd
         QNWARNING(errorDescription);
 
         Q_UNUSED(m_updateNoteWithThumbnailRequestIds.erase(tit))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
 
         checkAndIncrementNoteDownloadProgress(note.hasGuid() ? note.guid() : QString());
         checkServerDataMergeCompletion();
@@ -2311,6 +2707,7 @@ void RemoteToLocalSynchronizationManager::onUpdateNoteFailed(Note note, bool upd
                 << note);
 
         Q_UNUSED(m_resourcesByMarkNoteOwningResourceDirtyRequestIds.erase(mdit))
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
 
         ErrorString error(QT_TR_NOOP("Failed to mark the resource owning note dirty in the local storage"));
         error.additionalBases().append(errorDescription.base());
@@ -2356,6 +2753,8 @@ void RemoteToLocalSynchronizationManager::onUpdateResourceFailed(Resource resour
         QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onUpdateResourceFailed: resource = ")
                 << resource << QStringLiteral("\nrequestId = ") << requestId);
 
+        endSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, requestId.toString());
+
         ErrorString error(QT_TR_NOOP("Failed to update the resource in the local storage"));
         error.additionalBases().append(errorDescription.base());
         error.additionalBases().append(errorDescription.additionalBases());
@@ -2414,6 +2813,7 @@ void RemoteToLocalSynchronizationManager::onNoteThumbnailDownloadingFinished(boo
 
     QUuid updateNoteRequestId = QUuid::createUuid();
     Q_UNUSED(m_updateNoteWithThumbnailRequestIds.insert(updateNoteRequestId))
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateNoteRequestId.toString());
 
     QNTRACE(QStringLiteral("Emitting the request to update note with downloaded thumbnail: request id = ")
             << updateNoteRequestId << QStringLiteral(", note: ") << note);
@@ -2438,6 +2838,14 @@ void RemoteToLocalSynchronizationManager::onAuthenticationInfoReceived(QString a
         return;
     }
 
+    if (m_afterUsnForSyncChunkPendingAuthentication >= 0) {
+        qint32 afterUsn = m_afterUsnForSyncChunkPendingAuthentication;
+        m_afterUsnForSyncChunkPendingAuthentication = -1;
+        QNDEBUG(QStringLiteral("Resuming the download of sync chunks after USN ") << afterUsn);
+        downloadSyncChunksAndLaunchSync(afterUsn);
+        return;
+    }
+
     launchSync();
 }
 
@@ -2515,6 +2923,113 @@ void RemoteToLocalSynchronizationManager::setDownloadInkNoteImages(const bool fl
     appSettings.endGroup();
 }
 
+void RemoteToLocalSynchronizationManager::setSyncChunksMemoryLimit(const qint64 memoryLimitBytes)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setSyncChunksMemoryLimit: ") << memoryLimitBytes);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(SYNC_CHUNKS_MEMORY_LIMIT_KEY, memoryLimitBytes);
+    appSettings.endGroup();
+}
+
+void RemoteToLocalSynchronizationManager::setMaxInFlightDownloads(const int maxInFlightDownloads)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setMaxInFlightDownloads: ") << maxInFlightDownloads);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(MAX_IN_FLIGHT_DOWNLOADS_KEY, maxInFlightDownloads);
+    appSettings.endGroup();
+
+    // NOTE: applying the new value right away so that it affects the sync in progress, if any
+    m_downloadScheduler.setMaxWindow(maxInFlightDownloads);
+}
+
+void RemoteToLocalSynchronizationManager::setMaxParallelLinkedNotebookSyncs(const int maxParallelLinkedNotebookSyncs)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setMaxParallelLinkedNotebookSyncs: ")
+            << maxParallelLinkedNotebookSyncs);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(MAX_PARALLEL_LINKED_NOTEBOOK_SYNCS_KEY, maxParallelLinkedNotebookSyncs);
+    appSettings.endGroup();
+
+    m_maxParallelLinkedNotebookSyncs = std::max(maxParallelLinkedNotebookSyncs, 1);
+
+    // NOTE: if the linked notebooks sync chunks are being downloaded, the increased limit takes effect right away
+    if (m_active && m_linkedNotebooksSyncChunksDownloadStarted && !m_linkedNotebooksSyncChunksDownloaded) {
+        checkLinkedNotebooksSyncChunksDownloadCompletion();
+    }
+}
+
+void RemoteToLocalSynchronizationManager::setDownloadResourceDataOnDemand(const bool flag)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setDownloadResourceDataOnDemand: flag = ")
+            << (flag ? QStringLiteral("true") : QStringLiteral("false")));
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(DOWNLOAD_RESOURCE_DATA_ON_DEMAND_KEY, flag);
+    appSettings.endGroup();
+
+    m_downloadResourceDataOnDemand = flag;
+}
+
+void RemoteToLocalSynchronizationManager::setResourceDataPrefetchPolicy(const qint32 maxNoteAgeDays,
+                                                                        const qint64 maxNoteResourcesSizeBytes)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setResourceDataPrefetchPolicy: max note age days = ")
+            << maxNoteAgeDays << QStringLiteral(", max note resources size = ") << maxNoteResourcesSizeBytes);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(RESOURCE_DATA_PREFETCH_MAX_NOTE_AGE_KEY, maxNoteAgeDays);
+    appSettings.setValue(RESOURCE_DATA_PREFETCH_MAX_SIZE_KEY, maxNoteResourcesSizeBytes);
+    appSettings.endGroup();
+
+    m_resourceDataPrefetchMaxNoteAgeDays = maxNoteAgeDays;
+    m_resourceDataPrefetchMaxSize = maxNoteResourcesSizeBytes;
+}
+
+void RemoteToLocalSynchronizationManager::setVisibleNoteGuids(const QStringList & noteGuids)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setVisibleNoteGuids: ") << noteGuids.join(QStringLiteral(", ")));
+
+    // NOTE: the visible notes are not persisted in the settings: this is the transient state of the UI
+    m_noteImagesDownloadManager.setVisibleNoteGuids(noteGuids);
+
+    m_visibleNoteGuids = noteGuids.toSet();
+    updateScheduledDownloadsUrgency();
+}
+
+void RemoteToLocalSynchronizationManager::prioritizeNoteDownloads(const QStringList & noteGuids)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::prioritizeNoteDownloads: ") << noteGuids.join(QStringLiteral(", ")));
+
+    // NOTE: each call replaces the previously requested notes rather than adding to them
+    m_requestedNoteGuids = noteGuids.toSet();
+    updateScheduledDownloadsUrgency();
+}
+
+void RemoteToLocalSynchronizationManager::setSelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setSelectiveSyncFilter: notebook guids: ")
+            << notebookGuids.join(QStringLiteral(", ")) << QStringLiteral("; tag guids: ") << tagGuids.join(QStringLiteral(", ")));
+
+    SelectiveSyncFilter filter(notebookGuids, tagGuids);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY, filter.notebookGuids());
+    appSettings.setValue(SELECTIVE_SYNC_TAG_GUIDS_KEY, filter.tagGuids());
+    appSettings.endGroup();
+
+    // NOTE: the filter is read from the settings on the start of each sync; the running sync keeps using the filter
+    // it has started with since that one is recorded as the applied filter once the sync finishes
+}
+
 void RemoteToLocalSynchronizationManager::setInkNoteImagesStoragePath(const QString & path)
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setInkNoteImagesStoragePath: path = ") << path);
@@ -2565,6 +3080,12 @@ void RemoteToLocalSynchronizationManager::collectNonProcessedItemsSmallestUsns(q
 
     if (!syncingLinkedNotebooks)
     {
+        if (m_lastSyncMode == SyncMode::FullSync) {
+            QNDEBUG(QStringLiteral("Full sync of user's own account is in progress, it is resumed from the sync checkpoint "
+                                   "rather than from the last sync parameters"));
+            return;
+        }
+
         if (!m_syncChunksDownloaded) {
             QNDEBUG(QStringLiteral("Not all sync chunks from user's own account were downloaded (if any) => there are no valid USNs to return"));
             return;
@@ -2599,8 +3120,14 @@ void RemoteToLocalSynchronizationManager::collectNonProcessedItemsSmallestUsns(q
             continue;
         }
 
-        qint32 smallestUsn = nonProcessedItemsSmallestUsn(linkedNotebook.guid());
-        if (smallestUsn >= 0) {
+        if (m_linkedNotebookGuidsForWhichFullSyncWasPerformed.contains(linkedNotebook.guid())) {
+            QNDEBUG(QStringLiteral("Full sync of linked notebook with guid ") << linkedNotebook.guid()
+                    << QStringLiteral(" is in progress, it would start over if interrupted"));
+            continue;
+        }
+
+        qint32 smallestUsn = nonProcessedItemsSmallestUsn(linkedNotebook.guid());
+        if (smallestUsn >= 0) {
             QNDEBUG(QStringLiteral("Found the smallest USN of non-processed items within linked notebook with guid ")
                     << linkedNotebook.guid() << QStringLiteral(": ") << smallestUsn);
             usnByLinkedNotebookGuid[linkedNotebook.guid()] = (smallestUsn - 1);
@@ -2653,6 +3180,34 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
         return;
     }
 
+    if (errorCode == 0)
+    {
+        qint64 noteSize = (qecNote.content.isSet() ? qecNote.content->size() : 0);
+        if (qecNote.resources.isSet())
+        {
+            const QList<qevercloud::Resource> & resources = qecNote.resources.ref();
+            for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+            {
+                if (it->data.isSet() && it->data->body.isSet()) {
+                    noteSize += it->data->body->size();
+                }
+
+                if (it->alternateData.isSet() && it->alternateData->body.isSet()) {
+                    noteSize += it->alternateData->body->size();
+                }
+            }
+        }
+
+        endSyncTraceSpan(SyncTracer::Phase::NoteDownload, noteGuid, 1, noteSize);
+    }
+    else
+    {
+        endSyncTraceSpan(SyncTracer::Phase::NoteDownload, noteGuid);
+    }
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    DownloadScheduler::Download scheduledDownload;
+
     if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
     {
         if (rateLimitSeconds <= 0) {
@@ -2663,25 +3218,26 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
             return;
         }
 
-        int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-        if (Q_UNLIKELY(timerId == 0)) {
-            errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
-                                                "due to rate limit exceeding"));
-            Q_EMIT failure(errorDescription);
-            return;
-        }
-
+        // NOTE: the note is put back into the download scheduler's queue; the scheduler holds back all the downloads,
+        // regardless of the note store, until the rate limit expires
+        bool wasScheduled = m_downloadScheduler.onRateLimitReached(DownloadScheduler::DownloadType::Note, noteGuid,
+                                                                   rateLimitSeconds, timestamp, scheduledDownload);
+        const Note & noteToDownload = (wasScheduled ? scheduledDownload.m_note : note);
         if (needToAddNote) {
-            m_notesToAddPerAPICallPostponeTimerId[timerId] = note;
+            getFullNoteDataAsyncAndAddToLocalStorage(noteToDownload);
         }
         else {
-            m_notesToUpdatePerAPICallPostponeTimerId[timerId] = note;
+            getFullNoteDataAsyncAndUpdateInLocalStorage(noteToDownload);
         }
 
         Q_EMIT rateLimitExceeded(rateLimitSeconds);
         return;
     }
-    else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
+
+    Q_UNUSED(m_downloadScheduler.onDownloadFinished(DownloadScheduler::DownloadType::Note, noteGuid,
+                                                    timestamp, scheduledDownload))
+
+    if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
     {
         handleAuthExpiration();
         return;
@@ -2691,6 +3247,25 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
         return;
     }
 
+    // The successful download might have widened the window of downloads in flight
+    startScheduledDownloads();
+
+    // If only the changed parts of the note were downloaded, the rest of the note's data needs to be taken
+    // from the local note
+    bool partialDownload = false;
+    bool resourceDataDownloaded = true;
+    Note localNote;
+    if (needToUpdateNote)
+    {
+        auto partialDownloadIt = m_partialNoteDataDownloadsByGuid.find(noteGuid);
+        if (partialDownloadIt != m_partialNoteDataDownloadsByGuid.end()) {
+            partialDownload = true;
+            localNote = partialDownloadIt.value().first;
+            resourceDataDownloaded = partialDownloadIt.value().second.m_withResourceData;
+            Q_UNUSED(m_partialNoteDataDownloadsByGuid.erase(partialDownloadIt))
+        }
+    }
+
     // NOTE: thumbnails for notes are downloaded separately and their download is optional;
     // for the sake of better error tolerance the failure to download thumbnails for particular notes
     // should not be considered the failure of the synchronization algorithm as a whole.
@@ -2701,7 +3276,7 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
 
     const Notebook * pNotebook = Q_NULLPTR;
 
-    if (shouldDownloadThumbnailsForNotes() && note.hasResources())
+    if (shouldDownloadThumbnailsForNotes() && note.hasResources() && resourceDataDownloaded)
     {
         QNDEBUG(QStringLiteral("The added or updated note contains resources, need to download the thumbnails for it"));
 
@@ -2728,7 +3303,7 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
     // and for better error tolerance the failure to download any ink note image is not considered a failure
     // of the synchronization procedure
 
-    if (shouldDownloadInkNoteImages() && note.hasResources() && note.isInkNote())
+    if (shouldDownloadInkNoteImages() && note.hasResources() && note.isInkNote() && resourceDataDownloaded)
     {
         QNDEBUG(QStringLiteral("The added or updated note is the ink note, need to download the ink note image for it"));
 
@@ -2760,8 +3335,14 @@ void RemoteToLocalSynchronizationManager::onGetNoteAsyncFinished(qint32 errorCod
         return;
     }
 
+    if (partialDownload) {
+        updateNoteInLocalStorageKeepingLocalData(note, localNote);
+        return;
+    }
+
     QUuid updateNoteRequestId = QUuid::createUuid();
     Q_UNUSED(m_updateNoteRequestIds.insert(updateNoteRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateNoteRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to update note in local storage: request id = ")
             << updateNoteRequestId << QStringLiteral(", note; ") << note);
     Q_EMIT updateNote(note, /* update resources = */ true, /* update tags = */ true, updateNoteRequestId);
@@ -2815,6 +3396,27 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
         return;
     }
 
+    if (errorCode == 0)
+    {
+        qint64 resourceSize = 0;
+        if (qecResource.data.isSet() && qecResource.data->body.isSet()) {
+            resourceSize += qecResource.data->body->size();
+        }
+
+        if (qecResource.alternateData.isSet() && qecResource.alternateData->body.isSet()) {
+            resourceSize += qecResource.alternateData->body->size();
+        }
+
+        endSyncTraceSpan(SyncTracer::Phase::ResourceDownload, resourceGuid, 1, resourceSize);
+    }
+    else
+    {
+        endSyncTraceSpan(SyncTracer::Phase::ResourceDownload, resourceGuid);
+    }
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    DownloadScheduler::Download scheduledDownload;
+
     if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
     {
         if (rateLimitSeconds <= 0) {
@@ -2825,25 +3427,27 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
             return;
         }
 
-        int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-        if (Q_UNLIKELY(timerId == 0)) {
-            errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
-                                                "due to rate limit exceeding"));
-            Q_EMIT failure(errorDescription);
-            return;
-        }
-
+        // NOTE: the resource is put back into the download scheduler's queue; the scheduler holds back all the downloads,
+        // regardless of the note store, until the rate limit expires
+        bool wasScheduled = m_downloadScheduler.onRateLimitReached(DownloadScheduler::DownloadType::Resource, resourceGuid,
+                                                                   rateLimitSeconds, timestamp, scheduledDownload);
+        const Resource & resourceToDownload = (wasScheduled ? scheduledDownload.m_resource : resource);
+        const Note & resourceOwningNote = (wasScheduled ? scheduledDownload.m_note : note);
         if (needToAddResource) {
-            m_resourcesToAddWithNotesPerAPICallPostponeTimerId[timerId] = std::pair<Resource,Note>(resource, note);
+            getFullResourceDataAsyncAndAddToLocalStorage(resourceToDownload, resourceOwningNote);
         }
-        else if (needToUpdateResource) {
-            m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId[timerId] = std::pair<Resource,Note>(resource, note);
+        else {
+            getFullResourceDataAsyncAndUpdateInLocalStorage(resourceToDownload, resourceOwningNote);
         }
 
         Q_EMIT rateLimitExceeded(rateLimitSeconds);
         return;
     }
-    else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
+
+    Q_UNUSED(m_downloadScheduler.onDownloadFinished(DownloadScheduler::DownloadType::Resource, resourceGuid,
+                                                    timestamp, scheduledDownload))
+
+    if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
     {
         handleAuthExpiration();
         return;
@@ -2853,6 +3457,9 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
         return;
     }
 
+    // The successful download might have widened the window of downloads in flight
+    startScheduledDownloads();
+
     checkAndIncrementResourceDownloadProgress(resourceGuid);
 
     if (needToAddResource)
@@ -2863,6 +3470,7 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
 
         QUuid addResourceRequestId = QUuid::createUuid();
         Q_UNUSED(m_addResourceRequestIds.insert(addResourceRequestId));
+        beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, addResourceRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to add resource to local storage: request id = ")
                 << addResourceRequestId << QStringLiteral(", resource: ") << resource);
         Q_EMIT addResource(resource, addResourceRequestId);
@@ -2871,6 +3479,7 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
     {
         QUuid updateResourceRequestId = QUuid::createUuid();
         Q_UNUSED(m_updateResourceRequestIds.insert(updateResourceRequestId))
+        beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateResourceRequestId.toString());
         QNTRACE(QStringLiteral("Emitting the request to update resource: request id = ") << updateResourceRequestId
                 << QStringLiteral(", resource: ") << resource);
         Q_EMIT updateResource(resource, updateResourceRequestId);
@@ -2879,6 +3488,7 @@ void RemoteToLocalSynchronizationManager::onGetResourceAsyncFinished(qint32 erro
     note.setDirty(true);
     QUuid markNoteDirtyRequestId = QUuid::createUuid();
     m_resourcesByMarkNoteOwningResourceDirtyRequestIds[markNoteDirtyRequestId] = resource;
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, markNoteDirtyRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to mark the resource owning note as the dirty one: request id = ")
             << markNoteDirtyRequestId << QStringLiteral(", resource: ") << resource);
     Q_EMIT updateNote(note, /* update resources = */ false, /* update tags = */ false, markNoteDirtyRequestId);
@@ -2896,6 +3506,13 @@ void RemoteToLocalSynchronizationManager::onTagSyncCacheFilled()
         return;
     }
 
+    // The cache is shared with other consumers and is kept up to date after being filled,
+    // no need to listen to its further notifications
+    QObject::disconnect(pTagSyncCache, QNSIGNAL(TagSyncCache,filled),
+                        this, QNSLOT(RemoteToLocalSynchronizationManager,onTagSyncCacheFilled));
+    QObject::disconnect(pTagSyncCache, QNSIGNAL(TagSyncCache,failure,ErrorString),
+                        this, QNSLOT(RemoteToLocalSynchronizationManager,onTagSyncCacheFailure,ErrorString));
+
     const QString & linkedNotebookGuid = pTagSyncCache->linkedNotebookGuid();
     auto it = m_linkedNotebookGuidsPendingTagSyncCachesFill.find(linkedNotebookGuid);
     if (Q_UNLIKELY(it == m_linkedNotebookGuidsPendingTagSyncCachesFill.end())) {
@@ -2911,7 +3528,7 @@ void RemoteToLocalSynchronizationManager::onTagSyncCacheFilled()
     Q_UNUSED(m_linkedNotebookGuidsPendingTagSyncCachesFill.erase(it))
     if (m_linkedNotebookGuidsPendingTagSyncCachesFill.isEmpty()) {
         QNDEBUG(QStringLiteral("No more linked notebook guids pending tag sync caches fill"));
-        startFeedingDownloadedTagsToLocalStorageOneByOne(m_tags);
+        startFeedingDownloadedTagsToLocalStorageByLevels(m_tags);
     }
     else {
         QNDEBUG(QStringLiteral("Still have ") << m_linkedNotebookGuidsPendingTagSyncCachesFill.size()
@@ -2935,6 +3552,10 @@ void RemoteToLocalSynchronizationManager::onNotebookSyncConflictResolverFinished
         pResolver->deleteLater();
     }
 
+    if (remoteNotebook.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteNotebook.guid.ref(), 1);
+    }
+
     unregisterNotebookPendingAddOrUpdate(Notebook(remoteNotebook));
 
     checkNotebooksAndTagsSyncCompletionAndLaunchNotesSync();
@@ -2952,6 +3573,10 @@ void RemoteToLocalSynchronizationManager::onNotebookSyncConflictResolverFailure(
         pResolver->deleteLater();
     }
 
+    if (remoteNotebook.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteNotebook.guid.ref());
+    }
+
     Q_EMIT failure(errorDescription);
 }
 
@@ -2965,8 +3590,12 @@ void RemoteToLocalSynchronizationManager::onTagSyncConflictResolverFinished(qeve
         pResolver->deleteLater();
     }
 
+    if (remoteTag.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteTag.guid.ref(), 1);
+    }
+
     unregisterTagPendingAddOrUpdate(Tag(remoteTag));
-    syncNextTagPendingProcessing();
+    onTagFromCurrentLevelProcessed(remoteTag.guid.isSet() ? remoteTag.guid.ref() : QString());
     checkNotebooksAndTagsSyncCompletionAndLaunchNotesSync();
     checkServerDataMergeCompletion();
 }
@@ -2982,6 +3611,10 @@ void RemoteToLocalSynchronizationManager::onTagSyncConflictResolverFailure(qever
         pResolver->deleteLater();
     }
 
+    if (remoteTag.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteTag.guid.ref());
+    }
+
     Q_EMIT failure(errorDescription);
 }
 
@@ -2995,6 +3628,10 @@ void RemoteToLocalSynchronizationManager::onSavedSearchSyncConflictResolverFinis
         pResolver->deleteLater();
     }
 
+    if (remoteSavedSearch.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteSavedSearch.guid.ref(), 1);
+    }
+
     unregisterSavedSearchPendingAddOrUpdate(SavedSearch(remoteSavedSearch));
     checkServerDataMergeCompletion();
 }
@@ -3010,6 +3647,10 @@ void RemoteToLocalSynchronizationManager::onSavedSearchSyncConflictResolverFailu
         pResolver->deleteLater();
     }
 
+    if (remoteSavedSearch.guid.isSet()) {
+        endSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteSavedSearch.guid.ref());
+    }
+
     Q_EMIT failure(errorDescription);
 }
 
@@ -3039,6 +3680,8 @@ void RemoteToLocalSynchronizationManager::onFullSyncStaleDataItemsExpungerFinish
         junkFullSyncStaleDataItemsExpunger(*pExpunger);
     }
 
+    endSyncTraceSpan(SyncTracer::Phase::Expunge, QStringLiteral("FullSyncStaleDataItems/") + linkedNotebookGuid, 1);
+
     if (linkedNotebookGuid.isEmpty())
     {
         QNDEBUG(QStringLiteral("Finished analyzing and expunging stuff from user's own account after the non-first full sync"));
@@ -3085,6 +3728,8 @@ void RemoteToLocalSynchronizationManager::onFullSyncStaleDataItemsExpungerFailur
         junkFullSyncStaleDataItemsExpunger(*pExpunger);
     }
 
+    endSyncTraceSpan(SyncTracer::Phase::Expunge, QStringLiteral("FullSyncStaleDataItems/") + linkedNotebookGuid);
+
     QNWARNING(QStringLiteral("Failed to analyze and expunge stale stuff after the non-first full sync: ")
               << errorDescription << QStringLiteral("; linked notebook guid = ") << linkedNotebookGuid);
     Q_EMIT failure(errorDescription);
@@ -3115,6 +3760,8 @@ void RemoteToLocalSynchronizationManager::connectToLocalStorage()
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNotebookRequest,Notebook,QUuid));
     QObject::connect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,findNotebook,Notebook,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
+    QObject::connect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,findLastUsedNotebook,Notebook,QUuid),
+                     &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindLastUsedNotebookRequest,Notebook,QUuid));
     QObject::connect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,expungeNotebook,Notebook,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onExpungeNotebookRequest,Notebook,QUuid));
 
@@ -3181,6 +3828,10 @@ void RemoteToLocalSynchronizationManager::connectToLocalStorage()
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNotebookCompleted,Notebook,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNotebookFailed,Notebook,ErrorString,QUuid),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNotebookFailed,Notebook,ErrorString,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findLastUsedNotebookComplete,Notebook,QUuid),
+                     this, QNSLOT(RemoteToLocalSynchronizationManager,onFindLastUsedNotebookCompleted,Notebook,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findLastUsedNotebookFailed,Notebook,ErrorString,QUuid),
+                     this, QNSLOT(RemoteToLocalSynchronizationManager,onFindLastUsedNotebookFailed,Notebook,ErrorString,QUuid));
 
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteComplete,Note,bool,QUuid),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNoteCompleted,Note,bool,QUuid));
@@ -3348,6 +3999,8 @@ void RemoteToLocalSynchronizationManager::disconnectFromLocalStorage()
                         &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNotebookRequest,Notebook,QUuid));
     QObject::disconnect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,findNotebook,Notebook,QUuid),
                         &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
+    QObject::disconnect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,findLastUsedNotebook,Notebook,QUuid),
+                        &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindLastUsedNotebookRequest,Notebook,QUuid));
     QObject::disconnect(this, QNSIGNAL(RemoteToLocalSynchronizationManager,expungeNotebook,Notebook,QUuid),
                         &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onExpungeNotebookRequest,Notebook,QUuid));
 
@@ -3414,6 +4067,10 @@ void RemoteToLocalSynchronizationManager::disconnectFromLocalStorage()
                         this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNotebookCompleted,Notebook,QUuid));
     QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNotebookFailed,Notebook,ErrorString,QUuid),
                         this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNotebookFailed,Notebook,ErrorString,QUuid));
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findLastUsedNotebookComplete,Notebook,QUuid),
+                        this, QNSLOT(RemoteToLocalSynchronizationManager,onFindLastUsedNotebookCompleted,Notebook,QUuid));
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findLastUsedNotebookFailed,Notebook,ErrorString,QUuid),
+                        this, QNSLOT(RemoteToLocalSynchronizationManager,onFindLastUsedNotebookFailed,Notebook,ErrorString,QUuid));
 
     QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNoteComplete,Note,bool,QUuid),
                         this, QNSLOT(RemoteToLocalSynchronizationManager,onFindNoteCompleted,Note,bool,QUuid));
@@ -3570,6 +4227,11 @@ QString RemoteToLocalSynchronizationManager::defaultInkNoteImageStoragePath() co
     return applicationPersistentStoragePath() + QStringLiteral("/inkNoteImages");
 }
 
+QString RemoteToLocalSynchronizationManager::noteImagesCachePath() const
+{
+    return accountPersistentStoragePath(account()) + QStringLiteral("/noteImagesCache");
+}
+
 void RemoteToLocalSynchronizationManager::launchSync()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchSync"));
@@ -3580,12 +4242,6 @@ void RemoteToLocalSynchronizationManager::launchSync()
         return;
     }
 
-    if (m_onceSyncDone && (m_lastSyncMode == SyncMode::FullSync)) {
-        QNDEBUG(QStringLiteral("Performing full sync even though it has been performed at some moment in the past; "
-                               "collecting synced guids for full sync stale data items expunger"));
-        collectSyncedGuidsForFullSyncStaleDataItemsExpunger();
-    }
-
     m_pendingTagsSyncStart = true;
     m_pendingLinkedNotebooksSyncStart = true;
     m_pendingNotebooksSyncStart = true;
@@ -3596,6 +4252,10 @@ void RemoteToLocalSynchronizationManager::launchSync()
     launchTagsSync();
     launchNotebookSync();
 
+    // NOTE: saved searches and notebooks from all the downloaded sync chunks have been dispatched for processing now,
+    // if the sync is launched once again, there's no need to process them for the second time
+    m_numSyncChunksWithMergedSavedSearchesAndNotebooks = m_syncChunks.size();
+
     if (!m_tags.empty() || !m_notebooks.isEmpty()) {
         // NOTE: the sync of notes and, if need be, individual resouces would be launched asynchronously when the
         // notebooks and tags are synced
@@ -4129,24 +4789,53 @@ void RemoteToLocalSynchronizationManager::writeAccountLimitsToAppSettings()
     appSettings.setValue(keyGroup + ACCOUNT_LIMITS_LAST_SYNC_TIME_KEY, QVariant(QDateTime::currentMSecsSinceEpoch()));
 }
 
+template <class ElementType>
+int RemoteToLocalSynchronizationManager::numSyncChunksMergedDuringDownload() const
+{
+    return 0;
+}
+
+template <>
+int RemoteToLocalSynchronizationManager::numSyncChunksMergedDuringDownload<SavedSearch>() const
+{
+    return m_numSyncChunksWithMergedSavedSearchesAndNotebooks;
+}
+
+template <>
+int RemoteToLocalSynchronizationManager::numSyncChunksMergedDuringDownload<Notebook>() const
+{
+    return m_numSyncChunksWithMergedSavedSearchesAndNotebooks;
+}
+
 template <class ContainerType, class ElementType>
-void RemoteToLocalSynchronizationManager::launchDataElementSyncCommon(const ContentSource::type contentSource, ContainerType & container,
+bool RemoteToLocalSynchronizationManager::launchDataElementSyncCommon(const ContentSource::type contentSource, ContainerType & container,
                                                                       QList<QString> & expungedElements)
 {
     bool syncingUserAccountData = (contentSource == ContentSource::UserAccount);
     QNTRACE(QStringLiteral("syncingUserAccountData = ") << (syncingUserAccountData ? QStringLiteral("true") : QStringLiteral("false")));
 
-    const auto & syncChunks = (syncingUserAccountData ? m_syncChunks : m_linkedNotebookSyncChunks);
+    const SyncChunkSpool & syncChunks = syncChunksForContentSource(contentSource);
+
+    // NOTE: the data elements from the sync chunks merged during the download are already within the container,
+    // some of them are still being processed so the container must not be cleared in this case
+    int firstSyncChunkIndex = (syncingUserAccountData ? numSyncChunksMergedDuringDownload<ElementType>() : 0);
+    if (firstSyncChunkIndex == 0) {
+        container.clear();
+    }
 
-    container.clear();
     int numSyncChunks = syncChunks.size();
-    QNTRACE(QStringLiteral("Num sync chunks = ") << numSyncChunks);
+    QNTRACE(QStringLiteral("Num sync chunks = ") << numSyncChunks << QStringLiteral(", first sync chunk index = ")
+            << firstSyncChunkIndex);
 
-    for(int i = 0; i < numSyncChunks; ++i) {
-        const qevercloud::SyncChunk & syncChunk = syncChunks[i];
+    // NOTE: notes and resources, the only data elements the sync chunks spool might keep on disk, are taken
+    // from the sync chunks separately, see takeNotesFromSyncChunks and takeResourcesFromSyncChunks
+    for(int i = firstSyncChunkIndex; i < numSyncChunks; ++i) {
+        const qevercloud::SyncChunk & syncChunk = syncChunks.at(i);
         appendDataElementsFromSyncChunkToContainer<ContainerType>(syncChunk, container);
         extractExpungedElementsFromSyncChunk<ElementType>(syncChunk, expungedElements);
     }
+
+    return true;
 }
 
 template <class ContainerType, class ElementType>
@@ -4155,24 +4844,15 @@ void RemoteToLocalSynchronizationManager::launchDataElementSync(const ContentSou
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchDataElementSync: ") << typeName);
 
-    launchDataElementSyncCommon<ContainerType, ElementType>(contentSource, container, expungedElements);
+    if (!launchDataElementSyncCommon<ContainerType, ElementType>(contentSource, container, expungedElements)) {
+        return;
+    }
 
     if (container.isEmpty()) {
         QNDEBUG(QStringLiteral("No new or updated data items within the container"));
         return;
     }
 
-    int numElements = container.size();
-
-    if (typeName == QStringLiteral("Note")) {
-        m_originalNumberOfNotes = static_cast<quint32>(std::max(numElements, 0));
-        m_numNotesDownloaded = static_cast<quint32>(0);
-    }
-    else if (typeName == QStringLiteral("Resource")) {
-        m_originalNumberOfResources = static_cast<quint32>(std::max(numElements, 0));
-        m_numResourcesDownloaded = static_cast<quint32>(0);
-    }
-
     for(auto it = container.begin(), end = container.end(); it != end; ++it)
     {
         const auto & element = *it;
@@ -4194,7 +4874,9 @@ void RemoteToLocalSynchronizationManager::launchDataElementSync<TagsContainer, T
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchDataElementSync: ") << typeName);
 
-    launchDataElementSyncCommon<TagsContainer, Tag>(contentSource, container, expungedElements);
+    if (!launchDataElementSyncCommon<TagsContainer, Tag>(contentSource, container, expungedElements)) {
+        return;
+    }
 
     if (container.empty()) {
         QNDEBUG(QStringLiteral("No data items within the container"));
@@ -4255,13 +4937,7 @@ void RemoteToLocalSynchronizationManager::launchDataElementSync<TagsContainer, T
             {
                 const QString & linkedNotebookGuid = *it;
 
-                auto tagSyncCacheIt = m_tagSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-                if (tagSyncCacheIt == m_tagSyncCachesByLinkedNotebookGuids.end()) {
-                    TagSyncCache * pTagSyncCache = new TagSyncCache(m_manager.localStorageManagerAsync(), linkedNotebookGuid, this);
-                    tagSyncCacheIt = m_tagSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pTagSyncCache);
-                }
-
-                TagSyncCache * pTagSyncCache = tagSyncCacheIt.value();
+                TagSyncCache * pTagSyncCache = &m_syncCachesManager.tagSyncCache(linkedNotebookGuid);
                 if (pTagSyncCache->isFilled()) {
                     checkAndRemoveInaccessibleParentTagGuidsForTagsFromLinkedNotebook(linkedNotebookGuid, *pTagSyncCache);
                 }
@@ -4284,13 +4960,120 @@ void RemoteToLocalSynchronizationManager::launchDataElementSync<TagsContainer, T
         }
     }
 
-    startFeedingDownloadedTagsToLocalStorageOneByOne(container);
+    startFeedingDownloadedTagsToLocalStorageByLevels(container);
+}
+
+template <>
+void RemoteToLocalSynchronizationManager::launchDataElementSync<NotesList, Note>(const ContentSource::type contentSource,
+                                                                                 const QString & typeName,
+                                                                                 NotesList & container,
+                                                                                 QList<QString> & expungedElements)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchDataElementSync: ") << typeName);
+
+    // NOTE: the notes are taken from the sync chunks and put into the container for processing a few sync chunks
+    // at a time, the guids of expunged notes are collected from the sync chunks as they are taken
+    Q_UNUSED(expungedElements)
+
+    if ((m_nextSyncChunkIndexToTakeNotesFrom >= 0) && (m_notesSyncContentSource == contentSource)) {
+        QNDEBUG(QStringLiteral("The notes from these sync chunks are already being taken for processing"));
+        return;
+    }
+
+    releaseNotesTakenFromSyncChunks();
+    container.clear();
+
+    m_notesSyncContentSource = contentSource;
+    m_nextSyncChunkIndexToTakeNotesFrom = 0;
+    m_lastSyncChunkIndicesByNoteGuids.clear();
+    m_lastSyncChunkIndicesByExpungedNoteGuids.clear();
+    m_lastSyncChunkIndicesByExpungedNotebookGuids.clear();
+
+    // The same note can be contained within several sync chunks if it was modified while the sync chunks were being
+    // downloaded and the note contained within some sync chunk can be expunged by one of the subsequent sync chunks;
+    // the guids kept in memory for all the sync chunks allow to figure that out without reading all the notes at once
+    const SyncChunkSpool & syncChunks = syncChunksForContentSource(contentSource);
+    for(int i = 0, numSyncChunks = syncChunks.size(); i < numSyncChunks; ++i)
+    {
+        const QStringList noteGuids = syncChunks.noteGuids(i);
+        for(auto it = noteGuids.constBegin(), end = noteGuids.constEnd(); it != end; ++it) {
+            m_lastSyncChunkIndicesByNoteGuids[*it] = i;
+        }
+
+        const qevercloud::SyncChunk & syncChunk = syncChunks.at(i);
+
+        if (syncChunk.expungedNotes.isSet())
+        {
+            const QList<QString> & expungedNoteGuids = syncChunk.expungedNotes.ref();
+            for(auto it = expungedNoteGuids.constBegin(), end = expungedNoteGuids.constEnd(); it != end; ++it) {
+                m_lastSyncChunkIndicesByExpungedNoteGuids[*it] = i;
+            }
+        }
+
+        if (syncChunk.expungedNotebooks.isSet())
+        {
+            const QList<QString> & expungedNotebookGuids = syncChunk.expungedNotebooks.ref();
+            for(auto it = expungedNotebookGuids.constBegin(), end = expungedNotebookGuids.constEnd(); it != end; ++it) {
+                m_lastSyncChunkIndicesByExpungedNotebookGuids[*it] = i;
+            }
+        }
+    }
+
+    m_originalNumberOfNotes = static_cast<quint32>(m_lastSyncChunkIndicesByNoteGuids.size());
+    m_numNotesDownloaded = static_cast<quint32>(0);
+
+    if (m_originalNumberOfNotes == 0) {
+        QNDEBUG(QStringLiteral("No new or updated data items within the sync chunks"));
+    }
+
+    takeNotesFromSyncChunks();
+}
+
+template <>
+void RemoteToLocalSynchronizationManager::launchDataElementSync<ResourcesList, Resource>(const ContentSource::type contentSource,
+                                                                                         const QString & typeName,
+                                                                                         ResourcesList & container,
+                                                                                         QList<QString> & expungedElements)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchDataElementSync: ") << typeName);
+
+    Q_UNUSED(contentSource)
+    Q_UNUSED(expungedElements)
+
+    if (m_nextSyncChunkIndexToTakeResourcesFrom >= 0) {
+        QNDEBUG(QStringLiteral("The resources from the sync chunks are already being taken for processing"));
+        return;
+    }
+
+    releaseResourcesTakenFromSyncChunks();
+    container.clear();
+
+    m_nextSyncChunkIndexToTakeResourcesFrom = 0;
+    m_lastSyncChunkIndicesByResourceGuids.clear();
+
+    for(int i = 0, numSyncChunks = m_syncChunks.size(); i < numSyncChunks; ++i)
+    {
+        const QStringList resourceGuids = m_syncChunks.resourceGuids(i);
+        for(auto it = resourceGuids.constBegin(), end = resourceGuids.constEnd(); it != end; ++it) {
+            m_lastSyncChunkIndicesByResourceGuids[*it] = i;
+        }
+    }
+
+    m_originalNumberOfResources = static_cast<quint32>(m_lastSyncChunkIndicesByResourceGuids.size());
+    m_numResourcesDownloaded = static_cast<quint32>(0);
+
+    if (m_originalNumberOfResources == 0) {
+        QNDEBUG(QStringLiteral("No new or updated data items within the sync chunks"));
+    }
+
+    takeResourcesFromSyncChunks();
 }
 
 void RemoteToLocalSynchronizationManager::launchTagsSync()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchTagsSync"));
     m_pendingTagsSyncStart = false;
+    beginSyncTraceMergePhaseSpan(SyncTracer::Phase::TagsMerge);
     launchDataElementSync<TagsContainer, Tag>(ContentSource::UserAccount, QStringLiteral("Tag"), m_tags, m_expungedTags);
 }
 
@@ -4313,53 +5096,80 @@ void RemoteToLocalSynchronizationManager::launchNotebookSync()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchNotebookSync"));
     m_pendingNotebooksSyncStart = false;
+    beginSyncTraceMergePhaseSpan(SyncTracer::Phase::NotebooksMerge);
     launchDataElementSync<NotebooksList, Notebook>(ContentSource::UserAccount, QStringLiteral("Notebook"), m_notebooks, m_expungedNotebooks);
 }
 
-void RemoteToLocalSynchronizationManager::collectSyncedGuidsForFullSyncStaleDataItemsExpunger()
+void RemoteToLocalSynchronizationManager::collectSyncedGuidsFromSyncChunk(const qevercloud::SyncChunk & syncChunk,
+                                                                         FullSyncStaleDataItemsExpunger::SyncedGuids & syncedGuids) const
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::collectSyncedGuidsForFullSyncStaleDataItemsExpunger"));
-
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedNotebookGuids.clear();
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedTagGuids.clear();
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedNoteGuids.clear();
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedSavedSearchGuids.clear();
+    QNTRACE(QStringLiteral("RemoteToLocalSynchronizationManager::collectSyncedGuidsFromSyncChunk: chunk high USN = ")
+            << (syncChunk.chunkHighUSN.isSet() ? QString::number(syncChunk.chunkHighUSN.ref()) : QStringLiteral("<not set>")));
 
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedNotebookGuids.reserve(m_notebooks.size());
-    for(auto it = m_notebooks.constBegin(), end = m_notebooks.constEnd(); it != end; ++it)
+    if (syncChunk.notebooks.isSet())
     {
-        const qevercloud::Notebook & notebook = *it;
-        if (notebook.guid.isSet()) {
-            Q_UNUSED(m_fullSyncStaleDataItemsSyncedGuids.m_syncedNotebookGuids.insert(notebook.guid.ref()))
+        const QList<qevercloud::Notebook> & notebooks = syncChunk.notebooks.ref();
+        for(auto it = notebooks.constBegin(), end = notebooks.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                Q_UNUSED(syncedGuids.m_syncedNotebookGuids.insert(it->guid.ref()))
+            }
         }
     }
 
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedTagGuids.reserve(static_cast<int>(m_tags.size()));
-    for(auto it = m_tags.begin(), end = m_tags.end(); it != end; ++it)
+    if (syncChunk.tags.isSet())
     {
-        const qevercloud::Tag & tag = *it;
-        if (tag.guid.isSet()) {
-            Q_UNUSED(m_fullSyncStaleDataItemsSyncedGuids.m_syncedTagGuids.insert(tag.guid.ref()))
+        const QList<qevercloud::Tag> & tags = syncChunk.tags.ref();
+        for(auto it = tags.constBegin(), end = tags.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                Q_UNUSED(syncedGuids.m_syncedTagGuids.insert(it->guid.ref()))
+            }
         }
     }
 
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedNoteGuids.reserve(m_notes.size());
-    for(auto it = m_notes.constBegin(), end = m_notes.constEnd(); it != end; ++it)
+    // NOTE: the notes skipped due to the selective sync filter or due to the sync checkpoint still exist
+    // within the remote service so they are collected as well
+    if (syncChunk.notes.isSet())
     {
-        const qevercloud::Note & note = *it;
-        if (note.guid.isSet()) {
-            Q_UNUSED(m_fullSyncStaleDataItemsSyncedGuids.m_syncedNoteGuids.insert(note.guid.ref()))
+        const QList<qevercloud::Note> & notes = syncChunk.notes.ref();
+        for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                Q_UNUSED(syncedGuids.m_syncedNoteGuids.insert(it->guid.ref()))
+            }
         }
     }
 
-    m_fullSyncStaleDataItemsSyncedGuids.m_syncedSavedSearchGuids.reserve(m_savedSearches.size());
-    for(auto it = m_savedSearches.constBegin(), end = m_savedSearches.constEnd(); it != end; ++it)
+    if (syncChunk.searches.isSet())
     {
-        const qevercloud::SavedSearch & savedSearch = *it;
-        if (savedSearch.guid.isSet()) {
-            Q_UNUSED(m_fullSyncStaleDataItemsSyncedGuids.m_syncedSavedSearchGuids.insert(savedSearch.guid.ref()))
+        const QList<qevercloud::SavedSearch> & savedSearches = syncChunk.searches.ref();
+        for(auto it = savedSearches.constBegin(), end = savedSearches.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                Q_UNUSED(syncedGuids.m_syncedSavedSearchGuids.insert(it->guid.ref()))
+            }
         }
     }
+
+    // NOTE: the sync chunks contain expunged guids only during the incremental sync and the resumed full sync;
+    // the data items expunged from the service no longer exist there even if listed within the earlier sync chunks
+
+#define REMOVE_EXPUNGED_GUIDS(expungedGuids, guids) \
+    if (syncChunk.expungedGuids.isSet()) \
+    { \
+        const QList<qevercloud::Guid> & expunged = syncChunk.expungedGuids.ref(); \
+        for(auto it = expunged.constBegin(), end = expunged.constEnd(); it != end; ++it) { \
+            Q_UNUSED(syncedGuids.guids.remove(*it)) \
+        } \
+    }
+
+    REMOVE_EXPUNGED_GUIDS(expungedNotebooks, m_syncedNotebookGuids)
+    REMOVE_EXPUNGED_GUIDS(expungedTags, m_syncedTagGuids)
+    REMOVE_EXPUNGED_GUIDS(expungedNotes, m_syncedNoteGuids)
+    REMOVE_EXPUNGED_GUIDS(expungedSearches, m_syncedSavedSearchGuids)
+
+#undef REMOVE_EXPUNGED_GUIDS
 }
 
 void RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpunger()
@@ -4372,8 +5182,6 @@ void RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpunger()
     }
 
     m_pFullSyncStaleDataItemsExpunger = new FullSyncStaleDataItemsExpunger(m_manager.localStorageManagerAsync(),
-                                                                           m_notebookSyncCache, m_tagSyncCache,
-                                                                           m_savedSearchSyncCache,
                                                                            m_fullSyncStaleDataItemsSyncedGuids,
                                                                            QString(), this);
     QObject::connect(m_pFullSyncStaleDataItemsExpunger, QNSIGNAL(FullSyncStaleDataItemsExpunger,finished),
@@ -4381,6 +5189,7 @@ void RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpunger()
     QObject::connect(m_pFullSyncStaleDataItemsExpunger, QNSIGNAL(FullSyncStaleDataItemsExpunger,failure,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onFullSyncStaleDataItemsExpungerFailure,ErrorString));
     QNDEBUG(QStringLiteral("Starting FullSyncStaleDataItemsExpunger for user's own content"));
+    beginSyncTraceSpan(SyncTracer::Phase::Expunge, QStringLiteral("FullSyncStaleDataItems/"));
     m_pFullSyncStaleDataItemsExpunger->start();
 }
 
@@ -4419,7 +5228,8 @@ bool RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpungersF
                 << QStringLiteral(" were fully synced after being fully synced in the past, need to seek for stale data items and expunge them"));
         foundLinkedNotebookEligibleForFullSyncStaleDataItemsExpunging = true;
 
-        FullSyncStaleDataItemsExpunger::SyncedGuids syncedGuids;
+        FullSyncStaleDataItemsExpunger::SyncedGuids syncedGuids =
+            m_fullSyncStaleDataItemsSyncedGuidsByLinkedNotebookGuid.value(linkedNotebookGuid);
 
         for(auto nit = m_linkedNotebookGuidsByNotebookGuids.constBegin(), nend = m_linkedNotebookGuidsByNotebookGuids.constEnd(); nit != nend; ++nit)
         {
@@ -4430,14 +5240,6 @@ bool RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpungersF
 
             const QString & notebookGuid = nit.key();
             Q_UNUSED(syncedGuids.m_syncedNotebookGuids.insert(notebookGuid))
-
-            for(auto noteIt = m_notes.constBegin(), noteEnd = m_notes.constEnd(); noteIt != noteEnd; ++noteIt)
-            {
-                const qevercloud::Note & note = *noteIt;
-                if (note.guid.isSet() && note.notebookGuid.isSet() && (note.notebookGuid.ref() == notebookGuid)) {
-                    Q_UNUSED(syncedGuids.m_syncedNoteGuids.insert(note.guid.ref()))
-                }
-            }
         }
 
         for(auto tit = m_linkedNotebookGuidsByTagGuids.constBegin(), tend = m_linkedNotebookGuidsByTagGuids.constEnd(); tit != tend; ++tit)
@@ -4451,23 +5253,8 @@ bool RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpungersF
             Q_UNUSED(syncedGuids.m_syncedTagGuids.insert(tagGuid))
         }
 
-        auto notebookSyncCacheIt = m_notebookSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-        if (notebookSyncCacheIt == m_notebookSyncCachesByLinkedNotebookGuids.end()) {
-            NotebookSyncCache * pNotebookSyncCache = new NotebookSyncCache(m_manager.localStorageManagerAsync(), linkedNotebookGuid, this);
-            notebookSyncCacheIt = m_notebookSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pNotebookSyncCache);
-        }
-
-        auto tagSyncCacheIt = m_tagSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-        if (tagSyncCacheIt == m_tagSyncCachesByLinkedNotebookGuids.end()) {
-            TagSyncCache * pTagSyncCache = new TagSyncCache(m_manager.localStorageManagerAsync(), linkedNotebookGuid, this);
-            tagSyncCacheIt = m_tagSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pTagSyncCache);
-        }
-
         FullSyncStaleDataItemsExpunger * pExpunger = new FullSyncStaleDataItemsExpunger(m_manager.localStorageManagerAsync(),
-                                                                                        *notebookSyncCacheIt.value(),
-                                                                                        *tagSyncCacheIt.value(),
-                                                                                        m_savedSearchSyncCache, syncedGuids,
-                                                                                        linkedNotebookGuid, this);
+                                                                                        syncedGuids, linkedNotebookGuid, this);
         m_fullSyncStaleDataItemsExpungersByLinkedNotebookGuid[linkedNotebookGuid] = pExpunger;
         QObject::connect(pExpunger, QNSIGNAL(FullSyncStaleDataItemsExpunger,finished),
                          this, QNSLOT(RemoteToLocalSynchronizationManager,onFullSyncStaleDataItemsExpungerFinished));
@@ -4475,6 +5262,7 @@ bool RemoteToLocalSynchronizationManager::launchFullSyncStaleDataItemsExpungersF
                          this, QNSLOT(RemoteToLocalSynchronizationManager,onFullSyncStaleDataItemsExpungerFailure,ErrorString));
         QNDEBUG(QStringLiteral("Starting FullSyncStaleDataItemsExpunger for the content from linked notebook with guid ")
                 << linkedNotebookGuid);
+        beginSyncTraceSpan(SyncTracer::Phase::Expunge, QStringLiteral("FullSyncStaleDataItems/") + linkedNotebookGuid);
         pExpunger->start();
     }
 
@@ -4491,82 +5279,226 @@ void RemoteToLocalSynchronizationManager::launchExpungingOfNotelessTagsFromLinke
     Q_EMIT expungeNotelessTagsFromLinkedNotebooks(m_expungeNotelessTagsRequestId);
 }
 
-bool RemoteToLocalSynchronizationManager::syncingLinkedNotebooksContent() const
+QString RemoteToLocalSynchronizationManager::syncCheckpointFilePath() const
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::syncingLinkedNotebooksContent: last sync mode = ")
-            << m_lastSyncMode << QStringLiteral(", full note contents downloaded = ")
-            << (m_fullNoteContentsDownloaded ? QStringLiteral("true") : QStringLiteral("false"))
-            << QStringLiteral(", expunged from server to client = ")
-            << (m_expungedFromServerToClient ? QStringLiteral("true") : QStringLiteral("false")));
+    return accountPersistentStoragePath(account()) + QStringLiteral("/syncCheckpoint.dat");
+}
 
-    if (m_lastSyncMode == SyncMode::FullSync) {
-        return m_fullNoteContentsDownloaded;
+void RemoteToLocalSynchronizationManager::readSyncCheckpoint()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::readSyncCheckpoint"));
+
+    ErrorString errorDescription;
+    if (!m_syncCheckpoint.read(syncCheckpointFilePath(), errorDescription)) {
+        // NOTE: not a reason to fail the sync, it would just need to download everything once again
+        QNWARNING(QStringLiteral("Failed to read the sync checkpoint, ignoring it: ") << errorDescription);
+        m_syncCheckpoint.clear();
+        return;
     }
 
-    return m_expungedFromServerToClient;
+    if (!m_syncCheckpoint.isEmpty()) {
+        QNINFO(QStringLiteral("Resuming the interrupted sync: ") << m_syncCheckpoint);
+    }
 }
 
-void RemoteToLocalSynchronizationManager::checkAndIncrementNoteDownloadProgress(const QString & noteGuid)
+void RemoteToLocalSynchronizationManager::writeSyncCheckpoint()
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkAndIncrementNoteDownloadProgress: note guid = ") << noteGuid);
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::writeSyncCheckpoint: ") << m_syncCheckpoint);
 
-    if (m_originalNumberOfNotes == 0) {
-        QNDEBUG(QStringLiteral("No notes to download"));
-        return;
+    if (m_active && (m_lastSyncMode == SyncMode::FullSync)) {
+        m_syncCheckpoint.setFullSyncInProgress(fullSyncAfterUsn(), m_fullSyncStaleDataItemsSyncedGuids);
     }
 
-    if (m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.contains(noteGuid)) {
-        QNDEBUG(QStringLiteral("Found still pending ink note image download(s) for this note guid, won't increment the note download progress"));
+    if (!m_syncCheckpoint.isModified()) {
         return;
     }
 
-    if (m_notesPendingThumbnailDownloadByGuid.contains(noteGuid)) {
-        QNDEBUG(QStringLiteral("Found still pending note thumbnail download for this note guid, won't increment the note download progress"));
-        return;
+    ErrorString errorDescription;
+    if (!m_syncCheckpoint.write(syncCheckpointFilePath(), errorDescription)) {
+        // NOTE: not a reason to fail the sync, the previous checkpoint, if any, is still consistent
+        QNWARNING(QStringLiteral("Failed to write the sync checkpoint: ") << errorDescription);
     }
+}
 
-    if (Q_UNLIKELY(m_numNotesDownloaded == m_originalNumberOfNotes)) {
-        QNWARNING(QStringLiteral("The count of downloaded notes (") << m_numNotesDownloaded
-                  << QStringLiteral(") is already equal to the original number of notes (")
-                  << m_originalNumberOfNotes << QStringLiteral("), won't increment it further"));
+void RemoteToLocalSynchronizationManager::startSyncCheckpointTimer()
+{
+    if (m_syncCheckpointTimerId != 0) {
         return;
     }
 
-    ++m_numNotesDownloaded;
-    QNTRACE(QStringLiteral("Incremented the number of downloaded notes to ")
-            << m_numNotesDownloaded << QStringLiteral(", the total number of notes to download = ")
-            << m_originalNumberOfNotes);
-
-    if (syncingLinkedNotebooksContent()) {
-        Q_EMIT linkedNotebooksNotesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
-    }
-    else {
-        Q_EMIT notesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
+    m_syncCheckpointTimerId = startTimer(SYNC_CHECKPOINT_INTERVAL_MSEC);
+    if (Q_UNLIKELY(m_syncCheckpointTimerId == 0)) {
+        QNWARNING(QStringLiteral("Failed to start the timer to write the sync checkpoint"));
     }
 }
 
-void RemoteToLocalSynchronizationManager::checkAndIncrementResourceDownloadProgress(const QString & resourceGuid)
+qint32 RemoteToLocalSynchronizationManager::fullSyncAfterUsn() const
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkAndIncrementResourceDownloadProgress: resource guid = ")
-            << resourceGuid);
+    if (m_fullNoteContentsDownloaded) {
+        // All the data items from user's own account are already within the local storage
+        return m_lastUpdateCount;
+    }
 
-    if (m_originalNumberOfResources == 0) {
-        QNDEBUG(QStringLiteral("No resources to download"));
-        return;
+    qint32 afterUsn = m_syncCheckpoint.fullSyncAfterUsn();
+    if (!m_syncChunksDownloaded) {
+        return afterUsn;
     }
 
-    for(auto it = m_resourceGuidsPendingFindNotebookForInkNoteImageDownloadPerNoteGuid.constBegin(),
-        end = m_resourceGuidsPendingFindNotebookForInkNoteImageDownloadPerNoteGuid.constEnd(); it != end; ++it)
-    {
-        if (it.value() == resourceGuid) {
-            QNDEBUG(QStringLiteral("The resource is still pending finding notebook for ink note image downloading"));
-            return;
-        }
+    qint32 smallestUsn = nonProcessedItemsSmallestUsn();
+    if (smallestUsn > 0) {
+        // NOTE: decrement this USN because that would give the USN *after which* the full sync should be resumed
+        afterUsn = std::max(afterUsn, smallestUsn - 1);
     }
 
-    if (Q_UNLIKELY(m_numResourcesDownloaded == m_originalNumberOfResources)) {
-        QNWARNING(QStringLiteral("The count of downloaded resources (") << m_numResourcesDownloaded
-                  << QStringLiteral(") is already equal to the original number of resources (")
+    return afterUsn;
+}
+
+bool RemoteToLocalSynchronizationManager::shouldSkipItemsFromSyncCheckpoint() const
+{
+    // NOTE: after the full sync the local items not listed within the sync chunks are considered stale and get expunged,
+    // so the items from the checkpoint must not be filtered out of the sync chunks in this case
+    return (m_lastSyncMode == SyncMode::IncrementalSync) && m_linkedNotebookGuidsForWhichFullSyncWasPerformed.isEmpty();
+}
+
+SelectiveSyncFilter RemoteToLocalSynchronizationManager::appliedSelectiveSyncFilter() const
+{
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    QStringList notebookGuids = appSettings.value(APPLIED_SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY).toStringList();
+    QStringList tagGuids = appSettings.value(APPLIED_SELECTIVE_SYNC_TAG_GUIDS_KEY).toStringList();
+    appSettings.endGroup();
+    return SelectiveSyncFilter(notebookGuids, tagGuids);
+}
+
+void RemoteToLocalSynchronizationManager::persistAppliedSelectiveSyncFilter()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::persistAppliedSelectiveSyncFilter: ") << m_selectiveSyncFilter);
+
+    ApplicationSettings appSettings(account(), SYNCHRONIZATION_PERSISTENCE_NAME);
+    appSettings.beginGroup(SYNC_SETTINGS_KEY_GROUP);
+    appSettings.setValue(APPLIED_SELECTIVE_SYNC_NOTEBOOK_GUIDS_KEY, m_selectiveSyncFilter.notebookGuids());
+    appSettings.setValue(APPLIED_SELECTIVE_SYNC_TAG_GUIDS_KEY, m_selectiveSyncFilter.tagGuids());
+    appSettings.endGroup();
+
+    m_appliedSelectiveSyncFilter = m_selectiveSyncFilter;
+}
+
+void RemoteToLocalSynchronizationManager::removeNotesSyncedBeforeSelectiveSyncFilterChange(QList<qevercloud::Note> & notes,
+                                                                                          const qint32 lastPreviousUsn) const
+{
+    for(auto it = notes.begin(); it != notes.end(); )
+    {
+        const qevercloud::Note & note = *it;
+        if (note.updateSequenceNum.isSet() && (note.updateSequenceNum.ref() <= lastPreviousUsn) &&
+            m_appliedSelectiveSyncFilter.matchesNote(note))
+        {
+            it = notes.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+bool RemoteToLocalSynchronizationManager::shouldSkipNewNoteDueToSelectiveSyncFilter(const qevercloud::Note & note) const
+{
+    return !m_selectiveSyncFilter.isEmpty() && !m_selectiveSyncFilter.matchesNote(note);
+}
+
+void RemoteToLocalSynchronizationManager::skipNewNoteDueToSelectiveSyncFilter(const qevercloud::Note & note)
+{
+    QString noteGuid = (note.guid.isSet() ? note.guid.ref() : QString());
+    QNTRACE(QStringLiteral("Skipping the note not selected by the selective sync filter and not present within "
+                           "the local storage: ") << noteGuid);
+
+    if (!noteGuid.isEmpty()) {
+        m_notebookGuidsBySelectiveSyncSkippedNoteGuids[noteGuid] =
+            (note.notebookGuid.isSet() ? note.notebookGuid.ref() : QString());
+    }
+
+    checkAndIncrementNoteDownloadProgress(noteGuid);
+}
+
+bool RemoteToLocalSynchronizationManager::syncingLinkedNotebooksContent() const
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::syncingLinkedNotebooksContent: last sync mode = ")
+            << m_lastSyncMode << QStringLiteral(", full note contents downloaded = ")
+            << (m_fullNoteContentsDownloaded ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", expunged from server to client = ")
+            << (m_expungedFromServerToClient ? QStringLiteral("true") : QStringLiteral("false")));
+
+    if (m_lastSyncMode == SyncMode::FullSync) {
+        return m_fullNoteContentsDownloaded;
+    }
+
+    return m_expungedFromServerToClient;
+}
+
+void RemoteToLocalSynchronizationManager::checkAndIncrementNoteDownloadProgress(const QString & noteGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkAndIncrementNoteDownloadProgress: note guid = ") << noteGuid);
+
+    if (m_originalNumberOfNotes == 0) {
+        QNDEBUG(QStringLiteral("No notes to download"));
+        return;
+    }
+
+    if (m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.contains(noteGuid)) {
+        QNDEBUG(QStringLiteral("Found still pending ink note image download(s) for this note guid, won't increment the note download progress"));
+        return;
+    }
+
+    if (m_notesPendingThumbnailDownloadByGuid.contains(noteGuid)) {
+        QNDEBUG(QStringLiteral("Found still pending note thumbnail download for this note guid, won't increment the note download progress"));
+        return;
+    }
+
+    onNoteTakenFromSyncChunkProcessed(noteGuid);
+
+    if (Q_UNLIKELY(m_numNotesDownloaded == m_originalNumberOfNotes)) {
+        QNWARNING(QStringLiteral("The count of downloaded notes (") << m_numNotesDownloaded
+                  << QStringLiteral(") is already equal to the original number of notes (")
+                  << m_originalNumberOfNotes << QStringLiteral("), won't increment it further"));
+        return;
+    }
+
+    ++m_numNotesDownloaded;
+    QNTRACE(QStringLiteral("Incremented the number of downloaded notes to ")
+            << m_numNotesDownloaded << QStringLiteral(", the total number of notes to download = ")
+            << m_originalNumberOfNotes);
+
+    if (syncingLinkedNotebooksContent()) {
+        Q_EMIT linkedNotebooksNotesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
+    }
+    else {
+        Q_EMIT notesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
+    }
+}
+
+void RemoteToLocalSynchronizationManager::checkAndIncrementResourceDownloadProgress(const QString & resourceGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkAndIncrementResourceDownloadProgress: resource guid = ")
+            << resourceGuid);
+
+    if (m_originalNumberOfResources == 0) {
+        QNDEBUG(QStringLiteral("No resources to download"));
+        return;
+    }
+
+    for(auto it = m_resourceGuidsPendingFindNotebookForInkNoteImageDownloadPerNoteGuid.constBegin(),
+        end = m_resourceGuidsPendingFindNotebookForInkNoteImageDownloadPerNoteGuid.constEnd(); it != end; ++it)
+    {
+        if (it.value() == resourceGuid) {
+            QNDEBUG(QStringLiteral("The resource is still pending finding notebook for ink note image downloading"));
+            return;
+        }
+    }
+
+    onResourceTakenFromSyncChunkProcessed(resourceGuid);
+
+    if (Q_UNLIKELY(m_numResourcesDownloaded == m_originalNumberOfResources)) {
+        QNWARNING(QStringLiteral("The count of downloaded resources (") << m_numResourcesDownloaded
+                  << QStringLiteral(") is already equal to the original number of resources (")
                   << m_originalNumberOfResources << QStringLiteral("(, won't increment it further"));
         return;
     }
@@ -4635,14 +5567,14 @@ bool RemoteToLocalSynchronizationManager::notesSyncInProgress() const
             !m_addNoteRequestIds.isEmpty() ||
             !m_updateNoteRequestIds.isEmpty() ||
             !m_expungeNoteRequestIds.isEmpty() ||
-            !m_notesToAddPerAPICallPostponeTimerId.isEmpty() ||
-            !m_notesToUpdatePerAPICallPostponeTimerId.isEmpty() ||
             !m_guidsOfNotesPendingDownloadForAddingToLocalStorage.isEmpty() ||
             !m_notesPendingDownloadForUpdatingInLocalStorageByGuid.isEmpty() ||
+            !m_notesPendingLocalResourceDataByFindNoteRequestId.isEmpty() ||
             !m_notesPendingInkNoteImagesDownloadByFindNotebookRequestId.isEmpty() ||
             !m_notesPendingThumbnailDownloadByFindNotebookRequestId.isEmpty() ||
             !m_notesPendingThumbnailDownloadByGuid.isEmpty() ||
-            !m_updateNoteWithThumbnailRequestIds.isEmpty());
+            !m_updateNoteWithThumbnailRequestIds.isEmpty() ||
+            notesPendingTakingFromSyncChunks());
 }
 
 bool RemoteToLocalSynchronizationManager::resourcesSyncInProgress() const
@@ -4656,9 +5588,8 @@ bool RemoteToLocalSynchronizationManager::resourcesSyncInProgress() const
             !m_inkNoteResourceDataPerFindNotebookRequestId.isEmpty() ||
             !m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid.isEmpty() ||
             !m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid.isEmpty() ||
-            !m_resourcesToAddWithNotesPerAPICallPostponeTimerId.isEmpty() ||
-            !m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.isEmpty() ||
-            !m_postponedConflictingResourceDataPerAPICallPostponeTimerId.isEmpty());
+            !m_postponedConflictingResourceDataPerAPICallPostponeTimerId.isEmpty() ||
+            resourcesPendingTakingFromSyncChunks());
 }
 
 QTextStream & operator<<(QTextStream & strm, const RemoteToLocalSynchronizationManager::ContentSource::type & obj)
@@ -4694,6 +5625,7 @@ void RemoteToLocalSynchronizationManager::checkNotebooksAndTagsSyncCompletionAnd
 
 void RemoteToLocalSynchronizationManager::launchNotesSync(const ContentSource::type & contentSource)
 {
+    beginSyncTraceMergePhaseSpan(SyncTracer::Phase::NotesMerge);
     launchDataElementSync<NotesList, Note>(contentSource, QStringLiteral("Note"), m_notes, m_expungedNotes);
 }
 
@@ -4727,6 +5659,7 @@ void RemoteToLocalSynchronizationManager::launchResourcesSync()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchResourcesSync"));
     QList<QString> dummyList;
+    beginSyncTraceMergePhaseSpan(SyncTracer::Phase::ResourcesMerge);
     launchDataElementSync<ResourcesList, Resource>(ContentSource::UserAccount, QStringLiteral("Resource"), m_resources, dummyList);
 }
 
@@ -4794,8 +5727,8 @@ bool RemoteToLocalSynchronizationManager::mapContainerElementsWithLinkedNotebook
 }
 
 template <>
-bool RemoteToLocalSynchronizationManager::mapContainerElementsWithLinkedNotebookGuid<RemoteToLocalSynchronizationManager::NotebooksList>(const QString & linkedNotebookGuid,
-                                                                                                                                         const RemoteToLocalSynchronizationManager::NotebooksList & notebooks)
+bool RemoteToLocalSynchronizationManager::mapContainerElementsWithLinkedNotebookGuid<QList<qevercloud::Notebook> >(const QString & linkedNotebookGuid,
+                                                                                                                         const QList<qevercloud::Notebook> & notebooks)
 {
     const int numNotebooks = notebooks.size();
     for(int i = 0; i < numNotebooks; ++i)
@@ -5044,7 +5977,7 @@ void RemoteToLocalSynchronizationManager::getLinkedNotebookSyncState(const Linke
         return;
     }
 
-    NoteStore * pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
+    INoteStore * pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
     if (Q_UNLIKELY(!pNoteStore)) {
         errorDescription.setBase(QT_TR_NOOP("Can't find or create note store for the linked notebook"));
         Q_EMIT failure(errorDescription);
@@ -5117,246 +6050,550 @@ bool RemoteToLocalSynchronizationManager::downloadLinkedNotebooksSyncChunks()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::downloadLinkedNotebooksSyncChunks"));
 
-    qevercloud::SyncChunk * pSyncChunk = Q_NULLPTR;
+    if (m_linkedNotebooksSyncChunksDownloaded) {
+        QNDEBUG(QStringLiteral("The linked notebooks sync chunks were already downloaded"));
+        return true;
+    }
 
-    const int numAllLinkedNotebooks = m_allLinkedNotebooks.size();
-    for(int i = 0; i < numAllLinkedNotebooks; ++i)
+    if (!m_linkedNotebooksSyncChunksDownloadStarted)
     {
-        const LinkedNotebook & linkedNotebook = m_allLinkedNotebooks[i];
-        if (!linkedNotebook.hasGuid())
+        m_linkedNotebookGuidsPendingSyncChunksDownload.clear();
+
+        const int numAllLinkedNotebooks = m_allLinkedNotebooks.size();
+        for(int i = 0; i < numAllLinkedNotebooks; ++i)
         {
-            ErrorString error(QT_TR_NOOP("Internal error: found linked notebook without guid when "
-                                         "trying to download the linked notebook sync chunks"));
-            if (linkedNotebook.hasUsername()) {
-                error.details() = linkedNotebook.username();
+            const LinkedNotebook & linkedNotebook = m_allLinkedNotebooks[i];
+            if (!linkedNotebook.hasGuid())
+            {
+                ErrorString error(QT_TR_NOOP("Internal error: found linked notebook without guid when "
+                                             "trying to download the linked notebook sync chunks"));
+                if (linkedNotebook.hasUsername()) {
+                    error.details() = linkedNotebook.username();
+                }
+
+                QNWARNING(error << QStringLiteral(": ") << linkedNotebook);
+                Q_EMIT failure(error);
+                return false;
             }
 
-            QNWARNING(error << QStringLiteral(": ") << linkedNotebook);
-            Q_EMIT failure(error);
-            return false;
+            const QString & linkedNotebookGuid = linkedNotebook.guid();
+            if (m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.contains(linkedNotebookGuid)) {
+                QNDEBUG(QStringLiteral("Sync chunks were already downloaded for linked notebook with guid ") << linkedNotebookGuid);
+                continue;
+            }
+
+            m_linkedNotebookGuidsPendingSyncChunksDownload << linkedNotebookGuid;
         }
 
-        const QString & linkedNotebookGuid = linkedNotebook.guid();
+        m_linkedNotebooksSyncChunksDownloadStarted = true;
+    }
 
-        bool fullSyncOnly = false;
+    if (!scheduleLinkedNotebooksSyncChunksDownloads()) {
+        return false;
+    }
 
-        auto lastSyncTimeIt = m_lastSyncTimeByLinkedNotebookGuid.find(linkedNotebookGuid);
-        if (lastSyncTimeIt == m_lastSyncTimeByLinkedNotebookGuid.end()) {
-            lastSyncTimeIt = m_lastSyncTimeByLinkedNotebookGuid.insert(linkedNotebookGuid, 0);
-        }
-        qevercloud::Timestamp lastSyncTime = lastSyncTimeIt.value();
+    if (!m_linkedNotebookGuidsPendingSyncChunksDownload.isEmpty() || !m_linkedNotebookSyncChunksDownloadsByGuid.isEmpty()) {
+        QNDEBUG(QStringLiteral("Waiting for the sync chunks of ") << m_linkedNotebookSyncChunksDownloadsByGuid.size()
+                << QStringLiteral(" linked notebooks being downloaded, ") << m_linkedNotebookGuidsPendingSyncChunksDownload.size()
+                << QStringLiteral(" more linked notebooks are pending"));
+        return false;
+    }
 
-        auto lastUpdateCountIt = m_lastUpdateCountByLinkedNotebookGuid.find(linkedNotebookGuid);
-        if (lastUpdateCountIt == m_lastUpdateCountByLinkedNotebookGuid.end()) {
-            lastUpdateCountIt = m_lastUpdateCountByLinkedNotebookGuid.insert(linkedNotebookGuid, 0);
-        }
-        qint32 lastUpdateCount = lastUpdateCountIt.value();
+    finalizeLinkedNotebooksSyncChunksDownload();
+    return true;
+}
 
-        auto syncChunksDownloadedFlagIt = m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.find(linkedNotebookGuid);
-        if (syncChunksDownloadedFlagIt != m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.end()) {
-            QNDEBUG(QStringLiteral("Sync chunks were already downloaded for linked notebook with guid ") << linkedNotebookGuid);
-            continue;
-        }
+bool RemoteToLocalSynchronizationManager::scheduleLinkedNotebooksSyncChunksDownloads()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::scheduleLinkedNotebooksSyncChunksDownloads: ")
+            << m_linkedNotebookGuidsPendingSyncChunksDownload.size() << QStringLiteral(" pending, ")
+            << m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.size() << QStringLiteral(" in flight, max parallel = ")
+            << m_maxParallelLinkedNotebookSyncs);
 
-        qint32 afterUsn = lastUpdateCount;
-        qint32 lastPreviousUsn = std::max(lastUpdateCount, 0);
-        QNDEBUG(QStringLiteral("Last previous USN for current linked notebook = ") << lastPreviousUsn
-                << QStringLiteral(" (linked notebook guid = ") << linkedNotebookGuid
-                << QStringLiteral(")"));
+    if (m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId != 0) {
+        QNDEBUG(QStringLiteral("The requests to Evernote API are postponed due to rate limit exceeding"));
+        return true;
+    }
+
+    while(!m_linkedNotebookGuidsPendingSyncChunksDownload.isEmpty() &&
+          (m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.size() < m_maxParallelLinkedNotebookSyncs))
+    {
+        QString linkedNotebookGuid = m_linkedNotebookGuidsPendingSyncChunksDownload.takeFirst();
 
-        if (m_onceSyncDone || (afterUsn != 0))
+        auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+        if (it == m_linkedNotebookSyncChunksDownloadsByGuid.end())
         {
-            auto syncStateIter = m_syncStatesByLinkedNotebookGuid.find(linkedNotebookGuid);
-            if (syncStateIter == m_syncStatesByLinkedNotebookGuid.end())
+            const LinkedNotebook * pLinkedNotebook = Q_NULLPTR;
+            for(auto lit = m_allLinkedNotebooks.constBegin(), lend = m_allLinkedNotebooks.constEnd(); lit != lend; ++lit)
             {
-                QNTRACE(QStringLiteral("Found no cached sync state for linked notebook guid ") << linkedNotebookGuid
-                        << QStringLiteral(", will try to receive it from the remote service"));
-
-                qevercloud::SyncState syncState;
-                bool error = false;
-                bool asyncWait = false;
-                getLinkedNotebookSyncState(linkedNotebook, m_authenticationToken, syncState, asyncWait, error);
-                if (asyncWait || error) {
-                    QNTRACE(QStringLiteral("Async wait = ") << (asyncWait ? QStringLiteral("true") : QStringLiteral("false"))
-                            << QStringLiteral(", error = ") << (error ? QStringLiteral("true") : QStringLiteral("false")));
-                    return false;
+                if (lit->hasGuid() && (lit->guid() == linkedNotebookGuid)) {
+                    pLinkedNotebook = &(*lit);
+                    break;
                 }
-
-                syncStateIter = m_syncStatesByLinkedNotebookGuid.insert(linkedNotebookGuid, syncState);
             }
 
-            const qevercloud::SyncState & syncState = syncStateIter.value();
-            QNDEBUG(QStringLiteral("Sync state: ") << syncState
-                    << QStringLiteral("\nLast sync time = ") << printableDateTimeFromTimestamp(lastSyncTime)
-                    << QStringLiteral(", last update count = ") << lastUpdateCount);
-
-            if (syncState.fullSyncBefore > lastSyncTime)
-            {
-                QNDEBUG(QStringLiteral("Linked notebook sync state says the time has come to do the full sync"));
-                afterUsn = 0;
-                fullSyncOnly = true;
-            }
-            else if (syncState.updateCount == lastUpdateCount)
-            {
-                QNDEBUG(QStringLiteral("Server has no updates for data in this linked notebook, continuing with the next one"));
-                Q_UNUSED(m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.insert(linkedNotebookGuid));
+            if (Q_UNLIKELY(!pLinkedNotebook)) {
+                QNWARNING(QStringLiteral("Can't find the linked notebook with guid ") << linkedNotebookGuid
+                          << QStringLiteral(" pending the sync chunks download, skipping it"));
                 continue;
             }
-        }
-
-        NoteStore * pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
-        if (Q_UNLIKELY(!pNoteStore)) {
-            ErrorString error(QT_TR_NOOP("Can't find or create note store for the linked notebook"));
-            Q_EMIT failure(error);
-            return false;
-        }
 
-        if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
-            ErrorString errorDescription(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
-            Q_EMIT failure(errorDescription);
-            return false;
-        }
+            LinkedNotebookSyncChunksDownload download;
+            download.m_linkedNotebook = *pLinkedNotebook;
 
-        while(!pSyncChunk || (pSyncChunk->chunkHighUSN < pSyncChunk->updateCount))
-        {
-            if (pSyncChunk) {
-                afterUsn = pSyncChunk->chunkHighUSN;
-                QNTRACE(QStringLiteral("Updated afterUSN for linked notebook to sync chunk's high USN: ")
-                        << pSyncChunk->chunkHighUSN);
+            auto lastSyncTimeIt = m_lastSyncTimeByLinkedNotebookGuid.find(linkedNotebookGuid);
+            if (lastSyncTimeIt == m_lastSyncTimeByLinkedNotebookGuid.end()) {
+                lastSyncTimeIt = m_lastSyncTimeByLinkedNotebookGuid.insert(linkedNotebookGuid, 0);
             }
+            download.m_lastSyncTime = lastSyncTimeIt.value();
 
-            m_linkedNotebookSyncChunks.push_back(qevercloud::SyncChunk());
-            pSyncChunk = &(m_linkedNotebookSyncChunks.back());
-
-            ErrorString errorDescription;
-            qint32 rateLimitSeconds = 0;
-            qint32 errorCode = pNoteStore->getLinkedNotebookSyncChunk(linkedNotebook.qevercloudLinkedNotebook(),
-                                                                      afterUsn, m_maxSyncChunksPerOneDownload,
-                                                                      m_authenticationToken, fullSyncOnly, *pSyncChunk,
-                                                                      errorDescription, rateLimitSeconds);
-            if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
-            {
-                if (rateLimitSeconds <= 0) {
-                    errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
-                    errorDescription.details() = QString::number(rateLimitSeconds);
-                    Q_EMIT failure(errorDescription);
-                    return false;
-                }
+            auto lastUpdateCountIt = m_lastUpdateCountByLinkedNotebookGuid.find(linkedNotebookGuid);
+            if (lastUpdateCountIt == m_lastUpdateCountByLinkedNotebookGuid.end()) {
+                lastUpdateCountIt = m_lastUpdateCountByLinkedNotebookGuid.insert(linkedNotebookGuid, 0);
+            }
+            download.m_lastUpdateCount = lastUpdateCountIt.value();
+
+            download.m_afterUsn = download.m_lastUpdateCount;
+            download.m_lastPreviousUsn = std::max(download.m_lastUpdateCount, 0);
+            download.m_needSyncState = (m_onceSyncDone || (download.m_afterUsn != 0));
+
+            if (m_selectiveSyncBackfillPending && (download.m_afterUsn > 0)) {
+                // The notes skipped by the previous syncs due to the selective sync filter are picked from the linked
+                // notebook's sync chunks downloaded from scratch, the notes synced before are dropped from them
+                QNDEBUG(QStringLiteral("Downloading all sync chunks of linked notebook with guid ") << linkedNotebookGuid
+                        << QStringLiteral(" due to the widened selective sync filter"));
+                download.m_afterUsn = 0;
+                download.m_needSyncState = false;
+            }
 
-                m_linkedNotebookSyncChunks.pop_back();
-
-                int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-                if (Q_UNLIKELY(timerId == 0)) {
-                    ErrorString errorMessage(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
-                                                        "due to rate limit exceeding"));
-                    errorMessage.additionalBases().append(errorDescription.base());
-                    errorMessage.additionalBases().append(errorDescription.additionalBases());
-                    errorMessage.details() = errorDescription.details();
-                    Q_EMIT failure(errorMessage);
-                    return false;
-                }
+            QNDEBUG(QStringLiteral("Last previous USN for linked notebook = ") << download.m_lastPreviousUsn
+                    << QStringLiteral(" (linked notebook guid = ") << linkedNotebookGuid
+                    << QStringLiteral(")"));
 
-                m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId = timerId;
+            it = m_linkedNotebookSyncChunksDownloadsByGuid.insert(linkedNotebookGuid, download);
 
-                QNDEBUG(QStringLiteral("Rate limit exceeded, need to wait for ") << rateLimitSeconds << QStringLiteral(" seconds"));
-                Q_EMIT rateLimitExceeded(rateLimitSeconds);
-                return false;
-            }
-            else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-            {
-                ErrorString errorMessage(QT_TR_NOOP("Unexpected AUTH_EXPIRED error when trying to download "
-                                                    "the linked notebook sync chunks"));
-                errorMessage.additionalBases().append(errorDescription.base());
-                errorMessage.additionalBases().append(errorDescription.additionalBases());
-                errorMessage.details() = errorDescription.details();
-                QNDEBUG(errorMessage);
-                Q_EMIT failure(errorMessage);
-                return false;
-            }
-            else if (errorCode != 0)
+            auto syncStateIt = m_syncStatesByLinkedNotebookGuid.find(linkedNotebookGuid);
+            if (download.m_needSyncState && (syncStateIt != m_syncStatesByLinkedNotebookGuid.end()))
             {
-                ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks for linked notebooks content"));
-                errorMessage.additionalBases().append(errorDescription.base());
-                errorMessage.additionalBases().append(errorDescription.additionalBases());
-                errorMessage.details() = errorDescription.details();
-                QNDEBUG(errorMessage);
-                Q_EMIT failure(errorMessage);
-                return false;
+                it.value().m_needSyncState = false;
+                if (!processLinkedNotebookSyncState(linkedNotebookGuid, syncStateIt.value())) {
+                    // The linked notebook has no updates
+                    continue;
+                }
             }
+        }
 
-            QNDEBUG(QStringLiteral("Received sync chunk: ") << *pSyncChunk);
-
-            lastSyncTime = std::max(pSyncChunk->currentTime, lastSyncTime);
-            lastUpdateCount = std::max(pSyncChunk->updateCount, lastUpdateCount);
+        if (!requestNextLinkedNotebookSyncData(linkedNotebookGuid)) {
+            return false;
+        }
+    }
 
-            QNTRACE(QStringLiteral("Linked notebook's sync chunk current time: ") << printableDateTimeFromTimestamp(pSyncChunk->currentTime)
-                    << QStringLiteral(", last sync time = ") << printableDateTimeFromTimestamp(lastSyncTime)
-                    << QStringLiteral(", sync chunk update count = ") << pSyncChunk->updateCount
-                    << QStringLiteral(", last update count = ") << lastUpdateCount);
+    return true;
+}
 
-            Q_EMIT linkedNotebookSyncChunksDownloadProgress(pSyncChunk->chunkHighUSN, pSyncChunk->updateCount,
-                                                            lastPreviousUsn, linkedNotebook);
+bool RemoteToLocalSynchronizationManager::requestNextLinkedNotebookSyncData(const QString & linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::requestNextLinkedNotebookSyncData: linked notebook guid = ")
+            << linkedNotebookGuid);
 
-            if (pSyncChunk->tags.isSet())
-            {
-                bool res = mapContainerElementsWithLinkedNotebookGuid<TagsList>(linkedNotebookGuid, pSyncChunk->tags.ref());
-                if (!res) {
-                    return false;
-                }
-            }
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if (Q_UNLIKELY(it == m_linkedNotebookSyncChunksDownloadsByGuid.end())) {
+        ErrorString errorDescription(QT_TR_NOOP("Internal error: can't find the state of the linked notebook sync chunks download"));
+        errorDescription.details() = linkedNotebookGuid;
+        QNWARNING(errorDescription);
+        Q_EMIT failure(errorDescription);
+        return false;
+    }
 
-            if (pSyncChunk->notebooks.isSet())
-            {
-                bool res = mapContainerElementsWithLinkedNotebookGuid<NotebooksList>(linkedNotebookGuid, pSyncChunk->notebooks.ref());
-                if (!res) {
-                    return false;
-                }
-            }
+    const LinkedNotebookSyncChunksDownload & download = it.value();
+    const LinkedNotebook & linkedNotebook = download.m_linkedNotebook;
 
-            if (pSyncChunk->expungedTags.isSet()) {
-                unmapContainerElementsFromLinkedNotebookGuid<qevercloud::Tag>(pSyncChunk->expungedTags.ref());
-            }
+    INoteStore * pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
+    if (Q_UNLIKELY(!pNoteStore)) {
+        ErrorString error(QT_TR_NOOP("Can't find or create note store for the linked notebook"));
+        Q_EMIT failure(error);
+        return false;
+    }
 
-            if (pSyncChunk->expungedNotebooks.isSet()) {
-                unmapContainerElementsFromLinkedNotebookGuid<qevercloud::Notebook>(pSyncChunk->expungedNotebooks.ref());
-            }
-        }
+    if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
+        ErrorString errorDescription(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
+        Q_EMIT failure(errorDescription);
+        return false;
+    }
 
-        lastSyncTimeIt.value() = lastSyncTime;
-        lastUpdateCountIt.value() = lastUpdateCount;
+    ErrorString errorDescription;
+    bool res = false;
 
-        Q_UNUSED(m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.insert(linkedNotebook.guid()));
+    if (download.m_needSyncState)
+    {
+        QNTRACE(QStringLiteral("Found no cached sync state for linked notebook guid ") << linkedNotebookGuid
+                << QStringLiteral(", will try to receive it from the remote service"));
 
-        if (fullSyncOnly) {
-            Q_UNUSED(m_linkedNotebookGuidsForWhichFullSyncWasPerformed.insert(linkedNotebook.guid()))
-        }
+        QObject::connect(pNoteStore, QNSIGNAL(INoteStore,getLinkedNotebookSyncStateAsyncFinished,qint32,qevercloud::SyncState,qint32,ErrorString,QString),
+                         this, QNSLOT(RemoteToLocalSynchronizationManager,onGetLinkedNotebookSyncStateAsyncFinished,qint32,qevercloud::SyncState,qint32,ErrorString,QString),
+                         Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
-        pSyncChunk = Q_NULLPTR;
+        res = pNoteStore->getLinkedNotebookSyncStateAsync(linkedNotebook.qevercloudLinkedNotebook(), m_authenticationToken,
+                                                          errorDescription);
     }
+    else
+    {
+        QObject::connect(pNoteStore, QNSIGNAL(INoteStore,getLinkedNotebookSyncChunkAsyncFinished,qint32,qevercloud::SyncChunk,qint32,qint32,ErrorString,QString),
+                         this, QNSLOT(RemoteToLocalSynchronizationManager,onGetLinkedNotebookSyncChunkAsyncFinished,qint32,qevercloud::SyncChunk,qint32,qint32,ErrorString,QString),
+                         Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
-    QNDEBUG(QStringLiteral("Done. Processing content pointed to by linked notebooks from buffered sync chunks"));
+        beginSyncTraceSpan(SyncTracer::Phase::SyncChunksDownload,
+                           linkedNotebookGuid + QStringLiteral("/") + QString::number(download.m_afterUsn));
 
-    m_syncStatesByLinkedNotebookGuid.clear();   // don't need this anymore, it only served the purpose of preventing multiple get sync state calls for the same linked notebook
+        download.m_requestMaxEntries = m_linkedNotebookSyncChunkWindow.window();
+        download.m_requestTimestamp = QDateTime::currentMSecsSinceEpoch();
 
-    m_linkedNotebooksSyncChunksDownloaded = true;
-    Q_EMIT linkedNotebooksSyncChunksDownloaded();
+        res = pNoteStore->getLinkedNotebookSyncChunkAsync(linkedNotebook.qevercloudLinkedNotebook(), download.m_afterUsn,
+                                                          download.m_requestMaxEntries, m_authenticationToken,
+                                                          download.m_fullSyncOnly, errorDescription);
+    }
+
+    if (Q_UNLIKELY(!res)) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks for linked notebooks content"));
+        errorMessage.additionalBases().append(errorDescription.base());
+        errorMessage.additionalBases().append(errorDescription.additionalBases());
+        errorMessage.details() = errorDescription.details();
+        QNWARNING(errorMessage);
+        Q_EMIT failure(errorMessage);
+        return false;
+    }
 
+    Q_UNUSED(m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.insert(linkedNotebookGuid))
     return true;
 }
 
-void RemoteToLocalSynchronizationManager::launchLinkedNotebooksTagsSync()
+bool RemoteToLocalSynchronizationManager::processLinkedNotebookSyncState(const QString & linkedNotebookGuid,
+                                                                         const qevercloud::SyncState & syncState)
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchLinkedNotebooksTagsSync"));
-    m_pendingTagsSyncStart = false;
-    QList<QString> dummyList;
-    launchDataElementSync<TagsContainer, Tag>(ContentSource::LinkedNotebook, QStringLiteral("Tag"), m_tags, dummyList);
-}
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if (Q_UNLIKELY(it == m_linkedNotebookSyncChunksDownloadsByGuid.end())) {
+        return false;
+    }
 
-void RemoteToLocalSynchronizationManager::launchLinkedNotebooksNotebooksSync()
-{
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchLinkedNotebooksNotebooksSync"));
+    LinkedNotebookSyncChunksDownload & download = it.value();
 
-    m_pendingNotebooksSyncStart = false;
+    QNDEBUG(QStringLiteral("Sync state: ") << syncState
+            << QStringLiteral("\nLast sync time = ") << printableDateTimeFromTimestamp(download.m_lastSyncTime)
+            << QStringLiteral(", last update count = ") << download.m_lastUpdateCount
+            << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+
+    if (syncState.fullSyncBefore > download.m_lastSyncTime)
+    {
+        QNDEBUG(QStringLiteral("Linked notebook sync state says the time has come to do the full sync"));
+        download.m_afterUsn = 0;
+        download.m_fullSyncOnly = true;
+    }
+    else if (syncState.updateCount == download.m_lastUpdateCount)
+    {
+        QNDEBUG(QStringLiteral("Server has no updates for data in this linked notebook"));
+        finishLinkedNotebookSyncChunksDownload(linkedNotebookGuid);
+        return false;
+    }
+
+    return true;
+}
+
+void RemoteToLocalSynchronizationManager::onGetLinkedNotebookSyncStateAsyncFinished(qint32 errorCode, qevercloud::SyncState syncState,
+                                                                                    qint32 rateLimitSeconds, ErrorString errorDescription,
+                                                                                    QString linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onGetLinkedNotebookSyncStateAsyncFinished: error code = ")
+            << errorCode << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds
+            << QStringLiteral(", error description: ") << errorDescription
+            << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if ((it == m_linkedNotebookSyncChunksDownloadsByGuid.end()) || !it.value().m_needSyncState ||
+        !m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.contains(linkedNotebookGuid))
+    {
+        QNDEBUG(QStringLiteral("The linked notebook sync state was not expected, ignoring it"));
+        return;
+    }
+
+    Q_UNUSED(m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.remove(linkedNotebookGuid))
+
+    if (errorCode != 0) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to get the linked notebook sync state"));
+        errorMessage.additionalBases().append(errorDescription.base());
+        errorMessage.additionalBases().append(errorDescription.additionalBases());
+        errorMessage.details() = errorDescription.details();
+        processLinkedNotebookSyncDataDownloadError(linkedNotebookGuid, errorCode, rateLimitSeconds, errorMessage);
+        return;
+    }
+
+    it.value().m_needSyncState = false;
+    m_syncStatesByLinkedNotebookGuid[linkedNotebookGuid] = syncState;
+
+    if (!processLinkedNotebookSyncState(linkedNotebookGuid, syncState)) {
+        checkLinkedNotebooksSyncChunksDownloadCompletion();
+        return;
+    }
+
+    if (m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId != 0) {
+        m_linkedNotebookGuidsPendingSyncChunksDownload.prepend(linkedNotebookGuid);
+        return;
+    }
+
+    Q_UNUSED(requestNextLinkedNotebookSyncData(linkedNotebookGuid))
+}
+
+void RemoteToLocalSynchronizationManager::onGetLinkedNotebookSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk,
+                                                                                    qint32 afterUsn, qint32 rateLimitSeconds,
+                                                                                    ErrorString errorDescription, QString linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onGetLinkedNotebookSyncChunkAsyncFinished: error code = ")
+            << errorCode << QStringLiteral(", after USN = ") << afterUsn << QStringLiteral(", rate limit seconds = ")
+            << rateLimitSeconds << QStringLiteral(", error description: ") << errorDescription
+            << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if ((it == m_linkedNotebookSyncChunksDownloadsByGuid.end()) || it.value().m_needSyncState ||
+        (it.value().m_afterUsn != afterUsn) || !m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.contains(linkedNotebookGuid))
+    {
+        QNDEBUG(QStringLiteral("The linked notebook sync chunk was not expected, ignoring it"));
+        return;
+    }
+
+    Q_UNUSED(m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.remove(linkedNotebookGuid))
+    endSyncTraceSpan(SyncTracer::Phase::SyncChunksDownload, linkedNotebookGuid + QStringLiteral("/") + QString::number(afterUsn),
+                     (errorCode == 0 ? 1 : 0));
+
+    if (errorCode != 0) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks for linked notebooks content"));
+        errorMessage.additionalBases().append(errorDescription.base());
+        errorMessage.additionalBases().append(errorDescription.additionalBases());
+        errorMessage.details() = errorDescription.details();
+        processLinkedNotebookSyncDataDownloadError(linkedNotebookGuid, errorCode, rateLimitSeconds, errorMessage);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Received sync chunk: ") << syncChunk);
+
+    LinkedNotebookSyncChunksDownload & download = it.value();
+    download.m_lastSyncTime = std::max(syncChunk.currentTime, download.m_lastSyncTime);
+    download.m_lastUpdateCount = std::max(syncChunk.updateCount, download.m_lastUpdateCount);
+
+    QNTRACE(QStringLiteral("Linked notebook's sync chunk current time: ") << printableDateTimeFromTimestamp(syncChunk.currentTime)
+            << QStringLiteral(", last sync time = ") << printableDateTimeFromTimestamp(download.m_lastSyncTime)
+            << QStringLiteral(", sync chunk update count = ") << syncChunk.updateCount
+            << QStringLiteral(", last update count = ") << download.m_lastUpdateCount);
+
+    Q_EMIT linkedNotebookSyncChunksDownloadProgress(syncChunk.chunkHighUSN, syncChunk.updateCount,
+                                                    download.m_lastPreviousUsn, download.m_linkedNotebook);
+
+    if (syncChunk.tags.isSet())
+    {
+        bool res = mapContainerElementsWithLinkedNotebookGuid<TagsList>(linkedNotebookGuid, syncChunk.tags.ref());
+        if (!res) {
+            return;
+        }
+    }
+
+    if (syncChunk.notebooks.isSet())
+    {
+        bool res = mapContainerElementsWithLinkedNotebookGuid<QList<qevercloud::Notebook> >(linkedNotebookGuid, syncChunk.notebooks.ref());
+        if (!res) {
+            return;
+        }
+    }
+
+    if (syncChunk.expungedTags.isSet()) {
+        unmapContainerElementsFromLinkedNotebookGuid<qevercloud::Tag>(syncChunk.expungedTags.ref());
+    }
+
+    if (syncChunk.expungedNotebooks.isSet()) {
+        unmapContainerElementsFromLinkedNotebookGuid<qevercloud::Notebook>(syncChunk.expungedNotebooks.ref());
+    }
+
+    collectSyncedGuidsFromSyncChunk(syncChunk, m_fullSyncStaleDataItemsSyncedGuidsByLinkedNotebookGuid[linkedNotebookGuid]);
+
+    if (m_selectiveSyncBackfillPending && syncChunk.notes.isSet()) {
+        removeNotesSyncedBeforeSelectiveSyncFilterChange(syncChunk.notes.ref(), download.m_lastPreviousUsn);
+    }
+
+    ErrorString spoolErrorDescription;
+    if (!m_linkedNotebookSyncChunks.append(syncChunk, spoolErrorDescription)) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to store the downloaded sync chunk for linked notebooks content"));
+        errorMessage.additionalBases().append(spoolErrorDescription.base());
+        errorMessage.additionalBases().append(spoolErrorDescription.additionalBases());
+        errorMessage.details() = spoolErrorDescription.details();
+        Q_EMIT failure(errorMessage);
+        return;
+    }
+
+    m_linkedNotebookGuidsOfLinkedNotebookSyncChunks << linkedNotebookGuid;
+
+    m_linkedNotebookSyncChunkWindow.onSyncChunkDownloaded(download.m_requestMaxEntries,
+                                                          QDateTime::currentMSecsSinceEpoch() - download.m_requestTimestamp,
+                                                          m_linkedNotebookSyncChunks.estimatedMemoryUsage(m_linkedNotebookSyncChunks.size() - 1),
+                                                          (syncChunk.chunkHighUSN >= syncChunk.updateCount));
+
+    if (syncChunk.chunkHighUSN < syncChunk.updateCount)
+    {
+        download.m_afterUsn = syncChunk.chunkHighUSN;
+        QNTRACE(QStringLiteral("Updated afterUSN for linked notebook to sync chunk's high USN: ") << download.m_afterUsn);
+
+        if (m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId != 0) {
+            m_linkedNotebookGuidsPendingSyncChunksDownload.prepend(linkedNotebookGuid);
+            return;
+        }
+
+        Q_UNUSED(requestNextLinkedNotebookSyncData(linkedNotebookGuid))
+        return;
+    }
+
+    finishLinkedNotebookSyncChunksDownload(linkedNotebookGuid);
+    checkLinkedNotebooksSyncChunksDownloadCompletion();
+}
+
+void RemoteToLocalSynchronizationManager::processLinkedNotebookSyncDataDownloadError(const QString & linkedNotebookGuid,
+                                                                                     const qint32 errorCode,
+                                                                                     const qint32 rateLimitSeconds,
+                                                                                     const ErrorString & errorDescription)
+{
+    if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+    {
+        if (rateLimitSeconds <= 0) {
+            ErrorString errorMessage(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
+            errorMessage.details() = QString::number(rateLimitSeconds);
+            QNWARNING(errorMessage);
+            Q_EMIT failure(errorMessage);
+            return;
+        }
+
+        // NOTE: the rate limit applies to all the calls made on behalf of the user so all linked notebooks
+        // wait for the single timer before their next requests
+        m_linkedNotebookGuidsPendingSyncChunksDownload.prepend(linkedNotebookGuid);
+
+        if (m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId != 0) {
+            QNDEBUG(QStringLiteral("Rate limit exceeded, the requests are already postponed"));
+            return;
+        }
+
+        // NOTE: the window is reduced once per the rate limit hit even if several linked notebooks have hit it
+        m_linkedNotebookSyncChunkWindow.onRateLimitReached();
+
+        int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
+        if (Q_UNLIKELY(timerId == 0)) {
+            ErrorString errorMessage(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
+                                                "due to rate limit exceeding"));
+            errorMessage.additionalBases().append(errorDescription.base());
+            errorMessage.additionalBases().append(errorDescription.additionalBases());
+            errorMessage.details() = errorDescription.details();
+            QNWARNING(errorMessage);
+            Q_EMIT failure(errorMessage);
+            return;
+        }
+
+        m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId = timerId;
+
+        QNDEBUG(QStringLiteral("Rate limit exceeded, need to wait for ") << rateLimitSeconds << QStringLiteral(" seconds"));
+        Q_EMIT rateLimitExceeded(rateLimitSeconds);
+        return;
+    }
+
+    // NOTE: any other error, including the unexpected AUTH_EXPIRED one, only affects the single linked notebook:
+    // it is skipped within this sync while the rest of linked notebooks are synchronized as usual; as its last
+    // update count is not advanced, the next sync would attempt to download its changes once again
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if (Q_UNLIKELY(it == m_linkedNotebookSyncChunksDownloadsByGuid.end())) {
+        return;
+    }
+
+    LinkedNotebook linkedNotebook = it.value().m_linkedNotebook;
+    Q_UNUSED(m_linkedNotebookSyncChunksDownloadsByGuid.erase(it))
+    Q_UNUSED(m_linkedNotebookGuidsFailedToSync.insert(linkedNotebookGuid))
+
+    QNWARNING(errorDescription << QStringLiteral(", skipping the linked notebook: ") << linkedNotebook);
+    Q_EMIT linkedNotebookSyncFailed(linkedNotebook, errorDescription);
+
+    checkLinkedNotebooksSyncChunksDownloadCompletion();
+}
+
+void RemoteToLocalSynchronizationManager::finishLinkedNotebookSyncChunksDownload(const QString & linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::finishLinkedNotebookSyncChunksDownload: linked notebook guid = ")
+            << linkedNotebookGuid);
+
+    auto it = m_linkedNotebookSyncChunksDownloadsByGuid.find(linkedNotebookGuid);
+    if (Q_UNLIKELY(it == m_linkedNotebookSyncChunksDownloadsByGuid.end())) {
+        return;
+    }
+
+    const LinkedNotebookSyncChunksDownload & download = it.value();
+
+    m_lastSyncTimeByLinkedNotebookGuid[linkedNotebookGuid] = download.m_lastSyncTime;
+    m_lastUpdateCountByLinkedNotebookGuid[linkedNotebookGuid] = download.m_lastUpdateCount;
+
+    Q_UNUSED(m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.insert(linkedNotebookGuid))
+
+    if (download.m_fullSyncOnly) {
+        Q_UNUSED(m_linkedNotebookGuidsForWhichFullSyncWasPerformed.insert(linkedNotebookGuid))
+    }
+
+    LinkedNotebook linkedNotebook = download.m_linkedNotebook;
+    Q_UNUSED(m_linkedNotebookSyncChunksDownloadsByGuid.erase(it))
+
+    Q_EMIT linkedNotebookSyncChunksDownloadFinished(linkedNotebook);
+}
+
+void RemoteToLocalSynchronizationManager::checkLinkedNotebooksSyncChunksDownloadCompletion()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkLinkedNotebooksSyncChunksDownloadCompletion"));
+
+    if (m_linkedNotebooksSyncChunksDownloaded) {
+        QNDEBUG(QStringLiteral("The linked notebooks sync chunks were already downloaded"));
+        return;
+    }
+
+    if (!scheduleLinkedNotebooksSyncChunksDownloads()) {
+        return;
+    }
+
+    // NOTE: scheduling might have finished the downloads for linked notebooks with no updates right away
+    if (!m_linkedNotebookGuidsPendingSyncChunksDownload.isEmpty() || !m_linkedNotebookSyncChunksDownloadsByGuid.isEmpty()) {
+        return;
+    }
+
+    finalizeLinkedNotebooksSyncChunksDownload();
+    launchLinkedNotebooksContentsSync();
+}
+
+void RemoteToLocalSynchronizationManager::finalizeLinkedNotebooksSyncChunksDownload()
+{
+    QNDEBUG(QStringLiteral("Done. Processing content pointed to by linked notebooks from buffered sync chunks"));
+    QNINFO(QStringLiteral("Downloaded linked notebooks sync chunks: ") << m_linkedNotebookSyncChunks.statistics());
+    QNINFO(QStringLiteral("Linked notebooks sync chunk sizing: ") << m_linkedNotebookSyncChunkWindow.metrics());
+
+    if (!m_linkedNotebookGuidsFailedToSync.isEmpty()) {
+        QNWARNING(QStringLiteral("Failed to download the sync chunks for ") << m_linkedNotebookGuidsFailedToSync.size()
+                  << QStringLiteral(" linked notebooks, these would be synchronized next time"));
+    }
+
+    m_syncStatesByLinkedNotebookGuid.clear();   // don't need this anymore, it only served the purpose of preventing multiple get sync state calls for the same linked notebook
+
+    m_linkedNotebooksSyncChunksDownloaded = true;
+    Q_EMIT linkedNotebooksSyncChunksDownloaded();
+}
+
+void RemoteToLocalSynchronizationManager::launchLinkedNotebooksTagsSync()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchLinkedNotebooksTagsSync"));
+    m_pendingTagsSyncStart = false;
+    QList<QString> dummyList;
+    launchDataElementSync<TagsContainer, Tag>(ContentSource::LinkedNotebook, QStringLiteral("Tag"), m_tags, dummyList);
+}
+
+void RemoteToLocalSynchronizationManager::launchLinkedNotebooksNotebooksSync()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::launchLinkedNotebooksNotebooksSync"));
+
+    m_pendingNotebooksSyncStart = false;
 
     QList<QString> dummyList;
     launchDataElementSync<NotebooksList, Notebook>(ContentSource::LinkedNotebook, QStringLiteral("Notebook"), m_notebooks, dummyList);
@@ -5372,6 +6609,16 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion"));
 
+    // Every local storage request from the merging of data items ends up here so it's the right place to check
+    // whether the download of sync chunks postponed due to the local storage lagging behind can be resumed
+    resumeSyncChunksDownloadPostponedByLocalStorage();
+
+    // Same for taking the notes and resources from the next sync chunks once the ones taken before have been processed
+    takeNotesFromSyncChunks();
+    takeResourcesFromSyncChunks();
+
+    checkSyncTraceMergePhasesCompletion();
+
     // Need to check whether we are still waiting for the response from some add or update request
     bool tagsReady = !m_pendingTagsSyncStart && m_tagsPendingProcessing.isEmpty() && m_tagsPendingAddOrUpdate.isEmpty() &&
                      m_findTagByGuidRequestIds.isEmpty() &&
@@ -5446,12 +6693,22 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
                       m_updateNoteRequestIds.isEmpty() && m_addNoteRequestIds.isEmpty() &&
                       m_guidsOfNotesPendingDownloadForAddingToLocalStorage.isEmpty() &&
                       m_notesPendingDownloadForUpdatingInLocalStorageByGuid.isEmpty() &&
-                      m_notesToAddPerAPICallPostponeTimerId.isEmpty() && m_notesToUpdatePerAPICallPostponeTimerId.isEmpty() &&
+                      m_notesPendingLocalResourceDataByFindNoteRequestId.isEmpty() &&
                       m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.isEmpty() &&
                       m_notesPendingInkNoteImagesDownloadByFindNotebookRequestId.isEmpty() &&
                       m_notesPendingThumbnailDownloadByFindNotebookRequestId.isEmpty() &&
                       m_notesPendingThumbnailDownloadByGuid.isEmpty() &&
                       m_updateNoteWithThumbnailRequestIds.isEmpty();
+    if (notesReady && (notesPendingTakingFromSyncChunks() || !m_numPendingNotesBySyncChunkIndices.isEmpty()))
+    {
+        // Nothing is being processed at the moment: if some of the notes taken from the sync chunks haven't been
+        // reported as processed, they won't ever be so their sync chunks should not block taking the next ones
+        releaseNotesTakenFromSyncChunks();
+        takeNotesFromSyncChunks();
+        notesReady = !notesPendingTakingFromSyncChunks() && m_numPendingNotesBySyncChunkIndices.isEmpty() &&
+                     m_notes.isEmpty() && !notesSyncInProgress();
+    }
+
     if (!notesReady)
     {
         QNDEBUG(QStringLiteral("Notes are not ready, there are ") << m_notes.size()
@@ -5461,9 +6718,11 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
                 << QStringLiteral(" note add requests and/or ") << m_findNoteByGuidRequestIds.size()
                 << QStringLiteral(" find note by guid requests and/or ") << m_guidsOfNotesPendingDownloadForAddingToLocalStorage.size()
                 << QStringLiteral(" async full new note data downloads and/or ") << m_notesPendingDownloadForUpdatingInLocalStorageByGuid.size()
-                << QStringLiteral(" async full existing note data downloads; also, there are ") << m_notesToAddPerAPICallPostponeTimerId.size()
-                << QStringLiteral(" postponed note add requests and/or ") << m_notesToUpdatePerAPICallPostponeTimerId.size()
-                << QStringLiteral(" postponed note update requests and/or ") << m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.size()
+                << QStringLiteral(" async full existing note data downloads (") << m_downloadScheduler.queueDepth()
+                << QStringLiteral(" note and resource downloads are queued by the download scheduler) and/or ")
+                << m_notesPendingLocalResourceDataByFindNoteRequestId.size()
+                << QStringLiteral(" find note requests for preserving the local resources' binary data and/or ")
+                << m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.size()
                 << QStringLiteral(" note resources pending ink note image download processing and/or ") << m_notesPendingInkNoteImagesDownloadByFindNotebookRequestId.size()
                 << QStringLiteral(" find notebook requests for ink note image download processing and/or ") << m_notesPendingThumbnailDownloadByFindNotebookRequestId.size()
                 << QStringLiteral(" find notebook requests for note thumbnail download processing and/or ") << m_notesPendingThumbnailDownloadByGuid.size()
@@ -5481,9 +6740,15 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
                               m_inkNoteResourceDataPerFindNotebookRequestId.isEmpty() &&
                               m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid.isEmpty() &&
                               m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid.isEmpty() &&
-                              m_resourcesToAddWithNotesPerAPICallPostponeTimerId.isEmpty() &&
-                              m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.isEmpty() &&
                               m_postponedConflictingResourceDataPerAPICallPostponeTimerId.isEmpty();
+        if (resourcesReady && (resourcesPendingTakingFromSyncChunks() || !m_numPendingResourcesBySyncChunkIndices.isEmpty()))
+        {
+            releaseResourcesTakenFromSyncChunks();
+            takeResourcesFromSyncChunks();
+            resourcesReady = !resourcesPendingTakingFromSyncChunks() && m_numPendingResourcesBySyncChunkIndices.isEmpty() &&
+                             m_resources.isEmpty() && !resourcesSyncInProgress();
+        }
+
         if (!resourcesReady)
         {
             QNDEBUG(QStringLiteral("Resources are not ready, there are ") << m_resources.size()
@@ -5498,9 +6763,8 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
                     << m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid.size()
                     << QStringLiteral(" async full new resource data downloads and/or ")
                     << m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid.size()
-                    << QStringLiteral(" async full existing resource data downloads and/or ") << m_resourcesToAddWithNotesPerAPICallPostponeTimerId.size()
-                    << QStringLiteral(" postponed resource add requests and/or ") << m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.size()
-                    << QStringLiteral(" postponed resource update requests and/or ") << m_postponedConflictingResourceDataPerAPICallPostponeTimerId.size()
+                    << QStringLiteral(" async full existing resource data downloads and/or ")
+                    << m_postponedConflictingResourceDataPerAPICallPostponeTimerId.size()
                     << QStringLiteral(" postponed resource conflict resolutions"));
             return;
         }
@@ -5561,11 +6825,12 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
 
         m_fullNoteContentsDownloaded = true;
 
-        Q_EMIT synchronizedContentFromUsersOwnAccount(m_lastUpdateCount, m_lastSyncTime);
-
         if (m_lastSyncMode == SyncMode::FullSync)
         {
-            if (m_onceSyncDone) {
+            // NOTE: the last sync parameters are not updated until the full sync is finished: otherwise the full sync
+            // interrupted from now on would be followed by the incremental sync instead of being resumed
+
+            if (m_onceSyncDone || m_fullSyncResumedFromSyncCheckpoint) {
                 QNDEBUG(QStringLiteral("Performed full sync even though it has been performed at some moment in the past; "
                                        "need to check for stale data items left within the local storage and expunge them"));
                 launchFullSyncStaleDataItemsExpunger();
@@ -5574,6 +6839,10 @@ void RemoteToLocalSynchronizationManager::checkServerDataMergeCompletion()
 
             m_expungedFromServerToClient = true;
         }
+        else
+        {
+            Q_EMIT synchronizedContentFromUsersOwnAccount(m_lastUpdateCount, m_lastSyncTime);
+        }
 
         if (m_expungedFromServerToClient) {
             startLinkedNotebooksSync();
@@ -5606,6 +6875,26 @@ void RemoteToLocalSynchronizationManager::finalize()
         }
     }
 
+    QNINFO(QStringLiteral("Full note and resource data downloads: ") << m_downloadScheduler.metrics());
+
+    // The sync is complete, there's nothing to resume anymore
+    ErrorString errorDescription;
+    if (!SyncCheckpoint::remove(syncCheckpointFilePath(), errorDescription)) {
+        QNWARNING(QStringLiteral("Failed to remove the sync checkpoint: ") << errorDescription);
+    }
+
+    if (m_selectiveSyncFilter != m_appliedSelectiveSyncFilter)
+    {
+        // NOTE: the linked notebook which failed to sync would need the notes skipped by the previous syncs
+        // to be downloaded during the next sync
+        if (m_linkedNotebookGuidsFailedToSync.isEmpty()) {
+            persistAppliedSelectiveSyncFilter();
+        }
+        else {
+            QNINFO(QStringLiteral("Some linked notebooks failed to sync, the selective sync filter is not considered applied yet"));
+        }
+    }
+
     m_onceSyncDone = true;
     Q_EMIT finished(m_lastUpdateCount, m_lastSyncTime, m_lastUpdateCountByLinkedNotebookGuid, m_lastSyncTimeByLinkedNotebookGuid);
     clear();
@@ -5621,9 +6910,25 @@ void RemoteToLocalSynchronizationManager::clear()
 
     // NOTE: not clearing m_host: it can be reused in later syncs
 
+    m_fullSyncResumedFromSyncCheckpoint = false;
     m_lastUsnOnStart = -1;
     m_lastSyncChunksDownloadedUsn = -1;
 
+    m_lastPreviousUsnOnSyncChunksDownload = 0;
+    m_pendingSyncChunkAfterUsn = -1;
+    m_pendingSyncChunkMaxEntries = 0;
+    m_pendingSyncChunkRequestTimestamp = 0;
+    m_afterUsnForSyncChunkPendingAuthentication = -1;
+    m_numSyncChunksWithMergedSavedSearchesAndNotebooks = 0;
+
+    m_lastUsedNotebookGuid.clear();
+    m_findLastUsedNotebookRequestId = QUuid();
+
+    m_selectiveSyncBackfillPending = false;
+    m_selectiveSyncBackfillUpToUsn = -1;
+    m_selectiveSyncBackfillInProgress = false;
+    m_notebookGuidsBySelectiveSyncSkippedNoteGuids.clear();
+
     m_syncChunksDownloaded = false;
     m_fullNoteContentsDownloaded = false;
     m_expungedFromServerToClient = false;
@@ -5635,12 +6940,30 @@ void RemoteToLocalSynchronizationManager::clear()
 
     m_syncChunks.clear();
     m_linkedNotebookSyncChunks.clear();
+    m_linkedNotebookGuidsOfLinkedNotebookSyncChunks.clear();
     m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded.clear();
 
+    m_notesSyncContentSource = ContentSource::UserAccount;
+    m_nextSyncChunkIndexToTakeNotesFrom = -1;
+    m_nextSyncChunkIndexToTakeResourcesFrom = -1;
+    m_syncChunkIndicesByPendingNoteGuids.clear();
+    m_numPendingNotesBySyncChunkIndices.clear();
+    m_syncChunkIndicesByPendingResourceGuids.clear();
+    m_numPendingResourcesBySyncChunkIndices.clear();
+    m_lastSyncChunkIndicesByNoteGuids.clear();
+    m_lastSyncChunkIndicesByResourceGuids.clear();
+    m_lastSyncChunkIndicesByExpungedNoteGuids.clear();
+    m_lastSyncChunkIndicesByExpungedNotebookGuids.clear();
+
+    m_syncChunkWindow.clear();
+    m_linkedNotebookSyncChunkWindow.clear();
+
     // NOTE: not clearing m_accountLimits: it can be reused in later syncs
 
     m_tags.clear();
     m_tagsPendingProcessing.clear();
+    m_tagsPendingProcessingLevelSizes.clear();
+    m_guidsOfTagsFromCurrentLevelPendingProcessing.clear();
     m_tagsPendingAddOrUpdate.clear();
     m_expungedTags.clear();
     m_findTagByNameRequestIds.clear();
@@ -5664,22 +6987,6 @@ void RemoteToLocalSynchronizationManager::clear()
         pResolver->deleteLater();
     }
 
-    m_tagSyncCache.clear();
-
-    for(auto it = m_tagSyncCachesByLinkedNotebookGuids.begin(),
-        end = m_tagSyncCachesByLinkedNotebookGuids.end(); it != end; ++it)
-    {
-        TagSyncCache * pCache = *it;
-        if (Q_UNLIKELY(!pCache)) {
-            continue;
-        }
-
-        pCache->disconnect();
-        pCache->setParent(Q_NULLPTR);
-        pCache->deleteLater();
-    }
-
-    m_tagSyncCachesByLinkedNotebookGuids.clear();
     m_linkedNotebookGuidsPendingTagSyncCachesFill.clear();
 
     m_linkedNotebookGuidsByTagGuids.clear();
@@ -5707,8 +7014,6 @@ void RemoteToLocalSynchronizationManager::clear()
         pResolver->deleteLater();
     }
 
-    m_savedSearchSyncCache.clear();
-
     m_linkedNotebooks.clear();
     m_linkedNotebooksPendingAddOrUpdate.clear();
     m_expungedLinkedNotebooks.clear();
@@ -5740,6 +7045,12 @@ void RemoteToLocalSynchronizationManager::clear()
 
     m_syncStatesByLinkedNotebookGuid.clear();
 
+    m_linkedNotebooksSyncChunksDownloadStarted = false;
+    m_linkedNotebookGuidsPendingSyncChunksDownload.clear();
+    m_linkedNotebookSyncChunksDownloadsByGuid.clear();
+    m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight.clear();
+    m_linkedNotebookGuidsFailedToSync.clear();
+
     // NOTE: not clearing last synchronized USNs, sync times and update counts by linked notebook guid:
     // this information can be reused in subsequent syncs
 
@@ -5767,22 +7078,7 @@ void RemoteToLocalSynchronizationManager::clear()
         pResolver->deleteLater();
     }
 
-    m_notebookSyncCache.clear();
-
-    for(auto it = m_notebookSyncCachesByLinkedNotebookGuids.begin(),
-        end = m_notebookSyncCachesByLinkedNotebookGuids.end(); it != end; ++it)
-    {
-        NotebookSyncCache * pCache = *it;
-        if (Q_UNLIKELY(!pCache)) {
-            continue;
-        }
-
-        pCache->disconnect();
-        pCache->setParent(Q_NULLPTR);
-        pCache->deleteLater();
-    }
-
-    m_notebookSyncCachesByLinkedNotebookGuids.clear();
+    m_syncCachesManager.clear();
 
     m_linkedNotebookGuidsByNotebookGuids.clear();
 
@@ -5823,6 +7119,8 @@ void RemoteToLocalSynchronizationManager::clear()
 
     m_guidsOfNotesPendingDownloadForAddingToLocalStorage.clear();
     m_notesPendingDownloadForUpdatingInLocalStorageByGuid.clear();
+    m_partialNoteDataDownloadsByGuid.clear();
+    m_notesPendingLocalResourceDataByFindNoteRequestId.clear();
 
     m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid.clear();
     m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid.clear();
@@ -5831,6 +7129,7 @@ void RemoteToLocalSynchronizationManager::clear()
     m_fullSyncStaleDataItemsSyncedGuids.m_syncedTagGuids.clear();
     m_fullSyncStaleDataItemsSyncedGuids.m_syncedNoteGuids.clear();
     m_fullSyncStaleDataItemsSyncedGuids.m_syncedSavedSearchGuids.clear();
+    m_fullSyncStaleDataItemsSyncedGuidsByLinkedNotebookGuid.clear();
 
     if (m_pFullSyncStaleDataItemsExpunger) {
         junkFullSyncStaleDataItemsExpunger(*m_pFullSyncStaleDataItemsExpunger);
@@ -5848,37 +7147,19 @@ void RemoteToLocalSynchronizationManager::clear()
 
     m_fullSyncStaleDataItemsExpungersByLinkedNotebookGuid.clear();
 
-    auto notesToAddPerAPICallPostponeTimerIdEnd = m_notesToAddPerAPICallPostponeTimerId.end();
-    for(auto it = m_notesToAddPerAPICallPostponeTimerId.begin(); it != notesToAddPerAPICallPostponeTimerIdEnd; ++it) {
-        int key = it.key();
-        killTimer(key);
-    }
-    m_notesToAddPerAPICallPostponeTimerId.clear();
+    m_downloadScheduler.clear();
 
-    auto notesToUpdateAndToAddLaterPerAPICallPostponeTimerIdEnd = m_notesToUpdatePerAPICallPostponeTimerId.end();
-    for(auto it = m_notesToUpdatePerAPICallPostponeTimerId.begin(); it != notesToUpdateAndToAddLaterPerAPICallPostponeTimerIdEnd; ++it) {
-        int key = it.key();
-        killTimer(key);
+    if (m_downloadSchedulerBackoffTimerId != 0) {
+        killTimer(m_downloadSchedulerBackoffTimerId);
+        m_downloadSchedulerBackoffTimerId = 0;
     }
-    m_notesToUpdatePerAPICallPostponeTimerId.clear();
 
-    auto resourcesToAddWithNotesPerAPICallPostponeTimerIdEnd = m_resourcesToAddWithNotesPerAPICallPostponeTimerId.end();
-    for(auto it = m_resourcesToAddWithNotesPerAPICallPostponeTimerId.begin();
-        it != resourcesToAddWithNotesPerAPICallPostponeTimerIdEnd; ++it)
-    {
-        int key = it.key();
-        killTimer(key);
-    }
-    m_resourcesToAddWithNotesPerAPICallPostponeTimerId.clear();
+    m_syncCheckpoint.clear();
 
-    auto resourcesToUpdateWithNotesPerAPICallPostponeTimerIdEnd = m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.end();
-    for(auto it = m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.begin();
-        it != resourcesToUpdateWithNotesPerAPICallPostponeTimerIdEnd; ++it)
-    {
-        int key = it.key();
-        killTimer(key);
+    if (m_syncCheckpointTimerId != 0) {
+        killTimer(m_syncCheckpointTimerId);
+        m_syncCheckpointTimerId = 0;
     }
-    m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.clear();
 
     auto postponedConflictingResourceDataPerAPICallPostponeTimerIdEnd = m_postponedConflictingResourceDataPerAPICallPostponeTimerId.end();
     for(auto it = m_postponedConflictingResourceDataPerAPICallPostponeTimerId.begin();
@@ -5896,6 +7177,8 @@ void RemoteToLocalSynchronizationManager::clear()
     }
     m_afterUsnForSyncChunkPerAPICallPostponeTimerId.clear();
 
+    m_syncChunksDownloadPostponedByLocalStorage = false;
+
     if (m_getLinkedNotebookSyncStateBeforeStartAPICallPostponeTimerId != 0) {
         killTimer(m_getLinkedNotebookSyncStateBeforeStartAPICallPostponeTimerId);
         m_getLinkedNotebookSyncStateBeforeStartAPICallPostponeTimerId = 0;
@@ -5923,33 +7206,7 @@ void RemoteToLocalSynchronizationManager::clear()
 
     // NOTE: not clearing m_gotLastSyncParameters: this information can be reused in subsequent syncs
 
-    QList<NoteThumbnailDownloader*> noteThumbnailDownloaders = findChildren<NoteThumbnailDownloader*>();
-    for(auto it = noteThumbnailDownloaders.begin(), end = noteThumbnailDownloaders.end(); it != end; ++it)
-    {
-        NoteThumbnailDownloader * pDownloader = *it;
-        if (Q_UNLIKELY(!pDownloader)) {
-            continue;
-        }
-
-        QObject::disconnect(pDownloader, QNSIGNAL(NoteThumbnailDownloader,finished,bool,QString,QByteArray,ErrorString),
-                            this, QNSLOT(RemoteToLocalSynchronizationManager,onNoteThumbnailDownloadingFinished,bool,QString,QByteArray,ErrorString));
-        pDownloader->setParent(Q_NULLPTR);
-        pDownloader->deleteLater();
-    }
-
-    QList<InkNoteImageDownloader*> inkNoteImagesDownloaders = findChildren<InkNoteImageDownloader*>();
-    for(auto it = inkNoteImagesDownloaders.begin(), end = inkNoteImagesDownloaders.end(); it != end; ++it)
-    {
-        InkNoteImageDownloader * pDownloader = *it;
-        if (Q_UNLIKELY(!pDownloader)) {
-            continue;
-        }
-
-        QObject::disconnect(pDownloader, QNSIGNAL(InkNoteImageDownloader,finished,bool,QString,QString,ErrorString),
-                            this, QNSLOT(RemoteToLocalSynchronizationManager,onInkNoteImageDownloadFinished,bool,QString,QString,ErrorString));
-        pDownloader->setParent(Q_NULLPTR);
-        pDownloader->deleteLater();
-    }
+    m_noteImagesDownloadManager.clear();
 }
 
 void RemoteToLocalSynchronizationManager::clearAll()
@@ -6048,44 +7305,25 @@ void RemoteToLocalSynchronizationManager::timerEvent(QTimerEvent * pEvent)
     killTimer(timerId);
     QNDEBUG(QStringLiteral("Killed timer with id ") << timerId);
 
-    auto noteToAddIt = m_notesToAddPerAPICallPostponeTimerId.find(timerId);
-    if (noteToAddIt != m_notesToAddPerAPICallPostponeTimerId.end()) {
-        Note note = noteToAddIt.value();
-        Q_UNUSED(m_notesToAddPerAPICallPostponeTimerId.erase(noteToAddIt));
-        getFullNoteDataAsyncAndAddToLocalStorage(note);
+    if (m_downloadSchedulerBackoffTimerId == timerId) {
+        m_downloadSchedulerBackoffTimerId = 0;
+        startScheduledDownloads();
         return;
     }
 
-    auto noteToUpdateIt = m_notesToUpdatePerAPICallPostponeTimerId.find(timerId);
-    if (noteToUpdateIt != m_notesToUpdatePerAPICallPostponeTimerId.end()) {
-        Note noteToUpdate = noteToUpdateIt.value();
-        Q_UNUSED(m_notesToUpdatePerAPICallPostponeTimerId.erase(noteToUpdateIt));
-        registerNotePendingAddOrUpdate(noteToUpdate);
-        getFullNoteDataAsyncAndUpdateInLocalStorage(noteToUpdate);
+    if (m_syncCheckpointTimerId == timerId) {
+        m_syncCheckpointTimerId = 0;
+        writeSyncCheckpoint();
+        Q_EMIT syncCheckpointReached();
+        startSyncCheckpointTimer();
         return;
     }
 
-    auto resourceToAddIt = m_resourcesToAddWithNotesPerAPICallPostponeTimerId.find(timerId);
-    if (resourceToAddIt != m_resourcesToAddWithNotesPerAPICallPostponeTimerId.end()) {
-        std::pair<Resource,Note> pair = resourceToAddIt.value();
-        Q_UNUSED(m_resourcesToAddWithNotesPerAPICallPostponeTimerId.erase(resourceToAddIt))
-        getFullResourceDataAsyncAndAddToLocalStorage(pair.first, pair.second);
-        return;
-    }
-
-    auto resourceToUpdateIt = m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.find(timerId);
-    if (resourceToUpdateIt != m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId.end()) {
-        std::pair<Resource,Note> pair = resourceToAddIt.value();
-        Q_UNUSED(m_resourcesToAddWithNotesPerAPICallPostponeTimerId.erase(resourceToAddIt))
-        getFullResourceDataAsyncAndUpdateInLocalStorage(pair.first, pair.second);
-        return;
-    }
-
-    auto conflictingResourceDataIt = m_postponedConflictingResourceDataPerAPICallPostponeTimerId.find(timerId);
-    if (conflictingResourceDataIt != m_postponedConflictingResourceDataPerAPICallPostponeTimerId.end()) {
-        PostponedConflictingResourceData data = conflictingResourceDataIt.value();
-        Q_UNUSED(m_postponedConflictingResourceDataPerAPICallPostponeTimerId.erase(conflictingResourceDataIt))
-        processResourceConflictAsNoteConflict(data.m_remoteNote, data.m_localConflictingNote, data.m_remoteNoteResourceWithoutFullData);
+    auto conflictingResourceDataIt = m_postponedConflictingResourceDataPerAPICallPostponeTimerId.find(timerId);
+    if (conflictingResourceDataIt != m_postponedConflictingResourceDataPerAPICallPostponeTimerId.end()) {
+        PostponedConflictingResourceData data = conflictingResourceDataIt.value();
+        Q_UNUSED(m_postponedConflictingResourceDataPerAPICallPostponeTimerId.erase(conflictingResourceDataIt))
+        processResourceConflictAsNoteConflict(data.m_remoteNote, data.m_localConflictingNote, data.m_remoteNoteResourceWithoutFullData);
         return;
     }
 
@@ -6150,7 +7388,7 @@ void RemoteToLocalSynchronizationManager::getFullNoteDataAsync(const Note & note
 
     QString authToken;
     ErrorString errorDescription;
-    NoteStore * pNoteStore = noteStoreForNote(note, authToken, errorDescription);
+    INoteStore * pNoteStore = noteStoreForNote(note, authToken, errorDescription);
     if (Q_UNLIKELY(!pNoteStore)) {
         Q_EMIT failure(errorDescription);
         return;
@@ -6174,6 +7412,44 @@ void RemoteToLocalSynchronizationManager::getFullNoteDataAsync(const Note & note
     bool withNoteAppDataValues = true;
     bool withResourceAppDataValues = true;
     bool withNoteLimits = syncingLinkedNotebooksContent();
+
+    auto partialDownloadIt = m_partialNoteDataDownloadsByGuid.find(note.guid());
+    if (partialDownloadIt != m_partialNoteDataDownloadsByGuid.end()) {
+        const NoteDataDownloadOptions & options = partialDownloadIt.value().second;
+        withContent = options.m_withContent;
+        withResourceData = options.m_withResourceData;
+        withResourceRecognition = options.m_withResourceRecognition;
+        withResourceAlternateData = options.m_withResourceAlternateData;
+        QNDEBUG(QStringLiteral("Downloading only the changed parts of the note: ") << options);
+    }
+
+    if (withResourceData || withResourceAlternateData)
+    {
+        qint64 resourcesDataSize = 0;
+        if (note.hasResources())
+        {
+            QList<Resource> resources = note.resources();
+            for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+            {
+                if (it->hasDataSize()) {
+                    resourcesDataSize += it->dataSize();
+                }
+
+                if (it->hasAlternateDataSize()) {
+                    resourcesDataSize += it->alternateDataSize();
+                }
+            }
+        }
+
+        if (!shouldDownloadResourceData(note, resourcesDataSize)) {
+            QNDEBUG(QStringLiteral("Not downloading the resources' data for the note, it would be downloaded on demand"));
+            withResourceData = false;
+            withResourceAlternateData = false;
+        }
+    }
+
+    beginSyncTraceSpan(SyncTracer::Phase::NoteDownload, note.guid());
+
     errorDescription.clear();
     bool res = pNoteStore->getNoteAsync(withContent, withResourceData, withResourceRecognition,
                                         withResourceAlternateData, withSharedNotes,
@@ -6213,7 +7489,7 @@ void RemoteToLocalSynchronizationManager::getFullNoteDataAsyncAndAddToLocalStora
             << noteGuid);
     Q_UNUSED(m_guidsOfNotesPendingDownloadForAddingToLocalStorage.insert(noteGuid))
 
-    getFullNoteDataAsync(note);
+    scheduleFullNoteDataDownload(note);
 }
 
 void RemoteToLocalSynchronizationManager::getFullNoteDataAsyncAndUpdateInLocalStorage(const Note & note)
@@ -6244,7 +7520,229 @@ void RemoteToLocalSynchronizationManager::getFullNoteDataAsyncAndUpdateInLocalSt
             << noteGuid);
     m_notesPendingDownloadForUpdatingInLocalStorageByGuid[noteGuid] = note;
 
-    getFullNoteDataAsync(note);
+    scheduleFullNoteDataDownload(note);
+}
+
+RemoteToLocalSynchronizationManager::NoteDataDownloadOptions
+RemoteToLocalSynchronizationManager::noteDataDownloadOptions(const Note & localNote, const qevercloud::Note & remoteNote) const
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::noteDataDownloadOptions: local note = ")
+            << localNote << QStringLiteral("\nRemote note: ") << remoteNote);
+
+    NoteDataDownloadOptions options;
+
+    // NOTE: the hashes of the dirty local note or resources might not correspond to their actual data
+    if (localNote.isDirty()) {
+        QNDEBUG(QStringLiteral("The local note is dirty, need to download the full note data"));
+        return options;
+    }
+
+    QList<Resource> localResources;
+    if (localNote.hasResources()) {
+        localResources = localNote.resources();
+    }
+
+    for(auto it = localResources.constBegin(), end = localResources.constEnd(); it != end; ++it)
+    {
+        if (it->isDirty()) {
+            QNDEBUG(QStringLiteral("The local note has dirty resources, need to download the full note data"));
+            return options;
+        }
+    }
+
+    options.m_withContent = !(localNote.hasContent() && localNote.hasContentHash() && remoteNote.contentHash.isSet() &&
+                              (localNote.contentHash() == remoteNote.contentHash.ref()));
+    options.m_withResourceData = false;
+    options.m_withResourceRecognition = false;
+    options.m_withResourceAlternateData = false;
+
+    if (!remoteNote.resources.isSet()) {
+        QNDEBUG(QStringLiteral("The remote note has no resources: ") << options);
+        return options;
+    }
+
+    const QList<qevercloud::Resource> & remoteResources = remoteNote.resources.ref();
+    for(auto rit = remoteResources.constBegin(), rend = remoteResources.constEnd(); rit != rend; ++rit)
+    {
+        Resource remoteResource(*rit);
+
+        const Resource * pLocalResource = Q_NULLPTR;
+        if (remoteResource.hasGuid())
+        {
+            for(auto it = localResources.constBegin(), end = localResources.constEnd(); it != end; ++it)
+            {
+                if (it->hasGuid() && (it->guid() == remoteResource.guid())) {
+                    pLocalResource = &(*it);
+                    break;
+                }
+            }
+        }
+
+        if (!pLocalResource) {
+            options.m_withResourceData = true;
+            options.m_withResourceRecognition |= remoteResource.hasRecognitionData();
+            options.m_withResourceAlternateData |= remoteResource.hasAlternateData();
+            continue;
+        }
+
+        if ((remoteResource.hasDataHash() != pLocalResource->hasDataHash()) ||
+            (remoteResource.hasDataHash() && (remoteResource.dataHash() != pLocalResource->dataHash())))
+        {
+            options.m_withResourceData = true;
+        }
+
+        if ((remoteResource.hasRecognitionDataHash() != pLocalResource->hasRecognitionDataHash()) ||
+            (remoteResource.hasRecognitionDataHash() && (remoteResource.recognitionDataHash() != pLocalResource->recognitionDataHash())))
+        {
+            options.m_withResourceRecognition = true;
+        }
+
+        if ((remoteResource.hasAlternateDataHash() != pLocalResource->hasAlternateDataHash()) ||
+            (remoteResource.hasAlternateDataHash() && (remoteResource.alternateDataHash() != pLocalResource->alternateDataHash())))
+        {
+            options.m_withResourceAlternateData = true;
+        }
+    }
+
+    QNDEBUG(QStringLiteral("Note data download options: ") << options);
+    return options;
+}
+
+void RemoteToLocalSynchronizationManager::updateNoteInLocalStorageKeepingLocalData(Note & note, const Note & localNote)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::updateNoteInLocalStorageKeepingLocalData: note = ")
+            << note << QStringLiteral("\nLocal note: ") << localNote);
+
+    // The content is not downloaded if it hasn't changed
+    if (!note.hasContent() && localNote.hasContent() && note.hasContentHash() && localNote.hasContentHash() &&
+        (note.contentHash() == localNote.contentHash()))
+    {
+        note.setContent(localNote.content());
+    }
+
+    QList<Resource> resources;
+    if (note.hasResources()) {
+        resources = note.resources();
+    }
+
+    QList<Resource> localResources;
+    if (localNote.hasResources()) {
+        localResources = localNote.resources();
+    }
+
+    bool resourcesChanged = (resources.size() != localResources.size());
+    bool needLocalResourcesBinaryData = false;
+
+    for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+    {
+        const Resource & resource = *it;
+
+        const Resource * pLocalResource = Q_NULLPTR;
+        for(auto lit = localResources.constBegin(), lend = localResources.constEnd(); lit != lend; ++lit)
+        {
+            if (resource.hasGuid() && lit->hasGuid() && (lit->guid() == resource.guid())) {
+                pLocalResource = &(*lit);
+                break;
+            }
+        }
+
+        if (!pLocalResource) {
+            resourcesChanged = true;
+            continue;
+        }
+
+        if ((resource.hasUpdateSequenceNumber() != pLocalResource->hasUpdateSequenceNumber()) ||
+            (resource.hasUpdateSequenceNumber() && (resource.updateSequenceNumber() != pLocalResource->updateSequenceNumber())))
+        {
+            resourcesChanged = true;
+        }
+
+        // The binary data which wasn't downloaded because it hasn't changed needs to be taken from the local storage,
+        // otherwise the update of the resource would erase it
+        if ((!resource.hasDataBody() && resource.hasDataHash() && pLocalResource->hasDataHash() &&
+             (resource.dataHash() == pLocalResource->dataHash())) ||
+            (!resource.hasRecognitionDataBody() && resource.hasRecognitionDataHash() && pLocalResource->hasRecognitionDataHash() &&
+             (resource.recognitionDataHash() == pLocalResource->recognitionDataHash())) ||
+            (!resource.hasAlternateDataBody() && resource.hasAlternateDataHash() && pLocalResource->hasAlternateDataHash() &&
+             (resource.alternateDataHash() == pLocalResource->alternateDataHash())))
+        {
+            needLocalResourcesBinaryData = true;
+        }
+    }
+
+    if (resourcesChanged && needLocalResourcesBinaryData)
+    {
+        QUuid findNoteRequestId = QUuid::createUuid();
+        m_notesPendingLocalResourceDataByFindNoteRequestId[findNoteRequestId] = note;
+
+        Note noteToFind;
+        noteToFind.unsetLocalUid();
+        noteToFind.setGuid(note.guid());
+
+        QNTRACE(QStringLiteral("Emitting the request to find the note with resources' binary data in the local storage: request id = ")
+                << findNoteRequestId << QStringLiteral(", note: ") << noteToFind);
+        Q_EMIT findNote(noteToFind, /* with resource binary data = */ true, findNoteRequestId);
+        return;
+    }
+
+    QUuid updateNoteRequestId = QUuid::createUuid();
+    Q_UNUSED(m_updateNoteRequestIds.insert(updateNoteRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateNoteRequestId.toString());
+    QNTRACE(QStringLiteral("Emitting the request to update note in local storage: request id = ")
+            << updateNoteRequestId << QStringLiteral(", update resources = ") << (resourcesChanged ? QStringLiteral("true") : QStringLiteral("false"))
+            << QStringLiteral(", note; ") << note);
+    Q_EMIT updateNote(note, /* update resources = */ resourcesChanged, /* update tags = */ true, updateNoteRequestId);
+}
+
+void RemoteToLocalSynchronizationManager::copyLocalResourcesBinaryData(Note & note, const Note & localNote) const
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::copyLocalResourcesBinaryData: note guid = ")
+            << (note.hasGuid() ? note.guid() : QStringLiteral("<not set>")));
+
+    if (!note.hasResources() || !localNote.hasResources()) {
+        return;
+    }
+
+    QList<Resource> resources = note.resources();
+    QList<Resource> localResources = localNote.resources();
+
+    for(auto it = resources.begin(), end = resources.end(); it != end; ++it)
+    {
+        Resource & resource = *it;
+        if (!resource.hasGuid()) {
+            continue;
+        }
+
+        for(auto lit = localResources.constBegin(), lend = localResources.constEnd(); lit != lend; ++lit)
+        {
+            const Resource & localResource = *lit;
+            if (!localResource.hasGuid() || (localResource.guid() != resource.guid())) {
+                continue;
+            }
+
+            if (!resource.hasDataBody() && localResource.hasDataBody() && resource.hasDataHash() &&
+                localResource.hasDataHash() && (resource.dataHash() == localResource.dataHash()))
+            {
+                resource.setDataBody(localResource.dataBody());
+            }
+
+            if (!resource.hasRecognitionDataBody() && localResource.hasRecognitionDataBody() && resource.hasRecognitionDataHash() &&
+                localResource.hasRecognitionDataHash() && (resource.recognitionDataHash() == localResource.recognitionDataHash()))
+            {
+                resource.setRecognitionDataBody(localResource.recognitionDataBody());
+            }
+
+            if (!resource.hasAlternateDataBody() && localResource.hasAlternateDataBody() && resource.hasAlternateDataHash() &&
+                localResource.hasAlternateDataHash() && (resource.alternateDataHash() == localResource.alternateDataHash()))
+            {
+                resource.setAlternateDataBody(localResource.alternateDataBody());
+            }
+
+            break;
+        }
+    }
+
+    note.setResources(resources);
 }
 
 void RemoteToLocalSynchronizationManager::getFullResourceDataAsync(const Resource & resource,
@@ -6275,7 +7773,7 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsync(const Resourc
     // account or the one for the stuff from some linked notebook
 
     QString authToken;
-    NoteStore * pNoteStore = Q_NULLPTR;
+    INoteStore * pNoteStore = Q_NULLPTR;
     auto linkedNotebookGuidIt = m_linkedNotebookGuidsByNotebookGuids.find(resourceOwningNote.notebookGuid());
     if (linkedNotebookGuidIt == m_linkedNotebookGuidsByNotebookGuids.end())
     {
@@ -6342,7 +7840,7 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsync(const Resourc
             return;
         }
 
-        QObject::connect(pNoteStore, QNSIGNAL(NoteStore,getResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString),
+        QObject::connect(pNoteStore, QNSIGNAL(INoteStore,getResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString),
                          this, QNSLOT(RemoteToLocalSynchronizationManager,onGetResourceAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
                          Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
@@ -6350,9 +7848,21 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsync(const Resourc
                 << linkedNotebookGuid << QStringLiteral(", note store url = ") << pNoteStore->noteStoreUrl());
     }
 
+    qint64 resourceDataSize = (resource.hasDataSize() ? resource.dataSize() : 0);
+    if (resource.hasAlternateDataSize()) {
+        resourceDataSize += resource.alternateDataSize();
+    }
+
+    bool withResourceData = shouldDownloadResourceData(resourceOwningNote, resourceDataSize);
+    if (!withResourceData) {
+        QNDEBUG(QStringLiteral("Not downloading the resource's data, it would be downloaded on demand"));
+    }
+
+    beginSyncTraceSpan(SyncTracer::Phase::ResourceDownload, resource.guid());
+
     ErrorString errorDescription;
-    bool res = pNoteStore->getResourceAsync(/* with data body = */ true, /* with recognition data body = */ true,
-                                            /* with alternate data body = */ true, /* with attributes = */ true,
+    bool res = pNoteStore->getResourceAsync(/* with data body = */ withResourceData, /* with recognition data body = */ true,
+                                            /* with alternate data body = */ withResourceData, /* with attributes = */ true,
                                             resource.guid(), authToken, errorDescription);
     if (!res) {
         APPEND_NOTE_DETAILS(errorDescription, resourceOwningNote);
@@ -6362,6 +7872,29 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsync(const Resourc
     }
 }
 
+bool RemoteToLocalSynchronizationManager::shouldDownloadResourceData(const Note & note, const qint64 resourcesDataSize) const
+{
+    if (!m_downloadResourceDataOnDemand) {
+        return true;
+    }
+
+    if (m_resourceDataPrefetchMaxNoteAgeDays <= 0) {
+        return false;
+    }
+
+    if ((m_resourceDataPrefetchMaxSize > 0) && (resourcesDataSize > m_resourceDataPrefetchMaxSize)) {
+        QNTRACE(QStringLiteral("The resources' data is too large to prefetch: ") << resourcesDataSize);
+        return false;
+    }
+
+    if (!note.hasModificationTimestamp()) {
+        return false;
+    }
+
+    qint64 noteAgeMsec = QDateTime::currentMSecsSinceEpoch() - note.modificationTimestamp();
+    return (noteAgeMsec <= static_cast<qint64>(m_resourceDataPrefetchMaxNoteAgeDays) * ONE_DAY_IN_MSEC);
+}
+
 void RemoteToLocalSynchronizationManager::getFullResourceDataAsyncAndAddToLocalStorage(const Resource & resource,
                                                                                        const Note & resourceOwningNote)
 {
@@ -6390,7 +7923,7 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsyncAndAddToLocalS
             << resourceGuid);
     m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid[resourceGuid] = resourceOwningNote;
 
-    getFullResourceDataAsync(resource, resourceOwningNote);
+    scheduleFullResourceDataDownload(resource, resourceOwningNote);
 }
 
 void RemoteToLocalSynchronizationManager::getFullResourceDataAsyncAndUpdateInLocalStorage(const Resource & resource,
@@ -6421,145 +7954,471 @@ void RemoteToLocalSynchronizationManager::getFullResourceDataAsyncAndUpdateInLoc
             << resourceGuid);
     m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid[resourceGuid] = std::pair<Resource,Note>(resource, resourceOwningNote);
 
-    getFullResourceDataAsync(resource, resourceOwningNote);
+    scheduleFullResourceDataDownload(resource, resourceOwningNote);
 }
 
-void RemoteToLocalSynchronizationManager::downloadSyncChunksAndLaunchSync(qint32 afterUsn)
+void RemoteToLocalSynchronizationManager::scheduleFullNoteDataDownload(const Note & note)
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::downloadSyncChunksAndLaunchSync: after USN = ") << afterUsn);
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::scheduleFullNoteDataDownload: note guid = ")
+            << (note.hasGuid() ? note.guid() : QStringLiteral("<not set>")));
 
-    NoteStore & noteStore = m_manager.noteStore();
-    qevercloud::SyncChunk * pSyncChunk = Q_NULLPTR;
+    DownloadScheduler::Download download;
+    download.m_type = DownloadScheduler::DownloadType::Note;
+    download.m_priorityClass = downloadPriorityClassForNote(note);
+    download.m_urgency = downloadUrgencyForNote(note);
+    download.m_noteModificationTimestamp = (note.hasModificationTimestamp() ? note.modificationTimestamp() : 0);
+    download.m_note = note;
 
-    qint32 lastPreviousUsn = std::max(m_lastUpdateCount, 0);
-    QNDEBUG(QStringLiteral("Last previous USN: ") << lastPreviousUsn);
-
-    while(!pSyncChunk || (pSyncChunk->chunkHighUSN < pSyncChunk->updateCount))
+    const qevercloud::Note & qecNote = note.qevercloudNote();
+    qint64 estimatedSize = (qecNote.contentLength.isSet() ? static_cast<qint64>(qecNote.contentLength.ref()) : 0);
+    if (qecNote.resources.isSet())
     {
-        if (pSyncChunk) {
-            afterUsn = pSyncChunk->chunkHighUSN;
-            QNTRACE(QStringLiteral("Updated after USN to sync chunk's high USN: ") << pSyncChunk->chunkHighUSN);
+        const QList<qevercloud::Resource> & resources = qecNote.resources.ref();
+        for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+        {
+            if (it->data.isSet() && it->data->size.isSet()) {
+                estimatedSize += it->data->size.ref();
+            }
         }
+    }
 
-        m_syncChunks.push_back(qevercloud::SyncChunk());
-        pSyncChunk = &(m_syncChunks.back());
+    download.m_estimatedSize = estimatedSize;
 
-        qevercloud::SyncChunkFilter filter;
-        filter.includeNotebooks = true;
-        filter.includeNotes = true;
-        filter.includeTags = true;
-        filter.includeSearches = true;
-        filter.includeNoteResources = true;
-        filter.includeNoteAttributes = true;
-        filter.includeNoteApplicationDataFullMap = true;
-        filter.includeNoteResourceApplicationDataFullMap = true;
-        filter.includeLinkedNotebooks = true;
+    m_downloadScheduler.enqueue(download, QDateTime::currentMSecsSinceEpoch());
+    startScheduledDownloads();
+}
 
-        if (m_lastSyncMode == SyncMode::IncrementalSync) {
-            filter.includeExpunged = true;
-            filter.includeResources = true;
-        }
+void RemoteToLocalSynchronizationManager::scheduleFullResourceDataDownload(const Resource & resource,
+                                                                           const Note & resourceOwningNote)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::scheduleFullResourceDataDownload: resource guid = ")
+            << (resource.hasGuid() ? resource.guid() : QStringLiteral("<not set>")));
 
-        ErrorString errorDescription;
-        qint32 rateLimitSeconds = 0;
-        qint32 errorCode = noteStore.getSyncChunk(afterUsn, m_maxSyncChunksPerOneDownload, filter,
-                                                  *pSyncChunk, errorDescription, rateLimitSeconds);
-        if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
-        {
-            if (rateLimitSeconds <= 0) {
-                errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
-                errorDescription.details() = QString::number(rateLimitSeconds);
-                QNWARNING(errorDescription);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    DownloadScheduler::Download download;
+    download.m_type = DownloadScheduler::DownloadType::Resource;
+    download.m_priorityClass = downloadPriorityClassForNote(resourceOwningNote);
+    download.m_urgency = downloadUrgencyForNote(resourceOwningNote);
+    download.m_noteModificationTimestamp = (resourceOwningNote.hasModificationTimestamp()
+                                            ? resourceOwningNote.modificationTimestamp()
+                                            : 0);
+    download.m_estimatedSize = (resource.hasDataSize() ? static_cast<qint64>(resource.dataSize()) : 0);
+    download.m_note = resourceOwningNote;
+    download.m_resource = resource;
 
-            m_syncChunks.pop_back();
+    m_downloadScheduler.enqueue(download, QDateTime::currentMSecsSinceEpoch());
+    startScheduledDownloads();
+}
 
-            int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-            if (Q_UNLIKELY(timerId == 0)) {
-                ErrorString errorDescription(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
-                                                        "due to rate limit exceeding"));
-                QNWARNING(errorDescription);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+void RemoteToLocalSynchronizationManager::startScheduledDownloads()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::startScheduledDownloads: queue depth = ")
+            << m_downloadScheduler.queueDepth() << QStringLiteral(", in flight: ") << m_downloadScheduler.numInFlight()
+            << QStringLiteral(", window = ") << m_downloadScheduler.window());
 
-            m_afterUsnForSyncChunkPerAPICallPostponeTimerId[timerId] = afterUsn;
-            Q_EMIT rateLimitExceeded(rateLimitSeconds);
-            return;
-        }
-        else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-        {
-            handleAuthExpiration();
-            return;
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    DownloadScheduler::Download download;
+    while(m_downloadScheduler.takeNext(download, timestamp))
+    {
+        if (download.m_type == DownloadScheduler::DownloadType::Note) {
+            getFullNoteDataAsync(download.m_note);
         }
-        else if (errorCode != 0)
-        {
-            ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks"));
-            errorMessage.additionalBases().append(errorDescription.base());
-            errorMessage.additionalBases().append(errorDescription.additionalBases());
-            errorMessage.details() = errorDescription.details();
-            Q_EMIT failure(errorMessage);
-            return;
+        else {
+            getFullResourceDataAsync(download.m_resource, download.m_note);
         }
+    }
 
-        QNDEBUG(QStringLiteral("Received sync chunk: ") << *pSyncChunk);
-
-        m_lastSyncTime = std::max(pSyncChunk->currentTime, m_lastSyncTime);
-        m_lastUpdateCount = std::max(pSyncChunk->updateCount, m_lastUpdateCount);
+    if (m_downloadScheduler.queueDepth() == 0) {
+        return;
+    }
 
-        QNTRACE(QStringLiteral("Sync chunk current time: ") << printableDateTimeFromTimestamp(pSyncChunk->currentTime)
-                << QStringLiteral(", last sync time = ") << printableDateTimeFromTimestamp(m_lastSyncTime)
-                << QStringLiteral(", sync chunk high USN = ") << pSyncChunk->chunkHighUSN
-                << QStringLiteral(", sync chunk update count = ") << pSyncChunk->updateCount << QStringLiteral(", last update count = ")
-                << m_lastUpdateCount);
+    qint64 backoffRemainingMsec = m_downloadScheduler.backoffRemainingMsec(timestamp);
+    if ((backoffRemainingMsec <= 0) || (m_downloadSchedulerBackoffTimerId != 0)) {
+        // Either the queued downloads would be started once the downloads in flight finish
+        // or the timer to start them after the rate limit expiration is already running
+        return;
+    }
 
-        Q_EMIT syncChunksDownloadProgress(pSyncChunk->chunkHighUSN, pSyncChunk->updateCount, lastPreviousUsn);
+    m_downloadSchedulerBackoffTimerId = startTimer(static_cast<int>(backoffRemainingMsec));
+    if (Q_UNLIKELY(m_downloadSchedulerBackoffTimerId == 0)) {
+        ErrorString errorDescription(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
+                                                "due to rate limit exceeding"));
+        Q_EMIT failure(errorDescription);
+        return;
     }
 
-    QNDEBUG(QStringLiteral("Done. Processing tags, saved searches, linked notebooks and notebooks from buffered sync chunks"));
+    QNDEBUG(QStringLiteral("Started the timer to resume the downloads after the rate limit expiration: timer id = ")
+            << m_downloadSchedulerBackoffTimerId << QStringLiteral(", remaining msec = ") << backoffRemainingMsec);
+}
 
-    m_lastSyncChunksDownloadedUsn = afterUsn;
-    m_syncChunksDownloaded = true;
-    Q_EMIT syncChunksDownloaded();
+DownloadScheduler::PriorityClass::type RemoteToLocalSynchronizationManager::downloadPriorityClassForNote(const Note & note) const
+{
+    if (note.hasNotebookGuid() && m_linkedNotebookGuidsByNotebookGuids.contains(note.notebookGuid())) {
+        return DownloadScheduler::PriorityClass::LinkedNotebook;
+    }
 
-    launchSync();
+    return DownloadScheduler::PriorityClass::UserAccount;
 }
 
-const Notebook * RemoteToLocalSynchronizationManager::getNotebookPerNote(const Note & note) const
+DownloadScheduler::Urgency::type RemoteToLocalSynchronizationManager::downloadUrgencyForNote(const Note & note) const
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::getNotebookPerNote: note = ") << note);
+    if (note.hasGuid())
+    {
+        if (m_requestedNoteGuids.contains(note.guid())) {
+            return DownloadScheduler::Urgency::Requested;
+        }
 
-    QString noteGuid = (note.hasGuid() ? note.guid() : QString());
-    QString noteLocalUid = note.localUid();
+        if (m_visibleNoteGuids.contains(note.guid())) {
+            return DownloadScheduler::Urgency::Visible;
+        }
+    }
 
-    QPair<QString,QString> key(noteGuid, noteLocalUid);
-    auto it = m_notebooksPerNoteIds.find(key);
-    if (it == m_notebooksPerNoteIds.end()) {
-        return Q_NULLPTR;
+    if (!m_lastUsedNotebookGuid.isEmpty() && note.hasNotebookGuid() && (note.notebookGuid() == m_lastUsedNotebookGuid)) {
+        return DownloadScheduler::Urgency::LastUsedNotebook;
     }
-    else {
-        return &(it.value());
+
+    if (note.hasModificationTimestamp() &&
+        ((QDateTime::currentMSecsSinceEpoch() - note.modificationTimestamp()) <= RECENTLY_MODIFIED_NOTE_MAX_AGE_MSEC))
+    {
+        return DownloadScheduler::Urgency::RecentlyModified;
     }
+
+    return DownloadScheduler::Urgency::Regular;
 }
 
-void RemoteToLocalSynchronizationManager::handleAuthExpiration()
+void RemoteToLocalSynchronizationManager::updateScheduledDownloadsUrgency()
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::handleAuthExpiration"));
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::updateScheduledDownloadsUrgency: queue depth = ")
+            << m_downloadScheduler.queueDepth());
 
-    if (m_pendingAuthenticationTokenAndShardId) {
-        QNDEBUG(QStringLiteral("Already pending the authentication token and shard id"));
+    if (m_downloadScheduler.queueDepth() == 0) {
         return;
     }
 
-    m_pendingAuthenticationTokenAndShardId = true;
-    Q_EMIT requestAuthenticationToken();
+    QHash<QString,DownloadScheduler::Urgency::type> urgenciesByNoteGuid;
+    QList<DownloadScheduler::Download> downloads = m_downloadScheduler.downloads();
+    for(auto it = downloads.constBegin(), end = downloads.constEnd(); it != end; ++it)
+    {
+        const Note & note = it->m_note;
+        if (!note.hasGuid() || urgenciesByNoteGuid.contains(note.guid())) {
+            continue;
+        }
+
+        urgenciesByNoteGuid[note.guid()] = downloadUrgencyForNote(note);
+    }
+
+    Q_UNUSED(m_downloadScheduler.setUrgency(urgenciesByNoteGuid))
 }
 
-bool RemoteToLocalSynchronizationManager::checkUserAccountSyncState(bool & asyncWait, bool & error, qint32 & afterUsn)
+void RemoteToLocalSynchronizationManager::downloadSyncChunksAndLaunchSync(qint32 afterUsn)
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkUserAccountSyncState"));
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::downloadSyncChunksAndLaunchSync: after USN = ") << afterUsn);
+
+    if (m_syncChunks.isEmpty())
+    {
+        m_lastPreviousUsnOnSyncChunksDownload = std::max(m_lastUpdateCount, 0);
+        QNDEBUG(QStringLiteral("Last previous USN: ") << m_lastPreviousUsnOnSyncChunksDownload);
+
+        // NOTE: saved searches and notebooks are merged with the local storage while the rest of sync chunks
+        // are being downloaded; tags (which might have parents within the sync chunks not yet downloaded),
+        // linked notebooks, notes and resources are only processed once all the sync chunks are downloaded;
+        // until then these flags prevent the premature detection of sync completion
+        m_pendingTagsSyncStart = true;
+        m_pendingLinkedNotebooksSyncStart = true;
+        m_pendingNotebooksSyncStart = true;
+    }
+
+    qevercloud::SyncChunkFilter filter;
+    filter.includeNotes = true;
+    filter.includeNoteResources = true;
+    filter.includeNoteAttributes = true;
+    filter.includeNoteApplicationDataFullMap = true;
+    filter.includeNoteResourceApplicationDataFullMap = true;
+
+    // NOTE: only the notes are needed from the sync chunks downloaded in order to pick the notes skipped
+    // by the previous syncs due to the selective sync filter: the rest of data is already in sync
+    if (!m_selectiveSyncBackfillInProgress)
+    {
+        filter.includeNotebooks = true;
+        filter.includeTags = true;
+        filter.includeSearches = true;
+        filter.includeLinkedNotebooks = true;
+
+        if (m_lastSyncMode == SyncMode::IncrementalSync) {
+            filter.includeExpunged = true;
+            filter.includeResources = true;
+        }
+        else if (m_fullSyncResumedFromSyncCheckpoint) {
+            // The data items expunged from the service after the interruption of the full sync need to be
+            // excluded from the synced guids collected before the interruption
+            filter.includeExpunged = true;
+        }
+    }
+
+    beginSyncTraceSpan(SyncTracer::Phase::SyncChunksDownload, QString::number(afterUsn));
+
+    qint32 maxEntries = m_syncChunkWindow.window();
+    QNTRACE(QStringLiteral("Requesting the sync chunk with at most ") << maxEntries << QStringLiteral(" entries"));
+
+    ErrorString errorDescription;
+    bool res = m_manager.noteStore().getSyncChunkAsync(afterUsn, maxEntries, filter, errorDescription);
+    if (Q_UNLIKELY(!res)) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks"));
+        errorMessage.additionalBases().append(errorDescription.base());
+        errorMessage.additionalBases().append(errorDescription.additionalBases());
+        errorMessage.details() = errorDescription.details();
+        QNWARNING(errorMessage);
+        Q_EMIT failure(errorMessage);
+        return;
+    }
+
+    m_pendingSyncChunkAfterUsn = afterUsn;
+    m_pendingSyncChunkMaxEntries = maxEntries;
+    m_pendingSyncChunkRequestTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
+
+void RemoteToLocalSynchronizationManager::onGetSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk,
+                                                                      qint32 afterUsn, qint32 rateLimitSeconds,
+                                                                      ErrorString errorDescription)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onGetSyncChunkAsyncFinished: error code = ")
+            << errorCode << QStringLiteral(", after USN = ") << afterUsn << QStringLiteral(", rate limit seconds = ")
+            << rateLimitSeconds << QStringLiteral(", error description: ") << errorDescription);
+
+    if ((m_pendingSyncChunkAfterUsn < 0) || (m_pendingSyncChunkAfterUsn != afterUsn)) {
+        QNDEBUG(QStringLiteral("The sync chunk was not expected, ignoring it"));
+        return;
+    }
+
+    m_pendingSyncChunkAfterUsn = -1;
+    endSyncTraceSpan(SyncTracer::Phase::SyncChunksDownload, QString::number(afterUsn), (errorCode == 0 ? 1 : 0));
+
+    if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+    {
+        if (rateLimitSeconds <= 0) {
+            errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
+            errorDescription.details() = QString::number(rateLimitSeconds);
+            QNWARNING(errorDescription);
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+
+        m_syncChunkWindow.onRateLimitReached();
+        QNDEBUG(QStringLiteral("Rate limit reached during the sync chunk download, the sync chunk window is reduced to ")
+                << m_syncChunkWindow.window() << QStringLiteral(" entries"));
+
+        int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
+        if (Q_UNLIKELY(timerId == 0)) {
+            ErrorString errorDescription(QT_TR_NOOP("Failed to start a timer to postpone the Evernote API call "
+                                                    "due to rate limit exceeding"));
+            QNWARNING(errorDescription);
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+
+        m_afterUsnForSyncChunkPerAPICallPostponeTimerId[timerId] = afterUsn;
+        Q_EMIT rateLimitExceeded(rateLimitSeconds);
+        return;
+    }
+    else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
+    {
+        m_afterUsnForSyncChunkPendingAuthentication = afterUsn;
+        handleAuthExpiration();
+        return;
+    }
+    else if (errorCode != 0)
+    {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to download the sync chunks"));
+        errorMessage.additionalBases().append(errorDescription.base());
+        errorMessage.additionalBases().append(errorDescription.additionalBases());
+        errorMessage.details() = errorDescription.details();
+        Q_EMIT failure(errorMessage);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Received sync chunk: ") << syncChunk);
+
+    if (m_selectiveSyncBackfillInProgress && syncChunk.notes.isSet())
+    {
+        // The notes newer than the update count the sync has started from come within the regular sync chunks
+        QList<qevercloud::Note> & notes = syncChunk.notes.ref();
+        for(auto it = notes.begin(); it != notes.end(); )
+        {
+            if (it->updateSequenceNum.isSet() && (it->updateSequenceNum.ref() > m_selectiveSyncBackfillUpToUsn)) {
+                it = notes.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        removeNotesSyncedBeforeSelectiveSyncFilterChange(notes, m_selectiveSyncBackfillUpToUsn);
+    }
+
+    // NOTE: the sync chunks downloaded in order to pick the notes skipped by the previous syncs due to the selective
+    // sync filter are not a part of the full sync
+    if (!m_selectiveSyncBackfillInProgress) {
+        collectSyncedGuidsFromSyncChunk(syncChunk, m_fullSyncStaleDataItemsSyncedGuids);
+    }
+
+    ErrorString spoolErrorDescription;
+    if (!m_syncChunks.append(syncChunk, spoolErrorDescription)) {
+        ErrorString errorMessage(QT_TR_NOOP("Failed to store the downloaded sync chunk"));
+        errorMessage.additionalBases().append(spoolErrorDescription.base());
+        errorMessage.additionalBases().append(spoolErrorDescription.additionalBases());
+        errorMessage.details() = spoolErrorDescription.details();
+        Q_EMIT failure(errorMessage);
+        return;
+    }
+
+    m_lastSyncTime = std::max(syncChunk.currentTime, m_lastSyncTime);
+    m_lastUpdateCount = std::max(syncChunk.updateCount, m_lastUpdateCount);
+
+    QNTRACE(QStringLiteral("Sync chunk current time: ") << printableDateTimeFromTimestamp(syncChunk.currentTime)
+            << QStringLiteral(", last sync time = ") << printableDateTimeFromTimestamp(m_lastSyncTime)
+            << QStringLiteral(", sync chunk high USN = ")
+            << (syncChunk.chunkHighUSN.isSet() ? QString::number(syncChunk.chunkHighUSN.ref()) : QStringLiteral("<not set>"))
+            << QStringLiteral(", sync chunk update count = ") << syncChunk.updateCount << QStringLiteral(", last update count = ")
+            << m_lastUpdateCount);
+
+    // NOTE: the sync chunk has no high USN if there's nothing after the requested USN which is the case
+    // when the full sync resumed from the sync checkpoint was interrupted after all the sync chunks were downloaded
+    bool lastSyncChunk = (!syncChunk.chunkHighUSN.isSet() || (syncChunk.chunkHighUSN.ref() >= syncChunk.updateCount));
+
+    if (m_selectiveSyncBackfillInProgress) {
+        lastSyncChunk = lastSyncChunk || (syncChunk.chunkHighUSN.ref() >= m_selectiveSyncBackfillUpToUsn);
+    }
+    else {
+        Q_EMIT syncChunksDownloadProgress((syncChunk.chunkHighUSN.isSet() ? syncChunk.chunkHighUSN.ref() : syncChunk.updateCount),
+                                          syncChunk.updateCount, m_lastPreviousUsnOnSyncChunksDownload);
+    }
+
+    m_syncChunkWindow.onSyncChunkDownloaded(m_pendingSyncChunkMaxEntries,
+                                            QDateTime::currentMSecsSinceEpoch() - m_pendingSyncChunkRequestTimestamp,
+                                            m_syncChunks.estimatedMemoryUsage(m_syncChunks.size() - 1), lastSyncChunk);
+    QNTRACE(QStringLiteral("Sync chunk window: ") << m_syncChunkWindow.window() << QStringLiteral(" entries"));
+
+    if (!lastSyncChunk)
+    {
+        mergeSavedSearchesAndNotebooksFromDownloadedSyncChunks();
+        downloadNextSyncChunkOrWaitForLocalStorage();
+        return;
+    }
+
+    if (!m_selectiveSyncBackfillInProgress)
+    {
+        m_lastSyncChunksDownloadedUsn = afterUsn;
+
+        if (m_selectiveSyncBackfillUpToUsn > 0) {
+            QNDEBUG(QStringLiteral("Downloading the notes skipped by the previous syncs due to the selective sync filter, "
+                                   "up to USN ") << m_selectiveSyncBackfillUpToUsn);
+            m_selectiveSyncBackfillInProgress = true;
+            mergeSavedSearchesAndNotebooksFromDownloadedSyncChunks();
+            downloadSyncChunksAndLaunchSync(0);
+            return;
+        }
+    }
+
+    QNDEBUG(QStringLiteral("Done. Processing tags, saved searches, linked notebooks and notebooks from buffered sync chunks"));
+
+    m_syncChunksDownloaded = true;
+    Q_EMIT syncChunksDownloaded();
+
+    QNINFO(QStringLiteral("Downloaded sync chunks: ") << m_syncChunks.statistics());
+    QNINFO(QStringLiteral("Sync chunk sizing: ") << m_syncChunkWindow.metrics());
+
+    launchSync();
+}
+
+void RemoteToLocalSynchronizationManager::downloadNextSyncChunkOrWaitForLocalStorage()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::downloadNextSyncChunkOrWaitForLocalStorage"));
+
+    if (Q_UNLIKELY(m_syncChunks.isEmpty())) {
+        ErrorString errorDescription(QT_TR_NOOP("Internal error: no sync chunks were downloaded "
+                                                "before the attempt to download the next one"));
+        QNWARNING(errorDescription);
+        Q_EMIT failure(errorDescription);
+        return;
+    }
+
+    // Not starting the download of the next sync chunk if the local storage can't keep up with the processing
+    // of data elements from the already downloaded ones: in this case the sync chunks would just pile up in memory;
+    // the download is resumed from the completion handlers of local storage requests once enough of them are done
+    int numPendingLocalStorageRequests = numPendingSavedSearchesAndNotebooksLocalStorageRequests();
+    if (numPendingLocalStorageRequests > SYNC_CHUNKS_DOWNLOAD_MAX_PENDING_LOCAL_STORAGE_REQUESTS)
+    {
+        QNDEBUG(QStringLiteral("There are ") << numPendingLocalStorageRequests
+                << QStringLiteral(" pending local storage requests, postponing the download of the next sync chunk"));
+        m_syncChunksDownloadPostponedByLocalStorage = true;
+        return;
+    }
+
+    qint32 afterUsn = m_syncChunks.back().chunkHighUSN;
+    QNTRACE(QStringLiteral("Updated after USN to sync chunk's high USN: ") << afterUsn);
+
+    downloadSyncChunksAndLaunchSync(afterUsn);
+}
+
+void RemoteToLocalSynchronizationManager::resumeSyncChunksDownloadPostponedByLocalStorage()
+{
+    if (!m_syncChunksDownloadPostponedByLocalStorage) {
+        return;
+    }
+
+    int numPendingLocalStorageRequests = numPendingSavedSearchesAndNotebooksLocalStorageRequests();
+    if (numPendingLocalStorageRequests > SYNC_CHUNKS_DOWNLOAD_RESUME_PENDING_LOCAL_STORAGE_REQUESTS) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::resumeSyncChunksDownloadPostponedByLocalStorage: ")
+            << numPendingLocalStorageRequests << QStringLiteral(" pending local storage requests left"));
+
+    m_syncChunksDownloadPostponedByLocalStorage = false;
+    downloadNextSyncChunkOrWaitForLocalStorage();
+}
+
+int RemoteToLocalSynchronizationManager::numPendingSavedSearchesAndNotebooksLocalStorageRequests() const
+{
+    return m_findSavedSearchByGuidRequestIds.size() + m_findSavedSearchByNameRequestIds.size() +
+           m_addSavedSearchRequestIds.size() + m_updateSavedSearchRequestIds.size() +
+           m_findNotebookByGuidRequestIds.size() + m_findNotebookByNameRequestIds.size() +
+           m_addNotebookRequestIds.size() + m_updateNotebookRequestIds.size();
+}
+
+const Notebook * RemoteToLocalSynchronizationManager::getNotebookPerNote(const Note & note) const
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::getNotebookPerNote: note = ") << note);
+
+    QString noteGuid = (note.hasGuid() ? note.guid() : QString());
+    QString noteLocalUid = note.localUid();
+
+    QPair<QString,QString> key(noteGuid, noteLocalUid);
+    auto it = m_notebooksPerNoteIds.find(key);
+    if (it == m_notebooksPerNoteIds.end()) {
+        return Q_NULLPTR;
+    }
+    else {
+        return &(it.value());
+    }
+}
+
+void RemoteToLocalSynchronizationManager::handleAuthExpiration()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::handleAuthExpiration"));
+
+    if (m_pendingAuthenticationTokenAndShardId) {
+        QNDEBUG(QStringLiteral("Already pending the authentication token and shard id"));
+        return;
+    }
+
+    m_pendingAuthenticationTokenAndShardId = true;
+    Q_EMIT requestAuthenticationToken();
+}
+
+bool RemoteToLocalSynchronizationManager::checkUserAccountSyncState(bool & asyncWait, bool & error, qint32 & afterUsn)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::checkUserAccountSyncState"));
 
     asyncWait = false;
     error = false;
@@ -6783,12 +8642,14 @@ bool RemoteToLocalSynchronizationManager::findNotebookForInkNoteImageDownloading
     return true;
 }
 
-void RemoteToLocalSynchronizationManager::setupInkNoteImageDownloading(const QString & resourceGuid, const int resourceHeight,
-                                                                       const int resourceWidth, const QString & noteGuid,
-                                                                       const Notebook & notebook)
+void RemoteToLocalSynchronizationManager::setupInkNoteImageDownloading(const QString & resourceGuid,
+                                                                       const QByteArray & resourceDataHash,
+                                                                       const int resourceHeight, const int resourceWidth,
+                                                                       const QString & noteGuid, const Notebook & notebook)
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::setupInkNoteImageDownloading: resource guid = ")
-            << resourceGuid << QStringLiteral(", resource height = ") << resourceHeight << QStringLiteral(", resource width = ")
+            << resourceGuid << QStringLiteral(", resource data hash = ") << resourceDataHash.toHex()
+            << QStringLiteral(", resource height = ") << resourceHeight << QStringLiteral(", resource width = ")
             << resourceWidth << QStringLiteral(", note guid = ") << noteGuid << QStringLiteral(", notebook: ") << notebook);
 
     QString authToken, shardId;
@@ -6804,21 +8665,10 @@ void RemoteToLocalSynchronizationManager::setupInkNoteImageDownloading(const QSt
     Q_UNUSED(m_resourceGuidsPendingInkNoteImageDownloadPerNoteGuid.insert(noteGuid, resourceGuid))
     QString storageFolderPath = inkNoteImagesStoragePath();
 
-    InkNoteImageDownloader * pDownloader = new InkNoteImageDownloader(m_host, resourceGuid, noteGuid, authToken,
-                                                                      shardId, resourceHeight, resourceWidth,
-                                                                      /* from public linked notebook = */
-                                                                      isPublicNotebook, storageFolderPath, this);
-    QObject::connect(pDownloader, QNSIGNAL(InkNoteImageDownloader,finished,bool,QString,QString,ErrorString),
-                     this, QNSLOT(RemoteToLocalSynchronizationManager,onInkNoteImageDownloadFinished,bool,QString,QString,ErrorString));
-
-    // WARNING: it seems it's not possible to run ink note image downloading
-    // in a different thread, the error like this might appear: QObject: Cannot
-    // create children for a parent that is in a different thread.
-    // (Parent is QNetworkAccessManager(0x499b900), parent's thread is QThread(0x1b535b0), current thread is QThread(0x42ed270)
-
-    // QThreadPool::globalInstance()->start(pDownloader);
-
-    pDownloader->run();
+    m_noteImagesDownloadManager.downloadInkNoteImage(m_host, resourceGuid, noteGuid, resourceDataHash, authToken,
+                                                     shardId, resourceHeight, resourceWidth,
+                                                     /* from public linked notebook = */ isPublicNotebook,
+                                                     storageFolderPath, noteImagesDownloadPriorityClass(notebook));
 }
 
 bool RemoteToLocalSynchronizationManager::setupInkNoteImageDownloadingForNote(const Note & note, const Notebook & notebook)
@@ -6850,7 +8700,8 @@ bool RemoteToLocalSynchronizationManager::setupInkNoteImageDownloadingForNote(co
         if (resource.hasGuid() && resource.hasMime() && resource.hasWidth() && resource.hasHeight() &&
             (resource.mime() == QStringLiteral("application/vnd.evernote.ink")))
         {
-            setupInkNoteImageDownloading(resource.guid(), resource.height(), resource.width(), note.guid(), notebook);
+            setupInkNoteImageDownloading(resource.guid(), (resource.hasDataHash() ? resource.dataHash() : QByteArray()),
+                                         resource.height(), resource.width(), note.guid(), notebook);
         }
     }
 
@@ -6917,15 +8768,21 @@ bool RemoteToLocalSynchronizationManager::setupNoteThumbnailDownloading(const No
     bool isPublicNotebook = false;
     authenticationInfoForNotebook(notebook, authToken, shardId, isPublicNotebook);
 
-    NoteThumbnailDownloader * pDownloader = new NoteThumbnailDownloader(m_host, noteGuid, authToken, shardId,
-                                                                        /* from public linked notebook = */
-                                                                        isPublicNotebook, this);
-    QObject::connect(pDownloader, QNSIGNAL(NoteThumbnailDownloader,finished,bool,QString,QByteArray,ErrorString),
-                     this, QNSLOT(RemoteToLocalSynchronizationManager,onNoteThumbnailDownloadingFinished,bool,QString,QByteArray,ErrorString));
-    pDownloader->start();
+    m_noteImagesDownloadManager.downloadNoteThumbnail(m_host, noteGuid,
+                                                      (note.hasContentHash() ? note.contentHash() : QByteArray()),
+                                                      authToken, shardId,
+                                                      /* from public linked notebook = */ isPublicNotebook,
+                                                      noteImagesDownloadPriorityClass(notebook));
     return true;
 }
 
+NoteImagesDownloadManager::PriorityClass::type RemoteToLocalSynchronizationManager::noteImagesDownloadPriorityClass(const Notebook & notebook) const
+{
+    return (notebook.hasLinkedNotebookGuid()
+            ? NoteImagesDownloadManager::PriorityClass::LinkedNotebook
+            : NoteImagesDownloadManager::PriorityClass::UserAccount);
+}
+
 QString RemoteToLocalSynchronizationManager::clientNameForProtocolVersionCheck() const
 {
     QString clientName = QCoreApplication::applicationName();
@@ -7068,6 +8925,21 @@ qint32 RemoteToLocalSynchronizationManager::nonProcessedItemsSmallestUsn(const Q
 
     QHash<QString,QString> dummyHash;
 
+    // The notes and resources being downloaded are in none of the containers below until the download is finished;
+    // they must not be considered processed or the sync checkpoint could move past them
+    NotesList notesPendingDownload;
+    ResourcesList resourcesPendingDownload;
+    QList<DownloadScheduler::Download> downloads = m_downloadScheduler.downloads();
+    for(auto it = downloads.constBegin(), end = downloads.constEnd(); it != end; ++it)
+    {
+        if (it->m_type == DownloadScheduler::DownloadType::Note) {
+            notesPendingDownload << it->m_note.qevercloudNote();
+        }
+        else {
+            resourcesPendingDownload << it->m_resource.qevercloudResource();
+        }
+    }
+
     PROCESS_CONTAINER(m_tags, m_linkedNotebookGuidsByTagGuids)
     PROCESS_CONTAINER(m_tagsPendingAddOrUpdate, m_linkedNotebookGuidsByTagGuids)
     PROCESS_CONTAINER(m_savedSearches, dummyHash)
@@ -7080,46 +8952,48 @@ qint32 RemoteToLocalSynchronizationManager::nonProcessedItemsSmallestUsn(const Q
     bool syncingNotebooks = m_pendingNotebooksSyncStart || notebooksSyncInProgress();
     bool syncingTags = m_pendingTagsSyncStart || tagsSyncInProgress();
 
-    if (linkedNotebookGuid.isEmpty())
-    {
-        if (syncingNotebooks || syncingTags)
-        {
-            // That means the sync of notes hasn't started yet so we need to check notes from sync chunks
-            for(auto it = m_syncChunks.constBegin(), end = m_syncChunks.constEnd(); it != end; ++it)
-            {
-                const qevercloud::SyncChunk & syncChunk = *it;
-                if (!syncChunk.notes.isSet()) {
-                    continue;
-                }
+    // The notes not taken from the sync chunks for processing yet are pending processing; so are the resources
+    // unless the notes sync is over and no individual resources are to be taken from the sync chunks
+    bool resourcesPendingWithinSyncChunks = syncingNotebooks || syncingTags || notesSyncInProgress() ||
+                                            resourcesPendingTakingFromSyncChunks();
 
-                PROCESS_CONTAINER(syncChunk.notes.ref(), dummyHash)
-            }
+    // NOTE: the smallest update sequence numbers of notes and resources are recorded per sync chunk
+    // when it is appended to the spool so the sync chunks don't need to be read back from the spool here
+    const SyncChunkSpool & syncChunks = (linkedNotebookGuid.isEmpty() ? m_syncChunks : m_linkedNotebookSyncChunks);
+    for(int i = 0, numSyncChunks = syncChunks.size(); i < numSyncChunks; ++i)
+    {
+        if (!linkedNotebookGuid.isEmpty() && (m_linkedNotebookGuidsOfLinkedNotebookSyncChunks.value(i) != linkedNotebookGuid)) {
+            continue;
         }
-        else
-        {
-            PROCESS_CONTAINER(m_notes, dummyHash)
-            PROCESS_CONTAINER(m_notesPendingAddOrUpdate, dummyHash)
+
+        qint32 syncChunkSmallestUsn = -1;
+        if (!syncChunks.notesTaken(i)) {
+            syncChunkSmallestUsn = syncChunks.notesSmallestUsn(i);
         }
 
-        if (syncingNotebooks || syncingTags || notesSyncInProgress())
+        if (resourcesPendingWithinSyncChunks && !syncChunks.resourcesTaken(i))
         {
-            // That means the sync of resources hasn't started yet so we need to check resources from sync chunks
-            for(auto it = m_syncChunks.constBegin(), end = m_syncChunks.constEnd(); it != end; ++it)
-            {
-                const qevercloud::SyncChunk & syncChunk = *it;
-                if (!syncChunk.resources.isSet()) {
-                    continue;
-                }
-
-                PROCESS_CONTAINER(syncChunk.resources.ref(), dummyHash)
+            qint32 resourcesSmallestUsn = syncChunks.resourcesSmallestUsn(i);
+            if ((resourcesSmallestUsn >= 0) && ((syncChunkSmallestUsn < 0) || (resourcesSmallestUsn < syncChunkSmallestUsn))) {
+                syncChunkSmallestUsn = resourcesSmallestUsn;
             }
         }
-        else
-        {
-            PROCESS_CONTAINER(m_resources, dummyHash)
-            PROCESS_CONTAINER(m_resourcesPendingAddOrUpdate, dummyHash)
+
+        if ((syncChunkSmallestUsn >= 0) && ((smallestUsn < 0) || (syncChunkSmallestUsn < smallestUsn))) {
+            smallestUsn = syncChunkSmallestUsn;
         }
     }
+
+    if (linkedNotebookGuid.isEmpty())
+    {
+        PROCESS_CONTAINER(m_notes, dummyHash)
+        PROCESS_CONTAINER(m_notesPendingAddOrUpdate, dummyHash)
+        PROCESS_CONTAINER(notesPendingDownload, dummyHash)
+
+        PROCESS_CONTAINER(m_resources, dummyHash)
+        PROCESS_CONTAINER(m_resourcesPendingAddOrUpdate, dummyHash)
+        PROCESS_CONTAINER(resourcesPendingDownload, dummyHash)
+    }
     else
     {
         // The mapping between linked notebook guids and note guids is implicit, through notebook guid;
@@ -7130,134 +9004,79 @@ qint32 RemoteToLocalSynchronizationManager::nonProcessedItemsSmallestUsn(const Q
         // need to make it explicit here in order to reuse the macro
         QHash<QString,QString> linkedNotebookGuidsByResourceGuids;
 
-        bool syncingNotes = notesSyncInProgress();
-        if (syncingNotebooks || syncingTags || syncingNotes)
+        QList<qevercloud::Note> localNotesList;
+        for(auto it = m_notes.constBegin(), end = m_notes.constEnd(); it != end; ++it) {
+            localNotesList << *it;
+        }
+
+        for(auto it = m_notesPendingAddOrUpdate.constBegin(), end = m_notesPendingAddOrUpdate.constEnd(); it != end; ++it) {
+            localNotesList << *it;
+        }
+
+        for(auto it = notesPendingDownload.constBegin(), end = notesPendingDownload.constEnd(); it != end; ++it) {
+            localNotesList << *it;
+        }
+
+        for(auto noteIt = localNotesList.constBegin(), notesEnd = localNotesList.constEnd(); noteIt != notesEnd; ++noteIt)
         {
-            NotesList localNotesList;
-            if (syncingNotebooks || syncingTags)
-            {
-                // That means the sync of notes hasn't started yet so the notes are still within the sync chunks
-                for(auto it = m_linkedNotebookSyncChunks.constBegin(), end = m_linkedNotebookSyncChunks.constEnd(); it != end; ++it)
-                {
-                    const qevercloud::SyncChunk & syncChunk = *it;
-                    if (!syncChunk.notes.isSet()) {
-                        continue;
-                    }
+            const qevercloud::Note & note = *noteIt;
+            if (Q_UNLIKELY(!note.guid.isSet())) {
+                QNWARNING(QStringLiteral("Skipping note without guid: ") << note);
+                continue;
+            }
 
-                    localNotesList << syncChunk.notes.ref();
-                }
+            if (!note.notebookGuid.isSet()) {
+                QNWARNING(QStringLiteral("Skipping note without notebook guid: ") << note);
+                continue;
             }
-            else
-            {
-                // The sync of notes has already started so the pending notes are in either of two containers
-                localNotesList << m_notes;
-                localNotesList << m_notesPendingAddOrUpdate;
+
+            auto linkedNotebookGuidIt = m_linkedNotebookGuidsByNotebookGuids.find(note.notebookGuid.ref());
+            if (linkedNotebookGuidIt == m_linkedNotebookGuidsByNotebookGuids.end()) {
+                QNTRACE(QStringLiteral("Skipping note without linked notebook mapping: ") << note);
+                continue;
             }
 
-            for(auto noteIt = localNotesList.constBegin(), notesEnd = localNotesList.constEnd(); noteIt != notesEnd; ++noteIt)
-            {
-                const qevercloud::Note & note = *noteIt;
-                if (Q_UNLIKELY(!note.guid.isSet())) {
-                    QNWARNING(QStringLiteral("Skipping note without guid: ") << note);
-                    continue;
-                }
+            linkedNotebookGuidsByNoteGuids[note.guid.ref()] = linkedNotebookGuidIt.value();
+        }
 
-                if (!note.notebookGuid.isSet()) {
-                    QNWARNING(QStringLiteral("Skipping note without notebook guid: ") << note);
-                    continue;
-                }
+        QList<qevercloud::Resource> localResourcesList;
+        for(auto it = m_resources.constBegin(), end = m_resources.constEnd(); it != end; ++it) {
+            localResourcesList << *it;
+        }
 
-                auto linkedNotebookGuidIt = m_linkedNotebookGuidsByNotebookGuids.find(note.notebookGuid.ref());
-                if (linkedNotebookGuidIt == m_linkedNotebookGuidsByNotebookGuids.end()) {
-                    QNTRACE(QStringLiteral("Skipping note without linked notebook mapping: ") << note);
-                    continue;
-                }
+        for(auto it = m_resourcesPendingAddOrUpdate.constBegin(), end = m_resourcesPendingAddOrUpdate.constEnd(); it != end; ++it) {
+            localResourcesList << *it;
+        }
 
-                linkedNotebookGuidsByNoteGuids[note.guid.ref()] = linkedNotebookGuidIt.value();
-            }
+        for(auto it = resourcesPendingDownload.constBegin(), end = resourcesPendingDownload.constEnd(); it != end; ++it) {
+            localResourcesList << *it;
+        }
 
-            ResourcesList localResourcesList;
-            if (syncingNotes)
-            {
-                // That means the sync of resources hasn't started yet so the resources are still within the sync chunks
-                for(auto it = m_linkedNotebookSyncChunks.constBegin(), end = m_linkedNotebookSyncChunks.constEnd(); it != end; ++it)
-                {
-                    const qevercloud::SyncChunk & syncChunk = *it;
-                    if (!syncChunk.resources.isSet()) {
-                        continue;
-                    }
+        for(auto resourceIt = localResourcesList.constBegin(), resourcesEnd = localResourcesList.constEnd();
+            resourceIt != resourcesEnd; ++resourceIt)
+        {
+            const qevercloud::Resource & resource = *resourceIt;
+            if (Q_UNLIKELY(!resource.guid.isSet())) {
+                QNWARNING(QStringLiteral("Skipping resource without guid: ") << resource);
+                continue;
+            }
 
-                    localResourcesList << syncChunk.resources.ref();
-                }
+            if (Q_UNLIKELY(!resource.noteGuid.isSet())) {
+                QNWARNING(QStringLiteral("Skipping resource without note guid: ") << resource);
+                continue;
             }
-            else
-            {
-                // The sync of resources has already started so the pending resources are in either of two containers
-                localResourcesList << m_resources;
-                localResourcesList << m_resourcesPendingAddOrUpdate;
-            }
-
-            for(auto resourceIt = localResourcesList.constBegin(), resourcesEnd = localResourcesList.constEnd();
-                resourceIt != resourcesEnd; ++resourceIt)
-            {
-                const qevercloud::Resource & resource = *resourceIt;
-                if (Q_UNLIKELY(!resource.guid.isSet())) {
-                    QNWARNING(QStringLiteral("Skipping resource without guid: ") << resource);
-                    continue;
-                }
 
-                if (Q_UNLIKELY(!resource.noteGuid.isSet())) {
-                    QNWARNING(QStringLiteral("Skipping resource without note guid: ") << resource);
-                    continue;
-                }
-
-                auto linkedNotebookGuidIt = linkedNotebookGuidsByNoteGuids.find(resource.noteGuid.ref());
-                if (linkedNotebookGuidIt == linkedNotebookGuidsByNoteGuids.end()) {
-                    QNTRACE(QStringLiteral("Skipping resource without linked notebook mapping: ") << resource);
-                    continue;
-                }
-
-                linkedNotebookGuidsByResourceGuids[resource.guid.ref()] = linkedNotebookGuidIt.value();
+            auto linkedNotebookGuidIt = linkedNotebookGuidsByNoteGuids.find(resource.noteGuid.ref());
+            if (linkedNotebookGuidIt == linkedNotebookGuidsByNoteGuids.end()) {
+                QNTRACE(QStringLiteral("Skipping resource without linked notebook mapping: ") << resource);
+                continue;
             }
-        }
 
-        if (syncingNotebooks || syncingTags)
-        {
-            // That means the sync of notes hasn't started yet so we need to check notes from sync chunks
-            for(auto it = m_linkedNotebookSyncChunks.constBegin(), end = m_linkedNotebookSyncChunks.constEnd(); it != end; ++it)
-            {
-                const qevercloud::SyncChunk & syncChunk = *it;
-                if (!syncChunk.notes.isSet()) {
-                    continue;
-                }
-
-                PROCESS_CONTAINER(syncChunk.notes.ref(), linkedNotebookGuidsByNoteGuids)
-            }
+            linkedNotebookGuidsByResourceGuids[resource.guid.ref()] = linkedNotebookGuidIt.value();
         }
-        else
-        {
-            PROCESS_CONTAINER(m_notes, linkedNotebookGuidsByNoteGuids)
-            PROCESS_CONTAINER(m_notesPendingAddOrUpdate, linkedNotebookGuidsByNoteGuids)
-        }
-
-        if (syncingNotebooks || syncingTags || syncingNotes)
-        {
-            // That means the sync of resources hasn't started yet so we need to check resources from sync chunks
-            for(auto it = m_linkedNotebookSyncChunks.constBegin(), end = m_linkedNotebookSyncChunks.constEnd(); it != end; ++it)
-            {
-                const qevercloud::SyncChunk & syncChunk = *it;
-                if (!syncChunk.resources.isSet()) {
-                    continue;
-                }
 
-                PROCESS_CONTAINER(syncChunk.resources.ref(), linkedNotebookGuidsByResourceGuids)
-            }
-        }
-        else
-        {
-            PROCESS_CONTAINER(m_resources, linkedNotebookGuidsByResourceGuids)
-            PROCESS_CONTAINER(m_resourcesPendingAddOrUpdate, linkedNotebookGuidsByResourceGuids)
-        }
+        PROCESS_CONTAINER(localNotesList, linkedNotebookGuidsByNoteGuids)
+        PROCESS_CONTAINER(localResourcesList, linkedNotebookGuidsByResourceGuids)
     }
 
 #undef PROCESS_CONTAINER
@@ -7273,9 +9092,7 @@ void RemoteToLocalSynchronizationManager::registerTagPendingAddOrUpdate(const Ta
         return;
     }
 
-    auto it = std::find_if(m_tagsPendingAddOrUpdate.begin(), m_tagsPendingAddOrUpdate.end(),
-                           CompareItemByGuid<TagsList::value_type>(tag.guid()));
-    if (it == m_tagsPendingAddOrUpdate.end()) {
+    if (!m_tagsPendingAddOrUpdate.containsGuid(tag.guid())) {
         m_tagsPendingAddOrUpdate << tag.qevercloudTag();
     }
 }
@@ -7288,9 +9105,7 @@ void RemoteToLocalSynchronizationManager::registerSavedSearchPendingAddOrUpdate(
         return;
     }
 
-    auto it = std::find_if(m_savedSearchesPendingAddOrUpdate.begin(), m_savedSearchesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<SavedSearchesList::value_type>(search.guid()));
-    if (it == m_savedSearchesPendingAddOrUpdate.end()) {
+    if (!m_savedSearchesPendingAddOrUpdate.containsGuid(search.guid())) {
         m_savedSearchesPendingAddOrUpdate << search.qevercloudSavedSearch();
     }
 }
@@ -7303,9 +9118,7 @@ void RemoteToLocalSynchronizationManager::registerLinkedNotebookPendingAddOrUpda
         return;
     }
 
-    auto it = std::find_if(m_linkedNotebooksPendingAddOrUpdate.begin(), m_linkedNotebooksPendingAddOrUpdate.end(),
-                           CompareItemByGuid<LinkedNotebooksList::value_type>(linkedNotebook.guid()));
-    if (it == m_linkedNotebooksPendingAddOrUpdate.end()) {
+    if (!m_linkedNotebooksPendingAddOrUpdate.containsGuid(linkedNotebook.guid())) {
         m_linkedNotebooksPendingAddOrUpdate << linkedNotebook.qevercloudLinkedNotebook();
     }
 }
@@ -7318,9 +9131,7 @@ void RemoteToLocalSynchronizationManager::registerNotebookPendingAddOrUpdate(con
         return;
     }
 
-    auto it = std::find_if(m_notebooksPendingAddOrUpdate.begin(), m_notebooksPendingAddOrUpdate.end(),
-                           CompareItemByGuid<NotebooksList::value_type>(notebook.guid()));
-    if (it == m_notebooksPendingAddOrUpdate.end()) {
+    if (!m_notebooksPendingAddOrUpdate.containsGuid(notebook.guid())) {
         m_notebooksPendingAddOrUpdate << notebook.qevercloudNotebook();
     }
 }
@@ -7333,9 +9144,7 @@ void RemoteToLocalSynchronizationManager::registerNotePendingAddOrUpdate(const N
         return;
     }
 
-    auto it = std::find_if(m_notesPendingAddOrUpdate.begin(), m_notesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<NotesList::value_type>(note.guid()));
-    if (it == m_notesPendingAddOrUpdate.end()) {
+    if (!m_notesPendingAddOrUpdate.containsGuid(note.guid())) {
         m_notesPendingAddOrUpdate << note.qevercloudNote();
     }
 }
@@ -7348,9 +9157,7 @@ void RemoteToLocalSynchronizationManager::registerResourcePendingAddOrUpdate(con
         return;
     }
 
-    auto it = std::find_if(m_resourcesPendingAddOrUpdate.begin(), m_resourcesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<ResourcesList::value_type>(resource.guid()));
-    if (it == m_resourcesPendingAddOrUpdate.end()) {
+    if (!m_resourcesPendingAddOrUpdate.containsGuid(resource.guid())) {
         m_resourcesPendingAddOrUpdate << resource.qevercloudResource();
     }
 }
@@ -7363,11 +9170,7 @@ void RemoteToLocalSynchronizationManager::unregisterTagPendingAddOrUpdate(const
         return;
     }
 
-    auto it = std::find_if(m_tagsPendingAddOrUpdate.begin(), m_tagsPendingAddOrUpdate.end(),
-                           CompareItemByGuid<TagsList::value_type>(tag.guid()));
-    if (it != m_tagsPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_tagsPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_tagsPendingAddOrUpdate.removeByGuid(tag.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::unregisterSavedSearchPendingAddOrUpdate(const SavedSearch & search)
@@ -7378,11 +9181,7 @@ void RemoteToLocalSynchronizationManager::unregisterSavedSearchPendingAddOrUpdat
         return;
     }
 
-    auto it = std::find_if(m_savedSearchesPendingAddOrUpdate.begin(), m_savedSearchesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<SavedSearchesList::value_type>(search.guid()));
-    if (it != m_savedSearchesPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_savedSearchesPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_savedSearchesPendingAddOrUpdate.removeByGuid(search.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::unregisterLinkedNotebookPendingAddOrUpdate(const LinkedNotebook & linkedNotebook)
@@ -7393,11 +9192,7 @@ void RemoteToLocalSynchronizationManager::unregisterLinkedNotebookPendingAddOrUp
         return;
     }
 
-    auto it = std::find_if(m_linkedNotebooksPendingAddOrUpdate.begin(), m_linkedNotebooksPendingAddOrUpdate.end(),
-                           CompareItemByGuid<LinkedNotebooksList::value_type>(linkedNotebook.guid()));
-    if (it != m_linkedNotebooksPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_linkedNotebooksPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_linkedNotebooksPendingAddOrUpdate.removeByGuid(linkedNotebook.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::unregisterNotebookPendingAddOrUpdate(const Notebook & notebook)
@@ -7408,11 +9203,7 @@ void RemoteToLocalSynchronizationManager::unregisterNotebookPendingAddOrUpdate(c
         return;
     }
 
-    auto it = std::find_if(m_notebooksPendingAddOrUpdate.begin(), m_notebooksPendingAddOrUpdate.end(),
-                           CompareItemByGuid<NotebooksList::value_type>(notebook.guid()));
-    if (it != m_notebooksPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_notebooksPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_notebooksPendingAddOrUpdate.removeByGuid(notebook.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::unregisterNotePendingAddOrUpdate(const Note & note)
@@ -7423,11 +9214,7 @@ void RemoteToLocalSynchronizationManager::unregisterNotePendingAddOrUpdate(const
         return;
     }
 
-    auto it = std::find_if(m_notesPendingAddOrUpdate.begin(), m_notesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<NotesList::value_type>(note.guid()));
-    if (it != m_notesPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_notesPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_notesPendingAddOrUpdate.removeByGuid(note.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::unregisterResourcePendingAddOrUpdate(const Resource & resource)
@@ -7438,11 +9225,7 @@ void RemoteToLocalSynchronizationManager::unregisterResourcePendingAddOrUpdate(c
         return;
     }
 
-    auto it = std::find_if(m_resourcesPendingAddOrUpdate.begin(), m_resourcesPendingAddOrUpdate.end(),
-                           CompareItemByGuid<ResourcesList::value_type>(resource.guid()));
-    if (it != m_resourcesPendingAddOrUpdate.end()) {
-        Q_UNUSED(m_resourcesPendingAddOrUpdate.erase(it))
-    }
+    Q_UNUSED(m_resourcesPendingAddOrUpdate.removeByGuid(resource.guid()))
 }
 
 void RemoteToLocalSynchronizationManager::overrideLocalNoteWithRemoteNote(Note & localNote, const qevercloud::Note & remoteNote) const
@@ -7544,7 +9327,7 @@ void RemoteToLocalSynchronizationManager::processResourceConflictAsNoteConflict(
 {
     QString authToken;
     ErrorString errorDescription;
-    NoteStore * pNoteStore = noteStoreForNote(remoteNote, authToken, errorDescription);
+    INoteStore * pNoteStore = noteStoreForNote(remoteNote, authToken, errorDescription);
     if (Q_UNLIKELY(!pNoteStore)) {
         Q_EMIT failure(errorDescription);
         return;
@@ -7632,6 +9415,7 @@ void RemoteToLocalSynchronizationManager::processResourceConflictAsNoteConflict(
     registerNotePendingAddOrUpdate(remoteNote);
     QUuid updateNoteRequestId = QUuid::createUuid();
     Q_UNUSED(m_updateNoteRequestIds.insert(updateNoteRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateNoteRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to update the remote note in local storage: request id = ")
             << updateNoteRequestId << QStringLiteral(", note; ") << remoteNote);
     Q_EMIT updateNote(remoteNote, /* update resources = */ true, /* update tags = */ true, updateNoteRequestId);
@@ -7640,17 +9424,58 @@ void RemoteToLocalSynchronizationManager::processResourceConflictAsNoteConflict(
     emitAddRequest(localConflictingNote);
 }
 
-void RemoteToLocalSynchronizationManager::syncNextTagPendingProcessing()
+void RemoteToLocalSynchronizationManager::syncNextTagsLevelPendingProcessing()
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::syncNextTagPendingProcessing"));
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::syncNextTagsLevelPendingProcessing"));
 
-    if (m_tagsPendingProcessing.isEmpty()) {
+    if (m_tagsPendingProcessing.isEmpty() || m_tagsPendingProcessingLevelSizes.isEmpty()) {
         QNDEBUG(QStringLiteral("No tags pending for processing, nothing more to sync"));
+        m_tagsPendingProcessing.clear();
+        m_tagsPendingProcessingLevelSizes.clear();
+        return;
+    }
+
+    int levelSize = std::min(m_tagsPendingProcessingLevelSizes.takeFirst(), m_tagsPendingProcessing.size());
+    QNDEBUG(QStringLiteral("Starting to process the next level of tags: ") << levelSize
+            << QStringLiteral(" tags, ") << m_tagsPendingProcessingLevelSizes.size()
+            << QStringLiteral(" more levels pending processing"));
+
+    TagsList levelTags = m_tagsPendingProcessing.mid(0, levelSize);
+    m_tagsPendingProcessing.erase(m_tagsPendingProcessing.begin(), m_tagsPendingProcessing.begin() + levelSize);
+
+    // NOTE: need to register all tags from the level before emitting any requests to prevent
+    // the premature start of the next level
+    for(auto it = levelTags.constBegin(), end = levelTags.constEnd(); it != end; ++it)
+    {
+        const qevercloud::Tag & tag = *it;
+        if (tag.guid.isSet()) {
+            Q_UNUSED(m_guidsOfTagsFromCurrentLevelPendingProcessing.insert(tag.guid.ref()))
+        }
+    }
+
+    for(auto it = levelTags.constBegin(), end = levelTags.constEnd(); it != end; ++it) {
+        emitFindByGuidRequest(*it);
+    }
+}
+
+void RemoteToLocalSynchronizationManager::onTagFromCurrentLevelProcessed(const QString & tagGuid)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::onTagFromCurrentLevelProcessed: guid = ") << tagGuid);
+
+    auto it = m_guidsOfTagsFromCurrentLevelPendingProcessing.find(tagGuid);
+    if (it == m_guidsOfTagsFromCurrentLevelPendingProcessing.end()) {
+        QNDEBUG(QStringLiteral("The tag doesn't belong to the level of tags being processed"));
         return;
     }
 
-    qevercloud::Tag frontTag = m_tagsPendingProcessing.takeFirst();
-    emitFindByGuidRequest(frontTag);
+    Q_UNUSED(m_guidsOfTagsFromCurrentLevelPendingProcessing.erase(it))
+    if (!m_guidsOfTagsFromCurrentLevelPendingProcessing.isEmpty()) {
+        QNTRACE(QStringLiteral("Still have ") << m_guidsOfTagsFromCurrentLevelPendingProcessing.size()
+                << QStringLiteral(" tags from the current level pending processing"));
+        return;
+    }
+
+    syncNextTagsLevelPendingProcessing();
 }
 
 void RemoteToLocalSynchronizationManager::junkFullSyncStaleDataItemsExpunger(FullSyncStaleDataItemsExpunger & expunger)
@@ -7666,7 +9491,7 @@ void RemoteToLocalSynchronizationManager::junkFullSyncStaleDataItemsExpunger(Ful
     expunger.deleteLater();
 }
 
-NoteStore * RemoteToLocalSynchronizationManager::noteStoreForNote(const Note & note, QString & authToken, ErrorString & errorDescription) const
+INoteStore * RemoteToLocalSynchronizationManager::noteStoreForNote(const Note & note, QString & authToken, ErrorString & errorDescription) const
 {
     authToken.resize(0);
 
@@ -7687,7 +9512,7 @@ NoteStore * RemoteToLocalSynchronizationManager::noteStoreForNote(const Note & n
     // Need to find out which note store is required - the one for user's own
     // account or the one for the stuff from some linked notebook
 
-    NoteStore * pNoteStore = Q_NULLPTR;
+    INoteStore * pNoteStore = Q_NULLPTR;
     auto linkedNotebookGuidIt = m_linkedNotebookGuidsByNotebookGuids.find(note.notebookGuid());
     if (linkedNotebookGuidIt == m_linkedNotebookGuidsByNotebookGuids.end()) {
         QNDEBUG(QStringLiteral("Found no linked notebook corresponding to notebook guid ") << note.notebookGuid()
@@ -7745,7 +9570,7 @@ NoteStore * RemoteToLocalSynchronizationManager::noteStoreForNote(const Note & n
         return Q_NULLPTR;
     }
 
-    QObject::connect(pNoteStore, QNSIGNAL(NoteStore,getNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,getNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onGetNoteAsyncFinished,qint32,qevercloud::Note,qint32,ErrorString),
                      Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
@@ -7798,25 +9623,141 @@ void RemoteToLocalSynchronizationManager::checkAndRemoveInaccessibleParentTagGui
     }
 }
 
-void RemoteToLocalSynchronizationManager::startFeedingDownloadedTagsToLocalStorageOneByOne(const TagsContainer & container)
+void RemoteToLocalSynchronizationManager::startFeedingDownloadedTagsToLocalStorageByLevels(const TagsContainer & container)
 {
-    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::startFeedingDownloadedTagsToLocalStorageOneByOne"));
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::startFeedingDownloadedTagsToLocalStorageByLevels"));
 
-    m_tagsPendingProcessing.reserve(static_cast<int>(container.size()));
+    TagsList tags;
+    tags.reserve(static_cast<int>(container.size()));
     const auto & tagIndexByGuid = container.get<ByGuid>();
     for(auto it = tagIndexByGuid.begin(), end = tagIndexByGuid.end(); it != end; ++it) {
-        m_tagsPendingProcessing << *it;
+        tags << *it;
     }
 
-    if (!sortTagsByParentChildRelations(m_tagsPendingProcessing)) {
+    if (!sortTagsByParentChildRelations(tags)) {
         return;
     }
 
     // NOTE: parent tags need to be added to the local storage before their children, otherwise
-    // the local storage database would have a constraint failure; by now the tags
-    // are already sorted by parent-child relations but they need to be processed one by one
+    // the local storage database would have a constraint failure. The tags are already sorted
+    // by parent-child relations so the level of each tag is known by the time it is encountered:
+    // tags without parents among the downloaded ones form the first level, their children
+    // form the second level and so on. All tags from the same level are sent to the local storage
+    // at once, the next level is started when all the tags from the previous one are processed.
+    QHash<QString,int> levelsByGuid;
+    levelsByGuid.reserve(tags.size());
+    QList<TagsList> tagsByLevel;
+
+    for(auto it = tags.constBegin(), end = tags.constEnd(); it != end; ++it)
+    {
+        const qevercloud::Tag & tag = *it;
+
+        int level = 0;
+        if (tag.parentGuid.isSet())
+        {
+            auto levelIt = levelsByGuid.find(tag.parentGuid.ref());
+            if (levelIt != levelsByGuid.end()) {
+                level = levelIt.value() + 1;
+            }
+        }
+
+        if (tag.guid.isSet()) {
+            levelsByGuid[tag.guid.ref()] = level;
+        }
+
+        while(tagsByLevel.size() <= level) {
+            tagsByLevel << TagsList();
+        }
+
+        tagsByLevel[level] << tag;
+    }
+
+    m_tagsPendingProcessing.reserve(m_tagsPendingProcessing.size() + tags.size());
+    for(auto it = tagsByLevel.constBegin(), end = tagsByLevel.constEnd(); it != end; ++it) {
+        m_tagsPendingProcessing << *it;
+        m_tagsPendingProcessingLevelSizes << it->size();
+    }
+
+    QNDEBUG(QStringLiteral("Split ") << tags.size() << QStringLiteral(" tags into ") << tagsByLevel.size()
+            << QStringLiteral(" levels"));
+
+    if (!m_guidsOfTagsFromCurrentLevelPendingProcessing.isEmpty()) {
+        QNDEBUG(QStringLiteral("Some tags from the current level are still being processed, the new levels would be processed after them"));
+        return;
+    }
+
+    syncNextTagsLevelPendingProcessing();
+}
+
+void RemoteToLocalSynchronizationManager::beginSyncTraceSpan(const SyncTracer::Phase::type phase, const QString & id)
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    tracer.beginSpan(phase, id, QDateTime::currentMSecsSinceEpoch());
+}
+
+void RemoteToLocalSynchronizationManager::endSyncTraceSpan(const SyncTracer::Phase::type phase, const QString & id,
+                                                           const qint64 numItems, const qint64 numBytes)
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    Q_UNUSED(tracer.endSpan(phase, id, QDateTime::currentMSecsSinceEpoch(), numItems, numBytes))
+}
+
+void RemoteToLocalSynchronizationManager::beginSyncTraceMergePhaseSpan(const SyncTracer::Phase::type phase)
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    // NOTE: the merge phase might be launched several times in a row, for instance, once per each linked notebook;
+    // the span lasts from the first launch until the phase is found complete
+    QString id = (syncingLinkedNotebooksContent() ? QStringLiteral("LinkedNotebooks") : QStringLiteral("UserAccount"));
+    if (tracer.hasSpanInProgress(phase, id)) {
+        return;
+    }
 
-    syncNextTagPendingProcessing();
+    tracer.beginSpan(phase, id, QDateTime::currentMSecsSinceEpoch());
+}
+
+void RemoteToLocalSynchronizationManager::checkSyncTraceMergePhasesCompletion()
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    QStringList ids;
+    ids << QStringLiteral("UserAccount") << QStringLiteral("LinkedNotebooks");
+    for(auto it = ids.constBegin(), end = ids.constEnd(); it != end; ++it)
+    {
+        const QString & id = *it;
+
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::TagsMerge, id) && !tagsSyncInProgress()) {
+            Q_UNUSED(tracer.endSpan(SyncTracer::Phase::TagsMerge, id, timestamp))
+        }
+
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::NotebooksMerge, id) && !notebooksSyncInProgress()) {
+            Q_UNUSED(tracer.endSpan(SyncTracer::Phase::NotebooksMerge, id, timestamp))
+        }
+
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::NotesMerge, id) && m_notes.isEmpty() && !notesSyncInProgress()) {
+            Q_UNUSED(tracer.endSpan(SyncTracer::Phase::NotesMerge, id, timestamp))
+        }
+
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::ResourcesMerge, id) && m_resources.isEmpty() && !resourcesSyncInProgress()) {
+            Q_UNUSED(tracer.endSpan(SyncTracer::Phase::ResourcesMerge, id, timestamp))
+        }
+    }
 }
 
 QTextStream & operator<<(QTextStream & strm, const RemoteToLocalSynchronizationManager::SyncMode::type & obj)
@@ -7924,11 +9865,7 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
         const auto expungedSearchesEnd = expungedSearches.end();
         for(auto eit = expungedSearches.begin(); eit != expungedSearchesEnd; ++eit)
         {
-            SavedSearchesList::iterator it = std::find_if(container.begin(), container.end(),
-                                                          CompareItemByGuid<qevercloud::SavedSearch>(*eit));
-            if (it != container.end()) {
-                Q_UNUSED(container.erase(it));
-            }
+            Q_UNUSED(container.removeByGuid(*eit))
         }
     }
 }
@@ -7966,11 +9903,7 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
         const auto expungedLinkedNotebooksEnd = expungedLinkedNotebooks.end();
         for(auto eit = expungedLinkedNotebooks.begin(); eit != expungedLinkedNotebooksEnd; ++eit)
         {
-            LinkedNotebooksList::iterator it = std::find_if(container.begin(), container.end(),
-                                                            CompareItemByGuid<qevercloud::LinkedNotebook>(*eit));
-            if (it != container.end()) {
-                Q_UNUSED(container.erase(it));
-            }
+            Q_UNUSED(container.removeByGuid(*eit))
         }
     }
 }
@@ -8008,11 +9941,7 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
         const auto expungedNotebooksEnd = expungedNotebooks.end();
         for(auto eit = expungedNotebooks.begin(); eit != expungedNotebooksEnd; ++eit)
         {
-            NotebooksList::iterator it = std::find_if(container.begin(), container.end(),
-                                                      CompareItemByGuid<qevercloud::Notebook>(*eit));
-            if (it != container.end()) {
-                Q_UNUSED(container.erase(it));
-            }
+            Q_UNUSED(container.removeByGuid(*eit))
         }
     }
 }
@@ -8027,7 +9956,30 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
     {
         const auto & syncChunkNotes = syncChunk.notes.ref();
         QNDEBUG(QStringLiteral("Appending ") << syncChunkNotes.size() << QStringLiteral(" notes"));
-        container.append(syncChunkNotes);
+
+        bool skipItemsFromSyncCheckpoint = !m_syncCheckpoint.isEmpty() && shouldSkipItemsFromSyncCheckpoint();
+        // NOTE: the notes not selected by the selective sync filter are not skipped here: whether such a note
+        // has the local copy which needs to be updated is only known after looking it up within the local storage
+        if (!skipItemsFromSyncCheckpoint)
+        {
+            container.append(syncChunkNotes);
+        }
+        else
+        {
+            for(auto it = syncChunkNotes.constBegin(), end = syncChunkNotes.constEnd(); it != end; ++it)
+            {
+                const qevercloud::Note & note = *it;
+                if (note.guid.isSet() && note.updateSequenceNum.isSet() &&
+                    m_syncCheckpoint.isNoteProcessed(note.guid.ref(), note.updateSequenceNum.ref()))
+                {
+                    QNTRACE(QStringLiteral("Skipping the note already put into the local storage before the sync was interrupted: ")
+                            << note.guid.ref());
+                    continue;
+                }
+
+                container << note;
+            }
+        }
 
         for(auto it = m_expungedNotes.begin(); it != m_expungedNotes.end(); )
         {
@@ -8050,11 +10002,7 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
         const auto expungedNotesEnd = expungedNotes.end();
         for(auto eit = expungedNotes.begin(); eit != expungedNotesEnd; ++eit)
         {
-            NotesList::iterator it = std::find_if(container.begin(), container.end(),
-                                                  CompareItemByGuid<qevercloud::Note>(*eit));
-            if (it != container.end()) {
-                Q_UNUSED(container.erase(it));
-            }
+            Q_UNUSED(container.removeByGuid(*eit))
         }
     }
 
@@ -8063,20 +10011,21 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
         const auto & expungedNotebooks = syncChunk.expungedNotebooks.ref();
         QNDEBUG(QStringLiteral("Processing ") << expungedNotebooks.size() << QStringLiteral(" expunged notebooks"));
 
+        QSet<QString> expungedNotebookGuids;
+        expungedNotebookGuids.reserve(expungedNotebooks.size());
         const auto expungedNotebooksEnd = expungedNotebooks.end();
-        for(auto eit = expungedNotebooks.begin(); eit != expungedNotebooksEnd; ++eit)
-        {
-            const QString & expungedNotebookGuid = *eit;
+        for(auto eit = expungedNotebooks.begin(); eit != expungedNotebooksEnd; ++eit) {
+            Q_UNUSED(expungedNotebookGuids.insert(*eit))
+        }
 
-            for(auto it = container.begin(); it != container.end();)
-            {
-                qevercloud::Note & note = *it;
-                if (note.notebookGuid.isSet() && (note.notebookGuid.ref() == expungedNotebookGuid)) {
-                    it = container.erase(it);
-                }
-                else {
-                    ++it;
-                }
+        for(auto it = container.begin(); it != container.end();)
+        {
+            const qevercloud::Note & note = *it;
+            if (note.notebookGuid.isSet() && expungedNotebookGuids.contains(note.notebookGuid.ref())) {
+                it = container.erase(it);
+            }
+            else {
+                ++it;
             }
         }
     }
@@ -8108,6 +10057,14 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
             continue;
         }
 
+        if (resource.guid.isSet() && resource.updateSequenceNum.isSet() && shouldSkipItemsFromSyncCheckpoint() &&
+            m_syncCheckpoint.isResourceProcessed(resource.guid.ref(), resource.updateSequenceNum.ref()))
+        {
+            QNTRACE(QStringLiteral("Skipping the resource already put into the local storage before the sync was interrupted: ")
+                    << resource.guid.ref());
+            continue;
+        }
+
         QNTRACE(QStringLiteral("Checking whether resource belongs to a note pending downloading or already downloaded one: ")
                 << resource);
 
@@ -8118,24 +10075,7 @@ void RemoteToLocalSynchronizationManager::appendDataElementsFromSyncChunkToConta
             continue;
         }
 
-        bool foundNote = false;
-        for(auto nit = m_notes.constBegin(), nend = m_notes.constEnd(); nit != nend; ++nit)
-        {
-            const qevercloud::Note & note = *nit;
-            QNTRACE(QStringLiteral("Checking note: ") << note);
-
-            if (Q_UNLIKELY(!note.guid.isSet())) {
-                continue;
-            }
-
-            if (note.guid.ref() == resource.noteGuid.ref()) {
-                QNTRACE(QStringLiteral("Resource belongs to a note pending downloading: ") << note);
-                foundNote = true;
-                break;
-            }
-        }
-
-        if (foundNote) {
+        if (m_notes.containsGuid(resource.noteGuid.ref())) {
             QNTRACE(QStringLiteral("Skipping resource as it belongs to the note which while content would be downloaded "
                                    "a bit later: ") << resource);
             continue;
@@ -8169,15 +10109,14 @@ typename ContainerType::iterator RemoteToLocalSynchronizationManager::findItemBy
         return container.end();
     }
 
-    auto it = std::find_if(container.begin(), container.end(),
-                           CompareItemByName<typename ContainerType::value_type>(element.name()));
-    if (it == container.end()) {
+    QList<typename ContainerType::iterator> items = container.findByName(element.name());
+    if (items.isEmpty()) {
         SET_CANT_FIND_IN_PENDING_LIST_ERROR();
         Q_EMIT failure(errorDescription);
         return container.end();
     }
 
-    return it;
+    return items.front();
 }
 
 template<>
@@ -8254,8 +10193,7 @@ RemoteToLocalSynchronizationManager::NotebooksList::iterator RemoteToLocalSynchr
 {
     QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::findItemByName<Notebook>"));
 
-    // Attempt to find this data element by name within the list of elements waiting for processing;
-    // first simply try the front element from the list to avoid the costly lookup
+    // Attempt to find this data element by name within the list of elements waiting for processing
     if (!element.hasName()) {
         SET_CANT_FIND_BY_NAME_ERROR();
         Q_EMIT failure(errorDescription);
@@ -8268,17 +10206,10 @@ RemoteToLocalSynchronizationManager::NotebooksList::iterator RemoteToLocalSynchr
         return container.end();
     }
 
-    auto it = container.begin();
-    for(auto end = container.end(); it != end; ++it)
+    QList<NotebooksList::iterator> notebooks = container.findByName(element.name());
+    for(auto it = notebooks.constBegin(), end = notebooks.constEnd(); it != end; ++it)
     {
-        const qevercloud::Notebook & notebook = *it;
-        if (!notebook.name.isSet()) {
-            continue;
-        }
-
-        if (notebook.name.ref().toUpper() != element.name().toUpper()) {
-            continue;
-        }
+        const qevercloud::Notebook & notebook = **it;
 
         if (!targetLinkedNotebookGuid.isEmpty())
         {
@@ -8302,10 +10233,10 @@ RemoteToLocalSynchronizationManager::NotebooksList::iterator RemoteToLocalSynchr
             }
         }
 
-        break;
+        return *it;
     }
 
-    return it;
+    return container.end();
 }
 
 template <class ContainerType, class ElementType>
@@ -8327,8 +10258,7 @@ typename ContainerType::iterator RemoteToLocalSynchronizationManager::findItemBy
         return container.end();
     }
 
-    auto it = std::find_if(container.begin(), container.end(),
-                           CompareItemByGuid<typename ContainerType::value_type>(element.guid()));
+    auto it = container.findByGuid(element.guid());
     if (it == container.end()) {
         SET_CANT_FIND_IN_PENDING_LIST_ERROR();
         Q_EMIT failure(errorDescription);
@@ -8375,28 +10305,6 @@ TagsContainer::iterator RemoteToLocalSynchronizationManager::findItemByGuid<Tags
     return cit;
 }
 
-template <class T>
-bool RemoteToLocalSynchronizationManager::CompareItemByName<T>::operator()(const T & item) const
-{
-    if (item.name.isSet()) {
-        return (m_name.toUpper() == item.name.ref().toUpper());
-    }
-    else {
-        return false;
-    }
-}
-
-template <>
-bool RemoteToLocalSynchronizationManager::CompareItemByName<qevercloud::Note>::operator()(const qevercloud::Note & item) const
-{
-    if (item.title.isSet()) {
-        return (m_name.toUpper() == item.title->toUpper());
-    }
-    else {
-        return false;
-    }
-}
-
 template <class T>
 bool RemoteToLocalSynchronizationManager::CompareItemByGuid<T>::operator()(const T & item) const
 {
@@ -8600,10 +10508,7 @@ bool RemoteToLocalSynchronizationManager::onFoundDuplicateByName(ElementType ele
 
     resolveSyncConflict(remoteElement, element);
 
-    typename PendingContainerType::iterator pendingItemIt = std::find_if(pendingItemsContainer.begin(),
-                                                                         pendingItemsContainer.end(),
-                                                                         CompareItemByGuid<typename PendingContainerType::value_type>(remoteElement.guid.ref()));
-    if (pendingItemIt == pendingItemsContainer.end()) {
+    if (!pendingItemsContainer.containsGuid(remoteElement.guid.ref())) {
         pendingItemsContainer << remoteElement;
     }
 
@@ -8649,10 +10554,7 @@ bool RemoteToLocalSynchronizationManager::onFoundDuplicateByGuid(ElementType ele
 
     resolveSyncConflict(remoteElement, element);
 
-    typename PendingContainerType::iterator pendingItemIt = std::find_if(pendingItemsContainer.begin(),
-                                                                         pendingItemsContainer.end(),
-                                                                         CompareItemByGuid<typename PendingContainerType::value_type>(remoteElement.guid.ref()));
-    if (pendingItemIt == pendingItemsContainer.end()) {
+    if (!pendingItemsContainer.containsGuid(remoteElement.guid.ref())) {
         pendingItemsContainer << remoteElement;
     }
 
@@ -8801,23 +10703,9 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
         return;
     }
 
-    NotebookSyncCache * pCache = Q_NULLPTR;
-    if (localConflict.hasLinkedNotebookGuid())
-    {
-        const QString & linkedNotebookGuid = localConflict.linkedNotebookGuid();
-        auto it = m_notebookSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-        if (it == m_notebookSyncCachesByLinkedNotebookGuids.end()) {
-            pCache = new NotebookSyncCache(m_manager.localStorageManagerAsync(),
-                                           linkedNotebookGuid, this);
-            it = m_notebookSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pCache);
-        }
-
-        pCache = it.value();
-    }
-    else
-    {
-        pCache = &m_notebookSyncCache;
-    }
+    NotebookSyncCache * pCache = &m_syncCachesManager.notebookSyncCache(localConflict.hasLinkedNotebookGuid()
+                                                                        ? localConflict.linkedNotebookGuid()
+                                                                        : QString());
 
     QString remoteNotebookLinkedNotebookGuid;
     auto it = m_linkedNotebookGuidsByNotebookGuids.find(remoteNotebook.guid.ref());
@@ -8832,6 +10720,7 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onNotebookSyncConflictResolverFinished,qevercloud::Notebook));
     QObject::connect(pResolver, QNSIGNAL(NotebookSyncConflictResolver,failure,qevercloud::Notebook,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onNotebookSyncConflictResolverFailure,qevercloud::Notebook,ErrorString));
+    beginSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteNotebook.guid.ref());
     pResolver->start();
 }
 
@@ -8883,22 +10772,9 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
         return;
     }
 
-    TagSyncCache * pCache = Q_NULLPTR;
-    if (localConflict.hasLinkedNotebookGuid())
-    {
-        const QString & linkedNotebookGuid = localConflict.linkedNotebookGuid();
-        auto it = m_tagSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
-        if (it == m_tagSyncCachesByLinkedNotebookGuids.end()) {
-            pCache = new TagSyncCache(m_manager.localStorageManagerAsync(), linkedNotebookGuid, this);
-            it = m_tagSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pCache);
-        }
-
-        pCache = it.value();
-    }
-    else
-    {
-        pCache = &m_tagSyncCache;
-    }
+    TagSyncCache * pCache = &m_syncCachesManager.tagSyncCache(localConflict.hasLinkedNotebookGuid()
+                                                              ? localConflict.linkedNotebookGuid()
+                                                              : QString());
 
     QString remoteTagLinkedNotebookGuid;
     auto it = m_linkedNotebookGuidsByTagGuids.find(remoteTag.guid.ref());
@@ -8913,6 +10789,7 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onTagSyncConflictResolverFinished,qevercloud::Tag));
     QObject::connect(pResolver, QNSIGNAL(TagSyncConflictResolver,failure,qevercloud::Tag,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onTagSyncConflictResolverFailure,qevercloud::Tag,ErrorString));
+    beginSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteTag.guid.ref());
     pResolver->start();
 }
 
@@ -8966,12 +10843,13 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
     }
 
     SavedSearchSyncConflictResolver * pResolver = new SavedSearchSyncConflictResolver(remoteSavedSearch, localConflict,
-                                                                                      m_savedSearchSyncCache,
+                                                                                      m_syncCachesManager.savedSearchSyncCache(),
                                                                                       m_manager.localStorageManagerAsync(), this);
     QObject::connect(pResolver, QNSIGNAL(SavedSearchSyncConflictResolver,finished,qevercloud::SavedSearch),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onSavedSearchSyncConflictResolverFinished,qevercloud::SavedSearch));
     QObject::connect(pResolver, QNSIGNAL(SavedSearchSyncConflictResolver,failure,qevercloud::SavedSearch,ErrorString),
                      this, QNSLOT(RemoteToLocalSynchronizationManager,onSavedSearchSyncConflictResolverFailure,qevercloud::SavedSearch,ErrorString));
+    beginSyncTraceSpan(SyncTracer::Phase::ConflictResolution, remoteSavedSearch.guid.ref());
     pResolver->start();
 }
 
@@ -9018,7 +10896,23 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
     overrideLocalNoteWithRemoteNote(updatedNote, remoteNote);
 
     registerNotePendingAddOrUpdate(updatedNote);
-    getFullNoteDataAsyncAndUpdateInLocalStorage(updatedNote);
+
+    NoteDataDownloadOptions downloadOptions = noteDataDownloadOptions(localConflict, remoteNote);
+    if (downloadOptions.isEmpty())
+    {
+        QNDEBUG(QStringLiteral("Neither the content nor the resources' data of the note have changed, "
+                               "updating the note in the local storage without downloading anything"));
+        checkAndIncrementNoteDownloadProgress(remoteNote.guid.ref());
+        updateNoteInLocalStorageKeepingLocalData(updatedNote, localConflict);
+    }
+    else
+    {
+        if (!downloadOptions.isFull()) {
+            m_partialNoteDataDownloadsByGuid[remoteNote.guid.ref()] = QPair<Note,NoteDataDownloadOptions>(localConflict, downloadOptions);
+        }
+
+        getFullNoteDataAsyncAndUpdateInLocalStorage(updatedNote);
+    }
 
     if (shouldCreateConflictingNote) {
         Note conflictingNote = createConflictingNote(localConflict, &remoteNote);
@@ -9045,6 +10939,7 @@ void RemoteToLocalSynchronizationManager::resolveSyncConflict(const qevercloud::
 
     QUuid updateLinkedNotebookRequestId = QUuid::createUuid();
     Q_UNUSED(m_updateLinkedNotebookRequestIds.insert(updateLinkedNotebookRequestId));
+    beginSyncTraceSpan(SyncTracer::Phase::LocalStorageWrite, updateLinkedNotebookRequestId.toString());
     QNTRACE(QStringLiteral("Emitting the request to update linked notebook: request id = ") << updateLinkedNotebookRequestId
             << QStringLiteral(", linked notebook: ") << linkedNotebook);
     Q_EMIT updateLinkedNotebook(linkedNotebook, updateLinkedNotebookRequestId);
@@ -9065,6 +10960,474 @@ bool RemoteToLocalSynchronizationManager::sortTagsByParentChildRelations(TagsLis
     return true;
 }
 
+SyncChunkSpool & RemoteToLocalSynchronizationManager::syncChunksForContentSource(const ContentSource::type contentSource)
+{
+    return ((contentSource == ContentSource::UserAccount) ? m_syncChunks : m_linkedNotebookSyncChunks);
+}
+
+void RemoteToLocalSynchronizationManager::takeNotesFromSyncChunks()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::takeNotesFromSyncChunks"));
+
+    if (m_nextSyncChunkIndexToTakeNotesFrom < 0) {
+        QNDEBUG(QStringLiteral("Notes are not being taken from the sync chunks at the moment"));
+        return;
+    }
+
+    SyncChunkSpool & syncChunks = syncChunksForContentSource(m_notesSyncContentSource);
+
+    int numSkippedNotes = 0;
+    while((m_nextSyncChunkIndexToTakeNotesFrom < syncChunks.size()) &&
+          (m_numPendingNotesBySyncChunkIndices.size() < MAX_SYNC_CHUNKS_WITH_DATA_ELEMENTS_PENDING_PROCESSING))
+    {
+        int index = m_nextSyncChunkIndexToTakeNotesFrom++;
+
+        QList<qevercloud::Note> takenNotes;
+        ErrorString errorDescription;
+        if (!syncChunks.takeNotes(index, takenNotes, errorDescription)) {
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+
+        QNDEBUG(QStringLiteral("Took ") << takenNotes.size() << QStringLiteral(" notes from the sync chunk #") << index);
+
+        int numNotesToProcess = 0;
+        QList<qevercloud::Note> notes;
+        notes.reserve(takenNotes.size());
+        for(auto it = takenNotes.constBegin(), end = takenNotes.constEnd(); it != end; ++it)
+        {
+            const qevercloud::Note & note = *it;
+            if (Q_UNLIKELY(!note.guid.isSet())) {
+                notes << note;
+                continue;
+            }
+
+            const QString & noteGuid = note.guid.ref();
+            if (m_lastSyncChunkIndicesByNoteGuids.value(noteGuid, index) > index) {
+                QNTRACE(QStringLiteral("Skipping the note superseded by its version from one of the subsequent sync chunks: ")
+                        << noteGuid);
+                continue;
+            }
+
+            ++numNotesToProcess;
+
+            if (m_lastSyncChunkIndicesByExpungedNoteGuids.value(noteGuid, -1) > index) {
+                QNTRACE(QStringLiteral("Skipping the note expunged by one of the subsequent sync chunks: ") << noteGuid);
+                continue;
+            }
+
+            if (note.notebookGuid.isSet() &&
+                (m_lastSyncChunkIndicesByExpungedNotebookGuids.value(note.notebookGuid.ref(), -1) > index))
+            {
+                QNTRACE(QStringLiteral("Skipping the note which notebook is expunged by one of the subsequent sync chunks: ")
+                        << noteGuid);
+                continue;
+            }
+
+            notes << note;
+        }
+
+        takenNotes.clear();
+
+        // NOTE: the rest of sync chunk's data is required for filtering out the notes expunged by the same sync chunk
+        qevercloud::SyncChunk syncChunk = syncChunks.at(index);
+        syncChunk.notes = notes;
+        notes.clear();
+
+        NotesList newNotes;
+        appendDataElementsFromSyncChunkToContainer<NotesList>(syncChunk, newNotes);
+        extractExpungedElementsFromSyncChunk<Note>(syncChunk, m_expungedNotes);
+        syncChunk.notes.clear();
+
+        numSkippedNotes += std::max(numNotesToProcess - newNotes.size(), 0);
+
+        int numPendingNotes = 0;
+        for(auto it = newNotes.constBegin(), end = newNotes.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                m_syncChunkIndicesByPendingNoteGuids[it->guid.ref()] = index;
+                ++numPendingNotes;
+            }
+        }
+
+        if (numPendingNotes == 0) {
+            syncChunks.releaseNotes(index);
+        }
+        else {
+            m_numPendingNotesBySyncChunkIndices[index] = numPendingNotes;
+        }
+
+        if (!newNotes.isEmpty()) {
+            processNotesTakenFromSyncChunk(newNotes);
+        }
+    }
+
+    if (numSkippedNotes > 0)
+    {
+        QNDEBUG(QStringLiteral("Skipped ") << numSkippedNotes << QStringLiteral(" notes taken from the sync chunks"));
+
+        m_numNotesDownloaded = std::min(m_numNotesDownloaded + static_cast<quint32>(numSkippedNotes), m_originalNumberOfNotes);
+        if (syncingLinkedNotebooksContent()) {
+            Q_EMIT linkedNotebooksNotesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
+        }
+        else {
+            Q_EMIT notesDownloadProgress(m_numNotesDownloaded, m_originalNumberOfNotes);
+        }
+    }
+}
+
+void RemoteToLocalSynchronizationManager::takeResourcesFromSyncChunks()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::takeResourcesFromSyncChunks"));
+
+    if (m_nextSyncChunkIndexToTakeResourcesFrom < 0) {
+        QNDEBUG(QStringLiteral("Resources are not being taken from the sync chunks at the moment"));
+        return;
+    }
+
+    int numSkippedResources = 0;
+    while((m_nextSyncChunkIndexToTakeResourcesFrom < m_syncChunks.size()) &&
+          (m_numPendingResourcesBySyncChunkIndices.size() < MAX_SYNC_CHUNKS_WITH_DATA_ELEMENTS_PENDING_PROCESSING))
+    {
+        int index = m_nextSyncChunkIndexToTakeResourcesFrom++;
+
+        QList<qevercloud::Resource> takenResources;
+        ErrorString errorDescription;
+        if (!m_syncChunks.takeResources(index, takenResources, errorDescription)) {
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+
+        QNDEBUG(QStringLiteral("Took ") << takenResources.size() << QStringLiteral(" resources from the sync chunk #") << index);
+
+        int numResourcesToProcess = 0;
+        QList<qevercloud::Resource> resources;
+        resources.reserve(takenResources.size());
+        for(auto it = takenResources.constBegin(), end = takenResources.constEnd(); it != end; ++it)
+        {
+            const qevercloud::Resource & resource = *it;
+            if (resource.guid.isSet())
+            {
+                if (m_lastSyncChunkIndicesByResourceGuids.value(resource.guid.ref(), index) > index) {
+                    QNTRACE(QStringLiteral("Skipping the resource superseded by its version from one of the subsequent sync chunks: ")
+                            << resource.guid.ref());
+                    continue;
+                }
+
+                ++numResourcesToProcess;
+            }
+
+            resources << resource;
+        }
+
+        takenResources.clear();
+
+        qevercloud::SyncChunk syncChunk;
+        syncChunk.resources = resources;
+        resources.clear();
+
+        ResourcesList newResources;
+        appendDataElementsFromSyncChunkToContainer<ResourcesList>(syncChunk, newResources);
+        syncChunk.resources.clear();
+
+        numSkippedResources += std::max(numResourcesToProcess - newResources.size(), 0);
+
+        int numPendingResources = 0;
+        for(auto it = newResources.constBegin(), end = newResources.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                m_syncChunkIndicesByPendingResourceGuids[it->guid.ref()] = index;
+                ++numPendingResources;
+            }
+        }
+
+        if (numPendingResources == 0) {
+            m_syncChunks.releaseResources(index);
+        }
+        else {
+            m_numPendingResourcesBySyncChunkIndices[index] = numPendingResources;
+        }
+
+        for(auto it = newResources.constBegin(), end = newResources.constEnd(); it != end; ++it)
+        {
+            const qevercloud::Resource & element = *it;
+            if (!element.guid.isSet()) {
+                QString typeName = QStringLiteral("Resource");
+                SET_CANT_FIND_BY_GUID_ERROR();
+                Q_EMIT failure(errorDescription);
+                return;
+            }
+
+            m_resources << element;
+            emitFindByGuidRequest(element);
+        }
+    }
+
+    if (numSkippedResources > 0)
+    {
+        QNDEBUG(QStringLiteral("Skipped ") << numSkippedResources << QStringLiteral(" resources taken from the sync chunks"));
+
+        m_numResourcesDownloaded = std::min(m_numResourcesDownloaded + static_cast<quint32>(numSkippedResources),
+                                            m_originalNumberOfResources);
+        if (syncingLinkedNotebooksContent()) {
+            Q_EMIT linkedNotebooksResourcesDownloadProgress(m_numResourcesDownloaded, m_originalNumberOfResources);
+        }
+        else {
+            Q_EMIT resourcesDownloadProgress(m_numResourcesDownloaded, m_originalNumberOfResources);
+        }
+    }
+}
+
+bool RemoteToLocalSynchronizationManager::notesPendingTakingFromSyncChunks() const
+{
+    if (m_nextSyncChunkIndexToTakeNotesFrom < 0) {
+        return false;
+    }
+
+    const SyncChunkSpool & syncChunks = ((m_notesSyncContentSource == ContentSource::UserAccount)
+                                         ? m_syncChunks
+                                         : m_linkedNotebookSyncChunks);
+    return (m_nextSyncChunkIndexToTakeNotesFrom < syncChunks.size());
+}
+
+bool RemoteToLocalSynchronizationManager::resourcesPendingTakingFromSyncChunks() const
+{
+    return (m_nextSyncChunkIndexToTakeResourcesFrom >= 0) &&
+           (m_nextSyncChunkIndexToTakeResourcesFrom < m_syncChunks.size());
+}
+
+void RemoteToLocalSynchronizationManager::processNotesTakenFromSyncChunk(const NotesList & notes)
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::processNotesTakenFromSyncChunk: ") << notes.size()
+            << QStringLiteral(" notes"));
+
+    QString typeName = QStringLiteral("Note");
+
+    // NOTE: the notes from linked notebooks are always looked up within the local storage one by one
+    // since the notes from several linked notebooks are processed together
+    const NoteSyncCache * pNoteSyncCache = Q_NULLPTR;
+    if (m_notesSyncContentSource == ContentSource::UserAccount)
+    {
+        const NoteSyncCache & noteSyncCache = m_syncCachesManager.noteSyncCache();
+        if (noteSyncCache.isFilled()) {
+            pNoteSyncCache = &noteSyncCache;
+        }
+        else {
+            QNDEBUG(QStringLiteral("The note sync cache is not filled yet, will look for each note within the local storage"));
+        }
+    }
+
+    int numUpToDateNotes = 0;
+    int numSkippedNewNotes = 0;
+    for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it)
+    {
+        const qevercloud::Note & element = *it;
+        if (!element.guid.isSet()) {
+            SET_CANT_FIND_BY_GUID_ERROR();
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+
+        if (!pNoteSyncCache) {
+            m_notes << element;
+            emitFindByGuidRequest(element);
+            continue;
+        }
+
+        NoteSyncCache::NoteSyncStatus::type status = pNoteSyncCache->noteSyncStatus(element);
+        if ((status == NoteSyncCache::NoteSyncStatus::Conflicting) || (status == NoteSyncCache::NoteSyncStatus::Modified)) {
+            // NOTE: the local note is required both for the resolution of the conflict with it and for its override
+            // with the remote note which needs to preserve the local uids of the note's resources
+            m_notes << element;
+            emitFindByGuidRequest(element);
+            continue;
+        }
+
+        // The note doesn't need to be looked up within the local storage so it doesn't go to the list
+        // of notes waiting for processing
+        QString noteGuid = element.guid.ref();
+        Q_UNUSED(m_guidsOfProcessedNonExpungedNotes.insert(noteGuid))
+
+        if (status == NoteSyncCache::NoteSyncStatus::New)
+        {
+            if (shouldSkipNewNoteDueToSelectiveSyncFilter(element)) {
+                skipNewNoteDueToSelectiveSyncFilter(element);
+                ++numSkippedNewNotes;
+                continue;
+            }
+
+            QNTRACE(QStringLiteral("Found no local note with guid ") << noteGuid
+                    << QStringLiteral(" within the note sync cache, will add the remote note to the local storage"));
+            Note note(element);
+            getFullNoteDataAsyncAndAddToLocalStorage(note);
+            continue;
+        }
+
+        QNTRACE(QStringLiteral("The local note with guid ") << noteGuid << QStringLiteral(" is already up to date"));
+        checkAndIncrementNoteDownloadProgress(noteGuid);
+        ++numUpToDateNotes;
+    }
+
+    if (numSkippedNewNotes > 0) {
+        QNDEBUG(QStringLiteral("Skipped ") << numSkippedNewNotes << QStringLiteral(" new notes not selected by the selective sync filter"));
+    }
+
+    if (numUpToDateNotes > 0) {
+        QNDEBUG(QStringLiteral("Skipped ") << numUpToDateNotes << QStringLiteral(" notes which are already up to date"));
+    }
+
+    if ((numUpToDateNotes > 0) || (numSkippedNewNotes > 0)) {
+        checkNotesSyncCompletionAndLaunchResourcesSync();
+    }
+}
+
+void RemoteToLocalSynchronizationManager::onNoteTakenFromSyncChunkProcessed(const QString & noteGuid)
+{
+    auto it = m_syncChunkIndicesByPendingNoteGuids.find(noteGuid);
+    if (it == m_syncChunkIndicesByPendingNoteGuids.end()) {
+        return;
+    }
+
+    int index = it.value();
+    Q_UNUSED(m_syncChunkIndicesByPendingNoteGuids.erase(it))
+
+    auto numPendingNotesIt = m_numPendingNotesBySyncChunkIndices.find(index);
+    if (Q_UNLIKELY(numPendingNotesIt == m_numPendingNotesBySyncChunkIndices.end())) {
+        return;
+    }
+
+    --numPendingNotesIt.value();
+    if (numPendingNotesIt.value() > 0) {
+        return;
+    }
+
+    Q_UNUSED(m_numPendingNotesBySyncChunkIndices.erase(numPendingNotesIt))
+    QNDEBUG(QStringLiteral("Processed all notes taken from the sync chunk #") << index);
+
+    // NOTE: the notes from the next sync chunk would be taken on the next server data merge completion check
+    syncChunksForContentSource(m_notesSyncContentSource).releaseNotes(index);
+}
+
+void RemoteToLocalSynchronizationManager::onResourceTakenFromSyncChunkProcessed(const QString & resourceGuid)
+{
+    auto it = m_syncChunkIndicesByPendingResourceGuids.find(resourceGuid);
+    if (it == m_syncChunkIndicesByPendingResourceGuids.end()) {
+        return;
+    }
+
+    int index = it.value();
+    Q_UNUSED(m_syncChunkIndicesByPendingResourceGuids.erase(it))
+
+    auto numPendingResourcesIt = m_numPendingResourcesBySyncChunkIndices.find(index);
+    if (Q_UNLIKELY(numPendingResourcesIt == m_numPendingResourcesBySyncChunkIndices.end())) {
+        return;
+    }
+
+    --numPendingResourcesIt.value();
+    if (numPendingResourcesIt.value() > 0) {
+        return;
+    }
+
+    Q_UNUSED(m_numPendingResourcesBySyncChunkIndices.erase(numPendingResourcesIt))
+    QNDEBUG(QStringLiteral("Processed all resources taken from the sync chunk #") << index);
+
+    m_syncChunks.releaseResources(index);
+}
+
+void RemoteToLocalSynchronizationManager::releaseNotesTakenFromSyncChunks()
+{
+    if (m_numPendingNotesBySyncChunkIndices.isEmpty()) {
+        m_syncChunkIndicesByPendingNoteGuids.clear();
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::releaseNotesTakenFromSyncChunks: ")
+            << m_numPendingNotesBySyncChunkIndices.size() << QStringLiteral(" sync chunks, ")
+            << m_syncChunkIndicesByPendingNoteGuids.size() << QStringLiteral(" notes"));
+
+    SyncChunkSpool & syncChunks = syncChunksForContentSource(m_notesSyncContentSource);
+    for(auto it = m_numPendingNotesBySyncChunkIndices.constBegin(),
+        end = m_numPendingNotesBySyncChunkIndices.constEnd(); it != end; ++it)
+    {
+        syncChunks.releaseNotes(it.key());
+    }
+
+    m_numPendingNotesBySyncChunkIndices.clear();
+    m_syncChunkIndicesByPendingNoteGuids.clear();
+}
+
+void RemoteToLocalSynchronizationManager::releaseResourcesTakenFromSyncChunks()
+{
+    if (m_numPendingResourcesBySyncChunkIndices.isEmpty()) {
+        m_syncChunkIndicesByPendingResourceGuids.clear();
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::releaseResourcesTakenFromSyncChunks: ")
+            << m_numPendingResourcesBySyncChunkIndices.size() << QStringLiteral(" sync chunks, ")
+            << m_syncChunkIndicesByPendingResourceGuids.size() << QStringLiteral(" resources"));
+
+    for(auto it = m_numPendingResourcesBySyncChunkIndices.constBegin(),
+        end = m_numPendingResourcesBySyncChunkIndices.constEnd(); it != end; ++it)
+    {
+        m_syncChunks.releaseResources(it.key());
+    }
+
+    m_numPendingResourcesBySyncChunkIndices.clear();
+    m_syncChunkIndicesByPendingResourceGuids.clear();
+}
+
+void RemoteToLocalSynchronizationManager::mergeSavedSearchesAndNotebooksFromDownloadedSyncChunks()
+{
+    QNDEBUG(QStringLiteral("RemoteToLocalSynchronizationManager::mergeSavedSearchesAndNotebooksFromDownloadedSyncChunks: ")
+            << QStringLiteral("num sync chunks = ") << m_syncChunks.size() << QStringLiteral(", num already merged sync chunks = ")
+            << m_numSyncChunksWithMergedSavedSearchesAndNotebooks);
+
+    int numSyncChunks = m_syncChunks.size();
+    for(int i = m_numSyncChunksWithMergedSavedSearchesAndNotebooks; i < numSyncChunks; ++i)
+    {
+        const qevercloud::SyncChunk & syncChunk = m_syncChunks.at(i);
+
+        SavedSearchesList savedSearches;
+        appendDataElementsFromSyncChunkToContainer<SavedSearchesList>(syncChunk, savedSearches);
+        extractExpungedElementsFromSyncChunk<SavedSearch>(syncChunk, m_expungedSavedSearches);
+
+        for(auto it = savedSearches.constBegin(), end = savedSearches.constEnd(); it != end; ++it)
+        {
+            const qevercloud::SavedSearch & element = *it;
+            if (Q_UNLIKELY(!element.guid.isSet())) {
+                QString typeName = QStringLiteral("Saved search");
+                SET_CANT_FIND_BY_GUID_ERROR();
+                Q_EMIT failure(errorDescription);
+                return;
+            }
+
+            m_savedSearches << element;
+            emitFindByGuidRequest(element);
+        }
+
+        NotebooksList notebooks;
+        appendDataElementsFromSyncChunkToContainer<NotebooksList>(syncChunk, notebooks);
+        extractExpungedElementsFromSyncChunk<Notebook>(syncChunk, m_expungedNotebooks);
+
+        for(auto it = notebooks.constBegin(), end = notebooks.constEnd(); it != end; ++it)
+        {
+            const qevercloud::Notebook & element = *it;
+            if (Q_UNLIKELY(!element.guid.isSet())) {
+                QString typeName = QStringLiteral("Notebook");
+                SET_CANT_FIND_BY_GUID_ERROR();
+                Q_EMIT failure(errorDescription);
+                return;
+            }
+
+            m_notebooks << element;
+            emitFindByGuidRequest(element);
+        }
+    }
+
+    m_numSyncChunksWithMergedSavedSearchesAndNotebooks = numSyncChunks;
+}
+
 QTextStream & RemoteToLocalSynchronizationManager::PostponedConflictingResourceData::print(QTextStream & strm) const
 {
     strm << QStringLiteral("PostponedConflictingResourceData: {\n  Remote note:\n")
@@ -9074,4 +11437,30 @@ QTextStream & RemoteToLocalSynchronizationManager::PostponedConflictingResourceD
     return strm;
 }
 
+RemoteToLocalSynchronizationManager::NoteDataDownloadOptions::NoteDataDownloadOptions() :
+    m_withContent(true),
+    m_withResourceData(true),
+    m_withResourceRecognition(true),
+    m_withResourceAlternateData(true)
+{}
+
+bool RemoteToLocalSynchronizationManager::NoteDataDownloadOptions::isFull() const
+{
+    return m_withContent && m_withResourceData && m_withResourceRecognition && m_withResourceAlternateData;
+}
+
+bool RemoteToLocalSynchronizationManager::NoteDataDownloadOptions::isEmpty() const
+{
+    return !m_withContent && !m_withResourceData && !m_withResourceRecognition && !m_withResourceAlternateData;
+}
+
+QTextStream & RemoteToLocalSynchronizationManager::NoteDataDownloadOptions::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("NoteDataDownloadOptions: with content = ") << (m_withContent ? QStringLiteral("true") : QStringLiteral("false"))
+         << QStringLiteral(", with resource data = ") << (m_withResourceData ? QStringLiteral("true") : QStringLiteral("false"))
+         << QStringLiteral(", with resource recognition = ") << (m_withResourceRecognition ? QStringLiteral("true") : QStringLiteral("false"))
+         << QStringLiteral(", with resource alternate data = ") << (m_withResourceAlternateData ? QStringLiteral("true") : QStringLiteral("false"));
+    return strm;
+}
+
 } // namespace quentier
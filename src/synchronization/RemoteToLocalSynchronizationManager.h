@@ -20,15 +20,21 @@
 #define LIB_QUENTIER_SYNCHRONIZATION_REMOTE_TO_LOCAL_SYNCHRONIZATION_MANAGER_H
 
 #include "FullSyncStaleDataItemsExpunger.h"
-#include "NoteStore.h"
-#include "UserStore.h"
 #include "NotebookSyncConflictResolver.h"
-#include "NotebookSyncCache.h"
 #include "TagSyncConflictResolver.h"
-#include "TagSyncCache.h"
 #include "SavedSearchSyncConflictResolver.h"
-#include "SavedSearchSyncCache.h"
+#include "SyncCachesManager.h"
+#include "SyncChunkSpool.h"
+#include "SyncChunkWindow.h"
+#include "DownloadScheduler.h"
+#include "NoteImagesDownloadManager.h"
+#include "SyncCheckpoint.h"
+#include "PendingItemsRegistry.h"
 #include "SynchronizationShared.h"
+#include "SyncTracer.h"
+#include "SelectiveSyncFilter.h"
+#include <quentier/synchronization/INoteStore.h>
+#include <quentier/synchronization/IUserStore.h>
 #include <quentier/types/Account.h>
 #include <quentier/types/ErrorString.h>
 #include <quentier/utility/Macros.h>
@@ -62,9 +68,10 @@ public:
     {
     public:
         virtual LocalStorageManagerAsync & localStorageManagerAsync() = 0;
-        virtual NoteStore & noteStore() = 0;
-        virtual UserStore & userStore() = 0;
-        virtual NoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) = 0;
+        virtual INoteStore & noteStore() = 0;
+        virtual IUserStore & userStore() = 0;
+        virtual INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) = 0;
+        virtual SyncTracer & syncTracer() = 0;
     };
 
     explicit RemoteToLocalSynchronizationManager(IManager & manager, const QString & host, QObject * parent = Q_NULLPTR);
@@ -84,6 +91,13 @@ public:
     bool shouldDownloadThumbnailsForNotes() const;
     bool shouldDownloadInkNoteImages() const;
     QString inkNoteImagesStoragePath() const;
+    qint64 syncChunksMemoryLimit() const;
+    int maxInFlightDownloads() const;
+    int maxParallelLinkedNotebookSyncs() const;
+    bool downloadResourceDataOnDemand() const;
+    qint32 resourceDataPrefetchMaxNoteAgeDays() const;
+    qint64 resourceDataPrefetchMaxSize() const;
+    SelectiveSyncFilter selectiveSyncFilter() const;
 
 Q_SIGNALS:
     void failure(ErrorString errorDescription);
@@ -103,9 +117,20 @@ Q_SIGNALS:
 
     void synchronizedContentFromUsersOwnAccount(qint32 lastUpdateCount, qevercloud::Timestamp lastSyncTime);
 
+    // signal notifying that the notes and resources put into the local storage so far were persisted
+    // to the sync checkpoint so it's the right moment to persist the update counts from which the sync
+    // should be resumed if it gets interrupted
+    void syncCheckpointReached();
+
     void linkedNotebookSyncChunksDownloadProgress(qint32 highestDownloadedUsn, qint32 highestServerUsn,
                                                   qint32 lastPreviousUsn, LinkedNotebook linkedNotebook);
     void linkedNotebooksSyncChunksDownloaded();
+
+    // signals notifying about the outcome of sync chunks download for each individual linked notebook;
+    // the linked notebook which failed to sync is skipped, the rest of linked notebooks are synchronized as usual
+    void linkedNotebookSyncChunksDownloadFinished(LinkedNotebook linkedNotebook);
+    void linkedNotebookSyncFailed(LinkedNotebook linkedNotebook, ErrorString errorDescription);
+
     void linkedNotebooksNotesDownloadProgress(quint32 notesDownloaded, quint32 totalNotesToDownload);
     void linkedNotebooksResourcesDownloadProgress(quint32 resourcesDownloaded, quint32 totalResourcesToDownload);
 
@@ -132,6 +157,14 @@ public Q_SLOTS:
     void setDownloadNoteThumbnails(const bool flag);
     void setDownloadInkNoteImages(const bool flag);
     void setInkNoteImagesStoragePath(const QString & path);
+    void setSyncChunksMemoryLimit(const qint64 memoryLimitBytes);
+    void setMaxInFlightDownloads(const int maxInFlightDownloads);
+    void setMaxParallelLinkedNotebookSyncs(const int maxParallelLinkedNotebookSyncs);
+    void setDownloadResourceDataOnDemand(const bool flag);
+    void setResourceDataPrefetchPolicy(const qint32 maxNoteAgeDays, const qint64 maxNoteResourcesSizeBytes);
+    void setVisibleNoteGuids(const QStringList & noteGuids);
+    void setSelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids);
+    void prioritizeNoteDownloads(const QStringList & noteGuids);
 
     void collectNonProcessedItemsSmallestUsns(qint32 & usn, QHash<QString,qint32> & usnByLinkedNotebookGuid);
 
@@ -144,6 +177,7 @@ Q_SIGNALS:
     void addNotebook(Notebook notebook, QUuid requestId);
     void updateNotebook(Notebook notebook, QUuid requestId);
     void findNotebook(Notebook notebook, QUuid requestId);
+    void findLastUsedNotebook(Notebook notebook, QUuid requestId);
     void expungeNotebook(Notebook notebook, QUuid requestId);
 
     void addNote(Note note, QUuid requestId);
@@ -179,6 +213,8 @@ private Q_SLOTS:
     void onFindUserFailed(User user, ErrorString errorDescription, QUuid requestId);
     void onFindNotebookCompleted(Notebook notebook, QUuid requestId);
     void onFindNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
+    void onFindLastUsedNotebookCompleted(Notebook notebook, QUuid requestId);
+    void onFindLastUsedNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
     void onFindNoteCompleted(Note note, bool withResourceBinaryData, QUuid requestId);
     void onFindNoteFailed(Note note, bool withResourceBinaryData, ErrorString errorDescription, QUuid requestId);
     void onFindTagCompleted(Tag tag, QUuid requestId);
@@ -251,6 +287,13 @@ private Q_SLOTS:
 
     void onGetNoteAsyncFinished(qint32 errorCode, qevercloud::Note qecNote, qint32 rateLimitSeconds, ErrorString errorDescription);
     void onGetResourceAsyncFinished(qint32 errorCode, qevercloud::Resource qecResource, qint32 rateLimitSeconds, ErrorString errorDescription);
+    void onGetSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk, qint32 afterUsn,
+                                     qint32 rateLimitSeconds, ErrorString errorDescription);
+    void onGetLinkedNotebookSyncStateAsyncFinished(qint32 errorCode, qevercloud::SyncState syncState, qint32 rateLimitSeconds,
+                                                   ErrorString errorDescription, QString linkedNotebookGuid);
+    void onGetLinkedNotebookSyncChunkAsyncFinished(qint32 errorCode, qevercloud::SyncChunk syncChunk, qint32 afterUsn,
+                                                   qint32 rateLimitSeconds, ErrorString errorDescription,
+                                                   QString linkedNotebookGuid);
 
     // Slots for TagSyncCache
     void onTagSyncCacheFilled();
@@ -277,6 +320,7 @@ private:
     void resetCurrentSyncState();
 
     QString defaultInkNoteImageStoragePath() const;
+    QString noteImagesCachePath() const;
 
     void launchSync();
 
@@ -297,7 +341,11 @@ private:
     void launchLinkedNotebookSync();
     void launchNotebookSync();
 
-    void collectSyncedGuidsForFullSyncStaleDataItemsExpunger();
+    // The guids of data items from every downloaded sync chunk are collected as soon as the sync chunk arrives:
+    // with the merging of sync chunks pipelined with their download and spooling of sync chunks to disk
+    // the containers of data items pending processing never hold all of them at once
+    void collectSyncedGuidsFromSyncChunk(const qevercloud::SyncChunk & syncChunk,
+                                         FullSyncStaleDataItemsExpunger::SyncedGuids & syncedGuids) const;
     void launchFullSyncStaleDataItemsExpunger();
 
     // Returns true if full sync stale data items expunger was launched
@@ -310,6 +358,31 @@ private:
 
     bool syncingLinkedNotebooksContent() const;
 
+    // The sync checkpoint is written periodically while the sync is active and when it's stopped; it is removed
+    // once the sync finishes successfully
+    QString syncCheckpointFilePath() const;
+    void readSyncCheckpoint();
+    void writeSyncCheckpoint();
+    void startSyncCheckpointTimer();
+    bool shouldSkipItemsFromSyncCheckpoint() const;
+
+    // The update count after which the full sync of user's own account should be resumed if it gets interrupted now
+    qint32 fullSyncAfterUsn() const;
+
+    SelectiveSyncFilter appliedSelectiveSyncFilter() const;
+    void persistAppliedSelectiveSyncFilter();
+
+    // Removes the notes which were already synchronized by the previous syncs (i.e. those not newer than the last
+    // previous update count and selected by the applied selective sync filter) from the sync chunk downloaded
+    // in order to pick the notes skipped by the previous syncs
+    void removeNotesSyncedBeforeSelectiveSyncFilterChange(QList<qevercloud::Note> & notes, const qint32 lastPreviousUsn) const;
+
+    // The selective sync filter only prevents the notes without local copies from being added to the local storage:
+    // the notes synchronized before being moved or retagged out of the selection on the server are still updated,
+    // otherwise the stale local copies would be sent back over the remote changes
+    bool shouldSkipNewNoteDueToSelectiveSyncFilter(const qevercloud::Note & note) const;
+    void skipNewNoteDueToSelectiveSyncFilter(const qevercloud::Note & note);
+
     void checkAndIncrementNoteDownloadProgress(const QString & noteGuid);
     void checkAndIncrementResourceDownloadProgress(const QString & resourceGuid);
 
@@ -335,13 +408,33 @@ private:
                                QList<QString> & expungedElements);
 
     template <class ContainerType, class LocalType>
-    void launchDataElementSyncCommon(const ContentSource::type contentSource, ContainerType & container,
+    bool launchDataElementSyncCommon(const ContentSource::type contentSource, ContainerType & container,
                                      QList<QString> & expungedElements);
 
+    // Returns the number of user's own account's sync chunks which data elements of the given type
+    // have already been merged with the local storage while the rest of sync chunks were being downloaded
+    template <class ElementType>
+    int numSyncChunksMergedDuringDownload() const;
+
     template <class ElementType>
     void extractExpungedElementsFromSyncChunk(const qevercloud::SyncChunk & syncChunk,
                                               QList<QString> & expungedElementGuids);
 
+    SyncChunkSpool & syncChunksForContentSource(const ContentSource::type contentSource);
+
+    // The notes and resources are taken from the sync chunks for processing only a few sync chunks at a time,
+    // the next sync chunk's ones are taken once all notes or resources from one of the previously taken sync chunks
+    // have been processed; that keeps the notes and resources of the whole account from being held in memory at once
+    void takeNotesFromSyncChunks();
+    void takeResourcesFromSyncChunks();
+    bool notesPendingTakingFromSyncChunks() const;
+    bool resourcesPendingTakingFromSyncChunks() const;
+    void processNotesTakenFromSyncChunk(const PendingItemsRegistry<qevercloud::Note> & notes);
+    void onNoteTakenFromSyncChunkProcessed(const QString & noteGuid);
+    void onResourceTakenFromSyncChunkProcessed(const QString & resourceGuid);
+    void releaseNotesTakenFromSyncChunks();
+    void releaseResourcesTakenFromSyncChunks();
+
     // Returns binded linked notebook guid or empty string if no linked notebook guid was bound
     template <class ElementType>
     QString checkAndAddLinkedNotebookBinding(ElementType & targetElement);
@@ -489,6 +582,14 @@ private:
                                     const QString & authToken, qevercloud::SyncState & syncState,
                                     bool & asyncWait, bool & error);
     bool downloadLinkedNotebooksSyncChunks();
+    bool scheduleLinkedNotebooksSyncChunksDownloads();
+    bool requestNextLinkedNotebookSyncData(const QString & linkedNotebookGuid);
+    bool processLinkedNotebookSyncState(const QString & linkedNotebookGuid, const qevercloud::SyncState & syncState);
+    void processLinkedNotebookSyncDataDownloadError(const QString & linkedNotebookGuid, const qint32 errorCode,
+                                                    const qint32 rateLimitSeconds, const ErrorString & errorDescription);
+    void finishLinkedNotebookSyncChunksDownload(const QString & linkedNotebookGuid);
+    void checkLinkedNotebooksSyncChunksDownloadCompletion();
+    void finalizeLinkedNotebooksSyncChunksDownload();
 
     void launchLinkedNotebooksTagsSync();
     void launchLinkedNotebooksNotebooksSync();
@@ -513,7 +614,29 @@ private:
     void getFullResourceDataAsyncAndAddToLocalStorage(const Resource & resource, const Note & resourceOwningNote);
     void getFullResourceDataAsyncAndUpdateInLocalStorage(const Resource & resource, const Note & resourceOwningNote);
 
+    /**
+     * @brief shouldDownloadResourceData - figures out whether the binary data of the note's resources should be
+     * downloaded during the sync or left to be downloaded on demand
+     * @param resourcesDataSize - the size of the resources' binary data to be downloaded
+     */
+    bool shouldDownloadResourceData(const Note & note, const qint64 resourcesDataSize) const;
+
+    // The full note and resource data downloads go through the download scheduler which limits the number
+    // of downloads in flight and holds them back while the rate limit is in effect
+    void scheduleFullNoteDataDownload(const Note & note);
+    void scheduleFullResourceDataDownload(const Resource & resource, const Note & resourceOwningNote);
+    void startScheduledDownloads();
+    DownloadScheduler::PriorityClass::type downloadPriorityClassForNote(const Note & note) const;
+    DownloadScheduler::Urgency::type downloadUrgencyForNote(const Note & note) const;
+
+    // Recomputes the urgency of queued note and resource downloads after any of the inputs it depends on has changed
+    void updateScheduledDownloadsUrgency();
+
     void downloadSyncChunksAndLaunchSync(qint32 afterUsn);
+    void downloadNextSyncChunkOrWaitForLocalStorage();
+    void resumeSyncChunksDownloadPostponedByLocalStorage();
+    void mergeSavedSearchesAndNotebooksFromDownloadedSyncChunks();
+    int numPendingSavedSearchesAndNotebooksLocalStorageRequests() const;
 
     const Notebook * getNotebookPerNote(const Note & note) const;
 
@@ -526,12 +649,14 @@ private:
                                        QString & shardId, bool & isPublic) const;
 
     bool findNotebookForInkNoteImageDownloading(const Note & note);
-    void setupInkNoteImageDownloading(const QString & resourceGuid, const int resourceHeight, const int resourceWidth,
+    void setupInkNoteImageDownloading(const QString & resourceGuid, const QByteArray & resourceDataHash,
+                                      const int resourceHeight, const int resourceWidth,
                                       const QString & noteGuid, const Notebook & notebook);
     bool setupInkNoteImageDownloadingForNote(const Note & note, const Notebook & notebook);
 
     bool findNotebookForNoteThumbnailDownloading(const Note & note);
     bool setupNoteThumbnailDownloading(const Note & note, const Notebook & notebook);
+    NoteImagesDownloadManager::PriorityClass::type noteImagesDownloadPriorityClass(const Notebook & notebook) const;
 
     QString clientNameForProtocolVersionCheck() const;
 
@@ -557,29 +682,25 @@ private:
     void processResourceConflictAsNoteConflict(Note & remoteNote, const Note & localConflictingNote,
                                                Resource & remoteNoteResource);
 
-    void syncNextTagPendingProcessing();
+    void syncNextTagsLevelPendingProcessing();
+    void onTagFromCurrentLevelProcessed(const QString & tagGuid);
 
     void junkFullSyncStaleDataItemsExpunger(FullSyncStaleDataItemsExpunger & expunger);
 
-    NoteStore * noteStoreForNote(const Note & note, QString & authToken, ErrorString & errorDescription) const;
+    INoteStore * noteStoreForNote(const Note & note, QString & authToken, ErrorString & errorDescription) const;
 
     void checkAndRemoveInaccessibleParentTagGuidsForTagsFromLinkedNotebook(const QString & linkedNotebookGuid,
                                                                            const TagSyncCache & tagSyncCache);
 
-    void startFeedingDownloadedTagsToLocalStorageOneByOne(const TagsContainer & container);
-
-private:
-    template <class T>
-    class Q_DECL_HIDDEN CompareItemByName
-    {
-    public:
-        CompareItemByName(const QString & name) : m_name(name) {}
-        bool operator()(const T & item) const;
+    void startFeedingDownloadedTagsToLocalStorageByLevels(const TagsContainer & container);
 
-    private:
-        const QString m_name;
-    };
+    void beginSyncTraceSpan(const SyncTracer::Phase::type phase, const QString & id);
+    void endSyncTraceSpan(const SyncTracer::Phase::type phase, const QString & id,
+                          const qint64 numItems = 0, const qint64 numBytes = 0);
+    void beginSyncTraceMergePhaseSpan(const SyncTracer::Phase::type phase);
+    void checkSyncTraceMergePhasesCompletion();
 
+private:
     template <class T>
     class Q_DECL_HIDDEN CompareItemByGuid
     {
@@ -592,11 +713,12 @@ private:
     };
 
     typedef QList<qevercloud::Tag> TagsList;
-    typedef QList<qevercloud::SavedSearch> SavedSearchesList;
-    typedef QList<qevercloud::LinkedNotebook> LinkedNotebooksList;
-    typedef QList<qevercloud::Notebook> NotebooksList;
-    typedef QList<qevercloud::Note> NotesList;
-    typedef QList<qevercloud::Resource> ResourcesList;
+    typedef PendingItemsRegistry<qevercloud::Tag> TagsRegistry;
+    typedef PendingItemsRegistry<qevercloud::SavedSearch> SavedSearchesList;
+    typedef PendingItemsRegistry<qevercloud::LinkedNotebook> LinkedNotebooksList;
+    typedef PendingItemsRegistry<qevercloud::Notebook> NotebooksList;
+    typedef PendingItemsRegistry<qevercloud::Note> NotesList;
+    typedef PendingItemsRegistry<qevercloud::Resource> ResourcesList;
 
     bool sortTagsByParentChildRelations(TagsList & tags);
 
@@ -604,6 +726,7 @@ private:
     {
         InkNoteResourceData() :
             m_resourceGuid(),
+            m_resourceDataHash(),
             m_noteGuid(),
             m_resourceHeight(0),
             m_resourceWidth(0)
@@ -611,12 +734,14 @@ private:
 
         InkNoteResourceData(const QString & resourceGuid, const QString & noteGuid, int height, int width) :
             m_resourceGuid(resourceGuid),
+            m_resourceDataHash(),
             m_noteGuid(noteGuid),
             m_resourceHeight(height),
             m_resourceWidth(width)
         {}
 
         QString     m_resourceGuid;
+        QByteArray  m_resourceDataHash;
         QString     m_noteGuid;
         int         m_resourceHeight;
         int         m_resourceWidth;
@@ -643,6 +768,31 @@ private:
         virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
     };
 
+    /**
+     * @brief The NoteDataDownloadOptions class describes which parts of the note need to be downloaded
+     * in order to update the existing local note with the remote changes; the parts which haven't changed
+     * according to the hashes listed within the sync chunk are taken from the local note instead
+     */
+    class NoteDataDownloadOptions: public Printable
+    {
+    public:
+        NoteDataDownloadOptions();
+
+        bool isFull() const;
+        bool isEmpty() const;
+
+        virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+        bool    m_withContent;
+        bool    m_withResourceData;
+        bool    m_withResourceRecognition;
+        bool    m_withResourceAlternateData;
+    };
+
+    NoteDataDownloadOptions noteDataDownloadOptions(const Note & localNote, const qevercloud::Note & remoteNote) const;
+    void updateNoteInLocalStorageKeepingLocalData(Note & note, const Note & localNote);
+    void copyLocalResourcesBinaryData(Note & note, const Note & localNote) const;
+
     struct SyncMode
     {
         enum type
@@ -660,7 +810,9 @@ private:
 
     QString                                 m_host;
 
-    qint32                                  m_maxSyncChunksPerOneDownload;
+    // The number of entries requested within each sync chunk adapts to the download times and sizes of sync chunks
+    SyncChunkWindow                         m_syncChunkWindow;
+    SyncChunkWindow                         m_linkedNotebookSyncChunkWindow;
     SyncMode::type                          m_lastSyncMode;
 
     qint32                                  m_lastUpdateCount;
@@ -669,6 +821,10 @@ private:
     // Denotes whether the full sync of stuff from user's own account had been performed at least once in the past
     bool                                    m_onceSyncDone;
 
+    // Denotes whether the current full sync of stuff from user's own account resumes the interrupted one
+    // (so the local storage might contain stale data items which need to be expunged once the full sync is over)
+    bool                                    m_fullSyncResumedFromSyncCheckpoint;
+
     qint32                                  m_lastUsnOnStart;
     qint32                                  m_lastSyncChunksDownloadedUsn;
 
@@ -681,15 +837,32 @@ private:
 
     bool                                    m_edamProtocolVersionChecked;
 
-    QVector<qevercloud::SyncChunk>          m_syncChunks;
-    QVector<qevercloud::SyncChunk>          m_linkedNotebookSyncChunks;
+    SyncChunkSpool                          m_syncChunks;
+    SyncChunkSpool                          m_linkedNotebookSyncChunks;
+    QStringList                             m_linkedNotebookGuidsOfLinkedNotebookSyncChunks;  // by sync chunk index
     QSet<QString>                           m_linkedNotebookGuidsForWhichSyncChunksWereDownloaded;
 
+    // State of taking the notes and resources from the sync chunks for processing; negative index of the next
+    // sync chunk to take the data elements from means they are not being taken at the moment
+    ContentSource::type                     m_notesSyncContentSource;
+    int                                     m_nextSyncChunkIndexToTakeNotesFrom;
+    int                                     m_nextSyncChunkIndexToTakeResourcesFrom;
+    QHash<QString,int>                      m_syncChunkIndicesByPendingNoteGuids;
+    QHash<int,int>                          m_numPendingNotesBySyncChunkIndices;
+    QHash<QString,int>                      m_syncChunkIndicesByPendingResourceGuids;
+    QHash<int,int>                          m_numPendingResourcesBySyncChunkIndices;
+    QHash<QString,int>                      m_lastSyncChunkIndicesByNoteGuids;
+    QHash<QString,int>                      m_lastSyncChunkIndicesByResourceGuids;
+    QHash<QString,int>                      m_lastSyncChunkIndicesByExpungedNoteGuids;
+    QHash<QString,int>                      m_lastSyncChunkIndicesByExpungedNotebookGuids;
+
     qevercloud::AccountLimits               m_accountLimits;
 
     TagsContainer                           m_tags;
     TagsList                                m_tagsPendingProcessing;
-    TagsList                                m_tagsPendingAddOrUpdate;
+    QList<int>                              m_tagsPendingProcessingLevelSizes;
+    QSet<QString>                           m_guidsOfTagsFromCurrentLevelPendingProcessing;
+    TagsRegistry                            m_tagsPendingAddOrUpdate;
     QList<QString>                          m_expungedTags;
     QSet<QUuid>                             m_findTagByNameRequestIds;
     QHash<QUuid, QString>                   m_linkedNotebookGuidsByFindTagByNameRequestIds;
@@ -699,8 +872,6 @@ private:
     QSet<QUuid>                             m_expungeTagRequestIds;
     bool                                    m_pendingTagsSyncStart;
 
-    TagSyncCache                            m_tagSyncCache;
-    QMap<QString, TagSyncCache*>            m_tagSyncCachesByLinkedNotebookGuids;
     QSet<QString>                           m_linkedNotebookGuidsPendingTagSyncCachesFill;
 
     QHash<QString,QString>                  m_linkedNotebookGuidsByTagGuids;
@@ -715,8 +886,6 @@ private:
     QSet<QUuid>                             m_updateSavedSearchRequestIds;
     QSet<QUuid>                             m_expungeSavedSearchRequestIds;
 
-    SavedSearchSyncCache                    m_savedSearchSyncCache;
-
     LinkedNotebooksList                     m_linkedNotebooks;
     LinkedNotebooksList                     m_linkedNotebooksPendingAddOrUpdate;
     QList<QString>                          m_expungedLinkedNotebooks;
@@ -746,6 +915,40 @@ private:
 
     QHash<QString,qevercloud::SyncState>    m_syncStatesByLinkedNotebookGuid;
 
+    // State of the concurrent download of linked notebooks' sync chunks: each linked notebook has its own
+    // sequence of requests, up to m_maxParallelLinkedNotebookSyncs linked notebooks have requests in flight
+    struct LinkedNotebookSyncChunksDownload
+    {
+        LinkedNotebookSyncChunksDownload() :
+            m_linkedNotebook(),
+            m_afterUsn(0),
+            m_lastPreviousUsn(0),
+            m_lastSyncTime(0),
+            m_lastUpdateCount(0),
+            m_fullSyncOnly(false),
+            m_needSyncState(false),
+            m_requestMaxEntries(0),
+            m_requestTimestamp(0)
+        {}
+
+        LinkedNotebook          m_linkedNotebook;
+        qint32                  m_afterUsn;
+        qint32                  m_lastPreviousUsn;
+        qevercloud::Timestamp   m_lastSyncTime;
+        qint32                  m_lastUpdateCount;
+        bool                    m_fullSyncOnly;
+        bool                    m_needSyncState;
+        qint32                  m_requestMaxEntries;
+        qint64                  m_requestTimestamp;
+    };
+
+    bool                                    m_linkedNotebooksSyncChunksDownloadStarted;
+    QList<QString>                          m_linkedNotebookGuidsPendingSyncChunksDownload;
+    QHash<QString,LinkedNotebookSyncChunksDownload> m_linkedNotebookSyncChunksDownloadsByGuid;
+    QSet<QString>                           m_linkedNotebookGuidsWithSyncChunksDownloadRequestsInFlight;
+    QSet<QString>                           m_linkedNotebookGuidsFailedToSync;
+    int                                     m_maxParallelLinkedNotebookSyncs;
+
     QHash<QString,qint32>                   m_lastUpdateCountByLinkedNotebookGuid;
     QHash<QString,qevercloud::Timestamp>    m_lastSyncTimeByLinkedNotebookGuid;
     QSet<QString>                           m_linkedNotebookGuidsForWhichFullSyncWasPerformed;
@@ -764,8 +967,7 @@ private:
     QSet<QUuid>                             m_expungeNotebookRequestIds;
     bool                                    m_pendingNotebooksSyncStart;
 
-    NotebookSyncCache                       m_notebookSyncCache;
-    QMap<QString, NotebookSyncCache*>       m_notebookSyncCachesByLinkedNotebookGuids;
+    SyncCachesManager                       m_syncCachesManager;
 
     QHash<QString,QString>                  m_linkedNotebookGuidsByNotebookGuids;
 
@@ -819,23 +1021,67 @@ private:
     QSet<QString>                           m_guidsOfNotesPendingDownloadForAddingToLocalStorage;
     QHash<QString,Note>                     m_notesPendingDownloadForUpdatingInLocalStorageByGuid;
 
+    // The local notes along with the changed parts to download for the notes which were changed only partially
+    typedef QHash<QString,QPair<Note,NoteDataDownloadOptions> > PartialNoteDataDownloadsByGuid;
+    PartialNoteDataDownloadsByGuid          m_partialNoteDataDownloadsByGuid;
+    QHash<QUuid,Note>                       m_notesPendingLocalResourceDataByFindNoteRequestId;
+
     QHash<QString,Note>                         m_notesOwningResourcesPendingDownloadForAddingToLocalStorageByResourceGuid;
     QHash<QString,std::pair<Resource,Note> >    m_resourcesPendingDownloadForUpdatingInLocalStorageWithNotesByResourceGuid;
 
     FullSyncStaleDataItemsExpunger::SyncedGuids     m_fullSyncStaleDataItemsSyncedGuids;
+    QHash<QString, FullSyncStaleDataItemsExpunger::SyncedGuids> m_fullSyncStaleDataItemsSyncedGuidsByLinkedNotebookGuid;
     FullSyncStaleDataItemsExpunger *                m_pFullSyncStaleDataItemsExpunger;
     QMap<QString, FullSyncStaleDataItemsExpunger*>  m_fullSyncStaleDataItemsExpungersByLinkedNotebookGuid;
 
-    QHash<int,Note>                         m_notesToAddPerAPICallPostponeTimerId;
-    QHash<int,Note>                         m_notesToUpdatePerAPICallPostponeTimerId;
-
-    QHash<int,std::pair<Resource,Note> >    m_resourcesToAddWithNotesPerAPICallPostponeTimerId;
-    QHash<int,std::pair<Resource,Note> >    m_resourcesToUpdateWithNotesPerAPICallPostponeTimerId;
+    DownloadScheduler                       m_downloadScheduler;
+    int                                     m_downloadSchedulerBackoffTimerId;
+
+    // The inputs for the urgency of note and resource downloads: the requested and visible notes come from the UI
+    // and are kept between syncs, the last used notebook is looked up in the local storage on the start of each sync
+    QSet<QString>                           m_requestedNoteGuids;
+    QSet<QString>                           m_visibleNoteGuids;
+    QString                                 m_lastUsedNotebookGuid;
+    QUuid                                   m_findLastUsedNotebookRequestId;
+
+    NoteImagesDownloadManager               m_noteImagesDownloadManager;
+
+    // When the resources' data is downloaded on demand, only the data of the recently modified notes
+    // which is not too large is downloaded during the sync
+    bool                                    m_downloadResourceDataOnDemand;
+    qint32                                  m_resourceDataPrefetchMaxNoteAgeDays;
+    qint64                                  m_resourceDataPrefetchMaxSize;
+
+    // The selective sync filter in effect during the current sync and the one in effect during the last completed sync;
+    // the notes skipped by the latter but selected by the former are downloaded by the backfill pass which re-downloads
+    // the notes part of sync chunks up to the update count the current sync has started from
+    SelectiveSyncFilter                     m_selectiveSyncFilter;
+    SelectiveSyncFilter                     m_appliedSelectiveSyncFilter;
+    bool                                    m_selectiveSyncBackfillPending;
+    qint32                                  m_selectiveSyncBackfillUpToUsn;
+    bool                                    m_selectiveSyncBackfillInProgress;
+
+    // The notes without local copies skipped due to the selective sync filter; they are still considered synced
+    // by the stale data items expunger after the full sync: narrowing the filter doesn't remove the notes
+    // synchronized before from the local storage
+    QHash<QString,QString>                  m_notebookGuidsBySelectiveSyncSkippedNoteGuids;
+
+    SyncCheckpoint                          m_syncCheckpoint;
+    int                                     m_syncCheckpointTimerId;
 
     QHash<int,PostponedConflictingResourceData> m_postponedConflictingResourceDataPerAPICallPostponeTimerId;
 
     QHash<int,qint32>                       m_afterUsnForSyncChunkPerAPICallPostponeTimerId;
 
+    // State of the asynchronous download of user's own account's sync chunks
+    qint32                                  m_lastPreviousUsnOnSyncChunksDownload;
+    qint32                                  m_pendingSyncChunkAfterUsn;
+    qint32                                  m_pendingSyncChunkMaxEntries;
+    qint64                                  m_pendingSyncChunkRequestTimestamp;
+    qint32                                  m_afterUsnForSyncChunkPendingAuthentication;
+    int                                     m_numSyncChunksWithMergedSavedSearchesAndNotebooks;
+    bool                                    m_syncChunksDownloadPostponedByLocalStorage;
+
     int                                     m_getLinkedNotebookSyncStateBeforeStartAPICallPostponeTimerId;
     int                                     m_downloadLinkedNotebookSyncChunkAPICallPostponeTimerId;
     int                                     m_getSyncStateBeforeStartAPICallPostponeTimerId;
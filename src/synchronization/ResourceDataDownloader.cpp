@@ -0,0 +1,245 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceDataDownloader.h"
+#include <quentier/synchronization/INoteStore.h>
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/logging/QuentierLogger.h>
+#include <algorithm>
+
+namespace quentier {
+
+ResourceDataDownloader::ResourceDataDownloader(LocalStorageManagerAsync & localStorageManagerAsync, INoteStore & noteStore,
+                                               QObject * parent) :
+    QObject(parent),
+    m_localStorageManagerAsync(localStorageManagerAsync),
+    m_noteStore(noteStore),
+    m_connectedToLocalStorage(false),
+    m_noteStoresByUrl(),
+    m_resourcesByGuid(),
+    m_requestIdsByResourceGuid(),
+    m_resourceGuidsByUpdateResourceRequestId()
+{}
+
+void ResourceDataDownloader::download(const Resource & resource, const QString & noteStoreUrl,
+                                      const QString & authToken, const QUuid & requestId)
+{
+    QNDEBUG(QStringLiteral("ResourceDataDownloader::download: note store url = ") << noteStoreUrl
+            << QStringLiteral(", request id = ") << requestId << QStringLiteral(", resource: ") << resource);
+
+    if (Q_UNLIKELY(!resource.hasGuid())) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't download the resource data: the resource has no guid"));
+        QNWARNING(errorDescription << QStringLiteral(", resource: ") << resource);
+        Q_EMIT failed(resource, errorDescription, requestId);
+        return;
+    }
+
+    if (Q_UNLIKELY(noteStoreUrl.isEmpty())) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't download the resource data: no note store URL"));
+        QNWARNING(errorDescription << QStringLiteral(", resource: ") << resource);
+        Q_EMIT failed(resource, errorDescription, requestId);
+        return;
+    }
+
+    const QString & resourceGuid = resource.guid();
+
+    if (m_resourcesByGuid.contains(resourceGuid)) {
+        QNDEBUG(QStringLiteral("The data of this resource is already being downloaded"));
+        m_requestIdsByResourceGuid.insert(resourceGuid, requestId);
+        return;
+    }
+
+    connectToLocalStorage();
+
+    INoteStore * pNoteStore = noteStoreForUrl(noteStoreUrl);
+
+    ErrorString errorDescription;
+    bool res = pNoteStore->getResourceAsync(/* with data body = */ true, /* with recognition data body = */ true,
+                                            /* with alternate data body = */ true, /* with attributes = */ false,
+                                            resourceGuid, authToken, errorDescription);
+    if (!res) {
+        QNWARNING(errorDescription << QStringLiteral(", resource: ") << resource);
+        Q_EMIT failed(resource, errorDescription, requestId);
+        return;
+    }
+
+    m_resourcesByGuid[resourceGuid] = resource;
+    m_requestIdsByResourceGuid.insert(resourceGuid, requestId);
+}
+
+void ResourceDataDownloader::stop()
+{
+    QNDEBUG(QStringLiteral("ResourceDataDownloader::stop"));
+
+    for(auto it = m_noteStoresByUrl.begin(), end = m_noteStoresByUrl.end(); it != end; ++it) {
+        it.value()->stop();
+    }
+
+    m_resourcesByGuid.clear();
+    m_requestIdsByResourceGuid.clear();
+    m_resourceGuidsByUpdateResourceRequestId.clear();
+}
+
+void ResourceDataDownloader::onGetResourceAsyncFinished(qint32 errorCode, qevercloud::Resource qecResource,
+                                                        qint32 rateLimitSeconds, ErrorString errorDescription)
+{
+    if (Q_UNLIKELY(!qecResource.guid.isSet())) {
+        QNDEBUG(QStringLiteral("ResourceDataDownloader::onGetResourceAsyncFinished: the downloaded resource has no guid"));
+        return;
+    }
+
+    const QString & resourceGuid = qecResource.guid.ref();
+
+    auto it = m_resourcesByGuid.find(resourceGuid);
+    if (it == m_resourcesByGuid.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("ResourceDataDownloader::onGetResourceAsyncFinished: error code = ") << errorCode
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds << QStringLiteral(", error description: ")
+            << errorDescription << QStringLiteral(", resource guid = ") << resourceGuid);
+
+    if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+    {
+        // NOTE: unlike the synchronization, the on-demand download is not retried automatically:
+        // the one who requested it is in a better position to decide whether it's still needed
+        errorDescription.setBase(QT_TR_NOOP("Can't download the resource data: the Evernote API rate limit was reached, "
+                                            "please try again in several seconds"));
+        errorDescription.details() = QString::number(std::max(rateLimitSeconds, 0));
+        reportFailure(resourceGuid, errorDescription);
+        return;
+    }
+    else if (errorCode != 0)
+    {
+        reportFailure(resourceGuid, errorDescription);
+        return;
+    }
+
+    // NOTE: only the binary data is taken from the downloaded resource, the rest of the resource's data
+    // is brought up to date by the synchronization
+    Resource resource = it.value();
+    qevercloud::Resource & targetResource = resource.qevercloudResource();
+    targetResource.data = qecResource.data;
+    targetResource.recognition = qecResource.recognition;
+    targetResource.alternateData = qecResource.alternateData;
+    it.value() = resource;
+
+    QUuid updateResourceRequestId = QUuid::createUuid();
+    m_resourceGuidsByUpdateResourceRequestId[updateResourceRequestId] = resourceGuid;
+    QNTRACE(QStringLiteral("Emitting the request to update the resource in the local storage: request id = ")
+            << updateResourceRequestId << QStringLiteral(", resource guid = ") << resourceGuid);
+    Q_EMIT updateResource(resource, updateResourceRequestId);
+}
+
+void ResourceDataDownloader::onUpdateResourceComplete(Resource resource, QUuid requestId)
+{
+    auto it = m_resourceGuidsByUpdateResourceRequestId.find(requestId);
+    if (it == m_resourceGuidsByUpdateResourceRequestId.end()) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("ResourceDataDownloader::onUpdateResourceComplete: request id = ") << requestId);
+
+    QString resourceGuid = it.value();
+    Q_UNUSED(m_resourceGuidsByUpdateResourceRequestId.erase(it))
+    Q_UNUSED(m_resourcesByGuid.remove(resourceGuid))
+
+    QList<QUuid> requestIds = m_requestIdsByResourceGuid.values(resourceGuid);
+    Q_UNUSED(m_requestIdsByResourceGuid.remove(resourceGuid))
+
+    for(auto rit = requestIds.constBegin(), rend = requestIds.constEnd(); rit != rend; ++rit) {
+        Q_EMIT finished(resource, *rit);
+    }
+}
+
+void ResourceDataDownloader::onUpdateResourceFailed(Resource resource, ErrorString errorDescription, QUuid requestId)
+{
+    auto it = m_resourceGuidsByUpdateResourceRequestId.find(requestId);
+    if (it == m_resourceGuidsByUpdateResourceRequestId.end()) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("ResourceDataDownloader::onUpdateResourceFailed: request id = ") << requestId
+              << QStringLiteral(", error: ") << errorDescription << QStringLiteral(", resource: ") << resource);
+
+    QString resourceGuid = it.value();
+    Q_UNUSED(m_resourceGuidsByUpdateResourceRequestId.erase(it))
+
+    reportFailure(resourceGuid, errorDescription);
+}
+
+void ResourceDataDownloader::connectToLocalStorage()
+{
+    if (m_connectedToLocalStorage) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("ResourceDataDownloader::connectToLocalStorage"));
+
+    QObject::connect(this, QNSIGNAL(ResourceDataDownloader,updateResource,Resource,QUuid),
+                     &m_localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateResourceRequest,Resource,QUuid));
+
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateResourceComplete,Resource,QUuid),
+                     this, QNSLOT(ResourceDataDownloader,onUpdateResourceComplete,Resource,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateResourceFailed,Resource,ErrorString,QUuid),
+                     this, QNSLOT(ResourceDataDownloader,onUpdateResourceFailed,Resource,ErrorString,QUuid));
+
+    m_connectedToLocalStorage = true;
+}
+
+INoteStore * ResourceDataDownloader::noteStoreForUrl(const QString & noteStoreUrl)
+{
+    auto it = m_noteStoresByUrl.find(noteStoreUrl);
+    if (it != m_noteStoresByUrl.end()) {
+        return it.value();
+    }
+
+    QNDEBUG(QStringLiteral("ResourceDataDownloader: creating the note store for url ") << noteStoreUrl);
+
+    INoteStore * pNoteStore = m_noteStore.create();
+    pNoteStore->setParent(this);
+    pNoteStore->setNoteStoreUrl(noteStoreUrl);
+
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,getResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString),
+                     this, QNSLOT(ResourceDataDownloader,onGetResourceAsyncFinished,qint32,qevercloud::Resource,qint32,ErrorString));
+
+    m_noteStoresByUrl[noteStoreUrl] = pNoteStore;
+    return pNoteStore;
+}
+
+void ResourceDataDownloader::reportFailure(const QString & resourceGuid, const ErrorString & errorDescription)
+{
+    QNWARNING(QStringLiteral("Failed to download the data of resource with guid ") << resourceGuid
+              << QStringLiteral(": ") << errorDescription);
+
+    Resource resource;
+    auto it = m_resourcesByGuid.find(resourceGuid);
+    if (it != m_resourcesByGuid.end()) {
+        resource = it.value();
+        Q_UNUSED(m_resourcesByGuid.erase(it))
+    }
+
+    QList<QUuid> requestIds = m_requestIdsByResourceGuid.values(resourceGuid);
+    Q_UNUSED(m_requestIdsByResourceGuid.remove(resourceGuid))
+
+    for(auto rit = requestIds.constBegin(), rend = requestIds.constEnd(); rit != rend; ++rit) {
+        Q_EMIT failed(resource, errorDescription, *rit);
+    }
+}
+
+} // namespace quentier
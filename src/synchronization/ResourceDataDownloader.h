@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_RESOURCE_DATA_DOWNLOADER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_RESOURCE_DATA_DOWNLOADER_H
+
+#include <quentier/types/Resource.h>
+#include <quentier/types/ErrorString.h>
+#include <QObject>
+#include <QHash>
+#include <QMultiHash>
+#include <QUuid>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
+QT_FORWARD_DECLARE_CLASS(INoteStore)
+
+/**
+ * @brief The ResourceDataDownloader class downloads the binary data of resources which were synchronized
+ * without it and puts the downloaded data into the local storage
+ *
+ * The downloader uses its own note stores rather than the ones used by the synchronization so that
+ * the on-demand downloads can run both during the synchronization and between the synchronizations;
+ * these note stores are created from the note store passed to the constructor.
+ * Several requests to download the data of the same resource are served by a single download.
+ */
+class Q_DECL_HIDDEN ResourceDataDownloader: public QObject
+{
+    Q_OBJECT
+public:
+    explicit ResourceDataDownloader(LocalStorageManagerAsync & localStorageManagerAsync, INoteStore & noteStore,
+                                    QObject * parent = Q_NULLPTR);
+
+    /**
+     * @brief download - starts downloading the binary data of the resource from the note store with the given URL;
+     * the outcome is reported via either finished or failed signal with the same request id
+     * @param resource - the resource from the local storage, must have both local uid and guid set
+     */
+    void download(const Resource & resource, const QString & noteStoreUrl, const QString & authToken, const QUuid & requestId);
+
+    /**
+     * @brief stop - stops waiting for the downloads in progress, their results won't be reported
+     */
+    void stop();
+
+Q_SIGNALS:
+    void finished(Resource resource, QUuid requestId);
+    void failed(Resource resource, ErrorString errorDescription, QUuid requestId);
+
+// private signals
+    void updateResource(Resource resource, QUuid requestId);
+
+private Q_SLOTS:
+    void onGetResourceAsyncFinished(qint32 errorCode, qevercloud::Resource qecResource, qint32 rateLimitSeconds,
+                                    ErrorString errorDescription);
+    void onUpdateResourceComplete(Resource resource, QUuid requestId);
+    void onUpdateResourceFailed(Resource resource, ErrorString errorDescription, QUuid requestId);
+
+private:
+    void connectToLocalStorage();
+    INoteStore * noteStoreForUrl(const QString & noteStoreUrl);
+    void reportFailure(const QString & resourceGuid, const ErrorString & errorDescription);
+
+private:
+    Q_DISABLE_COPY(ResourceDataDownloader)
+
+private:
+    LocalStorageManagerAsync &      m_localStorageManagerAsync;
+    INoteStore &                    m_noteStore;
+    bool                            m_connectedToLocalStorage;
+
+    QHash<QString,INoteStore*>      m_noteStoresByUrl;
+
+    // The local resources which data is being downloaded or put into the local storage along with
+    // the ids of all the requests to download their data
+    QHash<QString,Resource>         m_resourcesByGuid;
+    QMultiHash<QString,QUuid>       m_requestIdsByResourceGuid;
+    QHash<QUuid,QString>            m_resourceGuidsByUpdateResourceRequestId;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_RESOURCE_DATA_DOWNLOADER_H
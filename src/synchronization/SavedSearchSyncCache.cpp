@@ -30,7 +30,7 @@ SavedSearchSyncCache::SavedSearchSyncCache(LocalStorageManagerAsync & localStora
     m_savedSearchGuidByName(),
     m_dirtySavedSearchesByGuid(),
     m_listSavedSearchesRequestId(),
-    m_limit(50),
+    m_limit(0),
     m_offset(0)
 {}
 
@@ -96,7 +96,7 @@ void SavedSearchSyncCache::onListSavedSearchesComplete(LocalStorageManager::List
 
     m_listSavedSearchesRequestId = QUuid();
 
-    if (foundSearches.size() == static_cast<int>(limit)) {
+    if ((limit != 0) && (foundSearches.size() == static_cast<int>(limit))) {
         QNTRACE(QStringLiteral("The number of found saved searches matches the limit, requesting more saved searches "
                                "from the local storage"));
         m_offset += limit;
@@ -160,6 +160,32 @@ void SavedSearchSyncCache::onExpungeSavedSearchComplete(SavedSearch search, QUui
     removeSavedSearch(search.localUid());
 }
 
+void SavedSearchSyncCache::onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                                           QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                                           QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                                           QUuid requestId)
+{
+    if (!linkedNotebookGuid.isEmpty()) {
+        return;
+    }
+
+    Q_UNUSED(syncedNotebookGuids)
+    Q_UNUSED(syncedTagGuids)
+    Q_UNUSED(syncedNoteGuids)
+    Q_UNUSED(syncedSavedSearchGuids)
+
+    QNDEBUG(QStringLiteral("SavedSearchSyncCache::onExpungeStaleDataItemsComplete: request id = ")
+            << requestId << QStringLiteral(", result: ") << result);
+
+    for(auto it = result.expungedSavedSearchLocalUids.constBegin(), end = result.expungedSavedSearchLocalUids.constEnd(); it != end; ++it) {
+        removeSavedSearch(*it);
+    }
+
+    for(auto it = result.detachedSavedSearchLocalUids.constBegin(), end = result.detachedSavedSearchLocalUids.constEnd(); it != end; ++it) {
+        detachSavedSearch(*it);
+    }
+}
+
 void SavedSearchSyncCache::connectToLocalStorage()
 {
     QNDEBUG(QStringLiteral("SavedSearchSyncCache::connectToLocalStorage"));
@@ -212,6 +238,11 @@ void SavedSearchSyncCache::connectToLocalStorage()
                      this, QNSLOT(SavedSearchSyncCache,onUpdateSavedSearchComplete,SavedSearch,QUuid));
     QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeSavedSearchComplete,SavedSearch,QUuid),
                      this, QNSLOT(SavedSearchSyncCache,onExpungeSavedSearchComplete,SavedSearch,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                           QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                           QString,StaleDataItemsExpungeResult,QUuid),
+                     this, QNSLOT(SavedSearchSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                  QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = true;
 }
@@ -268,6 +299,11 @@ void SavedSearchSyncCache::disconnectFromLocalStorage()
                         this, QNSLOT(SavedSearchSyncCache,onUpdateSavedSearchComplete,SavedSearch,QUuid));
     QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeSavedSearchComplete,SavedSearch,QUuid),
                         this, QNSLOT(SavedSearchSyncCache,onExpungeSavedSearchComplete,SavedSearch,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                              QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                              QString,StaleDataItemsExpungeResult,QUuid),
+                        this, QNSLOT(SavedSearchSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                     QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = false;
 }
@@ -300,14 +336,14 @@ void SavedSearchSyncCache::removeSavedSearch(const QString & savedSearchLocalUid
     QString name = localUidIt.value();
     Q_UNUSED(m_savedSearchNameByLocalUid.erase(localUidIt))
 
-    auto guidIt = m_savedSearchNameByGuid.find(name);
-    if (Q_UNLIKELY(guidIt == m_savedSearchNameByGuid.end())) {
+    auto guidIt = m_savedSearchGuidByName.find(name);
+    if (Q_UNLIKELY(guidIt == m_savedSearchGuidByName.end())) {
         QNDEBUG(QStringLiteral("The saved search guid was not found in the cache by name"));
         return;
     }
 
     QString guid = guidIt.value();
-    Q_UNUSED(m_savedSearchNameByGuid.erase(guidIt))
+    Q_UNUSED(m_savedSearchGuidByName.erase(guidIt))
 
     auto dirtySavedSearchIt = m_dirtySavedSearchesByGuid.find(guid);
     if (dirtySavedSearchIt != m_dirtySavedSearchesByGuid.end()) {
@@ -323,6 +359,22 @@ void SavedSearchSyncCache::removeSavedSearch(const QString & savedSearchLocalUid
     Q_UNUSED(m_savedSearchNameByGuid.erase(nameIt))
 }
 
+void SavedSearchSyncCache::detachSavedSearch(const QString & savedSearchLocalUid)
+{
+    QNDEBUG(QStringLiteral("SavedSearchSyncCache::detachSavedSearch: local uid = ") << savedSearchLocalUid);
+
+    // The detached saved search stays within the local storage under the same name but loses its guid
+    auto localUidIt = m_savedSearchNameByLocalUid.find(savedSearchLocalUid);
+    if (localUidIt == m_savedSearchNameByLocalUid.end()) {
+        QNDEBUG(QStringLiteral("The saved search name was not found in the cache by local uid"));
+        return;
+    }
+
+    QString name = localUidIt.value();
+    removeSavedSearch(savedSearchLocalUid);
+    m_savedSearchNameByLocalUid[savedSearchLocalUid] = name;
+}
+
 void SavedSearchSyncCache::processSavedSearch(const SavedSearch & search)
 {
     QNDEBUG(QStringLiteral("SavedSearchSyncCache::processSavedSearch: ") << search);
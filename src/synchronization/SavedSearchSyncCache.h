@@ -22,6 +22,7 @@
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <QObject>
 #include <QHash>
+#include <QSet>
 #include <QUuid>
 
 namespace quentier {
@@ -79,6 +80,10 @@ private Q_SLOTS:
     void onAddSavedSearchComplete(SavedSearch search, QUuid requestId);
     void onUpdateSavedSearchComplete(SavedSearch search, QUuid requestId);
     void onExpungeSavedSearchComplete(SavedSearch search, QUuid requestId);
+    void onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                         QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                         QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                         QUuid requestId);
 
 private:
     void connectToLocalStorage();
@@ -87,6 +92,7 @@ private:
     void requestSavedSearchesList();
 
     void removeSavedSearch(const QString & savedSearchLocalUid);
+    void detachSavedSearch(const QString & savedSearchLocalUid);
     void processSavedSearch(const SavedSearch & search);
 
 private:
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SelectiveSyncFilter.h"
+
+namespace quentier {
+
+SelectiveSyncFilter::SelectiveSyncFilter() :
+    m_notebookGuids(),
+    m_tagGuids()
+{}
+
+SelectiveSyncFilter::SelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids) :
+    m_notebookGuids(),
+    m_tagGuids()
+{
+    for(auto it = notebookGuids.constBegin(), end = notebookGuids.constEnd(); it != end; ++it)
+    {
+        if (!it->isEmpty()) {
+            Q_UNUSED(m_notebookGuids.insert(*it))
+        }
+    }
+
+    for(auto it = tagGuids.constBegin(), end = tagGuids.constEnd(); it != end; ++it)
+    {
+        if (!it->isEmpty()) {
+            Q_UNUSED(m_tagGuids.insert(*it))
+        }
+    }
+}
+
+bool SelectiveSyncFilter::isEmpty() const
+{
+    return m_notebookGuids.isEmpty() && m_tagGuids.isEmpty();
+}
+
+QStringList SelectiveSyncFilter::notebookGuids() const
+{
+    QStringList guids = m_notebookGuids.toList();
+    guids.sort();
+    return guids;
+}
+
+QStringList SelectiveSyncFilter::tagGuids() const
+{
+    QStringList guids = m_tagGuids.toList();
+    guids.sort();
+    return guids;
+}
+
+bool SelectiveSyncFilter::matchesNote(const qevercloud::Note & note) const
+{
+    if (isEmpty()) {
+        return true;
+    }
+
+    if (note.notebookGuid.isSet() && m_notebookGuids.contains(note.notebookGuid.ref())) {
+        return true;
+    }
+
+    if (note.tagGuids.isSet())
+    {
+        const QStringList & noteTagGuids = note.tagGuids.ref();
+        for(auto it = noteTagGuids.constBegin(), end = noteTagGuids.constEnd(); it != end; ++it)
+        {
+            if (m_tagGuids.contains(*it)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool SelectiveSyncFilter::selectsMoreThan(const SelectiveSyncFilter & other) const
+{
+    if (other.isEmpty()) {
+        return false;
+    }
+
+    if (isEmpty()) {
+        return true;
+    }
+
+    return !other.m_notebookGuids.contains(m_notebookGuids) || !other.m_tagGuids.contains(m_tagGuids);
+}
+
+bool SelectiveSyncFilter::operator==(const SelectiveSyncFilter & other) const
+{
+    return (m_notebookGuids == other.m_notebookGuids) && (m_tagGuids == other.m_tagGuids);
+}
+
+bool SelectiveSyncFilter::operator!=(const SelectiveSyncFilter & other) const
+{
+    return !(*this == other);
+}
+
+QTextStream & SelectiveSyncFilter::print(QTextStream & strm) const
+{
+    if (isEmpty()) {
+        strm << QStringLiteral("SelectiveSyncFilter: all notes");
+        return strm;
+    }
+
+    strm << QStringLiteral("SelectiveSyncFilter: notebook guids = ") << notebookGuids().join(QStringLiteral(", "))
+         << QStringLiteral("; tag guids = ") << tagGuids().join(QStringLiteral(", "));
+    return strm;
+}
+
+} // namespace quentier
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SELECTIVE_SYNC_FILTER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SELECTIVE_SYNC_FILTER_H
+
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+#include <QStringList>
+#include <QSet>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+namespace quentier {
+
+/**
+ * @brief The SelectiveSyncFilter class describes the subset of notes which should be downloaded during
+ * the synchronization: the note is selected if it belongs to one of the chosen notebooks or is labeled
+ * with at least one of the chosen tags. The filter without any chosen notebooks and tags selects all notes.
+ *
+ * The filter only concerns notes and their resources: notebooks, tags, saved searches and linked notebooks
+ * are lightweight and are always synchronized in full.
+ */
+class Q_DECL_HIDDEN SelectiveSyncFilter: public Printable
+{
+public:
+    SelectiveSyncFilter();
+    SelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids);
+
+    /**
+     * @return true if the filter selects all notes, false otherwise
+     */
+    bool isEmpty() const;
+
+    QStringList notebookGuids() const;
+    QStringList tagGuids() const;
+
+    bool matchesNote(const qevercloud::Note & note) const;
+
+    /**
+     * @return true if this filter might select some notes not selected by the other filter: such notes
+     * were skipped by the previous synchronizations performed with the other filter and need to be downloaded
+     * regardless of their update sequence numbers
+     */
+    bool selectsMoreThan(const SelectiveSyncFilter & other) const;
+
+    bool operator==(const SelectiveSyncFilter & other) const;
+    bool operator!=(const SelectiveSyncFilter & other) const;
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+private:
+    QSet<QString>   m_notebookGuids;
+    QSet<QString>   m_tagGuids;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SELECTIVE_SYNC_FILTER_H
@@ -24,6 +24,12 @@
 #include <quentier/logging/QuentierLogger.h>
 #include <QTimerEvent>
 
+// The max number of data items being sent to the service at the same time
+#define MAX_DATA_ITEMS_IN_FLIGHT (5)
+
+// The max number of sent notes for which the dirty flag is removed within the local storage at once
+#define MAX_NOTES_PER_DIRTY_FLAG_REMOVING_UPDATE (20)
+
 #define APPEND_NOTE_DETAILS(errorDescription, note) \
    if (note.hasTitle()) \
    { \
@@ -62,6 +68,15 @@ SendLocalChangesManager::SendLocalChangesManager(IManager & manager, QObject * p
     m_savedSearches(),
     m_notebooks(),
     m_notes(),
+    m_tagsInFlightBySendRequestId(),
+    m_savedSearchesInFlightBySendRequestId(),
+    m_notebooksInFlightBySendRequestId(),
+    m_notesInFlightBySendRequestId(),
+    m_pendingSentUsnsByLinkedNotebookGuid(),
+    m_tagGuidsByLocalUid(),
+    m_notebookGuidsByLocalUid(),
+    m_notesPreparedForSending(false),
+    m_notesPendingDirtyFlagRemoval(),
     m_linkedNotebookGuidsForWhichStuffWasRequestedFromLocalStorage(),
     m_linkedNotebookAuthData(),
     m_authenticationTokensAndShardIdsByLinkedNotebookGuid(),
@@ -70,13 +85,11 @@ SendLocalChangesManager::SendLocalChangesManager(IManager & manager, QObject * p
     m_updateTagRequestIds(),
     m_updateSavedSearchRequestIds(),
     m_updateNotebookRequestIds(),
-    m_updateNoteRequestIds(),
+    m_updateNotesRequestIds(),
     m_findNotebookRequestIds(),
+    m_listResourceSyncedDataHashesRequestId(),
     m_notebooksByGuidsCache(),
-    m_sendTagsPostponeTimerId(0),
-    m_sendSavedSearchesPostponeTimerId(0),
-    m_sendNotebooksPostponeTimerId(0),
-    m_sendNotesPostponeTimerId(0)
+    m_sendDataItemsPostponeTimerId(0)
 {}
 
 bool SendLocalChangesManager::active() const
@@ -107,6 +120,9 @@ void SendLocalChangesManager::stop()
         return;
     }
 
+    // The notes already sent to the service must not lose the guids and update sequence numbers they've got from it
+    flushNotesPendingDirtyFlagRemoval();
+
     clear();
 
     m_active = false;
@@ -568,40 +584,41 @@ void SendLocalChangesManager::onUpdateNotebookFailed(Notebook notebook, ErrorStr
     Q_EMIT failure(error);
 }
 
-void SendLocalChangesManager::onUpdateNoteCompleted(Note note, bool updateResources, bool updateTags, QUuid requestId)
+void SendLocalChangesManager::onUpdateNotesCompleted(QList<Note> notes, bool updateResources, bool updateTags, QUuid requestId)
 {
     Q_UNUSED(updateResources)
     Q_UNUSED(updateTags)
 
-    auto it = m_updateNoteRequestIds.find(requestId);
-    if (it == m_updateNoteRequestIds.end()) {
+    auto it = m_updateNotesRequestIds.find(requestId);
+    if (it == m_updateNotesRequestIds.end()) {
         return;
     }
 
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::onUpdateNoteCompleted: note = ") << note << QStringLiteral("\nRequest id = ") << requestId);
-    Q_UNUSED(m_updateNoteRequestIds.erase(it));
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onUpdateNotesCompleted: ") << notes.size()
+            << QStringLiteral(" notes, request id = ") << requestId);
+    Q_UNUSED(m_updateNotesRequestIds.erase(it));
 
     checkSendLocalChangesAndDirtyFlagsRemovingUpdatesAndFinalize();
 }
 
-void SendLocalChangesManager::onUpdateNoteFailed(Note note, bool updateResources, bool updateTags,
-                                                 ErrorString errorDescription, QUuid requestId)
+void SendLocalChangesManager::onUpdateNotesFailed(QList<Note> notes, bool updateResources, bool updateTags,
+                                                  ErrorString errorDescription, QUuid requestId)
 {
     Q_UNUSED(updateResources)
     Q_UNUSED(updateTags)
 
-    auto it = m_updateNoteRequestIds.find(requestId);
-    if (it == m_updateNoteRequestIds.end()) {
+    auto it = m_updateNotesRequestIds.find(requestId);
+    if (it == m_updateNotesRequestIds.end()) {
         return;
     }
 
-    Q_UNUSED(m_updateNoteRequestIds.erase(it));
+    Q_UNUSED(m_updateNotesRequestIds.erase(it));
 
-    ErrorString error(QT_TR_NOOP("Failed to update a note in the local storage"));
+    ErrorString error(QT_TR_NOOP("Failed to update notes in the local storage"));
     error.additionalBases().append(errorDescription.base());
     error.additionalBases().append(errorDescription.additionalBases());
     error.details() = errorDescription.details();
-    QNWARNING(error << QStringLiteral("; note: ") << note);
+    QNWARNING(error << QStringLiteral("; ") << notes.size() << QStringLiteral(" notes"));
     Q_EMIT failure(error);
 }
 
@@ -632,7 +649,7 @@ void SendLocalChangesManager::onFindNotebookCompleted(Notebook notebook, QUuid r
     Q_UNUSED(m_findNotebookRequestIds.erase(it));
 
     if (m_findNotebookRequestIds.isEmpty()) {
-        checkAndSendNotes();
+        sendDataItems();
     }
 }
 
@@ -649,6 +666,81 @@ void SendLocalChangesManager::onFindNotebookFailed(Notebook notebook, ErrorStrin
     Q_EMIT failure(errorDescription);
 }
 
+void SendLocalChangesManager::onListResourceSyncedDataHashesCompleted(QStringList noteLocalUids,
+                                                                      QHash<QString,QByteArray> dataHashesByResourceLocalUid,
+                                                                      QUuid requestId)
+{
+    if (requestId != m_listResourceSyncedDataHashesRequestId) {
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onListResourceSyncedDataHashesCompleted: ") << noteLocalUids.size()
+            << QStringLiteral(" note local uids, ") << dataHashesByResourceLocalUid.size()
+            << QStringLiteral(" synchronized data hashes, request id = ") << requestId);
+
+    m_listResourceSyncedDataHashesRequestId = QUuid();
+
+    // The service keeps the data of the resource if the resource is sent without the data body but with the same
+    // data hash, so there's no need to upload the data which hasn't changed since the last sync
+    int numStrippedResources = 0;
+    qint64 numStrippedBytes = 0;
+
+    for(auto it = m_notes.begin(), end = m_notes.end(); it != end; ++it)
+    {
+        Note & note = *it;
+        if (!note.hasResources()) {
+            continue;
+        }
+
+        QList<Resource> resources = note.resources();
+        bool strippedAnyResource = false;
+
+        for(auto rit = resources.begin(), rend = resources.end(); rit != rend; ++rit)
+        {
+            Resource & resource = *rit;
+            if (!resource.hasGuid() || !resource.hasDataBody() || !resource.hasDataHash()) {
+                continue;
+            }
+
+            auto hit = dataHashesByResourceLocalUid.find(resource.localUid());
+            if ((hit == dataHashesByResourceLocalUid.end()) || (hit.value() != resource.dataHash())) {
+                continue;
+            }
+
+            numStrippedBytes += resource.dataBody().size();
+            ++numStrippedResources;
+
+            resource.setDataBody(QByteArray());
+            strippedAnyResource = true;
+        }
+
+        if (strippedAnyResource) {
+            note.setResources(resources);
+        }
+    }
+
+    QNDEBUG(QStringLiteral("Won't upload the data of ") << numStrippedResources
+            << QStringLiteral(" resources which haven't changed since the last sync, ") << numStrippedBytes
+            << QStringLiteral(" bytes in total"));
+
+    sendLocalChanges();
+}
+
+void SendLocalChangesManager::onListResourceSyncedDataHashesFailed(QStringList noteLocalUids, ErrorString errorDescription,
+                                                                   QUuid requestId)
+{
+    if (requestId != m_listResourceSyncedDataHashesRequestId) {
+        return;
+    }
+
+    QNWARNING(QStringLiteral("SendLocalChangesManager::onListResourceSyncedDataHashesFailed: ") << errorDescription
+              << QStringLiteral(", ") << noteLocalUids.size() << QStringLiteral(" note local uids, request id = ") << requestId
+              << QStringLiteral("; will send the resources of notes along with all their data"));
+
+    m_listResourceSyncedDataHashesRequestId = QUuid();
+    sendLocalChanges();
+}
+
 void SendLocalChangesManager::timerEvent(QTimerEvent * pEvent)
 {
     QNDEBUG(QStringLiteral("SendLocalChangesManager::timerEvent"));
@@ -664,25 +756,9 @@ void SendLocalChangesManager::timerEvent(QTimerEvent * pEvent)
     killTimer(timerId);
     QNDEBUG(QStringLiteral("Killed timer with id ") << timerId);
 
-    if (timerId == m_sendTagsPostponeTimerId)
-    {
-        m_sendTagsPostponeTimerId = 0;
-        sendTags();
-    }
-    else if (timerId == m_sendSavedSearchesPostponeTimerId)
-    {
-        m_sendSavedSearchesPostponeTimerId = 0;
-        sendSavedSearches();
-    }
-    else if (timerId == m_sendNotebooksPostponeTimerId)
-    {
-        m_sendNotebooksPostponeTimerId = 0;
-        sendNotebooks();
-    }
-    else if (timerId == m_sendNotesPostponeTimerId)
-    {
-        m_sendNotesPostponeTimerId = 0;
-        checkAndSendNotes();
+    if (timerId == m_sendDataItemsPostponeTimerId) {
+        m_sendDataItemsPostponeTimerId = 0;
+        sendDataItems();
     }
 }
 
@@ -739,12 +815,15 @@ void SendLocalChangesManager::connectToLocalStorage()
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateSavedSearchRequest,SavedSearch,QUuid));
     QObject::connect(this, QNSIGNAL(SendLocalChangesManager,updateNotebook,Notebook,QUuid),
                      &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNotebookRequest,Notebook,QUuid));
-    QObject::connect(this, QNSIGNAL(SendLocalChangesManager,updateNote,Note,bool,bool,QUuid),
-                     &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNoteRequest,Note,bool,bool,QUuid));
+    QObject::connect(this, QNSIGNAL(SendLocalChangesManager,updateNotes,QList<Note>,bool,bool,QUuid),
+                     &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNotesRequest,QList<Note>,bool,bool,QUuid));
 
     QObject::connect(this, QNSIGNAL(SendLocalChangesManager,findNotebook,Notebook,QUuid), &localStorageManagerAsync,
                      QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
 
+    QObject::connect(this, QNSIGNAL(SendLocalChangesManager,requestResourceSyncedDataHashes,QStringList,QUuid), &localStorageManagerAsync,
+                     QNSLOT(LocalStorageManagerAsync,onListResourceSyncedDataHashesRequest,QStringList,QUuid));
+
     // Connect localStorageManagerThread's signals to local slots
     QObject::connect(&localStorageManagerAsync,
                      QNSIGNAL(LocalStorageManagerAsync,listTagsComplete,LocalStorageManager::ListObjectsOptions,size_t,size_t,
@@ -828,14 +907,19 @@ void SendLocalChangesManager::connectToLocalStorage()
                      this, QNSLOT(SendLocalChangesManager,onUpdateNotebookCompleted,Notebook,QUuid));
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotebookFailed,Notebook,ErrorString,QUuid),
                      this, QNSLOT(SendLocalChangesManager,onUpdateNotebookFailed,Notebook,ErrorString,QUuid));
-    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNoteComplete,Note,bool,bool,QUuid),
-                     this, QNSLOT(SendLocalChangesManager,onUpdateNoteCompleted,Note,bool,bool,QUuid));
-    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNoteFailed,Note,bool,bool,ErrorString,QUuid),
-                     this, QNSLOT(SendLocalChangesManager,onUpdateNoteFailed,Note,bool,bool,ErrorString,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotesComplete,QList<Note>,bool,bool,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateNotesCompleted,QList<Note>,bool,bool,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotesFailed,QList<Note>,bool,bool,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateNotesFailed,QList<Note>,bool,bool,ErrorString,QUuid));
 
     QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNotebookComplete,Notebook,QUuid),
                      this, QNSLOT(SendLocalChangesManager,onFindNotebookCompleted,Notebook,QUuid));
 
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,listResourceSyncedDataHashesComplete,QStringList,QHash<QString,QByteArray>,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onListResourceSyncedDataHashesCompleted,QStringList,QHash<QString,QByteArray>,QUuid));
+    QObject::connect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,listResourceSyncedDataHashesFailed,QStringList,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onListResourceSyncedDataHashesFailed,QStringList,ErrorString,QUuid));
+
     m_connectedToLocalStorage = true;
 }
 
@@ -892,12 +976,15 @@ void SendLocalChangesManager::disconnectFromLocalStorage()
                         QNSLOT(LocalStorageManagerAsync,onUpdateSavedSearchRequest,SavedSearch,QUuid));
     QObject::disconnect(this, QNSIGNAL(SendLocalChangesManager,updateNotebook,Notebook,QUuid), &localStorageManagerAsync,
                         QNSLOT(LocalStorageManagerAsync,onUpdateNotebookRequest,Notebook,QUuid));
-    QObject::disconnect(this, QNSIGNAL(SendLocalChangesManager,updateNote,Note,bool,bool,QUuid),
-                        &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNoteRequest,Note,bool,bool,QUuid));
+    QObject::disconnect(this, QNSIGNAL(SendLocalChangesManager,updateNotes,QList<Note>,bool,bool,QUuid),
+                        &localStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onUpdateNotesRequest,QList<Note>,bool,bool,QUuid));
 
     QObject::disconnect(this, QNSIGNAL(SendLocalChangesManager,findNotebook,Notebook,QUuid), &localStorageManagerAsync,
                         QNSLOT(LocalStorageManagerAsync,onFindNotebookRequest,Notebook,QUuid));
 
+    QObject::disconnect(this, QNSIGNAL(SendLocalChangesManager,requestResourceSyncedDataHashes,QStringList,QUuid), &localStorageManagerAsync,
+                        QNSLOT(LocalStorageManagerAsync,onListResourceSyncedDataHashesRequest,QStringList,QUuid));
+
     // Disconnect localStorageManagerThread's signals from local slots
     QObject::disconnect(&localStorageManagerAsync,
                         QNSIGNAL(LocalStorageManagerAsync,listTagsComplete,LocalStorageManager::ListObjectsOptions,size_t,size_t,
@@ -981,16 +1068,21 @@ void SendLocalChangesManager::disconnectFromLocalStorage()
                         this, QNSLOT(SendLocalChangesManager,onUpdateNotebookCompleted,Notebook,QUuid));
     QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotebookFailed,Notebook,ErrorString,QUuid),
                         this, QNSLOT(SendLocalChangesManager,onUpdateNotebookFailed,Notebook,ErrorString,QUuid));
-    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNoteComplete,Note,bool,bool,QUuid),
-                        this, QNSLOT(SendLocalChangesManager,onUpdateNoteCompleted,Note,bool,bool,QUuid));
-    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNoteFailed,Note,bool,bool,ErrorString,QUuid),
-                        this, QNSLOT(SendLocalChangesManager,onUpdateNoteFailed,Note,bool,bool,ErrorString,QUuid));
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotesComplete,QList<Note>,bool,bool,QUuid),
+                        this, QNSLOT(SendLocalChangesManager,onUpdateNotesCompleted,QList<Note>,bool,bool,QUuid));
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateNotesFailed,QList<Note>,bool,bool,ErrorString,QUuid),
+                        this, QNSLOT(SendLocalChangesManager,onUpdateNotesFailed,QList<Note>,bool,bool,ErrorString,QUuid));
 
     QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNotebookComplete,Notebook,QUuid),
                         this, QNSLOT(SendLocalChangesManager,onFindNotebookCompleted,Notebook,QUuid));
     QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findNotebookFailed,Notebook,ErrorString,QUuid),
                         this, QNSLOT(SendLocalChangesManager,onFindNotebookFailed,Notebook,ErrorString,QUuid));
 
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,listResourceSyncedDataHashesComplete,QStringList,QHash<QString,QByteArray>,QUuid),
+                        this, QNSLOT(SendLocalChangesManager,onListResourceSyncedDataHashesCompleted,QStringList,QHash<QString,QByteArray>,QUuid));
+    QObject::disconnect(&localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,listResourceSyncedDataHashesFailed,QStringList,ErrorString,QUuid),
+                        this, QNSLOT(SendLocalChangesManager,onListResourceSyncedDataHashesFailed,QStringList,ErrorString,QUuid));
+
     m_connectedToLocalStorage = false;
 }
 
@@ -1159,7 +1251,7 @@ void SendLocalChangesManager::checkListLocalStorageObjectsCompletion()
     Q_EMIT receivedAllDirtyObjects();
 
     if (!m_tags.isEmpty() || !m_savedSearches.isEmpty() || !m_notebooks.isEmpty() || !m_notes.isEmpty()) {
-        sendLocalChanges();
+        checkResourceSyncedDataHashesAndSendLocalChanges();
     }
     else {
         QNINFO(QStringLiteral("No modified or new synchronizable objects were found in the local storage, nothing to send to Evernote service"));
@@ -1167,35 +1259,49 @@ void SendLocalChangesManager::checkListLocalStorageObjectsCompletion()
     }
 }
 
-void SendLocalChangesManager::sendLocalChanges()
+void SendLocalChangesManager::checkResourceSyncedDataHashesAndSendLocalChanges()
 {
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendLocalChanges"));
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::checkResourceSyncedDataHashesAndSendLocalChanges"));
 
-    if (!checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
-        return;
-    }
+    QStringList noteLocalUids;
+    for(auto it = m_notes.constBegin(), end = m_notes.constEnd(); it != end; ++it)
+    {
+        const Note & note = *it;
+        if (!note.hasResources()) {
+            continue;
+        }
 
-#define CHECK_RATE_LIMIT() \
-    if (rateLimitIsActive()) { \
-        return; \
+        // Only the resources which already exist within the service might not need their data uploaded
+        QList<Resource> resources = note.resources();
+        for(auto rit = resources.constBegin(), rend = resources.constEnd(); rit != rend; ++rit)
+        {
+            if (rit->hasGuid() && rit->hasDataBody()) {
+                noteLocalUids << note.localUid();
+                break;
+            }
+        }
     }
 
-    sendTags();
-    CHECK_RATE_LIMIT()
-
-    sendSavedSearches();
-    CHECK_RATE_LIMIT()
-
-    sendNotebooks();
-    CHECK_RATE_LIMIT()
+    if (noteLocalUids.isEmpty()) {
+        sendLocalChanges();
+        return;
+    }
 
-    findNotebooksForNotes();
+    m_listResourceSyncedDataHashesRequestId = QUuid::createUuid();
+    QNTRACE(QStringLiteral("Emitting the request to list synchronized resource data hashes for ") << noteLocalUids.size()
+            << QStringLiteral(" notes, request id = ") << m_listResourceSyncedDataHashesRequestId);
+    Q_EMIT requestResourceSyncedDataHashes(noteLocalUids, m_listResourceSyncedDataHashesRequestId);
 }
 
-void SendLocalChangesManager::sendTags()
+void SendLocalChangesManager::sendLocalChanges()
 {
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendTags"));
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendLocalChanges"));
+
+    if (!checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
+        return;
+    }
 
+    // NOTE: parent tags need to be sent before their children so that the children could refer to their guids
     ErrorString errorDescription;
     bool res = sortTagsByParentChildRelations(m_tags, errorDescription);
     if (Q_UNLIKELY(!res)) {
@@ -1204,940 +1310,951 @@ void SendLocalChangesManager::sendTags()
         return;
     }
 
-    QHash<QString, QString> tagGuidsByLocalUid;
-    tagGuidsByLocalUid.reserve(m_tags.size());
-
-    for(auto it = m_tags.begin(); it != m_tags.end(); )
-    {
-        Tag & tag = *it;
-
-        errorDescription.clear();
-        qint32 rateLimitSeconds = 0;
-        qint32 errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
-
-        QString linkedNotebookAuthToken;
-        QString linkedNotebookShardId;
-        QString linkedNotebookNoteStoreUrl;
+    sendDataItems();
+}
 
-        if (tag.hasLinkedNotebookGuid())
-        {
-            auto cit = m_authenticationTokensAndShardIdsByLinkedNotebookGuid.find(tag.linkedNotebookGuid());
-            if (cit != m_authenticationTokensAndShardIdsByLinkedNotebookGuid.end())
-            {
-                linkedNotebookAuthToken = cit.value().first;
-                linkedNotebookShardId = cit.value().second;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the authentication token "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a tag from it"));
-                if (tag.hasName()) {
-                    errorDescription.details() = tag.name();
-                }
+void SendLocalChangesManager::sendDataItems()
+{
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendDataItems: ") << m_tags.size() << QStringLiteral(" tags, ")
+            << m_savedSearches.size() << QStringLiteral(" saved searches, ") << m_notebooks.size()
+            << QStringLiteral(" notebooks, ") << m_notes.size() << QStringLiteral(" notes queued, ")
+            << numDataItemsInFlight() << QStringLiteral(" data items in flight"));
 
-                QNWARNING(errorDescription << QStringLiteral(", tag: ") << tag);
+    if (!m_active) {
+        QNDEBUG(QStringLiteral("Not active, won't send anything"));
+        return;
+    }
 
-                auto sit = std::find_if(m_linkedNotebookAuthData.begin(),
-                                        m_linkedNotebookAuthData.end(),
-                                        CompareLinkedNotebookAuthDataByGuid(tag.linkedNotebookGuid()));
-                if (sit == m_linkedNotebookAuthData.end()) {
-                    QNWARNING(QStringLiteral("The linked notebook the tag refers to was not found within the list of linked notebooks "
-                                             "received from local storage!"));
-                }
+    if (m_sendDataItemsPostponeTimerId > 0) {
+        QNDEBUG(QStringLiteral("Waiting for the rate limit to expire before sending more data items"));
+        return;
+    }
 
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    if (m_pendingAuthenticationTokensForLinkedNotebooks) {
+        QNDEBUG(QStringLiteral("Waiting for the authentication tokens for linked notebooks before sending more data items"));
+        return;
+    }
 
-            auto sit = std::find_if(m_linkedNotebookAuthData.begin(),
-                                    m_linkedNotebookAuthData.end(),
-                                    CompareLinkedNotebookAuthDataByGuid(tag.linkedNotebookGuid()));
-            if (sit != m_linkedNotebookAuthData.end())
-            {
-                linkedNotebookNoteStoreUrl = sit->m_noteStoreUrl;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the note store URL "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a tag from it"));
-                if (tag.hasName()) {
-                    errorDescription.details() = tag.name();
-                }
+    ErrorString errorDescription;
+    while(numDataItemsInFlight() < MAX_DATA_ITEMS_IN_FLIGHT)
+    {
+        errorDescription.clear();
 
+        int tagIndex = nextSendableTagIndex();
+        if (tagIndex >= 0)
+        {
+            Tag tag = m_tags.takeAt(tagIndex);
+            if (!sendTagAsync(tag, errorDescription)) {
                 QNWARNING(errorDescription << QStringLiteral(", tag: ") << tag);
-
                 Q_EMIT failure(errorDescription);
                 return;
             }
+
+            continue;
         }
 
-        NoteStore * pNoteStore = Q_NULLPTR;
-        if (tag.hasLinkedNotebookGuid())
+        if (!m_notebooks.isEmpty())
         {
-            LinkedNotebook linkedNotebook;
-            linkedNotebook.setGuid(tag.linkedNotebookGuid());
-            linkedNotebook.setShardId(linkedNotebookShardId);
-            linkedNotebook.setNoteStoreUrl(linkedNotebookNoteStoreUrl);
-            pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
-
-            if (Q_UNLIKELY(!pNoteStore)) {
-                errorDescription.setBase(QT_TR_NOOP("Can't send new or modified tag: can't find or create a note store for the linked notebook"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << tag.linkedNotebookGuid());
-                Q_EMIT failure(errorDescription);
-                return;
-            }
-
-            if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
-                ErrorString errorDescription(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << tag.linkedNotebookGuid());
+            Notebook notebook = m_notebooks.takeFirst();
+            if (!sendNotebookAsync(notebook, errorDescription)) {
+                QNWARNING(errorDescription << QStringLiteral(", notebook: ") << notebook);
                 Q_EMIT failure(errorDescription);
                 return;
             }
-        }
-        else
-        {
-            pNoteStore = &(m_manager.noteStore());
-        }
 
-        bool creatingTag = !tag.hasUpdateSequenceNumber();
-        if (creatingTag) {
-            QNTRACE(QStringLiteral("Sending new tag: ") << tag);
-            errorCode = pNoteStore->createTag(tag, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
-        }
-        else {
-            QNTRACE(QStringLiteral("Sending modified tag: ") << tag);
-            errorCode = pNoteStore->updateTag(tag, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
+            continue;
         }
 
-        if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+        if (!m_savedSearches.isEmpty())
         {
-            if (rateLimitSeconds <= 0) {
-                errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
-                errorDescription.details() = QString::number(rateLimitSeconds);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
-
-            int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-            if (Q_UNLIKELY(timerId == 0)) {
-                errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone "
-                                                    "the Evernote API call due to rate limit exceeding"));
+            SavedSearch search = m_savedSearches.takeFirst();
+            if (!sendSavedSearchAsync(search, errorDescription)) {
+                QNWARNING(errorDescription << QStringLiteral(", saved search: ") << search);
                 Q_EMIT failure(errorDescription);
                 return;
             }
 
-            m_sendTagsPostponeTimerId = timerId;
-            Q_EMIT rateLimitExceeded(rateLimitSeconds);
-            return;
+            continue;
         }
-        else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-        {
-            if (!tag.hasLinkedNotebookGuid())
-            {
-                handleAuthExpiration();
-            }
-            else
-            {
-                auto cit = m_authenticationTokenExpirationTimesByLinkedNotebookGuid.find(tag.linkedNotebookGuid());
-                if (cit == m_authenticationTokenExpirationTimesByLinkedNotebookGuid.end())
-                {
-                    errorDescription.setBase(QT_TR_NOOP("Couldn't find the expiration time of "
-                                                        "a linked notebook's authentication token"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << tag.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-                else if (checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
-                    errorDescription.setBase(QT_TR_NOOP("Unexpected AUTH_EXPIRED error: authentication "
-                                                        "tokens for all linked notebooks are still valid"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << tag.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-            }
 
-            return;
-        }
-        else if (errorCode == qevercloud::EDAMErrorCode::DATA_CONFLICT)
-        {
-            QNINFO(QStringLiteral("Encountered DATA_CONFLICT exception while trying to send new and/or modified tags, "
-                                  "it means the incremental sync should be repeated before sending the changes to the service"));
-            Q_EMIT conflictDetected();
-            stop();
-            return;
-        }
-        else if (errorCode != 0) {
-            ErrorString error(QT_TR_NOOP("Failed to send new and/or modified tags to Evernote service"));
-            error.additionalBases().append(errorDescription.base());
-            error.additionalBases().append(errorDescription.additionalBases());
-            error.details() = errorDescription.details();
-            Q_EMIT failure(error);
-            return;
+        if (m_notes.isEmpty()) {
+            break;
         }
 
-        QNDEBUG(QStringLiteral("Successfully sent the tag to Evernote"));
-
-        // Now the tag should have obtained guid, need to set this guid as parent tag guid
-        // for child tags
+        // Notes can only be sent after all the tags and notebooks they refer to have got their guids
+        if (!m_tags.isEmpty() || !m_tagsInFlightBySendRequestId.isEmpty() || !m_notebooksInFlightBySendRequestId.isEmpty()) {
+            break;
+        }
 
-        if (Q_UNLIKELY(!tag.hasGuid()))
-        {
-            ErrorString error(QT_TR_NOOP("The tag just sent to Evernote has no guid"));
-            if (tag.hasName()) {
-                error.details() = tag.name();
-            }
-            Q_EMIT failure(error);
+        if (!m_notesPreparedForSending && !prepareNotesForSending()) {
             return;
         }
 
-        auto nextTagIt = it;
-        ++nextTagIt;
-        for(auto nit = nextTagIt; nit != m_tags.end(); ++nit)
-        {
-            Tag & otherTag = *nit;
-            if (otherTag.hasParentLocalUid() && (otherTag.parentLocalUid() == tag.localUid())) {
-                otherTag.setParentGuid(tag.guid());
-            }
+        if (!m_findNotebookRequestIds.isEmpty()) {
+            QNDEBUG(QStringLiteral("Waiting for the notebooks of notes to be found within the local storage"));
+            break;
         }
 
-        tagGuidsByLocalUid[tag.localUid()] = tag.guid();
-
-        tag.setDirty(false);
-        QUuid updateTagRequestId = QUuid::createUuid();
-        Q_UNUSED(m_updateTagRequestIds.insert(updateTagRequestId))
-        QNTRACE(QStringLiteral("Emitting the request to update tag (remove dirty flag from it): request id = ")
-                << updateTagRequestId << QStringLiteral(", tag: ") << tag);
-        Q_EMIT updateTag(tag, updateTagRequestId);
-
-        if (!m_shouldRepeatIncrementalSync)
-        {
-            QNTRACE(QStringLiteral("Checking if we are still in sync with the remote service"));
-
-            if (!tag.hasUpdateSequenceNumber()) {
-                errorDescription.setBase(QT_TR_NOOP("Tag's update sequence number is not set "
-                                                    "after it being sent to the service"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+        Note note = m_notes.takeFirst();
+        if (!sendNoteAsync(note, errorDescription)) {
+            QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
+            Q_EMIT failure(errorDescription);
+            return;
+        }
+    }
 
-            int * pLastUpdateCount = Q_NULLPTR;
-            if (!tag.hasLinkedNotebookGuid())
-            {
-                pLastUpdateCount = &m_lastUpdateCount;
-                QNTRACE(QStringLiteral("Current tag does not belong to linked notebook"));
-            }
-            else
-            {
-                QNTRACE(QStringLiteral("Current tag belongs to linked notebook with guid ") << tag.linkedNotebookGuid());
-
-                auto lit = m_lastUpdateCountByLinkedNotebookGuid.find(tag.linkedNotebookGuid());
-                if (lit == m_lastUpdateCountByLinkedNotebookGuid.end()) {
-                    errorDescription.setBase(QT_TR_NOOP("Can't find the update count per linked "
-                                                        "notebook guid on attempt to check "
-                                                        "the update count of tag sent to Evernote service"));
-                    Q_EMIT failure(errorDescription);
-                    return;
-                }
+    if (hasDataItemsToSend()) {
+        QNDEBUG(QStringLiteral("Still sending data items: ") << (m_tags.size() + m_savedSearches.size() + m_notebooks.size() + m_notes.size())
+                << QStringLiteral(" queued, ") << numDataItemsInFlight() << QStringLiteral(" in flight"));
+        return;
+    }
 
-                pLastUpdateCount = &lit.value();
-            }
+    QNINFO(QStringLiteral("Sent all locally added/updated data items back to the Evernote service"));
 
-            if (tag.updateSequenceNumber() == *pLastUpdateCount + 1) {
-                *pLastUpdateCount = tag.updateSequenceNumber();
-                QNTRACE(QStringLiteral("The client is in sync with the service; updated corresponding last update count to ") << *pLastUpdateCount);
-            }
-            else {
-                m_shouldRepeatIncrementalSync = true;
-                Q_EMIT shouldRepeatIncrementalSync();
-                QNTRACE(QStringLiteral("The client is not in sync with the service"));
-            }
-        }
+    // NOTE: the only possibly still pending transactions are those removing dirty flags
+    // from sent objects within the local storage
+    checkDirtyFlagRemovingUpdatesAndFinalize();
+}
 
-        it = m_tags.erase(it);
+int SendLocalChangesManager::nextSendableTagIndex() const
+{
+    // The tags are sorted by parent-child relations but the child tag can't be sent until its parent
+    // has been sent and has got the guid; the tags coming after such child tag can still be sent
+    QSet<QString> pendingTagLocalUids;
+    for(auto it = m_tagsInFlightBySendRequestId.constBegin(), end = m_tagsInFlightBySendRequestId.constEnd(); it != end; ++it) {
+        Q_UNUSED(pendingTagLocalUids.insert(it.value().localUid()))
     }
 
-    // Need to set tag guids for all dirty notes which have the corresponding tags local uids
-    for(auto nit = m_notes.begin(), end = m_notes.end(); nit != end; ++nit)
+    for(int i = 0, size = m_tags.size(); i < size; ++i)
     {
-        Note & note = *nit;
-        if (!note.hasTagLocalUids()) {
+        const Tag & tag = m_tags.at(i);
+        if (tag.hasParentLocalUid() && pendingTagLocalUids.contains(tag.parentLocalUid())) {
+            Q_UNUSED(pendingTagLocalUids.insert(tag.localUid()))
             continue;
         }
 
-        QStringList noteTagGuids;
-        if (note.hasTagGuids()) {
-            noteTagGuids = note.tagGuids();
-        }
-
-        const QStringList & tagLocalUids = note.tagLocalUids();
-        for(auto tit = tagLocalUids.constBegin(), tend = tagLocalUids.constEnd(); tit != tend; ++tit)
-        {
-            auto git = tagGuidsByLocalUid.find(*tit);
-            if (git == tagGuidsByLocalUid.constEnd()) {
-                continue;
-            }
+        return i;
+    }
 
-            const QString & tagGuid = git.value();
-            if (noteTagGuids.contains(tagGuid)) {
-                continue;
-            }
+    return -1;
+}
 
-            note.addTagGuid(tagGuid);
-        }
-    }
+int SendLocalChangesManager::numDataItemsInFlight() const
+{
+    return m_tagsInFlightBySendRequestId.size() + m_savedSearchesInFlightBySendRequestId.size() +
+           m_notebooksInFlightBySendRequestId.size() + m_notesInFlightBySendRequestId.size();
 }
 
-void SendLocalChangesManager::sendSavedSearches()
+bool SendLocalChangesManager::hasDataItemsToSend() const
 {
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendSavedSearches"));
+    return !m_tags.isEmpty() || !m_savedSearches.isEmpty() || !m_notebooks.isEmpty() || !m_notes.isEmpty() ||
+           (numDataItemsInFlight() != 0) || !m_findNotebookRequestIds.isEmpty();
+}
 
-    ErrorString errorDescription;
-    NoteStore & noteStore = m_manager.noteStore();
+bool SendLocalChangesManager::noteStoreForLinkedNotebookGuid(const QString & linkedNotebookGuid, INoteStore *& pNoteStore,
+                                                             QString & linkedNotebookAuthToken, ErrorString & errorDescription)
+{
+    if (linkedNotebookGuid.isEmpty()) {
+        pNoteStore = &(m_manager.noteStore());
+        linkedNotebookAuthToken.resize(0);
+        return true;
+    }
 
-    typedef QList<SavedSearch>::iterator Iter;
-    for(Iter it = m_savedSearches.begin(); it != m_savedSearches.end(); )
+    auto cit = m_authenticationTokensAndShardIdsByLinkedNotebookGuid.find(linkedNotebookGuid);
+    if (cit == m_authenticationTokensAndShardIdsByLinkedNotebookGuid.end())
     {
-        SavedSearch & search = *it;
-
-        errorDescription.clear();
-        qint32 rateLimitSeconds = 0;
-        qint32 errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        errorDescription.setBase(QT_TR_NOOP("Couldn't find the authentication token for a linked notebook "
+                                            "when attempting to create or update a data item from it"));
+        errorDescription.details() = linkedNotebookGuid;
 
-        bool creatingSearch = !search.hasUpdateSequenceNumber();
-        if (creatingSearch) {
-            QNTRACE(QStringLiteral("Sending new saved search: ") << search);
-            errorCode = noteStore.createSavedSearch(search, errorDescription, rateLimitSeconds);
-        }
-        else {
-            QNTRACE(QStringLiteral("Sending modified saved search: ") << search);
-            errorCode = noteStore.updateSavedSearch(search, errorDescription, rateLimitSeconds);
+        auto sit = std::find_if(m_linkedNotebookAuthData.begin(), m_linkedNotebookAuthData.end(),
+                                CompareLinkedNotebookAuthDataByGuid(linkedNotebookGuid));
+        if (sit == m_linkedNotebookAuthData.end()) {
+            QNWARNING(QStringLiteral("The linked notebook the data item refers to was not found within the list of linked notebooks "
+                                     "received from local storage, linked notebook guid = ") << linkedNotebookGuid);
         }
 
-        if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
-        {
-            if (rateLimitSeconds <= 0) {
-                errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number "
-                                                    "of seconds to wait is incorrect"));
-                errorDescription.details() = QString::number(rateLimitSeconds);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+        return false;
+    }
 
-            int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-            if (Q_UNLIKELY(timerId == 0)) {
-                errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone "
-                                                    "the Evernote API call due to rate limit exceeding"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    auto sit = std::find_if(m_linkedNotebookAuthData.begin(), m_linkedNotebookAuthData.end(),
+                            CompareLinkedNotebookAuthDataByGuid(linkedNotebookGuid));
+    if (sit == m_linkedNotebookAuthData.end()) {
+        errorDescription.setBase(QT_TR_NOOP("Couldn't find the note store URL for a linked notebook "
+                                            "when attempting to create or update a data item from it"));
+        errorDescription.details() = linkedNotebookGuid;
+        return false;
+    }
 
-            m_sendSavedSearchesPostponeTimerId = timerId;
-            Q_EMIT rateLimitExceeded(rateLimitSeconds);
-            return;
-        }
-        else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-        {
-            handleAuthExpiration();
-            return;
-        }
-        else if (errorCode == qevercloud::EDAMErrorCode::DATA_CONFLICT)
-        {
-            QNINFO(QStringLiteral("Encountered DATA_CONFLICT exception while trying to send new and/or modified saved searches, "
-                                  "it means the incremental sync should be repeated before sending the changes to the service"));
-            Q_EMIT conflictDetected();
-            stop();
-            return;
-        }
-        else if (errorCode != 0)
-        {
-            ErrorString error(QT_TR_NOOP("Failed to send new and/or modified tags to Evernote service"));
-            error.additionalBases().append(errorDescription.base());
-            error.additionalBases().append(errorDescription.additionalBases());
-            error.details() = errorDescription.details();
-            Q_EMIT failure(error);
-            return;
-        }
+    LinkedNotebook linkedNotebook;
+    linkedNotebook.setGuid(linkedNotebookGuid);
+    linkedNotebook.setShardId(cit.value().second);
+    linkedNotebook.setNoteStoreUrl(sit->m_noteStoreUrl);
+    pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
+
+    if (Q_UNLIKELY(!pNoteStore)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't send new or modified data item: can't find or create a note store "
+                                            "for the linked notebook"));
+        errorDescription.details() = linkedNotebookGuid;
+        return false;
+    }
 
-        QNDEBUG(QStringLiteral("Successfully sent the saved search to Evernote"));
+    if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
+        errorDescription.details() = linkedNotebookGuid;
+        return false;
+    }
 
-        search.setDirty(false);
-        QUuid updateSavedSearchRequestId = QUuid::createUuid();
-        Q_UNUSED(m_updateSavedSearchRequestIds.insert(updateSavedSearchRequestId))
-        QNTRACE(QStringLiteral("Emitting the request to update saved search (remove the dirty flag from it): request id = ")
-                << updateSavedSearchRequestId << QStringLiteral(", saved search: ") << search);
-        Q_EMIT updateSavedSearch(search, updateSavedSearchRequestId);
+    linkedNotebookAuthToken = cit.value().first;
+    return true;
+}
 
-        if (!m_shouldRepeatIncrementalSync)
-        {
-            QNTRACE(QStringLiteral("Checking if we are still in sync with the remote service"));
+bool SendLocalChangesManager::sendTagAsync(const Tag & tag, ErrorString & errorDescription)
+{
+    INoteStore * pNoteStore = Q_NULLPTR;
+    QString linkedNotebookAuthToken;
+    if (!noteStoreForLinkedNotebookGuid((tag.hasLinkedNotebookGuid() ? tag.linkedNotebookGuid() : QString()),
+                                        pNoteStore, linkedNotebookAuthToken, errorDescription))
+    {
+        return false;
+    }
 
-            if (!search.hasUpdateSequenceNumber()) {
-                errorDescription.setBase(QT_TR_NOOP("Internal error: saved search's update "
-                                                    "sequence number is not set after sending it "
-                                                    "to Evernote service"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,createTagAsyncFinished,qint32,Tag,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onCreateTagAsyncFinished,qint32,Tag,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,updateTagAsyncFinished,qint32,Tag,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateTagAsyncFinished,qint32,Tag,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
-            if (search.updateSequenceNumber() == m_lastUpdateCount + 1) {
-                m_lastUpdateCount = search.updateSequenceNumber();
-                QNTRACE(QStringLiteral("The client is in sync with the service; updated last update count to ") << m_lastUpdateCount);
-            }
-            else {
-                m_shouldRepeatIncrementalSync = true;
-                Q_EMIT shouldRepeatIncrementalSync();
-                QNTRACE(QStringLiteral("The client is not in sync with the service"));
-            }
-        }
+    QUuid requestId = QUuid::createUuid();
+
+    bool res = false;
+    bool creatingTag = !tag.hasUpdateSequenceNumber();
+    if (creatingTag) {
+        QNTRACE(QStringLiteral("Sending new tag: request id = ") << requestId << QStringLiteral(", tag: ") << tag);
+        res = pNoteStore->createTagAsync(tag, linkedNotebookAuthToken, requestId, errorDescription);
+    }
+    else {
+        QNTRACE(QStringLiteral("Sending modified tag: request id = ") << requestId << QStringLiteral(", tag: ") << tag);
+        res = pNoteStore->updateTagAsync(tag, linkedNotebookAuthToken, requestId, errorDescription);
+    }
 
-        it = m_savedSearches.erase(it);
+    if (!res) {
+        return false;
     }
+
+    beginSyncTraceSpan(requestId.toString());
+    m_tagsInFlightBySendRequestId[requestId] = tag;
+    return true;
 }
 
-void SendLocalChangesManager::sendNotebooks()
+void SendLocalChangesManager::onSendTagAsyncFinished(const qint32 errorCode, const Tag & tag, const qint32 rateLimitSeconds,
+                                                     const ErrorString & errorDescription, const QUuid & requestId)
 {
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendNotebooks"));
+    auto it = m_tagsInFlightBySendRequestId.find(requestId);
+    if (it == m_tagsInFlightBySendRequestId.end()) {
+        QNTRACE(QStringLiteral("The tag was not sent by this object or has already been dropped, request id = ") << requestId);
+        return;
+    }
 
-    ErrorString errorDescription;
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onSendTagAsyncFinished: error code = ") << errorCode
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds << QStringLiteral(", error description = ")
+            << errorDescription << QStringLiteral(", request id = ") << requestId);
+
+    Tag sentTag = it.value();
+    Q_UNUSED(m_tagsInFlightBySendRequestId.erase(it))
+    endSyncTraceSpan(requestId.toString(), (errorCode == 0));
 
-    QHash<QString, QString> notebookGuidsByLocalUid;
-    notebookGuidsByLocalUid.reserve(m_notebooks.size());
+    QString linkedNotebookGuid = (sentTag.hasLinkedNotebookGuid() ? sentTag.linkedNotebookGuid() : QString());
 
-    for(auto it = m_notebooks.begin(); it != m_notebooks.end(); )
+    if (errorCode != 0)
     {
-        Notebook & notebook = *it;
+        if ((errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED) ||
+            (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED))
+        {
+            // Put the tag back to the head of the queue so that it would be sent first once possible;
+            // it precedes its child tags still in the queue so the order by parent-child relations is preserved
+            m_tags.prepend(sentTag);
+        }
 
-        errorDescription.clear();
-        qint32 rateLimitSeconds = 0;
-        qint32 errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+        handleSendDataItemError(errorCode, rateLimitSeconds, errorDescription, linkedNotebookGuid,
+                                ErrorString(QT_TR_NOOP("Failed to send new and/or modified tags to Evernote service")));
+        return;
+    }
 
-        QString linkedNotebookAuthToken;
-        QString linkedNotebookShardId;
-        QString linkedNotebookNoteStoreUrl;
+    QNDEBUG(QStringLiteral("Successfully sent the tag to Evernote"));
 
-        if (notebook.hasLinkedNotebookGuid())
-        {
-            auto cit = m_authenticationTokensAndShardIdsByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-            if (cit != m_authenticationTokensAndShardIdsByLinkedNotebookGuid.end())
-            {
-                linkedNotebookAuthToken = cit.value().first;
-                linkedNotebookShardId = cit.value().second;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the authentication token "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a notebook"));
-                if (notebook.hasName()) {
-                    errorDescription.details() = notebook.name();
-                }
+    if (Q_UNLIKELY(!tag.hasGuid()))
+    {
+        ErrorString error(QT_TR_NOOP("The tag just sent to Evernote has no guid"));
+        if (tag.hasName()) {
+            error.details() = tag.name();
+        }
 
-                QNWARNING(errorDescription << QStringLiteral(", notebook: ") << notebook);
+        QNWARNING(error << QStringLiteral(", tag: ") << tag);
+        Q_EMIT failure(error);
+        return;
+    }
 
-                auto sit = std::find_if(m_linkedNotebookAuthData.begin(),
-                                        m_linkedNotebookAuthData.end(),
-                                        CompareLinkedNotebookAuthDataByGuid(notebook.linkedNotebookGuid()));
-                if (sit == m_linkedNotebookAuthData.end()) {
-                    QNWARNING(QStringLiteral("The linked notebook the notebook refers to was not found within the list of linked notebooks "
-                                             "received from local storage"));
-                }
+    if (Q_UNLIKELY(!tag.hasUpdateSequenceNumber()))
+    {
+        ErrorString error(QT_TR_NOOP("Tag's update sequence number is not set after it being sent to the service"));
+        if (tag.hasName()) {
+            error.details() = tag.name();
+        }
 
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+        QNWARNING(error << QStringLiteral(", tag: ") << tag);
+        Q_EMIT failure(error);
+        return;
+    }
 
-            auto sit = std::find_if(m_linkedNotebookAuthData.begin(),
-                                    m_linkedNotebookAuthData.end(),
-                                    CompareLinkedNotebookAuthDataByGuid(notebook.linkedNotebookGuid()));
-            if (sit != m_linkedNotebookAuthData.end())
-            {
-                linkedNotebookNoteStoreUrl = sit->m_noteStoreUrl;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the note store URL "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a notebook from it"));
-                if (notebook.hasName()) {
-                    errorDescription.details() = notebook.name();
-                }
+    // Now the tag has obtained guid, need to set this guid as parent tag guid for child tags
+    for(auto tit = m_tags.begin(), tend = m_tags.end(); tit != tend; ++tit)
+    {
+        Tag & otherTag = *tit;
+        if (otherTag.hasParentLocalUid() && (otherTag.parentLocalUid() == tag.localUid())) {
+            otherTag.setParentGuid(tag.guid());
+        }
+    }
 
-                QNWARNING(errorDescription << QStringLiteral(", notebook: ") << notebook);
+    m_tagGuidsByLocalUid[tag.localUid()] = tag.guid();
 
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    if (!m_shouldRepeatIncrementalSync)
+    {
+        ErrorString error;
+        if (!checkUpdateCountInSync(tag.updateSequenceNumber(), linkedNotebookGuid, error)) {
+            QNWARNING(error << QStringLiteral(", tag: ") << tag);
+            Q_EMIT failure(error);
+            return;
         }
+    }
 
-        NoteStore * pNoteStore = Q_NULLPTR;
-        if (notebook.hasLinkedNotebookGuid())
-        {
-            LinkedNotebook linkedNotebook;
-            linkedNotebook.setGuid(notebook.linkedNotebookGuid());
-            linkedNotebook.setShardId(linkedNotebookShardId);
-            linkedNotebook.setNoteStoreUrl(linkedNotebookNoteStoreUrl);
-            pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
-            if (Q_UNLIKELY(!pNoteStore)) {
-                errorDescription.setBase(QT_TR_NOOP("Can't send new or modified notebook: can't find or create a note store for the linked notebook"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    Tag updatedTag = tag;
+    updatedTag.setDirty(false);
+    QUuid updateTagRequestId = QUuid::createUuid();
+    Q_UNUSED(m_updateTagRequestIds.insert(updateTagRequestId))
+    QNTRACE(QStringLiteral("Emitting the request to update tag (remove dirty flag from it): request id = ")
+            << updateTagRequestId << QStringLiteral(", tag: ") << updatedTag);
+    Q_EMIT updateTag(updatedTag, updateTagRequestId);
 
-            if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
-                ErrorString errorDescription(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                Q_EMIT failure(errorDescription);
-                return;
-            }
-        }
-        else
-        {
-            pNoteStore = &(m_manager.noteStore());
-        }
+    sendDataItems();
+}
 
-        bool creatingNotebook = !notebook.hasUpdateSequenceNumber();
-        if (creatingNotebook) {
-            QNTRACE(QStringLiteral("Sending new notebook: ") << notebook);
-            errorCode = pNoteStore->createNotebook(notebook, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
-        }
-        else {
-            QNTRACE(QStringLiteral("Sending modified notebook: ") << notebook);
-            errorCode = pNoteStore->updateNotebook(notebook, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
-        }
+bool SendLocalChangesManager::sendSavedSearchAsync(const SavedSearch & search, ErrorString & errorDescription)
+{
+    INoteStore & noteStore = m_manager.noteStore();
+
+    QObject::connect(&noteStore, QNSIGNAL(INoteStore,createSavedSearchAsyncFinished,qint32,SavedSearch,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onCreateSavedSearchAsyncFinished,qint32,SavedSearch,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+    QObject::connect(&noteStore, QNSIGNAL(INoteStore,updateSavedSearchAsyncFinished,qint32,SavedSearch,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateSavedSearchAsyncFinished,qint32,SavedSearch,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
-        if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+    QUuid requestId = QUuid::createUuid();
+
+    bool res = false;
+    bool creatingSearch = !search.hasUpdateSequenceNumber();
+    if (creatingSearch) {
+        QNTRACE(QStringLiteral("Sending new saved search: request id = ") << requestId << QStringLiteral(", saved search: ") << search);
+        res = noteStore.createSavedSearchAsync(search, requestId, errorDescription);
+    }
+    else {
+        QNTRACE(QStringLiteral("Sending modified saved search: request id = ") << requestId << QStringLiteral(", saved search: ") << search);
+        res = noteStore.updateSavedSearchAsync(search, requestId, errorDescription);
+    }
+
+    if (!res) {
+        return false;
+    }
+
+    beginSyncTraceSpan(requestId.toString());
+    m_savedSearchesInFlightBySendRequestId[requestId] = search;
+    return true;
+}
+
+void SendLocalChangesManager::onSendSavedSearchAsyncFinished(const qint32 errorCode, const SavedSearch & search,
+                                                             const qint32 rateLimitSeconds, const ErrorString & errorDescription,
+                                                             const QUuid & requestId)
+{
+    auto it = m_savedSearchesInFlightBySendRequestId.find(requestId);
+    if (it == m_savedSearchesInFlightBySendRequestId.end()) {
+        QNTRACE(QStringLiteral("The saved search was not sent by this object or has already been dropped, request id = ") << requestId);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onSendSavedSearchAsyncFinished: error code = ") << errorCode
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds << QStringLiteral(", error description = ")
+            << errorDescription << QStringLiteral(", request id = ") << requestId);
+
+    SavedSearch sentSearch = it.value();
+    Q_UNUSED(m_savedSearchesInFlightBySendRequestId.erase(it))
+    endSyncTraceSpan(requestId.toString(), (errorCode == 0));
+
+    if (errorCode != 0)
+    {
+        if ((errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED) ||
+            (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED))
         {
-            if (rateLimitSeconds <= 0) {
-                errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number "
-                                                    "of seconds to wait is incorrect"));
-                errorDescription.details() = QString::number(rateLimitSeconds);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+            m_savedSearches.prepend(sentSearch);
+        }
 
-            int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-            if (Q_UNLIKELY(timerId == 0)) {
-                errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone "
-                                                    "the Evernote API call due to rate limit exceeding"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+        handleSendDataItemError(errorCode, rateLimitSeconds, errorDescription, QString(),
+                                ErrorString(QT_TR_NOOP("Failed to send new and/or modified saved searches to Evernote service")));
+        return;
+    }
 
-            m_sendNotebooksPostponeTimerId = timerId;
-            Q_EMIT rateLimitExceeded(rateLimitSeconds);
-            return;
+    QNDEBUG(QStringLiteral("Successfully sent the saved search to Evernote"));
+
+    if (Q_UNLIKELY(!search.hasUpdateSequenceNumber()))
+    {
+        ErrorString error(QT_TR_NOOP("Internal error: saved search's update sequence number is not set "
+                                     "after sending it to Evernote service"));
+        if (search.hasName()) {
+            error.details() = search.name();
         }
-        else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-        {
-            if (!notebook.hasLinkedNotebookGuid()) {
-                handleAuthExpiration();
-            }
-            else
-            {
-                auto cit = m_authenticationTokenExpirationTimesByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-                if (cit == m_authenticationTokenExpirationTimesByLinkedNotebookGuid.end())
-                {
-                    errorDescription.setBase(QT_TR_NOOP("Couldn't find the linked notebook "
-                                                        "auth token's expiration time"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-                else if (checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
-                    errorDescription.setBase(QT_TR_NOOP("Unexpected AUTH_EXPIRED error: authentication "
-                                                        "tokens for all linked notebooks are still valid"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-            }
 
+        QNWARNING(error << QStringLiteral(", saved search: ") << search);
+        Q_EMIT failure(error);
+        return;
+    }
+
+    if (!m_shouldRepeatIncrementalSync)
+    {
+        ErrorString error;
+        if (!checkUpdateCountInSync(search.updateSequenceNumber(), QString(), error)) {
+            QNWARNING(error << QStringLiteral(", saved search: ") << search);
+            Q_EMIT failure(error);
             return;
         }
-        else if (errorCode == qevercloud::EDAMErrorCode::DATA_CONFLICT)
+    }
+
+    SavedSearch updatedSearch = search;
+    updatedSearch.setDirty(false);
+    QUuid updateSavedSearchRequestId = QUuid::createUuid();
+    Q_UNUSED(m_updateSavedSearchRequestIds.insert(updateSavedSearchRequestId))
+    QNTRACE(QStringLiteral("Emitting the request to update saved search (remove the dirty flag from it): request id = ")
+            << updateSavedSearchRequestId << QStringLiteral(", saved search: ") << updatedSearch);
+    Q_EMIT updateSavedSearch(updatedSearch, updateSavedSearchRequestId);
+
+    sendDataItems();
+}
+
+bool SendLocalChangesManager::sendNotebookAsync(const Notebook & notebook, ErrorString & errorDescription)
+{
+    INoteStore * pNoteStore = Q_NULLPTR;
+    QString linkedNotebookAuthToken;
+    if (!noteStoreForLinkedNotebookGuid((notebook.hasLinkedNotebookGuid() ? notebook.linkedNotebookGuid() : QString()),
+                                        pNoteStore, linkedNotebookAuthToken, errorDescription))
+    {
+        return false;
+    }
+
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,createNotebookAsyncFinished,qint32,Notebook,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onCreateNotebookAsyncFinished,qint32,Notebook,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,updateNotebookAsyncFinished,qint32,Notebook,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateNotebookAsyncFinished,qint32,Notebook,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+
+    QUuid requestId = QUuid::createUuid();
+
+    bool res = false;
+    bool creatingNotebook = !notebook.hasUpdateSequenceNumber();
+    if (creatingNotebook) {
+        QNTRACE(QStringLiteral("Sending new notebook: request id = ") << requestId << QStringLiteral(", notebook: ") << notebook);
+        res = pNoteStore->createNotebookAsync(notebook, linkedNotebookAuthToken, requestId, errorDescription);
+    }
+    else {
+        QNTRACE(QStringLiteral("Sending modified notebook: request id = ") << requestId << QStringLiteral(", notebook: ") << notebook);
+        res = pNoteStore->updateNotebookAsync(notebook, linkedNotebookAuthToken, requestId, errorDescription);
+    }
+
+    if (!res) {
+        return false;
+    }
+
+    beginSyncTraceSpan(requestId.toString());
+    m_notebooksInFlightBySendRequestId[requestId] = notebook;
+    return true;
+}
+
+void SendLocalChangesManager::onSendNotebookAsyncFinished(const qint32 errorCode, const Notebook & notebook,
+                                                          const qint32 rateLimitSeconds, const ErrorString & errorDescription,
+                                                          const QUuid & requestId)
+{
+    auto it = m_notebooksInFlightBySendRequestId.find(requestId);
+    if (it == m_notebooksInFlightBySendRequestId.end()) {
+        QNTRACE(QStringLiteral("The notebook was not sent by this object or has already been dropped, request id = ") << requestId);
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onSendNotebookAsyncFinished: error code = ") << errorCode
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds << QStringLiteral(", error description = ")
+            << errorDescription << QStringLiteral(", request id = ") << requestId);
+
+    Notebook sentNotebook = it.value();
+    Q_UNUSED(m_notebooksInFlightBySendRequestId.erase(it))
+    endSyncTraceSpan(requestId.toString(), (errorCode == 0));
+
+    QString linkedNotebookGuid = (sentNotebook.hasLinkedNotebookGuid() ? sentNotebook.linkedNotebookGuid() : QString());
+
+    if (errorCode != 0)
+    {
+        if ((errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED) ||
+            (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED))
         {
-            QNINFO(QStringLiteral("Encountered DATA_CONFLICT exception while trying to send new and/or modified notebooks, "
-                                  "it means the incremental sync should be repeated before sending the changes to the service"));
-            Q_EMIT conflictDetected();
-            stop();
-            return;
+            m_notebooks.prepend(sentNotebook);
         }
-        else if (errorCode != 0)
-        {
-            ErrorString error(QT_TR_NOOP("Failed to send new and/or mofidied notebooks to Evernote service"));
-            error.additionalBases().append(errorDescription.base());
-            error.additionalBases().append(errorDescription.additionalBases());
-            error.details() = errorDescription.details();
-            Q_EMIT failure(error);
-            return;
+
+        handleSendDataItemError(errorCode, rateLimitSeconds, errorDescription, linkedNotebookGuid,
+                                ErrorString(QT_TR_NOOP("Failed to send new and/or mofidied notebooks to Evernote service")));
+        return;
+    }
+
+    QNDEBUG(QStringLiteral("Successfully sent the notebook to Evernote"));
+
+    if (Q_UNLIKELY(!notebook.hasGuid()))
+    {
+        ErrorString error(QT_TR_NOOP("The notebook just sent to Evernote has no guid"));
+        if (notebook.hasName()) {
+            error.details() = notebook.name();
         }
 
-        QNDEBUG(QStringLiteral("Successfully sent the notebook to Evernote"));
+        QNWARNING(error << QStringLiteral(", notebook: ") << notebook);
+        Q_EMIT failure(error);
+        return;
+    }
 
-        if (Q_UNLIKELY(!notebook.hasGuid()))
-        {
-            ErrorString error(QT_TR_NOOP("The notebook just sent to Evernote has no guid"));
-            if (notebook.hasName()) {
-                error.details() = notebook.name();
-            }
+    if (Q_UNLIKELY(!notebook.hasUpdateSequenceNumber()))
+    {
+        ErrorString error(QT_TR_NOOP("Notebook's update sequence number is not set after it was sent to Evernote service"));
+        if (notebook.hasName()) {
+            error.details() = notebook.name();
+        }
+
+        QNWARNING(error << QStringLiteral(", notebook: ") << notebook);
+        Q_EMIT failure(error);
+        return;
+    }
+
+    m_notebookGuidsByLocalUid[notebook.localUid()] = notebook.guid();
+
+    if (!m_shouldRepeatIncrementalSync)
+    {
+        ErrorString error;
+        if (!checkUpdateCountInSync(notebook.updateSequenceNumber(), linkedNotebookGuid, error)) {
+            QNWARNING(error << QStringLiteral(", notebook: ") << notebook);
             Q_EMIT failure(error);
             return;
         }
+    }
 
-        notebookGuidsByLocalUid[notebook.localUid()] = notebook.guid();
+    Notebook updatedNotebook = notebook;
+    updatedNotebook.setDirty(false);
+    QUuid updateNotebookRequestId = QUuid::createUuid();
+    Q_UNUSED(m_updateNotebookRequestIds.insert(updateNotebookRequestId))
+    QNTRACE(QStringLiteral("Emitting the request to update notebook (remove dirty flag from it): request id = ")
+            << updateNotebookRequestId << QStringLiteral(", notebook: ") << updatedNotebook);
+    Q_EMIT updateNotebook(updatedNotebook, updateNotebookRequestId);
 
-        notebook.setDirty(false);
-        QUuid updateNotebookRequestId = QUuid::createUuid();
-        Q_UNUSED(m_updateNotebookRequestIds.insert(updateNotebookRequestId))
-        QNTRACE(QStringLiteral("Emitting the request to update notebook (remove dirty flag from it): request id = ")
-                << updateNotebookRequestId << QStringLiteral(", notebook: ") << notebook);
-        Q_EMIT updateNotebook(notebook, updateNotebookRequestId);
+    sendDataItems();
+}
 
-        if (!m_shouldRepeatIncrementalSync)
-        {
-            QNTRACE(QStringLiteral("Checking if we are still in sync with the remote service"));
+bool SendLocalChangesManager::prepareNotesForSending()
+{
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::prepareNotesForSending"));
 
-            if (!notebook.hasUpdateSequenceNumber())
-            {
-                errorDescription.setBase(QT_TR_NOOP("Notebook's update sequence number is not "
-                                                    "set after it was sent to Evernote service"));
-                if (notebook.hasName()) {
-                    errorDescription.details() = notebook.name();
-                }
+    for(auto nit = m_notes.begin(), end = m_notes.end(); nit != end; ++nit)
+    {
+        Note & note = *nit;
 
-                Q_EMIT failure(errorDescription);
-                return;
+        // Need to set tag guids for all dirty notes which have the corresponding tags local uids
+        if (note.hasTagLocalUids())
+        {
+            QStringList noteTagGuids;
+            if (note.hasTagGuids()) {
+                noteTagGuids = note.tagGuids();
             }
 
-            int * pLastUpdateCount = Q_NULLPTR;
-            if (!notebook.hasLinkedNotebookGuid())
-            {
-                pLastUpdateCount = &m_lastUpdateCount;
-                QNTRACE(QStringLiteral("Current notebook does not belong to linked notebook"));
-            }
-            else
+            const QStringList & tagLocalUids = note.tagLocalUids();
+            for(auto tit = tagLocalUids.constBegin(), tend = tagLocalUids.constEnd(); tit != tend; ++tit)
             {
-                QNTRACE(QStringLiteral("Current notebook belongs to linked notebook with guid ") << notebook.linkedNotebookGuid());
-
-                auto lit = m_lastUpdateCountByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-                if (lit == m_lastUpdateCountByLinkedNotebookGuid.end()) {
-                    errorDescription.setBase(QT_TR_NOOP("Can't find the update count per linked "
-                                                        "notebook guid on attempt to check the update "
-                                                        "count of a notebook sent to Evernote service"));
-                    Q_EMIT failure(errorDescription);
-                    return;
+                auto git = m_tagGuidsByLocalUid.find(*tit);
+                if (git == m_tagGuidsByLocalUid.constEnd()) {
+                    continue;
                 }
 
-                pLastUpdateCount = &lit.value();
-            }
+                const QString & tagGuid = git.value();
+                if (noteTagGuids.contains(tagGuid)) {
+                    continue;
+                }
 
-            if (notebook.updateSequenceNumber() == *pLastUpdateCount + 1) {
-                *pLastUpdateCount = notebook.updateSequenceNumber();
-                QNTRACE(QStringLiteral("The client is in sync with the service; updated last update count to ") << *pLastUpdateCount);
-            }
-            else {
-                m_shouldRepeatIncrementalSync = true;
-                Q_EMIT shouldRepeatIncrementalSync();
-                QNTRACE(QStringLiteral("The client is not in sync with the service"));
+                note.addTagGuid(tagGuid);
             }
         }
 
-        it = m_notebooks.erase(it);
-    }
-
-    // Need to set notebook guids for all dirty notes which have the
-    // corresponding notebook local uids
-    for(auto nit = m_notes.begin(), end = m_notes.end(); nit != end; ++nit)
-    {
-        Note & note = *nit;
+        // Need to set notebook guids for all dirty notes which have the corresponding notebook local uids
         if (note.hasNotebookGuid()) {
-            QNDEBUG(QStringLiteral("Dirty note with local uid ") << note.localUid() << QStringLiteral(" already has notebook guid: ")
-                    << note.notebookGuid());
             continue;
         }
 
         if (Q_UNLIKELY(!note.hasNotebookLocalUid())) {
             ErrorString error(QT_TR_NOOP("Detected note which doesn't have neither notebook guid not notebook local uid"));
             APPEND_NOTE_DETAILS(error, note);
-            QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
-            Q_EMIT failure(errorDescription);
-            return;
+            QNWARNING(error << QStringLiteral(", note: ") << note);
+            Q_EMIT failure(error);
+            return false;
         }
 
-        auto git = notebookGuidsByLocalUid.find(note.notebookLocalUid());
-        if (Q_UNLIKELY(git == notebookGuidsByLocalUid.end())) {
+        auto git = m_notebookGuidsByLocalUid.find(note.notebookLocalUid());
+        if (Q_UNLIKELY(git == m_notebookGuidsByLocalUid.end())) {
             ErrorString error(QT_TR_NOOP("Can't find the notebook guid for one of notes"));
             APPEND_NOTE_DETAILS(error, note);
-            QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
-            Q_EMIT failure(errorDescription);
-            return;
+            QNWARNING(error << QStringLiteral(", note: ") << note);
+            Q_EMIT failure(error);
+            return false;
         }
 
         note.setNotebookGuid(git.value());
     }
+
+    m_notesPreparedForSending = true;
+    findNotebooksForNotes();
+    return true;
 }
 
-void SendLocalChangesManager::checkAndSendNotes()
+bool SendLocalChangesManager::sendNoteAsync(const Note & note, ErrorString & errorDescription)
 {
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::checkAndSendNotes"));
-
-    if (m_tags.isEmpty() && m_notebooks.isEmpty() && m_findNotebookRequestIds.isEmpty()) {
-        sendNotes();
+    if (!note.hasNotebookGuid()) {
+        errorDescription.setBase(QT_TR_NOOP("Found a note without notebook guid"));
+        APPEND_NOTE_DETAILS(errorDescription, note)
+        return false;
     }
-}
 
-void SendLocalChangesManager::sendNotes()
-{
-    QNDEBUG(QStringLiteral("SendLocalChangesManager::sendNotes"));
+    auto nit = m_notebooksByGuidsCache.find(note.notebookGuid());
+    if (nit == m_notebooksByGuidsCache.end()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't find the notebook for one of notes "
+                                            "about to be sent to Evernote service"));
+        APPEND_NOTE_DETAILS(errorDescription, note)
+        return false;
+    }
 
-    ErrorString errorDescription;
+    const Notebook & notebook = nit.value();
 
-    typedef QList<Note>::iterator Iter;
-    for(Iter it = m_notes.begin(); it != m_notes.end(); )
+    INoteStore * pNoteStore = Q_NULLPTR;
+    QString linkedNotebookAuthToken;
+    if (!noteStoreForLinkedNotebookGuid((notebook.hasLinkedNotebookGuid() ? notebook.linkedNotebookGuid() : QString()),
+                                        pNoteStore, linkedNotebookAuthToken, errorDescription))
     {
-        Note & note = *it;
+        return false;
+    }
 
-        errorDescription.clear();
-        qint32 rateLimitSeconds = 0;
-        qint32 errorCode = qevercloud::EDAMErrorCode::UNKNOWN;
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,createNoteAsyncFinished,qint32,Note,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onCreateNoteAsyncFinished,qint32,Note,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+    QObject::connect(pNoteStore, QNSIGNAL(INoteStore,updateNoteAsyncFinished,qint32,Note,qint32,ErrorString,QUuid),
+                     this, QNSLOT(SendLocalChangesManager,onUpdateNoteAsyncFinished,qint32,Note,qint32,ErrorString,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
 
-        if (!note.hasNotebookGuid()) {
-            errorDescription.setBase(QT_TR_NOOP("Found a note without notebook guid"));
-            APPEND_NOTE_DETAILS(errorDescription, note)
-            QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
-            Q_EMIT failure(errorDescription);
-            return;
-        }
+    QUuid requestId = QUuid::createUuid();
 
-        auto nit = m_notebooksByGuidsCache.find(note.notebookGuid());
-        if (nit == m_notebooksByGuidsCache.end())
-        {
-            errorDescription.setBase(QT_TR_NOOP("Can't find the notebook for one of notes "
-                                                "about to be sent to Evernote service"));
-            APPEND_NOTE_DETAILS(errorDescription, note)
-
-            QNWARNING(errorDescription << QStringLiteral(", note: ") << note);
-            Q_EMIT failure(errorDescription);
-            return;
-        }
+    bool res = false;
+    bool creatingNote = !note.hasUpdateSequenceNumber();
+    if (creatingNote) {
+        QNTRACE(QStringLiteral("Sending new note: request id = ") << requestId << QStringLiteral(", note: ") << note);
+        res = pNoteStore->createNoteAsync(note, linkedNotebookAuthToken, requestId, errorDescription);
+    }
+    else {
+        QNTRACE(QStringLiteral("Sending modified note: request id = ") << requestId << QStringLiteral(", note: ") << note);
+        res = pNoteStore->updateNoteAsync(note, linkedNotebookAuthToken, requestId, errorDescription);
+    }
 
-        const Notebook & notebook = nit.value();
+    if (!res) {
+        return false;
+    }
 
-        QString linkedNotebookAuthToken;
-        QString linkedNotebookShardId;
-        QString linkedNotebookNoteStoreUrl;
+    beginSyncTraceSpan(requestId.toString());
+    m_notesInFlightBySendRequestId[requestId] = note;
+    return true;
+}
 
-        if (notebook.hasLinkedNotebookGuid())
-        {
-            auto cit = m_authenticationTokensAndShardIdsByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-            if (cit != m_authenticationTokensAndShardIdsByLinkedNotebookGuid.end())
-            {
-                linkedNotebookAuthToken = cit.value().first;
-                linkedNotebookShardId = cit.value().second;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the authenticaton token "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a note from that notebook"));
-                QNWARNING(errorDescription << QStringLiteral(", notebook: ") << notebook);
+void SendLocalChangesManager::onSendNoteAsyncFinished(const qint32 errorCode, const Note & note, const qint32 rateLimitSeconds,
+                                                      const ErrorString & errorDescription, const QUuid & requestId)
+{
+    auto it = m_notesInFlightBySendRequestId.find(requestId);
+    if (it == m_notesInFlightBySendRequestId.end()) {
+        QNTRACE(QStringLiteral("The note was not sent by this object or has already been dropped, request id = ") << requestId);
+        return;
+    }
 
-                auto sit = std::find_if(m_linkedNotebookAuthData.begin(), m_linkedNotebookAuthData.end(),
-                                        CompareLinkedNotebookAuthDataByGuid(notebook.linkedNotebookGuid()));
-                if (sit == m_linkedNotebookAuthData.end()) {
-                    QNWARNING("The linked notebook the notebook refers to was not found within the list of linked notebooks "
-                              "received from local storage");
-                }
+    QNDEBUG(QStringLiteral("SendLocalChangesManager::onSendNoteAsyncFinished: error code = ") << errorCode
+            << QStringLiteral(", rate limit seconds = ") << rateLimitSeconds << QStringLiteral(", error description = ")
+            << errorDescription << QStringLiteral(", request id = ") << requestId);
 
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    Note sentNote = it.value();
+    Q_UNUSED(m_notesInFlightBySendRequestId.erase(it))
+    endSyncTraceSpan(requestId.toString(), (errorCode == 0));
 
-            auto sit = std::find_if(m_linkedNotebookAuthData.begin(), m_linkedNotebookAuthData.end(),
-                                    CompareLinkedNotebookAuthDataByGuid(notebook.linkedNotebookGuid()));
-            if (sit != m_linkedNotebookAuthData.end())
-            {
-                linkedNotebookNoteStoreUrl = sit->m_noteStoreUrl;
-            }
-            else
-            {
-                errorDescription.setBase(QT_TR_NOOP("Couldn't find the note store URL "
-                                                    "for a linked notebook when attempting "
-                                                    "to create or update a note from it"));
-                if (notebook.hasName()) {
-                    errorDescription.details() = notebook.name();
-                }
+    auto nit = m_notebooksByGuidsCache.find(sentNote.notebookGuid());
+    if (Q_UNLIKELY(nit == m_notebooksByGuidsCache.end())) {
+        ErrorString error(QT_TR_NOOP("Can't find the notebook for the note sent to Evernote service"));
+        APPEND_NOTE_DETAILS(error, sentNote)
+        QNWARNING(error << QStringLiteral(", note: ") << sentNote);
+        Q_EMIT failure(error);
+        return;
+    }
 
-                QNWARNING(errorDescription << QStringLiteral(", notebook: ") << notebook);
+    const Notebook & notebook = nit.value();
+    QString linkedNotebookGuid = (notebook.hasLinkedNotebookGuid() ? notebook.linkedNotebookGuid() : QString());
 
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    if (errorCode != 0)
+    {
+        if ((errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED) ||
+            (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED))
+        {
+            // Put the note back to the head of the queue so that it would be sent first once possible
+            m_notes.prepend(sentNote);
         }
 
-        NoteStore * pNoteStore = Q_NULLPTR;
-        if (notebook.hasLinkedNotebookGuid())
-        {
-            LinkedNotebook linkedNotebook;
-            linkedNotebook.setGuid(notebook.linkedNotebookGuid());
-            linkedNotebook.setShardId(linkedNotebookShardId);
-            linkedNotebook.setNoteStoreUrl(linkedNotebookNoteStoreUrl);
-            pNoteStore = m_manager.noteStoreForLinkedNotebook(linkedNotebook);
-
-            if (Q_UNLIKELY(!pNoteStore)) {
-                errorDescription.setBase(QT_TR_NOOP("Can't send new or modified note: can't find or create a note store for the linked notebook"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+        // The notes sent successfully before shouldn't keep waiting for the dirty flag removal
+        // while the sending is suspended
+        checkAndFlushNotesPendingDirtyFlagRemoval();
 
-            if (Q_UNLIKELY(pNoteStore->noteStoreUrl().isEmpty())) {
-                ErrorString errorDescription(QT_TR_NOOP("Internal error: empty note store url for the linked notebook's note store"));
-                QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                Q_EMIT failure(errorDescription);
-                return;
-            }
-        }
-        else
-        {
-            pNoteStore = &(m_manager.noteStore());
-        }
+        handleSendDataItemError(errorCode, rateLimitSeconds, errorDescription, linkedNotebookGuid,
+                                ErrorString(QT_TR_NOOP("Failed to send new and/or mofidied notes to Evernote service")));
+        return;
+    }
 
-        bool creatingNote = !note.hasUpdateSequenceNumber();
-        if (creatingNote) {
-            QNTRACE(QStringLiteral("Sending new note: ") << note);
-            errorCode = pNoteStore->createNote(note, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
-        }
-        else {
-            QNTRACE(QStringLiteral("Sending modified note: ") << note);
-            errorCode = pNoteStore->updateNote(note, errorDescription, rateLimitSeconds, linkedNotebookAuthToken);
+    QNDEBUG(QStringLiteral("Successfully sent the note to Evernote"));
+
+    if (Q_UNLIKELY(!note.hasUpdateSequenceNumber())) {
+        ErrorString error(QT_TR_NOOP("Note's update sequence number is not set after it was sent to Evernote service"));
+        APPEND_NOTE_DETAILS(error, note)
+        QNWARNING(error << QStringLiteral(", note: ") << note);
+        Q_EMIT failure(error);
+        return;
+    }
+
+    if (!m_shouldRepeatIncrementalSync)
+    {
+        ErrorString error;
+        if (!checkUpdateCountInSync(note.updateSequenceNumber(), linkedNotebookGuid, error)) {
+            QNWARNING(error << QStringLiteral(", note: ") << note);
+            Q_EMIT failure(error);
+            return;
         }
+    }
 
-        if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
-        {
-            if (rateLimitSeconds <= 0) {
-                errorDescription.setBase(QT_TR_NOOP("Rate limit reached but the number "
-                                                    "of seconds to wait is incorrect"));
-                errorDescription.details() = QString::number(rateLimitSeconds);
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    Note updatedNote = note;
+    updatedNote.setDirty(false);
+    m_notesPendingDirtyFlagRemoval << updatedNote;
+    checkAndFlushNotesPendingDirtyFlagRemoval();
 
-            int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
-            if (timerId == 0) {
-                errorDescription.setBase(QT_TR_NOOP("Failed to start a timer to postpone "
-                                                    "the Evernote API call due to rate limit exceeding"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    sendDataItems();
+}
 
-            m_sendNotesPostponeTimerId = timerId;
-            Q_EMIT rateLimitExceeded(rateLimitSeconds);
+void SendLocalChangesManager::handleSendDataItemError(const qint32 errorCode, const qint32 rateLimitSeconds,
+                                                      const ErrorString & errorDescription, const QString & linkedNotebookGuid,
+                                                      const ErrorString & errorBase)
+{
+    if (errorCode == qevercloud::EDAMErrorCode::RATE_LIMIT_REACHED)
+    {
+        if (rateLimitSeconds <= 0) {
+            ErrorString error(QT_TR_NOOP("Rate limit reached but the number of seconds to wait is incorrect"));
+            error.details() = QString::number(rateLimitSeconds);
+            QNWARNING(error);
+            Q_EMIT failure(error);
             return;
         }
-        else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
-        {
-            if (!notebook.hasLinkedNotebookGuid()) {
-                handleAuthExpiration();
-            }
-            else
-            {
-                auto cit = m_authenticationTokenExpirationTimesByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-                if (cit == m_authenticationTokenExpirationTimesByLinkedNotebookGuid.end())
-                {
-                    errorDescription.setBase(QT_TR_NOOP("Couldn't find the linked notebook auth token's expiration time"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-                else if (checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
-                    errorDescription.setBase(QT_TR_NOOP("Unexpected AUTH_EXPIRED error: authentication "
-                                                        "tokens for all linked notebooks are still valid"));
-                    QNWARNING(errorDescription << QStringLiteral(", linked notebook guid = ") << notebook.linkedNotebookGuid());
-                    Q_EMIT failure(errorDescription);
-                }
-            }
 
+        // The rate limit is per account so all the data items wait for the same timer
+        if (m_sendDataItemsPostponeTimerId > 0) {
+            QNDEBUG(QStringLiteral("Already waiting for the rate limit to expire"));
             return;
         }
-        else if (errorCode == qevercloud::EDAMErrorCode::DATA_CONFLICT)
-        {
-            QNINFO(QStringLiteral("Encountered DATA_CONFLICT exception while trying to send new and/or modified notes, "
-                                  "it means the incremental sync should be repeated before sending the changes to the service"));
-            Q_EMIT conflictDetected();
-            stop();
+
+        int timerId = startTimer(SEC_TO_MSEC(rateLimitSeconds));
+        if (Q_UNLIKELY(timerId == 0)) {
+            ErrorString error(QT_TR_NOOP("Failed to start a timer to postpone "
+                                         "the Evernote API call due to rate limit exceeding"));
+            QNWARNING(error);
+            Q_EMIT failure(error);
             return;
         }
-        else if (errorCode != 0)
+
+        m_sendDataItemsPostponeTimerId = timerId;
+        Q_EMIT rateLimitExceeded(rateLimitSeconds);
+        return;
+    }
+    else if (errorCode == qevercloud::EDAMErrorCode::AUTH_EXPIRED)
+    {
+        if (linkedNotebookGuid.isEmpty()) {
+            handleAuthExpiration();
+        }
+        else if (m_pendingAuthenticationTokensForLinkedNotebooks) {
+            QNDEBUG(QStringLiteral("Already waiting for the authentication tokens for linked notebooks"));
+        }
+        else
         {
-            ErrorString error(QT_TR_NOOP("Failed to send new and/or mofidied notes to Evernote service"));
-            error.additionalBases().append(errorDescription.base());
-            error.additionalBases().append(errorDescription.additionalBases());
-            error.details() = errorDescription.details();
-            Q_EMIT failure(error);
-            return;
+            auto cit = m_authenticationTokenExpirationTimesByLinkedNotebookGuid.find(linkedNotebookGuid);
+            if (cit == m_authenticationTokenExpirationTimesByLinkedNotebookGuid.end())
+            {
+                ErrorString error(QT_TR_NOOP("Couldn't find the linked notebook auth token's expiration time"));
+                QNWARNING(error << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+                Q_EMIT failure(error);
+            }
+            else if (checkAndRequestAuthenticationTokensForLinkedNotebooks()) {
+                ErrorString error(QT_TR_NOOP("Unexpected AUTH_EXPIRED error: authentication "
+                                             "tokens for all linked notebooks are still valid"));
+                QNWARNING(error << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+                Q_EMIT failure(error);
+            }
         }
 
-        QNDEBUG(QStringLiteral("Successfully sent the note to Evernote"));
+        return;
+    }
+    else if (errorCode == qevercloud::EDAMErrorCode::DATA_CONFLICT)
+    {
+        QNINFO(QStringLiteral("Encountered DATA_CONFLICT exception while trying to send new and/or modified data items, "
+                              "it means the incremental sync should be repeated before sending the changes to the service"));
+        Q_EMIT conflictDetected();
+        stop();
+        return;
+    }
 
-        note.setDirty(false);
-        QUuid updateNoteRequestId = QUuid::createUuid();
-        Q_UNUSED(m_updateNoteRequestIds.insert(updateNoteRequestId))
-        QNTRACE(QStringLiteral("Emitting the request to update note (remove the dirty flag from it): request id = ")
-                << updateNoteRequestId << QStringLiteral(", note: ") << note);
-        Q_EMIT updateNote(note, /* update resources = */ false, /* update tags = */ false, updateNoteRequestId);
+    ErrorString error(errorBase);
+    error.additionalBases().append(errorDescription.base());
+    error.additionalBases().append(errorDescription.additionalBases());
+    error.details() = errorDescription.details();
+    QNWARNING(error);
+    Q_EMIT failure(error);
+}
 
-        if (!m_shouldRepeatIncrementalSync)
-        {
-            QNTRACE(QStringLiteral("Checking if we are still in sync with Evernote service"));
+bool SendLocalChangesManager::checkUpdateCountInSync(const qint32 updateSequenceNumber, const QString & linkedNotebookGuid,
+                                                     ErrorString & errorDescription)
+{
+    QNTRACE(QStringLiteral("Checking if we are still in sync with Evernote service: update sequence number = ")
+            << updateSequenceNumber << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
 
-            if (!note.hasUpdateSequenceNumber()) {
-                errorDescription.setBase(QT_TR_NOOP("Note's update sequence number is not set "
-                                                    "after it was sent to Evernote service"));
-                Q_EMIT failure(errorDescription);
-                return;
-            }
+    int * pLastUpdateCount = Q_NULLPTR;
+    if (linkedNotebookGuid.isEmpty())
+    {
+        pLastUpdateCount = &m_lastUpdateCount;
+    }
+    else
+    {
+        auto lit = m_lastUpdateCountByLinkedNotebookGuid.find(linkedNotebookGuid);
+        if (lit == m_lastUpdateCountByLinkedNotebookGuid.end()) {
+            errorDescription.setBase(QT_TR_NOOP("Failed to find the update count per linked "
+                                                "notebook guid on attempt to check the update "
+                                                "count of a data item sent to Evernote service"));
+            errorDescription.details() = linkedNotebookGuid;
+            return false;
+        }
 
-            int * pLastUpdateCount = Q_NULLPTR;
-            if (!notebook.hasLinkedNotebookGuid())
-            {
-                pLastUpdateCount = &m_lastUpdateCount;
-                QNTRACE(QStringLiteral("Current note does not belong to linked notebook"));
-            }
-            else
-            {
-                QNTRACE(QStringLiteral("Current note belongs to linked notebook with guid ") << notebook.linkedNotebookGuid());
-
-                auto lit = m_lastUpdateCountByLinkedNotebookGuid.find(notebook.linkedNotebookGuid());
-                if (lit == m_lastUpdateCountByLinkedNotebookGuid.end()) {
-                    errorDescription.setBase(QT_TR_NOOP("Failed to find the update count per linked "
-                                                        "notebook guid on attempt to check the update "
-                                                        "count of a notebook sent to Evernote service"));
-                    Q_EMIT failure(errorDescription);
-                    return;
-                }
+        pLastUpdateCount = &lit.value();
+    }
 
-                pLastUpdateCount = &lit.value();
-            }
+    // The responses for the data items in flight can arrive in any order: the update sequence numbers which don't
+    // immediately follow the last update count are kept aside until the gap before them is filled
+    QSet<qint32> & pendingUsns = m_pendingSentUsnsByLinkedNotebookGuid[linkedNotebookGuid];
+    Q_UNUSED(pendingUsns.insert(updateSequenceNumber))
 
-            if (note.updateSequenceNumber() == *pLastUpdateCount + 1) {
-                *pLastUpdateCount = note.updateSequenceNumber();
-                QNTRACE(QStringLiteral("The client is in sync with the service; updated last update count to ") << *pLastUpdateCount);
-            }
-            else {
-                m_shouldRepeatIncrementalSync = true;
-                Q_EMIT shouldRepeatIncrementalSync();
-                QNTRACE(QStringLiteral("The client is not in sync with the service"));
-            }
-        }
+    while(pendingUsns.remove(*pLastUpdateCount + 1)) {
+        ++(*pLastUpdateCount);
+    }
+
+    if (pendingUsns.isEmpty()) {
+        QNTRACE(QStringLiteral("The client is in sync with the service; updated last update count to ") << *pLastUpdateCount);
+    }
+    else {
+        QNTRACE(QStringLiteral("Got ") << pendingUsns.size() << QStringLiteral(" update sequence numbers after the gap ")
+                << QStringLiteral("following the last update count ") << *pLastUpdateCount);
+    }
 
-        it = m_notes.erase(it);
+    return true;
+}
+
+void SendLocalChangesManager::checkAndFlushNotesPendingDirtyFlagRemoval()
+{
+    if (m_notesPendingDirtyFlagRemoval.isEmpty()) {
+        return;
     }
 
-    QNINFO(QStringLiteral("Sent all locally added/updated notes back to the Evernote service"));
+    if (!m_notesInFlightBySendRequestId.isEmpty() &&
+        (m_notesPendingDirtyFlagRemoval.size() < MAX_NOTES_PER_DIRTY_FLAG_REMOVING_UPDATE))
+    {
+        QNTRACE(QStringLiteral("Collected ") << m_notesPendingDirtyFlagRemoval.size()
+                << QStringLiteral(" sent notes pending the dirty flag removal so far"));
+        return;
+    }
 
-    // NOTE: as notes are sent the last, after sending them we must be done;
-    // the only possibly still pending transactions are those removing dirty flags
-    // from sent objects within the local storage
-    checkDirtyFlagRemovingUpdatesAndFinalize();
+    flushNotesPendingDirtyFlagRemoval();
+}
+
+void SendLocalChangesManager::flushNotesPendingDirtyFlagRemoval()
+{
+    if (m_notesPendingDirtyFlagRemoval.isEmpty()) {
+        return;
+    }
+
+    QList<Note> notes = m_notesPendingDirtyFlagRemoval;
+    m_notesPendingDirtyFlagRemoval.clear();
+
+    QUuid updateNotesRequestId = QUuid::createUuid();
+    Q_UNUSED(m_updateNotesRequestIds.insert(updateNotesRequestId))
+    QNTRACE(QStringLiteral("Emitting the request to update ") << notes.size()
+            << QStringLiteral(" notes (remove the dirty flag from them): request id = ") << updateNotesRequestId);
+    Q_EMIT updateNotes(notes, /* update resources = */ false, /* update tags = */ false, updateNotesRequestId);
+}
+
+void SendLocalChangesManager::onCreateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                                       ErrorString errorDescription, QUuid requestId)
+{
+    onSendTagAsyncFinished(errorCode, tag, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onUpdateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                                       ErrorString errorDescription, QUuid requestId)
+{
+    onSendTagAsyncFinished(errorCode, tag, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onCreateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                                               ErrorString errorDescription, QUuid requestId)
+{
+    onSendSavedSearchAsyncFinished(errorCode, savedSearch, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onUpdateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                                               ErrorString errorDescription, QUuid requestId)
+{
+    onSendSavedSearchAsyncFinished(errorCode, savedSearch, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onCreateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                                            ErrorString errorDescription, QUuid requestId)
+{
+    onSendNotebookAsyncFinished(errorCode, notebook, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onUpdateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                                            ErrorString errorDescription, QUuid requestId)
+{
+    onSendNotebookAsyncFinished(errorCode, notebook, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onCreateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                                        ErrorString errorDescription, QUuid requestId)
+{
+    onSendNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription, requestId);
+}
+
+void SendLocalChangesManager::onUpdateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                                        ErrorString errorDescription, QUuid requestId)
+{
+    onSendNoteAsyncFinished(errorCode, note, rateLimitSeconds, errorDescription, requestId);
 }
 
 void SendLocalChangesManager::findNotebooksForNotes()
@@ -2160,51 +2277,46 @@ void SendLocalChangesManager::findNotebooksForNotes()
         }
     }
 
-    if (!notebookGuids.isEmpty())
-    {
-        Notebook dummyNotebook;
-        dummyNotebook.unsetLocalUid();
-
-        for(auto it = notebookGuids.constBegin(), end = notebookGuids.constEnd(); it != end; ++it)
-        {
-            const QString & notebookGuid = *it;
-            dummyNotebook.setGuid(notebookGuid);
+    if (notebookGuids.isEmpty()) {
+        return;
+    }
 
-            QUuid requestId = QUuid::createUuid();
-            Q_EMIT findNotebook(dummyNotebook, requestId);
-            Q_UNUSED(m_findNotebookRequestIds.insert(requestId));
+    Notebook dummyNotebook;
+    dummyNotebook.unsetLocalUid();
 
-            QNTRACE(QStringLiteral("Sent find notebook request for notebook guid ") << notebookGuid << QStringLiteral(", request id = ") << requestId);
-        }
-    }
-    else
+    for(auto it = notebookGuids.constBegin(), end = notebookGuids.constEnd(); it != end; ++it)
     {
-        checkAndSendNotes();
-    }
-}
+        const QString & notebookGuid = *it;
+        dummyNotebook.setGuid(notebookGuid);
 
-bool SendLocalChangesManager::rateLimitIsActive() const
-{
-    return ( (m_sendTagsPostponeTimerId > 0) ||
-             (m_sendSavedSearchesPostponeTimerId > 0) ||
-             (m_sendNotebooksPostponeTimerId > 0) ||
-             (m_sendNotesPostponeTimerId > 0) );
+        QUuid requestId = QUuid::createUuid();
+        Q_UNUSED(m_findNotebookRequestIds.insert(requestId));
+        Q_EMIT findNotebook(dummyNotebook, requestId);
+
+        QNTRACE(QStringLiteral("Sent find notebook request for notebook guid ") << notebookGuid << QStringLiteral(", request id = ") << requestId);
+    }
 }
 
 void SendLocalChangesManager::checkSendLocalChangesAndDirtyFlagsRemovingUpdatesAndFinalize()
 {
     QNDEBUG(QStringLiteral("SendLocalChangesManager::checkSendLocalChangesAndDirtyFlagsRemovingUpdatesAndFinalize"));
 
-    if (m_tags.isEmpty() && m_savedSearches.isEmpty() && m_notebooks.isEmpty() && m_notes.isEmpty()) {
+    if (!hasDataItemsToSend()) {
         checkDirtyFlagRemovingUpdatesAndFinalize();
     }
-
 }
 
 void SendLocalChangesManager::checkDirtyFlagRemovingUpdatesAndFinalize()
 {
     QNDEBUG(QStringLiteral("SendLocalChangesManager::checkDirtyFlagRemovingUpdatesAndFinalize"));
 
+    if (!m_notesPendingDirtyFlagRemoval.isEmpty()) {
+        QNDEBUG(QStringLiteral("Still got ") << m_notesPendingDirtyFlagRemoval.size()
+                << QStringLiteral(" sent notes pending the dirty flag removal"));
+        flushNotesPendingDirtyFlagRemoval();
+        return;
+    }
+
     if (!m_updateTagRequestIds.isEmpty()) {
         QNDEBUG(QStringLiteral("Still pending ") << m_updateTagRequestIds.size()
                 << QStringLiteral(" update tag requests"));
@@ -2223,9 +2335,9 @@ void SendLocalChangesManager::checkDirtyFlagRemovingUpdatesAndFinalize()
         return;
     }
 
-    if (!m_updateNoteRequestIds.isEmpty()) {
-        QNDEBUG(QStringLiteral("Still pending ") << m_updateNoteRequestIds.size()
-                << QStringLiteral(" update note requests"));
+    if (!m_updateNotesRequestIds.isEmpty()) {
+        QNDEBUG(QStringLiteral("Still pending ") << m_updateNotesRequestIds.size()
+                << QStringLiteral(" update notes requests"));
         return;
     }
 
@@ -2239,11 +2351,51 @@ void SendLocalChangesManager::finalize()
             << m_lastUpdateCount << QStringLiteral(", last update count by linked notebook guid = ")
             << m_lastUpdateCountByLinkedNotebookGuid);
 
+    if (!m_shouldRepeatIncrementalSync)
+    {
+        // If some of the sent data items' update sequence numbers didn't fill the gaps after the last update count,
+        // someone else has modified the account in between and the client is not in sync with the service
+        for(auto it = m_pendingSentUsnsByLinkedNotebookGuid.constBegin(),
+            end = m_pendingSentUsnsByLinkedNotebookGuid.constEnd(); it != end; ++it)
+        {
+            if (it.value().isEmpty()) {
+                continue;
+            }
+
+            QNTRACE(QStringLiteral("The client is not in sync with the service: found non-consecutive update sequence numbers ")
+                    << QStringLiteral("of sent data items, linked notebook guid = ") << it.key());
+            m_shouldRepeatIncrementalSync = true;
+            Q_EMIT shouldRepeatIncrementalSync();
+            break;
+        }
+    }
+
     Q_EMIT finished(m_lastUpdateCount, m_lastUpdateCountByLinkedNotebookGuid);
     clear();
     m_active = false;
 }
 
+void SendLocalChangesManager::beginSyncTraceSpan(const QString & id)
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    tracer.beginSpan(SyncTracer::Phase::SendLocalChanges, id, QDateTime::currentMSecsSinceEpoch());
+}
+
+void SendLocalChangesManager::endSyncTraceSpan(const QString & id, const bool sent)
+{
+    SyncTracer & tracer = m_manager.syncTracer();
+    if (!tracer.isEnabled()) {
+        return;
+    }
+
+    Q_UNUSED(tracer.endSpan(SyncTracer::Phase::SendLocalChanges, id, QDateTime::currentMSecsSinceEpoch(),
+                            (sent ? 1 : 0)))
+}
+
 void SendLocalChangesManager::clear()
 {
     QNDEBUG(QStringLiteral("SendLocalChangesManager::clear"));
@@ -2274,6 +2426,18 @@ void SendLocalChangesManager::clear()
     m_notebooks.clear();
     m_notes.clear();
 
+    // NOTE: the responses for the data items still in flight would be ignored since their request ids are forgotten here
+    m_tagsInFlightBySendRequestId.clear();
+    m_savedSearchesInFlightBySendRequestId.clear();
+    m_notebooksInFlightBySendRequestId.clear();
+    m_notesInFlightBySendRequestId.clear();
+    m_pendingSentUsnsByLinkedNotebookGuid.clear();
+
+    m_tagGuidsByLocalUid.clear();
+    m_notebookGuidsByLocalUid.clear();
+    m_notesPreparedForSending = false;
+    m_notesPendingDirtyFlagRemoval.clear();
+
     m_linkedNotebookGuidsForWhichStuffWasRequestedFromLocalStorage.clear();
 
     m_linkedNotebookAuthData.clear();
@@ -2284,9 +2448,10 @@ void SendLocalChangesManager::clear()
     m_updateTagRequestIds.clear();
     m_updateSavedSearchRequestIds.clear();
     m_updateNotebookRequestIds.clear();
-    m_updateNoteRequestIds.clear();
+    m_updateNotesRequestIds.clear();
 
     m_findNotebookRequestIds.clear();
+    m_listResourceSyncedDataHashesRequestId = emptyId;
     m_notebooksByGuidsCache.clear();    // NOTE: don't get any ideas on preserving the cache, it can easily get stale
                                         // especially when disconnected from local storage
 
@@ -2297,25 +2462,10 @@ void SendLocalChangesManager::killAllTimers()
 {
     QNDEBUG(QStringLiteral("SendLocalChangesManager::killAllTimers"));
 
-    if (m_sendTagsPostponeTimerId > 0) {
-        killTimer(m_sendTagsPostponeTimerId);
-    }
-    m_sendTagsPostponeTimerId = 0;
-
-    if (m_sendSavedSearchesPostponeTimerId > 0) {
-        killTimer(m_sendSavedSearchesPostponeTimerId);
-    }
-    m_sendSavedSearchesPostponeTimerId = 0;
-
-    if (m_sendNotebooksPostponeTimerId > 0) {
-        killTimer(m_sendNotebooksPostponeTimerId);
-    }
-    m_sendNotebooksPostponeTimerId = 0;
-
-    if (m_sendNotesPostponeTimerId > 0) {
-        killTimer(m_sendNotesPostponeTimerId);
+    if (m_sendDataItemsPostponeTimerId > 0) {
+        killTimer(m_sendDataItemsPostponeTimerId);
     }
-    m_sendNotesPostponeTimerId = 0;
+    m_sendDataItemsPostponeTimerId = 0;
 }
 
 bool SendLocalChangesManager::checkAndRequestAuthenticationTokensForLinkedNotebooks()
@@ -19,8 +19,9 @@
 #ifndef LIB_QUENTIER_SYNCHRONIZATION_SEND_LOCAL_CHANGES_MANAGER_H
 #define LIB_QUENTIER_SYNCHRONIZATION_SEND_LOCAL_CHANGES_MANAGER_H
 
-#include "NoteStore.h"
 #include "SynchronizationShared.h"
+#include "SyncTracer.h"
+#include <quentier/synchronization/INoteStore.h>
 #include <quentier/utility/Macros.h>
 #include <quentier/types/ErrorString.h>
 #include <quentier/local_storage/LocalStorageManager.h>
@@ -29,6 +30,7 @@
 #include <quentier/types/Notebook.h>
 #include <quentier/types/Note.h>
 #include <QObject>
+#include <QStringList>
 
 namespace quentier {
 
@@ -42,8 +44,9 @@ public:
     {
     public:
         virtual LocalStorageManagerAsync & localStorageManagerAsync() = 0;
-        virtual NoteStore & noteStore() = 0;
-        virtual NoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) = 0;
+        virtual INoteStore & noteStore() = 0;
+        virtual INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) = 0;
+        virtual SyncTracer & syncTracer() = 0;
     };
 
     explicit SendLocalChangesManager(IManager & manager, QObject * parent = Q_NULLPTR);
@@ -110,10 +113,12 @@ Q_SIGNALS:
     void updateTag(Tag tag, QUuid requestId);
     void updateSavedSearch(SavedSearch savedSearch, QUuid requestId);
     void updateNotebook(Notebook notebook, QUuid requestId);
-    void updateNote(Note note, bool updateResources, bool updateTags, QUuid requestId);
+    void updateNotes(QList<Note> notes, bool updateResources, bool updateTags, QUuid requestId);
 
     void findNotebook(Notebook notebook, QUuid requestId);
 
+    void requestResourceSyncedDataHashes(QStringList noteLocalUids, QUuid requestId);
+
 private Q_SLOTS:
     void onListDirtyTagsCompleted(LocalStorageManager::ListObjectsOptions flag,
                                   size_t limit, size_t offset,
@@ -180,13 +185,37 @@ private Q_SLOTS:
     void onUpdateNotebookCompleted(Notebook notebook, QUuid requestId);
     void onUpdateNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
 
-    void onUpdateNoteCompleted(Note note, bool updateResources, bool updateTags, QUuid requestId);
-    void onUpdateNoteFailed(Note note, bool updateResources, bool updateTags,
-                            ErrorString errorDescription, QUuid requestId);
+    void onUpdateNotesCompleted(QList<Note> notes, bool updateResources, bool updateTags, QUuid requestId);
+    void onUpdateNotesFailed(QList<Note> notes, bool updateResources, bool updateTags,
+                             ErrorString errorDescription, QUuid requestId);
 
     void onFindNotebookCompleted(Notebook notebook, QUuid requestId);
     void onFindNotebookFailed(Notebook notebook, ErrorString errorDescription, QUuid requestId);
 
+    void onListResourceSyncedDataHashesCompleted(QStringList noteLocalUids, QHash<QString,QByteArray> dataHashesByResourceLocalUid,
+                                                 QUuid requestId);
+    void onListResourceSyncedDataHashesFailed(QStringList noteLocalUids, ErrorString errorDescription, QUuid requestId);
+
+    void onCreateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                  ErrorString errorDescription, QUuid requestId);
+    void onUpdateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                  ErrorString errorDescription, QUuid requestId);
+
+    void onCreateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                          ErrorString errorDescription, QUuid requestId);
+    void onUpdateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                          ErrorString errorDescription, QUuid requestId);
+
+    void onCreateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                       ErrorString errorDescription, QUuid requestId);
+    void onUpdateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                       ErrorString errorDescription, QUuid requestId);
+
+    void onCreateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                   ErrorString errorDescription, QUuid requestId);
+    void onUpdateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                   ErrorString errorDescription, QUuid requestId);
+
 private:
     virtual void timerEvent(QTimerEvent * pEvent);
 
@@ -198,17 +227,46 @@ private:
 
     void checkListLocalStorageObjectsCompletion();
 
+    void checkResourceSyncedDataHashesAndSendLocalChanges();
     void sendLocalChanges();
-    void sendTags();
-    void sendSavedSearches();
-    void sendNotebooks();
 
-    void checkAndSendNotes();
-    void sendNotes();
+    // Sends the queued data items while there's room for them within the in-flight window:
+    // tags level by level (parents first), then notebooks and saved searches, then notes
+    void sendDataItems();
+    int nextSendableTagIndex() const;
+    int numDataItemsInFlight() const;
+    bool hasDataItemsToSend() const;
 
-    void findNotebooksForNotes();
+    bool noteStoreForLinkedNotebookGuid(const QString & linkedNotebookGuid, INoteStore *& pNoteStore,
+                                        QString & linkedNotebookAuthToken, ErrorString & errorDescription);
+
+    bool sendTagAsync(const Tag & tag, ErrorString & errorDescription);
+    void onSendTagAsyncFinished(const qint32 errorCode, const Tag & tag, const qint32 rateLimitSeconds,
+                                const ErrorString & errorDescription, const QUuid & requestId);
+
+    bool sendSavedSearchAsync(const SavedSearch & search, ErrorString & errorDescription);
+    void onSendSavedSearchAsyncFinished(const qint32 errorCode, const SavedSearch & search, const qint32 rateLimitSeconds,
+                                        const ErrorString & errorDescription, const QUuid & requestId);
 
-    bool rateLimitIsActive() const;
+    bool sendNotebookAsync(const Notebook & notebook, ErrorString & errorDescription);
+    void onSendNotebookAsyncFinished(const qint32 errorCode, const Notebook & notebook, const qint32 rateLimitSeconds,
+                                     const ErrorString & errorDescription, const QUuid & requestId);
+
+    bool prepareNotesForSending();
+    bool sendNoteAsync(const Note & note, ErrorString & errorDescription);
+    void onSendNoteAsyncFinished(const qint32 errorCode, const Note & note, const qint32 rateLimitSeconds,
+                                 const ErrorString & errorDescription, const QUuid & requestId);
+
+    void handleSendDataItemError(const qint32 errorCode, const qint32 rateLimitSeconds,
+                                 const ErrorString & errorDescription, const QString & linkedNotebookGuid,
+                                 const ErrorString & errorBase);
+    bool checkUpdateCountInSync(const qint32 updateSequenceNumber, const QString & linkedNotebookGuid,
+                                ErrorString & errorDescription);
+
+    void checkAndFlushNotesPendingDirtyFlagRemoval();
+    void flushNotesPendingDirtyFlagRemoval();
+
+    void findNotebooksForNotes();
 
     void checkSendLocalChangesAndDirtyFlagsRemovingUpdatesAndFinalize();
     void checkDirtyFlagRemovingUpdatesAndFinalize();
@@ -220,6 +278,9 @@ private:
 
     void handleAuthExpiration();
 
+    void beginSyncTraceSpan(const QString & id);
+    void endSyncTraceSpan(const QString & id, const bool sent);
+
 private:
     class Q_DECL_HIDDEN CompareLinkedNotebookAuthDataByGuid
     {
@@ -264,6 +325,24 @@ private:
     QList<Notebook>                         m_notebooks;
     QList<Note>                             m_notes;
 
+    // Data items which have been sent to the service but for which the response hasn't arrived yet
+    QHash<QUuid,Tag>                        m_tagsInFlightBySendRequestId;
+    QHash<QUuid,SavedSearch>                m_savedSearchesInFlightBySendRequestId;
+    QHash<QUuid,Notebook>                   m_notebooksInFlightBySendRequestId;
+    QHash<QUuid,Note>                       m_notesInFlightBySendRequestId;
+
+    // Update sequence numbers of the sent data items which arrived out of order, i.e. while the responses
+    // for some items sent before them were still pending; the empty key corresponds to the user's own account
+    QHash<QString,QSet<qint32> >            m_pendingSentUsnsByLinkedNotebookGuid;
+
+    // Guids the sent tags and notebooks have got from the service, to be set to the notes referring to them
+    QHash<QString,QString>                  m_tagGuidsByLocalUid;
+    QHash<QString,QString>                  m_notebookGuidsByLocalUid;
+    bool                                    m_notesPreparedForSending;
+
+    // Sent notes for which the dirty flag is removed within the local storage in batches
+    QList<Note>                             m_notesPendingDirtyFlagRemoval;
+
     QSet<QString>                           m_linkedNotebookGuidsForWhichStuffWasRequestedFromLocalStorage;
 
     QVector<LinkedNotebookAuthData>         m_linkedNotebookAuthData;
@@ -275,15 +354,13 @@ private:
     QSet<QUuid>                             m_updateTagRequestIds;
     QSet<QUuid>                             m_updateSavedSearchRequestIds;
     QSet<QUuid>                             m_updateNotebookRequestIds;
-    QSet<QUuid>                             m_updateNoteRequestIds;
+    QSet<QUuid>                             m_updateNotesRequestIds;
 
     QSet<QUuid>                             m_findNotebookRequestIds;
+    QUuid                                   m_listResourceSyncedDataHashesRequestId;
     QHash<QString, Notebook>                m_notebooksByGuidsCache;
 
-    int                                     m_sendTagsPostponeTimerId;
-    int                                     m_sendSavedSearchesPostponeTimerId;
-    int                                     m_sendNotebooksPostponeTimerId;
-    int                                     m_sendNotesPostponeTimerId;
+    int                                     m_sendDataItemsPostponeTimerId;
 };
 
 } // namespace quentier
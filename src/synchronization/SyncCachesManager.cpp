@@ -0,0 +1,143 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncCachesManager.h"
+#include <quentier/logging/QuentierLogger.h>
+
+namespace quentier {
+
+SyncCachesManager::SyncCachesManager(LocalStorageManagerAsync & localStorageManagerAsync, QObject * parent) :
+    QObject(parent),
+    m_localStorageManagerAsync(localStorageManagerAsync),
+    m_notebookSyncCache(localStorageManagerAsync, QStringLiteral("")),
+    m_notebookSyncCachesByLinkedNotebookGuids(),
+    m_tagSyncCache(localStorageManagerAsync, QStringLiteral("")),
+    m_tagSyncCachesByLinkedNotebookGuids(),
+    m_noteSyncCache(localStorageManagerAsync, QStringLiteral("")),
+    m_noteSyncCachesByLinkedNotebookGuids(),
+    m_savedSearchSyncCache(localStorageManagerAsync)
+{}
+
+NotebookSyncCache & SyncCachesManager::notebookSyncCache(const QString & linkedNotebookGuid)
+{
+    if (linkedNotebookGuid.isEmpty()) {
+        return m_notebookSyncCache;
+    }
+
+    auto it = m_notebookSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
+    if (it == m_notebookSyncCachesByLinkedNotebookGuids.end()) {
+        QNDEBUG(QStringLiteral("Creating NotebookSyncCache for linked notebook guid ") << linkedNotebookGuid);
+        NotebookSyncCache * pCache = new NotebookSyncCache(m_localStorageManagerAsync, linkedNotebookGuid, this);
+        it = m_notebookSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pCache);
+    }
+
+    return *it.value();
+}
+
+TagSyncCache & SyncCachesManager::tagSyncCache(const QString & linkedNotebookGuid)
+{
+    if (linkedNotebookGuid.isEmpty()) {
+        return m_tagSyncCache;
+    }
+
+    auto it = m_tagSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
+    if (it == m_tagSyncCachesByLinkedNotebookGuids.end()) {
+        QNDEBUG(QStringLiteral("Creating TagSyncCache for linked notebook guid ") << linkedNotebookGuid);
+        TagSyncCache * pCache = new TagSyncCache(m_localStorageManagerAsync, linkedNotebookGuid, this);
+        it = m_tagSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pCache);
+    }
+
+    return *it.value();
+}
+
+NoteSyncCache & SyncCachesManager::noteSyncCache(const QString & linkedNotebookGuid)
+{
+    if (linkedNotebookGuid.isEmpty()) {
+        return m_noteSyncCache;
+    }
+
+    auto it = m_noteSyncCachesByLinkedNotebookGuids.find(linkedNotebookGuid);
+    if (it == m_noteSyncCachesByLinkedNotebookGuids.end()) {
+        QNDEBUG(QStringLiteral("Creating NoteSyncCache for linked notebook guid ") << linkedNotebookGuid);
+        NoteSyncCache * pCache = new NoteSyncCache(m_localStorageManagerAsync, linkedNotebookGuid, this);
+        it = m_noteSyncCachesByLinkedNotebookGuids.insert(linkedNotebookGuid, pCache);
+    }
+
+    return *it.value();
+}
+
+void SyncCachesManager::clear()
+{
+    QNDEBUG(QStringLiteral("SyncCachesManager::clear"));
+
+    m_notebookSyncCache.clear();
+    junkCaches(m_notebookSyncCachesByLinkedNotebookGuids);
+
+    m_tagSyncCache.clear();
+    junkCaches(m_tagSyncCachesByLinkedNotebookGuids);
+
+    m_noteSyncCache.clear();
+    junkCaches(m_noteSyncCachesByLinkedNotebookGuids);
+
+    m_savedSearchSyncCache.clear();
+}
+
+void SyncCachesManager::removeLinkedNotebookCaches(const QString & linkedNotebookGuid)
+{
+    QNDEBUG(QStringLiteral("SyncCachesManager::removeLinkedNotebookCaches: linked notebook guid = ") << linkedNotebookGuid);
+
+    junkCache(m_notebookSyncCachesByLinkedNotebookGuids, linkedNotebookGuid);
+    junkCache(m_tagSyncCachesByLinkedNotebookGuids, linkedNotebookGuid);
+    junkCache(m_noteSyncCachesByLinkedNotebookGuids, linkedNotebookGuid);
+}
+
+template <class T>
+void SyncCachesManager::junkCaches(QMap<QString, T*> & caches)
+{
+    for(auto it = caches.begin(), end = caches.end(); it != end; ++it)
+    {
+        T * pCache = it.value();
+        if (pCache) {
+            pCache->disconnect();
+            pCache->setParent(Q_NULLPTR);
+            pCache->deleteLater();
+        }
+    }
+
+    caches.clear();
+}
+
+template <class T>
+void SyncCachesManager::junkCache(QMap<QString, T*> & caches, const QString & linkedNotebookGuid)
+{
+    auto it = caches.find(linkedNotebookGuid);
+    if (it == caches.end()) {
+        return;
+    }
+
+    T * pCache = it.value();
+    if (pCache) {
+        pCache->disconnect();
+        pCache->setParent(Q_NULLPTR);
+        pCache->deleteLater();
+    }
+
+    Q_UNUSED(caches.erase(it))
+}
+
+} // namespace quentier
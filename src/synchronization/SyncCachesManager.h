@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SYNC_CACHES_MANAGER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SYNC_CACHES_MANAGER_H
+
+#include "NotebookSyncCache.h"
+#include "TagSyncCache.h"
+#include "SavedSearchSyncCache.h"
+#include "NoteSyncCache.h"
+#include <quentier/utility/Macros.h>
+#include <QObject>
+#include <QMap>
+
+namespace quentier {
+
+/**
+ * @brief The SyncCachesManager class owns the sync caches used within the single sync session:
+ * notebook, tag and note sync caches for the user's own account and for each linked notebook plus
+ * the saved search sync cache for the user's own account.
+ *
+ * The caches are created lazily on the first demand and shared by all their consumers (sync conflict resolvers,
+ * the check for inaccessible parent tags etc.). Each cache lists its data items from the local storage at most
+ * once per sync session and then keeps itself up to date by listening to the local storage's signals
+ * about the added, updated and expunged data items.
+ */
+class Q_DECL_HIDDEN SyncCachesManager: public QObject
+{
+    Q_OBJECT
+public:
+    explicit SyncCachesManager(LocalStorageManagerAsync & localStorageManagerAsync,
+                               QObject * parent = Q_NULLPTR);
+
+    /**
+     * @param linkedNotebookGuid - the guid of the linked notebook which notebooks the cache should contain;
+     * if empty, the cache of the user's own notebooks is returned
+     */
+    NotebookSyncCache & notebookSyncCache(const QString & linkedNotebookGuid = QString());
+
+    /**
+     * @param linkedNotebookGuid - the guid of the linked notebook which tags the cache should contain;
+     * if empty, the cache of the user's own tags is returned
+     */
+    TagSyncCache & tagSyncCache(const QString & linkedNotebookGuid = QString());
+
+    /**
+     * @param linkedNotebookGuid - the guid of the linked notebook which notes the cache should contain;
+     * if empty, the cache of the user's own notes is returned
+     */
+    NoteSyncCache & noteSyncCache(const QString & linkedNotebookGuid = QString());
+
+    SavedSearchSyncCache & savedSearchSyncCache() { return m_savedSearchSyncCache; }
+
+    /**
+     * Clears the caches for the user's own account and deletes the caches for all linked notebooks;
+     * intended to be called at the beginning and at the end of the sync session
+     */
+    void clear();
+
+    /**
+     * Deletes the caches corresponding to the specified linked notebook, intended to be called
+     * when the linked notebook is expunged
+     */
+    void removeLinkedNotebookCaches(const QString & linkedNotebookGuid);
+
+private:
+    template <class T>
+    void junkCaches(QMap<QString, T*> & caches);
+
+    template <class T>
+    void junkCache(QMap<QString, T*> & caches, const QString & linkedNotebookGuid);
+
+private:
+    LocalStorageManagerAsync &          m_localStorageManagerAsync;
+
+    NotebookSyncCache                   m_notebookSyncCache;
+    QMap<QString, NotebookSyncCache*>   m_notebookSyncCachesByLinkedNotebookGuids;
+
+    TagSyncCache                        m_tagSyncCache;
+    QMap<QString, TagSyncCache*>        m_tagSyncCachesByLinkedNotebookGuids;
+
+    NoteSyncCache                       m_noteSyncCache;
+    QMap<QString, NoteSyncCache*>       m_noteSyncCachesByLinkedNotebookGuids;
+
+    SavedSearchSyncCache                m_savedSearchSyncCache;
+
+private:
+    Q_DISABLE_COPY(SyncCachesManager)
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SYNC_CACHES_MANAGER_H
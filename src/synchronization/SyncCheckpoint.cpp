@@ -0,0 +1,283 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncCheckpoint.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDir>
+
+#define SYNC_CHECKPOINT_FILE_MAGIC (Q_UINT64_C(0x5153594e43434b50))
+#define SYNC_CHECKPOINT_FILE_FORMAT_VERSION (2)
+
+// The version of the checkpoint file format which has no full sync data
+#define SYNC_CHECKPOINT_FILE_FORMAT_VERSION_WITHOUT_FULL_SYNC (1)
+
+namespace quentier {
+
+SyncCheckpoint::SyncCheckpoint() :
+    m_processedNoteUsnsByGuid(),
+    m_processedResourceUsnsByGuid(),
+    m_fullSyncInProgress(false),
+    m_fullSyncAfterUsn(0),
+    m_fullSyncSyncedGuids(),
+    m_modified(false)
+{}
+
+bool SyncCheckpoint::isEmpty() const
+{
+    return !m_fullSyncInProgress && m_processedNoteUsnsByGuid.isEmpty() && m_processedResourceUsnsByGuid.isEmpty();
+}
+
+void SyncCheckpoint::setFullSyncInProgress(const qint32 afterUsn, const FullSyncStaleDataItemsExpunger::SyncedGuids & syncedGuids)
+{
+    if (m_fullSyncInProgress && (m_fullSyncAfterUsn == afterUsn) &&
+        (m_fullSyncSyncedGuids.m_syncedNotebookGuids == syncedGuids.m_syncedNotebookGuids) &&
+        (m_fullSyncSyncedGuids.m_syncedTagGuids == syncedGuids.m_syncedTagGuids) &&
+        (m_fullSyncSyncedGuids.m_syncedNoteGuids == syncedGuids.m_syncedNoteGuids) &&
+        (m_fullSyncSyncedGuids.m_syncedSavedSearchGuids == syncedGuids.m_syncedSavedSearchGuids))
+    {
+        return;
+    }
+
+    m_fullSyncInProgress = true;
+    m_fullSyncAfterUsn = afterUsn;
+    m_fullSyncSyncedGuids = syncedGuids;
+    m_modified = true;
+}
+
+void SyncCheckpoint::setNoteProcessed(const QString & guid, const qint32 usn)
+{
+    m_processedNoteUsnsByGuid[guid] = usn;
+    m_modified = true;
+}
+
+void SyncCheckpoint::setResourceProcessed(const QString & guid, const qint32 usn)
+{
+    m_processedResourceUsnsByGuid[guid] = usn;
+    m_modified = true;
+}
+
+bool SyncCheckpoint::isNoteProcessed(const QString & guid, const qint32 usn) const
+{
+    auto it = m_processedNoteUsnsByGuid.find(guid);
+    return ((it != m_processedNoteUsnsByGuid.end()) && (it.value() == usn));
+}
+
+bool SyncCheckpoint::isResourceProcessed(const QString & guid, const qint32 usn) const
+{
+    auto it = m_processedResourceUsnsByGuid.find(guid);
+    return ((it != m_processedResourceUsnsByGuid.end()) && (it.value() == usn));
+}
+
+void SyncCheckpoint::clear()
+{
+    m_processedNoteUsnsByGuid.clear();
+    m_processedResourceUsnsByGuid.clear();
+    m_fullSyncInProgress = false;
+    m_fullSyncAfterUsn = 0;
+    m_fullSyncSyncedGuids = FullSyncStaleDataItemsExpunger::SyncedGuids();
+    m_modified = false;
+}
+
+bool SyncCheckpoint::write(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncCheckpoint::write: ") << filePath << QStringLiteral(", num processed notes = ")
+            << m_processedNoteUsnsByGuid.size() << QStringLiteral(", num processed resources = ")
+            << m_processedResourceUsnsByGuid.size() << QStringLiteral(", full sync in progress = ")
+            << (m_fullSyncInProgress ? QStringLiteral("true") : QStringLiteral("false")));
+
+    QFileInfo fileInfo(filePath);
+    QString dirPath = fileInfo.absolutePath();
+    QDir dir(dirPath);
+    if (!dir.exists() && !dir.mkpath(dirPath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't create the directory for the sync checkpoint file"));
+        errorDescription.details() = QDir::toNativeSeparators(dirPath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QString tmpFilePath = filePath + QStringLiteral(".tmp");
+    QFile tmpFile(tmpFilePath);
+    if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't open the temporary sync checkpoint file for writing"));
+        errorDescription.details() = tmpFile.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QDataStream strm(&tmpFile);
+    strm.setVersion(QDataStream::Qt_4_8);
+    strm << static_cast<quint64>(SYNC_CHECKPOINT_FILE_MAGIC);
+    strm << static_cast<qint32>(SYNC_CHECKPOINT_FILE_FORMAT_VERSION);
+    strm << m_processedNoteUsnsByGuid;
+    strm << m_processedResourceUsnsByGuid;
+    strm << m_fullSyncInProgress;
+    strm << m_fullSyncAfterUsn;
+    strm << m_fullSyncSyncedGuids.m_syncedNotebookGuids;
+    strm << m_fullSyncSyncedGuids.m_syncedTagGuids;
+    strm << m_fullSyncSyncedGuids.m_syncedNoteGuids;
+    strm << m_fullSyncSyncedGuids.m_syncedSavedSearchGuids;
+
+    if (Q_UNLIKELY(strm.status() != QDataStream::Ok) || !tmpFile.flush()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the temporary sync checkpoint file"));
+        errorDescription.details() = tmpFile.errorString();
+        QNWARNING(errorDescription);
+        tmpFile.close();
+        Q_UNUSED(tmpFile.remove())
+        return false;
+    }
+
+    tmpFile.close();
+
+    // NOTE: QFile::rename doesn't overwrite the existing file
+    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't remove the previous sync checkpoint file"));
+        errorDescription.details() = QDir::toNativeSeparators(filePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (!QFile::rename(tmpFilePath, filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't rename the temporary sync checkpoint file"));
+        errorDescription.details() = QDir::toNativeSeparators(tmpFilePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    m_modified = false;
+    return true;
+}
+
+bool SyncCheckpoint::read(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncCheckpoint::read: ") << filePath);
+
+    clear();
+
+    QString actualFilePath = filePath;
+    if (!QFile::exists(actualFilePath))
+    {
+        // The crash might have happened right after the removal of the previous checkpoint file
+        // but before the temporary one was renamed
+        actualFilePath = filePath + QStringLiteral(".tmp");
+        if (!QFile::exists(actualFilePath)) {
+            QNDEBUG(QStringLiteral("No sync checkpoint file"));
+            return true;
+        }
+    }
+
+    QFile file(actualFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't open the sync checkpoint file for reading"));
+        errorDescription.details() = file.errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QDataStream strm(&file);
+    strm.setVersion(QDataStream::Qt_4_8);
+
+    quint64 magic = 0;
+    qint32 version = 0;
+    strm >> magic;
+    strm >> version;
+
+    if ((magic != SYNC_CHECKPOINT_FILE_MAGIC) ||
+        ((version != SYNC_CHECKPOINT_FILE_FORMAT_VERSION) && (version != SYNC_CHECKPOINT_FILE_FORMAT_VERSION_WITHOUT_FULL_SYNC)))
+    {
+        errorDescription.setBase(QT_TR_NOOP("The sync checkpoint file has unknown format"));
+        errorDescription.details() = QDir::toNativeSeparators(actualFilePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QHash<QString,qint32> processedNoteUsnsByGuid;
+    QHash<QString,qint32> processedResourceUsnsByGuid;
+    strm >> processedNoteUsnsByGuid;
+    strm >> processedResourceUsnsByGuid;
+
+    bool fullSyncInProgress = false;
+    qint32 fullSyncAfterUsn = 0;
+    FullSyncStaleDataItemsExpunger::SyncedGuids fullSyncSyncedGuids;
+    if (version != SYNC_CHECKPOINT_FILE_FORMAT_VERSION_WITHOUT_FULL_SYNC) {
+        strm >> fullSyncInProgress;
+        strm >> fullSyncAfterUsn;
+        strm >> fullSyncSyncedGuids.m_syncedNotebookGuids;
+        strm >> fullSyncSyncedGuids.m_syncedTagGuids;
+        strm >> fullSyncSyncedGuids.m_syncedNoteGuids;
+        strm >> fullSyncSyncedGuids.m_syncedSavedSearchGuids;
+    }
+
+    if (strm.status() != QDataStream::Ok) {
+        errorDescription.setBase(QT_TR_NOOP("The sync checkpoint file is corrupted"));
+        errorDescription.details() = QDir::toNativeSeparators(actualFilePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    m_processedNoteUsnsByGuid = processedNoteUsnsByGuid;
+    m_processedResourceUsnsByGuid = processedResourceUsnsByGuid;
+    m_fullSyncInProgress = fullSyncInProgress;
+    m_fullSyncAfterUsn = fullSyncAfterUsn;
+    m_fullSyncSyncedGuids = fullSyncSyncedGuids;
+    m_modified = false;
+
+    QNDEBUG(QStringLiteral("Read the sync checkpoint: ") << *this);
+    return true;
+}
+
+bool SyncCheckpoint::remove(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncCheckpoint::remove: ") << filePath);
+
+    QString tmpFilePath = filePath + QStringLiteral(".tmp");
+    if (QFile::exists(tmpFilePath)) {
+        Q_UNUSED(QFile::remove(tmpFilePath))
+    }
+
+    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't remove the sync checkpoint file"));
+        errorDescription.details() = QDir::toNativeSeparators(filePath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    return true;
+}
+
+QTextStream & SyncCheckpoint::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("SyncCheckpoint: num processed notes = ") << m_processedNoteUsnsByGuid.size()
+         << QStringLiteral(", num processed resources = ") << m_processedResourceUsnsByGuid.size()
+         << QStringLiteral(", full sync in progress = ") << (m_fullSyncInProgress ? QStringLiteral("true") : QStringLiteral("false"));
+
+    if (m_fullSyncInProgress) {
+        strm << QStringLiteral(", full sync after USN = ") << m_fullSyncAfterUsn
+             << QStringLiteral(", num full sync synced notebooks = ") << m_fullSyncSyncedGuids.m_syncedNotebookGuids.size()
+             << QStringLiteral(", tags = ") << m_fullSyncSyncedGuids.m_syncedTagGuids.size()
+             << QStringLiteral(", notes = ") << m_fullSyncSyncedGuids.m_syncedNoteGuids.size()
+             << QStringLiteral(", saved searches = ") << m_fullSyncSyncedGuids.m_syncedSavedSearchGuids.size();
+    }
+
+    strm << QStringLiteral(", modified = ") << (m_modified ? QStringLiteral("true") : QStringLiteral("false"));
+    return strm;
+}
+
+} // namespace quentier
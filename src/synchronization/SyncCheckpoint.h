@@ -0,0 +1,133 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHECKPOINT_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHECKPOINT_H
+
+#include "FullSyncStaleDataItemsExpunger.h"
+#include <quentier/types/ErrorString.h>
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+#include <QHash>
+
+namespace quentier {
+
+/**
+ * @brief The SyncCheckpoint class keeps track of notes and resources put into the local storage during the current
+ * synchronization and persists them to a file so that the synchronization interrupted by a crash, a network failure
+ * or by stopping it could be resumed without downloading these notes and resources once again
+ *
+ * The note or resource is considered processed only if it has the same update sequence number as the one recorded
+ * in the checkpoint: any change of the item on the remote side since the interrupted synchronization means the item
+ * needs to be synchronized as usual. The update counts from which the interrupted incremental synchronization should be
+ * resumed are not a part of the checkpoint, they are persisted along with the rest of last sync parameters.
+ *
+ * The full sync of user's own account is different: the last sync parameters must not be advanced until it's finished,
+ * otherwise the next synchronization would be the incremental one and the stale data items would never be expunged.
+ * So the checkpoint of the full sync carries the marker of the full sync in progress along with the update count
+ * after which the interrupted full sync should be resumed and the guids of data items listed within the sync chunks
+ * downloaded so far which the stale data items expunger needs once the full sync is over.
+ *
+ * The checkpoint file is replaced atomically: it is first written under a temporary name and then renamed,
+ * so the reader sees either the previous checkpoint or the new one but never a partially written one.
+ */
+class Q_DECL_HIDDEN SyncCheckpoint: public Printable
+{
+public:
+    SyncCheckpoint();
+
+    bool isEmpty() const;
+    int numProcessedNotes() const { return m_processedNoteUsnsByGuid.size(); }
+    int numProcessedResources() const { return m_processedResourceUsnsByGuid.size(); }
+
+    /**
+     * @return true if the checkpoint has changed since it was last written or read
+     */
+    bool isModified() const { return m_modified; }
+
+    /**
+     * @return true if the checkpoint belongs to the full sync of user's own account which hasn't finished yet
+     */
+    bool fullSyncInProgress() const { return m_fullSyncInProgress; }
+
+    /**
+     * @return the update count after which the interrupted full sync should resume downloading the sync chunks
+     */
+    qint32 fullSyncAfterUsn() const { return m_fullSyncAfterUsn; }
+
+    /**
+     * @return the guids of data items listed within the sync chunks downloaded during the full sync
+     */
+    const FullSyncStaleDataItemsExpunger::SyncedGuids & fullSyncSyncedGuids() const { return m_fullSyncSyncedGuids; }
+
+    /**
+     * @brief setFullSyncInProgress - marks the checkpoint as belonging to the full sync of user's own account
+     * which should be resumed after the given update count
+     */
+    void setFullSyncInProgress(const qint32 afterUsn, const FullSyncStaleDataItemsExpunger::SyncedGuids & syncedGuids);
+
+    void setNoteProcessed(const QString & guid, const qint32 usn);
+    void setResourceProcessed(const QString & guid, const qint32 usn);
+
+    /**
+     * @return true if the note with the given guid and update sequence number has already been put into
+     * the local storage, false otherwise
+     */
+    bool isNoteProcessed(const QString & guid, const qint32 usn) const;
+
+    /**
+     * @return true if the resource with the given guid and update sequence number has already been put into
+     * the local storage, false otherwise
+     */
+    bool isResourceProcessed(const QString & guid, const qint32 usn) const;
+
+    void clear();
+
+    /**
+     * @brief write - atomically replaces the checkpoint file with the current contents of the checkpoint
+     * @return true if the checkpoint was written successfully, false otherwise
+     */
+    bool write(const QString & filePath, ErrorString & errorDescription);
+
+    /**
+     * @brief read - replaces the contents of the checkpoint with the ones read from the checkpoint file;
+     * the missing checkpoint file is not an error, the checkpoint is just empty in this case
+     * @return true if the checkpoint was read successfully, false otherwise
+     */
+    bool read(const QString & filePath, ErrorString & errorDescription);
+
+    /**
+     * @brief remove - removes the checkpoint file, if any
+     * @return true if there's no checkpoint file after the call, false otherwise
+     */
+    static bool remove(const QString & filePath, ErrorString & errorDescription);
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+private:
+    QHash<QString,qint32>   m_processedNoteUsnsByGuid;
+    QHash<QString,qint32>   m_processedResourceUsnsByGuid;
+    bool                    m_fullSyncInProgress;
+    qint32                  m_fullSyncAfterUsn;
+    FullSyncStaleDataItemsExpunger::SyncedGuids     m_fullSyncSyncedGuids;
+    bool                    m_modified;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHECKPOINT_H
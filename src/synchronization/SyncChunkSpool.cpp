@@ -0,0 +1,987 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncChunkSpool.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <quentier/utility/StandardPaths.h>
+#include <QTemporaryFile>
+#include <QDataStream>
+#include <QDir>
+
+// The rough estimate of per data element memory overhead (qevercloud::Optional wrappers,
+// container nodes, implicitly shared data headers etc) on top of the size of its serialized representation
+#define SYNC_CHUNK_SPOOL_DATA_ELEMENT_MEMORY_OVERHEAD_BYTES (512)
+
+namespace quentier {
+
+// The spool format is private to the running process: each spooled sync chunk's notes and resources
+// are written using QDataStream, optional fields are prefixed with the "is set" flag, strings are written
+// as UTF-8 encoded byte arrays, enumerations are written as qint32
+
+static void writeValue(QDataStream & strm, const QString & value);
+static void writeValue(QDataStream & strm, const qevercloud::LazyMap & value);
+static void writeValue(QDataStream & strm, const qevercloud::ContactType::type & value);
+static void writeValue(QDataStream & strm, const qevercloud::SharedNotePrivilegeLevel::type & value);
+static void writeValue(QDataStream & strm, const qevercloud::Contact & value);
+static void writeValue(QDataStream & strm, const qevercloud::Identity & value);
+static void writeValue(QDataStream & strm, const qevercloud::SharedNote & value);
+static void writeValue(QDataStream & strm, const qevercloud::NoteRestrictions & value);
+static void writeValue(QDataStream & strm, const qevercloud::NoteLimits & value);
+static void writeValue(QDataStream & strm, const qevercloud::NoteAttributes & value);
+static void writeValue(QDataStream & strm, const qevercloud::Data & value);
+static void writeValue(QDataStream & strm, const qevercloud::ResourceAttributes & value);
+static void writeValue(QDataStream & strm, const qevercloud::Resource & value);
+static void writeValue(QDataStream & strm, const qevercloud::Note & value);
+
+static void readValue(QDataStream & strm, QString & value);
+static void readValue(QDataStream & strm, qevercloud::LazyMap & value);
+static void readValue(QDataStream & strm, qevercloud::ContactType::type & value);
+static void readValue(QDataStream & strm, qevercloud::SharedNotePrivilegeLevel::type & value);
+static void readValue(QDataStream & strm, qevercloud::Contact & value);
+static void readValue(QDataStream & strm, qevercloud::Identity & value);
+static void readValue(QDataStream & strm, qevercloud::SharedNote & value);
+static void readValue(QDataStream & strm, qevercloud::NoteRestrictions & value);
+static void readValue(QDataStream & strm, qevercloud::NoteLimits & value);
+static void readValue(QDataStream & strm, qevercloud::NoteAttributes & value);
+static void readValue(QDataStream & strm, qevercloud::Data & value);
+static void readValue(QDataStream & strm, qevercloud::ResourceAttributes & value);
+static void readValue(QDataStream & strm, qevercloud::Resource & value);
+static void readValue(QDataStream & strm, qevercloud::Note & value);
+
+template <class T>
+void writeValue(QDataStream & strm, const T & value)
+{
+    strm << value;
+}
+
+template <class T>
+void writeValue(QDataStream & strm, const QList<T> & values)
+{
+    strm << static_cast<qint32>(values.size());
+    for(auto it = values.constBegin(), end = values.constEnd(); it != end; ++it) {
+        writeValue(strm, *it);
+    }
+}
+
+template <class T>
+void writeOptional(QDataStream & strm, const qevercloud::Optional<T> & value)
+{
+    strm << value.isSet();
+    if (value.isSet()) {
+        writeValue(strm, value.ref());
+    }
+}
+
+template <class T>
+void readValue(QDataStream & strm, T & value)
+{
+    strm >> value;
+}
+
+template <class T>
+void readValue(QDataStream & strm, QList<T> & values)
+{
+    values.clear();
+
+    qint32 size = 0;
+    strm >> size;
+    if ((size < 0) || (strm.status() != QDataStream::Ok)) {
+        strm.setStatus(QDataStream::ReadCorruptData);
+        return;
+    }
+
+    values.reserve(size);
+    for(qint32 i = 0; i < size; ++i)
+    {
+        T value;
+        readValue(strm, value);
+        if (strm.status() != QDataStream::Ok) {
+            return;
+        }
+
+        values << value;
+    }
+}
+
+template <class T>
+void readOptional(QDataStream & strm, qevercloud::Optional<T> & value)
+{
+    value.clear();
+
+    bool isSet = false;
+    strm >> isSet;
+    if (!isSet) {
+        return;
+    }
+
+    T actualValue;
+    readValue(strm, actualValue);
+    value = actualValue;
+}
+
+void writeValue(QDataStream & strm, const QString & value)
+{
+    strm << value.toUtf8();
+}
+
+void writeValue(QDataStream & strm, const qevercloud::LazyMap & value)
+{
+    writeOptional(strm, value.keysOnly);
+    writeOptional(strm, value.fullMap);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::ContactType::type & value)
+{
+    strm << static_cast<qint32>(value);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::SharedNotePrivilegeLevel::type & value)
+{
+    strm << static_cast<qint32>(value);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::Contact & value)
+{
+    writeOptional(strm, value.name);
+    writeOptional(strm, value.id);
+    writeOptional(strm, value.type);
+    writeOptional(strm, value.photoUrl);
+    writeOptional(strm, value.photoLastUpdated);
+    writeOptional(strm, value.messagingPermit);
+    writeOptional(strm, value.messagingPermitExpires);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::Identity & value)
+{
+    strm << value.id;
+    writeOptional(strm, value.contact);
+    writeOptional(strm, value.userId);
+    writeOptional(strm, value.deactivated);
+    writeOptional(strm, value.sameBusiness);
+    writeOptional(strm, value.blocked);
+    writeOptional(strm, value.userConnected);
+    writeOptional(strm, value.eventId);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::SharedNote & value)
+{
+    writeOptional(strm, value.sharerUserID);
+    writeOptional(strm, value.recipientIdentity);
+    writeOptional(strm, value.privilege);
+    writeOptional(strm, value.serviceCreated);
+    writeOptional(strm, value.serviceUpdated);
+    writeOptional(strm, value.serviceAssigned);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::NoteRestrictions & value)
+{
+    writeOptional(strm, value.noUpdateTitle);
+    writeOptional(strm, value.noUpdateContent);
+    writeOptional(strm, value.noEmail);
+    writeOptional(strm, value.noShare);
+    writeOptional(strm, value.noSharePublicly);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::NoteLimits & value)
+{
+    writeOptional(strm, value.noteResourceCountMax);
+    writeOptional(strm, value.uploadLimit);
+    writeOptional(strm, value.resourceSizeMax);
+    writeOptional(strm, value.noteSizeMax);
+    writeOptional(strm, value.uploaded);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::NoteAttributes & value)
+{
+    writeOptional(strm, value.subjectDate);
+    writeOptional(strm, value.latitude);
+    writeOptional(strm, value.longitude);
+    writeOptional(strm, value.altitude);
+    writeOptional(strm, value.author);
+    writeOptional(strm, value.source);
+    writeOptional(strm, value.sourceURL);
+    writeOptional(strm, value.sourceApplication);
+    writeOptional(strm, value.shareDate);
+    writeOptional(strm, value.reminderOrder);
+    writeOptional(strm, value.reminderDoneTime);
+    writeOptional(strm, value.reminderTime);
+    writeOptional(strm, value.placeName);
+    writeOptional(strm, value.contentClass);
+    writeOptional(strm, value.applicationData);
+    writeOptional(strm, value.lastEditedBy);
+    writeOptional(strm, value.classifications);
+    writeOptional(strm, value.creatorId);
+    writeOptional(strm, value.lastEditorId);
+    writeOptional(strm, value.sharedWithBusiness);
+    writeOptional(strm, value.conflictSourceNoteGuid);
+    writeOptional(strm, value.noteTitleQuality);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::Data & value)
+{
+    writeOptional(strm, value.bodyHash);
+    writeOptional(strm, value.size);
+    writeOptional(strm, value.body);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::ResourceAttributes & value)
+{
+    writeOptional(strm, value.sourceURL);
+    writeOptional(strm, value.timestamp);
+    writeOptional(strm, value.latitude);
+    writeOptional(strm, value.longitude);
+    writeOptional(strm, value.altitude);
+    writeOptional(strm, value.cameraMake);
+    writeOptional(strm, value.cameraModel);
+    writeOptional(strm, value.clientWillIndex);
+    writeOptional(strm, value.recoType);
+    writeOptional(strm, value.fileName);
+    writeOptional(strm, value.attachment);
+    writeOptional(strm, value.applicationData);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::Resource & value)
+{
+    writeOptional(strm, value.guid);
+    writeOptional(strm, value.noteGuid);
+    writeOptional(strm, value.data);
+    writeOptional(strm, value.mime);
+    writeOptional(strm, value.width);
+    writeOptional(strm, value.height);
+    writeOptional(strm, value.duration);
+    writeOptional(strm, value.active);
+    writeOptional(strm, value.recognition);
+    writeOptional(strm, value.attributes);
+    writeOptional(strm, value.updateSequenceNum);
+    writeOptional(strm, value.alternateData);
+}
+
+void writeValue(QDataStream & strm, const qevercloud::Note & value)
+{
+    writeOptional(strm, value.guid);
+    writeOptional(strm, value.title);
+    writeOptional(strm, value.content);
+    writeOptional(strm, value.contentHash);
+    writeOptional(strm, value.contentLength);
+    writeOptional(strm, value.created);
+    writeOptional(strm, value.updated);
+    writeOptional(strm, value.deleted);
+    writeOptional(strm, value.active);
+    writeOptional(strm, value.updateSequenceNum);
+    writeOptional(strm, value.notebookGuid);
+    writeOptional(strm, value.tagGuids);
+    writeOptional(strm, value.resources);
+    writeOptional(strm, value.attributes);
+    writeOptional(strm, value.tagNames);
+    writeOptional(strm, value.sharedNotes);
+    writeOptional(strm, value.restrictions);
+    writeOptional(strm, value.limits);
+}
+
+void readValue(QDataStream & strm, QString & value)
+{
+    QByteArray utf8;
+    strm >> utf8;
+    value = QString::fromUtf8(utf8);
+}
+
+void readValue(QDataStream & strm, qevercloud::LazyMap & value)
+{
+    readOptional(strm, value.keysOnly);
+    readOptional(strm, value.fullMap);
+}
+
+void readValue(QDataStream & strm, qevercloud::ContactType::type & value)
+{
+    qint32 rawValue = 0;
+    strm >> rawValue;
+    value = static_cast<qevercloud::ContactType::type>(rawValue);
+}
+
+void readValue(QDataStream & strm, qevercloud::SharedNotePrivilegeLevel::type & value)
+{
+    qint32 rawValue = 0;
+    strm >> rawValue;
+    value = static_cast<qevercloud::SharedNotePrivilegeLevel::type>(rawValue);
+}
+
+void readValue(QDataStream & strm, qevercloud::Contact & value)
+{
+    readOptional(strm, value.name);
+    readOptional(strm, value.id);
+    readOptional(strm, value.type);
+    readOptional(strm, value.photoUrl);
+    readOptional(strm, value.photoLastUpdated);
+    readOptional(strm, value.messagingPermit);
+    readOptional(strm, value.messagingPermitExpires);
+}
+
+void readValue(QDataStream & strm, qevercloud::Identity & value)
+{
+    strm >> value.id;
+    readOptional(strm, value.contact);
+    readOptional(strm, value.userId);
+    readOptional(strm, value.deactivated);
+    readOptional(strm, value.sameBusiness);
+    readOptional(strm, value.blocked);
+    readOptional(strm, value.userConnected);
+    readOptional(strm, value.eventId);
+}
+
+void readValue(QDataStream & strm, qevercloud::SharedNote & value)
+{
+    readOptional(strm, value.sharerUserID);
+    readOptional(strm, value.recipientIdentity);
+    readOptional(strm, value.privilege);
+    readOptional(strm, value.serviceCreated);
+    readOptional(strm, value.serviceUpdated);
+    readOptional(strm, value.serviceAssigned);
+}
+
+void readValue(QDataStream & strm, qevercloud::NoteRestrictions & value)
+{
+    readOptional(strm, value.noUpdateTitle);
+    readOptional(strm, value.noUpdateContent);
+    readOptional(strm, value.noEmail);
+    readOptional(strm, value.noShare);
+    readOptional(strm, value.noSharePublicly);
+}
+
+void readValue(QDataStream & strm, qevercloud::NoteLimits & value)
+{
+    readOptional(strm, value.noteResourceCountMax);
+    readOptional(strm, value.uploadLimit);
+    readOptional(strm, value.resourceSizeMax);
+    readOptional(strm, value.noteSizeMax);
+    readOptional(strm, value.uploaded);
+}
+
+void readValue(QDataStream & strm, qevercloud::NoteAttributes & value)
+{
+    readOptional(strm, value.subjectDate);
+    readOptional(strm, value.latitude);
+    readOptional(strm, value.longitude);
+    readOptional(strm, value.altitude);
+    readOptional(strm, value.author);
+    readOptional(strm, value.source);
+    readOptional(strm, value.sourceURL);
+    readOptional(strm, value.sourceApplication);
+    readOptional(strm, value.shareDate);
+    readOptional(strm, value.reminderOrder);
+    readOptional(strm, value.reminderDoneTime);
+    readOptional(strm, value.reminderTime);
+    readOptional(strm, value.placeName);
+    readOptional(strm, value.contentClass);
+    readOptional(strm, value.applicationData);
+    readOptional(strm, value.lastEditedBy);
+    readOptional(strm, value.classifications);
+    readOptional(strm, value.creatorId);
+    readOptional(strm, value.lastEditorId);
+    readOptional(strm, value.sharedWithBusiness);
+    readOptional(strm, value.conflictSourceNoteGuid);
+    readOptional(strm, value.noteTitleQuality);
+}
+
+void readValue(QDataStream & strm, qevercloud::Data & value)
+{
+    readOptional(strm, value.bodyHash);
+    readOptional(strm, value.size);
+    readOptional(strm, value.body);
+}
+
+void readValue(QDataStream & strm, qevercloud::ResourceAttributes & value)
+{
+    readOptional(strm, value.sourceURL);
+    readOptional(strm, value.timestamp);
+    readOptional(strm, value.latitude);
+    readOptional(strm, value.longitude);
+    readOptional(strm, value.altitude);
+    readOptional(strm, value.cameraMake);
+    readOptional(strm, value.cameraModel);
+    readOptional(strm, value.clientWillIndex);
+    readOptional(strm, value.recoType);
+    readOptional(strm, value.fileName);
+    readOptional(strm, value.attachment);
+    readOptional(strm, value.applicationData);
+}
+
+void readValue(QDataStream & strm, qevercloud::Resource & value)
+{
+    readOptional(strm, value.guid);
+    readOptional(strm, value.noteGuid);
+    readOptional(strm, value.data);
+    readOptional(strm, value.mime);
+    readOptional(strm, value.width);
+    readOptional(strm, value.height);
+    readOptional(strm, value.duration);
+    readOptional(strm, value.active);
+    readOptional(strm, value.recognition);
+    readOptional(strm, value.attributes);
+    readOptional(strm, value.updateSequenceNum);
+    readOptional(strm, value.alternateData);
+}
+
+void readValue(QDataStream & strm, qevercloud::Note & value)
+{
+    readOptional(strm, value.guid);
+    readOptional(strm, value.title);
+    readOptional(strm, value.content);
+    readOptional(strm, value.contentHash);
+    readOptional(strm, value.contentLength);
+    readOptional(strm, value.created);
+    readOptional(strm, value.updated);
+    readOptional(strm, value.deleted);
+    readOptional(strm, value.active);
+    readOptional(strm, value.updateSequenceNum);
+    readOptional(strm, value.notebookGuid);
+    readOptional(strm, value.tagGuids);
+    readOptional(strm, value.resources);
+    readOptional(strm, value.attributes);
+    readOptional(strm, value.tagNames);
+    readOptional(strm, value.sharedNotes);
+    readOptional(strm, value.restrictions);
+    readOptional(strm, value.limits);
+}
+
+SyncChunkSpool::SyncChunkSpool() :
+    m_memoryLimitBytes(0),
+    m_syncChunks(),
+    m_spoolEntries(),
+    m_pSpoolFile(),
+    m_statistics()
+{}
+
+SyncChunkSpool::~SyncChunkSpool()
+{}
+
+void SyncChunkSpool::setMemoryLimit(const qint64 memoryLimitBytes)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::setMemoryLimit: ") << memoryLimitBytes);
+    m_memoryLimitBytes = memoryLimitBytes;
+}
+
+bool SyncChunkSpool::append(const qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::append: chunk high USN = ")
+            << (syncChunk.chunkHighUSN.isSet() ? QString::number(syncChunk.chunkHighUSN.ref()) : QStringLiteral("<not set>")));
+
+    SpoolEntry entry;
+
+    int numNotes = 0;
+    if (syncChunk.notes.isSet())
+    {
+        const QList<qevercloud::Note> & notes = syncChunk.notes.ref();
+        numNotes = notes.size();
+        for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                entry.m_noteGuids << it->guid.ref();
+            }
+
+            if (it->updateSequenceNum.isSet() &&
+                ((entry.m_notesSmallestUsn < 0) || (it->updateSequenceNum.ref() < entry.m_notesSmallestUsn)))
+            {
+                entry.m_notesSmallestUsn = it->updateSequenceNum.ref();
+            }
+        }
+    }
+
+    int numResources = 0;
+    if (syncChunk.resources.isSet())
+    {
+        const QList<qevercloud::Resource> & resources = syncChunk.resources.ref();
+        numResources = resources.size();
+        for(auto it = resources.constBegin(), end = resources.constEnd(); it != end; ++it)
+        {
+            if (it->guid.isSet()) {
+                entry.m_resourceGuids << it->guid.ref();
+            }
+
+            if (it->updateSequenceNum.isSet() &&
+                ((entry.m_resourcesSmallestUsn < 0) || (it->updateSequenceNum.ref() < entry.m_resourcesSmallestUsn)))
+            {
+                entry.m_resourcesSmallestUsn = it->updateSequenceNum.ref();
+            }
+        }
+    }
+
+    int numDataElements = numNotes + numResources;
+
+    QByteArray buffer;
+    QDataStream strm(&buffer, QIODevice::WriteOnly);
+    writeOptional(strm, syncChunk.notes);
+    entry.m_notesSize = buffer.size();
+    writeOptional(strm, syncChunk.resources);
+
+    entry.m_notesMemoryUsageBytes = entry.m_notesSize +
+                                    static_cast<qint64>(numNotes) * SYNC_CHUNK_SPOOL_DATA_ELEMENT_MEMORY_OVERHEAD_BYTES;
+    entry.m_resourcesMemoryUsageBytes = (buffer.size() - entry.m_notesSize) +
+                                        static_cast<qint64>(numResources) * SYNC_CHUNK_SPOOL_DATA_ELEMENT_MEMORY_OVERHEAD_BYTES;
+    qint64 estimatedMemoryUsageBytes = entry.m_notesMemoryUsageBytes + entry.m_resourcesMemoryUsageBytes;
+
+    bool shouldSpool = (m_memoryLimitBytes > 0) && (numDataElements > 0) &&
+                       ((m_statistics.m_memoryUsageBytes + estimatedMemoryUsageBytes) > m_memoryLimitBytes);
+    if (!shouldSpool)
+    {
+        m_syncChunks.push_back(syncChunk);
+        m_spoolEntries.push_back(entry);
+        ++m_statistics.m_numSyncChunks;
+        m_statistics.m_memoryUsageBytes += estimatedMemoryUsageBytes;
+        updatePeakMemoryUsage(0);
+        return true;
+    }
+
+    if (!openSpoolFile(errorDescription)) {
+        return false;
+    }
+
+    qint64 offset = m_pSpoolFile->size();
+    if (!m_pSpoolFile->seek(offset)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't seek to the end of the sync chunks spool file"));
+        errorDescription.details() = m_pSpoolFile->errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    qint64 bytesWritten = m_pSpoolFile->write(buffer);
+    if (bytesWritten != static_cast<qint64>(buffer.size())) {
+        errorDescription.setBase(QT_TR_NOOP("Can't write the sync chunk to the spool file"));
+        errorDescription.details() = m_pSpoolFile->errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    entry.m_offset = offset;
+    entry.m_size = bytesWritten;
+
+    qevercloud::SyncChunk strippedSyncChunk = syncChunk;
+    strippedSyncChunk.notes.clear();
+    strippedSyncChunk.resources.clear();
+
+    m_syncChunks.push_back(strippedSyncChunk);
+    m_spoolEntries.push_back(entry);
+
+    ++m_statistics.m_numSyncChunks;
+    ++m_statistics.m_numSpooledSyncChunks;
+    m_statistics.m_spooledBytes += bytesWritten;
+
+    QNDEBUG(QStringLiteral("Spooled ") << numDataElements << QStringLiteral(" notes and resources (")
+            << bytesWritten << QStringLiteral(" bytes) to the sync chunks spool file"));
+    return true;
+}
+
+bool SyncChunkSpool::isSpooled(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return false;
+    }
+
+    return (m_spoolEntries[index].m_offset >= 0);
+}
+
+qint64 SyncChunkSpool::estimatedMemoryUsage(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return 0;
+    }
+
+    const SpoolEntry & entry = m_spoolEntries[index];
+    return entry.m_notesMemoryUsageBytes + entry.m_resourcesMemoryUsageBytes;
+}
+
+QStringList SyncChunkSpool::noteGuids(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return QStringList();
+    }
+
+    return m_spoolEntries[index].m_noteGuids;
+}
+
+QStringList SyncChunkSpool::resourceGuids(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return QStringList();
+    }
+
+    return m_spoolEntries[index].m_resourceGuids;
+}
+
+qint32 SyncChunkSpool::notesSmallestUsn(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return -1;
+    }
+
+    return m_spoolEntries[index].m_notesSmallestUsn;
+}
+
+qint32 SyncChunkSpool::resourcesSmallestUsn(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return -1;
+    }
+
+    return m_spoolEntries[index].m_resourcesSmallestUsn;
+}
+
+bool SyncChunkSpool::read(const int index, qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_syncChunks.size()))) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: attempt to read the sync chunk with invalid index from the spool"));
+        errorDescription.details() = QString::number(index);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    syncChunk = m_syncChunks[index];
+
+    const SpoolEntry & entry = m_spoolEntries[index];
+    if (entry.m_offset < 0) {
+        return true;
+    }
+
+    bool shouldReadNotes = (entry.m_notesTakeState == TakeState::Stored);
+    bool shouldReadResources = (entry.m_resourcesTakeState == TakeState::Stored);
+    if (!shouldReadNotes && !shouldReadResources) {
+        return true;
+    }
+
+    QByteArray buffer;
+    if (!readSpoolFile(entry.m_offset, entry.m_size, buffer, errorDescription)) {
+        return false;
+    }
+
+    qevercloud::Optional<QList<qevercloud::Note> > notes;
+    qevercloud::Optional<QList<qevercloud::Resource> > resources;
+
+    QDataStream strm(buffer);
+    readOptional(strm, notes);
+    readOptional(strm, resources);
+
+    if (strm.status() != QDataStream::Ok) {
+        errorDescription.setBase(QT_TR_NOOP("The spooled sync chunk is corrupted"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    qint64 readMemoryUsageBytes = 0;
+
+    if (shouldReadNotes) {
+        syncChunk.notes = notes;
+        readMemoryUsageBytes += entry.m_notesMemoryUsageBytes;
+    }
+
+    if (shouldReadResources) {
+        syncChunk.resources = resources;
+        readMemoryUsageBytes += entry.m_resourcesMemoryUsageBytes;
+    }
+
+    ++m_statistics.m_numSpoolReads;
+    updatePeakMemoryUsage(readMemoryUsageBytes);
+    return true;
+}
+
+bool SyncChunkSpool::takeNotes(const int index, QList<qevercloud::Note> & notes, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::takeNotes: index = ") << index);
+
+    notes.clear();
+
+    if (Q_UNLIKELY((index < 0) || (index >= m_syncChunks.size()))) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: attempt to take the notes of the sync chunk with invalid index from the spool"));
+        errorDescription.details() = QString::number(index);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    SpoolEntry & entry = m_spoolEntries[index];
+    if (Q_UNLIKELY(entry.m_notesTakeState != TakeState::Stored)) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: the notes of the sync chunk have already been taken from the spool"));
+        errorDescription.details() = QString::number(index);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (entry.m_offset < 0)
+    {
+        // NOTE: the memory occupied by the notes has been accounted since the sync chunk was appended
+        // and remains accounted until the notes are released
+        qevercloud::SyncChunk & syncChunk = m_syncChunks[index];
+        if (syncChunk.notes.isSet()) {
+            notes = syncChunk.notes.ref();
+            syncChunk.notes.clear();
+        }
+
+        entry.m_notesTakeState = TakeState::Taken;
+        return true;
+    }
+
+    QByteArray buffer;
+    if (!readSpoolFile(entry.m_offset, entry.m_notesSize, buffer, errorDescription)) {
+        return false;
+    }
+
+    qevercloud::Optional<QList<qevercloud::Note> > spooledNotes;
+
+    QDataStream strm(buffer);
+    readOptional(strm, spooledNotes);
+
+    if (strm.status() != QDataStream::Ok) {
+        errorDescription.setBase(QT_TR_NOOP("The spooled sync chunk is corrupted"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (spooledNotes.isSet()) {
+        notes = spooledNotes.ref();
+    }
+
+    entry.m_notesTakeState = TakeState::Taken;
+
+    ++m_statistics.m_numSpoolReads;
+    m_statistics.m_memoryUsageBytes += entry.m_notesMemoryUsageBytes;
+    updatePeakMemoryUsage(0);
+    return true;
+}
+
+bool SyncChunkSpool::takeResources(const int index, QList<qevercloud::Resource> & resources, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::takeResources: index = ") << index);
+
+    resources.clear();
+
+    if (Q_UNLIKELY((index < 0) || (index >= m_syncChunks.size()))) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: attempt to take the resources of the sync chunk with invalid index from the spool"));
+        errorDescription.details() = QString::number(index);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    SpoolEntry & entry = m_spoolEntries[index];
+    if (Q_UNLIKELY(entry.m_resourcesTakeState != TakeState::Stored)) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: the resources of the sync chunk have already been taken from the spool"));
+        errorDescription.details() = QString::number(index);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (entry.m_offset < 0)
+    {
+        qevercloud::SyncChunk & syncChunk = m_syncChunks[index];
+        if (syncChunk.resources.isSet()) {
+            resources = syncChunk.resources.ref();
+            syncChunk.resources.clear();
+        }
+
+        entry.m_resourcesTakeState = TakeState::Taken;
+        return true;
+    }
+
+    QByteArray buffer;
+    if (!readSpoolFile(entry.m_offset + entry.m_notesSize, entry.m_size - entry.m_notesSize, buffer, errorDescription)) {
+        return false;
+    }
+
+    qevercloud::Optional<QList<qevercloud::Resource> > spooledResources;
+
+    QDataStream strm(buffer);
+    readOptional(strm, spooledResources);
+
+    if (strm.status() != QDataStream::Ok) {
+        errorDescription.setBase(QT_TR_NOOP("The spooled sync chunk is corrupted"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (spooledResources.isSet()) {
+        resources = spooledResources.ref();
+    }
+
+    entry.m_resourcesTakeState = TakeState::Taken;
+
+    ++m_statistics.m_numSpoolReads;
+    m_statistics.m_memoryUsageBytes += entry.m_resourcesMemoryUsageBytes;
+    updatePeakMemoryUsage(0);
+    return true;
+}
+
+bool SyncChunkSpool::notesTaken(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return false;
+    }
+
+    return (m_spoolEntries[index].m_notesTakeState != TakeState::Stored);
+}
+
+bool SyncChunkSpool::resourcesTaken(const int index) const
+{
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        return false;
+    }
+
+    return (m_spoolEntries[index].m_resourcesTakeState != TakeState::Stored);
+}
+
+void SyncChunkSpool::releaseNotes(const int index)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::releaseNotes: index = ") << index);
+
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        QNWARNING(QStringLiteral("Attempt to release the notes of the sync chunk with invalid index: ") << index);
+        return;
+    }
+
+    SpoolEntry & entry = m_spoolEntries[index];
+    if (Q_UNLIKELY(entry.m_notesTakeState != TakeState::Taken)) {
+        QNWARNING(QStringLiteral("Attempt to release the notes of the sync chunk which are not taken from the spool: ") << index);
+        return;
+    }
+
+    entry.m_notesTakeState = TakeState::Released;
+    m_statistics.m_memoryUsageBytes -= entry.m_notesMemoryUsageBytes;
+}
+
+void SyncChunkSpool::releaseResources(const int index)
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::releaseResources: index = ") << index);
+
+    if (Q_UNLIKELY((index < 0) || (index >= m_spoolEntries.size()))) {
+        QNWARNING(QStringLiteral("Attempt to release the resources of the sync chunk with invalid index: ") << index);
+        return;
+    }
+
+    SpoolEntry & entry = m_spoolEntries[index];
+    if (Q_UNLIKELY(entry.m_resourcesTakeState != TakeState::Taken)) {
+        QNWARNING(QStringLiteral("Attempt to release the resources of the sync chunk which are not taken from the spool: ") << index);
+        return;
+    }
+
+    entry.m_resourcesTakeState = TakeState::Released;
+    m_statistics.m_memoryUsageBytes -= entry.m_resourcesMemoryUsageBytes;
+}
+
+void SyncChunkSpool::clear()
+{
+    QNDEBUG(QStringLiteral("SyncChunkSpool::clear"));
+
+    m_syncChunks.clear();
+    m_spoolEntries.clear();
+    m_pSpoolFile.reset();
+    m_statistics = Statistics();
+}
+
+bool SyncChunkSpool::openSpoolFile(ErrorString & errorDescription)
+{
+    if (!m_pSpoolFile.isNull()) {
+        return true;
+    }
+
+    QString spoolDirPath = applicationTemporaryStoragePath();
+    QDir spoolDir(spoolDirPath);
+    if (!spoolDir.exists() && !spoolDir.mkpath(QStringLiteral("."))) {
+        errorDescription.setBase(QT_TR_NOOP("Can't create the directory for the sync chunks spool file"));
+        errorDescription.details() = QDir::toNativeSeparators(spoolDirPath);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QScopedPointer<QTemporaryFile> pSpoolFile(new QTemporaryFile(spoolDir.absoluteFilePath(QStringLiteral("sync_chunks_XXXXXX.spool"))));
+    if (!pSpoolFile->open()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't open the sync chunks spool file"));
+        errorDescription.details() = pSpoolFile->errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QNDEBUG(QStringLiteral("Opened the sync chunks spool file: ") << pSpoolFile->fileName());
+    m_pSpoolFile.reset(pSpoolFile.take());
+    return true;
+}
+
+bool SyncChunkSpool::readSpoolFile(const qint64 offset, const qint64 size, QByteArray & buffer,
+                                   ErrorString & errorDescription) const
+{
+    if (Q_UNLIKELY(m_pSpoolFile.isNull())) {
+        errorDescription.setBase(QT_TR_NOOP("Internal error: the sync chunk was spooled but the spool file is missing"));
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    if (!m_pSpoolFile->seek(offset)) {
+        errorDescription.setBase(QT_TR_NOOP("Can't seek to the spooled sync chunk within the spool file"));
+        errorDescription.details() = m_pSpoolFile->errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    buffer = m_pSpoolFile->read(size);
+    if (buffer.size() != size) {
+        errorDescription.setBase(QT_TR_NOOP("Can't read the spooled sync chunk from the spool file"));
+        errorDescription.details() = m_pSpoolFile->errorString();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    return true;
+}
+
+void SyncChunkSpool::updatePeakMemoryUsage(const qint64 additionalMemoryUsageBytes) const
+{
+    qint64 memoryUsageBytes = m_statistics.m_memoryUsageBytes + additionalMemoryUsageBytes;
+    if (memoryUsageBytes > m_statistics.m_peakMemoryUsageBytes) {
+        m_statistics.m_peakMemoryUsageBytes = memoryUsageBytes;
+    }
+}
+
+SyncChunkSpool::SpoolEntry::SpoolEntry() :
+    m_offset(-1),
+    m_size(0),
+    m_notesSize(0),
+    m_notesMemoryUsageBytes(0),
+    m_resourcesMemoryUsageBytes(0),
+    m_noteGuids(),
+    m_resourceGuids(),
+    m_notesSmallestUsn(-1),
+    m_resourcesSmallestUsn(-1),
+    m_notesTakeState(TakeState::Stored),
+    m_resourcesTakeState(TakeState::Stored)
+{}
+
+SyncChunkSpool::Statistics::Statistics() :
+    m_numSyncChunks(0),
+    m_numSpooledSyncChunks(0),
+    m_memoryUsageBytes(0),
+    m_peakMemoryUsageBytes(0),
+    m_spooledBytes(0),
+    m_numSpoolReads(0)
+{}
+
+QTextStream & SyncChunkSpool::Statistics::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("SyncChunkSpool::Statistics: num sync chunks = ") << m_numSyncChunks
+         << QStringLiteral(", num spooled sync chunks = ") << m_numSpooledSyncChunks
+         << QStringLiteral(", estimated memory usage = ") << m_memoryUsageBytes
+         << QStringLiteral(" bytes, estimated peak memory usage = ") << m_peakMemoryUsageBytes
+         << QStringLiteral(" bytes, spooled bytes = ") << m_spooledBytes
+         << QStringLiteral(", num spool reads = ") << m_numSpoolReads;
+    return strm;
+}
+
+} // namespace quentier
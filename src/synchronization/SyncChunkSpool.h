@@ -0,0 +1,219 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_SPOOL_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_SPOOL_H
+
+#include <quentier/types/ErrorString.h>
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <qt5qevercloud/QEverCloud.h>
+#else
+#include <qt4qevercloud/QEverCloud.h>
+#endif
+
+#include <QVector>
+#include <QStringList>
+#include <QScopedPointer>
+
+QT_FORWARD_DECLARE_CLASS(QTemporaryFile)
+
+namespace quentier {
+
+/**
+ * @brief The SyncChunkSpool class stores the sync chunks downloaded during the synchronization
+ * while keeping the estimated amount of memory occupied by them under the configurable limit
+ *
+ * Notes and resources are by far the largest part of sync chunks. Once the estimated memory footprint
+ * of the stored sync chunks reaches the limit, notes and resources of each subsequently appended sync chunk
+ * are serialized into the temporary spool file and removed from the in-memory copy of the sync chunk; they are read
+ * back from the spool file only when the full sync chunk is requested. The rest of each sync chunk's data
+ * as well as the guids of its notes and resources are small and are always kept in memory.
+ *
+ * The notes and resources of each sync chunk are meant to be taken from the spool for processing once and then
+ * released when their processing is over: the memory occupied by the taken notes and resources is accounted
+ * in the statistics until they are released.
+ */
+class Q_DECL_HIDDEN SyncChunkSpool
+{
+public:
+    struct Statistics: public Printable
+    {
+        Statistics();
+
+        virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+        int         m_numSyncChunks;
+        int         m_numSpooledSyncChunks;
+        qint64      m_memoryUsageBytes;
+        qint64      m_peakMemoryUsageBytes;
+        qint64      m_spooledBytes;
+        qint64      m_numSpoolReads;
+    };
+
+public:
+    SyncChunkSpool();
+    ~SyncChunkSpool();
+
+    /**
+     * @brief setMemoryLimit - sets the max estimated amount of memory the stored sync chunks should occupy;
+     * non-positive value means there's no limit and nothing is spooled to disk
+     */
+    void setMemoryLimit(const qint64 memoryLimitBytes);
+    qint64 memoryLimit() const { return m_memoryLimitBytes; }
+
+    int size() const { return m_syncChunks.size(); }
+    bool isEmpty() const { return m_syncChunks.isEmpty(); }
+
+    /**
+     * @brief append - appends the sync chunk to the spool, spooling its notes and resources to disk
+     * if the memory limit has been reached
+     * @return true if the sync chunk was appended successfully, false otherwise
+     */
+    bool append(const qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription);
+
+    /**
+     * @brief at - provides access to the in-memory part of the sync chunk at the given index: if the sync chunk
+     * has been spooled, the returned sync chunk contains neither notes nor resources; the notes and resources
+     * already taken from the spool are not contained within the returned sync chunk either
+     */
+    const qevercloud::SyncChunk & at(const int index) const { return m_syncChunks[index]; }
+    const qevercloud::SyncChunk & back() const { return m_syncChunks.back(); }
+
+    /**
+     * @return true if notes and resources of the sync chunk at the given index have been spooled to disk
+     */
+    bool isSpooled(const int index) const;
+
+    /**
+     * @return the estimated amount of memory occupied by notes and resources of the sync chunk at the given index
+     * or which they would occupy if the sync chunk has been spooled; zero for invalid index
+     */
+    qint64 estimatedMemoryUsage(const int index) const;
+
+    /**
+     * @return the guids of notes or resources of the sync chunk at the given index, regardless of whether
+     * they have been spooled or taken; empty list for invalid index
+     */
+    QStringList noteGuids(const int index) const;
+    QStringList resourceGuids(const int index) const;
+
+    /**
+     * @return the smallest update sequence number of notes or resources of the sync chunk at the given index,
+     * regardless of whether they have been spooled or taken; -1 if there are no such notes or resources
+     * or for invalid index
+     */
+    qint32 notesSmallestUsn(const int index) const;
+    qint32 resourcesSmallestUsn(const int index) const;
+
+    /**
+     * @brief read - reads the full sync chunk at the given index, with notes and resources read back
+     * from the spool file if they have been spooled; the notes and resources already taken from the spool
+     * are not read
+     * @return true if the sync chunk was read successfully, false otherwise
+     */
+    bool read(const int index, qevercloud::SyncChunk & syncChunk, ErrorString & errorDescription) const;
+
+    /**
+     * @brief takeNotes - moves the notes of the sync chunk at the given index out of the spool, reading them back
+     * from the spool file if they have been spooled; the memory occupied by the taken notes is accounted
+     * in the statistics until they are released
+     * @return true if the notes were taken successfully, false otherwise, in particular if they have already been taken
+     */
+    bool takeNotes(const int index, QList<qevercloud::Note> & notes, ErrorString & errorDescription);
+
+    /**
+     * @brief takeResources - the same as takeNotes but for resources
+     */
+    bool takeResources(const int index, QList<qevercloud::Resource> & resources, ErrorString & errorDescription);
+
+    /**
+     * @return true if notes or resources of the sync chunk at the given index have been taken from the spool
+     */
+    bool notesTaken(const int index) const;
+    bool resourcesTaken(const int index) const;
+
+    /**
+     * @brief releaseNotes - notifies the spool that the notes taken from the sync chunk at the given index
+     * have been processed and no longer occupy memory
+     */
+    void releaseNotes(const int index);
+
+    /**
+     * @brief releaseResources - the same as releaseNotes but for resources
+     */
+    void releaseResources(const int index);
+
+    /**
+     * @brief clear - removes all the stored sync chunks along with the spool file and resets the statistics
+     */
+    void clear();
+
+    const Statistics & statistics() const { return m_statistics; }
+
+private:
+    struct TakeState
+    {
+        enum type
+        {
+            Stored = 0,
+            Taken,
+            Released
+        };
+    };
+
+    struct SpoolEntry
+    {
+        SpoolEntry();
+
+        qint64              m_offset;
+        qint64              m_size;
+        qint64              m_notesSize;
+        qint64              m_notesMemoryUsageBytes;
+        qint64              m_resourcesMemoryUsageBytes;
+        QStringList         m_noteGuids;
+        QStringList         m_resourceGuids;
+        qint32              m_notesSmallestUsn;
+        qint32              m_resourcesSmallestUsn;
+        TakeState::type     m_notesTakeState;
+        TakeState::type     m_resourcesTakeState;
+    };
+
+    bool openSpoolFile(ErrorString & errorDescription);
+    bool readSpoolFile(const qint64 offset, const qint64 size, QByteArray & buffer,
+                       ErrorString & errorDescription) const;
+    void updatePeakMemoryUsage(const qint64 additionalMemoryUsageBytes) const;
+
+private:
+    Q_DISABLE_COPY(SyncChunkSpool)
+
+private:
+    qint64                              m_memoryLimitBytes;
+    QVector<qevercloud::SyncChunk>      m_syncChunks;
+    QVector<SpoolEntry>                 m_spoolEntries;
+    QScopedPointer<QTemporaryFile>      m_pSpoolFile;
+    // NOTE: mutable because reading the spooled sync chunks doesn't change the logical state of the spool
+    // but is accounted in the statistics
+    mutable Statistics                  m_statistics;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_SPOOL_H
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncChunkWindow.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <algorithm>
+
+// The number of entries requested within the first sync chunk
+#define SYNC_CHUNK_WINDOW_INITIAL_WINDOW (50)
+
+#define SYNC_CHUNK_WINDOW_MIN_WINDOW (10)
+#define SYNC_CHUNK_WINDOW_DEFAULT_MAX_WINDOW (250)
+
+// The window is adapted so that a sync chunk is downloaded within this time and fits into this payload size:
+// long downloads stall the processing of the downloaded data and make the rate limit hits more costly
+#define SYNC_CHUNK_WINDOW_TARGET_DOWNLOAD_MSEC (3000)
+#define SYNC_CHUNK_WINDOW_TARGET_PAYLOAD_BYTES (Q_INT64_C(4194304))
+
+namespace quentier {
+
+SyncChunkWindow::SyncChunkWindow() :
+    m_maxWindow(SYNC_CHUNK_WINDOW_DEFAULT_MAX_WINDOW),
+    m_window(SYNC_CHUNK_WINDOW_INITIAL_WINDOW),
+    m_metrics()
+{
+    m_metrics.m_window = m_window;
+    m_metrics.m_smallestWindow = m_window;
+    m_metrics.m_largestWindow = m_window;
+}
+
+void SyncChunkWindow::setMaxWindow(const qint32 maxWindow)
+{
+    QNDEBUG(QStringLiteral("SyncChunkWindow::setMaxWindow: ") << maxWindow);
+
+    m_maxWindow = std::max(maxWindow, minWindow());
+    setWindow(m_window);
+}
+
+qint32 SyncChunkWindow::minWindow() const
+{
+    return SYNC_CHUNK_WINDOW_MIN_WINDOW;
+}
+
+void SyncChunkWindow::onSyncChunkDownloaded(const qint32 requestedEntries, const qint64 downloadMsec,
+                                            const qint64 payloadBytes, const bool lastSyncChunk)
+{
+    QNDEBUG(QStringLiteral("SyncChunkWindow::onSyncChunkDownloaded: requested entries = ") << requestedEntries
+            << QStringLiteral(", download time = ") << downloadMsec << QStringLiteral(" msec, payload = ")
+            << payloadBytes << QStringLiteral(" bytes, last sync chunk = ")
+            << (lastSyncChunk ? QStringLiteral("true") : QStringLiteral("false")));
+
+    ++m_metrics.m_numSyncChunks;
+    m_metrics.m_totalDownloadMsec += std::max(downloadMsec, Q_INT64_C(0));
+    m_metrics.m_totalPayloadBytes += std::max(payloadBytes, Q_INT64_C(0));
+
+    if (lastSyncChunk || (requestedEntries <= 0)) {
+        return;
+    }
+
+    double factor = 2.0;
+
+    if (downloadMsec > 0) {
+        factor = std::min(factor, static_cast<double>(SYNC_CHUNK_WINDOW_TARGET_DOWNLOAD_MSEC) / static_cast<double>(downloadMsec));
+    }
+
+    if (payloadBytes > 0) {
+        factor = std::min(factor, static_cast<double>(SYNC_CHUNK_WINDOW_TARGET_PAYLOAD_BYTES) / static_cast<double>(payloadBytes));
+    }
+
+    factor = std::max(factor, 0.5);
+
+    // NOTE: the window is scaled from the number of entries requested within the downloaded sync chunk
+    // rather than from the current window as several sync chunks might be downloaded at the same time
+    setWindow(static_cast<qint32>(static_cast<double>(requestedEntries) * factor + 0.5));
+}
+
+void SyncChunkWindow::onRateLimitReached()
+{
+    QNDEBUG(QStringLiteral("SyncChunkWindow::onRateLimitReached: window = ") << m_window);
+
+    ++m_metrics.m_numRateLimitHits;
+    setWindow(m_window / 2);
+}
+
+void SyncChunkWindow::clear()
+{
+    QNDEBUG(QStringLiteral("SyncChunkWindow::clear"));
+
+    m_window = std::max(std::min(SYNC_CHUNK_WINDOW_INITIAL_WINDOW, m_maxWindow), minWindow());
+
+    m_metrics = Metrics();
+    m_metrics.m_window = m_window;
+    m_metrics.m_smallestWindow = m_window;
+    m_metrics.m_largestWindow = m_window;
+}
+
+void SyncChunkWindow::setWindow(const qint32 window)
+{
+    m_window = std::max(std::min(window, m_maxWindow), minWindow());
+
+    m_metrics.m_window = m_window;
+    m_metrics.m_smallestWindow = std::min(m_metrics.m_smallestWindow, m_window);
+    m_metrics.m_largestWindow = std::max(m_metrics.m_largestWindow, m_window);
+}
+
+SyncChunkWindow::Metrics::Metrics() :
+    m_window(0),
+    m_smallestWindow(0),
+    m_largestWindow(0),
+    m_numSyncChunks(0),
+    m_numRateLimitHits(0),
+    m_totalDownloadMsec(0),
+    m_totalPayloadBytes(0)
+{}
+
+qint64 SyncChunkWindow::Metrics::averageDownloadMsec() const
+{
+    if (m_numSyncChunks <= 0) {
+        return 0;
+    }
+
+    return m_totalDownloadMsec / m_numSyncChunks;
+}
+
+QTextStream & SyncChunkWindow::Metrics::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("SyncChunkWindow::Metrics: window = ") << m_window
+         << QStringLiteral(", smallest window = ") << m_smallestWindow
+         << QStringLiteral(", largest window = ") << m_largestWindow
+         << QStringLiteral(", sync chunks = ") << m_numSyncChunks
+         << QStringLiteral(", rate limit hits = ") << m_numRateLimitHits
+         << QStringLiteral(", average download time = ") << averageDownloadMsec()
+         << QStringLiteral(" msec, total payload = ") << m_totalPayloadBytes << QStringLiteral(" bytes");
+    return strm;
+}
+
+} // namespace quentier
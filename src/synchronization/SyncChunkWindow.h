@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_WINDOW_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_WINDOW_H
+
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+
+namespace quentier {
+
+/**
+ * @brief The SyncChunkWindow class chooses the max number of entries to request within a single sync chunk
+ *
+ * The window starts from a moderate number of entries and adapts to the measured download time and the estimated
+ * payload size of the downloaded sync chunks: after each sync chunk the window is scaled towards the number of entries
+ * which would be downloaded within the target time and would fit into the target payload size, by at most a factor
+ * of two per sync chunk. The window is halved each time the rate limit is reached. The last sync chunks which might
+ * contain fewer entries than requested don't affect the window.
+ *
+ * The window doesn't download anything itself and doesn't measure time: the download times are passed in by the caller
+ */
+class Q_DECL_HIDDEN SyncChunkWindow
+{
+public:
+    struct Metrics: public Printable
+    {
+        Metrics();
+
+        virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+        /**
+         * @return the average time it took to download the sync chunk, in milliseconds
+         */
+        qint64 averageDownloadMsec() const;
+
+        qint32      m_window;
+        qint32      m_smallestWindow;
+        qint32      m_largestWindow;
+        qint64      m_numSyncChunks;
+        qint64      m_numRateLimitHits;
+        qint64      m_totalDownloadMsec;
+        qint64      m_totalPayloadBytes;
+    };
+
+public:
+    SyncChunkWindow();
+
+    /**
+     * @brief setMaxWindow - sets the max number of entries which can be requested within a single sync chunk;
+     * the value less than the min window is treated as the min window
+     */
+    void setMaxWindow(const qint32 maxWindow);
+    qint32 maxWindow() const { return m_maxWindow; }
+
+    qint32 minWindow() const;
+
+    /**
+     * @return the number of entries to request within the next sync chunk
+     */
+    qint32 window() const { return m_window; }
+
+    /**
+     * @brief onSyncChunkDownloaded - adapts the window to the downloaded sync chunk
+     * @param requestedEntries - the max number of entries which was requested within the sync chunk
+     * @param downloadMsec - the time elapsed between sending the request and receiving the sync chunk
+     * @param payloadBytes - the estimated size of the sync chunk's data
+     * @param lastSyncChunk - true if there's no more sync chunks to download after this one
+     */
+    void onSyncChunkDownloaded(const qint32 requestedEntries, const qint64 downloadMsec,
+                               const qint64 payloadBytes, const bool lastSyncChunk);
+
+    /**
+     * @brief onRateLimitReached - halves the window
+     */
+    void onRateLimitReached();
+
+    const Metrics & metrics() const { return m_metrics; }
+
+    /**
+     * @brief clear - resets the window to the initial one and resets the metrics; the max window is preserved
+     */
+    void clear();
+
+private:
+    void setWindow(const qint32 window);
+
+private:
+    qint32      m_maxWindow;
+    qint32      m_window;
+    Metrics     m_metrics;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SYNC_CHUNK_WINDOW_H
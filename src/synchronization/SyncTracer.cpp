@@ -0,0 +1,390 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncTracer.h"
+#include <quentier/logging/QuentierLogger.h>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include <algorithm>
+
+#define SYNC_TRACER_DEFAULT_MAX_NUM_EVENTS (200000)
+
+namespace quentier {
+
+namespace {
+
+QString escapedJsonString(const QString & str)
+{
+    QString result;
+    result.reserve(str.size());
+
+    for(int i = 0, size = str.size(); i < size; ++i)
+    {
+        const QChar chr = str[i];
+        if (chr == QChar::fromLatin1('"')) {
+            result += QStringLiteral("\\\"");
+        }
+        else if (chr == QChar::fromLatin1('\\')) {
+            result += QStringLiteral("\\\\");
+        }
+        else if (chr.unicode() < 0x20) {
+            result += QString::fromLatin1("\\u%1").arg(static_cast<int>(chr.unicode()), 4, 16, QChar::fromLatin1('0'));
+        }
+        else {
+            result += chr;
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+SyncTracer::SyncTracer() :
+    m_enabled(false),
+    m_maxNumEvents(SYNC_TRACER_DEFAULT_MAX_NUM_EVENTS),
+    m_numDroppedEvents(0),
+    m_events(),
+    m_spanStartTimestamps(),
+    m_phaseMetrics(Phase::NumPhases)
+{}
+
+void SyncTracer::setEnabled(const bool enabled)
+{
+    QNDEBUG(QStringLiteral("SyncTracer::setEnabled: ") << (enabled ? QStringLiteral("true") : QStringLiteral("false")));
+
+    m_enabled = enabled;
+    if (!m_enabled) {
+        m_spanStartTimestamps.clear();
+    }
+}
+
+void SyncTracer::setMaxNumEvents(const int maxNumEvents)
+{
+    QNDEBUG(QStringLiteral("SyncTracer::setMaxNumEvents: ") << maxNumEvents);
+    m_maxNumEvents = std::max(maxNumEvents, 1);
+}
+
+void SyncTracer::beginSpan(const Phase::type phase, const QString & id, const qint64 timestamp)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    m_spanStartTimestamps[QPair<int,QString>(static_cast<int>(phase), id)] = timestamp;
+
+    Event event;
+    event.m_type = 'b';
+    event.m_phase = phase;
+    event.m_id = id;
+    event.m_timestamp = timestamp;
+    addEvent(event);
+}
+
+bool SyncTracer::endSpan(const Phase::type phase, const QString & id, const qint64 timestamp,
+                         const qint64 numItems, const qint64 numBytes)
+{
+    if (!m_enabled) {
+        return false;
+    }
+
+    auto it = m_spanStartTimestamps.find(QPair<int,QString>(static_cast<int>(phase), id));
+    if (it == m_spanStartTimestamps.end()) {
+        return false;
+    }
+
+    qint64 startTimestamp = it.value();
+    Q_UNUSED(m_spanStartTimestamps.erase(it))
+
+    updatePhaseMetrics(phase, startTimestamp, timestamp, numItems, numBytes);
+
+    Event event;
+    event.m_type = 'e';
+    event.m_phase = phase;
+    event.m_id = id;
+    event.m_timestamp = timestamp;
+    event.m_numItems = numItems;
+    event.m_numBytes = numBytes;
+    addEvent(event);
+
+    return true;
+}
+
+bool SyncTracer::hasSpanInProgress(const Phase::type phase, const QString & id) const
+{
+    return m_spanStartTimestamps.contains(QPair<int,QString>(static_cast<int>(phase), id));
+}
+
+void SyncTracer::recordRateLimitWait(const qint32 rateLimitSeconds, const qint64 timestamp)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    qint64 durationMsec = static_cast<qint64>(std::max(rateLimitSeconds, 0)) * 1000;
+    updatePhaseMetrics(Phase::RateLimitWait, timestamp, timestamp + durationMsec, 0, 0);
+
+    Event event;
+    event.m_type = 'X';
+    event.m_phase = Phase::RateLimitWait;
+    event.m_timestamp = timestamp;
+    event.m_durationMsec = durationMsec;
+    addEvent(event);
+}
+
+const SyncTracer::PhaseMetrics & SyncTracer::phaseMetrics(const Phase::type phase) const
+{
+    return m_phaseMetrics[static_cast<int>(phase)];
+}
+
+QByteArray SyncTracer::toChromeTraceJson() const
+{
+    qint64 originTimestamp = 0;
+    for(auto it = m_events.constBegin(), end = m_events.constEnd(); it != end; ++it)
+    {
+        if ((it == m_events.constBegin()) || (it->m_timestamp < originTimestamp)) {
+            originTimestamp = it->m_timestamp;
+        }
+    }
+
+    QString json;
+    QTextStream strm(&json, QIODevice::WriteOnly);
+
+    strm << QStringLiteral("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for(auto it = m_events.constBegin(), end = m_events.constEnd(); it != end; ++it)
+    {
+        const Event & event = *it;
+        if (it != m_events.constBegin()) {
+            strm << QStringLiteral(",");
+        }
+
+        QString name = phaseName(event.m_phase);
+
+        // NOTE: the timestamps and durations are in microseconds in Chrome trace event format
+        strm << QStringLiteral("\n{\"name\":\"") << name << QStringLiteral("\",\"cat\":\"") << name
+             << QStringLiteral("\",\"ph\":\"") << QChar::fromLatin1(event.m_type)
+             << QStringLiteral("\",\"ts\":") << ((event.m_timestamp - originTimestamp) * 1000)
+             << QStringLiteral(",\"pid\":1,\"tid\":1");
+
+        if (event.m_type == 'X') {
+            strm << QStringLiteral(",\"dur\":") << (event.m_durationMsec * 1000);
+        }
+        else {
+            strm << QStringLiteral(",\"id\":\"") << escapedJsonString(name + QStringLiteral(":") + event.m_id)
+                 << QStringLiteral("\"");
+        }
+
+        if (event.m_type == 'e') {
+            strm << QStringLiteral(",\"args\":{\"id\":\"") << escapedJsonString(event.m_id)
+                 << QStringLiteral("\",\"items\":") << event.m_numItems << QStringLiteral(",\"bytes\":")
+                 << event.m_numBytes << QStringLiteral("}");
+        }
+
+        strm << QStringLiteral("}");
+    }
+
+    strm << QStringLiteral("\n],\"otherData\":{\"droppedEvents\":") << m_numDroppedEvents << QStringLiteral("}}\n");
+    strm.flush();
+
+    return json.toUtf8();
+}
+
+bool SyncTracer::exportChromeTrace(const QString & filePath, ErrorString & errorDescription) const
+{
+    QNDEBUG(QStringLiteral("SyncTracer::exportChromeTrace: ") << filePath);
+
+    QFileInfo fileInfo(filePath);
+    QDir dir = fileInfo.absoluteDir();
+    if (!dir.exists() && !dir.mkpath(dir.absolutePath())) {
+        errorDescription.setBase(QT_TR_NOOP("can't create the folder for the sync trace file"));
+        errorDescription.details() = dir.absolutePath();
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorDescription.setBase(QT_TR_NOOP("can't open the sync trace file for writing"));
+        errorDescription.details() = filePath;
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    QByteArray json = toChromeTraceJson();
+    qint64 bytesWritten = file.write(json);
+    file.close();
+
+    if (bytesWritten != static_cast<qint64>(json.size())) {
+        errorDescription.setBase(QT_TR_NOOP("failed to write the sync trace file"));
+        errorDescription.details() = filePath;
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    return true;
+}
+
+void SyncTracer::clear()
+{
+    QNDEBUG(QStringLiteral("SyncTracer::clear"));
+
+    m_numDroppedEvents = 0;
+    m_events.clear();
+    m_spanStartTimestamps.clear();
+    m_phaseMetrics = QVector<PhaseMetrics>(Phase::NumPhases);
+}
+
+QString SyncTracer::phaseName(const Phase::type phase)
+{
+    switch(phase)
+    {
+    case Phase::SyncChunksDownload:
+        return QStringLiteral("SyncChunksDownload");
+    case Phase::TagsMerge:
+        return QStringLiteral("TagsMerge");
+    case Phase::NotebooksMerge:
+        return QStringLiteral("NotebooksMerge");
+    case Phase::NotesMerge:
+        return QStringLiteral("NotesMerge");
+    case Phase::ResourcesMerge:
+        return QStringLiteral("ResourcesMerge");
+    case Phase::ConflictResolution:
+        return QStringLiteral("ConflictResolution");
+    case Phase::NoteDownload:
+        return QStringLiteral("NoteDownload");
+    case Phase::ResourceDownload:
+        return QStringLiteral("ResourceDownload");
+    case Phase::LocalStorageWrite:
+        return QStringLiteral("LocalStorageWrite");
+    case Phase::Expunge:
+        return QStringLiteral("Expunge");
+    case Phase::SendLocalChanges:
+        return QStringLiteral("SendLocalChanges");
+    case Phase::RateLimitWait:
+        return QStringLiteral("RateLimitWait");
+    default:
+        return QStringLiteral("Unknown");
+    }
+}
+
+QTextStream & SyncTracer::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("SyncTracer: ") << m_events.size() << QStringLiteral(" events, ")
+         << m_numDroppedEvents << QStringLiteral(" dropped events, ") << m_spanStartTimestamps.size()
+         << QStringLiteral(" spans in progress");
+
+    for(int i = 0; i < Phase::NumPhases; ++i)
+    {
+        const PhaseMetrics & metrics = m_phaseMetrics[i];
+        if (metrics.m_numSpans == 0) {
+            continue;
+        }
+
+        strm << QStringLiteral("\n  ") << phaseName(static_cast<Phase::type>(i)) << QStringLiteral(": ") << metrics;
+    }
+
+    return strm;
+}
+
+SyncTracer::PhaseMetrics::PhaseMetrics() :
+    m_numSpans(0),
+    m_totalDurationMsec(0),
+    m_maxDurationMsec(0),
+    m_numItems(0),
+    m_numBytes(0),
+    m_firstStartTimestamp(0),
+    m_lastEndTimestamp(0)
+{}
+
+QTextStream & SyncTracer::PhaseMetrics::print(QTextStream & strm) const
+{
+    strm << QStringLiteral("spans = ") << m_numSpans
+         << QStringLiteral(", total duration = ") << m_totalDurationMsec
+         << QStringLiteral(" msec, average duration = ") << averageDurationMsec()
+         << QStringLiteral(" msec, max duration = ") << m_maxDurationMsec
+         << QStringLiteral(" msec, items = ") << m_numItems
+         << QStringLiteral(", bytes = ") << m_numBytes
+         << QStringLiteral(", throughput = ") << itemsPerSecond() << QStringLiteral(" items/sec");
+    return strm;
+}
+
+qint64 SyncTracer::PhaseMetrics::averageDurationMsec() const
+{
+    if (m_numSpans == 0) {
+        return 0;
+    }
+
+    return m_totalDurationMsec / m_numSpans;
+}
+
+double SyncTracer::PhaseMetrics::itemsPerSecond() const
+{
+    qint64 elapsedMsec = m_lastEndTimestamp - m_firstStartTimestamp;
+    if ((m_numSpans == 0) || (elapsedMsec <= 0)) {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_numItems) * 1000.0 / static_cast<double>(elapsedMsec);
+}
+
+SyncTracer::Event::Event() :
+    m_type('i'),
+    m_phase(Phase::SyncChunksDownload),
+    m_id(),
+    m_timestamp(0),
+    m_durationMsec(0),
+    m_numItems(0),
+    m_numBytes(0)
+{}
+
+void SyncTracer::addEvent(const Event & event)
+{
+    if (m_events.size() >= m_maxNumEvents) {
+        ++m_numDroppedEvents;
+        return;
+    }
+
+    m_events.push_back(event);
+}
+
+void SyncTracer::updatePhaseMetrics(const Phase::type phase, const qint64 startTimestamp, const qint64 endTimestamp,
+                                    const qint64 numItems, const qint64 numBytes)
+{
+    PhaseMetrics & metrics = m_phaseMetrics[static_cast<int>(phase)];
+
+    qint64 durationMsec = std::max(endTimestamp - startTimestamp, static_cast<qint64>(0));
+
+    if ((metrics.m_numSpans == 0) || (startTimestamp < metrics.m_firstStartTimestamp)) {
+        metrics.m_firstStartTimestamp = startTimestamp;
+    }
+
+    if ((metrics.m_numSpans == 0) || (endTimestamp > metrics.m_lastEndTimestamp)) {
+        metrics.m_lastEndTimestamp = endTimestamp;
+    }
+
+    ++metrics.m_numSpans;
+    metrics.m_totalDurationMsec += durationMsec;
+    metrics.m_maxDurationMsec = std::max(metrics.m_maxDurationMsec, durationMsec);
+    metrics.m_numItems += numItems;
+    metrics.m_numBytes += numBytes;
+}
+
+} // namespace quentier
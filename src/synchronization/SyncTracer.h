@@ -0,0 +1,173 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_SYNCHRONIZATION_SYNC_TRACER_H
+#define LIB_QUENTIER_SYNCHRONIZATION_SYNC_TRACER_H
+
+#include <quentier/types/ErrorString.h>
+#include <quentier/utility/Printable.h>
+#include <quentier/utility/Macros.h>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+namespace quentier {
+
+/**
+ * @brief The SyncTracer class records the timeline of the synchronization phases along with the per-phase metrics
+ *
+ * The spans within the same phase are identified by ids so that the overlapping spans, like the downloads of several
+ * notes in flight, can be traced. Each span can carry the number of items and bytes processed within it.
+ * The recorded trace can be exported in Chrome trace event format and loaded into chrome://tracing or any
+ * compatible viewer.
+ *
+ * The tracer doesn't measure time: the timestamps in milliseconds since epoch are passed in by the caller.
+ * The tracing is disabled by default; nothing is recorded while it is disabled.
+ */
+class Q_DECL_HIDDEN SyncTracer: public Printable
+{
+public:
+    struct Phase
+    {
+        enum type
+        {
+            SyncChunksDownload = 0,
+            TagsMerge,
+            NotebooksMerge,
+            NotesMerge,
+            ResourcesMerge,
+            ConflictResolution,
+            NoteDownload,
+            ResourceDownload,
+            LocalStorageWrite,
+            Expunge,
+            SendLocalChanges,
+            RateLimitWait,
+            NumPhases
+        };
+    };
+
+    struct PhaseMetrics: public Printable
+    {
+        PhaseMetrics();
+
+        virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+        /**
+         * @return the average duration of the finished spans, in milliseconds
+         */
+        qint64 averageDurationMsec() const;
+
+        /**
+         * @return the number of items processed per second between the start of the first span
+         * and the end of the last one
+         */
+        double itemsPerSecond() const;
+
+        qint64      m_numSpans;
+        qint64      m_totalDurationMsec;
+        qint64      m_maxDurationMsec;
+        qint64      m_numItems;
+        qint64      m_numBytes;
+        qint64      m_firstStartTimestamp;
+        qint64      m_lastEndTimestamp;
+    };
+
+public:
+    SyncTracer();
+
+    void setEnabled(const bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief setMaxNumEvents - sets the max number of trace events kept in memory; once the limit is reached,
+     * the new events are dropped but the per-phase metrics are still updated. The value less than 1 is treated as 1
+     */
+    void setMaxNumEvents(const int maxNumEvents);
+    int maxNumEvents() const { return m_maxNumEvents; }
+
+    void beginSpan(const Phase::type phase, const QString & id, const qint64 timestamp);
+
+    /**
+     * @brief endSpan - finishes the span previously started with beginSpan
+     * @return false if there was no such span in progress, true otherwise
+     */
+    bool endSpan(const Phase::type phase, const QString & id, const qint64 timestamp,
+                 const qint64 numItems = 0, const qint64 numBytes = 0);
+
+    bool hasSpanInProgress(const Phase::type phase, const QString & id) const;
+
+    /**
+     * @brief recordRateLimitWait - records the wait for the rate limit to expire as a span of RateLimitWait phase
+     * starting at the given timestamp
+     */
+    void recordRateLimitWait(const qint32 rateLimitSeconds, const qint64 timestamp);
+
+    const PhaseMetrics & phaseMetrics(const Phase::type phase) const;
+
+    int numEvents() const { return m_events.size(); }
+    qint64 numDroppedEvents() const { return m_numDroppedEvents; }
+
+    /**
+     * @return the recorded trace in Chrome trace event format: a JSON object with traceEvents array
+     */
+    QByteArray toChromeTraceJson() const;
+    bool exportChromeTrace(const QString & filePath, ErrorString & errorDescription) const;
+
+    /**
+     * @brief clear - drops the recorded events, the spans in progress and the metrics; the enabled flag
+     * and the max number of events are preserved
+     */
+    void clear();
+
+    static QString phaseName(const Phase::type phase);
+
+    virtual QTextStream & print(QTextStream & strm) const Q_DECL_OVERRIDE;
+
+private:
+    struct Event
+    {
+        Event();
+
+        char            m_type;
+        Phase::type     m_phase;
+        QString         m_id;
+        qint64          m_timestamp;
+        qint64          m_durationMsec;
+        qint64          m_numItems;
+        qint64          m_numBytes;
+    };
+
+    void addEvent(const Event & event);
+    void updatePhaseMetrics(const Phase::type phase, const qint64 startTimestamp, const qint64 endTimestamp,
+                            const qint64 numItems, const qint64 numBytes);
+
+private:
+    bool                                    m_enabled;
+    int                                     m_maxNumEvents;
+    qint64                                  m_numDroppedEvents;
+    QVector<Event>                          m_events;
+    QHash<QPair<int,QString>,qint64>        m_spanStartTimestamps;
+    QVector<PhaseMetrics>                   m_phaseMetrics;
+};
+
+} // namespace quentier
+
+#endif // LIB_QUENTIER_SYNCHRONIZATION_SYNC_TRACER_H
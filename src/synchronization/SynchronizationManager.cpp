@@ -24,8 +24,10 @@ namespace quentier {
 
 SynchronizationManager::SynchronizationManager(const QString & consumerKey, const QString & consumerSecret,
                                                const QString & host, LocalStorageManagerAsync & localStorageManagerAsync,
-                                               IAuthenticationManager & authenticationManager) :
-    d_ptr(new SynchronizationManagerPrivate(consumerKey, consumerSecret, host, localStorageManagerAsync, authenticationManager))
+                                               IAuthenticationManager & authenticationManager,
+                                               INoteStore * pNoteStore, IUserStore * pUserStore) :
+    d_ptr(new SynchronizationManagerPrivate(consumerKey, consumerSecret, host, localStorageManagerAsync, authenticationManager,
+                                            pNoteStore, pUserStore))
 {
     QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,notifyStart),
                      this, QNSIGNAL(SynchronizationManager,started));
@@ -43,6 +45,10 @@ SynchronizationManager::SynchronizationManager(const QString & consumerKey, cons
                      this, QNSIGNAL(SynchronizationManager,linkedNotebookSyncChunksDownloadProgress,qint32,qint32,qint32,LinkedNotebook));
     QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebooksSyncChunksDownloaded),
                      this, QNSIGNAL(SynchronizationManager,linkedNotebooksSyncChunksDownloaded));
+    QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebookSyncChunksDownloadFinished,LinkedNotebook),
+                     this, QNSIGNAL(SynchronizationManager,linkedNotebookSyncChunksDownloadFinished,LinkedNotebook));
+    QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebookSyncFailed,LinkedNotebook,ErrorString),
+                     this, QNSIGNAL(SynchronizationManager,linkedNotebookSyncFailed,LinkedNotebook,ErrorString));
     QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,notesDownloadProgress,quint32,quint32),
                      this, QNSIGNAL(SynchronizationManager,notesDownloadProgress,quint32,quint32));
     QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebooksNotesDownloadProgress,quint32,quint32),
@@ -71,6 +77,10 @@ SynchronizationManager::SynchronizationManager(const QString & consumerKey, cons
                      this, QNSIGNAL(SynchronizationManager,rateLimitExceeded,qint32));
     QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,notifyRemoteToLocalSyncDone),
                      this, QNSIGNAL(SynchronizationManager,remoteToLocalSyncDone));
+    QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,downloadResourceDataComplete,Resource,QUuid),
+                     this, QNSIGNAL(SynchronizationManager,downloadResourceDataComplete,Resource,QUuid));
+    QObject::connect(d_ptr, QNSIGNAL(SynchronizationManagerPrivate,downloadResourceDataFailed,Resource,ErrorString,QUuid),
+                     this, QNSIGNAL(SynchronizationManager,downloadResourceDataFailed,Resource,ErrorString,QUuid));
 }
 
 SynchronizationManager::~SynchronizationManager()
@@ -146,4 +156,102 @@ void SynchronizationManager::setInkNoteImagesStoragePath(QString path)
     Q_EMIT setInkNoteImagesStoragePathDone(path);
 }
 
+void SynchronizationManager::setSyncChunksMemoryLimit(qint64 memoryLimitBytes)
+{
+    Q_D(SynchronizationManager);
+    d->setSyncChunksMemoryLimit(memoryLimitBytes);
+
+    Q_EMIT setSyncChunksMemoryLimitDone(memoryLimitBytes);
+}
+
+void SynchronizationManager::setMaxInFlightDownloads(int maxInFlightDownloads)
+{
+    Q_D(SynchronizationManager);
+    d->setMaxInFlightDownloads(maxInFlightDownloads);
+
+    Q_EMIT setMaxInFlightDownloadsDone(maxInFlightDownloads);
+}
+
+void SynchronizationManager::setMaxParallelLinkedNotebookSyncs(int maxParallelLinkedNotebookSyncs)
+{
+    Q_D(SynchronizationManager);
+    d->setMaxParallelLinkedNotebookSyncs(maxParallelLinkedNotebookSyncs);
+
+    Q_EMIT setMaxParallelLinkedNotebookSyncsDone(maxParallelLinkedNotebookSyncs);
+}
+
+void SynchronizationManager::setDownloadResourceDataOnDemand(bool flag)
+{
+    Q_D(SynchronizationManager);
+    d->setDownloadResourceDataOnDemand(flag);
+
+    Q_EMIT setDownloadResourceDataOnDemandDone(flag);
+}
+
+void SynchronizationManager::setResourceDataPrefetchPolicy(qint32 maxNoteAgeDays, qint64 maxNoteResourcesSizeBytes)
+{
+    Q_D(SynchronizationManager);
+    d->setResourceDataPrefetchPolicy(maxNoteAgeDays, maxNoteResourcesSizeBytes);
+
+    Q_EMIT setResourceDataPrefetchPolicyDone(maxNoteAgeDays, maxNoteResourcesSizeBytes);
+}
+
+void SynchronizationManager::setVisibleNoteGuids(QStringList noteGuids)
+{
+    Q_D(SynchronizationManager);
+    d->setVisibleNoteGuids(noteGuids);
+
+    Q_EMIT setVisibleNoteGuidsDone(noteGuids);
+}
+
+void SynchronizationManager::setSelectiveSyncFilter(QStringList notebookGuids, QStringList tagGuids)
+{
+    Q_D(SynchronizationManager);
+    d->setSelectiveSyncFilter(notebookGuids, tagGuids);
+
+    Q_EMIT setSelectiveSyncFilterDone(notebookGuids, tagGuids);
+}
+
+void SynchronizationManager::prioritizeNoteDownloads(QStringList noteGuids)
+{
+    Q_D(SynchronizationManager);
+    d->prioritizeNoteDownloads(noteGuids);
+
+    Q_EMIT prioritizeNoteDownloadsDone(noteGuids);
+}
+
+void SynchronizationManager::setSyncTracingEnabled(bool flag)
+{
+    Q_D(SynchronizationManager);
+    d->setSyncTracingEnabled(flag);
+
+    Q_EMIT setSyncTracingEnabledDone(flag);
+}
+
+void SynchronizationManager::exportSyncTrace(QString filePath)
+{
+    Q_D(SynchronizationManager);
+
+    ErrorString errorDescription;
+    bool res = d->exportSyncTrace(filePath, errorDescription);
+
+    Q_EMIT exportSyncTraceDone(res, filePath, errorDescription);
+}
+
+void SynchronizationManager::setLastSyncParametersFromSnapshot(LocalStorageSnapshotInfo snapshotInfo)
+{
+    Q_D(SynchronizationManager);
+
+    ErrorString errorDescription;
+    bool res = d->setLastSyncParametersFromSnapshot(snapshotInfo, errorDescription);
+
+    Q_EMIT setLastSyncParametersFromSnapshotDone(res, snapshotInfo, errorDescription);
+}
+
+void SynchronizationManager::downloadResourceData(Resource resource, QString linkedNotebookGuid, QUuid requestId)
+{
+    Q_D(SynchronizationManager);
+    d->downloadResourceData(resource, linkedNotebookGuid, requestId);
+}
+
 } // namespace quentier
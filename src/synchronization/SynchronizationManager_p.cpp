@@ -18,6 +18,8 @@
 
 #include "SynchronizationManager_p.h"
 #include "SynchronizationShared.h"
+#include "NoteStore.h"
+#include "UserStore.h"
 #include <quentier/utility/Utility.h>
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <quentier/logging/QuentierLogger.h>
@@ -58,9 +60,10 @@ public:
                                                   SynchronizationManagerPrivate & syncManager);
 
     virtual LocalStorageManagerAsync & localStorageManagerAsync() Q_DECL_OVERRIDE;
-    virtual NoteStore & noteStore() Q_DECL_OVERRIDE;
-    virtual UserStore & userStore() Q_DECL_OVERRIDE;
-    virtual NoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) Q_DECL_OVERRIDE;
+    virtual INoteStore & noteStore() Q_DECL_OVERRIDE;
+    virtual IUserStore & userStore() Q_DECL_OVERRIDE;
+    virtual INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) Q_DECL_OVERRIDE;
+    virtual SyncTracer & syncTracer() Q_DECL_OVERRIDE;
 
 private:
     LocalStorageManagerAsync &          m_localStorageManagerAsync;
@@ -74,8 +77,9 @@ public:
                                       SynchronizationManagerPrivate & syncManager);
 
     virtual LocalStorageManagerAsync & localStorageManagerAsync() Q_DECL_OVERRIDE;
-    virtual NoteStore & noteStore() Q_DECL_OVERRIDE;
-    virtual NoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) Q_DECL_OVERRIDE;
+    virtual INoteStore & noteStore() Q_DECL_OVERRIDE;
+    virtual INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) Q_DECL_OVERRIDE;
+    virtual SyncTracer & syncTracer() Q_DECL_OVERRIDE;
 
 private:
     LocalStorageManagerAsync &          m_localStorageManagerAsync;
@@ -84,7 +88,8 @@ private:
 
 SynchronizationManagerPrivate::SynchronizationManagerPrivate(const QString & consumerKey, const QString & consumerSecret,
                                                              const QString & host, LocalStorageManagerAsync & localStorageManagerAsync,
-                                                             IAuthenticationManager & authenticationManager) :
+                                                             IAuthenticationManager & authenticationManager,
+                                                             INoteStore * pNoteStore, IUserStore * pUserStore) :
     m_consumerKey(consumerKey),
     m_consumerSecret(consumerSecret),
     m_host(host),
@@ -94,16 +99,18 @@ SynchronizationManagerPrivate::SynchronizationManagerPrivate(const QString & con
     m_cachedLinkedNotebookLastUpdateCountByGuid(),
     m_cachedLinkedNotebookLastSyncTimeByGuid(),
     m_onceReadLastSyncParams(false),
-    m_noteStore(QSharedPointer<qevercloud::NoteStore>(new qevercloud::NoteStore)),
-    m_userStore(QSharedPointer<qevercloud::UserStore>(new qevercloud::UserStore(m_host))),
+    m_pNoteStore(pNoteStore ? pNoteStore : new NoteStore(QSharedPointer<qevercloud::NoteStore>(new qevercloud::NoteStore))),
+    m_pUserStore(pUserStore ? pUserStore : new UserStore(QSharedPointer<qevercloud::UserStore>(new qevercloud::UserStore(m_host)))),
     m_authContext(AuthContext::Blank),
     m_launchSyncPostponeTimerId(-1),
     m_OAuthResult(),
     m_authenticationInProgress(false),
+    m_syncTracer(),
     m_pRemoteToLocalSyncManagerController(new RemoteToLocalSynchronizationManagerController(localStorageManagerAsync, *this)),
     m_remoteToLocalSyncManager(*m_pRemoteToLocalSyncManagerController, m_host),
     m_pSendLocalChangesManagerController(new SendLocalChangesManagerController(localStorageManagerAsync, *this)),
     m_sendLocalChangesManager(*m_pSendLocalChangesManagerController),
+    m_resourceDataDownloader(localStorageManagerAsync, *m_pNoteStore),
     m_cachedLinkedNotebookAuthTokensAndShardIdsByGuid(),
     m_cachedLinkedNotebookAuthTokenExpirationTimeByGuid(),
     m_linkedNotebookAuthDataPendingAuthentication(),
@@ -129,6 +136,8 @@ SynchronizationManagerPrivate::SynchronizationManagerPrivate(const QString & con
     m_linkedNotebookGuidsWithoutLocalAuthData(),
     m_shouldRepeatIncrementalSyncAfterSendingChanges(false)
 {
+    m_pNoteStore->setParent(this);
+
     m_OAuthResult.m_userId = -1;
 
     m_readAuthTokenJob.setAutoDelete(false);
@@ -256,6 +265,145 @@ void SynchronizationManagerPrivate::setInkNoteImagesStoragePath(const QString &
     m_remoteToLocalSyncManager.setInkNoteImagesStoragePath(path);
 }
 
+void SynchronizationManagerPrivate::setSyncChunksMemoryLimit(const qint64 memoryLimitBytes)
+{
+    m_remoteToLocalSyncManager.setSyncChunksMemoryLimit(memoryLimitBytes);
+}
+
+void SynchronizationManagerPrivate::setMaxInFlightDownloads(const int maxInFlightDownloads)
+{
+    m_remoteToLocalSyncManager.setMaxInFlightDownloads(maxInFlightDownloads);
+}
+
+void SynchronizationManagerPrivate::setMaxParallelLinkedNotebookSyncs(const int maxParallelLinkedNotebookSyncs)
+{
+    m_remoteToLocalSyncManager.setMaxParallelLinkedNotebookSyncs(maxParallelLinkedNotebookSyncs);
+}
+
+void SynchronizationManagerPrivate::setDownloadResourceDataOnDemand(const bool flag)
+{
+    m_remoteToLocalSyncManager.setDownloadResourceDataOnDemand(flag);
+}
+
+void SynchronizationManagerPrivate::setResourceDataPrefetchPolicy(const qint32 maxNoteAgeDays,
+                                                                  const qint64 maxNoteResourcesSizeBytes)
+{
+    m_remoteToLocalSyncManager.setResourceDataPrefetchPolicy(maxNoteAgeDays, maxNoteResourcesSizeBytes);
+}
+
+void SynchronizationManagerPrivate::setVisibleNoteGuids(const QStringList & noteGuids)
+{
+    m_remoteToLocalSyncManager.setVisibleNoteGuids(noteGuids);
+}
+
+void SynchronizationManagerPrivate::setSelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids)
+{
+    m_remoteToLocalSyncManager.setSelectiveSyncFilter(notebookGuids, tagGuids);
+}
+
+void SynchronizationManagerPrivate::prioritizeNoteDownloads(const QStringList & noteGuids)
+{
+    m_remoteToLocalSyncManager.prioritizeNoteDownloads(noteGuids);
+}
+
+void SynchronizationManagerPrivate::setSyncTracingEnabled(const bool flag)
+{
+    m_syncTracer.setEnabled(flag);
+}
+
+bool SynchronizationManagerPrivate::exportSyncTrace(const QString & filePath, ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::exportSyncTrace: ") << filePath);
+    return m_syncTracer.exportChromeTrace(filePath, errorDescription);
+}
+
+bool SynchronizationManagerPrivate::setLastSyncParametersFromSnapshot(const LocalStorageSnapshotInfo & snapshotInfo,
+                                                                      ErrorString & errorDescription)
+{
+    QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::setLastSyncParametersFromSnapshot: ") << snapshotInfo);
+
+    if (m_OAuthResult.m_userId < 0) {
+        errorDescription.setBase(QT_TR_NOOP("Can't set the last sync parameters from the local storage snapshot: "
+                                            "no Evernote account is set"));
+        QNINFO(errorDescription);
+        return false;
+    }
+
+    if (active()) {
+        errorDescription.setBase(QT_TR_NOOP("Can't set the last sync parameters from the local storage snapshot: "
+                                            "the synchronization is in progress"));
+        QNINFO(errorDescription);
+        return false;
+    }
+
+    if (snapshotInfo.highUsn < 0) {
+        errorDescription.setBase(QT_TR_NOOP("Can't set the last sync parameters from the local storage snapshot: "
+                                            "the snapshot's high USN is invalid"));
+        errorDescription.details() = QString::number(snapshotInfo.highUsn);
+        QNWARNING(errorDescription);
+        return false;
+    }
+
+    m_lastUpdateCount = snapshotInfo.highUsn;
+    m_lastSyncTime = snapshotInfo.creationTimestamp;
+
+    m_cachedLinkedNotebookLastUpdateCountByGuid = snapshotInfo.highUsnByLinkedNotebookGuid;
+    m_cachedLinkedNotebookLastSyncTimeByGuid.clear();
+    m_cachedLinkedNotebookLastSyncTimeByGuid.reserve(snapshotInfo.highUsnByLinkedNotebookGuid.size());
+    for(auto it = snapshotInfo.highUsnByLinkedNotebookGuid.constBegin(),
+        end = snapshotInfo.highUsnByLinkedNotebookGuid.constEnd(); it != end; ++it)
+    {
+        m_cachedLinkedNotebookLastSyncTimeByGuid[it.key()] = snapshotInfo.creationTimestamp;
+    }
+
+    m_onceReadLastSyncParams = true;
+    updatePersistentSyncSettings();
+    return true;
+}
+
+void SynchronizationManagerPrivate::downloadResourceData(const Resource & resource, const QString & linkedNotebookGuid,
+                                                         const QUuid & requestId)
+{
+    QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::downloadResourceData: linked notebook guid = ")
+            << linkedNotebookGuid << QStringLiteral(", request id = ") << requestId
+            << QStringLiteral(", resource guid = ") << (resource.hasGuid() ? resource.guid() : QStringLiteral("<not set>")));
+
+    if (!validAuthentication()) {
+        ErrorString errorDescription(QT_TR_NOOP("Can't download the resource data: not authenticated"));
+        QNINFO(errorDescription);
+        Q_EMIT downloadResourceDataFailed(resource, errorDescription, requestId);
+        return;
+    }
+
+    QString noteStoreUrl = m_OAuthResult.m_noteStoreUrl;
+    QString authToken = m_OAuthResult.m_authToken;
+
+    if (!linkedNotebookGuid.isEmpty())
+    {
+        auto noteStoreIt = m_noteStoresByLinkedNotebookGuids.find(linkedNotebookGuid);
+        auto authTokenIt = m_cachedLinkedNotebookAuthTokensAndShardIdsByGuid.find(linkedNotebookGuid);
+        if ((noteStoreIt == m_noteStoresByLinkedNotebookGuids.end()) || noteStoreIt.value()->noteStoreUrl().isEmpty() ||
+            (authTokenIt == m_cachedLinkedNotebookAuthTokensAndShardIdsByGuid.end()))
+        {
+            ErrorString errorDescription(QT_TR_NOOP("Can't download the resource data: the linked notebook has not been "
+                                                    "synchronized yet"));
+            QNINFO(errorDescription << QStringLiteral(", linked notebook guid = ") << linkedNotebookGuid);
+            Q_EMIT downloadResourceDataFailed(resource, errorDescription, requestId);
+            return;
+        }
+
+        noteStoreUrl = noteStoreIt.value()->noteStoreUrl();
+
+        // NOTE: empty authentication tokens correspond to public linked notebooks for which
+        // the authentication token from the user's own account needs to be used
+        if (!authTokenIt.value().first.isEmpty()) {
+            authToken = authTokenIt.value().first;
+        }
+    }
+
+    m_resourceDataDownloader.download(resource, noteStoreUrl, authToken, requestId);
+}
+
 void SynchronizationManagerPrivate::onOAuthResult(bool success, qevercloud::UserID userId, QString authToken,
                                                   qevercloud::Timestamp authTokenExpirationTime, QString shardId,
                                                   QString noteStoreUrl, QString webApiUrlPrefix, ErrorString errorDescription)
@@ -284,7 +432,7 @@ void SynchronizationManagerPrivate::onOAuthResult(bool success, qevercloud::User
         Account newAccount(QString(), Account::Type::Evernote, userId, Account::EvernoteAccountType::Free, m_host);
         m_remoteToLocalSyncManager.setAccount(newAccount);
 
-        m_userStore.setAuthenticationToken(authToken);
+        m_pUserStore->setAuthenticationToken(authToken);
 
         ErrorString error;
         bool res = m_remoteToLocalSyncManager.syncUser(userId, error, /* write user data to local storage = */ false);
@@ -569,6 +717,10 @@ void SynchronizationManagerPrivate::onRemoteToLocalSyncFailure(ErrorString error
 {
     QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::onRemoteToLocalSyncFailure: ") << errorDescription);
 
+    // The failure might be temporary (i.e. a network error), need to save the progress so that the next sync
+    // doesn't start from scratch
+    tryUpdateLastSyncStatus();
+
     Q_EMIT stopRemoteToLocalSync();
     Q_EMIT stopSendingLocalChanges();
     Q_EMIT notifyError(errorDescription);
@@ -586,6 +738,14 @@ void SynchronizationManagerPrivate::onRemoteToLocalSynchronizedContentFromUsersO
     updatePersistentSyncSettings();
 }
 
+void SynchronizationManagerPrivate::onRemoteToLocalSyncCheckpointReached()
+{
+    QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::onRemoteToLocalSyncCheckpointReached"));
+
+    // Persisting the update counts after which the sync should be resumed if it gets interrupted before it's finished
+    tryUpdateLastSyncStatus();
+}
+
 void SynchronizationManagerPrivate::onShouldRepeatIncrementalSync()
 {
     QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::onShouldRepeatIncrementalSync"));
@@ -628,6 +788,11 @@ void SynchronizationManagerPrivate::onLocalChangesSent(qint32 lastUpdateCount, Q
     }
 
     QNINFO(QStringLiteral("Finished the whole synchronization procedure!"));
+
+    if (m_syncTracer.isEnabled()) {
+        QNINFO(QStringLiteral("Synchronization trace metrics: ") << m_syncTracer);
+    }
+
     Q_EMIT notifyFinish(m_remoteToLocalSyncManager.account());
 }
 
@@ -662,6 +827,9 @@ void SynchronizationManagerPrivate::onRateLimitExceeded(qint32 secondsToWait)
     // re-download the same stuff over and over again and hit the rate limit at the very same sync stage
 
     tryUpdateLastSyncStatus();
+
+    m_syncTracer.recordRateLimitWait(secondsToWait, QDateTime::currentMSecsSinceEpoch());
+
     Q_EMIT rateLimitExceeded(secondsToWait);
 }
 
@@ -675,6 +843,12 @@ void SynchronizationManagerPrivate::createConnections(IAuthenticationManager & a
                      this, QNSLOT(SynchronizationManagerPrivate,onOAuthResult,bool,qevercloud::UserID,
                                   QString,qevercloud::Timestamp,QString,QString,QString,ErrorString));
 
+    // Connections with resource data downloader
+    QObject::connect(&m_resourceDataDownloader, QNSIGNAL(ResourceDataDownloader,finished,Resource,QUuid),
+                     this, QNSIGNAL(SynchronizationManagerPrivate,downloadResourceDataComplete,Resource,QUuid));
+    QObject::connect(&m_resourceDataDownloader, QNSIGNAL(ResourceDataDownloader,failed,Resource,ErrorString,QUuid),
+                     this, QNSIGNAL(SynchronizationManagerPrivate,downloadResourceDataFailed,Resource,ErrorString,QUuid));
+
     // Connections with remote to local synchronization manager
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,finished,qint32,qevercloud::Timestamp,QHash<QString,qint32>,
                                                            QHash<QString,qevercloud::Timestamp>),
@@ -692,6 +866,8 @@ void SynchronizationManagerPrivate::createConnections(IAuthenticationManager & a
                      this, QNSLOT(SynchronizationManagerPrivate,onRemoteToLocalSyncFailure,ErrorString));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,synchronizedContentFromUsersOwnAccount,qint32,qevercloud::Timestamp),
                      this, QNSLOT(SynchronizationManagerPrivate,onRemoteToLocalSynchronizedContentFromUsersOwnAccount,qint32,qevercloud::Timestamp));
+    QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,syncCheckpointReached),
+                     this, QNSLOT(SynchronizationManagerPrivate,onRemoteToLocalSyncCheckpointReached));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,requestLastSyncParameters),
                      this, QNSLOT(SynchronizationManagerPrivate,onRequestLastSyncParameters));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,syncChunksDownloadProgress,qint32,qint32,qint32),
@@ -704,6 +880,10 @@ void SynchronizationManagerPrivate::createConnections(IAuthenticationManager & a
                      this, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebookSyncChunksDownloadProgress,qint32,qint32,qint32,LinkedNotebook));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,linkedNotebooksSyncChunksDownloaded),
                      this, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebooksSyncChunksDownloaded));
+    QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,linkedNotebookSyncChunksDownloadFinished,LinkedNotebook),
+                     this, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebookSyncChunksDownloadFinished,LinkedNotebook));
+    QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,linkedNotebookSyncFailed,LinkedNotebook,ErrorString),
+                     this, QNSIGNAL(SynchronizationManagerPrivate,linkedNotebookSyncFailed,LinkedNotebook,ErrorString));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,resourcesDownloadProgress,quint32,quint32),
                      this, QNSIGNAL(SynchronizationManagerPrivate,resourcesDownloadProgress,quint32,quint32));
     QObject::connect(&m_remoteToLocalSyncManager, QNSIGNAL(RemoteToLocalSynchronizationManager,linkedNotebooksResourcesDownloadProgress,quint32,quint32),
@@ -959,9 +1139,12 @@ void SynchronizationManagerPrivate::launchSync()
 
     Q_EMIT notifyStart();
 
-    m_noteStore.setNoteStoreUrl(m_OAuthResult.m_noteStoreUrl);
-    m_noteStore.setAuthenticationToken(m_OAuthResult.m_authToken);
-    m_userStore.setAuthenticationToken(m_OAuthResult.m_authToken);
+    // NOTE: the trace of the previous sync is kept until the next one starts so that it can be exported in between
+    m_syncTracer.clear();
+
+    m_pNoteStore->setNoteStoreUrl(m_OAuthResult.m_noteStoreUrl);
+    m_pNoteStore->setAuthenticationToken(m_OAuthResult.m_authToken);
+    m_pUserStore->setAuthenticationToken(m_OAuthResult.m_authToken);
 
     if (m_lastUpdateCount <= 0) {
         QNDEBUG(QStringLiteral("The client has never synchronized with the remote service, "
@@ -1147,12 +1330,12 @@ void SynchronizationManagerPrivate::clear()
 
     m_launchSyncPostponeTimerId = -1;
 
-    m_noteStore.stop();
+    m_pNoteStore->stop();
 
     for(auto it = m_noteStoresByLinkedNotebookGuids.begin(),
         end = m_noteStoresByLinkedNotebookGuids.end(); it != end; ++it)
     {
-        NoteStore * pNoteStore = it.value();
+        INoteStore * pNoteStore = it.value();
         pNoteStore->stop();
         pNoteStore->setParent(Q_NULLPTR);
         pNoteStore->deleteLater();
@@ -1162,6 +1345,7 @@ void SynchronizationManagerPrivate::clear()
 
     m_remoteToLocalSyncManager.stop();
     m_sendLocalChangesManager.stop();
+    m_resourceDataDownloader.stop();
 
     m_linkedNotebookAuthDataPendingAuthentication.clear();
     m_cachedLinkedNotebookAuthTokensAndShardIdsByGuid.clear();
@@ -1361,7 +1545,7 @@ void SynchronizationManagerPrivate::authenticateToLinkedNotebooks()
         ErrorString errorDescription;
         qint32 rateLimitSeconds = 0;
 
-        NoteStore * pNoteStore = noteStoreForLinkedNotebookGuid(guid);
+        INoteStore * pNoteStore = noteStoreForLinkedNotebookGuid(guid);
         if (Q_UNLIKELY(!pNoteStore)) {
             ErrorString error(QT_TR_NOOP("Can't sync the linked notebook contents: can't find or create the note store for the linked notebook"));
             Q_EMIT notifyError(error);
@@ -1625,16 +1809,14 @@ void SynchronizationManagerPrivate::tryUpdateLastSyncStatus()
         return;
     }
 
-    qevercloud::Timestamp lastSyncTime = QDateTime::currentMSecsSinceEpoch();
-
+    // NOTE: the last sync time is not updated here: the sync is not finished yet, so the time of the previous
+    // successful sync is still the one to compare with the time before which the service requires the full sync
     bool shouldUpdatePersistentSyncSettings = false;
 
     if ((updateCount > 0) && m_remoteToLocalSyncManager.downloadedSyncChunks())
     {
         m_lastUpdateCount = updateCount;
-        m_lastSyncTime = lastSyncTime;
-        QNDEBUG(QStringLiteral("Got updated sync state for user's own account: update count = ") << m_lastUpdateCount
-                << QStringLiteral(", last sync time = ") << printableDateTimeFromTimestamp(m_lastSyncTime));
+        QNDEBUG(QStringLiteral("Got updated sync state for user's own account: update count = ") << m_lastUpdateCount);
         shouldUpdatePersistentSyncSettings = true;
     }
     else if (!updateCountsByLinkedNotebookGuid.isEmpty() &&
@@ -1644,10 +1826,12 @@ void SynchronizationManagerPrivate::tryUpdateLastSyncStatus()
             end = updateCountsByLinkedNotebookGuid.constEnd(); it != end; ++it)
         {
             m_cachedLinkedNotebookLastUpdateCountByGuid[it.key()] = it.value();
-            m_cachedLinkedNotebookLastSyncTimeByGuid[it.key()] = lastSyncTime;
+            if (!m_cachedLinkedNotebookLastSyncTimeByGuid.contains(it.key())) {
+                m_cachedLinkedNotebookLastSyncTimeByGuid[it.key()] = 0;
+            }
+
             QNDEBUG(QStringLiteral("Got updated sync state for linked notebook with guid ")
-                    << it.key() << QStringLiteral(", update count = ") << it.value()
-                    << QStringLiteral(", last sync time = ") << lastSyncTime);
+                    << it.key() << QStringLiteral(", update count = ") << it.value());
             shouldUpdatePersistentSyncSettings = true;
         }
     }
@@ -1701,7 +1885,7 @@ void SynchronizationManagerPrivate::updatePersistentSyncSettings()
     QNTRACE(QStringLiteral("Wrote ") << counter << QStringLiteral(" last sync params entries for linked notebooks"));
 }
 
-NoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
+INoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
 {
     QNTRACE(QStringLiteral("SynchronizationManagerPrivate::noteStoreForLinkedNotebook: ")
             << linkedNotebook);
@@ -1711,7 +1895,7 @@ NoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebook(const Link
         return Q_NULLPTR;
     }
 
-    NoteStore * pNoteStore = noteStoreForLinkedNotebookGuid(linkedNotebook.guid());
+    INoteStore * pNoteStore = noteStoreForLinkedNotebookGuid(linkedNotebook.guid());
     if (Q_UNLIKELY(!pNoteStore)) {
         return Q_NULLPTR;
     }
@@ -1725,7 +1909,7 @@ NoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebook(const Link
     return pNoteStore;
 }
 
-NoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebookGuid(const QString & guid)
+INoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebookGuid(const QString & guid)
 {
     QNDEBUG(QStringLiteral("SynchronizationManagerPrivate::noteStoreForLinkedNotebookGuid: guid = ") << guid);
 
@@ -1747,8 +1931,8 @@ NoteStore * SynchronizationManagerPrivate::noteStoreForLinkedNotebookGuid(const
         return Q_NULLPTR;
     }
 
-    QSharedPointer<qevercloud::NoteStore> pQecNoteStore(new qevercloud::NoteStore);
-    NoteStore * pNoteStore = new NoteStore(pQecNoteStore, this);
+    INoteStore * pNoteStore = m_pNoteStore->create();
+    pNoteStore->setParent(this);
     pNoteStore->setAuthenticationToken(m_OAuthResult.m_authToken);
     m_noteStoresByLinkedNotebookGuids[guid] = pNoteStore;
     return pNoteStore;
@@ -1765,21 +1949,26 @@ LocalStorageManagerAsync & SynchronizationManagerPrivate::RemoteToLocalSynchroni
     return m_localStorageManagerAsync;
 }
 
-NoteStore & SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::noteStore()
+INoteStore & SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::noteStore()
 {
-    return m_syncManager.m_noteStore;
+    return *m_syncManager.m_pNoteStore;
 }
 
-UserStore & SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::userStore()
+IUserStore & SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::userStore()
 {
-    return m_syncManager.m_userStore;
+    return *m_syncManager.m_pUserStore;
 }
 
-NoteStore * SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
+INoteStore * SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
 {
     return m_syncManager.noteStoreForLinkedNotebook(linkedNotebook);
 }
 
+SyncTracer & SynchronizationManagerPrivate::RemoteToLocalSynchronizationManagerController::syncTracer()
+{
+    return m_syncManager.m_syncTracer;
+}
+
 SynchronizationManagerPrivate::SendLocalChangesManagerController::SendLocalChangesManagerController(LocalStorageManagerAsync & localStorageManagerAsync,
                                                                                                     SynchronizationManagerPrivate & syncManager) :
     m_localStorageManagerAsync(localStorageManagerAsync),
@@ -1791,16 +1980,21 @@ LocalStorageManagerAsync & SynchronizationManagerPrivate::SendLocalChangesManage
     return m_localStorageManagerAsync;
 }
 
-NoteStore & SynchronizationManagerPrivate::SendLocalChangesManagerController::noteStore()
+INoteStore & SynchronizationManagerPrivate::SendLocalChangesManagerController::noteStore()
 {
-    return m_syncManager.m_noteStore;
+    return *m_syncManager.m_pNoteStore;
 }
 
-NoteStore * SynchronizationManagerPrivate::SendLocalChangesManagerController::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
+INoteStore * SynchronizationManagerPrivate::SendLocalChangesManagerController::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
 {
     return m_syncManager.noteStoreForLinkedNotebook(linkedNotebook);
 }
 
+SyncTracer & SynchronizationManagerPrivate::SendLocalChangesManagerController::syncTracer()
+{
+    return m_syncManager.m_syncTracer;
+}
+
 QTextStream & SynchronizationManagerPrivate::AuthData::print(QTextStream & strm) const
 {
     strm << QStringLiteral("AuthData: {\n")
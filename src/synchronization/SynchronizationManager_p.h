@@ -21,8 +21,11 @@
 
 #include "RemoteToLocalSynchronizationManager.h"
 #include "SendLocalChangesManager.h"
+#include "ResourceDataDownloader.h"
+#include "SyncTracer.h"
 #include <quentier/synchronization/IAuthenticationManager.h>
 #include <quentier/types/Account.h>
+#include <quentier/local_storage/LocalStorageSnapshotInfo.h>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <qt5keychain/keychain.h>
@@ -35,15 +38,14 @@
 
 namespace quentier {
 
-QT_FORWARD_DECLARE_CLASS(NoteStore)
-
 class Q_DECL_HIDDEN SynchronizationManagerPrivate: public QObject
 {
     Q_OBJECT
 public:
     SynchronizationManagerPrivate(const QString & consumerKey, const QString & consumerSecret,
                                   const QString & host, LocalStorageManagerAsync & localStorageManagerAsync,
-                                  IAuthenticationManager & authenticationManager);
+                                  IAuthenticationManager & authenticationManager,
+                                  INoteStore * pNoteStore = Q_NULLPTR, IUserStore * pUserStore = Q_NULLPTR);
     virtual ~SynchronizationManagerPrivate();
 
     bool active() const;
@@ -62,6 +64,8 @@ Q_SIGNALS:
     void linkedNotebookSyncChunksDownloadProgress(qint32 highestDownloadedUsn, qint32 highestServerUsn,
                                                   qint32 lastPreviousUsn, LinkedNotebook linkedNotebook);
     void linkedNotebooksSyncChunksDownloaded();
+    void linkedNotebookSyncChunksDownloadFinished(LinkedNotebook linkedNotebook);
+    void linkedNotebookSyncFailed(LinkedNotebook linkedNotebook, ErrorString errorDescription);
 
     void notesDownloadProgress(quint32 notesDownloaded, quint32 totalNotesToDownload);
     void linkedNotebooksNotesDownloadProgress(quint32 notesDownloaded, quint32 totalNotesToDownload);
@@ -86,6 +90,9 @@ Q_SIGNALS:
     void detectedConflictDuringLocalChangesSending();
     void rateLimitExceeded(qint32 secondsToWait);
 
+    void downloadResourceDataComplete(Resource resource, QUuid requestId);
+    void downloadResourceDataFailed(Resource resource, ErrorString errorDescription, QUuid requestId);
+
 public Q_SLOTS:
     void setAccount(const Account & account);
     void synchronize();
@@ -97,6 +104,19 @@ public Q_SLOTS:
     void setDownloadNoteThumbnails(const bool flag);
     void setDownloadInkNoteImages(const bool flag);
     void setInkNoteImagesStoragePath(const QString & path);
+    void setSyncChunksMemoryLimit(const qint64 memoryLimitBytes);
+    void setMaxInFlightDownloads(const int maxInFlightDownloads);
+    void setMaxParallelLinkedNotebookSyncs(const int maxParallelLinkedNotebookSyncs);
+    void setDownloadResourceDataOnDemand(const bool flag);
+    void setResourceDataPrefetchPolicy(const qint32 maxNoteAgeDays, const qint64 maxNoteResourcesSizeBytes);
+    void setVisibleNoteGuids(const QStringList & noteGuids);
+    void setSelectiveSyncFilter(const QStringList & notebookGuids, const QStringList & tagGuids);
+    void prioritizeNoteDownloads(const QStringList & noteGuids);
+    void setSyncTracingEnabled(const bool flag);
+    bool exportSyncTrace(const QString & filePath, ErrorString & errorDescription);
+    bool setLastSyncParametersFromSnapshot(const LocalStorageSnapshotInfo & snapshotInfo, ErrorString & errorDescription);
+
+    void downloadResourceData(const Resource & resource, const QString & linkedNotebookGuid, const QUuid & requestId);
 
 Q_SIGNALS:
 // private signals
@@ -129,6 +149,7 @@ private Q_SLOTS:
     void onRemoteToLocalSyncStopped();
     void onRemoteToLocalSyncFailure(ErrorString errorDescription);
     void onRemoteToLocalSynchronizedContentFromUsersOwnAccount(qint32 lastUpdateCount, qevercloud::Timestamp lastSyncTime);
+    void onRemoteToLocalSyncCheckpointReached();
 
     void onShouldRepeatIncrementalSync();
     void onConflictDetectedDuringLocalChangesSending();
@@ -199,8 +220,8 @@ private:
     void tryUpdateLastSyncStatus();
     void updatePersistentSyncSettings();
 
-    NoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook);
-    NoteStore * noteStoreForLinkedNotebookGuid(const QString & guid);
+    INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook);
+    INoteStore * noteStoreForLinkedNotebookGuid(const QString & guid);
 
 private:
     class SendLocalChangesManagerController;
@@ -225,8 +246,8 @@ private:
     QHash<QString,qevercloud::Timestamp>    m_cachedLinkedNotebookLastSyncTimeByGuid;
     bool                                    m_onceReadLastSyncParams;
 
-    NoteStore                               m_noteStore;
-    UserStore                               m_userStore;
+    INoteStore *                            m_pNoteStore;
+    QSharedPointer<IUserStore>              m_pUserStore;
     AuthContext::type                       m_authContext;
 
     int                                     m_launchSyncPostponeTimerId;
@@ -234,18 +255,22 @@ private:
     AuthData                                m_OAuthResult;
     bool                                    m_authenticationInProgress;
 
+    SyncTracer                              m_syncTracer;
+
     QScopedPointer<RemoteToLocalSynchronizationManagerController>   m_pRemoteToLocalSyncManagerController;
     RemoteToLocalSynchronizationManager     m_remoteToLocalSyncManager;
 
     QScopedPointer<SendLocalChangesManagerController>   m_pSendLocalChangesManagerController;
     SendLocalChangesManager                 m_sendLocalChangesManager;
 
+    ResourceDataDownloader                  m_resourceDataDownloader;
+
     QHash<QString,QPair<QString,QString> >  m_cachedLinkedNotebookAuthTokensAndShardIdsByGuid;
     QHash<QString,qevercloud::Timestamp>    m_cachedLinkedNotebookAuthTokenExpirationTimeByGuid;
 
     QVector<LinkedNotebookAuthData>         m_linkedNotebookAuthDataPendingAuthentication;
 
-    QHash<QString, NoteStore*>              m_noteStoresByLinkedNotebookGuids;
+    QHash<QString, INoteStore*>             m_noteStoresByLinkedNotebookGuids;
 
     int                                     m_authenticateToLinkedNotebooksPostponeTimerId;
 
@@ -49,7 +49,7 @@ TagSyncCache::TagSyncCache(LocalStorageManagerAsync & localStorageManagerAsync,
     m_tagGuidByName(),
     m_dirtyTagsByGuid(),
     m_listTagsRequestId(),
-    m_limit(50),
+    m_limit(0),
     m_offset(0)
 {}
 
@@ -114,7 +114,7 @@ void TagSyncCache::onListTagsComplete(LocalStorageManager::ListObjectsOptions fl
 
     m_listTagsRequestId = QUuid();
 
-    if (foundTags.size() == static_cast<int>(limit)) {
+    if ((limit != 0) && (foundTags.size() == static_cast<int>(limit))) {
         TCTRACE(QStringLiteral("The number of found tags matches the limit, requesting more tags from the local storage"));
         m_offset += limit;
         requestTagsList();
@@ -182,6 +182,32 @@ void TagSyncCache::onExpungeTagComplete(Tag tag, QStringList expungedChildTagLoc
     }
 }
 
+void TagSyncCache::onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                                   QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                                   QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                                   QUuid requestId)
+{
+    if (linkedNotebookGuid != m_linkedNotebookGuid) {
+        return;
+    }
+
+    Q_UNUSED(syncedNotebookGuids)
+    Q_UNUSED(syncedTagGuids)
+    Q_UNUSED(syncedNoteGuids)
+    Q_UNUSED(syncedSavedSearchGuids)
+
+    TCDEBUG(QStringLiteral("TagSyncCache::onExpungeStaleDataItemsComplete: request id = ")
+            << requestId << QStringLiteral(", result: ") << result);
+
+    for(auto it = result.expungedTagLocalUids.constBegin(), end = result.expungedTagLocalUids.constEnd(); it != end; ++it) {
+        removeTag(*it);
+    }
+
+    for(auto it = result.detachedTagLocalUids.constBegin(), end = result.detachedTagLocalUids.constEnd(); it != end; ++it) {
+        detachTag(*it);
+    }
+}
+
 void TagSyncCache::connectToLocalStorage()
 {
     TCDEBUG(QStringLiteral("TagSyncCache::connectToLocalStorage"));
@@ -228,6 +254,11 @@ void TagSyncCache::connectToLocalStorage()
                      this, QNSLOT(TagSyncCache,onUpdateTagComplete,Tag,QUuid));
     QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeTagComplete,Tag,QStringList,QUuid),
                      this, QNSLOT(TagSyncCache,onExpungeTagComplete,Tag,QStringList,QUuid));
+    QObject::connect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                           QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                           QString,StaleDataItemsExpungeResult,QUuid),
+                     this, QNSLOT(TagSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                  QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = true;
 }
@@ -277,7 +308,12 @@ void TagSyncCache::disconnectFromLocalStorage()
     QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,updateTagComplete,Tag,QUuid),
                         this, QNSLOT(TagSyncCache,onUpdateTagComplete,Tag,QUuid));
     QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeTagComplete,Tag,QUuid),
-                        this, QNSLOT(TagSyncCache,onExpungeTagComplete,Tag,QUuid));
+                        this, QNSLOT(TagSyncCache,onExpungeTagComplete,Tag,QStringList,QUuid));
+    QObject::disconnect(&m_localStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,expungeStaleDataItemsComplete,
+                                                              QSet<QString>,QSet<QString>,QSet<QString>,QSet<QString>,
+                                                              QString,StaleDataItemsExpungeResult,QUuid),
+                        this, QNSLOT(TagSyncCache,onExpungeStaleDataItemsComplete,QSet<QString>,QSet<QString>,
+                                     QSet<QString>,QSet<QString>,QString,StaleDataItemsExpungeResult,QUuid));
 
     m_connectedToLocalStorage = false;
 }
@@ -332,6 +368,22 @@ void TagSyncCache::removeTag(const QString & tagLocalUid)
     Q_UNUSED(m_tagNameByGuid.erase(nameIt))
 }
 
+void TagSyncCache::detachTag(const QString & tagLocalUid)
+{
+    TCDEBUG(QStringLiteral("TagSyncCache::detachTag: local uid = ") << tagLocalUid);
+
+    // The detached tag stays within the local storage under the same name but loses its guid
+    auto localUidIt = m_tagNameByLocalUid.find(tagLocalUid);
+    if (localUidIt == m_tagNameByLocalUid.end()) {
+        TCDEBUG(QStringLiteral("The tag name was not found in the cache by local uid"));
+        return;
+    }
+
+    QString name = localUidIt.value();
+    removeTag(tagLocalUid);
+    m_tagNameByLocalUid[tagLocalUid] = name;
+}
+
 void TagSyncCache::processTag(const Tag & tag)
 {
     TCDEBUG(QStringLiteral("TagSyncCache::processTag: ") << tag);
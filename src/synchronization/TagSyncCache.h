@@ -22,6 +22,7 @@
 #include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <QObject>
 #include <QHash>
+#include <QSet>
 #include <QUuid>
 
 namespace quentier {
@@ -80,6 +81,10 @@ private Q_SLOTS:
     void onAddTagComplete(Tag tag, QUuid requestId);
     void onUpdateTagComplete(Tag tag, QUuid requestId);
     void onExpungeTagComplete(Tag tag, QStringList expungedChildTagLocalUids, QUuid requestId);
+    void onExpungeStaleDataItemsComplete(QSet<QString> syncedNotebookGuids, QSet<QString> syncedTagGuids,
+                                         QSet<QString> syncedNoteGuids, QSet<QString> syncedSavedSearchGuids,
+                                         QString linkedNotebookGuid, StaleDataItemsExpungeResult result,
+                                         QUuid requestId);
 
 private:
     void connectToLocalStorage();
@@ -88,6 +93,7 @@ private:
     void requestTagsList();
 
     void removeTag(const QString & tagLocalUid);
+    void detachTag(const QString & tagLocalUid);
     void processTag(const Tag & tag);
 
 private:
@@ -25,6 +25,7 @@
 namespace quentier {
 
 UserStore::UserStore(QSharedPointer<qevercloud::UserStore> pQecUserStore) :
+    IUserStore(),
     m_pQecUserStore(pQecUserStore)
 {
     QUENTIER_CHECK_PTR(m_pQecUserStore)
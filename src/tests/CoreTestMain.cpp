@@ -18,6 +18,8 @@
 
 #include "CoreTester.h"
 #include "FullSyncStaleDataItemsExpungerTester.h"
+#include "SendLocalChangesManagerTester.h"
+#include "SynchronizationManagerTester.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/utility/QuentierApplication.h>
 #include <quentier/utility/Utility.h>
@@ -49,5 +51,15 @@ int main(int argc, char *argv[])
         return res;
     }
 
+    res = QTest::qExec(new SendLocalChangesManagerTester);
+    if (res != 0) {
+        return res;
+    }
+
+    res = QTest::qExec(new SynchronizationManagerTester);
+    if (res != 0) {
+        return res;
+    }
+
     return 0;
 }
@@ -33,6 +33,15 @@
 #include "EnexExportImportTests.h"
 #include "ResourceRecognitionIndicesParsingTest.h"
 #include "TagSortByParentChildRelationsTest.h"
+#include "SyncChunkSpoolTest.h"
+#include "DownloadSchedulerTest.h"
+#include "SyncCheckpointTest.h"
+#include "PendingItemsRegistryTest.h"
+#include "SyncTracerTest.h"
+#include "SelectiveSyncFilterTest.h"
+#include "NoteSyncCacheTest.h"
+#include "SyncChunkWindowTest.h"
+#include "NoteImagesDownloadManagerTest.h"
 #include <quentier/exception/IQuentierException.h>
 #include <quentier/utility/EventLoopWithExitStatus.h>
 #include <quentier/local_storage/LocalStorageManager.h>
@@ -419,6 +428,105 @@ void CoreTester::tagSortByParentChildRelationsTest()
     CATCH_EXCEPTION();
 }
 
+void CoreTester::syncChunkSpoolTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::syncChunkSpoolTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::downloadSchedulerTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::downloadSchedulerTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::syncCheckpointTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::syncCheckpointTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::pendingItemsRegistryTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::pendingItemsRegistryTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::syncTracerTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::syncTracerTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::selectiveSyncFilterTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::selectiveSyncFilterTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::noteSyncStatusTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::noteSyncStatusTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::syncChunkWindowTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::syncChunkWindowTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::noteImagesCacheHitTest()
+{
+    try
+    {
+        QString error;
+        bool res = ::quentier::test::noteImagesCacheHitTest(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
 void CoreTester::resourceRecognitionIndicesParsingTest()
 {
     try
@@ -575,6 +683,72 @@ void CoreTester::localStorageManagerNoteTagIdsComplementTest()
     CATCH_EXCEPTION();
 }
 
+void CoreTester::localStorageManagerChangeJournalTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestChangeJournalInLocalStorage(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::localStorageManagerResourceSyncedDataHashesTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestResourceSyncedDataHashesInLocalStorage(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::localStorageManagerStatisticsTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestLocalStorageStatistics(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::localStorageManagerSnapshotExportImportTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestLocalStorageSnapshotExportImport(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::localStorageManagerStaleDataItemsExpungingTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestStaleDataItemsExpungingInLocalStorage(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
+void CoreTester::localStorageManagerAsyncNoteUpdateCoalescingTest()
+{
+    try
+    {
+        QString error;
+        bool res = TestNoteUpdateCoalescingInLocalStorageManagerAsync(error);
+        QVERIFY2(res == true, qPrintable(error));
+    }
+    CATCH_EXCEPTION();
+}
+
 void CoreTester::localStorageManagerListSavedSearchesTest()
 {
     try
@@ -64,6 +64,16 @@ private Q_SLOTS:
 
     void tagSortByParentChildRelationsTest();
 
+    void syncChunkSpoolTest();
+    void downloadSchedulerTest();
+    void syncCheckpointTest();
+    void pendingItemsRegistryTest();
+    void syncTracerTest();
+    void selectiveSyncFilterTest();
+    void noteSyncStatusTest();
+    void syncChunkWindowTest();
+    void noteImagesCacheHitTest();
+
     void resourceRecognitionIndicesParsingTest();
 
     void noteSearchQueryTest();
@@ -81,6 +91,12 @@ private Q_SLOTS:
     void localStorageManagerAccountHighUsnTest();
     void localStorageManagerAddNoteWithoutLocalUidTest();
     void localStorageManagerNoteTagIdsComplementTest();
+    void localStorageManagerChangeJournalTest();
+    void localStorageManagerResourceSyncedDataHashesTest();
+    void localStorageManagerStatisticsTest();
+    void localStorageManagerSnapshotExportImportTest();
+    void localStorageManagerStaleDataItemsExpungingTest();
+    void localStorageManagerAsyncNoteUpdateCoalescingTest();
 
     void localStorageManagerListSavedSearchesTest();
     void localStorageManagerListLinkedNotebooksTest();
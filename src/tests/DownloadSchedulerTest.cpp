@@ -0,0 +1,321 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DownloadSchedulerTest.h"
+#include "../synchronization/DownloadScheduler.h"
+#include <quentier/utility/UidGenerator.h>
+
+namespace quentier {
+namespace test {
+
+DownloadScheduler::Download createNoteDownload(const DownloadScheduler::PriorityClass::type priorityClass,
+                                               const qint64 estimatedSize)
+{
+    DownloadScheduler::Download download;
+    download.m_type = DownloadScheduler::DownloadType::Note;
+    download.m_priorityClass = priorityClass;
+    download.m_estimatedSize = estimatedSize;
+    download.m_note.setGuid(UidGenerator::Generate());
+    download.m_note.setNotebookGuid(UidGenerator::Generate());
+    return download;
+}
+
+bool downloadSchedulerTest(QString & error)
+{
+    qint64 timestamp = 1000000;
+
+    // 1) The downloads are started in the order of priority classes and then estimated sizes
+    {
+        DownloadScheduler scheduler;
+        scheduler.setMaxWindow(1);
+
+        DownloadScheduler::Download largeLinkedNotebookNote = createNoteDownload(DownloadScheduler::PriorityClass::LinkedNotebook, 10);
+        DownloadScheduler::Download smallLinkedNotebookNote = createNoteDownload(DownloadScheduler::PriorityClass::LinkedNotebook, 1);
+        DownloadScheduler::Download largeUserAccountNote = createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, 1000);
+        DownloadScheduler::Download smallUserAccountNote = createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, 100);
+
+        scheduler.enqueue(largeLinkedNotebookNote, timestamp);
+        scheduler.enqueue(smallLinkedNotebookNote, timestamp);
+        scheduler.enqueue(largeUserAccountNote, timestamp);
+        scheduler.enqueue(smallUserAccountNote, timestamp);
+
+        QList<QString> expectedGuids;
+        expectedGuids << smallUserAccountNote.guid() << largeUserAccountNote.guid()
+                      << smallLinkedNotebookNote.guid() << largeLinkedNotebookNote.guid();
+
+        for(int i = 0, size = expectedGuids.size(); i < size; ++i)
+        {
+            DownloadScheduler::Download download;
+            if (!scheduler.takeNext(download, timestamp)) {
+                error = QStringLiteral("Failed to take the next download from the scheduler's queue");
+                return false;
+            }
+
+            if (download.guid() != expectedGuids[i]) {
+                error = QStringLiteral("The downloads are not started in the order of their priority");
+                return false;
+            }
+
+            DownloadScheduler::Download nextDownload;
+            if (scheduler.takeNext(nextDownload, timestamp)) {
+                error = QStringLiteral("The scheduler started more downloads than allowed by the window of size 1");
+                return false;
+            }
+
+            DownloadScheduler::Download finishedDownload;
+            if (!scheduler.onDownloadFinished(DownloadScheduler::DownloadType::Note, download.guid(), timestamp,
+                                              finishedDownload))
+            {
+                error = QStringLiteral("The scheduler doesn't consider the started download being in flight");
+                return false;
+            }
+
+            if (finishedDownload.m_note != download.m_note) {
+                error = QStringLiteral("The finished download returned by the scheduler differs from the started one");
+                return false;
+            }
+        }
+
+        if (scheduler.queueDepth() != 0) {
+            error = QStringLiteral("The scheduler's queue is not empty after all the downloads were started");
+            return false;
+        }
+    }
+
+    // 2) The window grows with successful downloads up to the max window and is halved on reaching the rate limit
+    {
+        DownloadScheduler scheduler;
+        scheduler.setMaxWindow(8);
+
+        const int numDownloads = 200;
+        for(int i = 0; i < numDownloads; ++i) {
+            scheduler.enqueue(createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, i), timestamp);
+        }
+
+        int initialWindow = scheduler.window();
+        if ((initialWindow < 1) || (initialWindow > 8)) {
+            error = QStringLiteral("The initial window of downloads in flight is out of bounds: ") + QString::number(initialWindow);
+            return false;
+        }
+
+        QList<DownloadScheduler::Download> inFlightDownloads;
+        DownloadScheduler::Download download;
+        while(scheduler.takeNext(download, timestamp)) {
+            inFlightDownloads << download;
+        }
+
+        if (inFlightDownloads.size() != initialWindow) {
+            error = QStringLiteral("The number of downloads in flight doesn't match the initial window: ") +
+                    QString::number(inFlightDownloads.size()) + QStringLiteral(" vs ") + QString::number(initialWindow);
+            return false;
+        }
+
+        // Finish the downloads one by one, starting new ones as the window permits
+        for(int i = 0; i < 100; ++i)
+        {
+            DownloadScheduler::Download inFlightDownload = inFlightDownloads.takeFirst();
+            DownloadScheduler::Download finishedDownload;
+            Q_UNUSED(scheduler.onDownloadFinished(DownloadScheduler::DownloadType::Note, inFlightDownload.guid(),
+                                                  ++timestamp, finishedDownload))
+
+            while(scheduler.takeNext(download, timestamp)) {
+                inFlightDownloads << download;
+            }
+
+            if (scheduler.numInFlight() > scheduler.window()) {
+                error = QStringLiteral("The number of downloads in flight exceeds the window");
+                return false;
+            }
+        }
+
+        if (scheduler.window() != 8) {
+            error = QStringLiteral("The window of downloads in flight hasn't grown up to the max window: ") +
+                    QString::number(scheduler.window());
+            return false;
+        }
+
+        if (scheduler.metrics().m_peakNumInFlight != 8) {
+            error = QStringLiteral("Unexpected peak number of downloads in flight: ") +
+                    QString::number(scheduler.metrics().m_peakNumInFlight);
+            return false;
+        }
+
+        // All the downloads in flight hit the same rate limit: the window should be halved only once
+        const qint32 rateLimitSeconds = 5;
+        int numInFlight = inFlightDownloads.size();
+        for(int i = 0; i < numInFlight; ++i)
+        {
+            DownloadScheduler::Download inFlightDownload = inFlightDownloads.takeFirst();
+            DownloadScheduler::Download rateLimitedDownload;
+            bool res = scheduler.onRateLimitReached(DownloadScheduler::DownloadType::Note, inFlightDownload.guid(),
+                                                    rateLimitSeconds, timestamp, rateLimitedDownload);
+            if (!res) {
+                error = QStringLiteral("The scheduler doesn't consider the rate limited download being in flight");
+                return false;
+            }
+
+            scheduler.enqueue(rateLimitedDownload, timestamp);
+        }
+
+        if (scheduler.window() != 4) {
+            error = QStringLiteral("The window of downloads in flight wasn't halved once on reaching the rate limit: ") +
+                    QString::number(scheduler.window());
+            return false;
+        }
+
+        if (scheduler.backoffRemainingMsec(timestamp) != rateLimitSeconds * 1000) {
+            error = QStringLiteral("Unexpected remaining backoff time: ") +
+                    QString::number(scheduler.backoffRemainingMsec(timestamp));
+            return false;
+        }
+
+        if (scheduler.takeNext(download, timestamp + 1000)) {
+            error = QStringLiteral("The scheduler started the download before the rate limit expiration");
+            return false;
+        }
+
+        timestamp += rateLimitSeconds * 1000;
+        while(scheduler.takeNext(download, timestamp)) {
+            inFlightDownloads << download;
+        }
+
+        if (inFlightDownloads.size() != 4) {
+            error = QStringLiteral("Unexpected number of downloads started after the rate limit expiration: ") +
+                    QString::number(inFlightDownloads.size());
+            return false;
+        }
+
+        const DownloadScheduler::Metrics & metrics = scheduler.metrics();
+        if (metrics.m_numRateLimitHits != 8) {
+            error = QStringLiteral("Unexpected number of rate limit hits in the metrics: ") +
+                    QString::number(metrics.m_numRateLimitHits);
+            return false;
+        }
+
+        if (metrics.m_totalBackoffMsec != rateLimitSeconds * 1000) {
+            error = QStringLiteral("Unexpected total backoff time in the metrics: ") + QString::number(metrics.m_totalBackoffMsec);
+            return false;
+        }
+
+        if (metrics.m_numFinished != 100) {
+            error = QStringLiteral("Unexpected number of finished downloads in the metrics: ") +
+                    QString::number(metrics.m_numFinished);
+            return false;
+        }
+
+        if (metrics.m_numEnqueued != numDownloads + numInFlight) {
+            error = QStringLiteral("Unexpected number of enqueued downloads in the metrics: ") +
+                    QString::number(metrics.m_numEnqueued);
+            return false;
+        }
+
+        if (metrics.throughput() <= 0.0) {
+            error = QStringLiteral("The download throughput in the metrics is not positive");
+            return false;
+        }
+
+        scheduler.clear();
+        if ((scheduler.queueDepth() != 0) || (scheduler.numInFlight() != 0) || (scheduler.metrics().m_numEnqueued != 0) ||
+            (scheduler.maxWindow() != 8))
+        {
+            error = QStringLiteral("The scheduler's state wasn't properly reset by clear method");
+            return false;
+        }
+    }
+
+    // 3) The urgent downloads go before the regular ones, the more recently modified notes first; changing the urgency
+    // of queued downloads reorders them
+    {
+        DownloadScheduler scheduler;
+        scheduler.setMaxWindow(1);
+
+        DownloadScheduler::Download regularNote = createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, 1);
+
+        DownloadScheduler::Download olderRecentlyModifiedNote = createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, 10);
+        olderRecentlyModifiedNote.m_urgency = DownloadScheduler::Urgency::RecentlyModified;
+        olderRecentlyModifiedNote.m_noteModificationTimestamp = 100;
+
+        DownloadScheduler::Download newerRecentlyModifiedNote = createNoteDownload(DownloadScheduler::PriorityClass::UserAccount, 1000);
+        newerRecentlyModifiedNote.m_urgency = DownloadScheduler::Urgency::RecentlyModified;
+        newerRecentlyModifiedNote.m_noteModificationTimestamp = 200;
+
+        DownloadScheduler::Download lastUsedNotebookNote = createNoteDownload(DownloadScheduler::PriorityClass::LinkedNotebook, 100);
+        lastUsedNotebookNote.m_urgency = DownloadScheduler::Urgency::LastUsedNotebook;
+
+        DownloadScheduler::Download resourceOfRegularNote;
+        resourceOfRegularNote.m_type = DownloadScheduler::DownloadType::Resource;
+        resourceOfRegularNote.m_estimatedSize = 5;
+        resourceOfRegularNote.m_note = regularNote.m_note;
+        resourceOfRegularNote.m_resource.setGuid(UidGenerator::Generate());
+
+        scheduler.enqueue(regularNote, timestamp);
+        scheduler.enqueue(olderRecentlyModifiedNote, timestamp);
+        scheduler.enqueue(newerRecentlyModifiedNote, timestamp);
+        scheduler.enqueue(lastUsedNotebookNote, timestamp);
+        scheduler.enqueue(resourceOfRegularNote, timestamp);
+
+        DownloadScheduler::Download download;
+        if (!scheduler.takeNext(download, timestamp) || (download.guid() != lastUsedNotebookNote.guid())) {
+            error = QStringLiteral("The download of the note from the last used notebook was not started first");
+            return false;
+        }
+
+        DownloadScheduler::Download finishedDownload;
+        Q_UNUSED(scheduler.onDownloadFinished(DownloadScheduler::DownloadType::Note, download.guid(), timestamp, finishedDownload))
+
+        // The user opens the regular note: it and its resource should go before the rest of queued downloads
+        QHash<QString,DownloadScheduler::Urgency::type> urgenciesByNoteGuid;
+        urgenciesByNoteGuid[regularNote.guid()] = DownloadScheduler::Urgency::Requested;
+        urgenciesByNoteGuid[lastUsedNotebookNote.guid()] = DownloadScheduler::Urgency::Requested;
+        int numChangedDownloads = scheduler.setUrgency(urgenciesByNoteGuid);
+        if (numChangedDownloads != 2) {
+            error = QStringLiteral("Unexpected number of queued downloads with changed urgency: ") +
+                    QString::number(numChangedDownloads);
+            return false;
+        }
+
+        QList<QString> expectedGuids;
+        expectedGuids << regularNote.guid() << resourceOfRegularNote.guid()
+                      << newerRecentlyModifiedNote.guid() << olderRecentlyModifiedNote.guid();
+
+        for(int i = 0, size = expectedGuids.size(); i < size; ++i)
+        {
+            if (!scheduler.takeNext(download, timestamp)) {
+                error = QStringLiteral("Failed to take the next download from the scheduler's queue");
+                return false;
+            }
+
+            if (download.guid() != expectedGuids[i]) {
+                error = QStringLiteral("The downloads are not started in the order of their urgency");
+                return false;
+            }
+
+            if ((i < 2) && (download.m_urgency != DownloadScheduler::Urgency::Requested)) {
+                error = QStringLiteral("The started download doesn't have the urgency it was changed to");
+                return false;
+            }
+
+            Q_UNUSED(scheduler.onDownloadFinished(download.m_type, download.guid(), timestamp, finishedDownload))
+        }
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
@@ -17,9 +17,7 @@
  */
 
 #include "FullSyncStaleDataItemsExpungerTester.h"
-#include "../synchronization/NotebookSyncCache.h"
-#include "../synchronization/TagSyncCache.h"
-#include "../synchronization/SavedSearchSyncCache.h"
+#include "../synchronization/SyncCachesManager.h"
 #include <quentier/utility/UidGenerator.h>
 #include <quentier/utility/EventLoopWithExitStatus.h>
 #include <QtTest/QTest>
@@ -61,15 +59,46 @@ struct CompareItemByGuid
     QString     m_targetGuid;
 };
 
+template <class T>
+void fillSyncCache(T & cache)
+{
+    int fillResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(&cache, SIGNAL(filled()), &loop, SLOT(exitAsSuccess()));
+        QObject::connect(&cache, SIGNAL(failure(ErrorString)), &loop, SLOT(exitAsFailure()));
+
+        QTimer slotInvokingTimer;
+        slotInvokingTimer.setInterval(500);
+        slotInvokingTimer.setSingleShot(true);
+
+        timer.start();
+        slotInvokingTimer.singleShot(0, &cache, SLOT(fill()));
+        fillResult = loop.exec();
+    }
+
+    if (fillResult == -1) {
+        QFAIL("Internal error: incorrect return status from the sync cache");
+    }
+    else if (fillResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Detected failure during the asynchronous loop processing in the sync cache");
+    }
+    else if (fillResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("The sync cache failed to fill in time");
+    }
+}
+
 FullSyncStaleDataItemsExpungerTester::FullSyncStaleDataItemsExpungerTester(QObject * parent) :
     QObject(parent),
     m_testAccount(QStringLiteral("FullSyncStaleDataItemsExpungerTesterFakeUser"),
                   Account::Type::Evernote, qevercloud::UserID(1)),
     m_pLocalStorageManagerAsync(Q_NULLPTR),
-    m_syncedGuids(),
-    m_pNotebookSyncCache(Q_NULLPTR),
-    m_pTagSyncCache(Q_NULLPTR),
-    m_pSavedSearchSyncCache(Q_NULLPTR)
+    m_syncedGuids()
 {}
 
 FullSyncStaleDataItemsExpungerTester::~FullSyncStaleDataItemsExpungerTester()
@@ -81,10 +110,6 @@ void FullSyncStaleDataItemsExpungerTester::init()
     m_pLocalStorageManagerAsync = new LocalStorageManagerAsync(m_testAccount, /* start from scratch = */ true,
                                                                /* override lock = */ false, this);
     m_pLocalStorageManagerAsync->init();
-
-    m_pNotebookSyncCache = new NotebookSyncCache(*m_pLocalStorageManagerAsync, QString(), this);
-    m_pTagSyncCache = new TagSyncCache(*m_pLocalStorageManagerAsync, QString(), this);
-    m_pSavedSearchSyncCache = new SavedSearchSyncCache(*m_pLocalStorageManagerAsync, this);
 }
 
 void FullSyncStaleDataItemsExpungerTester::cleanup()
@@ -92,15 +117,6 @@ void FullSyncStaleDataItemsExpungerTester::cleanup()
     delete m_pLocalStorageManagerAsync;
     m_pLocalStorageManagerAsync = Q_NULLPTR;
 
-    delete m_pNotebookSyncCache;
-    m_pNotebookSyncCache = Q_NULLPTR;
-
-    delete m_pTagSyncCache;
-    m_pTagSyncCache = Q_NULLPTR;
-
-    delete m_pSavedSearchSyncCache;
-    m_pSavedSearchSyncCache = Q_NULLPTR;
-
     m_syncedGuids.m_syncedNotebookGuids.clear();
     m_syncedGuids.m_syncedTagGuids.clear();
     m_syncedGuids.m_syncedNoteGuids.clear();
@@ -1640,6 +1656,195 @@ void FullSyncStaleDataItemsExpungerTester::testDirtyTagWithStaleParentTag()
     doTest(/* use base data items = */ true, QList<Notebook>(), nonSyncedTags, QList<SavedSearch>(), QList<Note>());
 }
 
+void FullSyncStaleDataItemsExpungerTester::testSyncCachesFollowStaleAndDirtyItems()
+{
+    if (Q_UNLIKELY(!m_pLocalStorageManagerAsync)) {
+        QFAIL("Detected null pointer to LocalStorageManagerAsync");
+    }
+
+    LocalStorageManager * pLocalStorageManager = m_pLocalStorageManagerAsync->localStorageManager();
+    if (Q_UNLIKELY(!pLocalStorageManager)) {
+        QFAIL("Detected null pointer to LocalStorageManager");
+    }
+
+    setupBaseDataItems();
+
+    Notebook staleNotebook;
+    staleNotebook.setName(QStringLiteral("Stale notebook"));
+    staleNotebook.setGuid(UidGenerator::Generate());
+    staleNotebook.setUpdateSequenceNumber(100);
+    staleNotebook.setLocal(false);
+    staleNotebook.setDirty(false);
+
+    Notebook dirtyNotebook;
+    dirtyNotebook.setName(QStringLiteral("Dirty notebook"));
+    dirtyNotebook.setGuid(UidGenerator::Generate());
+    dirtyNotebook.setUpdateSequenceNumber(101);
+    dirtyNotebook.setLocal(false);
+    dirtyNotebook.setDirty(true);
+
+    Tag staleTag;
+    staleTag.setName(QStringLiteral("Stale tag"));
+    staleTag.setGuid(UidGenerator::Generate());
+    staleTag.setUpdateSequenceNumber(102);
+    staleTag.setLocal(false);
+    staleTag.setDirty(false);
+
+    Tag dirtyTag;
+    dirtyTag.setName(QStringLiteral("Dirty tag"));
+    dirtyTag.setGuid(UidGenerator::Generate());
+    dirtyTag.setUpdateSequenceNumber(103);
+    dirtyTag.setLocal(false);
+    dirtyTag.setDirty(true);
+
+    SavedSearch staleSearch;
+    staleSearch.setName(QStringLiteral("Stale saved search"));
+    staleSearch.setQuery(QStringLiteral("stale"));
+    staleSearch.setGuid(UidGenerator::Generate());
+    staleSearch.setUpdateSequenceNumber(104);
+    staleSearch.setLocal(false);
+    staleSearch.setDirty(false);
+
+    SavedSearch dirtySearch;
+    dirtySearch.setName(QStringLiteral("Dirty saved search"));
+    dirtySearch.setQuery(QStringLiteral("dirty"));
+    dirtySearch.setGuid(UidGenerator::Generate());
+    dirtySearch.setUpdateSequenceNumber(105);
+    dirtySearch.setLocal(false);
+    dirtySearch.setDirty(true);
+
+    Note staleNote;
+    staleNote.setTitle(QStringLiteral("Stale note"));
+    staleNote.setContent(QStringLiteral("<en-note><h1>Stale note content</h1></en-note>"));
+    staleNote.setGuid(UidGenerator::Generate());
+    staleNote.setUpdateSequenceNumber(106);
+    staleNote.setNotebookLocalUid(FIRST_NOTEBOOK_LOCAL_UID);
+    staleNote.setLocal(false);
+    staleNote.setDirty(false);
+
+    Note dirtyNote;
+    dirtyNote.setTitle(QStringLiteral("Dirty note"));
+    dirtyNote.setContent(QStringLiteral("<en-note><h1>Dirty note content</h1></en-note>"));
+    dirtyNote.setGuid(UidGenerator::Generate());
+    dirtyNote.setUpdateSequenceNumber(107);
+    dirtyNote.setNotebookLocalUid(FIRST_NOTEBOOK_LOCAL_UID);
+    dirtyNote.setLocal(false);
+    dirtyNote.setDirty(true);
+
+    ErrorString errorDescription;
+    if (!pLocalStorageManager->addNotebook(staleNotebook, errorDescription) ||
+        !pLocalStorageManager->addNotebook(dirtyNotebook, errorDescription) ||
+        !pLocalStorageManager->addTag(staleTag, errorDescription) ||
+        !pLocalStorageManager->addTag(dirtyTag, errorDescription) ||
+        !pLocalStorageManager->addSavedSearch(staleSearch, errorDescription) ||
+        !pLocalStorageManager->addSavedSearch(dirtySearch, errorDescription) ||
+        !pLocalStorageManager->addNote(staleNote, errorDescription) ||
+        !pLocalStorageManager->addNote(dirtyNote, errorDescription))
+    {
+        QFAIL(qPrintable(errorDescription.nonLocalizedString()));
+    }
+
+    SyncCachesManager syncCachesManager(*m_pLocalStorageManagerAsync);
+
+    NotebookSyncCache & notebookSyncCache = syncCachesManager.notebookSyncCache();
+    fillSyncCache(notebookSyncCache);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    TagSyncCache & tagSyncCache = syncCachesManager.tagSyncCache();
+    fillSyncCache(tagSyncCache);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    SavedSearchSyncCache & savedSearchSyncCache = syncCachesManager.savedSearchSyncCache();
+    fillSyncCache(savedSearchSyncCache);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    NoteSyncCache & noteSyncCache = syncCachesManager.noteSyncCache();
+    fillSyncCache(noteSyncCache);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Make sure the caches know about the non-synced items before the expunging
+    QVERIFY(notebookSyncCache.nameByGuidHash().contains(staleNotebook.guid()));
+    QVERIFY(notebookSyncCache.nameByGuidHash().contains(dirtyNotebook.guid()));
+    QVERIFY(tagSyncCache.nameByGuidHash().contains(staleTag.guid()));
+    QVERIFY(tagSyncCache.nameByGuidHash().contains(dirtyTag.guid()));
+    QVERIFY(savedSearchSyncCache.nameByGuidHash().contains(staleSearch.guid()));
+    QVERIFY(savedSearchSyncCache.nameByGuidHash().contains(dirtySearch.guid()));
+    QVERIFY(noteSyncCache.noteSyncInfoByGuid().contains(staleNote.guid()));
+    QVERIFY(noteSyncCache.noteSyncInfoByGuid().contains(dirtyNote.guid()));
+
+    runExpunger();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // The caches are expected to follow the expunging without being refilled
+    QVERIFY(notebookSyncCache.isFilled());
+    QVERIFY(tagSyncCache.isFilled());
+    QVERIFY(savedSearchSyncCache.isFilled());
+    QVERIFY(noteSyncCache.isFilled());
+
+    // Stale items are expunged so they must be gone from the caches entirely
+    QVERIFY(!notebookSyncCache.nameByLocalUidHash().contains(staleNotebook.localUid()));
+    QVERIFY(!notebookSyncCache.nameByGuidHash().contains(staleNotebook.guid()));
+    QVERIFY(!notebookSyncCache.guidByNameHash().contains(staleNotebook.name().toLower()));
+
+    QVERIFY(!tagSyncCache.nameByLocalUidHash().contains(staleTag.localUid()));
+    QVERIFY(!tagSyncCache.nameByGuidHash().contains(staleTag.guid()));
+    QVERIFY(!tagSyncCache.guidByNameHash().contains(staleTag.name().toLower()));
+
+    QVERIFY(!savedSearchSyncCache.nameByLocalUidHash().contains(staleSearch.localUid()));
+    QVERIFY(!savedSearchSyncCache.nameByGuidHash().contains(staleSearch.guid()));
+    QVERIFY(!savedSearchSyncCache.guidByNameHash().contains(staleSearch.name().toLower()));
+
+    QVERIFY(!noteSyncCache.noteSyncInfoByGuid().contains(staleNote.guid()));
+    QVERIFY(!noteSyncCache.notebookGuidByNoteGuid().contains(staleNote.guid()));
+
+    // Dirty items are detached: they keep their names but lose the guid mappings
+    QVERIFY(notebookSyncCache.nameByLocalUidHash().contains(dirtyNotebook.localUid()));
+    QVERIFY(!notebookSyncCache.nameByGuidHash().contains(dirtyNotebook.guid()));
+    QVERIFY(!notebookSyncCache.guidByNameHash().contains(dirtyNotebook.name().toLower()));
+    QVERIFY(!notebookSyncCache.dirtyNotebooksByGuidHash().contains(dirtyNotebook.guid()));
+
+    QVERIFY(tagSyncCache.nameByLocalUidHash().contains(dirtyTag.localUid()));
+    QVERIFY(!tagSyncCache.nameByGuidHash().contains(dirtyTag.guid()));
+    QVERIFY(!tagSyncCache.guidByNameHash().contains(dirtyTag.name().toLower()));
+    QVERIFY(!tagSyncCache.dirtyTagsByGuidHash().contains(dirtyTag.guid()));
+
+    QVERIFY(savedSearchSyncCache.nameByLocalUidHash().contains(dirtySearch.localUid()));
+    QVERIFY(!savedSearchSyncCache.nameByGuidHash().contains(dirtySearch.guid()));
+    QVERIFY(!savedSearchSyncCache.guidByNameHash().contains(dirtySearch.name().toLower()));
+    QVERIFY(!savedSearchSyncCache.dirtySavedSearchesByGuid().contains(dirtySearch.guid()));
+
+    // Detached notes are no longer referenced by their guids so the note cache drops them entirely
+    QVERIFY(!noteSyncCache.noteSyncInfoByGuid().contains(dirtyNote.guid()));
+    QVERIFY(!noteSyncCache.notebookGuidByNoteGuid().contains(dirtyNote.guid()));
+
+    // Synced items must stay intact
+    for(auto it = m_syncedGuids.m_syncedNotebookGuids.constBegin(), end = m_syncedGuids.m_syncedNotebookGuids.constEnd(); it != end; ++it) {
+        QVERIFY(notebookSyncCache.nameByGuidHash().contains(*it));
+    }
+
+    for(auto it = m_syncedGuids.m_syncedTagGuids.constBegin(), end = m_syncedGuids.m_syncedTagGuids.constEnd(); it != end; ++it) {
+        QVERIFY(tagSyncCache.nameByGuidHash().contains(*it));
+    }
+
+    for(auto it = m_syncedGuids.m_syncedSavedSearchGuids.constBegin(), end = m_syncedGuids.m_syncedSavedSearchGuids.constEnd(); it != end; ++it) {
+        QVERIFY(savedSearchSyncCache.nameByGuidHash().contains(*it));
+    }
+
+    for(auto it = m_syncedGuids.m_syncedNoteGuids.constBegin(), end = m_syncedGuids.m_syncedNoteGuids.constEnd(); it != end; ++it) {
+        QVERIFY(noteSyncCache.noteSyncInfoByGuid().contains(*it));
+    }
+}
+
 void FullSyncStaleDataItemsExpungerTester::setupBaseDataItems()
 {
     if (Q_UNLIKELY(!m_pLocalStorageManagerAsync)) {
@@ -1866,10 +2071,6 @@ void FullSyncStaleDataItemsExpungerTester::doTest(const bool useBaseDataItems,
         QFAIL("Detected null pointer to LocalStorageManager");
     }
 
-    if (Q_UNLIKELY(!m_pSavedSearchSyncCache)) {
-        QFAIL("Detected null pointer to SavedSearchSyncCache");
-    }
-
     if (useBaseDataItems) {
         setupBaseDataItems();
     }
@@ -1918,37 +2119,9 @@ void FullSyncStaleDataItemsExpungerTester::doTest(const bool useBaseDataItems,
         }
     }
 
-    FullSyncStaleDataItemsExpunger expunger(*m_pLocalStorageManagerAsync, *m_pNotebookSyncCache, *m_pTagSyncCache,
-                                            *m_pSavedSearchSyncCache, m_syncedGuids, QString());
-
-    int expungerTestResult = -1;
-    {
-        QTimer timer;
-        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
-        timer.setSingleShot(true);
-
-        EventLoopWithExitStatus loop;
-        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
-        QObject::connect(&expunger, QNSIGNAL(FullSyncStaleDataItemsExpunger,finished), &loop, QNSLOT(EventLoopWithExitStatus,exitAsSuccess));
-        QObject::connect(&expunger, SIGNAL(failure(ErrorString)), &loop, SLOT(exitAsFailure()));
-
-        QTimer slotInvokingTimer;
-        slotInvokingTimer.setInterval(500);
-        slotInvokingTimer.setSingleShot(true);
-
-        timer.start();
-        slotInvokingTimer.singleShot(0, &expunger, SLOT(start()));
-        expungerTestResult = loop.exec();
-    }
-
-    if (expungerTestResult == -1) {
-        QFAIL("Internal error: incorrect return status from FullSyncStaleDataItemsExpunger");
-    }
-    else if (expungerTestResult == EventLoopWithExitStatus::ExitStatus::Failure) {
-        QFAIL("Detected failure during the asynchronous loop processing in FullSyncStaleDataItemsExpunger");
-    }
-    else if (expungerTestResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
-        QFAIL("FullSyncStaleDataItemsExpunger failed to finish in time");
+    runExpunger();
+    if (QTest::currentTestFailed()) {
+        return;
     }
 
     // ====== Check remaining notebooks, verify each of them was intended to be preserved + verify all of notebooks
@@ -2226,5 +2399,40 @@ void FullSyncStaleDataItemsExpungerTester::doTest(const bool useBaseDataItems,
     }
 }
 
+void FullSyncStaleDataItemsExpungerTester::runExpunger()
+{
+    FullSyncStaleDataItemsExpunger expunger(*m_pLocalStorageManagerAsync, m_syncedGuids, QString());
+
+    int expungerTestResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(&expunger, QNSIGNAL(FullSyncStaleDataItemsExpunger,finished), &loop, QNSLOT(EventLoopWithExitStatus,exitAsSuccess));
+        QObject::connect(&expunger, SIGNAL(failure(ErrorString)), &loop, SLOT(exitAsFailure()));
+
+        QTimer slotInvokingTimer;
+        slotInvokingTimer.setInterval(500);
+        slotInvokingTimer.setSingleShot(true);
+
+        timer.start();
+        slotInvokingTimer.singleShot(0, &expunger, SLOT(start()));
+        expungerTestResult = loop.exec();
+    }
+
+    if (expungerTestResult == -1) {
+        QFAIL("Internal error: incorrect return status from FullSyncStaleDataItemsExpunger");
+    }
+    else if (expungerTestResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Detected failure during the asynchronous loop processing in FullSyncStaleDataItemsExpunger");
+    }
+    else if (expungerTestResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("FullSyncStaleDataItemsExpunger failed to finish in time");
+    }
+}
+
 } // namespace test
 } // namespace quentier
@@ -81,6 +81,8 @@ private Q_SLOTS:
     void testDirtyNoteWithStaleNotebook();
     void testDirtyTagWithStaleParentTag();
 
+    void testSyncCachesFollowStaleAndDirtyItems();
+
 private:
     void setupBaseDataItems();
 
@@ -90,15 +92,13 @@ private:
                 const QList<SavedSearch> & nonSyncedSavedSearches,
                 const QList<Note> & nonSyncedNotes);
 
+    void runExpunger();
+
 private:
     Account                     m_testAccount;
     LocalStorageManagerAsync *  m_pLocalStorageManagerAsync;
     FullSyncStaleDataItemsExpunger::SyncedGuids     m_syncedGuids;
 
-    NotebookSyncCache *         m_pNotebookSyncCache;
-    TagSyncCache *              m_pTagSyncCache;
-    SavedSearchSyncCache *      m_pSavedSearchSyncCache;
-
     bool    m_detectedTestFailure;
 };
 
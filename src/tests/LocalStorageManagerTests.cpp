@@ -19,6 +19,7 @@
 #include "LocalStorageManagerTests.h"
 #include <quentier/logging/QuentierLogger.h>
 #include <quentier/local_storage/LocalStorageManager.h>
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
 #include <quentier/types/SavedSearch.h>
 #include <quentier/types/LinkedNotebook.h>
 #include <quentier/types/Tag.h>
@@ -29,7 +30,11 @@
 #include <quentier/types/User.h>
 #include <quentier/utility/Utility.h>
 #include <quentier/utility/UidGenerator.h>
+#include <quentier/utility/StandardPaths.h>
 #include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QSignalSpy>
 #include <string>
 
 namespace quentier {
@@ -3043,5 +3048,1087 @@ bool TestNoteTagIdsComplementWhenAddingAndUpdatingNote(QString & errorDescriptio
     return true;
 }
 
+bool TestChangeJournalInLocalStorage(QString & errorDescription)
+{
+    // 1) ========== Create LocalStorageManager =============
+
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageManagerChangeJournalTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager localStorageManager(account, startFromScratch, overrideLock);
+
+    ErrorString error;
+
+    qint64 initialSequenceNumber = localStorageManager.lastChangeSequenceNumber(error);
+    if (initialSequenceNumber < 0) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    // 2) ========== Add notebook, tag and note ==========
+
+    Notebook notebook;
+    notebook.setGuid(UidGenerator::Generate());
+    notebook.setName(QStringLiteral("Fake notebook name"));
+
+    error.clear();
+    bool res = localStorageManager.addNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Tag tag;
+    tag.setGuid(UidGenerator::Generate());
+    tag.setName(QStringLiteral("Fake tag name"));
+
+    error.clear();
+    res = localStorageManager.addTag(tag, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Note note;
+    note.setGuid(UidGenerator::Generate());
+    note.setNotebookGuid(notebook.guid());
+    note.setNotebookLocalUid(notebook.localUid());
+    note.setTitle(QStringLiteral("Fake note title"));
+    note.setContent(QStringLiteral("<en-note><h1>Hello, world</h1></en-note>"));
+
+    error.clear();
+    res = localStorageManager.addNote(note, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    // 3) ========== Update the note's tags only ==========
+
+    note.addTagGuid(tag.guid());
+    note.addTagLocalUid(tag.localUid());
+
+    error.clear();
+    res = localStorageManager.updateNote(note, /* update resources = */ false, /* update tags = */ true, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    // 4) ========== Expunge the notebook, the note should be expunged along with it ==========
+
+    error.clear();
+    res = localStorageManager.expungeNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    // 5) ========== Verify the change journal contents ==========
+
+    error.clear();
+    QList<ChangeJournalEntry> entries = localStorageManager.listChangesSince(initialSequenceNumber, error);
+    if (entries.isEmpty()) {
+        errorDescription = QStringLiteral("No changes were found in the change journal: ") + error.nonLocalizedString();
+        return false;
+    }
+
+    if (entries.size() != 6) {
+        errorDescription = QStringLiteral("Unexpected number of change journal entries: expected 6, got ") +
+                           QString::number(entries.size());
+        QNWARNING(errorDescription << QStringLiteral(", entries: ") << entries);
+        return false;
+    }
+
+    for(int i = 1, size = entries.size(); i < size; ++i)
+    {
+        if (entries[i].sequenceNumber <= entries[i-1].sequenceNumber) {
+            errorDescription = QStringLiteral("Change journal entries' sequence numbers are not monotonically increasing");
+            QNWARNING(errorDescription << QStringLiteral(", entries: ") << entries);
+            return false;
+        }
+    }
+
+#define CHECK_CHANGE_JOURNAL_ENTRY(index, entity, change, uid) \
+    if ((entries[index].entityType != ChangeJournalEntry::EntityType::entity) || \
+        (entries[index].changeType != ChangeJournalEntry::ChangeType::change) || \
+        (entries[index].localUid != uid)) \
+    { \
+        errorDescription = QStringLiteral("Unexpected change journal entry at index ") + QString::number(index); \
+        QNWARNING(errorDescription << QStringLiteral(": ") << entries[index]); \
+        return false; \
+    }
+
+    CHECK_CHANGE_JOURNAL_ENTRY(0, Notebook, Add, notebook.localUid())
+    CHECK_CHANGE_JOURNAL_ENTRY(1, Tag, Add, tag.localUid())
+    CHECK_CHANGE_JOURNAL_ENTRY(2, Note, Add, note.localUid())
+    CHECK_CHANGE_JOURNAL_ENTRY(3, Note, Update, note.localUid())
+    CHECK_CHANGE_JOURNAL_ENTRY(4, Note, Expunge, note.localUid())
+    CHECK_CHANGE_JOURNAL_ENTRY(5, Notebook, Expunge, notebook.localUid())
+
+#undef CHECK_CHANGE_JOURNAL_ENTRY
+
+    QStringList expectedChangedFields;
+    expectedChangedFields << QStringLiteral("note") << QStringLiteral("tags");
+    if (entries[3].changedFields != expectedChangedFields) {
+        errorDescription = QStringLiteral("Unexpected changed fields in the change journal entry for note update: ") +
+                           entries[3].changedFields.join(QStringLiteral(", "));
+        return false;
+    }
+
+    // 6) ========== Verify limit and trimming ==========
+
+    error.clear();
+    entries = localStorageManager.listChangesSince(initialSequenceNumber, error, 2);
+    if (entries.size() != 2) {
+        errorDescription = QStringLiteral("Unexpected number of change journal entries listed with limit: expected 2, got ") +
+                           QString::number(entries.size());
+        return false;
+    }
+
+    error.clear();
+    qint64 lastSequenceNumber = localStorageManager.lastChangeSequenceNumber(error);
+    if (lastSequenceNumber < 0) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    error.clear();
+    res = localStorageManager.trimChangeJournal(lastSequenceNumber, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    error.clear();
+    entries = localStorageManager.listChangesSince(initialSequenceNumber, error);
+    if (!entries.isEmpty()) {
+        errorDescription = QStringLiteral("Found change journal entries after trimming the whole journal");
+        return false;
+    }
+
+    error.clear();
+    qint64 sequenceNumberAfterTrimming = localStorageManager.lastChangeSequenceNumber(error);
+    if (sequenceNumberAfterTrimming != lastSequenceNumber) {
+        errorDescription = QStringLiteral("The last change sequence number has changed after trimming the journal");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestLocalStorageStatistics(QString & errorDescription)
+{
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageManagerStatisticsTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager localStorageManager(account, startFromScratch, overrideLock);
+
+    if (!localStorageManager.statisticsCollectionEnabled()) {
+        errorDescription = QStringLiteral("Local storage statistics collection is not enabled by default");
+        return false;
+    }
+
+    localStorageManager.resetStatistics();
+
+    // Make every query "slow" in order to ensure the slow query log gets filled
+    localStorageManager.setSlowQueryThreshold(0);
+
+    Notebook notebook;
+    notebook.setGuid(UidGenerator::Generate());
+    notebook.setName(QStringLiteral("Fake notebook name"));
+
+    ErrorString error;
+    bool res = localStorageManager.addNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    for(int i = 0; i < 3; ++i)
+    {
+        Notebook foundNotebook;
+        foundNotebook.setLocalUid(notebook.localUid());
+
+        error.clear();
+        res = localStorageManager.findNotebook(foundNotebook, error);
+        if (!res) {
+            errorDescription = error.nonLocalizedString();
+            return false;
+        }
+    }
+
+    LocalStorageStatistics statistics = localStorageManager.statistics();
+
+    auto addNotebookIt = statistics.operations.find(QStringLiteral("addNotebook"));
+    if ((addNotebookIt == statistics.operations.end()) || (addNotebookIt.value().count != 1)) {
+        errorDescription = QStringLiteral("Local storage statistics don't contain the single addNotebook operation");
+        QNWARNING(errorDescription << QStringLiteral(": ") << statistics);
+        return false;
+    }
+
+    auto findNotebookIt = statistics.operations.find(QStringLiteral("findNotebook"));
+    if ((findNotebookIt == statistics.operations.end()) || (findNotebookIt.value().count != 3)) {
+        errorDescription = QStringLiteral("Local storage statistics don't contain three findNotebook operations");
+        QNWARNING(errorDescription << QStringLiteral(": ") << statistics);
+        return false;
+    }
+
+    quint64 histogramTotal = 0;
+    const QVector<quint64> & histogram = findNotebookIt.value().latencyHistogram;
+    for(int i = 0, size = histogram.size(); i < size; ++i) {
+        histogramTotal += histogram[i];
+    }
+
+    if (histogramTotal != 3) {
+        errorDescription = QStringLiteral("The latency histogram of findNotebook operation doesn't sum up to the number of operations");
+        QNWARNING(errorDescription << QStringLiteral(": ") << statistics);
+        return false;
+    }
+
+    if (statistics.queries.isEmpty()) {
+        errorDescription = QStringLiteral("Local storage statistics contain no SQL query counters");
+        return false;
+    }
+
+    if (statistics.slowQueries.isEmpty()) {
+        errorDescription = QStringLiteral("The slow query log is empty despite the zero slow query threshold");
+        return false;
+    }
+
+    localStorageManager.resetStatistics();
+    statistics = localStorageManager.statistics();
+    if (!statistics.operations.isEmpty() || !statistics.queries.isEmpty() || !statistics.slowQueries.isEmpty()) {
+        errorDescription = QStringLiteral("Local storage statistics are not empty after the reset");
+        QNWARNING(errorDescription << QStringLiteral(": ") << statistics);
+        return false;
+    }
+
+    if (statistics.slowQueryThresholdUsec != 0) {
+        errorDescription = QStringLiteral("The slow query threshold was not preserved after the statistics reset");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestLocalStorageSnapshotExportImport(QString & errorDescription)
+{
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account sourceAccount(QStringLiteral("LocalStorageManagerSnapshotSourceTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager sourceLocalStorageManager(sourceAccount, startFromScratch, overrideLock);
+
+    Notebook notebook;
+    notebook.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000047"));
+    notebook.setUpdateSequenceNumber(1);
+    notebook.setName(QStringLiteral("Fake notebook name"));
+    notebook.setCreationTimestamp(1);
+    notebook.setModificationTimestamp(1);
+
+    ErrorString error;
+    bool res = sourceLocalStorageManager.addNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Note note;
+    note.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000048"));
+    note.setUpdateSequenceNumber(42);
+    note.setTitle(QStringLiteral("Fake note title"));
+    note.setContent(QStringLiteral("<en-note><h1>Hello, world</h1></en-note>"));
+    note.setCreationTimestamp(1);
+    note.setModificationTimestamp(1);
+    note.setNotebookGuid(notebook.guid());
+    note.setNotebookLocalUid(notebook.localUid());
+
+    error.clear();
+    res = sourceLocalStorageManager.addNote(note, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    LinkedNotebook linkedNotebook;
+    linkedNotebook.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000050"));
+    linkedNotebook.setUpdateSequenceNumber(2);
+    linkedNotebook.setShareName(QStringLiteral("Fake linked notebook share name"));
+    linkedNotebook.setUsername(QStringLiteral("Fake linked notebook username"));
+    linkedNotebook.setShardId(QStringLiteral("Fake linked notebook shard id"));
+    linkedNotebook.setSharedNotebookGlobalId(QStringLiteral("Fake linked notebook shared notebook global id"));
+    linkedNotebook.setUri(QStringLiteral("Fake linked notebook uri"));
+    linkedNotebook.setNoteStoreUrl(QStringLiteral("Fake linked notebook note store url"));
+    linkedNotebook.setWebApiUrlPrefix(QStringLiteral("Fake linked notebook web api url prefix"));
+
+    error.clear();
+    res = sourceLocalStorageManager.addLinkedNotebook(linkedNotebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Notebook linkedNotebookNotebook;
+    linkedNotebookNotebook.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000051"));
+    linkedNotebookNotebook.setUpdateSequenceNumber(17);
+    linkedNotebookNotebook.setName(QStringLiteral("Fake linked notebook's notebook name"));
+    linkedNotebookNotebook.setCreationTimestamp(1);
+    linkedNotebookNotebook.setModificationTimestamp(1);
+    linkedNotebookNotebook.setLinkedNotebookGuid(linkedNotebook.guid());
+
+    error.clear();
+    res = sourceLocalStorageManager.addNotebook(linkedNotebookNotebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    QString snapshotFilePath = applicationPersistentStoragePath() + QStringLiteral("/LocalStorageSnapshotTest.sqlite");
+
+    qint64 timestampBeforeExport = QDateTime::currentMSecsSinceEpoch();
+
+    LocalStorageSnapshotInfo exportedSnapshotInfo;
+    error.clear();
+    res = sourceLocalStorageManager.exportSnapshot(snapshotFilePath, exportedSnapshotInfo, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if (exportedSnapshotInfo.highUsn != note.updateSequenceNumber()) {
+        errorDescription = QStringLiteral("The high USN of the exported snapshot is unexpected: ") +
+                           QString::number(exportedSnapshotInfo.highUsn);
+        return false;
+    }
+
+    if ((exportedSnapshotInfo.highUsnByLinkedNotebookGuid.size() != 1) ||
+        (exportedSnapshotInfo.highUsnByLinkedNotebookGuid.value(linkedNotebook.guid(), -1) !=
+         linkedNotebookNotebook.updateSequenceNumber()))
+    {
+        errorDescription = QStringLiteral("The linked notebook high USNs of the exported snapshot are unexpected");
+        QNWARNING(errorDescription << QStringLiteral(": ") << exportedSnapshotInfo);
+        return false;
+    }
+
+    if (exportedSnapshotInfo.creationTimestamp < timestampBeforeExport) {
+        errorDescription = QStringLiteral("The creation timestamp of the exported snapshot is unexpected");
+        QNWARNING(errorDescription << QStringLiteral(": ") << exportedSnapshotInfo);
+        return false;
+    }
+
+    // Changes made after the export must not be present within the snapshot
+    Notebook anotherNotebook;
+    anotherNotebook.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000049"));
+    anotherNotebook.setUpdateSequenceNumber(43);
+    anotherNotebook.setName(QStringLiteral("Another fake notebook name"));
+
+    error.clear();
+    res = sourceLocalStorageManager.addNotebook(anotherNotebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Account targetAccount(QStringLiteral("LocalStorageManagerSnapshotTargetTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager targetLocalStorageManager(targetAccount, startFromScratch, overrideLock);
+
+    LocalStorageSnapshotInfo importedSnapshotInfo;
+    error.clear();
+    res = targetLocalStorageManager.importSnapshot(snapshotFilePath, importedSnapshotInfo, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if ((importedSnapshotInfo.highUsn != exportedSnapshotInfo.highUsn) ||
+        (importedSnapshotInfo.highUsnByLinkedNotebookGuid != exportedSnapshotInfo.highUsnByLinkedNotebookGuid) ||
+        (importedSnapshotInfo.creationTimestamp != exportedSnapshotInfo.creationTimestamp))
+    {
+        errorDescription = QStringLiteral("The info of the imported snapshot doesn't match the one of the exported snapshot");
+        QNWARNING(errorDescription << QStringLiteral(": exported: ") << exportedSnapshotInfo
+                  << QStringLiteral("\nImported: ") << importedSnapshotInfo);
+        return false;
+    }
+
+    // Neither the copy of the snapshot nor the backup of the replaced database file should be left behind
+    QString targetDatabaseFilePath = accountPersistentStoragePath(targetAccount) + QStringLiteral("/qn.storage.sqlite");
+    if (QFile::exists(targetDatabaseFilePath + QStringLiteral(".import")) ||
+        QFile::exists(targetDatabaseFilePath + QStringLiteral(".backup")))
+    {
+        errorDescription = QStringLiteral("Found the leftover temporary files after the successful snapshot import");
+        return false;
+    }
+
+    error.clear();
+    qint32 accountHighUsn = targetLocalStorageManager.accountHighUsn(QString(), error);
+    if (accountHighUsn != exportedSnapshotInfo.highUsn) {
+        errorDescription = QStringLiteral("Account high USN after the snapshot import doesn't match the snapshot's high USN: ") +
+                           QString::number(accountHighUsn);
+        return false;
+    }
+
+    Note foundNote;
+    foundNote.setLocalUid(note.localUid());
+
+    error.clear();
+    res = targetLocalStorageManager.findNote(foundNote, error, /* with resource binary data = */ false);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if (foundNote.title() != note.title()) {
+        errorDescription = QStringLiteral("The note found after the snapshot import doesn't match the original one");
+        QNWARNING(errorDescription << QStringLiteral(": original note: ") << note << QStringLiteral("\nFound note: ") << foundNote);
+        return false;
+    }
+
+    Notebook foundNotebook;
+    foundNotebook.setLocalUid(anotherNotebook.localUid());
+
+    error.clear();
+    res = targetLocalStorageManager.findNotebook(foundNotebook, error);
+    if (res) {
+        errorDescription = QStringLiteral("Found the notebook added after the snapshot export in the local storage "
+                                          "restored from the snapshot");
+        return false;
+    }
+
+    // The imported local storage should be fully functional
+    error.clear();
+    res = targetLocalStorageManager.addNotebook(anotherNotebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    // Importing something which is not a snapshot should fail without damaging the local storage
+    QString bogusSnapshotFilePath = applicationPersistentStoragePath() + QStringLiteral("/LocalStorageBogusSnapshotTest.sqlite");
+    QFile bogusSnapshotFile(bogusSnapshotFilePath);
+    if (!bogusSnapshotFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorDescription = QStringLiteral("Can't open the bogus snapshot file for writing");
+        return false;
+    }
+
+    Q_UNUSED(bogusSnapshotFile.write(QByteArray("This is not a local storage snapshot")))
+    bogusSnapshotFile.close();
+
+    error.clear();
+    res = targetLocalStorageManager.importSnapshot(bogusSnapshotFilePath, importedSnapshotInfo, error);
+    Q_UNUSED(QFile::remove(bogusSnapshotFilePath))
+    Q_UNUSED(QFile::remove(snapshotFilePath))
+
+    if (res) {
+        errorDescription = QStringLiteral("Imported the bogus snapshot into the local storage");
+        return false;
+    }
+
+    if (!QFile::exists(targetDatabaseFilePath) || QFile::exists(targetDatabaseFilePath + QStringLiteral(".backup"))) {
+        errorDescription = QStringLiteral("The local storage database file was not restored after the failed snapshot import");
+        return false;
+    }
+
+    error.clear();
+    int noteCount = targetLocalStorageManager.noteCount(error);
+    if (noteCount != 1) {
+        errorDescription = QStringLiteral("Unexpected note count after the failed attempt to import the bogus snapshot: ") +
+                           QString::number(noteCount);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestStaleDataItemsExpungingInLocalStorage(QString & errorDescription)
+{
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageManagerStaleDataItemsTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager localStorageManager(account, startFromScratch, overrideLock);
+
+    ErrorString error;
+
+    Notebook syncedNotebook;
+    syncedNotebook.setGuid(UidGenerator::Generate());
+    syncedNotebook.setUpdateSequenceNumber(1);
+    syncedNotebook.setName(QStringLiteral("Synced notebook"));
+    syncedNotebook.setDirty(false);
+
+    Notebook staleNotebook;
+    staleNotebook.setGuid(UidGenerator::Generate());
+    staleNotebook.setUpdateSequenceNumber(2);
+    staleNotebook.setName(QStringLiteral("Stale notebook"));
+    staleNotebook.setDirty(false);
+
+    Notebook dirtyStaleNotebook;
+    dirtyStaleNotebook.setGuid(UidGenerator::Generate());
+    dirtyStaleNotebook.setUpdateSequenceNumber(3);
+    dirtyStaleNotebook.setName(QStringLiteral("Dirty stale notebook"));
+    dirtyStaleNotebook.setDirty(true);
+
+    QList<Notebook> notebooks;
+    notebooks << syncedNotebook << staleNotebook << dirtyStaleNotebook;
+    for(auto it = notebooks.begin(), end = notebooks.end(); it != end; ++it)
+    {
+        error.clear();
+        if (!localStorageManager.addNotebook(*it, error)) {
+            errorDescription = error.nonLocalizedString();
+            return false;
+        }
+    }
+
+    Tag syncedTag;
+    syncedTag.setGuid(UidGenerator::Generate());
+    syncedTag.setUpdateSequenceNumber(4);
+    syncedTag.setName(QStringLiteral("Synced tag"));
+    syncedTag.setDirty(false);
+
+    Tag staleTag;
+    staleTag.setGuid(UidGenerator::Generate());
+    staleTag.setUpdateSequenceNumber(5);
+    staleTag.setName(QStringLiteral("Stale tag"));
+    staleTag.setDirty(false);
+
+    Tag dirtyStaleChildTag;
+    dirtyStaleChildTag.setGuid(UidGenerator::Generate());
+    dirtyStaleChildTag.setUpdateSequenceNumber(6);
+    dirtyStaleChildTag.setName(QStringLiteral("Dirty stale child tag"));
+    dirtyStaleChildTag.setParentGuid(staleTag.guid());
+    dirtyStaleChildTag.setParentLocalUid(staleTag.localUid());
+    dirtyStaleChildTag.setDirty(true);
+
+    QList<Tag> tags;
+    tags << syncedTag << staleTag << dirtyStaleChildTag;
+    for(auto it = tags.begin(), end = tags.end(); it != end; ++it)
+    {
+        error.clear();
+        if (!localStorageManager.addTag(*it, error)) {
+            errorDescription = error.nonLocalizedString();
+            return false;
+        }
+    }
+
+    SavedSearch syncedSearch;
+    syncedSearch.setGuid(UidGenerator::Generate());
+    syncedSearch.setUpdateSequenceNumber(7);
+    syncedSearch.setName(QStringLiteral("Synced saved search"));
+    syncedSearch.setQuery(QStringLiteral("synced"));
+    syncedSearch.setDirty(false);
+
+    SavedSearch staleSearch;
+    staleSearch.setGuid(UidGenerator::Generate());
+    staleSearch.setUpdateSequenceNumber(8);
+    staleSearch.setName(QStringLiteral("Stale saved search"));
+    staleSearch.setQuery(QStringLiteral("stale"));
+    staleSearch.setDirty(false);
+
+    SavedSearch dirtyStaleSearch;
+    dirtyStaleSearch.setGuid(UidGenerator::Generate());
+    dirtyStaleSearch.setUpdateSequenceNumber(9);
+    dirtyStaleSearch.setName(QStringLiteral("Dirty stale saved search"));
+    dirtyStaleSearch.setQuery(QStringLiteral("dirty stale"));
+    dirtyStaleSearch.setDirty(true);
+
+    QList<SavedSearch> searches;
+    searches << syncedSearch << staleSearch << dirtyStaleSearch;
+    for(auto it = searches.begin(), end = searches.end(); it != end; ++it)
+    {
+        error.clear();
+        if (!localStorageManager.addSavedSearch(*it, error)) {
+            errorDescription = error.nonLocalizedString();
+            return false;
+        }
+    }
+
+    Note syncedNote;
+    syncedNote.setGuid(UidGenerator::Generate());
+    syncedNote.setUpdateSequenceNumber(10);
+    syncedNote.setTitle(QStringLiteral("Synced note"));
+    syncedNote.setNotebookGuid(syncedNotebook.guid());
+    syncedNote.setNotebookLocalUid(syncedNotebook.localUid());
+    syncedNote.setDirty(false);
+
+    Note staleNote;
+    staleNote.setGuid(UidGenerator::Generate());
+    staleNote.setUpdateSequenceNumber(11);
+    staleNote.setTitle(QStringLiteral("Stale note"));
+    staleNote.setNotebookGuid(syncedNotebook.guid());
+    staleNote.setNotebookLocalUid(syncedNotebook.localUid());
+    staleNote.setDirty(false);
+
+    Resource staleNoteResource;
+    staleNoteResource.setGuid(UidGenerator::Generate());
+    staleNoteResource.setUpdateSequenceNumber(14);
+    staleNoteResource.setNoteGuid(staleNote.guid());
+    staleNoteResource.setNoteLocalUid(staleNote.localUid());
+    staleNoteResource.setDataBody(QByteArray("Fake resource data body"));
+    staleNoteResource.setDataSize(staleNoteResource.dataBody().size());
+    staleNoteResource.setDataHash(QByteArray("Fake hash      1"));
+    staleNoteResource.setMime(QStringLiteral("text/plain"));
+    staleNote.addResource(staleNoteResource);
+
+    Note dirtyStaleNote;
+    dirtyStaleNote.setGuid(UidGenerator::Generate());
+    dirtyStaleNote.setUpdateSequenceNumber(12);
+    dirtyStaleNote.setTitle(QStringLiteral("Dirty stale note"));
+    dirtyStaleNote.setNotebookGuid(syncedNotebook.guid());
+    dirtyStaleNote.setNotebookLocalUid(syncedNotebook.localUid());
+    dirtyStaleNote.setDirty(true);
+
+    // The note from the stale notebook is expunged along with its notebook even though it is dirty
+    Note dirtyNoteFromStaleNotebook;
+    dirtyNoteFromStaleNotebook.setGuid(UidGenerator::Generate());
+    dirtyNoteFromStaleNotebook.setUpdateSequenceNumber(13);
+    dirtyNoteFromStaleNotebook.setTitle(QStringLiteral("Dirty note from stale notebook"));
+    dirtyNoteFromStaleNotebook.setNotebookGuid(staleNotebook.guid());
+    dirtyNoteFromStaleNotebook.setNotebookLocalUid(staleNotebook.localUid());
+    dirtyNoteFromStaleNotebook.setDirty(true);
+
+    QList<Note> notes;
+    notes << syncedNote << staleNote << dirtyStaleNote << dirtyNoteFromStaleNotebook;
+    for(auto it = notes.begin(), end = notes.end(); it != end; ++it)
+    {
+        Note & note = *it;
+        note.setContent(QStringLiteral("<en-note><h1>Hello, world</h1></en-note>"));
+        note.setCreationTimestamp(1);
+        note.setModificationTimestamp(1);
+
+        error.clear();
+        if (!localStorageManager.addNote(note, error)) {
+            errorDescription = error.nonLocalizedString();
+            return false;
+        }
+    }
+
+    QSet<QString> syncedNotebookGuids;
+    syncedNotebookGuids << syncedNotebook.guid();
+
+    QSet<QString> syncedTagGuids;
+    syncedTagGuids << syncedTag.guid();
+
+    QSet<QString> syncedNoteGuids;
+    syncedNoteGuids << syncedNote.guid();
+
+    QSet<QString> syncedSavedSearchGuids;
+    syncedSavedSearchGuids << syncedSearch.guid();
+
+    error.clear();
+    qint64 sequenceNumberBeforeExpunging = localStorageManager.lastChangeSequenceNumber(error);
+    if (sequenceNumberBeforeExpunging < 0) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    StaleDataItemsExpungeResult result;
+    error.clear();
+    bool res = localStorageManager.expungeStaleDataItems(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids,
+                                                         syncedSavedSearchGuids, QString(), result, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    QStringList expectedExpungedNoteLocalUids;
+    expectedExpungedNoteLocalUids << staleNote.localUid() << dirtyNoteFromStaleNotebook.localUid();
+
+    QStringList expungedNoteLocalUids = result.expungedNoteLocalUids;
+    expungedNoteLocalUids.sort();
+    expectedExpungedNoteLocalUids.sort();
+
+    if ((result.expungedNotebookLocalUids != QStringList(staleNotebook.localUid())) ||
+        (result.detachedNotebookLocalUids != QStringList(dirtyStaleNotebook.localUid())) ||
+        (result.expungedTagLocalUids != QStringList(staleTag.localUid())) ||
+        (result.detachedTagLocalUids != QStringList(dirtyStaleChildTag.localUid())) ||
+        (expungedNoteLocalUids != expectedExpungedNoteLocalUids) ||
+        (result.detachedNoteLocalUids != QStringList(dirtyStaleNote.localUid())) ||
+        (result.expungedSavedSearchLocalUids != QStringList(staleSearch.localUid())) ||
+        (result.detachedSavedSearchLocalUids != QStringList(dirtyStaleSearch.localUid())))
+    {
+        errorDescription = QStringLiteral("Unexpected result of stale data items expunging");
+        QNWARNING(errorDescription << QStringLiteral(": ") << result);
+        return false;
+    }
+
+    // The expunged data items are journaled by the deletion triggers in the order of deletion, the items
+    // expunged implicitly along with others come before them; the detached items are journaled as updates
+    error.clear();
+    QList<ChangeJournalEntry> entries = localStorageManager.listChangesSince(sequenceNumberBeforeExpunging, error);
+    if (entries.size() != 10) {
+        errorDescription = QStringLiteral("Unexpected number of change journal entries after stale data items expunging: "
+                                          "expected 10, got ") + QString::number(entries.size());
+        QNWARNING(errorDescription << QStringLiteral(", entries: ") << entries << QStringLiteral(", error: ") << error);
+        return false;
+    }
+
+#define CHECK_CHANGE_JOURNAL_ENTRY(index, entity, change, uid, fields) \
+    if ((entries[index].entityType != ChangeJournalEntry::EntityType::entity) || \
+        (entries[index].changeType != ChangeJournalEntry::ChangeType::change) || \
+        (entries[index].localUid != uid) || \
+        (entries[index].changedFields != fields)) \
+    { \
+        errorDescription = QStringLiteral("Unexpected change journal entry after stale data items expunging at index ") + \
+                           QString::number(index); \
+        QNWARNING(errorDescription << QStringLiteral(": ") << entries[index]); \
+        return false; \
+    }
+
+    QStringList noteChangedFields;
+    noteChangedFields << QStringLiteral("note");
+
+    CHECK_CHANGE_JOURNAL_ENTRY(0, Resource, Expunge, staleNoteResource.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(1, Note, Expunge, staleNote.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(2, Note, Expunge, dirtyNoteFromStaleNotebook.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(3, Notebook, Expunge, staleNotebook.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(4, Tag, Expunge, staleTag.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(5, SavedSearch, Expunge, staleSearch.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(6, Notebook, Update, dirtyStaleNotebook.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(7, Tag, Update, dirtyStaleChildTag.localUid(), QStringList())
+    CHECK_CHANGE_JOURNAL_ENTRY(8, Note, Update, dirtyStaleNote.localUid(), noteChangedFields)
+    CHECK_CHANGE_JOURNAL_ENTRY(9, SavedSearch, Update, dirtyStaleSearch.localUid(), QStringList())
+
+#undef CHECK_CHANGE_JOURNAL_ENTRY
+
+    error.clear();
+    int notebookCount = localStorageManager.notebookCount(error);
+    int tagCount = localStorageManager.tagCount(error);
+    int noteCount = localStorageManager.noteCount(error);
+    int savedSearchCount = localStorageManager.savedSearchCount(error);
+    if ((notebookCount != 2) || (tagCount != 2) || (noteCount != 2) || (savedSearchCount != 2)) {
+        errorDescription = QStringLiteral("Unexpected number of data items left after stale data items expunging");
+        return false;
+    }
+
+    Notebook foundNotebook;
+    foundNotebook.setLocalUid(dirtyStaleNotebook.localUid());
+    error.clear();
+    res = localStorageManager.findNotebook(foundNotebook, error);
+    if (!res || foundNotebook.hasGuid() || foundNotebook.hasUpdateSequenceNumber()) {
+        errorDescription = QStringLiteral("Dirty stale notebook was not preserved without guid and update sequence number");
+        QNWARNING(errorDescription << QStringLiteral(": ") << foundNotebook);
+        return false;
+    }
+
+    Tag foundTag;
+    foundTag.setLocalUid(dirtyStaleChildTag.localUid());
+    error.clear();
+    res = localStorageManager.findTag(foundTag, error);
+    if (!res || foundTag.hasGuid() || foundTag.hasParentGuid() || foundTag.hasParentLocalUid()) {
+        errorDescription = QStringLiteral("Dirty stale child tag was not preserved without guid and parent");
+        QNWARNING(errorDescription << QStringLiteral(": ") << foundTag);
+        return false;
+    }
+
+    Note foundNote;
+    foundNote.setLocalUid(dirtyStaleNote.localUid());
+    error.clear();
+    res = localStorageManager.findNote(foundNote, error, /* with resource binary data = */ false);
+    if (!res || foundNote.hasGuid() || foundNote.hasUpdateSequenceNumber() ||
+        (foundNote.notebookLocalUid() != syncedNotebook.localUid()))
+    {
+        errorDescription = QStringLiteral("Dirty stale note was not preserved without guid and update sequence number");
+        QNWARNING(errorDescription << QStringLiteral(": ") << foundNote);
+        return false;
+    }
+
+    SavedSearch foundSearch;
+    foundSearch.setLocalUid(dirtyStaleSearch.localUid());
+    error.clear();
+    res = localStorageManager.findSavedSearch(foundSearch, error);
+    if (!res || foundSearch.hasGuid() || foundSearch.hasUpdateSequenceNumber()) {
+        errorDescription = QStringLiteral("Dirty stale saved search was not preserved without guid and update sequence number");
+        QNWARNING(errorDescription << QStringLiteral(": ") << foundSearch);
+        return false;
+    }
+
+    // Nothing is stale anymore so the repeated call should be no-op
+    error.clear();
+    res = localStorageManager.expungeStaleDataItems(syncedNotebookGuids, syncedTagGuids, syncedNoteGuids,
+                                                    syncedSavedSearchGuids, QString(), result, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if (!result.isEmpty()) {
+        errorDescription = QStringLiteral("Repeated stale data items expunging has found something to expunge");
+        QNWARNING(errorDescription << QStringLiteral(": ") << result);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestNoteUpdateCoalescingInLocalStorageManagerAsync(QString & errorDescription)
+{
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageManagerAsyncNoteUpdateCoalescingTestFakeUser"), Account::Type::Evernote, 0);
+
+    // NOTE: the async local storage manager lives in the current thread here and its slots are invoked directly
+    LocalStorageManagerAsync localStorageManagerAsync(account, startFromScratch, overrideLock);
+    localStorageManagerAsync.init();
+
+    LocalStorageManager * pLocalStorageManager = localStorageManagerAsync.localStorageManager();
+    if (Q_UNLIKELY(!pLocalStorageManager)) {
+        errorDescription = QStringLiteral("No local storage manager after the initialization of the async one");
+        return false;
+    }
+
+    Notebook notebook;
+    notebook.setGuid(QStringLiteral("00000000-0000-0000-c000-000000000047"));
+    notebook.setUpdateSequenceNumber(1);
+    notebook.setName(QStringLiteral("Fake notebook name"));
+
+    ErrorString error;
+    bool res = pLocalStorageManager->addNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Note note;
+    note.setTitle(QStringLiteral("Fake note title"));
+    note.setContent(QStringLiteral("<en-note><h1>Hello, world</h1></en-note>"));
+    note.setNotebookLocalUid(notebook.localUid());
+    note.setNotebookGuid(notebook.guid());
+
+    error.clear();
+    res = pLocalStorageManager->addNote(note, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    QSignalSpy updateNoteCompleteSpy(&localStorageManagerAsync, SIGNAL(updateNoteComplete(Note,bool,bool,QUuid)));
+    QSignalSpy flushCompleteSpy(&localStorageManagerAsync, SIGNAL(flushPendingNoteUpdatesComplete(QUuid)));
+
+    // Using the window long enough to never expire during the test
+    localStorageManagerAsync.setNoteUpdateCoalescingWindow(600000);
+
+    const int numUpdates = 5;
+    QList<QUuid> requestIds;
+    for(int i = 0; i < numUpdates; ++i)
+    {
+        note.setTitle(QStringLiteral("Updated note title #") + QString::number(i));
+        QUuid requestId = QUuid::createUuid();
+        requestIds << requestId;
+        localStorageManagerAsync.onUpdateNoteRequest(note, /* update resources = */ true,
+                                                     /* update tags = */ true, requestId);
+    }
+
+    if (!updateNoteCompleteSpy.isEmpty()) {
+        errorDescription = QStringLiteral("Note update was written before the end of the coalescing window");
+        return false;
+    }
+
+    Note foundNote;
+    foundNote.setLocalUid(note.localUid());
+
+    error.clear();
+    res = pLocalStorageManager->findNote(foundNote, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if (foundNote.title() != QStringLiteral("Fake note title")) {
+        errorDescription = QStringLiteral("The note in the local storage was updated before the end of the coalescing window");
+        return false;
+    }
+
+    QUuid flushRequestId = QUuid::createUuid();
+    localStorageManagerAsync.onFlushPendingNoteUpdatesRequest(flushRequestId);
+
+    if ((flushCompleteSpy.size() != 1) || (flushCompleteSpy.at(0).at(0).value<QUuid>() != flushRequestId)) {
+        errorDescription = QStringLiteral("No single flush completion signal with the expected request id");
+        return false;
+    }
+
+    if (updateNoteCompleteSpy.size() != numUpdates) {
+        errorDescription = QStringLiteral("Unexpected number of note update completion signals after the flush: ") +
+                           QString::number(updateNoteCompleteSpy.size());
+        return false;
+    }
+
+    for(int i = 0; i < numUpdates; ++i)
+    {
+        const QList<QVariant> & arguments = updateNoteCompleteSpy.at(i);
+        if (!requestIds.contains(arguments.at(3).value<QUuid>())) {
+            errorDescription = QStringLiteral("Note update completion signal with unexpected request id");
+            return false;
+        }
+
+        if (arguments.at(0).value<Note>().title() != note.title()) {
+            errorDescription = QStringLiteral("Note update completion signal doesn't contain the latest state of the note");
+            return false;
+        }
+    }
+
+    foundNote = Note();
+    foundNote.setLocalUid(note.localUid());
+
+    error.clear();
+    res = pLocalStorageManager->findNote(foundNote, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    if (foundNote.title() != note.title()) {
+        errorDescription = QStringLiteral("The note in the local storage doesn't have the latest state after the flush");
+        return false;
+    }
+
+    // The pending update should be written before processing any other request involving notes
+    updateNoteCompleteSpy.clear();
+    note.setTitle(QStringLiteral("Note title before the note count request"));
+    localStorageManagerAsync.onUpdateNoteRequest(note, /* update resources = */ true,
+                                                 /* update tags = */ true, QUuid::createUuid());
+    localStorageManagerAsync.onGetNoteCountRequest(QUuid::createUuid());
+
+    if (updateNoteCompleteSpy.size() != 1) {
+        errorDescription = QStringLiteral("The pending note update was not written before the note count request");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestResourceSyncedDataHashesInLocalStorage(QString & errorDescription)
+{
+    // 1) ========== Create LocalStorageManager =============
+
+    const bool startFromScratch = true;
+    const bool overrideLock = false;
+    Account account(QStringLiteral("LocalStorageManagerResourceSyncedDataHashesTestFakeUser"), Account::Type::Evernote, 0);
+    LocalStorageManager localStorageManager(account, startFromScratch, overrideLock);
+
+    ErrorString error;
+
+    // 2) ========== Add notebook and note with resource as if they were downloaded from the service ==========
+
+    Notebook notebook;
+    notebook.setGuid(UidGenerator::Generate());
+    notebook.setUpdateSequenceNumber(1);
+    notebook.setName(QStringLiteral("Fake notebook name"));
+    notebook.setDirty(false);
+
+    bool res = localStorageManager.addNotebook(notebook, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    Note note;
+    note.setGuid(UidGenerator::Generate());
+    note.setUpdateSequenceNumber(2);
+    note.setNotebookGuid(notebook.guid());
+    note.setNotebookLocalUid(notebook.localUid());
+    note.setTitle(QStringLiteral("Fake note title"));
+    note.setContent(QStringLiteral("<en-note><h1>Hello, world</h1></en-note>"));
+    note.setDirty(false);
+
+    Resource resource;
+    resource.setGuid(UidGenerator::Generate());
+    resource.setUpdateSequenceNumber(3);
+    resource.setNoteGuid(note.guid());
+    resource.setDataBody(QByteArray("Fake resource data body"));
+    resource.setDataSize(resource.dataBody().size());
+    resource.setDataHash(QByteArray("Fake hash      1"));
+    resource.setDirty(false);
+
+    note.addResource(resource);
+
+    error.clear();
+    res = localStorageManager.addNote(note, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    QStringList noteLocalUids;
+    noteLocalUids << note.localUid();
+
+    error.clear();
+    QHash<QString,QByteArray> dataHashes = localStorageManager.listResourceSyncedDataHashes(noteLocalUids, error);
+    if (dataHashes.size() != 1) {
+        errorDescription = QStringLiteral("Unexpected number of synchronized resource data hashes after adding the note: ") +
+                           QString::number(dataHashes.size()) + QStringLiteral(", error: ") + error.nonLocalizedString();
+        return false;
+    }
+
+    if (dataHashes.value(resource.localUid()) != resource.dataHash()) {
+        errorDescription = QStringLiteral("The synchronized data hash of the resource doesn't match the data hash "
+                                          "of the resource added to the local storage");
+        return false;
+    }
+
+    // 3) ========== Modify the resource's data locally, the synchronized data hash should not change ==========
+
+    Resource modifiedResource = resource;
+    modifiedResource.setDataBody(QByteArray("Modified fake resource data body"));
+    modifiedResource.setDataSize(modifiedResource.dataBody().size());
+    modifiedResource.setDataHash(QByteArray("Fake hash      2"));
+    modifiedResource.setDirty(true);
+
+    QList<Resource> resources;
+    resources << modifiedResource;
+    note.setResources(resources);
+    note.setDirty(true);
+
+    error.clear();
+    res = localStorageManager.updateNote(note, /* update resources = */ true, /* update tags = */ false, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    error.clear();
+    dataHashes = localStorageManager.listResourceSyncedDataHashes(noteLocalUids, error);
+    if (dataHashes.value(resource.localUid()) != resource.dataHash()) {
+        errorDescription = QStringLiteral("The synchronized data hash of the resource has changed after the local modification "
+                                          "of the resource: ") + error.nonLocalizedString();
+        return false;
+    }
+
+    // 4) ========== Clear the note's dirty flag as if the note was sent to the service ==========
+
+    note.setDirty(false);
+
+    error.clear();
+    res = localStorageManager.updateNote(note, /* update resources = */ false, /* update tags = */ false, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    error.clear();
+    dataHashes = localStorageManager.listResourceSyncedDataHashes(noteLocalUids, error);
+    if (dataHashes.value(resource.localUid()) != modifiedResource.dataHash()) {
+        errorDescription = QStringLiteral("The synchronized data hash of the resource hasn't changed after the note "
+                                          "was sent to the service: ") + error.nonLocalizedString();
+        return false;
+    }
+
+    // 5) ========== Expunge the note, the synchronized data hash should be removed along with its resource ==========
+
+    error.clear();
+    res = localStorageManager.expungeNote(note, error);
+    if (!res) {
+        errorDescription = error.nonLocalizedString();
+        return false;
+    }
+
+    error.clear();
+    dataHashes = localStorageManager.listResourceSyncedDataHashes(noteLocalUids, error);
+    if (!dataHashes.isEmpty() || !error.isEmpty()) {
+        errorDescription = QStringLiteral("Unexpected synchronized resource data hashes after expunging the note: ") +
+                           QString::number(dataHashes.size()) + QStringLiteral(", error: ") + error.nonLocalizedString();
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace test
 } // namespace quentier
@@ -56,6 +56,18 @@ bool TestAddingNoteWithoutLocalUid(QString & errorDescription);
 
 bool TestNoteTagIdsComplementWhenAddingAndUpdatingNote(QString & errorDescription);
 
+bool TestChangeJournalInLocalStorage(QString & errorDescription);
+
+bool TestResourceSyncedDataHashesInLocalStorage(QString & errorDescription);
+
+bool TestLocalStorageStatistics(QString & errorDescription);
+
+bool TestLocalStorageSnapshotExportImport(QString & errorDescription);
+
+bool TestStaleDataItemsExpungingInLocalStorage(QString & errorDescription);
+
+bool TestNoteUpdateCoalescingInLocalStorageManagerAsync(QString & errorDescription);
+
 } // namespace test
 } // namespace quentier
 
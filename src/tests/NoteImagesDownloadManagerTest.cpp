@@ -0,0 +1,214 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NoteImagesDownloadManagerTest.h"
+#include "../synchronization/NoteImagesDownloadManager.h"
+#include <quentier/utility/EventLoopWithExitStatus.h>
+#include <quentier/utility/UidGenerator.h>
+#include <QCryptographicHash>
+#include <QSignalSpy>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+// 10 minutes should be enough
+#define MAX_ALLOWED_MILLISECONDS 600000
+
+// Any attempt to actually download something from this host fails
+#define UNREACHABLE_HOST QStringLiteral("unreachable.invalid")
+
+namespace quentier {
+namespace test {
+
+bool writeNoteImagesTestFile(const QString & filePath, const QByteArray & data, QString & error)
+{
+    QFileInfo fileInfo(filePath);
+    QDir dir(fileInfo.absolutePath());
+    if (!dir.exists() && !dir.mkpath(fileInfo.absolutePath())) {
+        error = QStringLiteral("Can't create the folder for the test file: ") + fileInfo.absolutePath();
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = QStringLiteral("Can't open the test file for writing: ") + filePath;
+        return false;
+    }
+
+    file.write(data);
+    file.close();
+    return true;
+}
+
+void removeNoteImagesTestFolder(const QString & folderPath)
+{
+    QDir dir(folderPath);
+    QFileInfoList entries = dir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+    for(auto it = entries.constBegin(), end = entries.constEnd(); it != end; ++it)
+    {
+        if (it->isDir()) {
+            removeNoteImagesTestFolder(it->absoluteFilePath());
+        }
+        else {
+            Q_UNUSED(QFile::remove(it->absoluteFilePath()))
+        }
+    }
+
+    Q_UNUSED(dir.rmdir(folderPath))
+}
+
+bool checkNoteImagesCacheHit(const QString & testFolderPath, QString & error)
+{
+    QString cacheFolderPath = testFolderPath + QStringLiteral("/cache");
+    QString storageFolderPath = testFolderPath + QStringLiteral("/storage");
+
+    QString noteGuid = UidGenerator::Generate();
+    QString resourceGuid = UidGenerator::Generate();
+
+    QByteArray noteContentHash = QCryptographicHash::hash(QByteArray("<en-note>Note content</en-note>"),
+                                                          QCryptographicHash::Md5);
+    QByteArray resourceDataHash = QCryptographicHash::hash(QByteArray("Ink note resource data"),
+                                                           QCryptographicHash::Md5);
+
+    QByteArray thumbnailData("Cached thumbnail data");
+    QByteArray inkNoteImageData("Cached ink note image data");
+
+    // NOTE: the file layout must match the one used by NoteImagesDownloadManager for its cache
+    QString thumbnailCacheFilePath = cacheFolderPath + QStringLiteral("/thumbnails/") + noteGuid +
+                                     QStringLiteral("/") + QString::fromUtf8(noteContentHash.toHex()) +
+                                     QStringLiteral(".png");
+    if (!writeNoteImagesTestFile(thumbnailCacheFilePath, thumbnailData, error)) {
+        return false;
+    }
+
+    QString inkNoteImageCacheFilePath = cacheFolderPath + QStringLiteral("/inkNoteImages/") + noteGuid +
+                                        QStringLiteral("/") + resourceGuid + QStringLiteral("_") +
+                                        QString::fromUtf8(resourceDataHash.toHex()) + QStringLiteral(".png");
+    if (!writeNoteImagesTestFile(inkNoteImageCacheFilePath, inkNoteImageData, error)) {
+        return false;
+    }
+
+    NoteImagesDownloadManager manager;
+    manager.setCacheFolderPath(cacheFolderPath);
+
+    QSignalSpy thumbnailDownloadedSpy(&manager, SIGNAL(noteThumbnailDownloaded(bool,QString,QByteArray,ErrorString)));
+    QSignalSpy inkNoteImageDownloadedSpy(&manager, SIGNAL(inkNoteImageDownloaded(bool,QString,QString,ErrorString)));
+
+    int loopResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+
+        // The ink note image download is scheduled after the thumbnail one so it's the last to finish
+        QObject::connect(&manager, SIGNAL(inkNoteImageDownloaded(bool,QString,QString,ErrorString)),
+                         &loop, SLOT(exitAsSuccess()));
+
+        manager.downloadNoteThumbnail(UNREACHABLE_HOST, noteGuid, noteContentHash, QStringLiteral("fake auth token"),
+                                      QStringLiteral("fake shard id"), /* from public linked notebook = */ false,
+                                      NoteImagesDownloadManager::PriorityClass::UserAccount);
+        manager.downloadInkNoteImage(UNREACHABLE_HOST, resourceGuid, noteGuid, resourceDataHash,
+                                     QStringLiteral("fake auth token"), QStringLiteral("fake shard id"),
+                                     /* height = */ 100, /* width = */ 100, /* from public linked notebook = */ false,
+                                     storageFolderPath, NoteImagesDownloadManager::PriorityClass::UserAccount);
+
+        timer.start();
+        loopResult = loop.exec();
+    }
+
+    if (loopResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        error = QStringLiteral("NoteImagesDownloadManager failed to complete the downloads in time");
+        return false;
+    }
+
+    // Both images are found within the cache so no download should have ever been started
+    if ((manager.numDownloadsInFlight() != 0) || (manager.numPendingDownloads() != 0)) {
+        error = QStringLiteral("NoteImagesDownloadManager started the downloads of the images found within the cache");
+        return false;
+    }
+
+    if (thumbnailDownloadedSpy.size() != 1) {
+        error = QStringLiteral("Unexpected number of thumbnail download signals: ") +
+                QString::number(thumbnailDownloadedSpy.size());
+        return false;
+    }
+
+    const QList<QVariant> & thumbnailArguments = thumbnailDownloadedSpy.at(0);
+    if (!thumbnailArguments.at(0).toBool()) {
+        error = QStringLiteral("The thumbnail found within the cache was reported as not downloaded");
+        return false;
+    }
+
+    if (thumbnailArguments.at(1).toString() != noteGuid) {
+        error = QStringLiteral("The thumbnail download signal has unexpected note guid");
+        return false;
+    }
+
+    if (thumbnailArguments.at(2).toByteArray() != thumbnailData) {
+        error = QStringLiteral("The thumbnail data doesn't match the data from the cache");
+        return false;
+    }
+
+    if (inkNoteImageDownloadedSpy.size() != 1) {
+        error = QStringLiteral("Unexpected number of ink note image download signals: ") +
+                QString::number(inkNoteImageDownloadedSpy.size());
+        return false;
+    }
+
+    const QList<QVariant> & inkNoteImageArguments = inkNoteImageDownloadedSpy.at(0);
+    if (!inkNoteImageArguments.at(0).toBool()) {
+        error = QStringLiteral("The ink note image found within the cache was reported as not downloaded");
+        return false;
+    }
+
+    if (inkNoteImageArguments.at(1).toString() != resourceGuid) {
+        error = QStringLiteral("The ink note image download signal has unexpected resource guid");
+        return false;
+    }
+
+    QFile inkNoteImageFile(storageFolderPath + QStringLiteral("/") + resourceGuid + QStringLiteral(".png"));
+    if (!inkNoteImageFile.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("The ink note image from the cache was not put into the storage folder");
+        return false;
+    }
+
+    QByteArray storedInkNoteImageData = inkNoteImageFile.readAll();
+    inkNoteImageFile.close();
+
+    if (storedInkNoteImageData != inkNoteImageData) {
+        error = QStringLiteral("The ink note image within the storage folder doesn't match the one from the cache");
+        return false;
+    }
+
+    return true;
+}
+
+bool noteImagesCacheHitTest(QString & error)
+{
+    QString testFolderPath = QDir::tempPath() + QStringLiteral("/QuentierNoteImagesCacheTest_") + UidGenerator::Generate();
+    bool res = checkNoteImagesCacheHit(testFolderPath, error);
+    removeNoteImagesTestFolder(testFolderPath);
+    return res;
+}
+
+} // namespace test
+} // namespace quentier
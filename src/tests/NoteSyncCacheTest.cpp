@@ -0,0 +1,95 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NoteSyncCacheTest.h"
+#include "../synchronization/NoteSyncCache.h"
+
+namespace quentier {
+namespace test {
+
+bool noteSyncStatusTest(QString & error)
+{
+    qevercloud::Note remoteNote;
+    remoteNote.guid = QStringLiteral("note-1");
+    remoteNote.notebookGuid = QStringLiteral("notebook-1");
+    remoteNote.updateSequenceNum = 42;
+    remoteNote.contentHash = QByteArray("content-hash");
+
+    NoteSyncCache::NoteSyncStatus::type status = NoteSyncCache::noteSyncStatus(Q_NULLPTR, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::New) {
+        error = QStringLiteral("The remote note without the local counterpart is not considered new");
+        return false;
+    }
+
+    NoteSyncCache::NoteSyncInfo info;
+    info.m_localUid = QStringLiteral("local-uid-1");
+    info.m_updateSequenceNumber = 42;
+    info.m_isDirty = false;
+    info.m_contentHash = QByteArray("content-hash");
+
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::UpToDate) {
+        error = QStringLiteral("The remote note matching the non-dirty local note by the update sequence number "
+                               "and the content hash is not considered up to date");
+        return false;
+    }
+
+    info.m_contentHash = QByteArray("other-content-hash");
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::Modified) {
+        error = QStringLiteral("The remote note with the content hash different from the non-dirty local note's one "
+                               "is not considered modified");
+        return false;
+    }
+
+    info.m_contentHash.clear();
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::Modified) {
+        error = QStringLiteral("The remote note is considered up to date even though the local note has no content hash");
+        return false;
+    }
+
+    info.m_contentHash = QByteArray("content-hash");
+    info.m_updateSequenceNumber = 41;
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::Modified) {
+        error = QStringLiteral("The remote note with the update sequence number different from the non-dirty local note's one "
+                               "is not considered modified");
+        return false;
+    }
+
+    info.m_isDirty = true;
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::Conflicting) {
+        error = QStringLiteral("The remote note is not considered conflicting with the dirty local note");
+        return false;
+    }
+
+    info.m_updateSequenceNumber = 42;
+    status = NoteSyncCache::noteSyncStatus(&info, remoteNote);
+    if (status != NoteSyncCache::NoteSyncStatus::Conflicting) {
+        error = QStringLiteral("The remote note is not considered conflicting with the dirty local note "
+                               "having the same update sequence number");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
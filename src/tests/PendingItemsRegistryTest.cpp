@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PendingItemsRegistryTest.h"
+#include "../synchronization/PendingItemsRegistry.h"
+#include <quentier/utility/UidGenerator.h>
+#include <QStringList>
+#include <iterator>
+
+namespace quentier {
+namespace test {
+
+bool pendingItemsRegistryTest(QString & error)
+{
+    PendingItemsRegistry<qevercloud::Notebook> registry;
+
+    const int numNotebooks = 100;
+    QStringList guids;
+    for(int i = 0; i < numNotebooks; ++i)
+    {
+        qevercloud::Notebook notebook;
+        notebook.guid = UidGenerator::Generate();
+        notebook.name = QStringLiteral("Notebook #") + QString::number(i);
+        notebook.updateSequenceNum = i + 1;
+        registry << notebook;
+        guids << notebook.guid.ref();
+    }
+
+    if (registry.size() != numNotebooks) {
+        error = QStringLiteral("Unexpected number of items within the registry: ") + QString::number(registry.size());
+        return false;
+    }
+
+    // Items must be iterated in the order of their addition
+    int index = 0;
+    for(auto it = registry.constBegin(), end = registry.constEnd(); it != end; ++it, ++index)
+    {
+        if (it->guid.ref() != guids[index]) {
+            error = QStringLiteral("The order of items within the registry differs from the order of their addition");
+            return false;
+        }
+    }
+
+    auto it = registry.findByGuid(guids[42]);
+    if ((it == registry.end()) || (it->updateSequenceNum.ref() != 43)) {
+        error = QStringLiteral("Failed to find the item within the registry by guid");
+        return false;
+    }
+
+    QList<PendingItemsRegistry<qevercloud::Notebook>::iterator> itemsByName =
+        registry.findByName(QStringLiteral("NOTEBOOK #42"));
+    if ((itemsByName.size() != 1) || (itemsByName.front() != it)) {
+        error = QStringLiteral("Failed to find the item within the registry by name ignoring the case");
+        return false;
+    }
+
+    // Appending the item with the guid already within the registry should replace the item in place
+    qevercloud::Notebook updatedNotebook = *it;
+    updatedNotebook.name = QStringLiteral("Renamed notebook");
+    updatedNotebook.updateSequenceNum = numNotebooks + 1;
+    Q_UNUSED(registry.append(updatedNotebook))
+
+    if (registry.size() != numNotebooks) {
+        error = QStringLiteral("Appending the item with existing guid changed the number of items within the registry");
+        return false;
+    }
+
+    if (!registry.findByName(QStringLiteral("Notebook #42")).isEmpty() ||
+        (registry.findByName(QStringLiteral("renamed notebook")).size() != 1))
+    {
+        error = QStringLiteral("The name index was not updated after the replacement of the item");
+        return false;
+    }
+
+    it = registry.begin();
+    std::advance(it, 42);
+    if (it->updateSequenceNum.ref() != (numNotebooks + 1)) {
+        error = QStringLiteral("The replaced item didn't keep its position within the registry");
+        return false;
+    }
+
+    // Removal from the middle should keep the order of the rest of items and the indices consistent
+    Q_UNUSED(registry.erase(registry.findByGuid(guids[10])))
+    if (!registry.removeByGuid(guids[20]) || registry.removeByGuid(guids[20])) {
+        error = QStringLiteral("Unexpected result of the removal of the item by guid");
+        return false;
+    }
+
+    if ((registry.size() != (numNotebooks - 2)) || registry.containsGuid(guids[10]) || registry.containsGuid(guids[20]) ||
+        !registry.findByName(QStringLiteral("Notebook #10")).isEmpty())
+    {
+        error = QStringLiteral("The removed items are still within the registry");
+        return false;
+    }
+
+    index = 0;
+    for(auto rit = registry.constBegin(), end = registry.constEnd(); rit != end; ++rit, ++index)
+    {
+        if ((index == 10) || (index == 20)) {
+            ++index;
+        }
+
+        if (rit->guid.ref() != guids[index]) {
+            error = QStringLiteral("The order of items within the registry was broken by the removal of items");
+            return false;
+        }
+    }
+
+    // Several items can share the name, i.e. the notebooks from different linked notebooks
+    qevercloud::Notebook sameNameNotebook;
+    sameNameNotebook.guid = UidGenerator::Generate();
+    sameNameNotebook.name = QStringLiteral("Notebook #50");
+    registry << sameNameNotebook;
+
+    if (registry.findByName(QStringLiteral("Notebook #50")).size() != 2) {
+        error = QStringLiteral("Failed to find all the items sharing the same name within the registry");
+        return false;
+    }
+
+    PendingItemsRegistry<qevercloud::Notebook> copy(registry);
+    registry.clear();
+    if (!registry.isEmpty() || registry.containsGuid(guids[0]) || !registry.findByName(QStringLiteral("Notebook #0")).isEmpty()) {
+        error = QStringLiteral("The registry is not empty after being cleared");
+        return false;
+    }
+
+    if ((copy.size() != (numNotebooks - 1)) || !copy.containsGuid(guids[0])) {
+        error = QStringLiteral("The copy of the registry doesn't contain the items of the original registry");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SelectiveSyncFilterTest.h"
+#include "../synchronization/SelectiveSyncFilter.h"
+
+namespace quentier {
+namespace test {
+
+bool selectiveSyncFilterTest(QString & error)
+{
+    qevercloud::Note firstNote;
+    firstNote.guid = QStringLiteral("note-1");
+    firstNote.notebookGuid = QStringLiteral("notebook-1");
+
+    qevercloud::Note secondNote;
+    secondNote.guid = QStringLiteral("note-2");
+    secondNote.notebookGuid = QStringLiteral("notebook-2");
+    secondNote.tagGuids = QStringList() << QStringLiteral("tag-1") << QStringLiteral("tag-2");
+
+    SelectiveSyncFilter allNotesFilter;
+    if (!allNotesFilter.isEmpty()) {
+        error = QStringLiteral("The default constructed selective sync filter is not empty");
+        return false;
+    }
+
+    if (!allNotesFilter.matchesNote(firstNote) || !allNotesFilter.matchesNote(secondNote)) {
+        error = QStringLiteral("The empty selective sync filter doesn't select all notes");
+        return false;
+    }
+
+    SelectiveSyncFilter emptyGuidsFilter(QStringList() << QString(), QStringList() << QString());
+    if (!emptyGuidsFilter.isEmpty()) {
+        error = QStringLiteral("The selective sync filter constructed from empty guids is not empty");
+        return false;
+    }
+
+    SelectiveSyncFilter notebookFilter(QStringList() << QStringLiteral("notebook-1"), QStringList());
+    if (!notebookFilter.matchesNote(firstNote)) {
+        error = QStringLiteral("The selective sync filter doesn't select the note from the chosen notebook");
+        return false;
+    }
+
+    if (notebookFilter.matchesNote(secondNote)) {
+        error = QStringLiteral("The selective sync filter selects the note from the notebook which was not chosen");
+        return false;
+    }
+
+    SelectiveSyncFilter tagFilter(QStringList(), QStringList() << QStringLiteral("tag-2"));
+    if (tagFilter.matchesNote(firstNote) || !tagFilter.matchesNote(secondNote)) {
+        error = QStringLiteral("The selective sync filter doesn't select notes by the chosen tags properly");
+        return false;
+    }
+
+    SelectiveSyncFilter notebookAndTagFilter(QStringList() << QStringLiteral("notebook-1"),
+                                             QStringList() << QStringLiteral("tag-1"));
+    if (!notebookAndTagFilter.matchesNote(firstNote) || !notebookAndTagFilter.matchesNote(secondNote)) {
+        error = QStringLiteral("The selective sync filter doesn't select the note matching either the chosen notebooks "
+                               "or the chosen tags");
+        return false;
+    }
+
+    if (!allNotesFilter.selectsMoreThan(notebookFilter)) {
+        error = QStringLiteral("Removing the selective sync restrictions doesn't require to download the skipped notes");
+        return false;
+    }
+
+    if (notebookFilter.selectsMoreThan(allNotesFilter) || allNotesFilter.selectsMoreThan(allNotesFilter)) {
+        error = QStringLiteral("Narrowing the selective sync filter requires to download the skipped notes");
+        return false;
+    }
+
+    if (notebookFilter.selectsMoreThan(notebookAndTagFilter)) {
+        error = QStringLiteral("The selective sync filter being the subset of the other one is considered selecting more notes");
+        return false;
+    }
+
+    if (!notebookAndTagFilter.selectsMoreThan(notebookFilter)) {
+        error = QStringLiteral("Choosing the additional tag doesn't require to download the skipped notes");
+        return false;
+    }
+
+    SelectiveSyncFilter reorderedFilter(QStringList() << QStringLiteral("notebook-1") << QStringLiteral("notebook-1"),
+                                        QStringList() << QStringLiteral("tag-1"));
+    if (reorderedFilter != notebookAndTagFilter) {
+        error = QStringLiteral("The selective sync filters with the same notebook and tag guids are not equal");
+        return false;
+    }
+
+    if ((notebookAndTagFilter.notebookGuids() != (QStringList() << QStringLiteral("notebook-1"))) ||
+        (notebookAndTagFilter.tagGuids() != (QStringList() << QStringLiteral("tag-1"))))
+    {
+        error = QStringLiteral("The selective sync filter doesn't return the chosen notebook and tag guids");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
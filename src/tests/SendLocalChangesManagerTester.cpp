@@ -0,0 +1,476 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SendLocalChangesManagerTester.h"
+#include "../benchmarks/FakeSyncService.h"
+#include "../benchmarks/FakeNoteStore.h"
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/utility/EventLoopWithExitStatus.h>
+#include <QtTest/QTest>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+
+// 10 minutes should be enough
+#define MAX_ALLOWED_MILLISECONDS 600000
+
+#define FAKE_SYNC_SERVICE_SEED (17)
+#define NUM_FAKE_SYNC_SERVICE_NOTES (10)
+#define NUM_DIRTY_NOTES (12)
+
+namespace quentier {
+namespace test {
+
+SendLocalChangesManagerTester::SendLocalChangesManagerTester(QObject * parent) :
+    QObject(parent),
+    m_testAccount(QStringLiteral("SendLocalChangesManagerTesterFakeUser"),
+                  Account::Type::Evernote, qevercloud::UserID(1)),
+    m_pFakeSyncService(Q_NULLPTR),
+    m_pFakeNoteStore(Q_NULLPTR),
+    m_pLocalStorageManagerThread(Q_NULLPTR),
+    m_pLocalStorageManagerAsync(Q_NULLPTR),
+    m_syncTracer(),
+    m_notebookLocalUid(),
+    m_parentTagLocalUid(),
+    m_childTagLocalUid(),
+    m_grandChildTagLocalUid(),
+    m_finished(false),
+    m_lastUpdateCount(0),
+    m_numShouldRepeatIncrementalSyncSignals(0),
+    m_numRateLimitExceededSignals(0),
+    m_sentUpdateSequenceNumbers()
+{}
+
+SendLocalChangesManagerTester::~SendLocalChangesManagerTester()
+{}
+
+LocalStorageManagerAsync & SendLocalChangesManagerTester::localStorageManagerAsync()
+{
+    return *m_pLocalStorageManagerAsync;
+}
+
+INoteStore & SendLocalChangesManagerTester::noteStore()
+{
+    return *m_pFakeNoteStore;
+}
+
+INoteStore * SendLocalChangesManagerTester::noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook)
+{
+    Q_UNUSED(linkedNotebook)
+    return Q_NULLPTR;
+}
+
+SyncTracer & SendLocalChangesManagerTester::syncTracer()
+{
+    return m_syncTracer;
+}
+
+void SendLocalChangesManagerTester::onFinished(qint32 lastUpdateCount, QHash<QString,qint32> lastUpdateCountByLinkedNotebookGuid)
+{
+    Q_UNUSED(lastUpdateCountByLinkedNotebookGuid)
+    m_finished = true;
+    m_lastUpdateCount = lastUpdateCount;
+}
+
+void SendLocalChangesManagerTester::onShouldRepeatIncrementalSync()
+{
+    ++m_numShouldRepeatIncrementalSyncSignals;
+}
+
+void SendLocalChangesManagerTester::onRateLimitExceeded(qint32 secondsToWait)
+{
+    Q_UNUSED(secondsToWait)
+    ++m_numRateLimitExceededSignals;
+}
+
+void SendLocalChangesManagerTester::onCreateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                                                  ErrorString errorDescription, QUuid requestId)
+{
+    Q_UNUSED(rateLimitSeconds)
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(requestId)
+    onSentDataItemUpdateSequenceNumber(errorCode, notebook.updateSequenceNumber());
+}
+
+void SendLocalChangesManagerTester::onCreateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                                             ErrorString errorDescription, QUuid requestId)
+{
+    Q_UNUSED(rateLimitSeconds)
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(requestId)
+    onSentDataItemUpdateSequenceNumber(errorCode, tag.updateSequenceNumber());
+}
+
+void SendLocalChangesManagerTester::onCreateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch,
+                                                                     qint32 rateLimitSeconds, ErrorString errorDescription,
+                                                                     QUuid requestId)
+{
+    Q_UNUSED(rateLimitSeconds)
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(requestId)
+    onSentDataItemUpdateSequenceNumber(errorCode, savedSearch.updateSequenceNumber());
+}
+
+void SendLocalChangesManagerTester::onCreateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                                              ErrorString errorDescription, QUuid requestId)
+{
+    Q_UNUSED(rateLimitSeconds)
+    Q_UNUSED(errorDescription)
+    Q_UNUSED(requestId)
+    onSentDataItemUpdateSequenceNumber(errorCode, note.updateSequenceNumber());
+}
+
+void SendLocalChangesManagerTester::init()
+{
+    m_testAccount = Account(m_testAccount.name(), Account::Type::Evernote, m_testAccount.id() + 1);
+
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 10;
+    settings.m_rateLimitEveryNthRequest = 4;
+    settings.m_rateLimitSeconds = 1;
+    settings.m_reorderAsyncReplies = true;
+
+    m_pFakeSyncService = new benchmark::FakeSyncService(FAKE_SYNC_SERVICE_SEED, settings);
+    m_pFakeSyncService->populate(NUM_FAKE_SYNC_SERVICE_NOTES);
+    m_pFakeSyncService->resetStatistics();
+
+    m_pFakeNoteStore = new benchmark::FakeNoteStore(*m_pFakeSyncService);
+
+    QObject::connect(m_pFakeNoteStore, SIGNAL(createNotebookAsyncFinished(qint32,Notebook,qint32,ErrorString,QUuid)),
+                     this, SLOT(onCreateNotebookAsyncFinished(qint32,Notebook,qint32,ErrorString,QUuid)));
+    QObject::connect(m_pFakeNoteStore, SIGNAL(createTagAsyncFinished(qint32,Tag,qint32,ErrorString,QUuid)),
+                     this, SLOT(onCreateTagAsyncFinished(qint32,Tag,qint32,ErrorString,QUuid)));
+    QObject::connect(m_pFakeNoteStore, SIGNAL(createSavedSearchAsyncFinished(qint32,SavedSearch,qint32,ErrorString,QUuid)),
+                     this, SLOT(onCreateSavedSearchAsyncFinished(qint32,SavedSearch,qint32,ErrorString,QUuid)));
+    QObject::connect(m_pFakeNoteStore, SIGNAL(createNoteAsyncFinished(qint32,Note,qint32,ErrorString,QUuid)),
+                     this, SLOT(onCreateNoteAsyncFinished(qint32,Note,qint32,ErrorString,QUuid)));
+
+    setupDirtyDataItems();
+    startLocalStorageManagerAsync();
+}
+
+void SendLocalChangesManagerTester::cleanup()
+{
+    stopLocalStorageManagerAsync();
+
+    delete m_pFakeNoteStore;
+    m_pFakeNoteStore = Q_NULLPTR;
+
+    delete m_pFakeSyncService;
+    m_pFakeSyncService = Q_NULLPTR;
+
+    m_notebookLocalUid.resize(0);
+    m_parentTagLocalUid.resize(0);
+    m_childTagLocalUid.resize(0);
+    m_grandChildTagLocalUid.resize(0);
+
+    m_finished = false;
+    m_lastUpdateCount = 0;
+    m_numShouldRepeatIncrementalSyncSignals = 0;
+    m_numRateLimitExceededSignals = 0;
+    m_sentUpdateSequenceNumbers.clear();
+}
+
+void SendLocalChangesManagerTester::testSendOutOfOrderWithRateLimit()
+{
+    // The update count matches the one of the service so the update sequence numbers of all sent data items
+    // should eventually fill the gaps after it, whatever the order of the replies
+    const qint32 updateCount = m_pFakeSyncService->updateCount();
+    doTest(updateCount);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QVERIFY2(m_numShouldRepeatIncrementalSyncSignals == 0,
+             "SendLocalChangesManager requested to repeat the incremental sync while nobody else has modified the account");
+    QVERIFY2(m_lastUpdateCount == m_pFakeSyncService->updateCount(),
+             "The last update count reported by SendLocalChangesManager doesn't match the update count of the service");
+
+    checkSentDataItems();
+}
+
+void SendLocalChangesManagerTester::testUpdateCountGapRepeatsIncrementalSync()
+{
+    // Pretend another client has modified the account since the last sync: the update sequence number following
+    // the last update count known to the client is never received in the replies for the sent data items
+    const qint32 updateCount = m_pFakeSyncService->updateCount() - 1;
+    doTest(updateCount);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QVERIFY2(m_numShouldRepeatIncrementalSyncSignals == 1,
+             "SendLocalChangesManager was expected to request to repeat the incremental sync exactly once");
+    QVERIFY2(m_lastUpdateCount == updateCount,
+             "The last update count reported by SendLocalChangesManager has advanced past the gap");
+
+    checkSentDataItems();
+}
+
+void SendLocalChangesManagerTester::setupDirtyDataItems()
+{
+    // NOTE: only one local storage manager can hold the database lock at a time so this one is destroyed
+    // before LocalStorageManagerAsync is started
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ true, /* override lock = */ false);
+    ErrorString errorDescription;
+
+    Notebook notebook;
+    notebook.setName(QStringLiteral("Dirty notebook"));
+    notebook.setLocal(false);
+    notebook.setDirty(true);
+    bool res = localStorageManager.addNotebook(notebook, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    m_notebookLocalUid = notebook.localUid();
+
+    Tag parentTag;
+    parentTag.setName(QStringLiteral("Parent tag"));
+    parentTag.setLocal(false);
+    parentTag.setDirty(true);
+    res = localStorageManager.addTag(parentTag, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    m_parentTagLocalUid = parentTag.localUid();
+
+    Tag childTag;
+    childTag.setName(QStringLiteral("Child tag"));
+    childTag.setParentLocalUid(m_parentTagLocalUid);
+    childTag.setLocal(false);
+    childTag.setDirty(true);
+    res = localStorageManager.addTag(childTag, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    m_childTagLocalUid = childTag.localUid();
+
+    Tag grandChildTag;
+    grandChildTag.setName(QStringLiteral("Grand child tag"));
+    grandChildTag.setParentLocalUid(m_childTagLocalUid);
+    grandChildTag.setLocal(false);
+    grandChildTag.setDirty(true);
+    res = localStorageManager.addTag(grandChildTag, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    m_grandChildTagLocalUid = grandChildTag.localUid();
+
+    Tag siblingTag;
+    siblingTag.setName(QStringLiteral("Sibling tag"));
+    siblingTag.setLocal(false);
+    siblingTag.setDirty(true);
+    res = localStorageManager.addTag(siblingTag, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+
+    SavedSearch savedSearch;
+    savedSearch.setName(QStringLiteral("Dirty saved search"));
+    savedSearch.setQuery(QStringLiteral("dirty"));
+    savedSearch.setLocal(false);
+    savedSearch.setDirty(true);
+    res = localStorageManager.addSavedSearch(savedSearch, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+
+    for(int i = 0; i < NUM_DIRTY_NOTES; ++i)
+    {
+        Note note;
+        note.setTitle(QStringLiteral("Dirty note #") + QString::number(i));
+        note.setContent(QStringLiteral("<en-note><div>Dirty note #") + QString::number(i) +
+                        QStringLiteral("</div></en-note>"));
+        note.setNotebookLocalUid(m_notebookLocalUid);
+        note.addTagLocalUid(((i % 2) == 0) ? m_grandChildTagLocalUid : siblingTag.localUid());
+        note.setLocal(false);
+        note.setDirty(true);
+        res = localStorageManager.addNote(note, errorDescription);
+        QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    }
+}
+
+void SendLocalChangesManagerTester::startLocalStorageManagerAsync()
+{
+    // NOTE: SendLocalChangesManager expects the replies from the local storage to arrive asynchronously
+    // so the local storage manager runs in its own thread, much like with the real synchronization
+    m_pLocalStorageManagerThread = new QThread;
+    m_pLocalStorageManagerAsync = new LocalStorageManagerAsync(m_testAccount, /* start from scratch = */ false,
+                                                               /* override lock = */ false);
+    m_pLocalStorageManagerAsync->moveToThread(m_pLocalStorageManagerThread);
+
+    QObject::connect(m_pLocalStorageManagerThread, QNSIGNAL(QThread,started),
+                     m_pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,init));
+
+    QEventLoop loop;
+    QObject::connect(m_pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,initialized),
+                     &loop, QNSLOT(QEventLoop,quit));
+    m_pLocalStorageManagerThread->start();
+    Q_UNUSED(loop.exec())
+}
+
+void SendLocalChangesManagerTester::stopLocalStorageManagerAsync()
+{
+    if (!m_pLocalStorageManagerThread) {
+        return;
+    }
+
+    m_pLocalStorageManagerThread->quit();
+    Q_UNUSED(m_pLocalStorageManagerThread->wait())
+
+    delete m_pLocalStorageManagerAsync;
+    m_pLocalStorageManagerAsync = Q_NULLPTR;
+
+    delete m_pLocalStorageManagerThread;
+    m_pLocalStorageManagerThread = Q_NULLPTR;
+}
+
+void SendLocalChangesManagerTester::doTest(const qint32 updateCount)
+{
+    if (Q_UNLIKELY(!m_pLocalStorageManagerAsync)) {
+        QFAIL("Detected null pointer to LocalStorageManagerAsync");
+    }
+
+    SendLocalChangesManager sendLocalChangesManager(*this);
+
+    QObject::connect(&sendLocalChangesManager, QNSIGNAL(SendLocalChangesManager,finished,qint32,QHash<QString,qint32>),
+                     this, QNSLOT(SendLocalChangesManagerTester,onFinished,qint32,QHash<QString,qint32>));
+    QObject::connect(&sendLocalChangesManager, QNSIGNAL(SendLocalChangesManager,shouldRepeatIncrementalSync),
+                     this, QNSLOT(SendLocalChangesManagerTester,onShouldRepeatIncrementalSync));
+    QObject::connect(&sendLocalChangesManager, QNSIGNAL(SendLocalChangesManager,rateLimitExceeded,qint32),
+                     this, QNSLOT(SendLocalChangesManagerTester,onRateLimitExceeded,qint32));
+
+    int testResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(&sendLocalChangesManager, SIGNAL(finished(qint32,QHash<QString,qint32>)),
+                         &loop, SLOT(exitAsSuccess()));
+        QObject::connect(&sendLocalChangesManager, SIGNAL(failure(ErrorString)), &loop, SLOT(exitAsFailure()));
+        QObject::connect(&sendLocalChangesManager, SIGNAL(conflictDetected()), &loop, SLOT(exitAsFailure()));
+
+        timer.start();
+
+        // NOTE: the replies from the local storage are queued so they won't arrive before the loop is running
+        sendLocalChangesManager.start(updateCount, QHash<QString,qint32>());
+        testResult = loop.exec();
+    }
+
+    if (testResult == -1) {
+        QFAIL("Internal error: incorrect return status from SendLocalChangesManager");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Detected failure during the asynchronous loop processing in SendLocalChangesManager");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("SendLocalChangesManager failed to finish in time");
+    }
+
+    QVERIFY2(m_finished, "SendLocalChangesManager didn't report the finish");
+
+    QVERIFY2(m_pFakeSyncService->statistics().m_numRateLimitedRequests > 0,
+             "None of the requests sent to the fake note store has hit the rate limit");
+    QVERIFY2(m_numRateLimitExceededSignals > 0,
+             "SendLocalChangesManager didn't report the rate limit exceeding");
+
+    bool foundOutOfOrderReply = false;
+    for(int i = 1, size = m_sentUpdateSequenceNumbers.size(); i < size; ++i)
+    {
+        if (m_sentUpdateSequenceNumbers[i] < m_sentUpdateSequenceNumbers[i - 1]) {
+            foundOutOfOrderReply = true;
+            break;
+        }
+    }
+
+    QVERIFY2(foundOutOfOrderReply, "The fake note store didn't deliver any of the replies out of order");
+}
+
+void SendLocalChangesManagerTester::checkSentDataItems()
+{
+    // The dirty flags are cleared by the local storage thread; stopping it ensures all the updates are written
+    // before the database is reopened for checking
+    stopLocalStorageManagerAsync();
+
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+    ErrorString errorDescription;
+
+    QList<Notebook> dirtyNotebooks = localStorageManager.listNotebooks(LocalStorageManager::ListDirty, errorDescription);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(dirtyNotebooks.isEmpty(), "Found dirty notebook after sending the local changes");
+
+    QList<Tag> dirtyTags = localStorageManager.listTags(LocalStorageManager::ListDirty, errorDescription);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(dirtyTags.isEmpty(), "Found dirty tag after sending the local changes");
+
+    QList<SavedSearch> dirtySavedSearches = localStorageManager.listSavedSearches(LocalStorageManager::ListDirty,
+                                                                                   errorDescription);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(dirtySavedSearches.isEmpty(), "Found dirty saved search after sending the local changes");
+
+    QList<Note> dirtyNotes = localStorageManager.listNotes(LocalStorageManager::ListDirty, errorDescription,
+                                                           /* with resource binary data = */ false);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(dirtyNotes.isEmpty(), "Found dirty note after sending the local changes");
+
+    QHash<QString, Tag> tagsByLocalUid;
+    QList<Tag> tags = localStorageManager.listTags(LocalStorageManager::ListAll, errorDescription);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    for(auto it = tags.constBegin(), end = tags.constEnd(); it != end; ++it)
+    {
+        const Tag & tag = *it;
+        QVERIFY2(tag.hasGuid(), "Found tag without guid after sending the local changes");
+        QVERIFY2(tag.hasUpdateSequenceNumber(), "Found tag without update sequence number after sending the local changes");
+        tagsByLocalUid[tag.localUid()] = tag;
+    }
+
+    const Tag parentTag = tagsByLocalUid.value(m_parentTagLocalUid);
+    const Tag childTag = tagsByLocalUid.value(m_childTagLocalUid);
+    const Tag grandChildTag = tagsByLocalUid.value(m_grandChildTagLocalUid);
+
+    QVERIFY2(!parentTag.hasParentGuid(), "The top level tag has got the parent guid");
+    QVERIFY2(childTag.hasParentGuid() && (childTag.parentGuid() == parentTag.guid()),
+             "The child tag's parent guid doesn't match the guid of the parent tag");
+    QVERIFY2(grandChildTag.hasParentGuid() && (grandChildTag.parentGuid() == childTag.guid()),
+             "The grand child tag's parent guid doesn't match the guid of the child tag");
+
+    Notebook notebook;
+    notebook.setLocalUid(m_notebookLocalUid);
+    bool res = localStorageManager.findNotebook(notebook, errorDescription);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(notebook.hasGuid(), "The notebook has no guid after sending the local changes");
+
+    QList<Note> notes = localStorageManager.listNotes(LocalStorageManager::ListAll, errorDescription,
+                                                      /* with resource binary data = */ false);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(notes.size() == NUM_DIRTY_NOTES, "Unexpected number of notes after sending the local changes");
+
+    for(auto it = notes.constBegin(), end = notes.constEnd(); it != end; ++it)
+    {
+        const Note & note = *it;
+        QVERIFY2(note.hasGuid(), "Found note without guid after sending the local changes");
+        QVERIFY2(note.hasUpdateSequenceNumber(), "Found note without update sequence number after sending the local changes");
+        QVERIFY2(note.hasNotebookGuid() && (note.notebookGuid() == notebook.guid()),
+                 "The note's notebook guid doesn't match the guid of the sent notebook");
+        QVERIFY2(note.hasTagGuids() && (note.tagGuids().size() == 1),
+                 "The note doesn't have the guid of its tag after sending the local changes");
+    }
+}
+
+void SendLocalChangesManagerTester::onSentDataItemUpdateSequenceNumber(const qint32 errorCode, const qint32 updateSequenceNumber)
+{
+    if (errorCode != 0) {
+        return;
+    }
+
+    m_sentUpdateSequenceNumbers << updateSequenceNumber;
+}
+
+} // namespace test
+} // namespace quentier
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_TESTS_SEND_LOCAL_CHANGES_MANAGER_TESTER_H
+#define LIB_QUENTIER_TESTS_SEND_LOCAL_CHANGES_MANAGER_TESTER_H
+
+#include "../synchronization/SendLocalChangesManager.h"
+#include <quentier/types/Account.h>
+#include <QList>
+
+QT_FORWARD_DECLARE_CLASS(QThread)
+
+namespace quentier {
+
+namespace benchmark {
+QT_FORWARD_DECLARE_CLASS(FakeSyncService)
+QT_FORWARD_DECLARE_CLASS(FakeNoteStore)
+}
+
+namespace test {
+
+/**
+ * @brief The SendLocalChangesManagerTester class sends the local changes to the fake note store which delivers
+ * the results of the asynchronous requests out of order and fails some of them due to the rate limit
+ */
+class SendLocalChangesManagerTester: public QObject,
+                                     public SendLocalChangesManager::IManager
+{
+    Q_OBJECT
+public:
+    SendLocalChangesManagerTester(QObject * parent = Q_NULLPTR);
+    virtual ~SendLocalChangesManagerTester();
+
+    // SendLocalChangesManager::IManager
+    virtual LocalStorageManagerAsync & localStorageManagerAsync() Q_DECL_OVERRIDE;
+    virtual INoteStore & noteStore() Q_DECL_OVERRIDE;
+    virtual INoteStore * noteStoreForLinkedNotebook(const LinkedNotebook & linkedNotebook) Q_DECL_OVERRIDE;
+    virtual SyncTracer & syncTracer() Q_DECL_OVERRIDE;
+
+// NOTE: these are public so that QTest doesn't run them as test cases
+public Q_SLOTS:
+    void onFinished(qint32 lastUpdateCount, QHash<QString,qint32> lastUpdateCountByLinkedNotebookGuid);
+    void onShouldRepeatIncrementalSync();
+    void onRateLimitExceeded(qint32 secondsToWait);
+
+    void onCreateNotebookAsyncFinished(qint32 errorCode, Notebook notebook, qint32 rateLimitSeconds,
+                                       ErrorString errorDescription, QUuid requestId);
+    void onCreateTagAsyncFinished(qint32 errorCode, Tag tag, qint32 rateLimitSeconds,
+                                  ErrorString errorDescription, QUuid requestId);
+    void onCreateSavedSearchAsyncFinished(qint32 errorCode, SavedSearch savedSearch, qint32 rateLimitSeconds,
+                                          ErrorString errorDescription, QUuid requestId);
+    void onCreateNoteAsyncFinished(qint32 errorCode, Note note, qint32 rateLimitSeconds,
+                                   ErrorString errorDescription, QUuid requestId);
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testSendOutOfOrderWithRateLimit();
+    void testUpdateCountGapRepeatsIncrementalSync();
+
+private:
+    void setupDirtyDataItems();
+    void startLocalStorageManagerAsync();
+    void stopLocalStorageManagerAsync();
+
+    void doTest(const qint32 updateCount);
+    void checkSentDataItems();
+
+    void onSentDataItemUpdateSequenceNumber(const qint32 errorCode, const qint32 updateSequenceNumber);
+
+private:
+    Account                         m_testAccount;
+    benchmark::FakeSyncService *    m_pFakeSyncService;
+    benchmark::FakeNoteStore *      m_pFakeNoteStore;
+    QThread *                       m_pLocalStorageManagerThread;
+    LocalStorageManagerAsync *      m_pLocalStorageManagerAsync;
+    SyncTracer                      m_syncTracer;
+
+    QString                         m_notebookLocalUid;
+    QString                         m_parentTagLocalUid;
+    QString                         m_childTagLocalUid;
+    QString                         m_grandChildTagLocalUid;
+
+    bool                            m_finished;
+    qint32                          m_lastUpdateCount;
+    int                             m_numShouldRepeatIncrementalSyncSignals;
+    int                             m_numRateLimitExceededSignals;
+    QList<qint32>                   m_sentUpdateSequenceNumbers;
+};
+
+} // namespace test
+} // namespace quentier
+
+#endif // LIB_QUENTIER_TESTS_SEND_LOCAL_CHANGES_MANAGER_TESTER_H
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncCheckpointTest.h"
+#include "../synchronization/SyncCheckpoint.h"
+#include <quentier/utility/UidGenerator.h>
+#include <quentier/utility/StandardPaths.h>
+#include <QFile>
+
+namespace quentier {
+namespace test {
+
+bool syncCheckpointTest(QString & error)
+{
+    QString checkpointFilePath = applicationPersistentStoragePath() + QStringLiteral("/SyncCheckpointTest.dat");
+
+    ErrorString errorDescription;
+    if (!SyncCheckpoint::remove(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Failed to remove the leftover sync checkpoint file: ") + errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    SyncCheckpoint checkpoint;
+    errorDescription.clear();
+    if (!checkpoint.read(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Reading the missing sync checkpoint file failed: ") + errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    if (!checkpoint.isEmpty()) {
+        error = QStringLiteral("The sync checkpoint read from the missing file is not empty");
+        return false;
+    }
+
+    QString noteGuid = UidGenerator::Generate();
+    QString resourceGuid = UidGenerator::Generate();
+    checkpoint.setNoteProcessed(noteGuid, 42);
+    checkpoint.setResourceProcessed(resourceGuid, 43);
+
+    const int numNotes = 1000;
+    for(int i = 0; i < numNotes; ++i) {
+        checkpoint.setNoteProcessed(UidGenerator::Generate(), 100 + i);
+    }
+
+    if (!checkpoint.isModified()) {
+        error = QStringLiteral("The sync checkpoint is not marked as modified after recording the processed items");
+        return false;
+    }
+
+    if (!checkpoint.isNoteProcessed(noteGuid, 42) || !checkpoint.isResourceProcessed(resourceGuid, 43)) {
+        error = QStringLiteral("The items recorded in the sync checkpoint are not considered processed");
+        return false;
+    }
+
+    if (checkpoint.isNoteProcessed(noteGuid, 44) || checkpoint.isResourceProcessed(resourceGuid, 44)) {
+        error = QStringLiteral("The items updated since being recorded in the sync checkpoint are considered processed");
+        return false;
+    }
+
+    if (checkpoint.isNoteProcessed(resourceGuid, 43) || checkpoint.isResourceProcessed(noteGuid, 42)) {
+        error = QStringLiteral("The sync checkpoint doesn't distinguish between notes and resources");
+        return false;
+    }
+
+    if (checkpoint.fullSyncInProgress()) {
+        error = QStringLiteral("The sync checkpoint is marked as the full sync one without being told so");
+        return false;
+    }
+
+    // The full sync marker alone makes the checkpoint non-empty: the interrupted full sync has to be resumed
+    // even if no notes or resources were processed before the interruption
+    SyncCheckpoint fullSyncCheckpoint;
+    FullSyncStaleDataItemsExpunger::SyncedGuids syncedGuids;
+    fullSyncCheckpoint.setFullSyncInProgress(0, syncedGuids);
+    if (fullSyncCheckpoint.isEmpty() || !fullSyncCheckpoint.isModified()) {
+        error = QStringLiteral("The sync checkpoint with just the full sync marker is empty or not modified");
+        return false;
+    }
+
+    QString notebookGuid = UidGenerator::Generate();
+    QString tagGuid = UidGenerator::Generate();
+    QString savedSearchGuid = UidGenerator::Generate();
+    Q_UNUSED(syncedGuids.m_syncedNotebookGuids.insert(notebookGuid))
+    Q_UNUSED(syncedGuids.m_syncedTagGuids.insert(tagGuid))
+    Q_UNUSED(syncedGuids.m_syncedNoteGuids.insert(noteGuid))
+    Q_UNUSED(syncedGuids.m_syncedSavedSearchGuids.insert(savedSearchGuid))
+    checkpoint.setFullSyncInProgress(41, syncedGuids);
+
+    errorDescription.clear();
+    if (!checkpoint.write(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Failed to write the sync checkpoint: ") + errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    if (checkpoint.isModified()) {
+        error = QStringLiteral("The sync checkpoint is still marked as modified after being written");
+        return false;
+    }
+
+    if (QFile::exists(checkpointFilePath + QStringLiteral(".tmp"))) {
+        error = QStringLiteral("The temporary sync checkpoint file is left behind after writing the sync checkpoint");
+        return false;
+    }
+
+    SyncCheckpoint readCheckpoint;
+    errorDescription.clear();
+    if (!readCheckpoint.read(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Failed to read the sync checkpoint: ") + errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    if ((readCheckpoint.numProcessedNotes() != numNotes + 1) || (readCheckpoint.numProcessedResources() != 1)) {
+        error = QStringLiteral("Unexpected number of processed items in the sync checkpoint read back: notes = ") +
+                QString::number(readCheckpoint.numProcessedNotes()) + QStringLiteral(", resources = ") +
+                QString::number(readCheckpoint.numProcessedResources());
+        return false;
+    }
+
+    if (!readCheckpoint.isNoteProcessed(noteGuid, 42) || !readCheckpoint.isResourceProcessed(resourceGuid, 43)) {
+        error = QStringLiteral("The items recorded in the sync checkpoint are missing from the sync checkpoint read back");
+        return false;
+    }
+
+    if (readCheckpoint.isModified()) {
+        error = QStringLiteral("The sync checkpoint is marked as modified right after being read");
+        return false;
+    }
+
+    if (!readCheckpoint.fullSyncInProgress() || (readCheckpoint.fullSyncAfterUsn() != 41)) {
+        error = QStringLiteral("The full sync marker is missing from the sync checkpoint read back");
+        return false;
+    }
+
+    const FullSyncStaleDataItemsExpunger::SyncedGuids & readSyncedGuids = readCheckpoint.fullSyncSyncedGuids();
+    if ((readSyncedGuids.m_syncedNotebookGuids != syncedGuids.m_syncedNotebookGuids) ||
+        (readSyncedGuids.m_syncedTagGuids != syncedGuids.m_syncedTagGuids) ||
+        (readSyncedGuids.m_syncedNoteGuids != syncedGuids.m_syncedNoteGuids) ||
+        (readSyncedGuids.m_syncedSavedSearchGuids != syncedGuids.m_syncedSavedSearchGuids))
+    {
+        error = QStringLiteral("The full sync synced guids read back from the sync checkpoint differ from the written ones");
+        return false;
+    }
+
+    // Recording the same full sync state once again is not a modification worth writing the checkpoint for
+    readCheckpoint.setFullSyncInProgress(41, syncedGuids);
+    if (readCheckpoint.isModified()) {
+        error = QStringLiteral("The sync checkpoint is marked as modified after recording the unchanged full sync state");
+        return false;
+    }
+
+    readCheckpoint.setFullSyncInProgress(57, syncedGuids);
+    if (!readCheckpoint.isModified() || (readCheckpoint.fullSyncAfterUsn() != 57)) {
+        error = QStringLiteral("The sync checkpoint is not updated after recording the advanced full sync state");
+        return false;
+    }
+
+    // The corrupted checkpoint file must be reported as such and must not leave any stale items in the checkpoint
+    QFile checkpointFile(checkpointFilePath);
+    if (!checkpointFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = QStringLiteral("Failed to open the sync checkpoint file for corrupting it: ") + checkpointFile.errorString();
+        return false;
+    }
+
+    Q_UNUSED(checkpointFile.write(QByteArray("not a sync checkpoint")))
+    checkpointFile.close();
+
+    errorDescription.clear();
+    if (readCheckpoint.read(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Reading the corrupted sync checkpoint file succeeded");
+        return false;
+    }
+
+    if (!readCheckpoint.isEmpty() || readCheckpoint.fullSyncInProgress()) {
+        error = QStringLiteral("The sync checkpoint is not empty after failing to read the corrupted sync checkpoint file");
+        return false;
+    }
+
+    errorDescription.clear();
+    if (!SyncCheckpoint::remove(checkpointFilePath, errorDescription)) {
+        error = QStringLiteral("Failed to remove the sync checkpoint file: ") + errorDescription.nonLocalizedString();
+        return false;
+    }
+
+    if (QFile::exists(checkpointFilePath)) {
+        error = QStringLiteral("The sync checkpoint file still exists after being removed");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
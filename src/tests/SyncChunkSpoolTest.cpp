@@ -0,0 +1,470 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncChunkSpoolTest.h"
+#include "../synchronization/SyncChunkSpool.h"
+#include <quentier/utility/UidGenerator.h>
+#include <QCryptographicHash>
+
+namespace quentier {
+namespace test {
+
+qevercloud::Resource createSyncChunkSpoolTestResource(const QString & noteGuid, const qint32 usn)
+{
+    qevercloud::Resource resource;
+    resource.guid = UidGenerator::Generate();
+    resource.noteGuid = noteGuid;
+    resource.updateSequenceNum = usn;
+    resource.mime = QStringLiteral("image/png");
+    resource.width = static_cast<qint16>(640);
+    resource.height = static_cast<qint16>(480);
+    resource.active = true;
+
+    QByteArray body = QByteArray(4096, 'x') + noteGuid.toUtf8();
+
+    qevercloud::Data data;
+    data.body = body;
+    data.size = body.size();
+    data.bodyHash = QCryptographicHash::hash(body, QCryptographicHash::Md5);
+    resource.data = data;
+
+    qevercloud::ResourceAttributes attributes;
+    attributes.fileName = QStringLiteral("image.png");
+    attributes.attachment = false;
+    attributes.latitude = 55.75;
+
+    qevercloud::LazyMap applicationData;
+    QMap<QString, QString> fullMap;
+    fullMap[QStringLiteral("key")] = QStringLiteral("value");
+    applicationData.fullMap = fullMap;
+    attributes.applicationData = applicationData;
+
+    resource.attributes = attributes;
+    return resource;
+}
+
+qevercloud::Note createSyncChunkSpoolTestNote(const qint32 usn)
+{
+    qevercloud::Note note;
+    note.guid = UidGenerator::Generate();
+    note.notebookGuid = UidGenerator::Generate();
+    note.updateSequenceNum = usn;
+    note.title = QString::fromUtf8("Note \xd0\xb7\xd0\xb0\xd0\xbc\xd0\xb5\xd1\x82\xd0\xba\xd0\xb0 #") + QString::number(usn);
+    note.content = QStringLiteral("<en-note><div>Note content</div></en-note>");
+    note.created = 1483228800000 + usn;
+    note.updated = 1483228800000 + usn;
+    note.active = true;
+
+    QList<QString> tagGuids;
+    tagGuids << UidGenerator::Generate() << UidGenerator::Generate();
+    note.tagGuids = tagGuids;
+
+    qevercloud::NoteAttributes attributes;
+    attributes.author = QStringLiteral("Author");
+    attributes.reminderOrder = 42;
+    attributes.sharedWithBusiness = true;
+
+    qevercloud::LazyMap applicationData;
+    QSet<QString> keysOnly;
+    keysOnly << QStringLiteral("first") << QStringLiteral("second");
+    applicationData.keysOnly = keysOnly;
+    attributes.applicationData = applicationData;
+    note.attributes = attributes;
+
+    qevercloud::Contact contact;
+    contact.name = QStringLiteral("Contact");
+    contact.type = qevercloud::ContactType::EMAIL;
+
+    qevercloud::Identity identity;
+    identity.id = 7;
+    identity.contact = contact;
+    identity.sameBusiness = false;
+
+    qevercloud::SharedNote sharedNote;
+    sharedNote.sharerUserID = 1;
+    sharedNote.recipientIdentity = identity;
+    sharedNote.privilege = qevercloud::SharedNotePrivilegeLevel::MODIFY_NOTE;
+
+    QList<qevercloud::SharedNote> sharedNotes;
+    sharedNotes << sharedNote;
+    note.sharedNotes = sharedNotes;
+
+    qevercloud::NoteLimits limits;
+    limits.noteResourceCountMax = 100;
+    limits.uploaded = 1024;
+    note.limits = limits;
+
+    QList<qevercloud::Resource> resources;
+    resources << createSyncChunkSpoolTestResource(note.guid.ref(), usn);
+    note.resources = resources;
+
+    return note;
+}
+
+qevercloud::SyncChunk createSyncChunkSpoolTestSyncChunk(const qint32 firstUsn, const int numNotes)
+{
+    qevercloud::SyncChunk syncChunk;
+    syncChunk.currentTime = 1483228800000;
+    syncChunk.updateCount = 1000;
+
+    qint32 usn = firstUsn;
+
+    QList<qevercloud::Tag> tags;
+    qevercloud::Tag tag;
+    tag.guid = UidGenerator::Generate();
+    tag.name = QStringLiteral("Tag #") + QString::number(usn);
+    tag.updateSequenceNum = usn++;
+    tags << tag;
+    syncChunk.tags = tags;
+
+    QList<qevercloud::Note> notes;
+    QList<qevercloud::Resource> resources;
+    for(int i = 0; i < numNotes; ++i) {
+        qevercloud::Note note = createSyncChunkSpoolTestNote(usn++);
+        notes << note;
+        resources << note.resources.ref();
+    }
+
+    syncChunk.notes = notes;
+    syncChunk.resources = resources;
+    syncChunk.chunkHighUSN = usn - 1;
+    return syncChunk;
+}
+
+bool syncChunkSpoolTest(QString & error)
+{
+    QList<qevercloud::SyncChunk> syncChunks;
+    syncChunks << createSyncChunkSpoolTestSyncChunk(1, 3);
+    syncChunks << createSyncChunkSpoolTestSyncChunk(100, 5);
+    syncChunks << createSyncChunkSpoolTestSyncChunk(200, 2);
+
+    // The sync chunk without notes and resources should never be spooled
+    qevercloud::SyncChunk tagsOnlySyncChunk = createSyncChunkSpoolTestSyncChunk(300, 0);
+    tagsOnlySyncChunk.notes.clear();
+    tagsOnlySyncChunk.resources.clear();
+    syncChunks << tagsOnlySyncChunk;
+
+    const int numSyncChunks = syncChunks.size();
+
+    // 1) Without the memory limit nothing should be spooled
+    SyncChunkSpool unlimitedSpool;
+    for(int i = 0; i < numSyncChunks; ++i)
+    {
+        ErrorString errorDescription;
+        if (!unlimitedSpool.append(syncChunks[i], errorDescription)) {
+            error = QStringLiteral("Failed to append the sync chunk to the spool without memory limit: ") +
+                    errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (unlimitedSpool.isSpooled(i)) {
+            error = QStringLiteral("Sync chunk was spooled to disk although there's no memory limit");
+            return false;
+        }
+
+        if (!(unlimitedSpool.at(i) == syncChunks[i])) {
+            error = QStringLiteral("Sync chunk stored in the spool without memory limit differs from the original one");
+            return false;
+        }
+    }
+
+    if (unlimitedSpool.statistics().m_peakMemoryUsageBytes <= 0) {
+        error = QStringLiteral("Peak memory usage of the spool without memory limit is not positive");
+        return false;
+    }
+
+    // 2) With a tiny memory limit notes and resources of every sync chunk containing them should be spooled
+    SyncChunkSpool spool;
+    spool.setMemoryLimit(1);
+
+    for(int i = 0; i < numSyncChunks; ++i)
+    {
+        ErrorString errorDescription;
+        if (!spool.append(syncChunks[i], errorDescription)) {
+            error = QStringLiteral("Failed to append the sync chunk to the spool with memory limit: ") +
+                    errorDescription.nonLocalizedString();
+            return false;
+        }
+    }
+
+    if (spool.size() != numSyncChunks) {
+        error = QStringLiteral("Unexpected number of sync chunks in the spool: expected ") + QString::number(numSyncChunks) +
+                QStringLiteral(", got ") + QString::number(spool.size());
+        return false;
+    }
+
+    for(int i = 0; i < numSyncChunks; ++i)
+    {
+        const qevercloud::SyncChunk & original = syncChunks[i];
+        bool expectedToBeSpooled = original.notes.isSet();
+
+        if (spool.isSpooled(i) != expectedToBeSpooled) {
+            error = QStringLiteral("Unexpected spooled state of the sync chunk #") + QString::number(i);
+            return false;
+        }
+
+        const qevercloud::SyncChunk & inMemory = spool.at(i);
+        if (expectedToBeSpooled && (inMemory.notes.isSet() || inMemory.resources.isSet())) {
+            error = QStringLiteral("Spooled sync chunk still holds notes or resources in memory");
+            return false;
+        }
+
+        if (!inMemory.tags.isSet() || !(inMemory.tags.ref() == original.tags.ref()) ||
+            (inMemory.chunkHighUSN.ref() != original.chunkHighUSN.ref()))
+        {
+            error = QStringLiteral("The in-memory part of the spooled sync chunk differs from the original sync chunk");
+            return false;
+        }
+
+        qevercloud::SyncChunk readSyncChunk;
+        ErrorString errorDescription;
+        if (!spool.read(i, readSyncChunk, errorDescription)) {
+            error = QStringLiteral("Failed to read the sync chunk from the spool: ") + errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (!(readSyncChunk == original)) {
+            error = QStringLiteral("The sync chunk read from the spool differs from the original sync chunk #") + QString::number(i);
+            return false;
+        }
+    }
+
+    // Reading the sync chunks in reverse order should work as well
+    for(int i = numSyncChunks - 1; i >= 0; --i)
+    {
+        qevercloud::SyncChunk readSyncChunk;
+        ErrorString errorDescription;
+        if (!spool.read(i, readSyncChunk, errorDescription) || !(readSyncChunk == syncChunks[i])) {
+            error = QStringLiteral("Failed to read the sync chunk #") + QString::number(i) +
+                    QStringLiteral(" from the spool in reverse order: ") + errorDescription.nonLocalizedString();
+            return false;
+        }
+    }
+
+    const SyncChunkSpool::Statistics & statistics = spool.statistics();
+    if (statistics.m_numSyncChunks != numSyncChunks) {
+        error = QStringLiteral("Unexpected number of sync chunks in the spool statistics");
+        return false;
+    }
+
+    if (statistics.m_numSpooledSyncChunks != (numSyncChunks - 1)) {
+        error = QStringLiteral("Unexpected number of spooled sync chunks in the spool statistics: ") +
+                QString::number(statistics.m_numSpooledSyncChunks);
+        return false;
+    }
+
+    if (statistics.m_spooledBytes <= 0) {
+        error = QStringLiteral("Spooled bytes in the spool statistics are not positive");
+        return false;
+    }
+
+    if (statistics.m_numSpoolReads != static_cast<qint64>(2 * (numSyncChunks - 1))) {
+        error = QStringLiteral("Unexpected number of spool reads in the spool statistics: ") +
+                QString::number(statistics.m_numSpoolReads);
+        return false;
+    }
+
+    if (statistics.m_peakMemoryUsageBytes >= unlimitedSpool.statistics().m_peakMemoryUsageBytes) {
+        error = QStringLiteral("Peak memory usage of the spool with memory limit is not lower than the one of the spool without limit");
+        return false;
+    }
+
+    // 3) Notes and resources taken from the spool one sync chunk at a time should match the original ones
+    // and the memory they occupy should be accounted only until they are released
+    qint64 peakMemoryUsageBytesBeforeTaking = spool.statistics().m_peakMemoryUsageBytes;
+    for(int i = 0; i < numSyncChunks; ++i)
+    {
+        const qevercloud::SyncChunk & original = syncChunks[i];
+
+        QStringList expectedNoteGuids;
+        if (original.notes.isSet())
+        {
+            const QList<qevercloud::Note> & originalNotes = original.notes.ref();
+            for(auto it = originalNotes.constBegin(), end = originalNotes.constEnd(); it != end; ++it) {
+                expectedNoteGuids << it->guid.ref();
+            }
+        }
+
+        if (spool.noteGuids(i) != expectedNoteGuids) {
+            error = QStringLiteral("The note guids of the sync chunk #") + QString::number(i) +
+                    QStringLiteral(" don't match the original ones");
+            return false;
+        }
+
+        if (spool.resourceGuids(i).size() != (original.resources.isSet() ? original.resources->size() : 0)) {
+            error = QStringLiteral("Unexpected number of resource guids of the sync chunk #") + QString::number(i);
+            return false;
+        }
+
+        // The smallest USNs are recorded on appending the sync chunk and are available regardless of spooling
+        qint32 expectedNotesSmallestUsn = -1;
+        if (original.notes.isSet())
+        {
+            const QList<qevercloud::Note> & originalNotes = original.notes.ref();
+            for(auto it = originalNotes.constBegin(), end = originalNotes.constEnd(); it != end; ++it)
+            {
+                if ((expectedNotesSmallestUsn < 0) || (it->updateSequenceNum.ref() < expectedNotesSmallestUsn)) {
+                    expectedNotesSmallestUsn = it->updateSequenceNum.ref();
+                }
+            }
+        }
+
+        qint32 expectedResourcesSmallestUsn = -1;
+        if (original.resources.isSet())
+        {
+            const QList<qevercloud::Resource> & originalResources = original.resources.ref();
+            for(auto it = originalResources.constBegin(), end = originalResources.constEnd(); it != end; ++it)
+            {
+                if ((expectedResourcesSmallestUsn < 0) || (it->updateSequenceNum.ref() < expectedResourcesSmallestUsn)) {
+                    expectedResourcesSmallestUsn = it->updateSequenceNum.ref();
+                }
+            }
+        }
+
+        if ((spool.notesSmallestUsn(i) != expectedNotesSmallestUsn) ||
+            (spool.resourcesSmallestUsn(i) != expectedResourcesSmallestUsn))
+        {
+            error = QStringLiteral("Unexpected smallest USNs of notes and resources of the sync chunk #") + QString::number(i) +
+                    QStringLiteral(": notes: ") + QString::number(spool.notesSmallestUsn(i)) + QStringLiteral(" instead of ") +
+                    QString::number(expectedNotesSmallestUsn) + QStringLiteral(", resources: ") +
+                    QString::number(spool.resourcesSmallestUsn(i)) + QStringLiteral(" instead of ") +
+                    QString::number(expectedResourcesSmallestUsn);
+            return false;
+        }
+
+        qint64 memoryUsageBytesBeforeTaking = spool.statistics().m_memoryUsageBytes;
+
+        QList<qevercloud::Note> notes;
+        ErrorString errorDescription;
+        if (!spool.takeNotes(i, notes, errorDescription)) {
+            error = QStringLiteral("Failed to take the notes of the sync chunk from the spool: ") + errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (notes != (original.notes.isSet() ? original.notes.ref() : QList<qevercloud::Note>())) {
+            error = QStringLiteral("The notes taken from the spool differ from the original ones for the sync chunk #") + QString::number(i);
+            return false;
+        }
+
+        if (!spool.notesTaken(i) || spool.resourcesTaken(i)) {
+            error = QStringLiteral("Unexpected taken state of the sync chunk #") + QString::number(i);
+            return false;
+        }
+
+        QList<qevercloud::Note> notesTakenTwice;
+        errorDescription.clear();
+        if (spool.takeNotes(i, notesTakenTwice, errorDescription)) {
+            error = QStringLiteral("The notes of the same sync chunk were taken from the spool twice");
+            return false;
+        }
+
+        // The sync chunk read after its notes were taken should contain only the resources
+        qevercloud::SyncChunk readSyncChunk;
+        errorDescription.clear();
+        if (!spool.read(i, readSyncChunk, errorDescription)) {
+            error = QStringLiteral("Failed to read the sync chunk with taken notes from the spool: ") + errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (readSyncChunk.notes.isSet() || (readSyncChunk.resources.isSet() != original.resources.isSet())) {
+            error = QStringLiteral("The sync chunk read after its notes were taken from the spool is unexpected");
+            return false;
+        }
+
+        QList<qevercloud::Resource> resources;
+        errorDescription.clear();
+        if (!spool.takeResources(i, resources, errorDescription)) {
+            error = QStringLiteral("Failed to take the resources of the sync chunk from the spool: ") + errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (resources != (original.resources.isSet() ? original.resources.ref() : QList<qevercloud::Resource>())) {
+            error = QStringLiteral("The resources taken from the spool differ from the original ones for the sync chunk #") + QString::number(i);
+            return false;
+        }
+
+        // The notes and resources of the in-memory sync chunks are accounted since they were appended to the spool
+        // while the ones of the spooled sync chunks are accounted only since they were taken from it
+        qint64 expectedMemoryUsageBytes = memoryUsageBytesBeforeTaking;
+        if (spool.isSpooled(i)) {
+            expectedMemoryUsageBytes += spool.estimatedMemoryUsage(i);
+        }
+
+        if (spool.statistics().m_memoryUsageBytes != expectedMemoryUsageBytes) {
+            error = QStringLiteral("The memory occupied by the notes and resources taken from the spool is not accounted properly: expected ") +
+                    QString::number(expectedMemoryUsageBytes) + QStringLiteral(", got ") +
+                    QString::number(spool.statistics().m_memoryUsageBytes);
+            return false;
+        }
+
+        spool.releaseNotes(i);
+        spool.releaseResources(i);
+
+        expectedMemoryUsageBytes -= spool.estimatedMemoryUsage(i);
+        if (spool.statistics().m_memoryUsageBytes != expectedMemoryUsageBytes) {
+            error = QStringLiteral("The memory occupied by the released notes and resources is still accounted for the sync chunk #") +
+                    QString::number(i);
+            return false;
+        }
+    }
+
+    if (spool.statistics().m_peakMemoryUsageBytes != peakMemoryUsageBytesBeforeTaking) {
+        error = QStringLiteral("Taking the notes and resources from the spool one sync chunk at a time increased the peak memory usage");
+        return false;
+    }
+
+    // 4) Releasing the notes and resources taken from the in-memory sync chunks should decrease the memory usage
+    for(int i = 0; i < numSyncChunks; ++i)
+    {
+        QList<qevercloud::Note> notes;
+        QList<qevercloud::Resource> resources;
+        ErrorString errorDescription;
+        if (!unlimitedSpool.takeNotes(i, notes, errorDescription) ||
+            !unlimitedSpool.takeResources(i, resources, errorDescription))
+        {
+            error = QStringLiteral("Failed to take the notes and resources from the spool without memory limit: ") +
+                    errorDescription.nonLocalizedString();
+            return false;
+        }
+
+        if (unlimitedSpool.at(i).notes.isSet() || unlimitedSpool.at(i).resources.isSet()) {
+            error = QStringLiteral("The in-memory sync chunk still holds the notes or resources taken from the spool");
+            return false;
+        }
+
+        unlimitedSpool.releaseNotes(i);
+        unlimitedSpool.releaseResources(i);
+    }
+
+    if (unlimitedSpool.statistics().m_memoryUsageBytes != 0) {
+        error = QStringLiteral("The memory usage of the spool without memory limit is not zero after releasing all notes and resources: ") +
+                QString::number(unlimitedSpool.statistics().m_memoryUsageBytes);
+        return false;
+    }
+
+    spool.clear();
+    if (!spool.isEmpty() || (spool.statistics().m_numSyncChunks != 0) || (spool.statistics().m_spooledBytes != 0)) {
+        error = QStringLiteral("The spool is not empty after clearing");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncChunkWindowTest.h"
+#include "../synchronization/SyncChunkWindow.h"
+
+namespace quentier {
+namespace test {
+
+bool syncChunkWindowTest(QString & error)
+{
+    SyncChunkWindow window;
+
+    if (window.window() != 50) {
+        error = QStringLiteral("Unexpected initial sync chunk window: expected 50, got %1").arg(window.window());
+        return false;
+    }
+
+    // Fast download of the small sync chunk doubles the window
+    window.onSyncChunkDownloaded(50, 100, 1000, /* last sync chunk = */ false);
+    if (window.window() != 100) {
+        error = QStringLiteral("Unexpected sync chunk window after the fast download: expected 100, got %1")
+                .arg(window.window());
+        return false;
+    }
+
+    // The last sync chunk doesn't affect the window
+    window.onSyncChunkDownloaded(100, 10, 10, /* last sync chunk = */ true);
+    if (window.window() != 100) {
+        error = QStringLiteral("The last sync chunk has changed the sync chunk window: expected 100, got %1")
+                .arg(window.window());
+        return false;
+    }
+
+    // Slow download halves the window
+    window.onSyncChunkDownloaded(100, 6000, 1000, /* last sync chunk = */ false);
+    if (window.window() != 50) {
+        error = QStringLiteral("Unexpected sync chunk window after the slow download: expected 50, got %1")
+                .arg(window.window());
+        return false;
+    }
+
+    // The download taking the target time keeps the window
+    window.onSyncChunkDownloaded(50, 3000, 1000, /* last sync chunk = */ false);
+    if (window.window() != 50) {
+        error = QStringLiteral("Unexpected sync chunk window after the download taking the target time: "
+                                  "expected 50, got %1").arg(window.window());
+        return false;
+    }
+
+    // Fast download of the large sync chunk shrinks the window
+    window.onSyncChunkDownloaded(50, 100, Q_INT64_C(8388608), /* last sync chunk = */ false);
+    if (window.window() != 25) {
+        error = QStringLiteral("Unexpected sync chunk window after the download of the large sync chunk: "
+                                  "expected 25, got %1").arg(window.window());
+        return false;
+    }
+
+    window.onRateLimitReached();
+    if (window.window() != 12) {
+        error = QStringLiteral("Unexpected sync chunk window after reaching the rate limit: expected 12, got %1")
+                .arg(window.window());
+        return false;
+    }
+
+    window.onRateLimitReached();
+    if (window.window() != window.minWindow()) {
+        error = QStringLiteral("The sync chunk window went below the min window: expected %1, got %2")
+                .arg(window.minWindow()).arg(window.window());
+        return false;
+    }
+
+    const SyncChunkWindow::Metrics & metrics = window.metrics();
+    if ((metrics.m_numSyncChunks != 5) || (metrics.m_numRateLimitHits != 2) ||
+        (metrics.m_largestWindow != 100) || (metrics.m_smallestWindow != window.minWindow()))
+    {
+        error = QStringLiteral("Unexpected sync chunk window metrics: sync chunks = %1, rate limit hits = %2, "
+                                  "largest window = %3, smallest window = %4")
+                .arg(metrics.m_numSyncChunks).arg(metrics.m_numRateLimitHits)
+                .arg(metrics.m_largestWindow).arg(metrics.m_smallestWindow);
+        return false;
+    }
+
+    window.setMaxWindow(60);
+    for(int i = 0; i < 5; ++i) {
+        window.onSyncChunkDownloaded(window.window(), 100, 1000, /* last sync chunk = */ false);
+    }
+
+    if (window.window() != 60) {
+        error = QStringLiteral("The sync chunk window doesn't respect the max window: expected 60, got %1")
+                .arg(window.window());
+        return false;
+    }
+
+    window.setMaxWindow(1);
+    if ((window.maxWindow() != window.minWindow()) || (window.window() != window.minWindow())) {
+        error = QStringLiteral("The max window less than the min window is not treated as the min window: "
+                                  "max window = %1, window = %2").arg(window.maxWindow()).arg(window.window());
+        return false;
+    }
+
+    window.setMaxWindow(250);
+    window.clear();
+    if ((window.window() != 50) || (window.maxWindow() != 250) || (window.metrics().m_numSyncChunks != 0)) {
+        error = QStringLiteral("The sync chunk window was not reset properly: window = %1, max window = %2, "
+                                  "sync chunks = %3").arg(window.window()).arg(window.maxWindow())
+                .arg(window.metrics().m_numSyncChunks);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyncTracerTest.h"
+#include "../synchronization/SyncTracer.h"
+#include <QByteArray>
+
+namespace quentier {
+namespace test {
+
+bool syncTracerTest(QString & error)
+{
+    qint64 timestamp = 1000000;
+
+    // 1) Nothing is recorded while the tracing is disabled
+    {
+        SyncTracer tracer;
+        tracer.beginSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("guid"), timestamp);
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::NoteDownload, QStringLiteral("guid"))) {
+            error = QStringLiteral("The disabled tracer has started a span");
+            return false;
+        }
+
+        if (tracer.endSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("guid"), timestamp + 10, 1, 100)) {
+            error = QStringLiteral("The disabled tracer has finished a span");
+            return false;
+        }
+
+        tracer.recordRateLimitWait(5, timestamp);
+
+        if (tracer.numEvents() != 0) {
+            error = QStringLiteral("The disabled tracer has recorded some events");
+            return false;
+        }
+
+        if (tracer.phaseMetrics(SyncTracer::Phase::RateLimitWait).m_numSpans != 0) {
+            error = QStringLiteral("The disabled tracer has updated the phase metrics");
+            return false;
+        }
+    }
+
+    // 2) The overlapping spans within the same phase are told apart by their ids and contribute to the phase metrics
+    {
+        SyncTracer tracer;
+        tracer.setEnabled(true);
+
+        tracer.beginSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("first"), timestamp);
+        tracer.beginSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("second"), timestamp + 100);
+
+        if (!tracer.hasSpanInProgress(SyncTracer::Phase::NoteDownload, QStringLiteral("first")) ||
+            !tracer.hasSpanInProgress(SyncTracer::Phase::NoteDownload, QStringLiteral("second")))
+        {
+            error = QStringLiteral("The tracer has lost one of the overlapping spans");
+            return false;
+        }
+
+        if (tracer.hasSpanInProgress(SyncTracer::Phase::ResourceDownload, QStringLiteral("first"))) {
+            error = QStringLiteral("The span in progress is found within the wrong phase");
+            return false;
+        }
+
+        if (!tracer.endSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("second"), timestamp + 400, 1, 3000)) {
+            error = QStringLiteral("Failed to finish the span in progress");
+            return false;
+        }
+
+        if (!tracer.endSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("first"), timestamp + 1000, 1, 1000)) {
+            error = QStringLiteral("Failed to finish the span in progress");
+            return false;
+        }
+
+        if (tracer.endSpan(SyncTracer::Phase::NoteDownload, QStringLiteral("first"), timestamp + 1100)) {
+            error = QStringLiteral("The already finished span was finished once again");
+            return false;
+        }
+
+        const SyncTracer::PhaseMetrics & metrics = tracer.phaseMetrics(SyncTracer::Phase::NoteDownload);
+        if (metrics.m_numSpans != 2) {
+            error = QStringLiteral("Wrong number of spans in the phase metrics: expected 2, got ") +
+                    QString::number(metrics.m_numSpans);
+            return false;
+        }
+
+        if (metrics.m_totalDurationMsec != 1300) {
+            error = QStringLiteral("Wrong total duration in the phase metrics: expected 1300, got ") +
+                    QString::number(metrics.m_totalDurationMsec);
+            return false;
+        }
+
+        if (metrics.m_maxDurationMsec != 1000) {
+            error = QStringLiteral("Wrong max duration in the phase metrics: expected 1000, got ") +
+                    QString::number(metrics.m_maxDurationMsec);
+            return false;
+        }
+
+        if (metrics.averageDurationMsec() != 650) {
+            error = QStringLiteral("Wrong average duration in the phase metrics: expected 650, got ") +
+                    QString::number(metrics.averageDurationMsec());
+            return false;
+        }
+
+        if ((metrics.m_numItems != 2) || (metrics.m_numBytes != 4000)) {
+            error = QStringLiteral("Wrong number of items or bytes in the phase metrics");
+            return false;
+        }
+
+        // Two items within one second between the start of the first span and the end of the last one
+        if (metrics.itemsPerSecond() != 2.0) {
+            error = QStringLiteral("Wrong throughput in the phase metrics: expected 2 items per second, got ") +
+                    QString::number(metrics.itemsPerSecond());
+            return false;
+        }
+
+        tracer.recordRateLimitWait(3, timestamp + 2000);
+        if (tracer.phaseMetrics(SyncTracer::Phase::RateLimitWait).m_totalDurationMsec != 3000) {
+            error = QStringLiteral("The rate limit wait was not accounted in the phase metrics");
+            return false;
+        }
+
+        if (tracer.numEvents() != 5) {
+            error = QStringLiteral("Wrong number of recorded events: expected 5, got ") + QString::number(tracer.numEvents());
+            return false;
+        }
+
+        tracer.clear();
+        if ((tracer.numEvents() != 0) || (tracer.phaseMetrics(SyncTracer::Phase::NoteDownload).m_numSpans != 0)) {
+            error = QStringLiteral("The tracer has not dropped the recorded data on clear");
+            return false;
+        }
+
+        if (!tracer.isEnabled()) {
+            error = QStringLiteral("The tracer got disabled on clear");
+            return false;
+        }
+    }
+
+    // 3) The events above the limit are dropped but the phase metrics are still updated
+    {
+        SyncTracer tracer;
+        tracer.setEnabled(true);
+        tracer.setMaxNumEvents(2);
+
+        for(int i = 0; i < 3; ++i) {
+            QString id = QString::number(i);
+            tracer.beginSpan(SyncTracer::Phase::LocalStorageWrite, id, timestamp + i);
+            Q_UNUSED(tracer.endSpan(SyncTracer::Phase::LocalStorageWrite, id, timestamp + i + 1, 1))
+        }
+
+        if ((tracer.numEvents() != 2) || (tracer.numDroppedEvents() != 4)) {
+            error = QStringLiteral("The events above the limit were not dropped properly");
+            return false;
+        }
+
+        if (tracer.phaseMetrics(SyncTracer::Phase::LocalStorageWrite).m_numItems != 3) {
+            error = QStringLiteral("The phase metrics were not updated after the events limit was reached");
+            return false;
+        }
+    }
+
+    // 4) The exported trace is in Chrome trace event format with timestamps in microseconds relative to the first event
+    {
+        SyncTracer tracer;
+        tracer.setEnabled(true);
+
+        tracer.beginSpan(SyncTracer::Phase::SyncChunksDownload, QStringLiteral("\"quoted\""), timestamp);
+        Q_UNUSED(tracer.endSpan(SyncTracer::Phase::SyncChunksDownload, QStringLiteral("\"quoted\""), timestamp + 20, 1, 512))
+
+        QByteArray json = tracer.toChromeTraceJson();
+
+        if (!json.startsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[")) {
+            error = QStringLiteral("The exported trace doesn't start with the trace events array: ") + QString::fromUtf8(json);
+            return false;
+        }
+
+        if (!json.contains("\"name\":\"SyncChunksDownload\",\"cat\":\"SyncChunksDownload\",\"ph\":\"b\",\"ts\":0,")) {
+            error = QStringLiteral("The exported trace lacks the span begin event: ") + QString::fromUtf8(json);
+            return false;
+        }
+
+        if (!json.contains("\"ph\":\"e\",\"ts\":20000,")) {
+            error = QStringLiteral("The exported trace lacks the span end event with timestamp in microseconds: ") +
+                    QString::fromUtf8(json);
+            return false;
+        }
+
+        if (!json.contains("\"id\":\"SyncChunksDownload:\\\"quoted\\\"\"")) {
+            error = QStringLiteral("The span id is not escaped properly within the exported trace: ") + QString::fromUtf8(json);
+            return false;
+        }
+
+        if (!json.contains("\"items\":1,\"bytes\":512")) {
+            error = QStringLiteral("The exported trace lacks the number of items and bytes of the span: ") +
+                    QString::fromUtf8(json);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace test
+} // namespace quentier
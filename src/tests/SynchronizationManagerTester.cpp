@@ -0,0 +1,846 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SynchronizationManagerTester.h"
+#include "../benchmarks/FakeAuthenticationManager.h"
+#include "../benchmarks/FakeNoteStore.h"
+#include "../benchmarks/FakeUserStore.h"
+#include <quentier/synchronization/SynchronizationManager.h>
+#include <quentier/local_storage/LocalStorageManagerAsync.h>
+#include <quentier/utility/EventLoopWithExitStatus.h>
+#include <QtTest/QTest>
+#include <QDateTime>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+
+// 10 minutes should be enough
+#define MAX_ALLOWED_MILLISECONDS 600000
+
+#define FAKE_SYNC_SERVICE_SEED (23)
+
+namespace quentier {
+namespace test {
+
+SynchronizationManagerTester::SynchronizationManagerTester(QObject * parent) :
+    QObject(parent),
+    m_testAccount(),
+    m_host(),
+    m_pFakeSyncService(Q_NULLPTR),
+    m_pLocalStorageManagerThread(Q_NULLPTR),
+    m_pLocalStorageManagerAsync(Q_NULLPTR),
+    m_pAuthenticationManager(Q_NULLPTR),
+    m_pSynchronizationManager(Q_NULLPTR),
+    m_failedLinkedNotebookGuids(),
+    m_foundResource(),
+    m_downloadedResource()
+{}
+
+SynchronizationManagerTester::~SynchronizationManagerTester()
+{}
+
+void SynchronizationManagerTester::init()
+{
+    // NOTE: the last sync parameters are persisted per host so each test needs its own one in order to start
+    // with the full sync
+    m_host = QStringLiteral("fake") + QString::number(QDateTime::currentMSecsSinceEpoch()) +
+             QStringLiteral(".evernote.local");
+
+    m_failedLinkedNotebookGuids.clear();
+    m_foundResource = Resource();
+    m_downloadedResource = Resource();
+}
+
+void SynchronizationManagerTester::onLinkedNotebookSyncFailed(LinkedNotebook linkedNotebook, ErrorString errorDescription)
+{
+    Q_UNUSED(errorDescription)
+    m_failedLinkedNotebookGuids << linkedNotebook.guid();
+}
+
+void SynchronizationManagerTester::onFindResourceComplete(Resource resource, bool withBinaryData, QUuid requestId)
+{
+    Q_UNUSED(withBinaryData)
+    Q_UNUSED(requestId)
+    m_foundResource = resource;
+}
+
+void SynchronizationManagerTester::onDownloadResourceDataComplete(Resource resource, QUuid requestId)
+{
+    Q_UNUSED(requestId)
+    m_downloadedResource = resource;
+}
+
+void SynchronizationManagerTester::cleanup()
+{
+    stopSynchronization();
+
+    delete m_pFakeSyncService;
+    m_pFakeSyncService = Q_NULLPTR;
+}
+
+void SynchronizationManagerTester::testIncrementalSyncDownloadsOnlyChangedNoteData()
+{
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 1;
+    settings.m_recordNoteRequests = true;
+
+    setupSynchronization(settings, /* num notes = */ 50);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QStringList noteGuidsWithResources;
+    QStringList noteGuids = m_pFakeSyncService->noteGuids();
+    noteGuids.sort();
+    for(auto it = noteGuids.constBegin(), end = noteGuids.constEnd(); it != end; ++it)
+    {
+        if (m_pFakeSyncService->numNoteResources(*it) > 0) {
+            noteGuidsWithResources << *it;
+        }
+    }
+
+    QVERIFY2(noteGuidsWithResources.size() >= 4, "The fake sync service has too few notes with resources");
+
+    const QString & metadataOnlyChangedNoteGuid = noteGuidsWithResources[0];
+    const QString & contentChangedNoteGuid = noteGuidsWithResources[1];
+    const QString & resourceDataChangedNoteGuid = noteGuidsWithResources[2];
+    const QString & newResourceNoteGuid = noteGuidsWithResources[3];
+
+    QVERIFY(m_pFakeSyncService->modifyNoteTitle(metadataOnlyChangedNoteGuid));
+    QVERIFY(m_pFakeSyncService->modifyNoteContent(contentChangedNoteGuid));
+    QVERIFY(m_pFakeSyncService->modifyNoteResourceData(resourceDataChangedNoteGuid));
+    QVERIFY(m_pFakeSyncService->addNoteResource(newResourceNoteGuid));
+
+    m_pFakeSyncService->resetStatistics();
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QVERIFY2(!m_pFakeSyncService->noteRequestsByGuid().contains(metadataOnlyChangedNoteGuid),
+             "The note with changed metadata only was downloaded during the incremental sync");
+
+    checkNoteRequest(contentChangedNoteGuid, /* with content = */ true, /* with resources data = */ false,
+                     /* with resources recognition = */ false, /* with resources alternate data = */ false);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    checkNoteRequest(resourceDataChangedNoteGuid, /* with content = */ false, /* with resources data = */ true,
+                     /* with resources recognition = */ false, /* with resources alternate data = */ false);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // The new resource comes with the recognition data
+    checkNoteRequest(newResourceNoteGuid, /* with content = */ false, /* with resources data = */ true,
+                     /* with resources recognition = */ true, /* with resources alternate data = */ false);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    stopSynchronization();
+
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+
+    checkLocalNote(localStorageManager, metadataOnlyChangedNoteGuid);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    checkLocalNote(localStorageManager, contentChangedNoteGuid);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    checkLocalNote(localStorageManager, resourceDataChangedNoteGuid);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    checkLocalNote(localStorageManager, newResourceNoteGuid);
+}
+
+void SynchronizationManagerTester::testTagTreeWithSameLevelRenameSwap()
+{
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 1;
+
+    setupSynchronization(settings, /* num notes = */ 10);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QHash<QString,QString> namesByGuid;
+    QHash<QString,QString> parentGuidsByGuid;
+
+    // The tree of three levels with two tags at each of the lower levels
+    const QString rootTagGuid = putTag(QStringLiteral("Root"), QString());
+    const QString firstChildTagGuid = putTag(QStringLiteral("First child"), rootTagGuid);
+    const QString secondChildTagGuid = putTag(QStringLiteral("Second child"), rootTagGuid);
+    const QString firstGrandChildTagGuid = putTag(QStringLiteral("First grand child"), firstChildTagGuid);
+    const QString secondGrandChildTagGuid = putTag(QStringLiteral("Second grand child"), secondChildTagGuid);
+
+    namesByGuid[rootTagGuid] = QStringLiteral("Root");
+    namesByGuid[firstChildTagGuid] = QStringLiteral("First child");
+    namesByGuid[secondChildTagGuid] = QStringLiteral("Second child");
+    namesByGuid[firstGrandChildTagGuid] = QStringLiteral("First grand child");
+    namesByGuid[secondGrandChildTagGuid] = QStringLiteral("Second grand child");
+
+    parentGuidsByGuid[firstChildTagGuid] = rootTagGuid;
+    parentGuidsByGuid[secondChildTagGuid] = rootTagGuid;
+    parentGuidsByGuid[firstGrandChildTagGuid] = firstChildTagGuid;
+    parentGuidsByGuid[secondGrandChildTagGuid] = secondChildTagGuid;
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Another client swaps the names of the two tags from the same level and adds one more tag to the lowest level;
+    // each of the renamed tags gets the name the other one still has locally by the time it is processed
+    QVERIFY(m_pFakeSyncService->renameTag(firstChildTagGuid, QStringLiteral("Second child")));
+    QVERIFY(m_pFakeSyncService->renameTag(secondChildTagGuid, QStringLiteral("First child")));
+    const QString thirdGrandChildTagGuid = putTag(QStringLiteral("Third grand child"), secondChildTagGuid);
+
+    namesByGuid[firstChildTagGuid] = QStringLiteral("Second child");
+    namesByGuid[secondChildTagGuid] = QStringLiteral("First child");
+    namesByGuid[thirdGrandChildTagGuid] = QStringLiteral("Third grand child");
+    parentGuidsByGuid[thirdGrandChildTagGuid] = secondChildTagGuid;
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    stopSynchronization();
+    checkLocalTags(namesByGuid, parentGuidsByGuid);
+}
+
+void SynchronizationManagerTester::testInaccessibleLinkedNotebookIsSkipped()
+{
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 1;
+    settings.m_recordNoteRequests = true;
+
+    setupSynchronization(settings, /* num notes = */ 10);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QObject::connect(m_pSynchronizationManager,
+                     QNSIGNAL(SynchronizationManager,linkedNotebookSyncFailed,LinkedNotebook,ErrorString),
+                     this, QNSLOT(SynchronizationManagerTester,onLinkedNotebookSyncFailed,LinkedNotebook,ErrorString));
+
+    QStringList linkedNotebookGuids;
+    for(int i = 0; i < 3; ++i) {
+        linkedNotebookGuids << m_pFakeSyncService->addLinkedNotebook(/* num notes = */ 3);
+    }
+
+    const QString & inaccessibleLinkedNotebookGuid = linkedNotebookGuids[1];
+    QVERIFY(m_pFakeSyncService->setLinkedNotebookAccessible(inaccessibleLinkedNotebookGuid, false));
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QCOMPARE(m_failedLinkedNotebookGuids, QStringList() << inaccessibleLinkedNotebookGuid);
+
+    for(auto it = linkedNotebookGuids.constBegin(), end = linkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        const bool shouldBeDownloaded = (*it != inaccessibleLinkedNotebookGuid);
+        const QStringList noteGuids = m_pFakeSyncService->linkedNotebookNoteGuids(*it);
+        for(auto nit = noteGuids.constBegin(), nend = noteGuids.constEnd(); nit != nend; ++nit) {
+            QVERIFY2(m_pFakeSyncService->noteRequestsByGuid().contains(*nit) == shouldBeDownloaded,
+                     qPrintable(QStringLiteral("Unexpected download state of the linked notebook's note after the first sync: ")
+                                + *nit));
+        }
+    }
+
+    // Once the access is restored, the next sync picks the skipped linked notebook's content as its last update count
+    // has not advanced while the rest of linked notebooks have no updates to download
+    QVERIFY(m_pFakeSyncService->setLinkedNotebookAccessible(inaccessibleLinkedNotebookGuid, true));
+    m_pFakeSyncService->resetStatistics();
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QCOMPARE(m_failedLinkedNotebookGuids.size(), 1);
+
+    for(auto it = linkedNotebookGuids.constBegin(), end = linkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        const bool shouldBeDownloaded = (*it == inaccessibleLinkedNotebookGuid);
+        const QStringList noteGuids = m_pFakeSyncService->linkedNotebookNoteGuids(*it);
+        for(auto nit = noteGuids.constBegin(), nend = noteGuids.constEnd(); nit != nend; ++nit) {
+            QVERIFY2(m_pFakeSyncService->noteRequestsByGuid().contains(*nit) == shouldBeDownloaded,
+                     qPrintable(QStringLiteral("Unexpected download state of the linked notebook's note after the second sync: ")
+                                + *nit));
+        }
+    }
+
+    stopSynchronization();
+
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+
+    for(auto it = linkedNotebookGuids.constBegin(), end = linkedNotebookGuids.constEnd(); it != end; ++it)
+    {
+        const QStringList noteGuids = m_pFakeSyncService->linkedNotebookNoteGuids(*it);
+        for(auto nit = noteGuids.constBegin(), nend = noteGuids.constEnd(); nit != nend; ++nit)
+        {
+            checkLocalNote(localStorageManager, *nit);
+            if (QTest::currentTestFailed()) {
+                return;
+            }
+        }
+    }
+}
+
+void SynchronizationManagerTester::testOnDemandResourceDataDownload()
+{
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 1;
+    settings.m_recordNoteRequests = true;
+
+    setupSynchronization(settings, /* num notes = */ 30);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    m_pSynchronizationManager->setDownloadResourceDataOnDemand(true);
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QString noteGuid;
+    QStringList noteGuids = m_pFakeSyncService->noteGuids();
+    noteGuids.sort();
+    for(auto it = noteGuids.constBegin(), end = noteGuids.constEnd(); it != end; ++it)
+    {
+        if (m_pFakeSyncService->numNoteResources(*it) > 0) {
+            noteGuid = *it;
+            break;
+        }
+    }
+
+    QVERIFY2(!noteGuid.isEmpty(), "The fake sync service has no notes with resources");
+
+    // The note comes with the content and the resources' recognition data but without the resources' data
+    checkNoteRequest(noteGuid, /* with content = */ true, /* with resources data = */ false,
+                     /* with resources recognition = */ true, /* with resources alternate data = */ false);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    qevercloud::Note qecNote;
+    QVERIFY(m_pFakeSyncService->findNote(noteGuid, /* with content = */ false, /* with resources data = */ true,
+                                         /* with resources recognition = */ false,
+                                         /* with resources alternate data = */ false, qecNote));
+    const Resource remoteResource(qecNote.resources.ref()[0]);
+
+    findLocalResource(remoteResource.guid());
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QVERIFY2(m_foundResource.hasDataHash() && !m_foundResource.hasDataBody(),
+             "The local resource should have the data hash but no data body before the on-demand download");
+
+    m_pFakeSyncService->resetStatistics();
+
+    downloadResourceData(m_foundResource);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QCOMPARE(m_pFakeSyncService->statistics().m_numResourceRequests, qint64(1));
+    QVERIFY2(m_downloadedResource.hasDataBody() && (m_downloadedResource.dataBody() == remoteResource.dataBody()),
+             "The downloaded resource's data body differs from the remote one");
+
+    stopSynchronization();
+
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+
+    Resource localResource;
+    localResource.unsetLocalUid();
+    localResource.setGuid(remoteResource.guid());
+
+    ErrorString errorDescription;
+    bool res = localStorageManager.findEnResource(localResource, errorDescription, /* with binary data = */ true);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(localResource.hasDataBody() && (localResource.dataBody() == remoteResource.dataBody()),
+             "The local resource's data body differs from the remote one after the on-demand download");
+}
+
+void SynchronizationManagerTester::testSelectiveSyncFilterWideningAndNoteMovedOutOfSelection()
+{
+    benchmark::FakeSyncService::Settings settings;
+    settings.m_latencyMsec = 1;
+    settings.m_recordNoteRequests = true;
+
+    setupSynchronization(settings, /* num notes = */ 40);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QHash<QString,QString> notebookGuidsByNoteGuid;
+    QHash<QString,QStringList> noteGuidsByNotebookGuid;
+    QStringList noteGuids = m_pFakeSyncService->noteGuids();
+    noteGuids.sort();
+    for(auto it = noteGuids.constBegin(), end = noteGuids.constEnd(); it != end; ++it)
+    {
+        const QString notebookGuid = m_pFakeSyncService->noteNotebookGuid(*it);
+        notebookGuidsByNoteGuid[*it] = notebookGuid;
+        noteGuidsByNotebookGuid[notebookGuid] << *it;
+    }
+
+    QStringList notebookGuids = noteGuidsByNotebookGuid.keys();
+    notebookGuids.sort();
+    QVERIFY2(notebookGuids.size() >= 3, "The fake sync service has too few notebooks with notes");
+
+    const QString & initiallySelectedNotebookGuid = notebookGuids[0];
+    const QString & laterSelectedNotebookGuid = notebookGuids[1];
+    const QString & unselectedNotebookGuid = notebookGuids[2];
+
+    m_pSynchronizationManager->setSelectiveSyncFilter(QStringList() << initiallySelectedNotebookGuid, QStringList());
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    for(auto it = notebookGuidsByNoteGuid.constBegin(), end = notebookGuidsByNoteGuid.constEnd(); it != end; ++it) {
+        QVERIFY2(m_pFakeSyncService->noteRequestsByGuid().contains(it.key()) == (it.value() == initiallySelectedNotebookGuid),
+                 qPrintable(QStringLiteral("Unexpected download state of the note after the first sync: ") + it.key()));
+    }
+
+    // Another client moves one of the synchronized notes out of the selection while the selection gets widened
+    // by one more notebook
+    const QString movedNoteGuid = noteGuidsByNotebookGuid[initiallySelectedNotebookGuid].first();
+    QVERIFY(m_pFakeSyncService->moveNote(movedNoteGuid, unselectedNotebookGuid));
+
+    m_pSynchronizationManager->setSelectiveSyncFilter(QStringList() << initiallySelectedNotebookGuid
+                                                      << laterSelectedNotebookGuid, QStringList());
+    m_pFakeSyncService->resetStatistics();
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Only the notes from the newly selected notebook are downloaded: the moved note has its metadata changed only
+    for(auto it = notebookGuidsByNoteGuid.constBegin(), end = notebookGuidsByNoteGuid.constEnd(); it != end; ++it) {
+        QVERIFY2(m_pFakeSyncService->noteRequestsByGuid().contains(it.key()) == (it.value() == laterSelectedNotebookGuid),
+                 qPrintable(QStringLiteral("Unexpected download state of the note after the widening of the selective "
+                                           "sync filter: ") + it.key()));
+    }
+
+    // The re-download of the older sync chunks for the backfill doesn't move the last update count backwards
+    // so the next sync has nothing to download
+    m_pFakeSyncService->resetStatistics();
+
+    synchronize();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QCOMPARE(m_pFakeSyncService->statistics().m_numSyncChunkRequests, qint64(0));
+    QVERIFY2(m_pFakeSyncService->noteRequestsByGuid().isEmpty(), "Some notes were downloaded by the sync without updates");
+
+    stopSynchronization();
+
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+
+    const QStringList & laterSelectedNoteGuids = noteGuidsByNotebookGuid[laterSelectedNotebookGuid];
+    for(auto it = laterSelectedNoteGuids.constBegin(), end = laterSelectedNoteGuids.constEnd(); it != end; ++it)
+    {
+        checkLocalNote(localStorageManager, *it);
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+
+    // The local copy of the note moved out of the selection follows the remote note instead of keeping the stale notebook
+    checkLocalNote(localStorageManager, movedNoteGuid);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    Note movedNote;
+    movedNote.unsetLocalUid();
+    movedNote.setGuid(movedNoteGuid);
+
+    ErrorString errorDescription;
+    bool res = localStorageManager.findNote(movedNote, errorDescription, /* with resource binary data = */ false);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+    QVERIFY2(movedNote.hasNotebookGuid() && (movedNote.notebookGuid() == unselectedNotebookGuid),
+             "The local copy of the note moved out of the selection on the server still has the old notebook");
+
+    const QStringList & unselectedNoteGuids = noteGuidsByNotebookGuid[unselectedNotebookGuid];
+    for(auto it = unselectedNoteGuids.constBegin(), end = unselectedNoteGuids.constEnd(); it != end; ++it)
+    {
+        Note note;
+        note.unsetLocalUid();
+        note.setGuid(*it);
+
+        errorDescription.clear();
+        res = localStorageManager.findNote(note, errorDescription, /* with resource binary data = */ false);
+        QVERIFY2(res == false, qPrintable(QStringLiteral("Found the local note not selected by the selective sync filter: ") + *it));
+    }
+}
+
+void SynchronizationManagerTester::setupSynchronization(const benchmark::FakeSyncService::Settings & settings,
+                                                        const int numNotes)
+{
+    m_pFakeSyncService = new benchmark::FakeSyncService(FAKE_SYNC_SERVICE_SEED, settings);
+    m_pFakeSyncService->populate(numNotes);
+    m_pFakeSyncService->resetStatistics();
+
+    m_testAccount = Account(m_pFakeSyncService->user().username.ref(), Account::Type::Evernote,
+                            m_pFakeSyncService->userId(), Account::EvernoteAccountType::Free, m_host);
+
+    startLocalStorageManagerAsync();
+
+    m_pAuthenticationManager = new benchmark::FakeAuthenticationManager(m_pFakeSyncService->userId());
+    m_pSynchronizationManager = new SynchronizationManager(QStringLiteral("fake_consumer_key"),
+                                                           QStringLiteral("fake_consumer_secret"),
+                                                           m_host, *m_pLocalStorageManagerAsync,
+                                                           *m_pAuthenticationManager,
+                                                           new benchmark::FakeNoteStore(*m_pFakeSyncService),
+                                                           new benchmark::FakeUserStore(*m_pFakeSyncService));
+
+    // Thumbnails and ink note images are downloaded via HTTP requests bypassing the note store
+    m_pSynchronizationManager->setDownloadNoteThumbnails(false);
+    m_pSynchronizationManager->setDownloadInkNoteImages(false);
+}
+
+void SynchronizationManagerTester::startLocalStorageManagerAsync()
+{
+    m_pLocalStorageManagerThread = new QThread;
+    m_pLocalStorageManagerAsync = new LocalStorageManagerAsync(m_testAccount, /* start from scratch = */ true,
+                                                               /* override lock = */ false);
+    m_pLocalStorageManagerAsync->moveToThread(m_pLocalStorageManagerThread);
+
+    QObject::connect(m_pLocalStorageManagerThread, QNSIGNAL(QThread,started),
+                     m_pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,init));
+
+    QEventLoop loop;
+    QObject::connect(m_pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,initialized),
+                     &loop, QNSLOT(QEventLoop,quit));
+    m_pLocalStorageManagerThread->start();
+    Q_UNUSED(loop.exec())
+}
+
+void SynchronizationManagerTester::stopSynchronization()
+{
+    delete m_pSynchronizationManager;
+    m_pSynchronizationManager = Q_NULLPTR;
+
+    delete m_pAuthenticationManager;
+    m_pAuthenticationManager = Q_NULLPTR;
+
+    if (m_pLocalStorageManagerThread) {
+        m_pLocalStorageManagerThread->quit();
+        Q_UNUSED(m_pLocalStorageManagerThread->wait())
+    }
+
+    delete m_pLocalStorageManagerAsync;
+    m_pLocalStorageManagerAsync = Q_NULLPTR;
+
+    delete m_pLocalStorageManagerThread;
+    m_pLocalStorageManagerThread = Q_NULLPTR;
+}
+
+void SynchronizationManagerTester::synchronize()
+{
+    if (Q_UNLIKELY(!m_pSynchronizationManager)) {
+        QFAIL("Detected null pointer to SynchronizationManager");
+    }
+
+    int testResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(m_pSynchronizationManager, SIGNAL(finished(Account)), &loop, SLOT(exitAsSuccess()));
+        QObject::connect(m_pSynchronizationManager, SIGNAL(failed(ErrorString)),
+                         &loop, SLOT(exitAsFailureWithErrorString(ErrorString)));
+
+        timer.start();
+        QTimer::singleShot(0, m_pSynchronizationManager, SLOT(synchronize()));
+        testResult = loop.exec();
+    }
+
+    if (testResult == -1) {
+        QFAIL("Internal error: incorrect return status from SynchronizationManager");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Detected failure during the asynchronous loop processing in SynchronizationManager");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("SynchronizationManager failed to finish in time");
+    }
+}
+
+void SynchronizationManagerTester::findLocalResource(const QString & resourceGuid)
+{
+    if (Q_UNLIKELY(!m_pLocalStorageManagerAsync)) {
+        QFAIL("Detected null pointer to LocalStorageManagerAsync");
+    }
+
+    Resource resource;
+    resource.unsetLocalUid();
+    resource.setGuid(resourceGuid);
+
+    QObject::connect(this, QNSIGNAL(SynchronizationManagerTester,findResourceRequest,Resource,bool,QUuid),
+                     m_pLocalStorageManagerAsync, QNSLOT(LocalStorageManagerAsync,onFindResourceRequest,Resource,bool,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+
+    // NOTE: the queued calls are delivered in the order of connections so the found resource is stored
+    // before the loop exits
+    QObject::connect(m_pLocalStorageManagerAsync, QNSIGNAL(LocalStorageManagerAsync,findResourceComplete,Resource,bool,QUuid),
+                     this, QNSLOT(SynchronizationManagerTester,onFindResourceComplete,Resource,bool,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+
+    int testResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(m_pLocalStorageManagerAsync, SIGNAL(findResourceComplete(Resource,bool,QUuid)),
+                         &loop, SLOT(exitAsSuccess()));
+        QObject::connect(m_pLocalStorageManagerAsync, SIGNAL(findResourceFailed(Resource,bool,ErrorString,QUuid)),
+                         &loop, SLOT(exitAsFailure()));
+
+        timer.start();
+        Q_EMIT findResourceRequest(resource, /* with binary data = */ true, QUuid::createUuid());
+        testResult = loop.exec();
+    }
+
+    if (testResult == -1) {
+        QFAIL("Internal error: incorrect return status from LocalStorageManagerAsync");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Failed to find the resource in the local storage");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("LocalStorageManagerAsync failed to find the resource in time");
+    }
+}
+
+void SynchronizationManagerTester::downloadResourceData(const Resource & resource)
+{
+    if (Q_UNLIKELY(!m_pSynchronizationManager)) {
+        QFAIL("Detected null pointer to SynchronizationManager");
+    }
+
+    // NOTE: the request is queued so that the failure reported right away doesn't go unnoticed by the loop below
+    QObject::connect(this, QNSIGNAL(SynchronizationManagerTester,downloadResourceDataRequest,Resource,QString,QUuid),
+                     m_pSynchronizationManager, QNSLOT(SynchronizationManager,downloadResourceData,Resource,QString,QUuid),
+                     Qt::ConnectionType(Qt::QueuedConnection | Qt::UniqueConnection));
+    QObject::connect(m_pSynchronizationManager, QNSIGNAL(SynchronizationManager,downloadResourceDataComplete,Resource,QUuid),
+                     this, QNSLOT(SynchronizationManagerTester,onDownloadResourceDataComplete,Resource,QUuid),
+                     Qt::ConnectionType(Qt::AutoConnection | Qt::UniqueConnection));
+
+    int testResult = -1;
+    {
+        QTimer timer;
+        timer.setInterval(MAX_ALLOWED_MILLISECONDS);
+        timer.setSingleShot(true);
+
+        EventLoopWithExitStatus loop;
+        QObject::connect(&timer, QNSIGNAL(QTimer,timeout), &loop, QNSLOT(EventLoopWithExitStatus,exitAsTimeout));
+        QObject::connect(m_pSynchronizationManager, SIGNAL(downloadResourceDataComplete(Resource,QUuid)),
+                         &loop, SLOT(exitAsSuccess()));
+        QObject::connect(m_pSynchronizationManager, SIGNAL(downloadResourceDataFailed(Resource,ErrorString,QUuid)),
+                         &loop, SLOT(exitAsFailure()));
+
+        timer.start();
+        Q_EMIT downloadResourceDataRequest(resource, QString(), QUuid::createUuid());
+        testResult = loop.exec();
+    }
+
+    if (testResult == -1) {
+        QFAIL("Internal error: incorrect return status from SynchronizationManager");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Failure) {
+        QFAIL("Failed to download the resource data on demand");
+    }
+    else if (testResult == EventLoopWithExitStatus::ExitStatus::Timeout) {
+        QFAIL("SynchronizationManager failed to download the resource data in time");
+    }
+}
+
+QString SynchronizationManagerTester::putTag(const QString & name, const QString & parentGuid)
+{
+    qevercloud::Tag tag;
+    tag.name = name;
+    if (!parentGuid.isEmpty()) {
+        tag.parentGuid = parentGuid;
+    }
+
+    m_pFakeSyncService->putTag(tag);
+    return tag.guid.ref();
+}
+
+void SynchronizationManagerTester::checkLocalTags(const QHash<QString,QString> & namesByGuid,
+                                                  const QHash<QString,QString> & parentGuidsByGuid)
+{
+    LocalStorageManager localStorageManager(m_testAccount, /* start from scratch = */ false, /* override lock = */ false);
+
+    ErrorString errorDescription;
+    QList<Tag> tags = localStorageManager.listTags(LocalStorageManager::ListAll, errorDescription);
+    QVERIFY2(errorDescription.isEmpty(), qPrintable(errorDescription.nonLocalizedString()));
+
+    QHash<QString,Tag> tagsByGuid;
+    for(auto it = tags.constBegin(), end = tags.constEnd(); it != end; ++it)
+    {
+        if (it->hasGuid()) {
+            tagsByGuid[it->guid()] = *it;
+        }
+    }
+
+    for(auto it = namesByGuid.constBegin(), end = namesByGuid.constEnd(); it != end; ++it)
+    {
+        const QString & guid = it.key();
+
+        auto tagIt = tagsByGuid.constFind(guid);
+        QVERIFY2(tagIt != tagsByGuid.constEnd(), qPrintable(QStringLiteral("Can't find the local tag: ") + guid));
+
+        const Tag & tag = tagIt.value();
+        QVERIFY2(tag.hasName() && (tag.name() == it.value()),
+                 qPrintable(QStringLiteral("The local tag's name differs from the remote one: ") + guid));
+
+        const QString parentGuid = parentGuidsByGuid.value(guid);
+        if (parentGuid.isEmpty()) {
+            QVERIFY2(!tag.hasParentGuid(), qPrintable(QStringLiteral("The top level local tag has the parent guid: ") + guid));
+            continue;
+        }
+
+        QVERIFY2(tag.hasParentGuid() && (tag.parentGuid() == parentGuid),
+                 qPrintable(QStringLiteral("The local tag's parent guid differs from the remote one: ") + guid));
+
+        auto parentTagIt = tagsByGuid.constFind(parentGuid);
+        QVERIFY2(parentTagIt != tagsByGuid.constEnd(), qPrintable(QStringLiteral("Can't find the local parent tag: ") + parentGuid));
+        QVERIFY2(tag.hasParentLocalUid() && (tag.parentLocalUid() == parentTagIt->localUid()),
+                 qPrintable(QStringLiteral("The local tag's parent local uid doesn't match the local uid of its parent: ") + guid));
+    }
+}
+
+void SynchronizationManagerTester::checkLocalNote(LocalStorageManager & localStorageManager, const QString & noteGuid)
+{
+    qevercloud::Note qecNote;
+    QVERIFY2(m_pFakeSyncService->findNote(noteGuid, /* with content = */ true, /* with resources data = */ true,
+                                          /* with resources recognition = */ true,
+                                          /* with resources alternate data = */ true, qecNote),
+             qPrintable(QStringLiteral("Can't find the note within the fake sync service: ") + noteGuid));
+    const Note remoteNote(qecNote);
+
+    Note localNote;
+    localNote.unsetLocalUid();
+    localNote.setGuid(noteGuid);
+
+    ErrorString errorDescription;
+    bool res = localStorageManager.findNote(localNote, errorDescription, /* with resource binary data = */ true);
+    QVERIFY2(res == true, qPrintable(errorDescription.nonLocalizedString()));
+
+    QVERIFY2(localNote.hasUpdateSequenceNumber() &&
+             (localNote.updateSequenceNumber() == remoteNote.updateSequenceNumber()),
+             qPrintable(QStringLiteral("The local note's update sequence number differs from the remote one: ") + noteGuid));
+    QVERIFY2(localNote.hasTitle() && (localNote.title() == remoteNote.title()),
+             qPrintable(QStringLiteral("The local note's title differs from the remote one: ") + noteGuid));
+    QVERIFY2(localNote.hasContent() && (localNote.content() == remoteNote.content()),
+             qPrintable(QStringLiteral("The local note's content differs from the remote one: ") + noteGuid));
+
+    QList<Resource> remoteResources = remoteNote.resources();
+    QList<Resource> localResources;
+    if (localNote.hasResources()) {
+        localResources = localNote.resources();
+    }
+
+    QVERIFY2(localResources.size() == remoteResources.size(),
+             qPrintable(QStringLiteral("The local note's number of resources differs from the remote one: ") + noteGuid));
+
+    for(auto it = remoteResources.constBegin(), end = remoteResources.constEnd(); it != end; ++it)
+    {
+        const Resource & remoteResource = *it;
+
+        const Resource * pLocalResource = Q_NULLPTR;
+        for(auto lit = localResources.constBegin(), lend = localResources.constEnd(); lit != lend; ++lit)
+        {
+            if (lit->hasGuid() && (lit->guid() == remoteResource.guid())) {
+                pLocalResource = &(*lit);
+                break;
+            }
+        }
+
+        QVERIFY2(pLocalResource != Q_NULLPTR,
+                 qPrintable(QStringLiteral("Can't find the local resource: ") + remoteResource.guid()));
+        QVERIFY2(pLocalResource->hasDataBody() && (pLocalResource->dataBody() == remoteResource.dataBody()),
+                 qPrintable(QStringLiteral("The local resource's data body differs from the remote one: ") +
+                            remoteResource.guid()));
+
+        if (remoteResource.hasRecognitionDataBody()) {
+            QVERIFY2(pLocalResource->hasRecognitionDataBody() &&
+                     (pLocalResource->recognitionDataBody() == remoteResource.recognitionDataBody()),
+                     qPrintable(QStringLiteral("The local resource's recognition data body differs from the remote one: ") +
+                                remoteResource.guid()));
+        }
+    }
+}
+
+void SynchronizationManagerTester::checkNoteRequest(const QString & noteGuid, const bool withContent,
+                                                    const bool withResourcesData, const bool withResourcesRecognition,
+                                                    const bool withResourcesAlternateData)
+{
+    const QHash<QString, benchmark::FakeSyncService::NoteRequest> & noteRequestsByGuid =
+            m_pFakeSyncService->noteRequestsByGuid();
+
+    auto it = noteRequestsByGuid.constFind(noteGuid);
+    QVERIFY2(it != noteRequestsByGuid.constEnd(),
+             qPrintable(QStringLiteral("The changed note was not downloaded during the incremental sync: ") + noteGuid));
+
+    const benchmark::FakeSyncService::NoteRequest & request = it.value();
+    QVERIFY2(request.m_withContent == withContent,
+             qPrintable(QStringLiteral("Unexpected content download option for note ") + noteGuid));
+    QVERIFY2(request.m_withResourcesData == withResourcesData,
+             qPrintable(QStringLiteral("Unexpected resources data download option for note ") + noteGuid));
+    QVERIFY2(request.m_withResourcesRecognition == withResourcesRecognition,
+             qPrintable(QStringLiteral("Unexpected resources recognition download option for note ") + noteGuid));
+    QVERIFY2(request.m_withResourcesAlternateData == withResourcesAlternateData,
+             qPrintable(QStringLiteral("Unexpected resources alternate data download option for note ") + noteGuid));
+}
+
+} // namespace test
+} // namespace quentier
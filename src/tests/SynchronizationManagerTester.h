@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017 Dmitry Ivanov
+ *
+ * This file is part of libquentier
+ *
+ * libquentier is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * libquentier is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libquentier. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_QUENTIER_TESTS_SYNCHRONIZATION_MANAGER_TESTER_H
+#define LIB_QUENTIER_TESTS_SYNCHRONIZATION_MANAGER_TESTER_H
+
+#include "../benchmarks/FakeSyncService.h"
+#include <quentier/types/Account.h>
+#include <quentier/types/LinkedNotebook.h>
+#include <quentier/types/Resource.h>
+#include <QObject>
+#include <QStringList>
+#include <QUuid>
+
+QT_FORWARD_DECLARE_CLASS(QThread)
+
+namespace quentier {
+
+QT_FORWARD_DECLARE_CLASS(LocalStorageManager)
+QT_FORWARD_DECLARE_CLASS(LocalStorageManagerAsync)
+QT_FORWARD_DECLARE_CLASS(SynchronizationManager)
+
+namespace benchmark {
+QT_FORWARD_DECLARE_CLASS(FakeAuthenticationManager)
+}
+
+namespace test {
+
+/**
+ * @brief The SynchronizationManagerTester class runs the whole synchronization against the fake sync service
+ * and checks what was requested from the service and what has ended up in the local storage
+ */
+class SynchronizationManagerTester: public QObject
+{
+    Q_OBJECT
+public:
+    SynchronizationManagerTester(QObject * parent = Q_NULLPTR);
+    virtual ~SynchronizationManagerTester();
+
+Q_SIGNALS:
+// private signals
+    void findResourceRequest(Resource resource, bool withBinaryData, QUuid requestId);
+    void downloadResourceDataRequest(Resource resource, QString linkedNotebookGuid, QUuid requestId);
+
+// NOTE: these are public so that QTest doesn't run them as test cases
+public Q_SLOTS:
+    void onLinkedNotebookSyncFailed(LinkedNotebook linkedNotebook, ErrorString errorDescription);
+    void onFindResourceComplete(Resource resource, bool withBinaryData, QUuid requestId);
+    void onDownloadResourceDataComplete(Resource resource, QUuid requestId);
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testIncrementalSyncDownloadsOnlyChangedNoteData();
+    void testTagTreeWithSameLevelRenameSwap();
+    void testInaccessibleLinkedNotebookIsSkipped();
+    void testOnDemandResourceDataDownload();
+    void testSelectiveSyncFilterWideningAndNoteMovedOutOfSelection();
+
+private:
+    void setupSynchronization(const benchmark::FakeSyncService::Settings & settings, const int numNotes);
+    void startLocalStorageManagerAsync();
+    void stopSynchronization();
+
+    void synchronize();
+    void findLocalResource(const QString & resourceGuid);
+    void downloadResourceData(const Resource & resource);
+
+    QString putTag(const QString & name, const QString & parentGuid);
+    void checkLocalTags(const QHash<QString,QString> & namesByGuid, const QHash<QString,QString> & parentGuidsByGuid);
+
+    void checkLocalNote(LocalStorageManager & localStorageManager, const QString & noteGuid);
+    void checkNoteRequest(const QString & noteGuid, const bool withContent, const bool withResourcesData,
+                          const bool withResourcesRecognition, const bool withResourcesAlternateData);
+
+private:
+    Account                                 m_testAccount;
+    QString                                 m_host;
+    benchmark::FakeSyncService *            m_pFakeSyncService;
+    QThread *                               m_pLocalStorageManagerThread;
+    LocalStorageManagerAsync *              m_pLocalStorageManagerAsync;
+    benchmark::FakeAuthenticationManager *  m_pAuthenticationManager;
+    SynchronizationManager *                m_pSynchronizationManager;
+    QStringList                             m_failedLinkedNotebookGuids;
+    Resource                                m_foundResource;
+    Resource                                m_downloadedResource;
+};
+
+} // namespace test
+} // namespace quentier
+
+#endif // LIB_QUENTIER_TESTS_SYNCHRONIZATION_MANAGER_TESTER_H
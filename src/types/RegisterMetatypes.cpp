@@ -29,7 +29,12 @@
 #include <quentier/types/SharedNotebook.h>
 #include <quentier/local_storage/LocalStorageManager.h>
 #include <quentier/local_storage/NoteSearchQuery.h>
+#include <quentier/local_storage/ChangeJournalEntry.h>
+#include <quentier/local_storage/LocalStorageStatistics.h>
+#include <quentier/local_storage/LocalStorageSnapshotInfo.h>
+#include <quentier/local_storage/StaleDataItemsExpungeResult.h>
 #include <QMetaType>
+#include <QSet>
 #include <QSqlError>
 
 namespace quentier {
@@ -71,9 +76,17 @@ void registerMetatypes()
     qRegisterMetaType<QHash<QString,qevercloud::Timestamp> >("QHash<QString,qevercloud::Timestamp>");
     qRegisterMetaType<QHash<QString,qint32> >("QHash<QString,qint32>");
     qRegisterMetaType<QHash<QString,int> >("QHash<QString,int>");
+    qRegisterMetaType<QHash<QString,QByteArray> >("QHash<QString,QByteArray>");
+    qRegisterMetaType<QSet<QString> >("QSet<QString>");
 
     qRegisterMetaType<NoteSearchQuery>("NoteSearchQuery");
 
+    qRegisterMetaType<ChangeJournalEntry>("ChangeJournalEntry");
+    qRegisterMetaType< QList<ChangeJournalEntry> >("QList<ChangeJournalEntry>");
+    qRegisterMetaType<LocalStorageStatistics>("LocalStorageStatistics");
+    qRegisterMetaType<LocalStorageSnapshotInfo>("LocalStorageSnapshotInfo");
+    qRegisterMetaType<StaleDataItemsExpungeResult>("StaleDataItemsExpungeResult");
+
     qRegisterMetaType<ErrorString>("ErrorString");
     qRegisterMetaType<QSqlError>("QSqlError");
 }